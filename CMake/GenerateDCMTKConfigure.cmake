@@ -171,6 +171,7 @@ ENDIF(WIN32 AND NOT CYGWIN)
   CHECK_INCLUDE_FILE_CXX("ndir.h" HAVE_NDIR_H)
   CHECK_INCLUDE_FILE_CXX("netdb.h" HAVE_NETDB_H)
   CHECK_INCLUDE_FILE_CXX("new.h" HAVE_NEW_H)
+  CHECK_INCLUDE_FILE_CXX("poll.h" HAVE_POLL_H)
   CHECK_INCLUDE_FILE_CXX("pwd.h" HAVE_PWD_H)
   CHECK_INCLUDE_FILE_CXX("semaphore.h" HAVE_SEMAPHORE_H)
   CHECK_INCLUDE_FILE_CXX("setjmp.h" HAVE_SETJMP_H)
@@ -191,9 +192,11 @@ ENDIF(WIN32 AND NOT CYGWIN)
   CHECK_INCLUDE_FILE_CXX("strstrea.h" HAVE_STRSTREA_H)
   CHECK_INCLUDE_FILE_CXX("synch.h" HAVE_SYNCH_H)
   CHECK_INCLUDE_FILE_CXX("syslog.h" HAVE_SYSLOG_H)
+  CHECK_INCLUDE_FILE_CXX("sys/epoll.h" HAVE_SYS_EPOLL_H)
   CHECK_INCLUDE_FILE_CXX("sys/errno.h" HAVE_SYS_ERRNO_H)
   CHECK_INCLUDE_FILE_CXX("sys/dir.h" HAVE_SYS_DIR_H)
   CHECK_INCLUDE_FILE_CXX("sys/file.h" HAVE_SYS_FILE_H)
+  CHECK_INCLUDE_FILE_CXX("sys/mman.h" HAVE_SYS_MMAN_H)
   CHECK_INCLUDE_FILE_CXX("sys/ndir.h" HAVE_SYS_NDIR_H)
   CHECK_INCLUDE_FILE_CXX("sys/param.h" HAVE_SYS_PARAM_H)
   CHECK_INCLUDE_FILE_CXX("sys/resource.h" HAVE_SYS_RESOURCE_H)
@@ -203,6 +206,7 @@ ENDIF(WIN32 AND NOT CYGWIN)
   CHECK_INCLUDE_FILE_CXX("sys/time.h" HAVE_SYS_TIME_H)
   CHECK_INCLUDE_FILE_CXX("sys/timeb.h" HAVE_SYS_TIMEB_H)
   CHECK_INCLUDE_FILE_CXX("sys/types.h" HAVE_SYS_TYPES_H)
+  CHECK_INCLUDE_FILE_CXX("sys/uio.h" HAVE_SYS_UIO_H)
   CHECK_INCLUDE_FILE_CXX("sys/utime.h" HAVE_SYS_UTIME_H)
   CHECK_INCLUDE_FILE_CXX("sys/utsname.h" HAVE_SYS_UTSNAME_H)
   CHECK_INCLUDE_FILE_CXX("sys/wait.h" HAVE_SYS_WAIT_H)
@@ -306,6 +310,7 @@ ENDIF(WIN32 AND NOT CYGWIN)
   CHECK_FUNCTION_EXISTS(memset HAVE_MEMSET)
   CHECK_FUNCTION_EXISTS(mkstemp HAVE_MKSTEMP)
   CHECK_FUNCTION_EXISTS(mktemp HAVE_MKTEMP)
+  CHECK_FUNCTION_EXISTS(pread HAVE_PREAD)
   CHECK_FUNCTION_EXISTS(rindex HAVE_RINDEX)
   CHECK_FUNCTION_EXISTS(select HAVE_SELECT)
   CHECK_FUNCTION_EXISTS(setsockopt HAVE_SETSOCKOPT)
@@ -34,6 +34,7 @@
 #include "dcmtk/dcmdata/cmdlnarg.h"
 #include "dcmtk/ofstd/ofconapp.h"
 #include "dcmtk/dcmdata/dcuid.h"     /* for dcmtk version name */
+#include "dcmtk/dcmdata/dcfrmpar.h"  /* for dcmCodecMaxThreads */
 #include "dcmtk/dcmdata/dcrleerg.h"  /* for DcmRLEEncoderRegistration */
 
 #ifdef WITH_ZLIB
@@ -75,6 +76,7 @@ int main(int argc, char *argv[])
   // RLE options
   E_TransferSyntax opt_oxfer = EXS_RLELossless;
   OFCmdUnsignedInt opt_fragmentSize = 0; // 0=unlimited
+  OFCmdUnsignedInt opt_threads = 1;
   OFBool           opt_createOffsetTable = OFTrue;
   OFBool           opt_uidcreation = OFFalse;
   OFBool           opt_secondarycapture = OFFalse;
@@ -112,6 +114,9 @@ int main(int argc, char *argv[])
     cmd.addSubGroup("basic offset table encoding:");
       cmd.addOption("--offset-table-create", "+ot",    "create offset table (default)");
       cmd.addOption("--offset-table-empty",  "-ot",    "leave offset table empty");
+    cmd.addSubGroup("multi-frame images:");
+      cmd.addOption("--threads",             "+mt", 1, "[n]umber: integer (default: 1)",
+                                                       "compress up to n frames in parallel");
 
     cmd.addSubGroup("SOP Class UID:");
       cmd.addOption("--class-default",       "+cd",    "keep SOP Class UID (default)");
@@ -208,6 +213,12 @@ int main(int argc, char *argv[])
       if (cmd.findOption("--offset-table-empty")) opt_createOffsetTable = OFFalse;
       cmd.endOptionBlock();
 
+      if (cmd.findOption("--threads"))
+      {
+        app.checkValue(cmd.getValueAndCheckMin(opt_threads, 1));
+        dcmCodecMaxThreads.set(OFstatic_cast(Uint32, opt_threads));
+      }
+
       cmd.beginOptionBlock();
       if (cmd.findOption("--class-default")) opt_secondarycapture = OFFalse;
       if (cmd.findOption("--class-sc")) opt_secondarycapture = OFTrue;
@@ -283,12 +294,9 @@ int main(int argc, char *argv[])
     DcmXfer original_xfer(dataset->getOriginalXfer());
     if (original_xfer.isEncapsulated())
     {
-      OFLOG_INFO(dcmcrleLogger, "DICOM file is already compressed, converting to uncompressed transfer syntax first");
-      if (EC_Normal != dataset->chooseRepresentation(EXS_LittleEndianExplicit, NULL))
-      {
-        OFLOG_FATAL(dcmcrleLogger, "No conversion from compressed original to uncompressed transfer syntax possible!");
-        return 1;
-      }
+      // no explicit conversion to an uncompressed transfer syntax here, chooseRepresentation()
+      // decodes the original pixel data as needed (frame by frame, if the codecs support it)
+      OFLOG_INFO(dcmcrleLogger, "DICOM file is already compressed, transcoding to the new transfer syntax");
     }
 
     OFString sopClass;
@@ -317,6 +325,8 @@ int main(int argc, char *argv[])
 
     OFLOG_INFO(dcmcrleLogger, "create output file " << opt_ofname);
 
+    // drop the original (compressed) pixel data, it is not needed for writing
+    dataset->removeAllButCurrentRepresentations();
     fileformat.loadAllDataIntoMemory();
     error = fileformat.saveFile(opt_ofname, opt_oxfer, opt_oenctype, opt_oglenc, opt_opadenc,
         OFstatic_cast(Uint32, opt_filepad), OFstatic_cast(Uint32, opt_itempad), EWM_updateMeta);
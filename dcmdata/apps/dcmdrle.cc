@@ -35,6 +35,7 @@
 #include "dcmtk/ofstd/ofconapp.h"
 #include "dcmtk/dcmdata/dcuid.h"     /* for dcmtk version name */
 #include "dcmtk/dcmdata/dcrledrg.h"  /* for DcmRLEDecoderRegistration */
+#include "dcmtk/dcmdata/dcfrmpar.h"  /* for dcmCodecMaxThreads */
 
 #ifdef WITH_ZLIB
 #include <zlib.h>      /* for zlibVersion() */
@@ -77,6 +78,7 @@ int main(int argc, char *argv[])
   // RLE parameters
   OFBool opt_uidcreation = OFFalse;
   OFBool opt_reversebyteorder = OFFalse;
+  OFCmdUnsignedInt opt_threads = 1;
 
   OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION, "Decode RLE-compressed DICOM file", rcsid);
   OFCommandLine cmd;
@@ -104,6 +106,9 @@ int main(int argc, char *argv[])
     cmd.addSubGroup("RLE byte segment order:");
       cmd.addOption("--byte-order-default",  "+bd",    "most significant byte first (default)");
       cmd.addOption("--byte-order-reverse",  "+br",    "least significant byte first");
+    cmd.addSubGroup("multi-frame images:");
+      cmd.addOption("--threads",             "+mt", 1, "[n]umber: integer (default: 1)",
+                                                       "decompress up to n frames in parallel");
 
   cmd.addGroup("output options:");
     cmd.addSubGroup("output file format:");
@@ -166,6 +171,12 @@ int main(int argc, char *argv[])
       if (cmd.findOption("--byte-order-reverse")) opt_reversebyteorder = OFTrue;
       cmd.endOptionBlock();
 
+      if (cmd.findOption("--threads"))
+      {
+        app.checkValue(cmd.getValueAndCheckMin(opt_threads, 1));
+        dcmCodecMaxThreads.set(OFstatic_cast(Uint32, opt_threads));
+      }
+
       cmd.beginOptionBlock();
       if (cmd.findOption("--read-file"))
       {
@@ -34,6 +34,7 @@ class DcmPixelSequence;
 class DcmPolymorphOBOW;
 class DcmItem;
 class DcmTagKey;
+class DcmFrameSource;
 
 /** abstract base class for a codec parameter object that
  *  describes the settings (modes of operations) for one
@@ -182,6 +183,33 @@ public:
     const DcmCodecParameter * cp,
     DcmStack & objStack) const = 0;
 
+  /** compresses the frames of a compressed DICOM image, which are decompressed
+   *  batch by batch by the given frame source, and stores the result in the
+   *  given pixSeq element. This allows for transcoding a compressed image
+   *  without holding the complete uncompressed pixel data in memory.
+   *  Called by DcmCodecList::encode() if no codec is able to transcode the
+   *  image directly. Before this method is called, the photometric
+   *  interpretation in the dataset is updated to the decompressed color model.
+   *  The default implementation returns EC_IllegalCall, in which case the
+   *  image is decompressed completely and then compressed with encode().
+   *  @param frames source of the uncompressed frames. Must only be accessed
+   *    by the thread that called this method.
+   *  @param toRepParam representation parameter describing the desired
+   *    compressed representation (e.g. JPEG quality)
+   *  @param pixSeq compressed pixel sequence (pointer to new DcmPixelSequence object
+   *    allocated on heap) returned in this parameter upon success.
+   *  @param cp codec parameters for this codec
+   *  @param objStack stack pointing to the location of the pixel data
+   *    element in the current dataset.
+   *  @return EC_Normal if successful, an error code otherwise.
+   */
+  virtual OFCondition encodeFrames(
+    DcmFrameSource& frames,
+    const DcmRepresentationParameter * toRepParam,
+    DcmPixelSequence * & pixSeq,
+    const DcmCodecParameter * cp,
+    DcmStack & objStack) const;
+
   /** checks if this codec is able to convert from the
    *  given current transfer syntax to the given new
    *  transfer syntax
@@ -419,6 +447,10 @@ public:
   /** looks for a codec that is able to transcode (re-compresses)
    *  from the given transfer syntax to the given transfer syntax
    *  and calls the encode() method of the codec.
+   *  If there is no such codec, but a codec that decompresses the image and
+   *  a codec that compresses to the new transfer syntax, the image is
+   *  transcoded frame by frame with the encodeFrames() method of the latter,
+   *  if supported.
    *  A read lock on the list of
    *  codecs is acquired until this method returns.
    *  @param fromRepType current transfer syntax of the compressed image
@@ -484,6 +516,29 @@ private:
     const DcmRepresentationParameter *aDefaultRepParam,
     const DcmCodecParameter *aCodecParameter);
 
+  /** transcodes the given compressed image frame by frame, using a codec
+   *  that decompresses the frames and a codec that compresses them with its
+   *  encodeFrames() method. Must be called with a read lock on the list of codecs.
+   *  @param fromRepType current transfer syntax of the compressed image
+   *  @param fromParam current representation parameter of compressed data, may be NULL
+   *  @param fromPixSeq compressed pixel sequence
+   *  @param toRepType transfer syntax to compress to
+   *  @param toRepParam representation parameter describing the desired
+   *    new compressed representation, may be NULL
+   *  @param toPixSeq compressed pixel sequence returned in this parameter upon success.
+   *  @param pixelStack stack pointing to the location of the pixel data
+   *    element in the current dataset.
+   *  @return EC_Normal if successful, an error code otherwise.
+   */
+  static OFCondition encodeFrames(
+    const E_TransferSyntax fromRepType,
+    const DcmRepresentationParameter * fromParam,
+    DcmPixelSequence * fromPixSeq,
+    const E_TransferSyntax toRepType,
+    const DcmRepresentationParameter * toRepParam,
+    DcmPixelSequence * & toPixSeq,
+    DcmStack & pixelStack);
+
   /// private undefined copy constructor
   DcmCodecList(const DcmCodecList &);
 
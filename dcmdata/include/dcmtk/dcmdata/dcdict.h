@@ -49,6 +49,13 @@
 #define ENVIRONMENT_PATH_SEPARATOR '\n' /* at least define something unlikely */
 #endif
 
+/* read access to the global data dictionary does not require a lock if the
+ * pointer to the current dictionary can be published by an atomic operation
+ */
+#if defined(WITH_THREADS) && (defined(HAVE_SYNC_ADD_AND_FETCH) || defined(HAVE_INTERLOCKED_INCREMENT))
+#define DCMDICT_LOCKFREE_READ 1
+#endif
+
 
 /** this class implements a loadable DICOM Data Dictionary
  */
@@ -64,6 +71,12 @@ public:
      */
     DcmDataDictionary(OFBool loadBuiltin, OFBool loadExternal);
 
+    /** copy constructor.  Creates a deep copy of all dictionary entries,
+     *  static tables of entries (e.g. of the builtin dictionary) are shared.
+     *  @param other dictionary to be copied
+     */
+    DcmDataDictionary(const DcmDataDictionary &other);
+
     /// destructor
     ~DcmDataDictionary();
 
@@ -76,7 +89,7 @@ public:
     int numberOfNormalTagEntries() const { return hashDict.size(); }
 
     /// returns the number of repeating tag entries
-    int numberOfRepeatingTagEntries() const { return OFstatic_cast(int, repDict.size()); }
+    int numberOfRepeatingTagEntries() const { return OFstatic_cast(int, repDict.size()) + staticRepCount; }
 
     /** returns the number of dictionary entries that were loaded
      *  either from file or from a built-in dictionary or both.
@@ -138,6 +151,13 @@ public:
      */
     void addEntry(DcmDictEntry* entry);
 
+    /** deletes the given entry from either dictionary (if present).
+     *  An equivalent entry, i.e. one with the same tag range, VR and
+     *  private creator, is removed and deallocated (via delete).
+     *  @param entry entry to be deleted
+     */
+    void deleteEntry(const DcmDictEntry& entry);
+
     /* Iterators to access the normal and the repeating entries */
 
     /// returns an iterator to the start of the normal (non-repeating) dictionary
@@ -146,11 +166,14 @@ public:
     /// returns an iterator to the end of the normal (non-repeating) dictionary
     DcmHashDictIterator normalEnd() { return hashDict.end(); }
 
-    /// returns an iterator to the start of the repeating tag dictionary
-    DcmDictEntryListIterator repeatingBegin() { return repDict.begin(); }
+    /** returns an iterator to the start of the repeating tag dictionary.
+     *  The repeating tag entries of the builtin dictionary (if any) are copied
+     *  to the list of repeating tags before.
+     */
+    DcmDictEntryListIterator repeatingBegin() { copyStaticRepeatingEntries(); return repDict.begin(); }
 
     /// returns an iterator to the end of the repeating tag dictionary
-    DcmDictEntryListIterator repeatingEnd() { return repDict.end(); }
+    DcmDictEntryListIterator repeatingEnd() { copyStaticRepeatingEntries(); return repDict.end(); }
 
 private:
 
@@ -158,10 +181,6 @@ private:
      */
     DcmDataDictionary &operator=(const DcmDataDictionary &);
 
-    /** private undefined copy constructor
-     */
-    DcmDataDictionary(const DcmDataDictionary &);
-
     /** loads external dictionaries defined via environment variables
      *  @return true if successful
      */
@@ -169,10 +188,35 @@ private:
 
     /** loads a builtin (compiled) data dictionary.
      *  Depending on which code is in use, this function may not
-     *  do anything.
+     *  do anything.  The builtin dictionary is not copied to the heap:
+     *  its entries are attached as static tables to the dictionary of
+     *  normal tags and to the list of repeating tags.
      */
     void loadBuiltinDictionary();
 
+    /** attaches static tables of entries (e.g. of the builtin dictionary),
+     *  which are searched after the entries added by addEntry().  Entries
+     *  added before with the same tag (range) and private creator are replaced.
+     *  @param publicDict normal tag entries without private creator
+     *  @param privateDict normal tag entries with private creator
+     *  @param repEntries repeating tag entries in the order of the lookup,
+     *    entries without private creator first
+     *  @param repPublicCount number of repeating tag entries without private creator
+     *  @param repCount total number of repeating tag entries
+     */
+    void setStaticEntries(const DcmStaticHashDict& publicDict,
+                          const DcmStaticHashDict& privateDict,
+                          const DcmDictEntry* repEntries,
+                          int repPublicCount,
+                          int repCount);
+
+    /** copies the static repeating tag entries (if any) to the list of
+     *  repeating tags and detaches the static entries afterwards.  This
+     *  is required before the list of repeating tags is modified, since
+     *  the order of its entries is relevant for the lookup.
+     */
+    void copyStaticRepeatingEntries();
+
     /** loads the skeleton dictionary (the bare minimum needed to run)
      *  @return true if successful
      */
@@ -183,10 +227,6 @@ private:
      */
     const DcmDictEntry* findEntry(const DcmDictEntry& entry) const;
 
-    /** deletes the given entry from either dictionary
-     */
-    void deleteEntry(const DcmDictEntry& entry);
-
 
     /** dictionary of normal tags
      */
@@ -196,6 +236,19 @@ private:
      */
     DcmDictEntryList repDict;
 
+    /** static repeating tag entries (e.g. of the builtin dictionary), searched
+     *  after repDict.  Entries without private creator come first.
+     */
+    const DcmDictEntry *staticRepDict;
+
+    /** number of static repeating tag entries without private creator
+     */
+    int staticRepPublicCount;
+
+    /** total number of static repeating tag entries
+     */
+    int staticRepCount;
+
     /** the number of skeleton entries
      */
     int skeletonCount;
@@ -212,6 +265,22 @@ private:
  *  on first use, if the user accesses it via rdlock() or wrlock().  The
  *  dictionary allows safe read (shared) and write (exclusive) access from
  *  multiple threads in parallel.
+ *  If DCMDICT_LOCKFREE_READ is defined, read access does not acquire any lock:
+ *  the dictionary returned by rdlock() is an immutable snapshot, i.e. it is
+ *  never modified.  wrlock() returns a copy of the current dictionary, which
+ *  replaces the current one (for all subsequent calls of rdlock()) when the
+ *  write lock is released.  Since a thread might still use a snapshot after
+ *  it has been replaced, each thread announces the epoch (i.e. the number of
+ *  replacements so far) in which it started reading in a slot of its own, and
+ *  replaced dictionaries are deleted as soon as all readers that started
+ *  before the replacement have called unlock().  The reference returned by
+ *  rdlock() must therefore not be used after unlock().  Readers only write
+ *  to their own slot and need no atomic read-modify-write operation.  Write
+ *  access should still be rare (e.g. only on startup of an application),
+ *  since each one copies the dictionary.
+ *  In this case, read locks may also be nested and a thread holding a read
+ *  lock may acquire the write lock.  In any case, a thread holding the write
+ *  lock must not call rdlock() or wrlock() before it has called unlock().
  */
 class DCMTK_DCMDATA_EXPORT GlobalDcmDataDictionary
 {
@@ -225,18 +294,26 @@ public:
   ~GlobalDcmDataDictionary();
 
   /** acquires a read lock and returns a const reference to
-   *  the dictionary.
+   *  the dictionary.  If DCMDICT_LOCKFREE_READ is defined, no lock is
+   *  acquired and the current snapshot of the dictionary is returned, which
+   *  remains valid until unlock() is called.  Must not be called by a thread
+   *  holding the write lock.
    *  @return const reference to dictionary
    */
   const DcmDataDictionary& rdlock();
 
   /** acquires a write lock and returns a non-const reference
-   *  to the dictionary.
+   *  to the dictionary.  If DCMDICT_LOCKFREE_READ is defined, a reference to
+   *  a copy of the current dictionary is returned, which is published by
+   *  unlock().  Readers are not blocked in the meantime.
    *  @return non-const reference to dictionary.
    */
   DcmDataDictionary& wrlock();
 
   /** unlocks the read or write lock which must have been acquired previously.
+   *  If the calling thread holds the write lock and DCMDICT_LOCKFREE_READ is
+   *  defined, the modified dictionary replaces the current one.  Replaced
+   *  dictionaries that are no longer used by any reader are deleted.
    */
   void unlock();
 
@@ -268,6 +345,96 @@ private:
    */
   void createDataDict();
 
+#ifdef DCMDICT_LOCKFREE_READ
+  /** replaces the current dictionary by the given one.  The caller must
+   *  have dataDictLock locked.
+   *  @param dict the new dictionary
+   */
+  void publishDataDict(DcmDataDictionary *dict);
+
+  /** deletes the replaced dictionaries that are not used by any reader.
+   *  The caller must have dataDictLock locked.
+   */
+  void deleteReplacedDicts();
+
+  /** per-thread state of the readers and the writer.  Each slot is owned
+   *  by one thread at a time and padded in order to occupy a cache line.
+   */
+  struct ThreadSlot
+  {
+    /// epoch in which the owning thread started reading, -1 if not reading
+    volatile long epoch;
+    /// number of nested read locks held by the owning thread
+    long readDepth;
+    /// flag indicating whether the owning thread holds the write lock
+    OFBool writeLocked;
+    /// 1 if the slot is owned by a thread, 0 if it can be reused (modified atomically only)
+    volatile long owned;
+    /// next slot in the list of all slots (never modified after insertion)
+    ThreadSlot *next;
+    /// padding to avoid false sharing between the slots
+    char padding[64];
+  };
+
+  /** a dictionary that has been replaced and the epoch that started with
+   *  its replacement
+   */
+  struct ReplacedDict
+  {
+    /// the replaced dictionary
+    DcmDataDictionary *dict;
+    /// epoch in which the dictionary was no longer current
+    long epoch;
+  };
+
+  /** returns the slot owned by the calling thread.  A new slot is
+   *  assigned on the first call, preferably a slot of a terminated thread.
+   *  @return slot of the calling thread
+   */
+  ThreadSlot *getThreadSlot();
+
+  /** called on termination of a thread, makes its slot available again
+   *  @param slot the slot of the terminating thread
+   */
+  static void releaseThreadSlot(void *slot);
+
+  /** the current (immutable) data dictionary managed by this class.
+   *  Only accessed by atomic operations with acquire/release semantics.
+   */
+  DcmDataDictionary *dataDict;
+
+  /** the copy of the data dictionary modified by the thread holding the
+   *  write lock, NULL if the write lock is not held
+   */
+  DcmDataDictionary *modifiedDict;
+
+  /** the data dictionaries that have been replaced but might still be in use
+   */
+  OFList<ReplacedDict> replacedDicts;
+
+  /** flag indicating that replacedDicts is not empty (only a hint for readers,
+   *  modified with dataDictLock locked)
+   */
+  volatile OFBool replacedDictsPending;
+
+  /** number of times the dictionary has been replaced.  Only modified with
+   *  dataDictLock locked, and only accessed with acquire/release semantics.
+   */
+  volatile long epoch;
+
+  /** list of the slots of all threads that have used the dictionary.
+   *  New slots are inserted atomically at the head, no slot is ever removed.
+   */
+  ThreadSlot *threadSlots;
+
+  /** the slot owned by the calling thread (NULL if not yet assigned)
+   */
+  OFThreadSpecificData threadSlot;
+
+  /** the mutex used to serialize write access from multiple threads
+   */
+  OFMutex dataDictLock;
+#else
   /** the data dictionary managed by this class
    */
   DcmDataDictionary *dataDict;
@@ -277,6 +444,7 @@ private:
    */
   OFReadWriteLock dataDictLock;
 #endif
+#endif
 };
 
 
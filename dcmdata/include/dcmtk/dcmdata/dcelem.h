@@ -31,6 +31,7 @@
 // forward declarations
 class DcmInputStreamFactory;
 class DcmFileCache;
+class DcmFileMapping;
 class DcmItem;
 
 /** abstract base class for all DICOM elements
@@ -137,6 +138,13 @@ class DCMTK_DCMDATA_EXPORT DcmElement
      */
     inline OFBool valueLoaded() const { return fValue != NULL || getLengthField() == 0; }
 
+    /** check if the value of this element refers directly to a memory mapped
+     *  input file (see dcmUseMemoryMappedFileInput) instead of a buffer owned
+     *  by this element. Such a value is copied on write by the operating system.
+     *  @return true if value refers to a memory mapped file, false otherwise
+     */
+    inline OFBool valueMapped() const { return fMapping != NULL; }
+
     /** initialize the transfer state of this object. This method must be called
      *  before this object is written to a stream or read (parsed) from a stream.
      */
@@ -428,6 +436,11 @@ class DCMTK_DCMDATA_EXPORT DcmElement
      *  heap after use. The DICOM element remains a copy of the value if the
      *  copy parameter is OFTrue; otherwise the value is erased in the DICOM
      *  element.
+     *  If the value refers to a memory mapped file (see valueMapped()), it is
+     *  copied into main memory first and the detached value is this copy.
+     *  Pointers to the value that were retrieved before then still refer to the
+     *  memory mapped file, so call this method with copy = OFTrue before
+     *  retrieving a value that is to be detached later.
      *  @param copy if true, copy value field before detaching; if false, do not
      *    retain a copy.
      *  @return EC_Normal upon success, an error code otherwise
@@ -854,6 +867,25 @@ class DCMTK_DCMDATA_EXPORT DcmElement
 
   private:
 
+    /** check whether the value of this element may refer directly to a
+     *  memory mapped input file instead of being copied into main memory.
+     *  This is the case for large, even-length values of binary VRs only.
+     *  @return true if value may be mapped, false otherwise
+     */
+    OFBool isMappableValue();
+
+    /** replace a value that refers to a memory mapped file by a copy in main
+     *  memory and release the reference to the mapped file. Does nothing if the
+     *  value does not refer to a memory mapped file.
+     *  @return EC_Normal upon success, an error code otherwise
+     */
+    OFCondition copyMappedValue();
+
+    /** delete the value field (or release the reference to the memory mapped
+     *  file it refers to) and set the value pointer to NULL
+     */
+    void deleteValueField();
+
     /// current byte order of attribute value in memory
     E_ByteOrder fByteOrder;
 
@@ -862,6 +894,9 @@ class DCMTK_DCMDATA_EXPORT DcmElement
 
     /// value of the element
     Uint8 *fValue;
+
+    /// memory mapped file fValue refers to, NULL if fValue is owned by this element
+    DcmFileMapping *fMapping;
 };
 
 
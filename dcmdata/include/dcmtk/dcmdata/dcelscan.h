@@ -0,0 +1,185 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: lightweight scanner extracting the values of a few top-level
+ *    elements from an encoded dataset without parsing it into a DcmDataset
+ *
+ */
+
+#ifndef DCELSCAN_H
+#define DCELSCAN_H
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+#include "dcmtk/ofstd/ofcond.h"
+#include "dcmtk/ofstd/ofstring.h"
+#include "dcmtk/ofstd/ofvector.h"
+#include "dcmtk/dcmdata/dctagkey.h"
+#include "dcmtk/dcmdata/dcxfer.h"
+
+
+/** lightweight scanner extracting the values of a few top-level elements from
+ *  a dataset while it is being received or written, e.g. the UIDs needed for
+ *  naming and indexing an incoming object. The encoded dataset is passed
+ *  chunk by chunk to scan(). Only the element headers are looked at; the
+ *  values of all other elements, including sequences and pixel data, are
+ *  skipped without being copied. Since the top-level elements of a dataset
+ *  are sorted by tag, scanning stops as soon as the last requested tag has
+ *  been passed, which is usually the case after the first few kilobytes.
+ *  Deflated transfer syntaxes are not supported.
+ */
+class DCMTK_DCMDATA_EXPORT DcmElementScanner
+{
+public:
+
+  /// default constructor, no tags are requested
+  DcmElementScanner();
+
+  /** request the value of the given top-level element. Must be called before
+   *  start(). Values longer than 1024 bytes are not extracted.
+   *  @param tag tag of the element
+   */
+  void addTag(const DcmTagKey &tag);
+
+  /** start scanning a new dataset. The values found in a previous dataset
+   *  are discarded, the requested tags are retained.
+   *  @param xfer transfer syntax of the dataset
+   */
+  void start(E_TransferSyntax xfer);
+
+  /** scan the next chunk of the encoded dataset. Does nothing after
+   *  finished() has returned OFTrue.
+   *  @param data pointer to the chunk
+   *  @param length length of the chunk in bytes
+   */
+  void scan(const void *data, size_t length);
+
+  /** check whether scanning has finished, i.e. whether all requested
+   *  elements have been found or passed, or whether an error has occurred.
+   *  @return OFTrue if further calls to scan() are not needed
+   */
+  OFBool finished() const
+  {
+    return finished_;
+  }
+
+  /** get the status of the scanner
+   *  @return EC_Normal unless the dataset could not be scanned, e.g.
+   *    because it is corrupted or deflated
+   */
+  OFCondition status() const
+  {
+    return status_;
+  }
+
+  /** get the value of a requested element. Trailing spaces and null bytes
+   *  are removed. For multi-valued elements, only the first value is returned.
+   *  @param tag tag of the element
+   *  @param value returns the value of the element
+   *  @return EC_Normal if the element has been found, EC_TagNotFound otherwise
+   */
+  OFCondition getValue(const DcmTagKey &tag, OFString &value) const;
+
+private:
+
+  /// format of the element header being read
+  enum E_HeaderFormat
+  {
+    /// tag not yet complete
+    EHF_Unknown,
+    /// tag followed by 32-bit length (implicit VR or delimitation items)
+    EHF_Implicit,
+    /// tag and VR, length not yet known
+    EHF_Explicit,
+    /// tag, VR and 16-bit length
+    EHF_ExplicitShort,
+    /// tag, VR, reserved field and 32-bit length
+    EHF_ExplicitLong
+  };
+
+  /// nesting level within an element of undefined length
+  struct Level
+  {
+    /// OFTrue within a sequence, OFFalse within an item
+    OFBool sequence;
+
+    /// OFTrue if the contents are encoded with explicit VR
+    OFBool explicitVR;
+  };
+
+  /** get a 16-bit value from the header buffer
+   *  @param offset offset in bytes
+   *  @return value in local byte order
+   */
+  Uint16 getUint16(size_t offset) const;
+
+  /** get a 32-bit value from the header buffer
+   *  @param offset offset in bytes
+   *  @return value in local byte order
+   */
+  Uint32 getUint32(size_t offset) const;
+
+  /// handle the element header after it has been read completely
+  void processHeader();
+
+  /** stop scanning
+   *  @param status the reason for stopping
+   */
+  void finish(const OFCondition &status);
+
+  /// tags of the requested elements
+  OFVector<DcmTagKey> tags_;
+
+  /// values of the requested elements
+  OFVector<OFString> values_;
+
+  /// flags indicating which of the requested elements have been found
+  OFVector<OFBool> found_;
+
+  /// largest requested tag
+  DcmTagKey maxTag_;
+
+  /// OFTrue if the dataset is little endian
+  OFBool littleEndian_;
+
+  /// OFTrue if the dataset is encoded with explicit VR
+  OFBool explicitVR_;
+
+  /// nesting levels within elements of undefined length, empty at top level
+  OFVector<Level> levels_;
+
+  /// buffer for the element header being read
+  Uint8 header_[12];
+
+  /// number of bytes of the element header read so far
+  size_t headerLength_;
+
+  /// format of the element header being read
+  E_HeaderFormat headerFormat_;
+
+  /// number of bytes to be skipped
+  Uint32 skip_;
+
+  /// index of the requested element whose value is being read, or -1
+  long current_;
+
+  /// number of bytes of the current value still to be read
+  Uint32 remaining_;
+
+  /// number of requested elements found so far
+  size_t numFound_;
+
+  /// OFTrue if scanning has finished
+  OFBool finished_;
+
+  /// status of the scanner
+  OFCondition status_;
+};
+
+#endif
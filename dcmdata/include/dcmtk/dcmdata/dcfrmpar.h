@@ -0,0 +1,436 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: helper classes for processing the frames of a multi-frame
+ *    image in parallel, e.g. in compression and decompression codecs
+ *
+ */
+
+#ifndef DCFRMPAR_H
+#define DCFRMPAR_H
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+#include "dcmtk/ofstd/ofcond.h"
+#include "dcmtk/ofstd/ofglobal.h"
+#include "dcmtk/ofstd/ofvector.h"
+#include "dcmtk/ofstd/ofthread.h"
+#include "dcmtk/ofstd/ofstring.h"
+#include "dcmtk/dcmdata/dctypes.h"
+#include "dcmtk/dcmdata/dcofsetl.h"
+
+class DcmPixelSequence;
+class DcmItem;
+class DcmCodec;
+class DcmCodecParameter;
+class DcmRepresentationParameter;
+
+/** Maximum number of threads used by the codecs in order to compress or
+ *  decompress the frames of a multi-frame image in parallel. Each frame is
+ *  still processed by a single thread, i.e. single-frame images do not
+ *  benefit from this setting, except for the RLE codec, which also processes
+ *  the stripes of a frame in parallel if there are less frames than threads.
+ *  If the toolkit has been compiled without thread support, this flag has
+ *  no effect.
+ *  Default is 1, i.e. frames are processed one after another.
+ */
+extern DCMTK_DCMDATA_EXPORT OFGlobal<Uint32> dcmCodecMaxThreads; /* default 1 */
+
+
+/** abstract base class for an operation that is performed independently on
+ *  each frame of a multi-frame image, such as the compression or decompression
+ *  of a frame. Derived classes implement processFrame() for a single frame,
+ *  run() distributes the frames over a number of worker threads.
+ *  The worker threads are taken from a pool that is shared by all instances
+ *  of this class (including the parallel loops of the image processing
+ *  modules). Threads are created on demand and kept until the application
+ *  terminates, so that no threads are started for each call of run().
+ *  Implementations of processFrame() must be thread-safe. In particular,
+ *  they must not access the items of a dataset or pixel sequence, since
+ *  even read access to these may modify their internal state.
+ *  processFrame() may call run() of another instance, i.e. nested use
+ *  is possible.
+ */
+class DCMTK_DCMDATA_EXPORT DcmFrameProcessor
+{
+public:
+
+  /// default constructor
+  DcmFrameProcessor();
+
+  /// destructor
+  virtual ~DcmFrameProcessor();
+
+  /** process the given frames by calling processFrame() for each of them.
+   *  If more than one thread is requested and available, the frames are
+   *  processed in parallel, otherwise one after another in the calling
+   *  thread. No further frames are processed after an error has occurred.
+   *  @param firstFrame number of the first frame to be processed
+   *  @param numberOfFrames number of frames to be processed
+   *  @param numberOfThreads maximum number of threads to be used
+   *  @return EC_Normal if all frames have been processed successfully,
+   *    otherwise the error that occurred for the lowest frame number
+   */
+  OFCondition run(Uint32 firstFrame,
+                  Uint32 numberOfFrames,
+                  Uint32 numberOfThreads = dcmCodecMaxThreads.get());
+
+protected:
+
+  /** process a single frame. Is called exactly once for each frame, possibly
+   *  by different threads at the same time.
+   *  @param frameNo number of the frame to be processed
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition processFrame(Uint32 frameNo) = 0;
+
+private:
+
+  /// pool thread calling processFrames() for the processors handed to it
+  class Worker;
+
+  // Needed to keep MS VC6 happy
+  friend class Worker;
+
+  /// the thread pool creates the worker threads
+  friend class DcmFrameProcessorPool;
+
+  /// private undefined copy constructor
+  DcmFrameProcessor(const DcmFrameProcessor&);
+
+  /// private undefined copy assignment operator
+  DcmFrameProcessor& operator=(const DcmFrameProcessor&);
+
+  /** process frames until all frames have been handed out or an error has
+   *  occurred. Executed by each worker thread.
+   */
+  void processFrames();
+
+#ifdef WITH_THREADS
+  /// mutex guarding the frame counter and the result
+  OFMutex mutex_;
+
+  /// posted by each pool thread after it has finished processing frames
+  OFSemaphore finished_;
+#endif
+
+  /// next frame to be processed
+  Uint32 nextFrame_;
+
+  /// end of the range of frames to be processed, or frame that failed first
+  Uint32 endFrame_;
+
+  /// error that occurred for the frame endFrame_, EC_Normal if none
+  OFCondition result_;
+};
+
+
+/** abstract base class for the compression of the frames of a multi-frame
+ *  image. Derived classes implement compressFrame() for a single frame.
+ *  The frames are compressed in batches, in parallel if requested, and are
+ *  then appended to the pixel sequence in frame order. The result is thus
+ *  independent of the number of threads used.
+ */
+class DCMTK_DCMDATA_EXPORT DcmFrameCompressor: private DcmFrameProcessor
+{
+public:
+
+  /// default constructor
+  DcmFrameCompressor();
+
+  /// destructor
+  virtual ~DcmFrameCompressor();
+
+  /** compress all frames and append them to the given pixel sequence.
+   *  No further frames are compressed after an error has occurred.
+   *  @param pixelSequence pixel sequence to which the compressed frames are
+   *    appended, must not be NULL
+   *  @param offsetList list of offset table entries, an entry is appended
+   *    for each frame
+   *  @param numberOfFrames number of frames to be compressed
+   *  @param fragmentSize maximum fragment size (in kbytes), 0 for unlimited
+   *  @param compressedSize returns the total size of the compressed frames
+   *  @param numberOfThreads maximum number of threads to be used
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition compress(DcmPixelSequence *pixelSequence,
+                       DcmOffsetList &offsetList,
+                       Uint32 numberOfFrames,
+                       Uint32 fragmentSize,
+                       size_t &compressedSize,
+                       Uint32 numberOfThreads = dcmCodecMaxThreads.get());
+
+protected:
+
+  /** prepare a batch of frames for compression. Is called by the thread that
+   *  called compress() for each batch of frames in ascending order before
+   *  compressFrame() is called for these frames. Can be used for operations
+   *  that are not thread-safe, such as rendering the frames of a DicomImage.
+   *  The default implementation does nothing.
+   *  @param firstFrame number of the first frame of the batch
+   *  @param numberOfFrames number of frames in the batch
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition prepareFrames(Uint32 firstFrame, Uint32 numberOfFrames);
+
+  /** compress a single frame. Is called exactly once for each frame, possibly
+   *  by different threads at the same time.
+   *  @param frameNo number of the frame to be compressed
+   *  @param compressedData returns the compressed frame in a buffer allocated
+   *    with new[], which is deleted by the caller
+   *  @param compressedLength returns the length of the compressed frame
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition compressFrame(Uint32 frameNo,
+                                    Uint8 *&compressedData,
+                                    Uint32 &compressedLength) = 0;
+
+private:
+
+  /// private undefined copy constructor
+  DcmFrameCompressor(const DcmFrameCompressor&);
+
+  /// private undefined copy assignment operator
+  DcmFrameCompressor& operator=(const DcmFrameCompressor&);
+
+  /** compress the given frame and keep the result for the current batch
+   *  @param frameNo number of the frame to be compressed
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition processFrame(Uint32 frameNo);
+
+  /// delete the compressed frames of the current batch
+  void clearFrames();
+
+  /// number of the first frame of the current batch
+  Uint32 firstFrame_;
+
+  /// compressed frames of the current batch
+  OFVector<Uint8 *> data_;
+
+  /// lengths of the compressed frames of the current batch
+  OFVector<Uint32> length_;
+};
+
+
+/** table of the fragments of a compressed pixel sequence providing direct
+ *  access to the fragment data and to the first fragment of each frame.
+ *  The table is created by a single thread and can then be used by multiple
+ *  threads concurrently, which is not possible for the pixel sequence itself.
+ */
+class DCMTK_DCMDATA_EXPORT DcmFragmentTable
+{
+public:
+
+  /// default constructor, creates an empty table
+  DcmFragmentTable();
+
+  /** fill the table from the given pixel sequence. The values of all pixel
+   *  items are loaded into memory. The start fragments of the frames are
+   *  determined like in DcmCodec::determineStartFragment(), i.e. from the
+   *  number of fragments or from the basic offset table. If this fails,
+   *  the table is still usable but hasFrameIndex() returns OFFalse.
+   *  @param pixSeq compressed pixel sequence, must not be NULL
+   *  @param numberOfFrames number of frames of the image
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition create(DcmPixelSequence *pixSeq, Uint32 numberOfFrames);
+
+  /** get number of fragments including the basic offset table
+   *  @return number of fragments
+   */
+  Uint32 numberOfFragments() const
+  {
+    return OFstatic_cast(Uint32, length_.size());
+  }
+
+  /** get the data of the given fragment
+   *  @param fragment index of the fragment, starting with 0 for the offset table
+   *  @return pointer to the fragment data, may be NULL for an empty fragment
+   */
+  Uint8 *getData(Uint32 fragment) const
+  {
+    return data_[fragment];
+  }
+
+  /** get the length of the given fragment in bytes
+   *  @param fragment index of the fragment, starting with 0 for the offset table
+   *  @return length of the fragment
+   */
+  Uint32 getLength(Uint32 fragment) const
+  {
+    return length_[fragment];
+  }
+
+  /** check whether the fragments of each frame are known
+   *  @return OFTrue if getStartFragment() and getEndFragment() can be used
+   */
+  OFBool hasFrameIndex() const
+  {
+    return !start_.empty();
+  }
+
+  /** get the index of the first fragment of the given frame.
+   *  May only be called if hasFrameIndex() returns OFTrue.
+   *  @param frameNo frame number, starting with 0
+   *  @return index of the first fragment
+   */
+  Uint32 getStartFragment(Uint32 frameNo) const
+  {
+    return start_[frameNo];
+  }
+
+  /** get the index of the first fragment following the given frame.
+   *  May only be called if hasFrameIndex() returns OFTrue.
+   *  @param frameNo frame number, starting with 0
+   *  @return index of the first fragment not belonging to the frame
+   */
+  Uint32 getEndFragment(Uint32 frameNo) const
+  {
+    return (frameNo + 1 < start_.size()) ? start_[frameNo + 1] : numberOfFragments();
+  }
+
+private:
+
+  /// pointers to the data of all fragments
+  OFVector<Uint8 *> data_;
+
+  /// lengths of all fragments
+  OFVector<Uint32> length_;
+
+  /// index of the first fragment of each frame, empty if unknown
+  OFVector<Uint32> start_;
+};
+
+
+/** helper class providing the uncompressed frames of a compressed image,
+ *  which are decompressed batch by batch with the decodeFrame() method of a
+ *  decoder codec. Used for transcoding a compressed image frame by frame (see
+ *  DcmCodec::encodeFrames()), so that only the frames of the current batch
+ *  are held in memory in uncompressed form, instead of the complete pixel
+ *  data. Like DcmPixelData::getUncompressedFrame(), the frames are provided
+ *  in the byte order in which the decoder would have stored the complete
+ *  uncompressed pixel data with VR OW in local byte order.
+ *  Since the pixel sequence is accessed, the methods of this class must not
+ *  be called by more than one thread at the same time.
+ */
+class DCMTK_DCMDATA_EXPORT DcmFrameSource
+{
+public:
+
+  /** constructor
+   *  @param decoder codec used to decompress the frames, must not be NULL
+   *  @param decoderParameter codec parameters of the decoder
+   *  @param fromParam representation parameter of the compressed
+   *    representation, may be NULL
+   *  @param fromPixSeq compressed pixel sequence
+   *  @param dataset dataset in which the pixel data element is contained
+   */
+  DcmFrameSource(const DcmCodec *decoder,
+                 const DcmCodecParameter *decoderParameter,
+                 const DcmRepresentationParameter *fromParam,
+                 DcmPixelSequence *fromPixSeq,
+                 DcmItem *dataset);
+
+  /// destructor
+  ~DcmFrameSource();
+
+  /** determine the size of an uncompressed frame from the image attributes
+   *  of the dataset and decompress the first frame in order to determine
+   *  the color model of the decompressed image. Must be called once before
+   *  any of the other methods.
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition init();
+
+  /** get the size of an uncompressed frame in bytes
+   *  @return frame size
+   */
+  Uint32 getFrameSize() const
+  {
+    return frameSize_;
+  }
+
+  /** get the color model of the decompressed frames, which may be different
+   *  from the photometric interpretation of the compressed image
+   *  @return decompressed color model
+   */
+  const OFString& getDecompressedColorModel() const
+  {
+    return colorModel_;
+  }
+
+  /** decompress the given frames, replacing the frames decompressed by the
+   *  previous call. Frames should be requested in ascending order since
+   *  the start fragment of a frame is then known from the previous frame.
+   *  @param firstFrame number of the first frame, starting with 0
+   *  @param numberOfFrames number of frames to be decompressed
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition decompressFrames(Uint32 firstFrame, Uint32 numberOfFrames);
+
+  /** get one of the frames decompressed by the last call of decompressFrames().
+   *  The frame may be modified by the caller, e.g. for byte swapping.
+   *  @param frameNo number of the frame, starting with 0
+   *  @return pointer to the uncompressed frame, NULL if not available
+   */
+  Uint8 *getFrame(Uint32 frameNo) const;
+
+private:
+
+  /// private undefined copy constructor
+  DcmFrameSource(const DcmFrameSource&);
+
+  /// private undefined copy assignment operator
+  DcmFrameSource& operator=(const DcmFrameSource&);
+
+  /// codec used to decompress the frames
+  const DcmCodec *decoder_;
+
+  /// codec parameters of the decoder
+  const DcmCodecParameter *decoderParameter_;
+
+  /// representation parameter of the compressed representation
+  const DcmRepresentationParameter *fromParam_;
+
+  /// compressed pixel sequence
+  DcmPixelSequence *fromPixSeq_;
+
+  /// dataset in which the pixel data element is contained
+  DcmItem *dataset_;
+
+  /// size of an uncompressed frame in bytes
+  Uint32 frameSize_;
+
+  /// distance between two frames in the buffer, i.e. frame size rounded to even
+  Uint32 frameStride_;
+
+  /// color model of the decompressed frames
+  OFString colorModel_;
+
+  /// buffer containing the decompressed frames
+  Uint8 *buffer_;
+
+  /// number of frames that fit into the buffer
+  Uint32 bufferFrames_;
+
+  /// number of the first frame in the buffer
+  Uint32 firstFrame_;
+
+  /// number of frames in the buffer
+  Uint32 numberOfFrames_;
+
+  /// number of the frame following the last decompressed frame
+  Uint32 nextFrame_;
+
+  /// index of the first fragment of nextFrame_
+  Uint32 nextFragment_;
+};
+
+#endif
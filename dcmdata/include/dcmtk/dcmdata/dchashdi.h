@@ -25,6 +25,7 @@
 #include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
 #include "dcmtk/ofstd/oflist.h"
 #include "dcmtk/ofstd/ofstream.h"
+#include "dcmtk/ofstd/oftypes.h"
 #include "dcmtk/dcmdata/dcdefine.h"
 
 class DcmDictEntry;
@@ -110,6 +111,74 @@ private:
 };
 
 
+/** a read-only hash table of dictionary entries based on a minimal perfect
+ *  hash function that has been computed in advance, e.g. by mkdictbi for the
+ *  builtin data dictionary.  Each entry can be found with a single probe of the
+ *  table.  The table only refers to externally managed (usually static) arrays
+ *  of entries and seeds, i.e. it never copies, deletes or allocates anything.
+ */
+class DCMTK_DCMDATA_EXPORT DcmStaticHashDict
+{
+public:
+
+    /// default constructor, creates an empty table
+    DcmStaticHashDict()
+      : entries(NULL), seeds(NULL), count(0)
+        { }
+
+    /** constructor
+     *  @param entryArray array of entries, ordered by their slot in the table
+     *  @param seedArray array of seed values, one for each first level bucket
+     *    (the number of buckets is the same as the number of entries).  A positive
+     *    value is the seed for hash() that maps the keys of the bucket to their
+     *    slots, a negative value -n means that the only key of the bucket is
+     *    stored in slot n-1.
+     *  @param entryCount number of elements in both arrays
+     */
+    DcmStaticHashDict(const DcmDictEntry *entryArray, const Sint32 *seedArray, int entryCount)
+      : entries(entryArray), seeds(seedArray), count(entryCount)
+        { }
+
+    /// @return the number of entries in the table
+    int size() const { return count; }
+
+    /** @param idx index (slot) of the entry, 0..size()-1
+     *  @return pointer to the entry in the given slot
+     */
+    const DcmDictEntry* at(int idx) const;
+
+    /** table lookup for the given tag key and private creator name.
+     *  Only exact matches are found.
+     *  @param key tag key of the entry to be searched for
+     *  @param privCreator private creator name, may be NULL
+     *  @return pointer to entry (if found), otherwise NULL
+     */
+    const DcmDictEntry* get(const DcmTagKey& key, const char *privCreator) const;
+
+    /** compute the hash value of the given tag key and private creator name.
+     *  The first level bucket of a key is given by the hash value for seed 0
+     *  (modulo the table size), its slot by the hash value for the seed of the
+     *  bucket (modulo the table size).
+     *  @param key tag key
+     *  @param privCreator private creator name, may be NULL
+     *  @param seed seed value
+     *  @return hash value
+     */
+    static Uint32 hash(const DcmTagKey& key, const char *privCreator, Uint32 seed);
+
+private:
+
+    /// array of entries, ordered by slot
+    const DcmDictEntry *entries;
+
+    /// array of seed values, one per first level bucket
+    const Sint32 *seeds;
+
+    /// number of entries (and buckets)
+    int count;
+};
+
+
 /** iterator class for traversing a DcmHashDict
  */
 class DCMTK_DCMDATA_EXPORT DcmHashDictIterator
@@ -118,7 +187,7 @@ public:
 
     /// default constructor
     DcmHashDictIterator()
-      : dict(NULL), hindex(0), iterating(OFFalse), iter()
+      : dict(NULL), hindex(0), sindex(0), iterating(OFFalse), iter(), entry(NULL)
         { init(NULL); }
 
     /** constructor, creates iterator to existing hash dictionary
@@ -127,22 +196,24 @@ public:
      *   of hash dictionary, otherwise iterator points to first element
      */
     DcmHashDictIterator(const DcmHashDict* d, OFBool atEnd = OFFalse)
-      : dict(NULL), hindex(0), iterating(OFFalse), iter()
+      : dict(NULL), hindex(0), sindex(0), iterating(OFFalse), iter(), entry(NULL)
         { init(d, atEnd); }
 
     /// copy constructor
     DcmHashDictIterator(const DcmHashDictIterator& i)
-      : dict(i.dict), hindex(i.hindex), iterating(i.iterating), iter(i.iter)
+      : dict(i.dict), hindex(i.hindex), sindex(i.sindex), iterating(i.iterating),
+        iter(i.iter), entry(i.entry)
         { }
 
     /// copy assignment operator
     DcmHashDictIterator& operator=(const DcmHashDictIterator& i)
-        { dict = i.dict; hindex = i.hindex;
-          iterating = i.iterating; iter = i.iter; return *this; }
+        { dict = i.dict; hindex = i.hindex; sindex = i.sindex;
+          iterating = i.iterating; iter = i.iter; entry = i.entry; return *this; }
 
     /// comparison equality
     OFBool operator==(const DcmHashDictIterator& x) const
-        { return (hindex == x.hindex) && (iter == x.iter); }
+        { return (hindex == x.hindex) && (sindex == x.sindex) &&
+                 (iterating == x.iterating) && (!iterating || (iter == x.iter)); }
 
     /// comparison non-equality
     OFBool operator!=(const DcmHashDictIterator& x) const
@@ -150,7 +221,7 @@ public:
 
     /// dereferencing of iterator
     const DcmDictEntry* operator*() const
-        { return (*iter); }
+        { return entry; }
 
     /// pre-increment operator
     DcmHashDictIterator& operator++()
@@ -173,21 +244,38 @@ private:
      */
     void stepUp();
 
+    /** moves the iterator to the next valid position, starting with the
+     *  current one.  The buckets of the hash table are traversed first,
+     *  followed by those entries of the static tables that are not replaced
+     *  by an entry of the hash table.
+     */
+    void seek();
+
     /// pointer to the hash dictionary this iterator traverses
     const DcmHashDict* dict;
 
     /// index of current bucket
     int hindex;
 
+    /// index of current entry in the static tables
+    int sindex;
+
     /// flag indicating if iter is currently valid
     OFBool iterating;
 
     /// iterator for traversing a bucket in the hash table
     DcmDictEntryListIterator iter;
+
+    /// current entry, NULL at the end of the hash dictionary
+    const DcmDictEntry* entry;
 };
 
 
-/** a hash table of pointers to DcmDictEntry objects
+/** a hash table of pointers to DcmDictEntry objects.
+ *  Optionally, static tables of entries (e.g. the builtin data dictionary)
+ *  can be attached, which are searched after the entries inserted by put().
+ *  An inserted entry replaces a static entry with the same tag key and private
+ *  creator name, so runtime-loaded dictionaries act as an overlay.
  */
 class DCMTK_DCMDATA_EXPORT DcmHashDict
 {
@@ -195,20 +283,37 @@ class DCMTK_DCMDATA_EXPORT DcmHashDict
 public:
     /// default constructor
     DcmHashDict()
-     : hashTab(NULL), lowestBucket(0), highestBucket(0), entryCount(0)
+     : hashTab(NULL), lowestBucket(0), highestBucket(0), entryCount(0),
+       replacedCount(0), staticPublic(), staticPrivate()
         { _init(); }
 
+    /** copy constructor.  Creates a deep copy of the entries in the hash table,
+     *  the static tables (if any) are shared with the original.
+     *  @param other hash table to be copied
+     */
+    DcmHashDict(const DcmHashDict& other);
+
     /// destructor
     ~DcmHashDict();
 
-    /** counts total number of entries
+    /** counts total number of entries (including the static tables)
      *  @return number of entries
      */
-    int size() const { return entryCount; }
+    int size() const { return entryCount + staticSize() - replacedCount; }
 
-    /// clears the hash table of all entries
+    /// clears the hash table of all entries and detaches the static tables
     void clear();
 
+    /** attaches static tables of entries, which are searched after the entries
+     *  inserted by put().  Entries of the hash table with the same tag key and
+     *  private creator name as a static entry are replaced (deleted).  The static
+     *  tables must remain valid until clear() is called or the hash table is
+     *  destroyed.
+     *  @param publicDict table of entries without private creator name
+     *  @param privateDict table of entries with private creator name
+     */
+    void setStaticTables(const DcmStaticHashDict& publicDict, const DcmStaticHashDict& privateDict);
+
     /** inserts an entry into hash table (deletes old entry if present)
      *  @param entry pointer to new entry
      */
@@ -243,15 +348,28 @@ public:
 
 private:
 
-    /// private unimplemented copy constructor
-    DcmHashDict(const DcmHashDict &);
-
     /// private unimplemented copy assignment operator
     DcmHashDict &operator=(const DcmHashDict &);
 
     /// performs initialization for given hash table size, called from constructor
     void _init();
 
+    /// @return number of entries in the static tables
+    int staticSize() const { return staticPublic.size() + staticPrivate.size(); }
+
+    /** @param idx index of the entry, 0..staticSize()-1
+     *  @return pointer to the entry of the static tables with the given index
+     */
+    const DcmDictEntry* staticEntry(int idx) const;
+
+    /** looks up the given tag key and private creator name in the entries
+     *  inserted by put() only, i.e. without the static tables (exact match only)
+     *  @param key tag key of the entry to be searched for
+     *  @param privCreator private creator name, may be NULL
+     *  @return pointer to entry (if found), otherwise NULL
+     */
+    const DcmDictEntry* getInserted(const DcmTagKey& key, const char *privCreator) const;
+
     /** compute hash value for given tag key
      *  @param key pointer to tag key
      *  @param privCreator private creator name, may be NULL
@@ -296,9 +414,18 @@ private:
     /// index of highest bucket for which the DcmDictEntryList has been initialized
     int highestBucket;
 
-    /// number of entries in hash table
+    /// number of entries in hash table (not counting the static tables)
     int entryCount;
 
+    /// number of entries of the static tables replaced by entries in hash table
+    int replacedCount;
+
+    /// static table of entries without private creator name
+    DcmStaticHashDict staticPublic;
+
+    /// static table of entries with private creator name
+    DcmStaticHashDict staticPrivate;
+
 };
 
 #endif /* DCHASHDI_H */
@@ -29,6 +29,7 @@
 #include "dcmtk/dcmdata/dcxfer.h"   /* for E_StreamCompression */
 
 class DcmInputStream;
+class DcmFileMapping;
 
 /** pure virtual abstract base class for producers, i.e. the initial node 
  *  of a filter chain in an input stream.
@@ -87,6 +88,26 @@ public:
    */
   virtual void putback(offile_off_t num) = 0;
 
+  /** requests direct access to the next len bytes of the stream without
+   *  copying them, which is only possible if the producer is backed by a
+   *  memory mapped file. If successful, the read position is advanced by
+   *  len bytes and the reference counter of the mapping is increased.
+   *  The caller must call DcmFileMapping::decreaseRefCount() on the returned
+   *  mapping once the data is no longer needed. The default implementation
+   *  always fails.
+   *  @param len number of bytes requested
+   *  @param alignment required alignment of the returned pointer in bytes
+   *  @param mapping returns the mapping the returned pointer refers to
+   *  @return pointer to the requested data, NULL if direct access is not
+   *    possible (in which case the read position remains unchanged)
+   */
+  virtual Uint8 *mapData(offile_off_t /* len */,
+                         size_t /* alignment */,
+                         DcmFileMapping *& /* mapping */)
+  {
+    return NULL;
+  }
+
 };
 
 
@@ -183,6 +204,18 @@ public:
    */
   virtual offile_off_t skip(offile_off_t skiplen);
 
+  /** requests direct access to the next len bytes of the stream without
+   *  copying them. This is only possible if the stream reads from a memory
+   *  mapped file and no compression filter is installed.
+   *  @param len number of bytes requested
+   *  @param alignment required alignment of the returned pointer in bytes
+   *  @param mapping returns the mapping the returned pointer refers to.
+   *    The caller must call DcmFileMapping::decreaseRefCount() on this
+   *    object once the data is no longer needed.
+   *  @return pointer to the requested data, NULL if direct access is not possible
+   */
+  virtual Uint8 *mapData(offile_off_t len, size_t alignment, DcmFileMapping *&mapping);
+
   /** returns the total number of bytes read from the stream so far
    *  @return total number of bytes read from the stream
    */
@@ -25,9 +25,222 @@
 
 #include "dcmtk/config/osconfig.h"
 #include "dcmtk/dcmdata/dcistrma.h"
+#include "dcmtk/ofstd/ofglobal.h"
+#include "dcmtk/ofstd/ofthread.h"
+
+/** This flag defines whether DcmFileProducer maps input files into memory
+ *  instead of reading them through stdio buffers. In this mode, the values
+ *  of large binary elements (e.g. Pixel Data) are not copied into a newly
+ *  allocated buffer but refer directly to the memory mapped file until they
+ *  are modified (copy-on-write). The file must not be modified or truncated
+ *  by another process while it is mapped. If memory mapped files are not
+ *  supported on the current platform, this flag has no effect.
+ *  Default is OFFalse, i.e. files are read through stdio.
+ */
+extern DCMTK_DCMDATA_EXPORT OFGlobal<OFBool> dcmUseMemoryMappedFileInput; /* default OFFalse */
+
+/** Minimum length (in bytes) of an element value that is used directly from a
+ *  memory mapped input file (see dcmUseMemoryMappedFileInput). Shorter values
+ *  are copied into main memory as usual.
+ *  Default is 4096.
+ */
+extern DCMTK_DCMDATA_EXPORT OFGlobal<Uint32> dcmMemoryMappedValueThreshold; /* default 4096 */
+
+/** Maximum number of files kept open in the process-wide cache of shared file
+ *  handles (see DcmSharedFile). If greater than 0, the values of elements that
+ *  remain in file when a dataset is loaded (see parameter maxReadLength of
+ *  DcmFileFormat::loadFile()) are loaded through a cached file handle instead
+ *  of opening the file again for each value. If more files are in use, the
+ *  least recently used ones are closed. Note that a cached file handle still
+ *  refers to the original file if the file is deleted or replaced by another
+ *  one; call DcmSharedFile::clearCache() in this case.
+ *  This flag has no effect if dcmUseMemoryMappedFileInput is enabled, since
+ *  deferred values are then loaded from the mapping created when the dataset
+ *  was read.
+ *  Default is 0, i.e. the file is opened again for each value.
+ */
+extern DCMTK_DCMDATA_EXPORT OFGlobal<Uint32> dcmFileHandleCacheSize; /* default 0 */
+
+
+/** class that manages the life cycle of a file mapped into memory.
+ *  It maintains a thread-safe reference counter, and when this counter
+ *  is decreased to zero, unmaps the file and deletes the handler object itself.
+ *  The file is mapped copy-on-write, i.e. modifications of the mapped data are
+ *  never written back to the file.
+ */
+class DCMTK_DCMDATA_EXPORT DcmFileMapping
+{
+public:
+
+  /** static method that permits creation of instances of
+   *  this class (only) on the heap, never on the stack.
+   *  A newly created instance always has a reference counter of 1.
+   *  @param filename path to the file to be mapped (may contain wide chars
+   *    if support enabled)
+   *  @return pointer to new instance, NULL if the file could not be mapped
+   *    (e.g. because it is empty or memory mapped files are not supported)
+   */
+  static DcmFileMapping *newInstance(const OFFilename &filename);
+
+  /** check whether memory mapped files are supported on the current platform
+   *  @return true if files can be mapped into memory, false otherwise
+   */
+  static OFBool supported();
+
+  /** get pointer to the first byte of the mapped file
+   *  @return pointer to the mapped data
+   */
+  Uint8 *data() const { return data_; }
+
+  /** get number of bytes of the mapped file
+   *  @return size of the mapped file
+   */
+  offile_off_t size() const { return size_; }
+
+  /// increase reference counter for this object
+  void increaseRefCount();
+
+  /** decreases reference counter for this object and unmaps
+   *  the file and deletes this object if the reference counter becomes zero.
+   */
+  void decreaseRefCount();
+
+private:
+
+  /** private constructor.
+   *  Instances of this class are always created through newInstance().
+   *  @param data pointer to the mapped data
+   *  @param size number of bytes mapped
+   */
+  DcmFileMapping(Uint8 *data, offile_off_t size);
+
+  /** private destructor. Instances of this class
+   *  are always deleted through the reference counting methods
+   */
+  virtual ~DcmFileMapping();
+
+  /// private undefined copy constructor
+  DcmFileMapping(const DcmFileMapping& arg);
+
+  /// private undefined copy assignment operator
+  DcmFileMapping& operator=(const DcmFileMapping& arg);
+
+  /** number of references to the mapping.
+   *  Default initialized to 1 upon construction of this object
+   */
+  size_t refCount_;
+
+#ifdef WITH_THREADS
+  /// mutex for MT-safe reference counting
+  OFMutex mutex_;
+#endif
+
+  /// pointer to the mapped data
+  Uint8 *data_;
+
+  /// number of bytes mapped
+  offile_off_t size_;
+};
+
+
+/** class that manages the life cycle of a file that is opened for reading by
+ *  any number of input streams at the same time, possibly in different threads.
+ *  The file is read with positional reads, i.e. the streams do not share a file
+ *  position. It maintains a thread-safe reference counter, and when this counter
+ *  is decreased to zero, closes the file and deletes the object itself.
+ */
+class DCMTK_DCMDATA_EXPORT DcmSharedFile
+{
+public:
+
+  /** static method that permits creation of instances of
+   *  this class (only) on the heap, never on the stack.
+   *  A newly created instance always has a reference counter of 1.
+   *  @param filename name of the file to be opened (may contain wide chars
+   *    if support enabled)
+   *  @return pointer to new instance, NULL if the file could not be opened
+   */
+  static DcmSharedFile *newInstance(const OFFilename &filename);
+
+  /** get an instance for the given file from the process-wide cache of shared
+   *  file handles, opening the file if it is not in the cache yet. The reference
+   *  counter of the returned instance has been increased for the caller.
+   *  @param filename name of the file to be opened
+   *  @return pointer to the instance, NULL if the cache is disabled (see
+   *    dcmFileHandleCacheSize), if the filename uses wide characters or if
+   *    the file could not be opened
+   */
+  static DcmSharedFile *getCachedInstance(const OFFilename &filename);
+
+  /** remove all files from the process-wide cache of shared file handles.
+   *  Files that are still in use are closed as soon as they are released.
+   */
+  static void clearCache();
+
+  /** get number of bytes in the file
+   *  @return size of the file when it was opened
+   */
+  offile_off_t size() const { return size_; }
+
+  /** read the given number of bytes at the given position. Can be called by
+   *  multiple threads at the same time.
+   *  @param buf pointer to memory block, must not be NULL
+   *  @param buflen number of bytes to read
+   *  @param offset position in the file
+   *  @return number of bytes actually read
+   */
+  offile_off_t read(void *buf, offile_off_t buflen, offile_off_t offset);
+
+  /// increase reference counter for this object
+  void increaseRefCount();
+
+  /** decreases reference counter for this object and closes
+   *  the file and deletes this object if the reference counter becomes zero.
+   */
+  void decreaseRefCount();
+
+private:
+
+  /** private constructor.
+   *  Instances of this class are always created through newInstance().
+   */
+  DcmSharedFile();
+
+  /** private destructor. Instances of this class
+   *  are always deleted through the reference counting methods
+   */
+  virtual ~DcmSharedFile();
+
+  /// private undefined copy constructor
+  DcmSharedFile(const DcmSharedFile& arg);
+
+  /// private undefined copy assignment operator
+  DcmSharedFile& operator=(const DcmSharedFile& arg);
+
+  /** number of references to the file.
+   *  Default initialized to 1 upon construction of this object
+   */
+  size_t refCount_;
+
+#ifdef WITH_THREADS
+  /** mutex for MT-safe reference counting, also protects the file
+   *  position on platforms not supporting positional reads
+   */
+  OFMutex mutex_;
+#endif
+
+  /// the file
+  OFFile file_;
+
+  /// number of bytes in the file
+  offile_off_t size_;
+};
 
 
 /** producer class that reads data from a plain file.
+ *  If dcmUseMemoryMappedFileInput is enabled, the file is mapped into
+ *  memory and the producer supports direct access through mapData().
+ *  Alternatively, the producer can read from a shared file.
  */
 class DCMTK_DCMDATA_EXPORT DcmFileProducer: public DcmProducer
 {
@@ -39,9 +252,28 @@ public:
    */
   DcmFileProducer(const OFFilename &filename, offile_off_t offset = 0);
 
+  /** constructor reading from a shared file
+   *  @param file shared file, must not be NULL. The producer takes over
+   *    one reference, i.e. it decreases the reference counter when deleted.
+   *  @param offset byte offset to skip from the start of file
+   */
+  DcmFileProducer(DcmSharedFile *file, offile_off_t offset);
+
+  /** constructor reading from a file that has already been mapped into memory
+   *  @param mapping memory mapped file, must not be NULL. The producer takes
+   *    over one reference, i.e. it decreases the reference counter when deleted.
+   *  @param offset byte offset to skip from the start of file
+   */
+  DcmFileProducer(DcmFileMapping *mapping, offile_off_t offset);
+
   /// destructor
   virtual ~DcmFileProducer();
 
+  /** get the memory mapping of the file
+   *  @return pointer to the mapping, NULL if the file is not mapped into memory
+   */
+  DcmFileMapping *getMapping() const { return mapping_; }
+
   /** returns the status of the producer. Unless the status is good,
    *  the producer will not permit any operation.
    *  @return status, true if good
@@ -87,6 +319,15 @@ public:
    */
   virtual void putback(offile_off_t num);
 
+  /** requests direct access to the next len bytes of the file without
+   *  copying them. Only supported if the file is mapped into memory.
+   *  @param len number of bytes requested
+   *  @param alignment required alignment of the returned pointer in bytes
+   *  @param mapping returns the mapping the returned pointer refers to
+   *  @return pointer to the requested data, NULL if direct access is not possible
+   */
+  virtual Uint8 *mapData(offile_off_t len, size_t alignment, DcmFileMapping *&mapping);
+
 private:
 
   /// private unimplemented copy constructor
@@ -103,6 +344,15 @@ private:
 
   /// number of bytes in file
   offile_off_t size_;
+
+  /// memory mapping of the file, NULL if the file is read through stdio
+  DcmFileMapping *mapping_;
+
+  /// shared file, NULL if the file is read through stdio
+  DcmSharedFile *sharedFile_;
+
+  /// current read position in the memory mapping or shared file
+  offile_off_t pos_;
 };
 
 
@@ -119,13 +369,27 @@ public:
    */
   DcmInputFileStreamFactory(const OFFilename &filename, offile_off_t offset);
 
+  /** constructor for a file that has been mapped into memory. The streams
+   *  created by this factory read from the given mapping instead of mapping
+   *  the file again.
+   *  @param filename name of file to be opened (may contain wide chars
+   *    if support enabled)
+   *  @param offset byte offset to skip from the start of file
+   *  @param mapping memory mapped file, may be NULL. The factory increases
+   *    the reference counter for as long as it exists.
+   */
+  DcmInputFileStreamFactory(const OFFilename &filename, offile_off_t offset, DcmFileMapping *mapping);
+
   /// copy constructor
   DcmInputFileStreamFactory(const DcmInputFileStreamFactory &arg);
 
   /// destructor
   virtual ~DcmInputFileStreamFactory();
 
-  /** create a new input stream object
+  /** create a new input stream object. If the file has been mapped into memory
+   *  already, the stream reads from this mapping. Otherwise, if the cache of
+   *  shared file handles is enabled (see dcmFileHandleCacheSize), the stream
+   *  reads from a cached file handle.
    *  @return pointer to new input stream object
    */
   virtual DcmInputStream *create() const;
@@ -149,6 +413,8 @@ private:
   /// offset in file
   offile_off_t offset_;
 
+  /// memory mapping of the file, may be NULL
+  DcmFileMapping *mapping_;
 };
 
 
@@ -164,6 +430,22 @@ public:
    */
   DcmInputFileStream(const OFFilename &filename, offile_off_t offset = 0);
 
+  /** constructor reading from a shared file
+   *  @param file shared file, must not be NULL. The stream takes over
+   *    one reference, i.e. it decreases the reference counter when deleted.
+   *  @param filename name of the shared file
+   *  @param offset byte offset to skip from the start of file
+   */
+  DcmInputFileStream(DcmSharedFile *file, const OFFilename &filename, offile_off_t offset);
+
+  /** constructor reading from a file that has already been mapped into memory
+   *  @param mapping memory mapped file, must not be NULL. The stream takes over
+   *    one reference, i.e. it decreases the reference counter when deleted.
+   *  @param filename name of the mapped file
+   *  @param offset byte offset to skip from the start of file
+   */
+  DcmInputFileStream(DcmFileMapping *mapping, const OFFilename &filename, offile_off_t offset);
+
   /// destructor
   virtual ~DcmInputFileStream();
 
@@ -1303,6 +1303,15 @@ class DCMTK_DCMDATA_EXPORT DcmItem
                                   DcmStack &resultStack,         // inout
                                   OFBool searchIntoSub );        // in
 
+    /** helper function that determines the position of the first element in
+     *  elementList whose tag is not less than the given tag by binary search.
+     *  This relies on elementList being sorted by tag, as maintained by insert().
+     *  @param tag tag key to be searched
+     *  @return position of the element, or number of elements if all tags are
+     *    less than the given tag
+     */
+    unsigned long findElementPosition(const DcmTagKey &tag);
+
     /** helper function that interprets the given pointer as a pointer to an
      *  array of two characters and checks whether these two characters form
      *  a valid standard DICOM VR.
@@ -35,43 +35,6 @@
 /// index indicating "end of list"
 const unsigned long DCM_EndOfListIndex = OFstatic_cast(unsigned long, -1L);
 
-/** helper class maintaining an entry in a DcmList double-linked list
- */
-class DCMTK_DCMDATA_EXPORT DcmListNode 
-{
-
-public:
-    /** constructor
-     *  @param obj object to be maintained by this list node
-     */
-    DcmListNode( DcmObject *obj );
-
-    /// destructor
-    ~DcmListNode();
-
-    /// return pointer to object maintained by this list node
-    inline DcmObject *value() { return objNodeValue; } 
-
-private:
-    friend class DcmList;
-
-    /// pointer to next node in double-linked list
-    DcmListNode *nextNode;
-
-    /// pointer to previous node in double-linked list
-    DcmListNode *prevNode;
-
-    /// pointer to DcmObject instance maintained by this list entry
-    DcmObject *objNodeValue;
-
-    /// private undefined copy constructor 
-    DcmListNode(const DcmListNode &);
-
-    /// private undefined copy assignment operator 
-    DcmListNode &operator=(const DcmListNode &);
-
-};
-
 /// list position indicator
 typedef enum
 {
@@ -91,9 +54,12 @@ typedef enum
     ELP_next
 } E_ListPos;
 
-/** double-linked list class that maintains pointers to DcmObject instances.
- *  The remove operation does not delete the object pointed to, however,
- *  the destructor will delete all elements pointed to
+/** list class that maintains pointers to DcmObject instances.
+ *  The pointers are stored in a contiguous array, so that positional access
+ *  (seek_to()) takes constant time and appending is amortized constant.
+ *  Inserting or removing in the middle of the list moves the subsequent
+ *  pointers. The remove operation does not delete the object pointed to,
+ *  however, deleteAllElements() will delete all elements pointed to.
  */
 class DCMTK_DCMDATA_EXPORT DcmList 
 {
@@ -143,7 +109,7 @@ public:
     DcmObject *seek(    E_ListPos pos = ELP_next );
 
     /** seek within element in list to given element index
-     *  (i.e. set current element to given index)
+     *  (i.e. set current element to given index). Takes constant time.
      *  @param absolute_position position index < card()
      *  @return pointer to new current object
      */
@@ -159,20 +125,26 @@ public:
     inline unsigned long card() const { return cardinality; }
 
     /// return true if list is empty, false otherwise
-    inline OFBool empty(void) const { return firstNode == NULL; }
+    inline OFBool empty(void) const { return cardinality == 0; }
 
-    /// return true if current node exists, false otherwise
-    inline OFBool valid(void) const { return currentNode != NULL; }
+    /// return true if current element exists, false otherwise
+    inline OFBool valid(void) const { return currentIndex != DCM_EndOfListIndex; }
 
 private:
-    /// pointer to first node in list
-    DcmListNode *firstNode;
+    /** insert object at given index and make it the current element
+     *  @param obj pointer to object
+     *  @param index position index <= card()
+     */
+    void insertAt( DcmObject *obj, unsigned long index );
+
+    /// array of pointers to the objects in the list
+    DcmObject **objects;
 
-    /// pointer to last node in list
-    DcmListNode *lastNode;
+    /// number of entries allocated in the array
+    unsigned long capacity;
 
-    /// pointer to current node in list
-    DcmListNode *currentNode;
+    /// index of current element in list, DCM_EndOfListIndex if none
+    unsigned long currentIndex;
 
     /// number of elements in list
     unsigned long cardinality;
@@ -590,6 +590,35 @@ public:
         OFString& decompressedColorModel,
         DcmFileCache *cache=NULL);
 
+    /** access a range of frames of uncompressed pixel data without loading the
+     *  complete multi-frame object. If the element value has not yet been loaded,
+     *  only the requested frames are read from file, starting directly at the
+     *  byte offset of the first frame. The frames are copied into the buffer
+     *  passed by the caller. This method cannot be used if only a compressed
+     *  version of the pixel data exists; see getUncompressedFrame() for that case.
+     *  @param dataset pointer to DICOM dataset in which this pixel data object is
+     *    located. Used to access rows, columns, samples per pixel etc.
+     *  @param firstFrame number of the first frame, starting with 0
+     *  @param numberOfFrames number of frames to be copied
+     *  @param buffer pointer to buffer allocated by the caller. The buffer
+     *    must be large enough for the given number of frames.
+     *  @param bufSize size of buffer, in bytes
+     *  @param length upon successful return, the number of bytes copied. This is
+     *    less than the size of the requested frames if the pixel data is too short.
+     *  @param cache file cache object that may be passed to multiple subsequent calls
+     *    to this method for the same file; the file cache will then keep a file
+     *    handle open, thus improving performance. Optional, may be NULL
+     *  @return EC_Normal if successful, an error code otherwise
+     */
+    virtual OFCondition getUncompressedFrames(
+        DcmItem *dataset,
+        Uint32 firstFrame,
+        Uint32 numberOfFrames,
+        void *buffer,
+        Uint32 bufSize,
+        Uint32& length,
+        DcmFileCache *cache=NULL);
+
     /** determine color model of the decompressed image
      *  @param dataset pointer to DICOM dataset in which this pixel data object
      *    is located. Used to access photometric interpretation.
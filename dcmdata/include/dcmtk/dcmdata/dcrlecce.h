@@ -28,8 +28,8 @@
 class DcmItem;
 
 /** encoder class for RLE.
- *  This class only supports compression, it neither implements
- *  decoding nor transcoding.
+ *  This class only supports compression, it does not implement decoding.
+ *  Compressed images can be transcoded frame by frame, see encodeFrames().
  */
 class DCMTK_DCMDATA_EXPORT DcmRLECodecEncoder: public DcmCodec
 {
@@ -139,6 +139,26 @@ public:
     const DcmCodecParameter * cp,
     DcmStack & objStack) const;
 
+  /** compresses the frames of a compressed DICOM image, which are decompressed
+   *  batch by batch by the given frame source, and stores the result in the
+   *  given pixSeq element.
+   *  @param frames source of the uncompressed frames
+   *  @param toRepParam representation parameter describing the desired
+   *    compressed representation
+   *  @param pixSeq compressed pixel sequence (pointer to new DcmPixelSequence object
+   *    allocated on heap) returned in this parameter upon success.
+   *  @param cp codec parameters for this codec
+   *  @param objStack stack pointing to the location of the pixel data
+   *    element in the current dataset.
+   *  @return EC_Normal if successful, an error code otherwise.
+   */
+  virtual OFCondition encodeFrames(
+    DcmFrameSource& frames,
+    const DcmRepresentationParameter * toRepParam,
+    DcmPixelSequence * & pixSeq,
+    const DcmCodecParameter * cp,
+    DcmStack & objStack) const;
+
   /** checks if this codec is able to convert from the
    *  given current transfer syntax to the given new
    *  transfer syntax
@@ -178,6 +198,26 @@ private:
   /// private undefined copy assignment operator
   DcmRLECodecEncoder& operator=(const DcmRLECodecEncoder&);
 
+  /** compresses the given uncompressed DICOM image, or the frames provided
+   *  by the given frame source, and stores the result in the given pixSeq element.
+   *  @param pixelData pointer to the uncompressed image data in OW format
+   *    and local byte order, NULL if frames is used
+   *  @param length of the pixel data field in bytes
+   *  @param frames source of the uncompressed frames, NULL if pixelData is used
+   *  @param pixSeq compressed pixel sequence returned in this parameter upon success.
+   *  @param cp codec parameters for this codec
+   *  @param objStack stack pointing to the location of the pixel data
+   *    element in the current dataset.
+   *  @return EC_Normal if successful, an error code otherwise.
+   */
+  OFCondition encodeImage(
+    const Uint16 * pixelData,
+    const Uint32 length,
+    DcmFrameSource * frames,
+    DcmPixelSequence * & pixSeq,
+    const DcmCodecParameter *cp,
+    DcmStack & objStack) const;
+
   /** create Derivation Description.
    *  @param dataset dataset to be modified
    *  @param ratio image compression ratio. This is the real effective ratio
@@ -169,17 +169,14 @@ public:
   }
 
   /** this method adds a block of bytes to the byte stream to be
-   *  compressed with the RLE compressor.
+   *  compressed with the RLE compressor. Instead of looking at each byte
+   *  separately, runs of identical bytes and stretches of literal bytes
+   *  are detected blockwise (using SIMD instructions where available).
+   *  The result is identical to adding the bytes one by one.
    *  @param buf buffer to be added
    *  @param bufcount number of bytes in buffer
    */
-  inline void add(const unsigned char *buf, size_t bufcount)
-  {
-    if (buf)
-    {
-      while (bufcount--) add(*buf++);
-    }
-  }
+  void add(const unsigned char *buf, size_t bufcount);
 
   /** this method finalizes the compressed RLE stream, i.e. flushes all
    *  pending literal or repeat runs. This method can be called at any
@@ -333,6 +330,16 @@ private:
   /// private undefined copy assignment operator
   DcmRLEEncoder& operator=(const DcmRLEEncoder&);
 
+  /** this method appends the given bytes to the literal run in RLE_buff_,
+   *  flushing a literal run of 128 bytes whenever the buffer is full.
+   *  The repeat run (RLE_prev_, RLE_pcount_) is not modified, i.e. the
+   *  caller must make sure that these are exactly the bytes that add()
+   *  would have appended to the literal run one by one.
+   *  @param buf bytes to be appended
+   *  @param bufcount number of bytes
+   */
+  void appendLiteral(const unsigned char *buf, size_t bufcount);
+
   /** this method moves the given number of bytes from buff_
    *  to currentBlock_ and "flushes" currentBlock_ to
    *  blockList_ if necessary.
@@ -340,8 +347,9 @@ private:
    */
   inline void move(size_t numberOfBytes)
   {
-    size_t i=0;
-    while (i < numberOfBytes)
+    const unsigned char *source = RLE_buff_;
+    size_t count;
+    while (numberOfBytes > 0)
     {
       if (offset_ == DcmRLEEncoder_BLOCKSIZE)
       {
@@ -354,7 +362,13 @@ private:
           break;    // exit while loop
         }
       }
-      currentBlock_[offset_++] = RLE_buff_[i++];
+      // copy as many bytes as fit into the current block
+      count = DcmRLEEncoder_BLOCKSIZE - offset_;
+      if (count > numberOfBytes) count = numberOfBytes;
+      memcpy(currentBlock_ + offset_, source, count);
+      offset_ += count;
+      source += count;
+      numberOfBytes -= count;
     }
   }
 
@@ -44,14 +44,18 @@ class DCMTK_DCMDATA_EXPORT DcmWriteCache
 {
 public:
 
-  /// default constructor. Construction is cheap (no allocation of memory block).
-  DcmWriteCache()
+  /** default constructor. Construction is cheap (no allocation of memory block).
+   *  @param bufferSize size of the buffer in bytes. A buffer matching the size of
+   *    the output stream's buffer, e.g. the PDV buffer of a network association,
+   *    reduces the number of read operations for large elements.
+   */
+  explicit DcmWriteCache(Uint32 bufferSize = DcmWriteCacheBufsize)
   : fcache_()
   , buf_(NULL)
   , owner_(NULL)
   , offset_(0)
   , numBytes_(0)
-  , capacity_(0)
+  , capacity_(bufferSize > 0 ? bufferSize : DcmWriteCacheBufsize)
   , fieldLength_(0)
   , fieldOffset_(0)
   , byteOrder_(EBO_unknown)
@@ -31,6 +31,7 @@
 #include "dcmtk/dcmdata/dcpxitem.h"  /* for DcmPixelItem */
 #include "dcmtk/dcmdata/dcswap.h"    /* for swapIfNecessary */
 #include "dcmtk/dcmdata/dcvrui.h"    /* for DcmUniqueIdentifier */
+#include "dcmtk/dcmdata/dcfrmpar.h"  /* for DcmFrameSource */
 
 // static member variables
 OFList<DcmCodecList *> DcmCodecList::registeredCodecs;
@@ -41,6 +42,19 @@ OFReadWriteLock DcmCodecList::codecLock;
 
 /* --------------------------------------------------------------- */
 
+OFCondition DcmCodec::encodeFrames(
+    DcmFrameSource& /* frames */,
+    const DcmRepresentationParameter * /* toRepParam */,
+    DcmPixelSequence * & /* pixSeq */,
+    const DcmCodecParameter * /* cp */,
+    DcmStack & /* objStack */) const
+{
+  // frame by frame transcoding is not supported unless implemented by a derived class
+  return EC_IllegalCall;
+}
+
+/* --------------------------------------------------------------- */
+
 // DcmCodec static helper methods
 
 OFCondition DcmCodec::insertStringIfMissing(DcmItem *dataset, const DcmTagKey& tag, const char *val)
@@ -517,6 +531,7 @@ OFCondition DcmCodecList::encode(
   if (0 == locker.rdlock())
   {
 #endif
+    OFBool found = OFFalse;
     OFListIterator(DcmCodecList *) first = registeredCodecs.begin();
     OFListIterator(DcmCodecList *) last = registeredCodecs.end();
     while (first != last)
@@ -526,9 +541,14 @@ OFCondition DcmCodecList::encode(
         if (!toRepParam) toRepParam = (*first)->defaultRepParam;
         result = (*first)->codec->encode(fromRepType, fromParam, fromPixSeq,
                  toRepParam, toPixSeq, (*first)->codecParameter, pixelStack);
+        found = OFTrue;
         first = last;
       } else ++first;
     }
+
+    // no codec transcodes directly, try to decompress and compress frame by frame
+    if (!found) result = encodeFrames(fromRepType, fromParam, fromPixSeq,
+                         toRepType, toRepParam, toPixSeq, pixelStack);
 #ifdef WITH_THREADS
   } else result = EC_IllegalCall;
 #endif
@@ -536,6 +556,64 @@ OFCondition DcmCodecList::encode(
   return result;
 }
 
+OFCondition DcmCodecList::encodeFrames(
+  const E_TransferSyntax fromRepType,
+  const DcmRepresentationParameter * fromParam,
+  DcmPixelSequence * fromPixSeq,
+  const E_TransferSyntax toRepType,
+  const DcmRepresentationParameter * toRepParam,
+  DcmPixelSequence * & toPixSeq,
+  DcmStack & pixelStack)
+{
+  // look for a decoder and an encoder
+  const DcmCodecList *decoder = NULL;
+  const DcmCodecList *encoder = NULL;
+  OFListIterator(DcmCodecList *) first = registeredCodecs.begin();
+  OFListIterator(DcmCodecList *) last = registeredCodecs.end();
+  while (first != last)
+  {
+    if (!decoder && (*first)->codec->canChangeCoding(fromRepType, EXS_LittleEndianExplicit)) decoder = *first;
+    if (!encoder && (*first)->codec->canChangeCoding(EXS_LittleEndianExplicit, toRepType)) encoder = *first;
+    ++first;
+  }
+  if ((decoder == NULL) || (encoder == NULL)) return EC_CannotChangeRepresentation;
+
+  // retrieve pointer to dataset from parameter stack
+  DcmStack localStack(pixelStack);
+  (void)localStack.pop();  // pop pixel data element from stack
+  DcmObject *dobject = localStack.pop(); // this is the item in which the pixel data is located
+  if ((!dobject)||((dobject->ident()!= EVR_dataset) && (dobject->ident()!= EVR_item))) return EC_InvalidTag;
+  DcmItem *dataset = OFstatic_cast(DcmItem *, dobject);
+
+  // decompress the first frame in order to determine the decompressed color model
+  DcmFrameSource frames(decoder->codec, decoder->codecParameter, fromParam, fromPixSeq, dataset);
+  OFCondition result = frames.init();
+  if (result.bad()) return result;
+
+  // update the photometric interpretation like a complete decompression would,
+  // and restore it if the encoder fails
+  OFString photometricInterpretation;
+  const OFString& colorModel = frames.getDecompressedColorModel();
+  OFBool colorModelChanged = OFFalse;
+  if ((dataset->findAndGetOFString(DCM_PhotometricInterpretation, photometricInterpretation).good()) &&
+      (!colorModel.empty()) && (colorModel != photometricInterpretation))
+  {
+    result = dataset->putAndInsertOFStringArray(DCM_PhotometricInterpretation, colorModel);
+    colorModelChanged = OFTrue;
+  }
+
+  if (result.good())
+  {
+    DCMDATA_DEBUG("transcoding pixel data frame by frame");
+    if (!toRepParam) toRepParam = encoder->defaultRepParam;
+    result = encoder->codec->encodeFrames(frames, toRepParam, toPixSeq, encoder->codecParameter, pixelStack);
+  }
+
+  if (result.bad() && colorModelChanged)
+    (void) dataset->putAndInsertOFStringArray(DCM_PhotometricInterpretation, photometricInterpretation);
+  return result;
+}
+
 OFCondition DcmCodecList::encode(
   const E_TransferSyntax fromRepType,
   const Uint16 * pixelData,
@@ -32,8 +32,95 @@
 #define INCLUDE_CSTDIO
 #define INCLUDE_CSTRING
 #define INCLUDE_CCTYPE
+#define INCLUDE_CASSERT
 #include "dcmtk/ofstd/ofstdinc.h"
 
+#if defined(DCMDICT_LOCKFREE_READ) && !defined(HAVE_SYNC_ADD_AND_FETCH)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+#ifdef DCMDICT_LOCKFREE_READ
+
+/* atomic operations used for the lock-free read access to the global data dictionary */
+
+static inline void fullMemoryBarrier()
+{
+#ifdef HAVE_SYNC_ADD_AND_FETCH
+    __sync_synchronize();
+#else
+    MemoryBarrier();
+#endif
+}
+
+template<class T>
+static inline T *loadAcquire(T * const *ptr)
+{
+#if defined(__ATOMIC_ACQUIRE)
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#else
+    T *value = *OFconst_cast(T * const volatile *, ptr);
+    fullMemoryBarrier();
+    return value;
+#endif
+}
+
+static inline long loadAcquire(const volatile long *ptr)
+{
+#if defined(__ATOMIC_ACQUIRE)
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#else
+    long value = *ptr;
+    fullMemoryBarrier();
+    return value;
+#endif
+}
+
+static inline void storeRelease(DcmDataDictionary **ptr, DcmDataDictionary *dict)
+{
+#if defined(__ATOMIC_RELEASE)
+    __atomic_store_n(ptr, dict, __ATOMIC_RELEASE);
+#elif defined(HAVE_SYNC_ADD_AND_FETCH)
+    __sync_synchronize();
+    *OFconst_cast(DcmDataDictionary * volatile *, ptr) = dict;
+#else
+    InterlockedExchangePointer(OFreinterpret_cast(PVOID volatile *, ptr), dict);
+#endif
+}
+
+static inline void storeRelease(volatile long *ptr, long value)
+{
+#if defined(__ATOMIC_RELEASE)
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#else
+    fullMemoryBarrier();
+    *ptr = value;
+#endif
+}
+
+/* the following functions imply a full memory barrier */
+
+static inline OFBool compareAndSwap(volatile long *value, long expected, long desired)
+{
+#ifdef HAVE_SYNC_ADD_AND_FETCH
+    return __sync_bool_compare_and_swap(value, expected, desired);
+#else
+    return InterlockedCompareExchange(value, desired, expected) == expected;
+#endif
+}
+
+template<class T>
+static inline OFBool compareAndSwap(T **ptr, T *expected, T *desired)
+{
+#ifdef HAVE_SYNC_ADD_AND_FETCH
+    return __sync_bool_compare_and_swap(ptr, expected, desired);
+#else
+    return InterlockedCompareExchangePointer(OFreinterpret_cast(PVOID volatile *, ptr), desired, expected) == expected;
+#endif
+}
+
+#endif /* DCMDICT_LOCKFREE_READ */
+
 /*
 ** The separator character between fields in the data dictionary file(s)
 */
@@ -111,12 +198,29 @@ OFBool DcmDataDictionary::loadSkeletonDictionary()
 DcmDataDictionary::DcmDataDictionary(OFBool loadBuiltin, OFBool loadExternal)
   : hashDict(),
     repDict(),
+    staticRepDict(NULL),
+    staticRepPublicCount(0),
+    staticRepCount(0),
     skeletonCount(0),
     dictionaryLoaded(OFFalse)
 {
     reloadDictionaries(loadBuiltin, loadExternal);
 }
 
+DcmDataDictionary::DcmDataDictionary(const DcmDataDictionary &other)
+  : hashDict(other.hashDict),
+    repDict(),
+    staticRepDict(other.staticRepDict),
+    staticRepPublicCount(other.staticRepPublicCount),
+    staticRepCount(other.staticRepCount),
+    skeletonCount(other.skeletonCount),
+    dictionaryLoaded(other.dictionaryLoaded)
+{
+    /* the order of the repeating tag entries is relevant for the lookup */
+    for (DcmDictEntryListConstIterator iter(other.repDict.begin()); iter != other.repDict.end(); ++iter)
+        repDict.push_back(new DcmDictEntry(**iter));
+}
+
 DcmDataDictionary::~DcmDataDictionary()
 {
     clear();
@@ -127,6 +231,9 @@ void DcmDataDictionary::clear()
 {
    hashDict.clear();
    repDict.clear();
+   staticRepDict = NULL;
+   staticRepPublicCount = 0;
+   staticRepCount = 0;
    skeletonCount = 0;
    dictionaryLoaded = OFFalse;
 }
@@ -635,10 +742,59 @@ DcmDataDictionary::loadExternalDictionaries()
 }
 
 
+void
+DcmDataDictionary::setStaticEntries(const DcmStaticHashDict& publicDict,
+                                    const DcmStaticHashDict& privateDict,
+                                    const DcmDictEntry* repEntries,
+                                    int repPublicCount,
+                                    int repCount)
+{
+    hashDict.setStaticTables(publicDict, privateDict);
+    copyStaticRepeatingEntries();
+    /* remove repeating tag entries that are replaced by a static one */
+    DcmDictEntryListIterator iter(repDict.begin());
+    while (iter != repDict.end()) {
+        DcmDictEntry* e = *iter++;
+        for (int i = 0; i < repCount; ++i) {
+            if (e->setEQ(repEntries[i])) {
+#ifdef PRINT_REPLACED_DICTIONARY_ENTRIES
+                DCMDATA_WARN("replacing " << *e);
+#endif
+                repDict.remove(e);
+                delete e;
+                break;
+            }
+        }
+    }
+    staticRepDict = repEntries;
+    staticRepPublicCount = repPublicCount;
+    staticRepCount = repCount;
+    /* the position of other entries in the list depends on the static ones */
+    if (!repDict.empty())
+        copyStaticRepeatingEntries();
+}
+
+void
+DcmDataDictionary::copyStaticRepeatingEntries()
+{
+    if (staticRepCount > 0) {
+        const DcmDictEntry* entries = staticRepDict;
+        const int count = staticRepCount;
+        /* detach the static entries first, since addEntry() calls this method */
+        staticRepDict = NULL;
+        staticRepPublicCount = 0;
+        staticRepCount = 0;
+        for (int i = 0; i < count; ++i)
+            addEntry(new DcmDictEntry(entries[i]));
+    }
+}
+
 void
 DcmDataDictionary::addEntry(DcmDictEntry* e)
 {
     if (e->isRepeating()) {
+        /* the order of all repeating tag entries is relevant */
+        copyStaticRepeatingEntries();
         /*
          * Find the best position in repeating tag list
          * Existing entries are replaced if the ranges and repetition
@@ -685,6 +841,8 @@ DcmDataDictionary::deleteEntry(const DcmDictEntry& entry)
     e = OFconst_cast(DcmDictEntry *, findEntry(entry));
     if (e != NULL) {
         if (e->isRepeating()) {
+            copyStaticRepeatingEntries();
+            e = OFconst_cast(DcmDictEntry *, findEntry(entry));
             repDict.remove(e);
             delete e;
         } else {
@@ -708,6 +866,12 @@ DcmDataDictionary::findEntry(const DcmDictEntry& entry) const
                 e = *iter;
             }
         }
+        for (int i = 0; !found && i < staticRepCount; ++i) {
+            if (entry.setEQ(staticRepDict[i])) {
+                found = OFTrue;
+                e = staticRepDict + i;
+            }
+        }
     } else {
         e = hashDict.get(entry, entry.getPrivateCreator());
     }
@@ -734,6 +898,15 @@ DcmDataDictionary::findEntry(const DcmTagKey& key, const char *privCreator) cons
                 e = *iter;
             }
         }
+        /* the static entries without private creator come first */
+        const int first = (privCreator == NULL) ? 0 : staticRepPublicCount;
+        const int count = (privCreator == NULL) ? staticRepPublicCount : staticRepCount;
+        for (int i = first; !found && i < count; ++i) {
+            if (staticRepDict[i].contains(key, privCreator)) {
+                found = OFTrue;
+                e = staticRepDict + i;
+            }
+        }
     }
     return e;
 }
@@ -771,6 +944,12 @@ DcmDataDictionary::findEntry(const char *name) const
                 e = *iter2;
             }
         }
+        for (int i = 0; !found && i < staticRepCount; ++i) {
+            if (staticRepDict[i].contains(name)) {
+                found = OFTrue;
+                e = staticRepDict + i;
+            }
+        }
     }
 
     if (e == NULL && ePrivate != NULL) {
@@ -787,7 +966,15 @@ DcmDataDictionary::findEntry(const char *name) const
 
 GlobalDcmDataDictionary::GlobalDcmDataDictionary()
   : dataDict(NULL)
-#ifdef WITH_THREADS
+#ifdef DCMDICT_LOCKFREE_READ
+  , modifiedDict(NULL)
+  , replacedDicts()
+  , replacedDictsPending(OFFalse)
+  , epoch(0)
+  , threadSlots(NULL)
+  , threadSlot(releaseThreadSlot)
+  , dataDictLock()
+#elif defined(WITH_THREADS)
   , dataDictLock()
 #endif
 {
@@ -797,8 +984,186 @@ GlobalDcmDataDictionary::~GlobalDcmDataDictionary()
 {
   /* No threads may be active any more, so no locking needed */
   delete dataDict;
+#ifdef DCMDICT_LOCKFREE_READ
+  OFListIterator(ReplacedDict) iter = replacedDicts.begin();
+  while (iter != replacedDicts.end())
+    delete (iter++)->dict;
+  while (threadSlots)
+  {
+    ThreadSlot *slot = threadSlots;
+    threadSlots = slot->next;
+    delete slot;
+  }
+#endif
+}
+
+#ifdef DCMDICT_LOCKFREE_READ
+
+void GlobalDcmDataDictionary::createDataDict()
+{
+  /* Make sure only one thread tries to initialize the dictionary */
+  dataDictLock.lock();
+#ifdef DONT_LOAD_EXTERNAL_DICTIONARIES
+  const OFBool loadExternal = OFFalse;
+#else
+  const OFBool loadExternal = OFTrue;
+#endif
+  /* Make sure no other thread managed to create the dictionary
+   * before we got our lock. */
+  if (!dataDict)
+    publishDataDict(new DcmDataDictionary(OFTrue /*loadBuiltin*/, loadExternal));
+  dataDictLock.unlock();
+}
+
+void GlobalDcmDataDictionary::publishDataDict(DcmDataDictionary *dict)
+{
+  /* Make sure that the new dictionary is completely visible to other
+   * threads before the pointer is replaced.  The new epoch starts after
+   * the replacement, so a reader that sees the new epoch also sees the
+   * new dictionary. */
+  DcmDataDictionary *oldDict = dataDict;
+  storeRelease(&dataDict, dict);
+  storeRelease(&epoch, epoch + 1);
+  /* The old dictionary might still be used by other threads */
+  if (oldDict)
+  {
+    ReplacedDict replaced;
+    replaced.dict = oldDict;
+    replaced.epoch = epoch;
+    replacedDicts.push_back(replaced);
+    replacedDictsPending = OFTrue;
+  }
+}
+
+void GlobalDcmDataDictionary::deleteReplacedDicts()
+{
+  if (replacedDicts.empty())
+    return;
+  /* A reader announces its epoch before it loads the current dictionary, so
+   * it can only use dictionaries that were replaced in a later epoch.  The
+   * barrier makes sure that a reader either sees the dictionary published
+   * by the caller or its epoch is seen here (and the readers do the same). */
+  fullMemoryBarrier();
+  long oldestEpoch = epoch;
+  for (ThreadSlot *slot = loadAcquire(&threadSlots); slot != NULL; slot = slot->next)
+  {
+    const long readerEpoch = slot->epoch;
+    if ((readerEpoch >= 0) && (readerEpoch < oldestEpoch))
+      oldestEpoch = readerEpoch;
+  }
+  OFListIterator(ReplacedDict) iter = replacedDicts.begin();
+  while (iter != replacedDicts.end())
+  {
+    if (iter->epoch <= oldestEpoch)
+    {
+      delete iter->dict;
+      iter = replacedDicts.erase(iter);
+    }
+    else
+      ++iter;
+  }
+  replacedDictsPending = !replacedDicts.empty();
+}
+
+GlobalDcmDataDictionary::ThreadSlot *GlobalDcmDataDictionary::getThreadSlot()
+{
+  void *value = NULL;
+  threadSlot.get(value);
+  ThreadSlot *slot = OFstatic_cast(ThreadSlot *, value);
+  if (!slot)
+  {
+    /* Reuse the slot of a terminated thread, if any */
+    for (slot = loadAcquire(&threadSlots); slot != NULL; slot = slot->next)
+    {
+      if ((slot->owned == 0) && compareAndSwap(&slot->owned, 0, 1))
+        break;
+    }
+    if (!slot)
+    {
+      slot = new ThreadSlot;
+      slot->epoch = -1;
+      slot->owned = 1;
+      do {
+        slot->next = loadAcquire(&threadSlots);
+      } while (!compareAndSwap(&threadSlots, slot->next, slot));
+    }
+    slot->readDepth = 0;
+    slot->writeLocked = OFFalse;
+    threadSlot.set(slot);
+  }
+  return slot;
+}
+
+void GlobalDcmDataDictionary::releaseThreadSlot(void *slot)
+{
+  /* The thread has terminated, so it is not reading any more */
+  ThreadSlot *released = OFstatic_cast(ThreadSlot *, slot);
+  storeRelease(&released->epoch, -1);
+  storeRelease(&released->owned, 0);
+}
+
+const DcmDataDictionary& GlobalDcmDataDictionary::rdlock()
+{
+  ThreadSlot *slot = getThreadSlot();
+  /* unlock() could not tell a read lock from the write lock */
+  assert(!slot->writeLocked);
+  /* The current dictionary is never modified, so no lock is needed.  The
+   * current epoch is announced before the dictionary is loaded, so a
+   * replaced dictionary is not deleted while it is still used by this
+   * thread.  Nested read locks are covered by the outermost one. */
+  if (slot->readDepth++ == 0)
+  {
+    slot->epoch = loadAcquire(&epoch);
+    fullMemoryBarrier();
+  }
+  DcmDataDictionary *dict = loadAcquire(&dataDict);
+  if (!dict)
+  {
+    createDataDict();
+    dict = loadAcquire(&dataDict);
+  }
+  return *dict;
 }
 
+DcmDataDictionary& GlobalDcmDataDictionary::wrlock()
+{
+  if (!loadAcquire(&dataDict))
+    createDataDict();
+  ThreadSlot *slot = getThreadSlot();
+  assert(!slot->writeLocked);
+  dataDictLock.lock();
+  /* Modify a copy of the current dictionary, which is published by unlock() */
+  modifiedDict = new DcmDataDictionary(*dataDict);
+  slot->writeLocked = OFTrue;
+  return *modifiedDict;
+}
+
+void GlobalDcmDataDictionary::unlock()
+{
+  ThreadSlot *slot = getThreadSlot();
+  if (slot->writeLocked)
+  {
+    slot->writeLocked = OFFalse;
+    publishDataDict(modifiedDict);
+    modifiedDict = NULL;
+    deleteReplacedDicts();
+    dataDictLock.unlock();
+  }
+  else if (--slot->readDepth == 0)
+  {
+    storeRelease(&slot->epoch, -1);
+    /* The reader deletes the replaced dictionaries (if possible),
+     * but never waits for a writer */
+    if (replacedDictsPending && (dataDictLock.trylock() == 0))
+    {
+      deleteReplacedDicts();
+      dataDictLock.unlock();
+    }
+  }
+}
+
+#else /* DCMDICT_LOCKFREE_READ */
+
 void GlobalDcmDataDictionary::createDataDict()
 {
   /* Make sure only one thread tries to initialize the dictionary */
@@ -864,6 +1229,8 @@ void GlobalDcmDataDictionary::unlock()
 #endif
 }
 
+#endif /* DCMDICT_LOCKFREE_READ */
+
 OFBool GlobalDcmDataDictionary::isDictionaryLoaded()
 {
   OFBool result = rdlock().isDictionaryLoaded();
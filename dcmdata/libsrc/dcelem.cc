@@ -35,6 +35,7 @@
 #include "dcmtk/dcmdata/dcobject.h"
 #include "dcmtk/dcmdata/dcswap.h"
 #include "dcmtk/dcmdata/dcistrma.h"    /* for class DcmInputStream */
+#include "dcmtk/dcmdata/dcistrmf.h"    /* for class DcmFileMapping */
 #include "dcmtk/dcmdata/dcostrma.h"    /* for class DcmOutputStream */
 #include "dcmtk/dcmdata/dcfcache.h"    /* for class DcmFileCache */
 #include "dcmtk/dcmdata/dcwcache.h"    /* for class DcmWriteCache */
@@ -54,7 +55,8 @@ DcmElement::DcmElement(const DcmTag &tag,
   : DcmObject(tag, len),
     fByteOrder(gLocalByteOrder),
     fLoadValue(NULL),
-    fValue(NULL)
+    fValue(NULL),
+    fMapping(NULL)
 {
 }
 
@@ -63,7 +65,8 @@ DcmElement::DcmElement(const DcmElement &elem)
   : DcmObject(elem),
     fByteOrder(elem.fByteOrder),
     fLoadValue(NULL),
-    fValue(NULL)
+    fValue(NULL),
+    fMapping(NULL)
 {
     if (elem.fValue)
     {
@@ -135,16 +138,9 @@ DcmElement &DcmElement::operator=(const DcmElement &obj)
 {
   if (this != &obj)
   {
-#if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
-    // if created with the nothrow version it must also be deleted with
-    // the nothrow version else memory error.
-    operator delete[] (fValue, std::nothrow);
-#else
-    delete[] fValue;
-#endif
+    deleteValueField();
     delete fLoadValue;
     fLoadValue = NULL;
-    fValue = NULL;
 
     DcmObject::operator=(obj);
     fByteOrder = obj.fByteOrder;
@@ -258,13 +254,7 @@ OFCondition DcmElement::copyFrom(const DcmObject& rhs)
 
 DcmElement::~DcmElement()
 {
-#if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
-    // if created with the nothrow version it must also be deleted with
-    // the nothrow version else memory error.
-    operator delete[] (fValue, std::nothrow);
-#else
-    delete[] fValue;
-#endif
+    deleteValueField();
     delete fLoadValue;
 }
 
@@ -275,14 +265,7 @@ DcmElement::~DcmElement()
 OFCondition DcmElement::clear()
 {
     errorFlag = EC_Normal;
-#if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
-    // if created with the nothrow version it must also be deleted with
-    // the nothrow version else memory error.
-    operator delete[] (fValue, std::nothrow);
-#else
-    delete[] fValue;
-#endif
-    fValue = NULL;
+    deleteValueField();
     delete fLoadValue;
     fLoadValue = NULL;
     setLengthField(0);
@@ -344,7 +327,11 @@ OFBool DcmElement::canWriteXfer(const E_TransferSyntax newXfer,
 OFCondition DcmElement::detachValueField(OFBool copy)
 {
     OFCondition l_error = EC_Normal;
-    if (getLengthField() != 0)
+    /* a value that refers to a memory mapped file cannot be handed over to the caller, */
+    /* so copy it into main memory first */
+    if (fMapping)
+        l_error = copyMappedValue();
+    if (l_error.good() && (getLengthField() != 0))
     {
         if (copy)
         {
@@ -645,7 +632,15 @@ OFCondition DcmElement::loadValue(DcmInputStream *inStream)
             {
                 /* if the object which holds this element's value does not yet exist, create it */
                 if (!fValue)
-                    fValue = newValueField(); /* also set errorFlag in case of error */
+                {
+                    /* large binary values may refer directly to a memory mapped input file */
+                    if ((getTransferredBytes() == 0) && isMappableValue())
+                        fValue = readStream->mapData(getLengthField(), getTag().getVR().getValueWidth(), fMapping);
+                    if (fValue)
+                        setTransferredBytes(getLengthField());
+                    else
+                        fValue = newValueField(); /* also set errorFlag in case of error */
+                }
 
                 /* if object could be created  (i.e. we have an object which can be used to capture this element's */
                 /* value) we need to read a certain amount of bytes from the stream */
@@ -691,6 +686,86 @@ OFCondition DcmElement::loadValue(DcmInputStream *inStream)
 // ********************************
 
 
+OFBool DcmElement::isMappableValue()
+{
+    /* odd length values and strings need an additional pad byte */
+    const Uint32 lengthField = getLengthField();
+    if ((lengthField & 1) || (lengthField < dcmMemoryMappedValueThreshold.get()))
+        return OFFalse;
+    switch (getTag().getEVR())
+    {
+        case EVR_OB:
+        case EVR_OD:
+        case EVR_OF:
+        case EVR_OW:
+        case EVR_ox:
+        case EVR_UN:
+        case EVR_UNKNOWN:
+        case EVR_pixelItem:
+            return OFTrue;
+        default:
+            return OFFalse;
+    }
+}
+
+
+OFCondition DcmElement::copyMappedValue()
+{
+    OFCondition l_error = EC_Normal;
+    if (fMapping)
+    {
+        /* mapped values always have an even length, so no pad byte is needed */
+        Uint8 *newValue;
+#ifdef HAVE_STD__NOTHROW
+        // we want to use a non-throwing new here if available
+        newValue = new (std::nothrow) Uint8[getLengthField()];
+#else
+        /* make sure that the pointer is set to NULL in case of error */
+        try
+        {
+            newValue = new Uint8[getLengthField()];
+        }
+        catch (STD_NAMESPACE bad_alloc const &)
+        {
+            newValue = NULL;
+        }
+#endif
+        if (newValue)
+        {
+            memcpy(newValue, fValue, size_t(getLengthField()));
+            fMapping->decreaseRefCount();
+            fMapping = NULL;
+            fValue = newValue;
+        } else
+            l_error = EC_MemoryExhausted;
+    }
+    return l_error;
+}
+
+
+void DcmElement::deleteValueField()
+{
+    if (fMapping)
+    {
+        /* the value refers to a memory mapped file and is not owned by this element */
+        fMapping->decreaseRefCount();
+        fMapping = NULL;
+    } else {
+#if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
+        // if created with the nothrow version it must also be deleted with
+        // the nothrow version else memory error.
+        operator delete[] (fValue, std::nothrow);
+#else
+        delete[] fValue;
+#endif
+    }
+    fValue = NULL;
+}
+
+
+// ********************************
+
+
 Uint8 *DcmElement::newValueField()
 {
     Uint8 * value;
@@ -831,13 +906,7 @@ OFCondition DcmElement::changeValue(const void *value,
                     memcpy(newValue, fValue, size_t(getLengthField()));
                     // copy value passed as a parameter to the end
                     memcpy(&newValue[getLengthField()], OFstatic_cast(const Uint8 *, value), size_t(num));
-#if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
-                    // if created with the nothrow version it must also be deleted with
-                    // the nothrow version else memory error.
-                    operator delete[] (fValue, std::nothrow);
-#else
-                    delete[] fValue;
-#endif
+                    deleteValueField();
                     fValue = newValue;
                     setLengthField(getLengthField() + num);
                 } else
@@ -998,17 +1067,7 @@ OFCondition DcmElement::putValue(const void * newValue,
 {
     errorFlag = EC_Normal;
 
-    if (fValue)
-    {
-#if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
-        // if created with the nothrow version it must also be deleted with
-        // the nothrow version else memory error.
-        operator delete[] (fValue, std::nothrow);
-#else
-        delete[] fValue;
-#endif
-    }
-    fValue = NULL;
+    deleteValueField();
 
     if (fLoadValue)
         delete fLoadValue;
@@ -1061,17 +1120,7 @@ OFCondition DcmElement::createUint16Array(const Uint32 /*numWords*/,
 OFCondition DcmElement::createEmptyValue(const Uint32 length)
 {
     errorFlag = EC_Normal;
-    if (fValue)
-    {
-#if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
-        // if created with the nothrow version it must also be deleted with
-        // the nothrow version else memory error.
-        operator delete[] (fValue, std::nothrow);
-#else
-        delete[] fValue;
-#endif
-    }
-    fValue = NULL;
+    deleteValueField();
     if (fLoadValue)
         delete fLoadValue;
     fLoadValue = NULL;
@@ -1177,13 +1226,7 @@ OFCondition DcmElement::read(DcmInputStream &inStream,
                     }
                 }
                 /* if there is already a value for this element, delete this value */
-#if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
-                // if created with the nothrow version it must also be deleted with
-                // the nothrow version else memory error.
-                operator delete[] (fValue, std::nothrow);
-#else
-                delete[] fValue;
-#endif
+                deleteValueField();
                 /* set the transfer state to ERW_inWork */
                 setTransferState(ERW_inWork);
             }
@@ -1794,8 +1837,7 @@ void DcmElement::compact()
   {
     DCMDATA_DEBUG("DcmElement::compact() removed element value of " << getTag()
         << " with " << getTransferredBytes() << " bytes");
-    delete[] fValue;
-    fValue = NULL;
+    deleteValueField();
     setTransferredBytes(0);
   }
 }
@@ -1807,14 +1849,7 @@ OFCondition DcmElement::createValueFromTempFile(DcmInputStreamFactory *factory,
 {
     if (factory && !(length & 1))
     {
-#if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
-        // if created with the nothrow version it must also be deleted with
-        // the nothrow version else memory error.
-        operator delete[] (fValue, std::nothrow);
-#else
-        delete[] fValue;
-#endif
-        fValue = 0;
+        deleteValueField();
         delete fLoadValue;
         fLoadValue = factory;
         fByteOrder = byteOrder;
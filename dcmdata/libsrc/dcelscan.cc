@@ -0,0 +1,264 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: lightweight scanner extracting the values of a few top-level
+ *    elements from an encoded dataset without parsing it into a DcmDataset
+ *
+ */
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+#include "dcmtk/dcmdata/dcelscan.h"
+#include "dcmtk/dcmdata/dcdeftag.h"
+#include "dcmtk/dcmdata/dcerror.h"
+#include "dcmtk/dcmdata/dcvr.h"
+
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+/* maximum length of an element value that is extracted */
+#define DCMELEMENTSCANNER_MAX_VALUE_LENGTH 1024
+
+
+DcmElementScanner::DcmElementScanner()
+: tags_()
+, values_()
+, found_()
+, maxTag_(0, 0)
+, littleEndian_(OFTrue)
+, explicitVR_(OFTrue)
+, levels_()
+, headerLength_(0)
+, headerFormat_(EHF_Unknown)
+, skip_(0)
+, current_(-1)
+, remaining_(0)
+, numFound_(0)
+, finished_(OFTrue)
+, status_(EC_Normal)
+{
+}
+
+
+void DcmElementScanner::addTag(const DcmTagKey &tag)
+{
+  tags_.push_back(tag);
+  values_.push_back(OFString());
+  found_.push_back(OFFalse);
+  if (tag > maxTag_) maxTag_ = tag;
+}
+
+
+void DcmElementScanner::start(E_TransferSyntax xfer)
+{
+  for (size_t i = 0; i < tags_.size(); ++i)
+  {
+    values_[i].clear();
+    found_[i] = OFFalse;
+  }
+  levels_.clear();
+  headerLength_ = 0;
+  headerFormat_ = EHF_Unknown;
+  skip_ = 0;
+  current_ = -1;
+  remaining_ = 0;
+  numFound_ = 0;
+  finished_ = tags_.empty();
+  status_ = EC_Normal;
+
+  DcmXfer xferSyn(xfer);
+  if ((xfer == EXS_Unknown) || (xferSyn.getStreamCompression() != ESC_none))
+    finish(EC_UnsupportedEncoding);
+  littleEndian_ = (xferSyn.getByteOrder() != EBO_BigEndian);
+  explicitVR_ = xferSyn.isExplicitVR();
+}
+
+
+void DcmElementScanner::scan(const void *data, size_t length)
+{
+  const Uint8 *p = OFstatic_cast(const Uint8 *, data);
+  size_t n;
+  while ((length > 0) && !finished_)
+  {
+    if (skip_ > 0)
+    {
+      // skip the value of an element or item we are not interested in
+      n = (length < skip_) ? length : skip_;
+      skip_ -= OFstatic_cast(Uint32, n);
+    }
+    else if (current_ >= 0)
+    {
+      // read the value of a requested element
+      n = (length < remaining_) ? length : remaining_;
+      values_[current_].append(OFreinterpret_cast(const char *, p), n);
+      remaining_ -= OFstatic_cast(Uint32, n);
+      if (remaining_ == 0)
+      {
+        found_[current_] = OFTrue;
+        current_ = -1;
+        if (++numFound_ == tags_.size()) finish(EC_Normal);
+      }
+    }
+    else
+    {
+      // read the next element header, which is processed in steps since
+      // its length depends on the tag and the VR
+      size_t needed = 4;
+      if ((headerFormat_ == EHF_Implicit) || (headerFormat_ == EHF_ExplicitShort)) needed = 8;
+      else if (headerFormat_ == EHF_Explicit) needed = 6;
+      else if (headerFormat_ == EHF_ExplicitLong) needed = 12;
+      n = needed - headerLength_;
+      if (length < n) n = length;
+      memcpy(header_ + headerLength_, p, n);
+      headerLength_ += n;
+      if (headerLength_ == needed) processHeader();
+    }
+    p += n;
+    length -= n;
+  }
+}
+
+
+OFCondition DcmElementScanner::getValue(const DcmTagKey &tag, OFString &value) const
+{
+  for (size_t i = 0; i < tags_.size(); ++i)
+  {
+    if (found_[i] && (tags_[i] == tag))
+    {
+      const OFString &v = values_[i];
+      size_t len = v.find('\\');
+      if (len == OFString_npos) len = v.length();
+      while ((len > 0) && ((v[len - 1] == ' ') || (v[len - 1] == '\0'))) --len;
+      value.assign(v, 0, len);
+      return EC_Normal;
+    }
+  }
+  value.clear();
+  return EC_TagNotFound;
+}
+
+
+Uint16 DcmElementScanner::getUint16(size_t offset) const
+{
+  if (littleEndian_)
+    return OFstatic_cast(Uint16, header_[offset] | (header_[offset + 1] << 8));
+  return OFstatic_cast(Uint16, (header_[offset] << 8) | header_[offset + 1]);
+}
+
+
+Uint32 DcmElementScanner::getUint32(size_t offset) const
+{
+  if (littleEndian_)
+    return OFstatic_cast(Uint32, getUint16(offset)) | (OFstatic_cast(Uint32, getUint16(offset + 2)) << 16);
+  return (OFstatic_cast(Uint32, getUint16(offset)) << 16) | OFstatic_cast(Uint32, getUint16(offset + 2));
+}
+
+
+void DcmElementScanner::processHeader()
+{
+  const DcmTagKey tag(getUint16(0), getUint16(2));
+  const OFBool inSequence = !levels_.empty() && levels_.back().sequence;
+  const OFBool explicitVR = levels_.empty() ? explicitVR_ : levels_.back().explicitVR;
+
+  if (headerFormat_ == EHF_Unknown)
+  {
+    // items and delimitation items never have a VR
+    if (inSequence || (tag.getGroup() == 0xfffe) || !explicitVR) headerFormat_ = EHF_Implicit;
+    else headerFormat_ = EHF_Explicit;
+    return;
+  }
+
+  OFBool unknownVR = OFFalse;
+  if (headerFormat_ == EHF_Explicit)
+  {
+    const char vrName[3] = { OFstatic_cast(char, header_[4]), OFstatic_cast(char, header_[5]), '\0' };
+    const DcmVR vr(vrName);
+    headerFormat_ = vr.usesExtendedLengthEncoding() ? EHF_ExplicitLong : EHF_ExplicitShort;
+    return;
+  }
+
+  Uint32 length = 0;
+  if (headerFormat_ == EHF_Implicit) length = getUint32(4);
+  else if (headerFormat_ == EHF_ExplicitShort) length = getUint16(6);
+  else
+  {
+    length = getUint32(8);
+    // the contents of an UN element of undefined length are encoded with implicit VR
+    unknownVR = (header_[4] == 'U') && (header_[5] == 'N');
+  }
+  headerLength_ = 0;
+  headerFormat_ = EHF_Unknown;
+
+  if (inSequence)
+  {
+    if (tag == DCM_SequenceDelimitationItem) levels_.pop_back();
+    else if (tag != DCM_Item) finish(EC_CorruptedData);
+    else if (length != DCM_UndefinedLength) skip_ = length;
+    else
+    {
+      // item of undefined length, scan its elements
+      Level level;
+      level.sequence = OFFalse;
+      level.explicitVR = explicitVR;
+      levels_.push_back(level);
+    }
+  }
+  else if (tag == DCM_ItemDelimitationItem)
+  {
+    if (levels_.empty()) finish(EC_CorruptedData);
+    else levels_.pop_back();
+  }
+  else if (tag.getGroup() == 0xfffe)
+  {
+    finish(EC_CorruptedData);
+  }
+  else if (levels_.empty() && (tag > maxTag_))
+  {
+    // top-level elements are sorted, so all requested elements have been passed
+    finish(EC_Normal);
+  }
+  else if (length == DCM_UndefinedLength)
+  {
+    // sequence or encapsulated pixel data, scan its items
+    Level level;
+    level.sequence = OFTrue;
+    level.explicitVR = explicitVR && !unknownVR;
+    levels_.push_back(level);
+  }
+  else
+  {
+    if (levels_.empty() && (length <= DCMELEMENTSCANNER_MAX_VALUE_LENGTH))
+    {
+      for (size_t i = 0; i < tags_.size(); ++i)
+      {
+        if (!found_[i] && (tags_[i] == tag))
+        {
+          current_ = OFstatic_cast(long, i);
+          remaining_ = length;
+          if (length == 0)
+          {
+            // empty value
+            found_[i] = OFTrue;
+            current_ = -1;
+            if (++numFound_ == tags_.size()) finish(EC_Normal);
+          }
+          return;
+        }
+      }
+    }
+    skip_ = length;
+  }
+}
+
+
+void DcmElementScanner::finish(const OFCondition &status)
+{
+  finished_ = OFTrue;
+  status_ = status;
+}
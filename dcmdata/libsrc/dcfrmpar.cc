@@ -0,0 +1,579 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: helper classes for processing the frames of a multi-frame
+ *    image in parallel, e.g. in compression and decompression codecs
+ *
+ */
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+#include "dcmtk/dcmdata/dcfrmpar.h"
+#include "dcmtk/dcmdata/dcpixseq.h"
+#include "dcmtk/dcmdata/dcpxitem.h"
+#include "dcmtk/dcmdata/dcerror.h"
+#include "dcmtk/dcmdata/dccodec.h"
+#include "dcmtk/dcmdata/dcitem.h"
+#include "dcmtk/ofstd/oflist.h"
+
+#define INCLUDE_NEW
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+
+OFGlobal<Uint32> dcmCodecMaxThreads(1);
+
+
+/* ======================================================================= */
+
+#ifdef WITH_THREADS
+
+/** pool of threads shared by all frame processors. Each call of
+ *  DcmFrameProcessor::run() queues a number of requests, which are picked
+ *  up by idle threads. New threads are only started if there are more
+ *  requests than idle threads. The threads are terminated when the pool
+ *  is destroyed, i.e. when the application terminates.
+ */
+class DcmFrameProcessorPool
+{
+public:
+
+  /// default constructor
+  DcmFrameProcessorPool();
+
+  /// destructor, waits for all threads to terminate
+  ~DcmFrameProcessorPool();
+
+  /** queue requests for processing the frames of the given processor
+   *  @param processor the frame processor
+   *  @param count number of requests, i.e. threads that should be used
+   *  @return number of requests queued, may be less than count if no
+   *    further threads could be started
+   */
+  Uint32 submit(DcmFrameProcessor *processor, Uint32 count);
+
+  /** remove the requests of the given processor that have not yet been
+   *  picked up by a thread
+   *  @param processor the frame processor
+   *  @return number of requests removed
+   */
+  Uint32 withdraw(DcmFrameProcessor *processor);
+
+  /** wait for the next request. Called by the threads of the pool.
+   *  @return processor of the request, NULL if the thread should terminate
+   */
+  DcmFrameProcessor *next();
+
+  /** mark the calling thread as idle after it has processed a request.
+   *  Called by the threads of the pool.
+   */
+  void done();
+
+private:
+
+  /// private undefined copy constructor
+  DcmFrameProcessorPool(const DcmFrameProcessorPool&);
+
+  /// private undefined copy assignment operator
+  DcmFrameProcessorPool& operator=(const DcmFrameProcessorPool&);
+
+  /// mutex guarding all other members except for requests_
+  OFMutex mutex_;
+
+  /// posted once for each queued request and for each thread on shutdown
+  OFSemaphore requests_;
+
+  /// queued requests
+  OFList<DcmFrameProcessor *> queue_;
+
+  /// all threads of the pool
+  OFVector<OFThread *> threads_;
+
+  /// number of threads not processing a request
+  size_t idle_;
+
+  /// true if the pool is being destroyed
+  OFBool shutdown_;
+};
+
+
+/** thread of the DcmFrameProcessorPool
+ */
+class DcmFrameProcessor::Worker : public OFThread
+{
+public:
+
+  /** constructor
+   *  @param pool the thread pool
+   */
+  Worker(DcmFrameProcessorPool& pool)
+  : OFThread()
+  , pool_(pool)
+  {
+  }
+
+protected:
+
+  /// process requests until the pool is destroyed
+  virtual void run()
+  {
+    DcmFrameProcessor *processor;
+    while ((processor = pool_.next()) != NULL)
+    {
+      processor->processFrames();
+      pool_.done();
+      // the processor may be deleted as soon as this has been posted
+      processor->finished_.post();
+    }
+  }
+
+private:
+
+  /// the thread pool
+  DcmFrameProcessorPool& pool_;
+};
+
+
+DcmFrameProcessorPool::DcmFrameProcessorPool()
+: mutex_()
+, requests_(0)
+, queue_()
+, threads_()
+, idle_(0)
+, shutdown_(OFFalse)
+{
+}
+
+DcmFrameProcessorPool::~DcmFrameProcessorPool()
+{
+  mutex_.lock();
+  shutdown_ = OFTrue;
+  mutex_.unlock();
+  size_t i;
+  for (i = 0; i < threads_.size(); ++i)
+    requests_.post();
+  for (i = 0; i < threads_.size(); ++i)
+  {
+    threads_[i]->join();
+    delete threads_[i];
+  }
+}
+
+Uint32 DcmFrameProcessorPool::submit(DcmFrameProcessor *processor, Uint32 count)
+{
+  Uint32 queued = 0;
+  mutex_.lock();
+  while ((queued < count) && !shutdown_)
+  {
+    if (queue_.size() >= idle_)
+    {
+      // all idle threads are already requested, start another one
+      DcmFrameProcessor::Worker *worker = new DcmFrameProcessor::Worker(*this);
+      if (worker->start() != 0)
+      {
+        // continue with the threads we already have
+        delete worker;
+        break;
+      }
+      threads_.push_back(worker);
+      ++idle_;
+    }
+    queue_.push_back(processor);
+    ++queued;
+  }
+  mutex_.unlock();
+  for (Uint32 i = 0; i < queued; ++i)
+    requests_.post();
+  return queued;
+}
+
+Uint32 DcmFrameProcessorPool::withdraw(DcmFrameProcessor *processor)
+{
+  Uint32 removed = 0;
+  mutex_.lock();
+  OFListIterator(DcmFrameProcessor *) it = queue_.begin();
+  while (it != queue_.end())
+  {
+    if (*it == processor)
+    {
+      it = queue_.erase(it);
+      ++removed;
+    }
+    else ++it;
+  }
+  mutex_.unlock();
+  // the semaphore is not decremented, threads that wake up for a withdrawn
+  // request find the queue empty and continue waiting
+  return removed;
+}
+
+DcmFrameProcessor *DcmFrameProcessorPool::next()
+{
+  DcmFrameProcessor *processor = NULL;
+  OFBool stop = OFFalse;
+  while ((processor == NULL) && !stop)
+  {
+    requests_.wait();
+    mutex_.lock();
+    if (shutdown_) stop = OFTrue;
+    else if (!queue_.empty())
+    {
+      processor = queue_.front();
+      queue_.pop_front();
+      --idle_;
+    }
+    mutex_.unlock();
+  }
+  return processor;
+}
+
+void DcmFrameProcessorPool::done()
+{
+  mutex_.lock();
+  ++idle_;
+  mutex_.unlock();
+}
+
+
+/// the thread pool used by all frame processors
+static DcmFrameProcessorPool FrameProcessorPool;
+
+#endif
+
+
+DcmFrameProcessor::DcmFrameProcessor()
+#ifdef WITH_THREADS
+: mutex_()
+, finished_(0)
+, nextFrame_(0)
+#else
+: nextFrame_(0)
+#endif
+, endFrame_(0)
+, result_(EC_Normal)
+{
+}
+
+DcmFrameProcessor::~DcmFrameProcessor()
+{
+}
+
+OFCondition DcmFrameProcessor::run(Uint32 firstFrame, Uint32 numberOfFrames, Uint32 numberOfThreads)
+{
+  nextFrame_ = firstFrame;
+  endFrame_ = firstFrame + numberOfFrames;
+  result_ = EC_Normal;
+
+#ifdef WITH_THREADS
+  if (numberOfThreads > numberOfFrames) numberOfThreads = numberOfFrames;
+  if (numberOfThreads > 1)
+  {
+    // the calling thread acts as one of the workers, so all frames are
+    // processed even if no pool thread picks up a request
+    const Uint32 queued = FrameProcessorPool.submit(this, numberOfThreads - 1);
+    processFrames();
+    // wait for the pool threads that have picked up a request
+    for (Uint32 running = queued - FrameProcessorPool.withdraw(this); running > 0; --running)
+      finished_.wait();
+    return result_;
+  }
+#else
+  (void) numberOfThreads;
+#endif
+
+  processFrames();
+  return result_;
+}
+
+void DcmFrameProcessor::processFrames()
+{
+  while (OFTrue)
+  {
+#ifdef WITH_THREADS
+    mutex_.lock();
+#endif
+    const Uint32 frameNo = nextFrame_;
+    if (frameNo < endFrame_) ++nextFrame_;
+#ifdef WITH_THREADS
+    mutex_.unlock();
+#endif
+    if (frameNo >= endFrame_) break;
+
+    OFCondition cond = processFrame(frameNo);
+    if (cond.bad())
+    {
+#ifdef WITH_THREADS
+      mutex_.lock();
+#endif
+      // stop handing out frames after this one and report the error of the
+      // lowest failing frame, as sequential processing would do
+      if (frameNo < endFrame_)
+      {
+        endFrame_ = frameNo;
+        result_ = cond;
+      }
+#ifdef WITH_THREADS
+      mutex_.unlock();
+#endif
+    }
+  }
+}
+
+
+/* ======================================================================= */
+
+DcmFrameCompressor::DcmFrameCompressor()
+: DcmFrameProcessor()
+, firstFrame_(0)
+, data_()
+, length_()
+{
+}
+
+DcmFrameCompressor::~DcmFrameCompressor()
+{
+  clearFrames();
+}
+
+OFCondition DcmFrameCompressor::compress(
+  DcmPixelSequence *pixelSequence,
+  DcmOffsetList &offsetList,
+  Uint32 numberOfFrames,
+  Uint32 fragmentSize,
+  size_t &compressedSize,
+  Uint32 numberOfThreads)
+{
+  compressedSize = 0;
+  if (pixelSequence == NULL) return EC_IllegalCall;
+
+  // give each thread two frames per batch in order to balance the load while
+  // limiting the number of compressed frames held in memory at the same time
+  Uint32 batchSize = (numberOfThreads > 1) ? 2 * numberOfThreads : 1;
+  OFCondition result = EC_Normal;
+  for (firstFrame_ = 0; (firstFrame_ < numberOfFrames) && result.good(); firstFrame_ += batchSize)
+  {
+    if (batchSize > numberOfFrames - firstFrame_) batchSize = numberOfFrames - firstFrame_;
+    data_.resize(batchSize, NULL);
+    length_.resize(batchSize, 0);
+    result = prepareFrames(firstFrame_, batchSize);
+    if (result.good()) result = run(firstFrame_, batchSize, numberOfThreads);
+
+    // store the compressed frames in frame order
+    for (Uint32 i = 0; (i < batchSize) && result.good(); ++i)
+    {
+      result = pixelSequence->storeCompressedFrame(offsetList, data_[i], length_[i], fragmentSize);
+      compressedSize += length_[i];
+    }
+    clearFrames();
+  }
+  return result;
+}
+
+OFCondition DcmFrameCompressor::prepareFrames(Uint32 /* firstFrame */, Uint32 /* numberOfFrames */)
+{
+  return EC_Normal;
+}
+
+OFCondition DcmFrameCompressor::processFrame(Uint32 frameNo)
+{
+  const size_t i = frameNo - firstFrame_;
+  OFCondition result = compressFrame(frameNo, data_[i], length_[i]);
+  if (result.good() && (data_[i] == NULL)) result = EC_IllegalCall;
+  return result;
+}
+
+void DcmFrameCompressor::clearFrames()
+{
+  for (OFVector<Uint8 *>::iterator it = data_.begin(); it != data_.end(); ++it)
+    delete[] *it;
+  data_.clear();
+  length_.clear();
+}
+
+
+/* ======================================================================= */
+
+DcmFragmentTable::DcmFragmentTable()
+: data_()
+, length_()
+, start_()
+{
+}
+
+OFCondition DcmFragmentTable::create(DcmPixelSequence *pixSeq, Uint32 numberOfFrames)
+{
+  data_.clear();
+  length_.clear();
+  start_.clear();
+  if (pixSeq == NULL) return EC_IllegalCall;
+
+  // load all fragments, including the basic offset table
+  const Uint32 numberOfFragments = OFstatic_cast(Uint32, pixSeq->card());
+  DcmPixelItem *pixItem = NULL;
+  Uint8 *data = NULL;
+  OFCondition result = EC_Normal;
+  for (Uint32 i = 0; (i < numberOfFragments) && result.good(); ++i)
+  {
+    result = pixSeq->getItem(pixItem, i);
+    if (result.good())
+    {
+      data = NULL;
+      if (pixItem->getLength() > 0) result = pixItem->getUint8Array(data);
+      data_.push_back(data);
+      length_.push_back(pixItem->getLength());
+    }
+  }
+  if (result.bad() || (numberOfFrames < 1) || (numberOfFragments <= numberOfFrames)) return result;
+
+  if (numberOfFrames == 1)
+  {
+    // all fragments belong to the only frame
+    start_.push_back(1);
+  }
+  else if (numberOfFragments == numberOfFrames + 1)
+  {
+    // standard case: there is one fragment per frame
+    for (Uint32 frame = 0; frame < numberOfFrames; ++frame)
+      start_.push_back(frame + 1);
+  }
+  else if ((length_[0] == 4 * numberOfFrames) && data_[0])
+  {
+    // multiple fragments per frame, consult the basic offset table which
+    // is always stored in little endian byte order
+    const Uint8 *table = data_[0];
+    Uint32 fragment = 1;
+    Uint32 counter = 0;
+    for (Uint32 frame = 0; frame < numberOfFrames; ++frame)
+    {
+      const Uint32 offset = OFstatic_cast(Uint32, table[4 * frame]) |
+        (OFstatic_cast(Uint32, table[4 * frame + 1]) << 8) |
+        (OFstatic_cast(Uint32, table[4 * frame + 2]) << 16) |
+        (OFstatic_cast(Uint32, table[4 * frame + 3]) << 24);
+      // add fragment lengths plus 8 bytes for item tag and length field
+      // until we reach the offset of the frame
+      while ((counter < offset) && (fragment < numberOfFragments))
+        counter += length_[fragment++] + 8;
+      if ((counter != offset) || (fragment >= numberOfFragments))
+      {
+        // offset table is inconsistent with the fragments
+        start_.clear();
+        break;
+      }
+      start_.push_back(fragment);
+    }
+  }
+  return EC_Normal;
+}
+
+
+/* ======================================================================= */
+
+DcmFrameSource::DcmFrameSource(
+  const DcmCodec *decoder,
+  const DcmCodecParameter *decoderParameter,
+  const DcmRepresentationParameter *fromParam,
+  DcmPixelSequence *fromPixSeq,
+  DcmItem *dataset)
+: decoder_(decoder)
+, decoderParameter_(decoderParameter)
+, fromParam_(fromParam)
+, fromPixSeq_(fromPixSeq)
+, dataset_(dataset)
+, frameSize_(0)
+, frameStride_(0)
+, colorModel_()
+, buffer_(NULL)
+, bufferFrames_(0)
+, firstFrame_(0)
+, numberOfFrames_(0)
+, nextFrame_(0)
+, nextFragment_(0)
+{
+}
+
+DcmFrameSource::~DcmFrameSource()
+{
+  delete[] buffer_;
+}
+
+OFCondition DcmFrameSource::init()
+{
+  if ((decoder_ == NULL) || (fromPixSeq_ == NULL) || (dataset_ == NULL)) return EC_IllegalCall;
+  OFCondition result = fromPixSeq_->getUncompressedFrameSize(dataset_, frameSize_);
+  if (result.bad()) return result;
+  if (frameSize_ == 0) return EC_CannotChangeRepresentation;
+
+  // the decoder may swap the frame to local byte order as a sequence
+  // of 16-bit words, so an odd-sized frame needs one pad byte
+  frameStride_ = frameSize_ + (frameSize_ & 1);
+
+  // the first frame is kept for the first call of decompressFrames()
+  return decompressFrames(0, 1);
+}
+
+OFCondition DcmFrameSource::decompressFrames(Uint32 firstFrame, Uint32 numberOfFrames)
+{
+  if (frameStride_ == 0) return EC_IllegalCall;
+
+  // frames that are already at the requested position in the buffer are kept
+  Uint32 keep = 0;
+  if (firstFrame == firstFrame_)
+    keep = (numberOfFrames_ < numberOfFrames) ? numberOfFrames_ : numberOfFrames;
+
+  if (numberOfFrames > bufferFrames_)
+  {
+    Uint8 *buffer = NULL;
+#ifdef HAVE_STD__NOTHROW
+    // use a non-throwing new here (if available) because the buffer can be huge
+    buffer = new (std::nothrow) Uint8[OFstatic_cast(size_t, frameStride_) * numberOfFrames];
+#else
+    // make sure that the pointer is set to NULL in case of error
+    try
+    {
+      buffer = new Uint8[OFstatic_cast(size_t, frameStride_) * numberOfFrames];
+    }
+    catch (STD_NAMESPACE bad_alloc const &)
+    {
+      buffer = NULL;
+    }
+#endif
+    if (buffer == NULL) return EC_MemoryExhausted;
+    if (keep > 0) memcpy(buffer, buffer_, OFstatic_cast(size_t, frameStride_) * keep);
+    delete[] buffer_;
+    buffer_ = buffer;
+    bufferFrames_ = numberOfFrames;
+  }
+  firstFrame_ = firstFrame;
+  numberOfFrames_ = keep;
+
+  OFCondition result = EC_Normal;
+  OFString colorModel;
+  for (Uint32 frameNo = firstFrame + keep; (frameNo < firstFrame + numberOfFrames) && result.good(); ++frameNo)
+  {
+    // the start fragment is only known if frames are decompressed in ascending order,
+    // otherwise the decoder has to determine it
+    Uint32 startFragment = (frameNo == nextFrame_) ? nextFragment_ : 0;
+    result = decoder_->decodeFrame(fromParam_, fromPixSeq_, decoderParameter_, dataset_, frameNo, startFragment,
+      buffer_ + OFstatic_cast(size_t, frameStride_) * (frameNo - firstFrame), frameStride_, colorModel);
+    if (result.good())
+    {
+      if (frameNo == 0) colorModel_ = colorModel;
+      nextFrame_ = frameNo + 1;
+      nextFragment_ = startFragment;
+      ++numberOfFrames_;
+    }
+  }
+  return result;
+}
+
+Uint8 *DcmFrameSource::getFrame(Uint32 frameNo) const
+{
+  if ((frameNo < firstFrame_) || (frameNo - firstFrame_ >= numberOfFrames_)) return NULL;
+  return buffer_ + OFstatic_cast(size_t, frameStride_) * (frameNo - firstFrame_);
+}
@@ -172,55 +172,117 @@ DcmHashDictIterator::init(const DcmHashDict* d, OFBool atEnd)
 {
     dict = d;
     hindex = 0;
+    sindex = 0;
     iterating = OFFalse;
+    entry = NULL;
     if (dict != NULL) {
-        if (atEnd || dict->size() == 0) {
-            hindex = dict->highestBucket;
-            if (dict->size() > 0) {
-                iter = dict->hashTab[hindex]->end();
-                iterating = OFTrue;
-            }
+        if (atEnd) {
+            hindex = DcmHashDict::hashTabLength;
+            sindex = dict->staticSize();
         } else {
             hindex = dict->lowestBucket;
-            iter = dict->hashTab[hindex]->begin();
-            iterating = OFTrue;
+            seek();
         }
     }
 }
 
 void
-DcmHashDictIterator::stepUp()
+DcmHashDictIterator::seek()
 {
-    assert(dict != NULL);
-
-    while (hindex <= dict->highestBucket) {
-        DcmDictEntryList* bucket = dict->hashTab[hindex];
-        if (bucket == NULL) {
-            if (hindex == dict->highestBucket)
-                return; /* We reached the end of the dictionary */
-            hindex++; // move on to next bucket
-            iterating = OFFalse;
-        } else {
-            if (!iterating) {
-                iter = bucket->begin();
-                iterating = OFTrue;
-                if (iter != bucket->end()) {
-                    return; /* we have found the next one */
+    entry = NULL;
+    /* first, traverse the buckets of the hash table */
+    while (hindex < DcmHashDict::hashTabLength) {
+        if (hindex <= dict->highestBucket) {
+            DcmDictEntryList* bucket = dict->hashTab[hindex];
+            if (bucket != NULL) {
+                if (!iterating) {
+                    iter = bucket->begin();
+                    iterating = OFTrue;
                 }
-            }
-            if (iter == bucket->end()) {
-                if (hindex == dict->highestBucket)
-                    return; /* We reached the end of the dictionary */
-                iterating = OFFalse;
-                hindex++;
-            } else {
-                ++iter;
                 if (iter != bucket->end()) {
+                    entry = *iter;
                     return; /* we have found the next one */
                 }
             }
+            hindex++; // move on to next bucket
+        } else {
+            hindex = DcmHashDict::hashTabLength;
         }
+        iterating = OFFalse;
     }
+    /* then, traverse the static tables (skipping replaced entries) */
+    const int staticSize = dict->staticSize();
+    while (sindex < staticSize) {
+        const DcmDictEntry* e = dict->staticEntry(sindex);
+        if ((dict->entryCount == 0) || (dict->getInserted(*e, e->getPrivateCreator()) == NULL)) {
+            entry = e;
+            return; /* we have found the next one */
+        }
+        sindex++;
+    }
+}
+
+void
+DcmHashDictIterator::stepUp()
+{
+    assert(dict != NULL);
+
+    if (iterating)
+        ++iter;
+    else if (sindex < dict->staticSize())
+        sindex++;
+    seek();
+}
+
+
+/*
+** DcmStaticHashDict
+*/
+
+const DcmDictEntry*
+DcmStaticHashDict::at(int idx) const
+{
+    return entries + idx;
+}
+
+const DcmDictEntry*
+DcmStaticHashDict::get(const DcmTagKey& key, const char *privCreator) const
+{
+    if (count > 0) {
+        const Uint32 n = OFstatic_cast(Uint32, count);
+        const Sint32 seed = seeds[hash(key, privCreator, 0) % n];
+        const Uint32 slot = (seed < 0) ? OFstatic_cast(Uint32, -(seed + 1))
+                                       : hash(key, privCreator, OFstatic_cast(Uint32, seed)) % n;
+        const DcmDictEntry* e = entries + slot;
+        // the slot is occupied by another entry if the key is not in the table
+        if ((e->getGroup() == key.getGroup()) && (e->getElement() == key.getElement()) &&
+            e->privateCreatorMatch(privCreator))
+        {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+Uint32
+DcmStaticHashDict::hash(const DcmTagKey& key, const char *privCreator, Uint32 seed)
+{
+    Uint32 h = key.hash() ^ seed;
+
+    // If there is a private creator, hash that in, too (FNV-1a)
+    for (; privCreator != NULL && *privCreator != '\0'; privCreator++) {
+        h ^= OFstatic_cast(unsigned char, *privCreator);
+        h *= 16777619UL;
+    }
+
+    // final mixing of all bits (as used by MurmurHash3)
+    h ^= h >> 16;
+    h *= 0x85ebca6bUL;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35UL;
+    h ^= h >> 16;
+
+    return h;
 }
 
 
@@ -243,6 +305,27 @@ DcmHashDict::_init()
     lowestBucket = hashTabLength-1;
     highestBucket = 0;
     entryCount = 0;
+    replacedCount = 0;
+}
+
+
+DcmHashDict::DcmHashDict(const DcmHashDict& other)
+ : hashTab(NULL), lowestBucket(other.lowestBucket), highestBucket(other.highestBucket),
+   entryCount(other.entryCount), replacedCount(other.replacedCount),
+   staticPublic(other.staticPublic), staticPrivate(other.staticPrivate)
+{
+    hashTab = new DcmDictEntryList*[hashTabLength];
+    assert(hashTab != NULL);
+    for (int i=0; i<hashTabLength; i++) {
+        hashTab[i] = NULL;
+        const DcmDictEntryList* bucket = other.hashTab[i];
+        if (bucket != NULL) {
+            /* keep the order of the entries within the bucket */
+            hashTab[i] = new DcmDictEntryList;
+            for (DcmDictEntryListConstIterator iter(bucket->begin()); iter != bucket->end(); ++iter)
+                hashTab[i]->push_back(new DcmDictEntry(**iter));
+        }
+    }
 }
 
 
@@ -262,6 +345,45 @@ DcmHashDict::clear()
     lowestBucket = hashTabLength-1;
     highestBucket = 0;
     entryCount = 0;
+    replacedCount = 0;
+    staticPublic = DcmStaticHashDict();
+    staticPrivate = DcmStaticHashDict();
+}
+
+void
+DcmHashDict::setStaticTables(const DcmStaticHashDict& publicDict, const DcmStaticHashDict& privateDict)
+{
+    staticPublic = publicDict;
+    staticPrivate = privateDict;
+    /* the static entries replace those inserted before */
+    if (entryCount > 0) {
+        for (int i = lowestBucket; i <= highestBucket; i++) {
+            DcmDictEntryList* bucket = hashTab[i];
+            if (bucket != NULL) {
+                DcmDictEntryListIterator iter(bucket->begin());
+                while (iter != bucket->end()) {
+                    DcmDictEntry* e = *iter++;
+                    const DcmStaticHashDict& table = (e->getPrivateCreator() == NULL) ? staticPublic : staticPrivate;
+                    if (table.get(*e, e->getPrivateCreator()) != NULL) {
+#ifdef PRINT_REPLACED_DICTIONARY_ENTRIES
+                        DCMDATA_WARN("replacing " << *e);
+#endif
+                        bucket->remove(e);
+                        delete e;
+                        entryCount--;
+                    }
+                }
+            }
+        }
+    }
+    replacedCount = 0;
+}
+
+const DcmDictEntry*
+DcmHashDict::staticEntry(int idx) const
+{
+    const int publicSize = staticPublic.size();
+    return (idx < publicSize) ? staticPublic.at(idx) : staticPrivate.at(idx - publicSize);
 }
 
 int
@@ -310,6 +432,10 @@ DcmHashDict::put(DcmDictEntry* entry)
 #endif
         delete old;
     } else {
+        const DcmStaticHashDict& table = (entry->getPrivateCreator() == NULL) ? staticPublic : staticPrivate;
+        /* an entry of the static tables is replaced (i.e. hidden) by the new one */
+        if (table.get(*entry, entry->getPrivateCreator()) != NULL)
+            replacedCount++;
         entryCount++;
     }
 
@@ -323,22 +449,31 @@ DcmDictEntry *DcmHashDict::findInList(DcmDictEntryList& l, const DcmTagKey& key,
 }
 
 const DcmDictEntry*
-DcmHashDict::get(const DcmTagKey& key, const char *privCreator) const
+DcmHashDict::getInserted(const DcmTagKey& key, const char *privCreator) const
 {
     const DcmDictEntry* entry = NULL;
-
-    // first we look for an entry that exactly matches the given tag key
     Uint32 idx = hash(&key, privCreator);
     DcmDictEntryList* bucket = hashTab[idx];
     if (bucket) entry = findInList(*bucket, key, privCreator);
+    return entry;
+}
+
+const DcmDictEntry*
+DcmHashDict::get(const DcmTagKey& key, const char *privCreator) const
+{
+    const DcmDictEntry* entry = NULL;
+    const DcmStaticHashDict& table = (privCreator == NULL) ? staticPublic : staticPrivate;
+
+    // first we look for an entry that exactly matches the given tag key
+    if (entryCount > 0) entry = getInserted(key, privCreator);
+    if (entry == NULL) entry = table.get(key, privCreator);
 
     if ((entry == NULL) && privCreator)
     {
       // As a second guess, we look for a private tag with flexible element number.
       DcmTagKey tk(key.getGroup(), OFstatic_cast(unsigned short, key.getElement() & 0xff));
-      idx = hash(&tk, privCreator);
-      bucket = hashTab[idx];
-      if (bucket) entry = findInList(*bucket, tk, privCreator);
+      if (entryCount > 0) entry = getInserted(tk, privCreator);
+      if (entry == NULL) entry = table.get(tk, privCreator);
     }
 
     return entry;
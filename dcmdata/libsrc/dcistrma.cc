@@ -73,6 +73,14 @@ offile_off_t DcmInputStream::skip(offile_off_t skiplen)
   return result;
 }
 
+Uint8 *DcmInputStream::mapData(offile_off_t len, size_t alignment, DcmFileMapping *&mapping)
+{
+  // a compression filter (if any) is the current producer and does not support mapping
+  Uint8 *result = current_->mapData(len, alignment, mapping);
+  if (result) tell_ += len;
+  return result;
+}
+
 offile_off_t DcmInputStream::tell() const
 {
   return tell_;
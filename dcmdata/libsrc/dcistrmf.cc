@@ -23,19 +23,308 @@
 #include "dcmtk/config/osconfig.h"
 #include "dcmtk/dcmdata/dcistrmf.h"
 #include "dcmtk/dcmdata/dcerror.h"
+#include "dcmtk/ofstd/oflist.h"
 
 #define INCLUDE_CSTDIO
 #define INCLUDE_CERRNO
+#define INCLUDE_CSTRING
 #include "dcmtk/ofstd/ofstdinc.h"
 
+BEGIN_EXTERN_C
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>    /* for stat() */
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>       /* for open() */
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>      /* for close() */
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>    /* for mmap() */
+#endif
+END_EXTERN_C
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_SYS_STAT_H) && defined(HAVE_FCNTL_H) && defined(HAVE_UNISTD_H)
+#define DCMTK_ENABLE_FILE_MAPPING
+#endif
+
+
+OFGlobal<OFBool> dcmUseMemoryMappedFileInput(OFFalse);
+OFGlobal<Uint32> dcmMemoryMappedValueThreshold(4096);
+OFGlobal<Uint32> dcmFileHandleCacheSize(0);
+
+
+/* ======================================================================= */
+
+DcmFileMapping::DcmFileMapping(Uint8 *data, offile_off_t size)
+#ifdef WITH_THREADS
+: refCount_(1), mutex_(), data_(data), size_(size)
+#else
+: refCount_(1), data_(data), size_(size)
+#endif
+{
+}
+
+DcmFileMapping::~DcmFileMapping()
+{
+#ifdef DCMTK_ENABLE_FILE_MAPPING
+  munmap(OFreinterpret_cast(char *, data_), OFstatic_cast(size_t, size_));
+#endif
+}
+
+DcmFileMapping *DcmFileMapping::newInstance(const OFFilename &filename)
+{
+  DcmFileMapping *result = NULL;
+#ifdef DCMTK_ENABLE_FILE_MAPPING
+  const char *fname = filename.getCharPointer();
+  struct stat st;
+  // only regular, non-empty files whose size fits into the address space can be mapped
+  if (fname && (stat(fname, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0) &&
+      (OFstatic_cast(offile_off_t, OFstatic_cast(size_t, st.st_size)) == OFstatic_cast(offile_off_t, st.st_size)))
+  {
+    int fd = open(fname, O_RDONLY);
+    if (fd >= 0)
+    {
+      // map copy-on-write so that in-place modifications (e.g. byte swapping)
+      // of element values never affect the file
+      void *data = mmap(NULL, OFstatic_cast(size_t, st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED)
+        result = new DcmFileMapping(OFstatic_cast(Uint8 *, data), OFstatic_cast(offile_off_t, st.st_size));
+      // the mapping remains valid after the file descriptor has been closed
+      close(fd);
+    }
+  }
+#else
+  (void) filename;
+#endif
+  return result;
+}
+
+OFBool DcmFileMapping::supported()
+{
+#ifdef DCMTK_ENABLE_FILE_MAPPING
+  return OFTrue;
+#else
+  return OFFalse;
+#endif
+}
+
+void DcmFileMapping::increaseRefCount()
+{
+#ifdef WITH_THREADS
+  mutex_.lock();
+#endif
+  ++refCount_;
+#ifdef WITH_THREADS
+  mutex_.unlock();
+#endif
+}
+
+void DcmFileMapping::decreaseRefCount()
+{
+#ifdef WITH_THREADS
+  mutex_.lock();
+#endif
+  size_t result = --refCount_;
+#ifdef WITH_THREADS
+  mutex_.unlock();
+#endif
+  if (result == 0) delete this;
+}
+
+/* ======================================================================= */
+
+/* entry of the process-wide cache of shared file handles */
+struct DcmSharedFileCacheEntry
+{
+  /// name of the file
+  OFString filename;
+
+  /// the shared file, the cache holds one reference
+  DcmSharedFile *file;
+};
+
+/* cache of shared file handles, most recently used file first */
+static OFList<DcmSharedFileCacheEntry> sharedFileCache;
+
+#ifdef WITH_THREADS
+/* mutex protecting the cache of shared file handles */
+static OFMutex sharedFileCacheMutex;
+#endif
+
+
+DcmSharedFile::DcmSharedFile()
+#ifdef WITH_THREADS
+: refCount_(1), mutex_(), file_(), size_(0)
+#else
+: refCount_(1), file_(), size_(0)
+#endif
+{
+}
+
+DcmSharedFile::~DcmSharedFile()
+{
+}
+
+DcmSharedFile *DcmSharedFile::newInstance(const OFFilename &filename)
+{
+  DcmSharedFile *result = new DcmSharedFile();
+  if (result->file_.fopen(filename, "rb") && (result->file_.fseek(0L, SEEK_END) == 0))
+  {
+    result->size_ = result->file_.ftell();
+  }
+  else
+  {
+    delete result;
+    result = NULL;
+  }
+  return result;
+}
+
+DcmSharedFile *DcmSharedFile::getCachedInstance(const OFFilename &filename)
+{
+  const Uint32 maxFiles = dcmFileHandleCacheSize.get();
+  if ((maxFiles == 0) || filename.usesWideChars() || (filename.getCharPointer() == NULL))
+    return NULL;
+
+  const OFString name(filename.getCharPointer());
+  DcmSharedFile *result = NULL;
+#ifdef WITH_THREADS
+  sharedFileCacheMutex.lock();
+#endif
+  OFListIterator(DcmSharedFileCacheEntry) it = sharedFileCache.begin();
+  while ((it != sharedFileCache.end()) && ((*it).filename != name)) ++it;
+  if (it != sharedFileCache.end())
+  {
+    // move the entry to the front of the list
+    result = (*it).file;
+    if (it != sharedFileCache.begin())
+    {
+      sharedFileCache.erase(it);
+      DcmSharedFileCacheEntry entry;
+      entry.filename = name;
+      entry.file = result;
+      sharedFileCache.push_front(entry);
+    }
+  }
+  else
+  {
+    result = newInstance(filename);
+    if (result)
+    {
+      DcmSharedFileCacheEntry entry;
+      entry.filename = name;
+      entry.file = result;
+      sharedFileCache.push_front(entry);
+      // close the least recently used files (as soon as they are not in use anymore)
+      while (sharedFileCache.size() > maxFiles)
+      {
+        sharedFileCache.back().file->decreaseRefCount();
+        sharedFileCache.pop_back();
+      }
+    }
+  }
+  if (result) result->increaseRefCount();
+#ifdef WITH_THREADS
+  sharedFileCacheMutex.unlock();
+#endif
+  return result;
+}
+
+void DcmSharedFile::clearCache()
+{
+#ifdef WITH_THREADS
+  sharedFileCacheMutex.lock();
+#endif
+  for (OFListIterator(DcmSharedFileCacheEntry) it = sharedFileCache.begin(); it != sharedFileCache.end(); ++it)
+    (*it).file->decreaseRefCount();
+  sharedFileCache.clear();
+#ifdef WITH_THREADS
+  sharedFileCacheMutex.unlock();
+#endif
+}
+
+offile_off_t DcmSharedFile::read(void *buf, offile_off_t buflen, offile_off_t offset)
+{
+  offile_off_t result = 0;
+#ifdef HAVE_PREAD
+  // positional reads do not modify the file position, so no locking is needed
+  char *p = OFstatic_cast(char *, buf);
+  const int fd = file_.fileNo();
+  while (buflen > 0)
+  {
+#ifdef EXPLICIT_LFS_64
+    ssize_t nbytes = ::pread64(fd, p, OFstatic_cast(size_t, buflen), offset);
+#else
+    ssize_t nbytes = ::pread(fd, p, OFstatic_cast(size_t, buflen), offset);
+#endif
+    if ((nbytes < 0) && (errno == EINTR)) continue;
+    if (nbytes <= 0) break;
+    p += nbytes;
+    buflen -= nbytes;
+    offset += nbytes;
+    result += nbytes;
+  }
+#else
+#ifdef WITH_THREADS
+  mutex_.lock();
+#endif
+  if (file_.fseek(offset, SEEK_SET) == 0)
+    result = file_.fread(buf, 1, OFstatic_cast(size_t, buflen));
+#ifdef WITH_THREADS
+  mutex_.unlock();
+#endif
+#endif
+  return result;
+}
+
+void DcmSharedFile::increaseRefCount()
+{
+#ifdef WITH_THREADS
+  mutex_.lock();
+#endif
+  ++refCount_;
+#ifdef WITH_THREADS
+  mutex_.unlock();
+#endif
+}
+
+void DcmSharedFile::decreaseRefCount()
+{
+#ifdef WITH_THREADS
+  mutex_.lock();
+#endif
+  size_t result = --refCount_;
+#ifdef WITH_THREADS
+  mutex_.unlock();
+#endif
+  if (result == 0) delete this;
+}
+
+/* ======================================================================= */
 
 DcmFileProducer::DcmFileProducer(const OFFilename &filename, offile_off_t offset)
 : DcmProducer()
 , file_()
 , status_(EC_Normal)
 , size_(0)
+, mapping_(NULL)
+, sharedFile_(NULL)
+, pos_(0)
 {
-  if (file_.fopen(filename, "rb"))
+  if (dcmUseMemoryMappedFileInput.get())
+    mapping_ = DcmFileMapping::newInstance(filename);
+
+  if (mapping_)
+  {
+     size_ = mapping_->size();
+     pos_ = (offset < size_) ? offset : size_;
+  }
+  else if (file_.fopen(filename, "rb"))
   {
      // Get number of bytes in file
      file_.fseek(0L, SEEK_END);
@@ -55,8 +344,32 @@ DcmFileProducer::DcmFileProducer(const OFFilename &filename, offile_off_t offset
   }
 }
 
+DcmFileProducer::DcmFileProducer(DcmSharedFile *file, offile_off_t offset)
+: DcmProducer()
+, file_()
+, status_(EC_Normal)
+, size_(file->size())
+, mapping_(NULL)
+, sharedFile_(file)
+, pos_((offset < file->size()) ? offset : file->size())
+{
+}
+
+DcmFileProducer::DcmFileProducer(DcmFileMapping *mapping, offile_off_t offset)
+: DcmProducer()
+, file_()
+, status_(EC_Normal)
+, size_(mapping->size())
+, mapping_(mapping)
+, sharedFile_(NULL)
+, pos_((offset < mapping->size()) ? offset : mapping->size())
+{
+}
+
 DcmFileProducer::~DcmFileProducer()
 {
+  if (mapping_) mapping_->decreaseRefCount();
+  if (sharedFile_) sharedFile_->decreaseRefCount();
 }
 
 OFBool DcmFileProducer::good() const
@@ -71,6 +384,7 @@ OFCondition DcmFileProducer::status() const
 
 OFBool DcmFileProducer::eos()
 {
+  if (mapping_ || sharedFile_) return (pos_ >= size_);
   if (file_.open())
   {
     return (file_.eof() || (size_ == file_.ftell()));
@@ -80,13 +394,25 @@ OFBool DcmFileProducer::eos()
 
 offile_off_t DcmFileProducer::avail()
 {
+  if (mapping_ || sharedFile_) return size_ - pos_;
   if (file_.open()) return size_ - file_.ftell(); else return 0;
 }
 
 offile_off_t DcmFileProducer::read(void *buf, offile_off_t buflen)
 {
   offile_off_t result = 0;
-  if (status_.good() && file_.open() && buf && buflen)
+  if (status_.good() && mapping_ && buf && buflen)
+  {
+    result = (size_ - pos_ < buflen) ? (size_ - pos_) : buflen;
+    memcpy(buf, mapping_->data() + pos_, OFstatic_cast(size_t, result));
+    pos_ += result;
+  }
+  else if (status_.good() && sharedFile_ && buf && buflen)
+  {
+    result = sharedFile_->read(buf, (size_ - pos_ < buflen) ? (size_ - pos_) : buflen, pos_);
+    pos_ += result;
+  }
+  else if (status_.good() && file_.open() && buf && buflen)
   {
     result = file_.fread(buf, 1, OFstatic_cast(size_t, buflen));
   }
@@ -96,7 +422,12 @@ offile_off_t DcmFileProducer::read(void *buf, offile_off_t buflen)
 offile_off_t DcmFileProducer::skip(offile_off_t skiplen)
 {
   offile_off_t result = 0;
-  if (status_.good() && file_.open() && skiplen)
+  if (status_.good() && (mapping_ || sharedFile_) && skiplen)
+  {
+    result = (size_ - pos_ < skiplen) ? (size_ - pos_) : skiplen;
+    pos_ += result;
+  }
+  else if (status_.good() && file_.open() && skiplen)
   {
     offile_off_t pos = file_.ftell();
     result = (size_ - pos < skiplen) ? (size_ - pos) : skiplen;
@@ -112,7 +443,12 @@ offile_off_t DcmFileProducer::skip(offile_off_t skiplen)
 
 void DcmFileProducer::putback(offile_off_t num)
 {
-  if (status_.good() && file_.open() && num)
+  if (status_.good() && (mapping_ || sharedFile_) && num)
+  {
+    if (num <= pos_) pos_ -= num;
+    else status_ = EC_PutbackFailed; // tried to putback before start of file
+  }
+  else if (status_.good() && file_.open() && num)
   {
     offile_off_t pos = file_.ftell();
     if (num <= pos)
@@ -128,6 +464,24 @@ void DcmFileProducer::putback(offile_off_t num)
   }
 }
 
+Uint8 *DcmFileProducer::mapData(offile_off_t len, size_t alignment, DcmFileMapping *&mapping)
+{
+  Uint8 *result = NULL;
+  if (status_.good() && mapping_ && (len > 0) && (size_ - pos_ >= len))
+  {
+    Uint8 *data = mapping_->data() + pos_;
+    // the mapping itself is page aligned, so this only depends on the file offset
+    if ((alignment < 2) || (OFreinterpret_cast(size_t, data) % alignment == 0))
+    {
+      mapping_->increaseRefCount();
+      mapping = mapping_;
+      pos_ += len;
+      result = data;
+    }
+  }
+  return result;
+}
+
 
 /* ======================================================================= */
 
@@ -135,22 +489,46 @@ DcmInputFileStreamFactory::DcmInputFileStreamFactory(const OFFilename &filename,
 : DcmInputStreamFactory()
 , filename_(filename)
 , offset_(offset)
+, mapping_(NULL)
+{
+}
+
+DcmInputFileStreamFactory::DcmInputFileStreamFactory(const OFFilename &filename, offile_off_t offset, DcmFileMapping *mapping)
+: DcmInputStreamFactory()
+, filename_(filename)
+, offset_(offset)
+, mapping_(mapping)
 {
+  if (mapping_) mapping_->increaseRefCount();
 }
 
 DcmInputFileStreamFactory::DcmInputFileStreamFactory(const DcmInputFileStreamFactory& arg)
 : DcmInputStreamFactory(arg)
 , filename_(arg.filename_)
 , offset_(arg.offset_)
+, mapping_(arg.mapping_)
 {
+  if (mapping_) mapping_->increaseRefCount();
 }
 
 DcmInputFileStreamFactory::~DcmInputFileStreamFactory()
 {
+  if (mapping_) mapping_->decreaseRefCount();
 }
 
 DcmInputStream *DcmInputFileStreamFactory::create() const
 {
+  if (mapping_)
+  {
+    // reuse the mapping created when the dataset was read
+    mapping_->increaseRefCount();
+    return new DcmInputFileStream(mapping_, filename_, offset_);
+  }
+  if (!dcmUseMemoryMappedFileInput.get())
+  {
+    DcmSharedFile *file = DcmSharedFile::getCachedInstance(filename_);
+    if (file) return new DcmInputFileStream(file, filename_, offset_);
+  }
   return new DcmInputFileStream(filename_, offset_);
 }
 
@@ -163,6 +541,20 @@ DcmInputFileStream::DcmInputFileStream(const OFFilename &filename, offile_off_t
 {
 }
 
+DcmInputFileStream::DcmInputFileStream(DcmSharedFile *file, const OFFilename &filename, offile_off_t offset)
+: DcmInputStream(&producer_) // safe because DcmInputStream only stores pointer
+, producer_(file, offset)
+, filename_(filename)
+{
+}
+
+DcmInputFileStream::DcmInputFileStream(DcmFileMapping *mapping, const OFFilename &filename, offile_off_t offset)
+: DcmInputStream(&producer_) // safe because DcmInputStream only stores pointer
+, producer_(mapping, offset)
+, filename_(filename)
+{
+}
+
 DcmInputFileStream::~DcmInputFileStream()
 {
 }
@@ -173,7 +565,7 @@ DcmInputStreamFactory *DcmInputFileStream::newFactory() const
   if (currentProducer() == &producer_)
   {
     // no filter installed, can create factory object
-    result = new DcmInputFileStreamFactory(filename_, tell());
+    result = new DcmInputFileStreamFactory(filename_, tell(), producer_.getMapping());
   }
   return result;
 }
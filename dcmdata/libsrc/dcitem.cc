@@ -1643,7 +1643,19 @@ OFCondition DcmItem::insert(DcmElement *elem,
     {
         DcmElement *dE;
         E_ListPos seekmode = ELP_last;
-        /* iterate through elementList (from the last element to the first) */
+        /* elementList is sorted by tag. Usually (e.g. while parsing), the new element is */
+        /* appended at the end; otherwise, determine its position by binary search */
+        dE = OFstatic_cast(DcmElement *, elementList->get(ELP_last));
+        if ((dE != NULL) && (elem->getTag() < dE->getTag()))
+        {
+            unsigned long pos = findElementPosition(elem->getTag());
+            /* start with the predecessor unless an element with the same tag exists */
+            if ((pos > 0) && (elementList->seek_to(pos)->getTag() != elem->getTag()))
+                --pos;
+            elementList->seek_to(pos);
+            seekmode = ELP_atpos;
+        }
+        /* iterate through elementList (from the current element to the first) */
         do {
             /* get current element from elementList */
             dE = OFstatic_cast(DcmElement *, elementList->seek(seekmode));
@@ -1904,20 +1916,12 @@ DcmElement *DcmItem::remove(DcmObject *elem)
 DcmElement *DcmItem::remove(const DcmTagKey &tag)
 {
     errorFlag = EC_TagNotFound;
-    DcmObject *dO = NULL;
-    if (!elementList->empty())
+    DcmObject *dO = elementList->seek_to(findElementPosition(tag));
+    if ((dO != NULL) && (dO->getTag() == tag))
     {
-        elementList->seek(ELP_first);
-        do {
-            dO = elementList->get();
-            if (dO->getTag() == tag)
-            {
-                elementList->remove();     // removes element from list but does not delete it
-                dO->setParent(NULL);       // forget about the parent
-                errorFlag = EC_Normal;
-                break;
-            }
-        } while (elementList->seek(ELP_next));
+        elementList->remove();     // removes element from list but does not delete it
+        dO->setParent(NULL);       // forget about the parent
+        errorFlag = EC_Normal;
     }
 
     if (errorFlag == EC_TagNotFound)
@@ -1985,27 +1989,29 @@ OFCondition DcmItem::searchSubFromHere(const DcmTagKey &tag,
 {
     DcmObject *dO;
     OFCondition l_error = EC_TagNotFound;
-    if (!elementList->empty())
+    if (!searchIntoSub)
+    {
+        /* elementList is sorted by tag, so a binary search is sufficient on this level */
+        dO = elementList->seek_to(findElementPosition(tag));
+        if ((dO != NULL) && (dO->getTag() == tag))
+        {
+            resultStack.push(dO);
+            l_error = EC_Normal;
+            DCMDATA_TRACE("DcmItem::searchSubFromHere() Element " << tag << " found");
+        }
+    }
+    else if (!elementList->empty())
     {
         elementList->seek(ELP_first);
         do {
             dO = elementList->get();
-            if (searchIntoSub)
-            {
-                resultStack.push(dO);
-                if (dO->getTag() == tag)
-                    l_error = EC_Normal;
-                else
-                    l_error = dO->search(tag, resultStack, ESM_fromStackTop, OFTrue);
-                if (l_error.bad())
-                    resultStack.pop();
-            } else {
-                if (dO->getTag() == tag)
-                {
-                    resultStack.push(dO);
-                    l_error = EC_Normal;
-                }
-            }
+            resultStack.push(dO);
+            if (dO->getTag() == tag)
+                l_error = EC_Normal;
+            else
+                l_error = dO->search(tag, resultStack, ESM_fromStackTop, OFTrue);
+            if (l_error.bad())
+                resultStack.pop();
         } while (l_error.bad() && elementList->seek(ELP_next));
         if (l_error==EC_Normal && dO->getTag()==tag)
         {
@@ -2019,6 +2025,29 @@ OFCondition DcmItem::searchSubFromHere(const DcmTagKey &tag,
 // ********************************
 
 
+unsigned long DcmItem::findElementPosition(const DcmTagKey &tag)
+{
+    /* binary search for the first element whose tag is not less than the given one */
+    unsigned long first = 0;
+    unsigned long count = elementList->card();
+    while (count > 0)
+    {
+        const unsigned long step = count / 2;
+        if (elementList->seek_to(first + step)->getTag() < tag)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+            count = step;
+    }
+    return first;
+}
+
+
+// ********************************
+
+
 OFCondition DcmItem::search(const DcmTagKey &tag,
                             DcmStack &resultStack,
                             E_SearchMode mode,
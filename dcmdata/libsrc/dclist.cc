@@ -21,19 +21,26 @@
 
 #include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
 
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
 #include "dcmtk/ofstd/ofstream.h"
 #include "dcmtk/dcmdata/dclist.h"
 
+/// number of entries allocated when the first object is added to a list
+#define DCMLIST_INITIAL_CAPACITY 8
+
 
 // *****************************************
-// *** DcmListNode *************************
+// *** DcmList *****************************
 // *****************************************
 
 
-DcmListNode::DcmListNode( DcmObject *obj )
-  : nextNode(NULL),
-    prevNode(NULL),
-    objNodeValue(obj)
+DcmList::DcmList()
+  : objects(NULL),
+    capacity(0),
+    currentIndex(DCM_EndOfListIndex),
+    cardinality(0)
 {
 }
 
@@ -41,41 +48,34 @@ DcmListNode::DcmListNode( DcmObject *obj )
 // ********************************
 
 
-DcmListNode::~DcmListNode()
-{
-}
-
-
-// *****************************************
-// *** DcmList *****************************
-// *****************************************
-
-
-DcmList::DcmList()
-  : firstNode(NULL),
-    lastNode(NULL),
-    currentNode(NULL),
-    cardinality(0)
+DcmList::~DcmList()
 {
+    // the objects themselves are not deleted here (dangerous!)
+    delete[] objects;
 }
 
 
 // ********************************
 
 
-DcmList::~DcmList()
+void DcmList::insertAt( DcmObject *obj, unsigned long index )
 {
-    if ( !DcmList::empty() )                      // list is not empty !
+    if ( cardinality == capacity )                 // array is full !
     {
-        lastNode->nextNode = NULL;                // set to 0 for safety reasons
-        do {
-            DcmListNode *temp = firstNode;
-            firstNode = firstNode->nextNode;
-            // delete temp->objNodeValue;;        // dangerous!
-            delete temp;
-        } while ( firstNode != NULL );
-        currentNode = firstNode = lastNode = NULL;
+        // grow geometrically, so that appending takes amortized constant time
+        const unsigned long newCapacity = capacity ? 2 * capacity : DCMLIST_INITIAL_CAPACITY;
+        DcmObject **newObjects = new DcmObject *[newCapacity];
+        if ( cardinality > 0 )
+            memcpy( newObjects, objects, cardinality * sizeof(DcmObject *) );
+        delete[] objects;
+        objects = newObjects;
+        capacity = newCapacity;
     }
+    if ( index < cardinality )                     // make room for new entry
+        memmove( objects + index + 1, objects + index, (cardinality - index) * sizeof(DcmObject *) );
+    objects[index] = obj;
+    currentIndex = index;
+    cardinality++;
 }
 
 
@@ -85,18 +85,7 @@ DcmList::~DcmList()
 DcmObject *DcmList::append( DcmObject *obj )
 {
     if ( obj != NULL )
-    {
-        if ( DcmList::empty() )                        // list is empty !
-            currentNode = firstNode = lastNode = new DcmListNode(obj);
-        else
-        {
-            DcmListNode *node = new DcmListNode(obj);
-            lastNode->nextNode = node;
-            node->prevNode = lastNode;
-            currentNode = lastNode = node;
-        }
-        cardinality++;
-    } // obj == NULL
+        insertAt( obj, cardinality );
     return obj;
 }
 
@@ -107,18 +96,7 @@ DcmObject *DcmList::append( DcmObject *obj )
 DcmObject *DcmList::prepend( DcmObject *obj )
 {
     if ( obj != NULL )
-    {
-        if ( DcmList::empty() )                        // list is empty !
-            currentNode = firstNode = lastNode = new DcmListNode(obj);
-        else
-        {
-            DcmListNode *node = new DcmListNode(obj);
-            node->nextNode = firstNode;
-            firstNode->prevNode = node;
-            currentNode = firstNode = node;
-        }
-        cardinality++;
-    } // obj == NULL
+        insertAt( obj, 0 );
     return obj;
 }
 
@@ -130,48 +108,21 @@ DcmObject *DcmList::insert( DcmObject *obj, E_ListPos pos )
 {
     if ( obj != NULL )
     {
-        if ( DcmList::empty() )                 // list is empty !
-        {
-            currentNode = firstNode = lastNode = new DcmListNode(obj);
-            cardinality++;
-        }
-        else {
-            if ( pos==ELP_last )
-                DcmList::append( obj );         // cardinality++;
-            else if ( pos==ELP_first )
-                DcmList::prepend( obj );        // cardinality++;
-            else if ( !DcmList::valid() )
-                // set current node to the end if there is no predecessor or
-                // there are successors to be determined
-                DcmList::append( obj );         // cardinality++;
-            else if ( pos == ELP_prev )         // insert before current node
-            {
-                DcmListNode *node = new DcmListNode(obj);
-                if ( currentNode->prevNode == NULL )
-                    firstNode = node;           // insert at the beginning
-                else
-                    currentNode->prevNode->nextNode = node;
-                node->prevNode = currentNode->prevNode;
-                node->nextNode = currentNode;
-                currentNode->prevNode = node;
-                currentNode = node;
-                cardinality++;
-            }
-            else //( pos==ELP_next || pos==ELP_atpos )
-                                                // insert after current node
-            {
-                DcmListNode *node = new DcmListNode(obj);
-                if ( currentNode->nextNode == NULL )
-                    lastNode = node;            // append to the end
-                else
-                    currentNode->nextNode->prevNode = node;
-                node->nextNode = currentNode->nextNode;
-                node->prevNode = currentNode;
-                currentNode->nextNode = node;
-                currentNode = node;
-                cardinality++;
-            }
-        }
+        if ( DcmList::empty() )                    // list is empty !
+            insertAt( obj, 0 );
+        else if ( pos == ELP_last )
+            insertAt( obj, cardinality );
+        else if ( pos == ELP_first )
+            insertAt( obj, 0 );
+        else if ( !DcmList::valid() )
+            // set current element to the end if there is no predecessor or
+            // there are successors to be determined
+            insertAt( obj, cardinality );
+        else if ( pos == ELP_prev )                // insert before current element
+            insertAt( obj, currentIndex );
+        else //( pos==ELP_next || pos==ELP_atpos )
+                                                   // insert after current element
+            insertAt( obj, currentIndex + 1 );
     } // obj == NULL
     return obj;
 }
@@ -182,31 +133,19 @@ DcmObject *DcmList::insert( DcmObject *obj, E_ListPos pos )
 
 DcmObject *DcmList::remove()
 {
-    DcmObject *tempobj;
-    DcmListNode *tempnode;
-
     if ( DcmList::empty() )                        // list is empty !
         return NULL;
     else if ( !DcmList::valid() )
-        return NULL;                               // current node is 0
+        return NULL;                               // no current element
     else
     {
-        tempnode = currentNode;
-
-        if ( currentNode->prevNode == NULL )
-            firstNode = currentNode->nextNode;     // delete first element
-        else
-            currentNode->prevNode->nextNode = currentNode->nextNode;
-
-        if ( currentNode->nextNode == NULL )
-            lastNode = currentNode->prevNode;      // delete last element
-        else
-            currentNode->nextNode->prevNode = currentNode->prevNode;
-
-        currentNode = currentNode->nextNode;
-        tempobj = tempnode->value();
-        delete tempnode;
+        DcmObject *tempobj = objects[currentIndex];
         cardinality--;
+        if ( currentIndex < cardinality )
+            memmove( objects + currentIndex, objects + currentIndex + 1, (cardinality - currentIndex) * sizeof(DcmObject *) );
+        else
+            currentIndex = DCM_EndOfListIndex;     // removed last element
+        // the current element is now the successor of the removed element
         return tempobj;
     }
 }
@@ -229,23 +168,23 @@ DcmObject *DcmList::seek( E_ListPos pos )
     switch (pos)
     {
         case ELP_first :
-            currentNode = firstNode;
+            currentIndex = DcmList::empty() ? DCM_EndOfListIndex : 0;
             break;
         case ELP_last :
-            currentNode = lastNode;
+            currentIndex = DcmList::empty() ? DCM_EndOfListIndex : cardinality - 1;
             break;
         case ELP_prev :
             if ( DcmList::valid() )
-                currentNode = currentNode->prevNode;
+                currentIndex = (currentIndex == 0) ? DCM_EndOfListIndex : currentIndex - 1;
             break;
         case ELP_next :
             if ( DcmList::valid() )
-                currentNode = currentNode->nextNode;
+                currentIndex = (currentIndex + 1 < cardinality) ? currentIndex + 1 : DCM_EndOfListIndex;
             break;
         default:
             break;
     }
-    return DcmList::valid() ? currentNode->value() : NULL;
+    return DcmList::valid() ? objects[currentIndex] : NULL;
 }
 
 
@@ -254,10 +193,7 @@ DcmObject *DcmList::seek( E_ListPos pos )
 
 DcmObject *DcmList::seek_to(unsigned long absolute_position)
 {
-    const unsigned long tmppos = absolute_position < cardinality ? absolute_position : cardinality;
-    seek( ELP_first );
-    for (unsigned long i = 0; i < tmppos; i++)
-        seek( ELP_next );
+    currentIndex = absolute_position < cardinality ? absolute_position : DCM_EndOfListIndex;
     return get( ELP_atpos );
 }
 
@@ -267,29 +203,13 @@ DcmObject *DcmList::seek_to(unsigned long absolute_position)
 
 void DcmList::deleteAllElements()
 {
-    unsigned long numElements = cardinality;
-    DcmListNode* tmpNode = NULL;
-    DcmObject* tmpObject = NULL;
     // delete all elements
-    for (unsigned long i = 0; i < numElements; i++)
-    {
-        // always select first node so no search is necessary
-        tmpNode = firstNode;
-        // clear value of node
-        tmpObject = tmpNode->value();
-        if (tmpObject != NULL)
-        {
-          // delete load of selected list node
-          delete tmpObject;
-          tmpObject = NULL;
-        }
-        firstNode = tmpNode->nextNode;
-        // delete the list node itself
-        delete tmpNode;
-    }
+    for (unsigned long i = 0; i < cardinality; i++)
+        delete objects[i];
     // reset all attributes for later use
-    firstNode = NULL;
-    lastNode = NULL;
-    currentNode = NULL;
+    delete[] objects;
+    objects = NULL;
+    capacity = 0;
+    currentIndex = DCM_EndOfListIndex;
     cardinality = 0;
 }
@@ -1101,6 +1101,42 @@ OFCondition DcmPixelData::getUncompressedFrame(
 }
 
 
+OFCondition DcmPixelData::getUncompressedFrames(
+    DcmItem *dataset,
+    Uint32 firstFrame,
+    Uint32 numberOfFrames,
+    void *buffer,
+    Uint32 bufSize,
+    Uint32& length,
+    DcmFileCache *cache)
+{
+    length = 0;
+    if ((dataset == NULL) || (buffer == NULL) || !existUnencapsulated) return EC_IllegalCall;
+
+    Uint32 frameSize;
+    OFCondition result = getUncompressedFrameSize(dataset, frameSize);
+    if (result.bad()) return result;
+    if ((frameSize == 0) || (numberOfFrames == 0)) return EC_Normal;
+
+    // the byte offset of the first frame must be within the element value,
+    // which is checked without computing the (possibly overflowing) offset first
+    const Uint32 valueLength = getLengthField();
+    if ((valueLength == 0) || (firstFrame > (valueLength - 1) / frameSize)) return EC_InvalidOffset;
+    const Uint32 offset = firstFrame * frameSize;
+
+    // copy as many of the requested frames as are present in the element value
+    Uint32 numBytes = valueLength - offset;
+    if (numberOfFrames <= numBytes / frameSize) numBytes = numberOfFrames * frameSize;
+    if (bufSize < numBytes) return EC_IllegalCall;
+
+    // DcmElement::getPartialValue() skips directly to the given offset
+    // in the file if the value has not been loaded into memory
+    result = getPartialValue(buffer, offset, numBytes, cache);
+    if (result.good()) length = numBytes;
+    return result;
+}
+
+
 OFCondition DcmPixelData::getDecompressedColorModel(
     DcmItem *dataset,
     OFString &decompressedColorModel)
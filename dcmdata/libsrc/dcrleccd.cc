@@ -32,6 +32,468 @@
 #include "dcmtk/dcmdata/dcvrpobw.h"  /* for class DcmPolymorphOBOW */
 #include "dcmtk/dcmdata/dcswap.h"    /* for swapIfNecessary() */
 #include "dcmtk/dcmdata/dcuid.h"     /* for dcmGenerateUniqueIdentifer()*/
+#include "dcmtk/dcmdata/dcfrmpar.h"  /* for class DcmFrameProcessor */
+
+
+/** helper class decompressing the frames of an RLE compressed image.
+ *  Frames can be decompressed one after another by calling decodeFrame(),
+ *  or in parallel by calling run(), which requires the frame index of the
+ *  fragment table to be present. The stripes of a frame that is stored in
+ *  a single fragment can be decompressed in parallel as well.
+ */
+class DcmRLEFrameDecoder: public DcmFrameProcessor
+{
+public:
+
+  /** constructor
+   *  @param fragments fragments of the compressed pixel sequence
+   *  @param imageData buffer for all uncompressed frames
+   *  @param frameSize size of an uncompressed frame in bytes
+   *  @param columns number of columns
+   *  @param rows number of rows
+   *  @param samplesPerPixel number of samples per pixel
+   *  @param bytesAllocated number of bytes allocated per sample
+   *  @param planarConfiguration planar configuration of the uncompressed image
+   *  @param reverseByteOrder assume LSB to MSB order of RLE segments if true
+   *  @param stripeThreads maximum number of threads used for the stripes of a frame
+   */
+  DcmRLEFrameDecoder(
+    const DcmFragmentTable& fragments,
+    Uint8 *imageData,
+    size_t frameSize,
+    Uint16 columns,
+    Uint16 rows,
+    Uint16 samplesPerPixel,
+    Uint16 bytesAllocated,
+    Uint16 planarConfiguration,
+    OFBool reverseByteOrder,
+    Uint32 stripeThreads)
+  : DcmFrameProcessor()
+  , fragments_(fragments)
+  , imageData_(imageData)
+  , frameSize_(frameSize)
+  , columns_(columns)
+  , rows_(rows)
+  , samplesPerPixel_(samplesPerPixel)
+  , bytesAllocated_(bytesAllocated)
+  , planarConfiguration_(planarConfiguration)
+  , reverseByteOrder_(reverseByteOrder)
+  , stripeThreads_(stripeThreads)
+  {
+  }
+
+  /** decompress a single frame
+   *  @param currentItem index of the first fragment of the frame, updated to
+   *    the index of the fragment following the last fragment used
+   *  @param imageData8 buffer for the uncompressed frame
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition decodeFrame(Uint32& currentItem, Uint8 *imageData8) const;
+
+  /** decompress a single stripe that is completely contained in the given
+   *  buffer and distribute its bytes into the uncompressed frame
+   *  @param stripe index of the stripe
+   *  @param rleData compressed stripe
+   *  @param rleLength length of the compressed stripe in bytes
+   *  @param imageData8 buffer for the uncompressed frame
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition decodeStripe(Uint32 stripe, Uint8 *rleData, size_t rleLength, Uint8 *imageData8) const;
+
+protected:
+
+  /** decompress the given frame into its place in the output buffer
+   *  @param frameNo number of the frame
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition processFrame(Uint32 frameNo)
+  {
+    DCMDATA_DEBUG("RLE decoder processes frame " << frameNo);
+    Uint32 currentItem = fragments_.getStartFragment(frameNo);
+    return decodeFrame(currentItem, imageData_ + frameNo * frameSize_);
+  }
+
+private:
+
+  /** access the given fragment
+   *  @param item index of the fragment, incremented after access
+   *  @param fragmentLength returns the length of the fragment
+   *  @param rleData returns the data of the fragment
+   *  @return EC_Normal if successful, EC_IllegalCall if the fragment does not exist
+   */
+  OFCondition getFragment(Uint32& item, Uint32& fragmentLength, Uint8 *& rleData) const
+  {
+    if (item >= fragments_.numberOfFragments()) return EC_IllegalCall;
+    fragmentLength = fragments_.getLength(item);
+    rleData = fragments_.getData(item++);
+    return (rleData == NULL) ? EC_CorruptedData : EC_Normal;
+  }
+
+  /** distribute the decompressed bytes of a stripe into the uncompressed frame
+   *  @param stripe index of the stripe
+   *  @param stripeData decompressed stripe, columns_ * rows_ bytes
+   *  @param imageData8 buffer for the uncompressed frame
+   */
+  void distributeStripe(Uint32 stripe, const Uint8 *stripeData, Uint8 *imageData8) const;
+
+  /// private undefined copy constructor
+  DcmRLEFrameDecoder(const DcmRLEFrameDecoder&);
+
+  /// private undefined copy assignment operator
+  DcmRLEFrameDecoder& operator=(const DcmRLEFrameDecoder&);
+
+  /// fragments of the compressed pixel sequence
+  const DcmFragmentTable& fragments_;
+
+  /// buffer for all uncompressed frames
+  Uint8 *imageData_;
+
+  /// size of an uncompressed frame in bytes
+  size_t frameSize_;
+
+  /// number of columns
+  Uint16 columns_;
+
+  /// number of rows
+  Uint16 rows_;
+
+  /// number of samples per pixel
+  Uint16 samplesPerPixel_;
+
+  /// number of bytes allocated per sample
+  Uint16 bytesAllocated_;
+
+  /// planar configuration of the uncompressed image
+  Uint16 planarConfiguration_;
+
+  /// assume LSB to MSB order of RLE segments if true
+  OFBool reverseByteOrder_;
+
+  /// maximum number of threads used for the stripes of a frame
+  Uint32 stripeThreads_;
+};
+
+
+/** helper class decompressing the stripes of a frame that is stored in a
+ *  single fragment. The stripes are independent of each other and can
+ *  therefore be decompressed in parallel.
+ */
+class DcmRLEStripeDecoder: public DcmFrameProcessor
+{
+public:
+
+  /** constructor
+   *  @param frameDecoder frame decoder used to decompress the stripes
+   *  @param rleData fragment containing the compressed frame
+   *  @param fragmentLength length of the fragment
+   *  @param rleHeader RLE header of the frame in local byte order
+   *  @param imageData8 buffer for the uncompressed frame
+   */
+  DcmRLEStripeDecoder(
+    const DcmRLEFrameDecoder& frameDecoder,
+    Uint8 *rleData,
+    Uint32 fragmentLength,
+    const Uint32 *rleHeader,
+    Uint8 *imageData8)
+  : DcmFrameProcessor()
+  , frameDecoder_(frameDecoder)
+  , rleData_(rleData)
+  , fragmentLength_(fragmentLength)
+  , rleHeader_(rleHeader)
+  , imageData8_(imageData8)
+  {
+  }
+
+protected:
+
+  /** decompress the given stripe
+   *  @param stripe index of the stripe
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition processFrame(Uint32 stripe)
+  {
+    // the last stripe extends to the end of the fragment
+    const Uint32 start = rleHeader_[stripe + 1];
+    const Uint32 end = (stripe + 1 < rleHeader_[0]) ? rleHeader_[stripe + 2] : fragmentLength_;
+    return frameDecoder_.decodeStripe(stripe, rleData_ + start, end - start, imageData8_);
+  }
+
+private:
+
+  /// private undefined copy constructor
+  DcmRLEStripeDecoder(const DcmRLEStripeDecoder&);
+
+  /// private undefined copy assignment operator
+  DcmRLEStripeDecoder& operator=(const DcmRLEStripeDecoder&);
+
+  /// frame decoder used to decompress the stripes
+  const DcmRLEFrameDecoder& frameDecoder_;
+
+  /// fragment containing the compressed frame
+  Uint8 *rleData_;
+
+  /// length of the fragment
+  Uint32 fragmentLength_;
+
+  /// RLE header of the frame in local byte order
+  const Uint32 *rleHeader_;
+
+  /// buffer for the uncompressed frame
+  Uint8 *imageData8_;
+};
+
+
+OFCondition DcmRLEFrameDecoder::decodeFrame(Uint32& currentItem, Uint8 *imageData8) const
+{
+  const size_t bytesPerStripe = columns_ * rows_;
+  Uint8 *rleData = NULL;
+  Uint32 rleHeader[16];
+  Uint32 numberOfStripes = 0;
+  Uint32 fragmentLength = 0;
+  Uint32 i;
+
+  DcmRLEDecoder rledecoder(bytesPerStripe);
+  if (rledecoder.fail()) return EC_MemoryExhausted;  // RLE decoder failed to initialize
+
+  DCMDATA_DEBUG("RLE decoder processes pixel item " << currentItem);
+  // get first pixel item of this frame
+  OFCondition result = getFragment(currentItem, fragmentLength, rleData);
+  if (result.good())
+  {
+    // we require that the RLE header must be completely
+    // contained in the first fragment; otherwise bail out
+    if (fragmentLength < 64) result = EC_CannotChangeRepresentation;
+  }
+
+  if (result.good())
+  {
+    // copy RLE header to buffer and adjust byte order
+    memcpy(rleHeader, rleData, 64);
+    swapIfNecessary(gLocalByteOrder, EBO_LittleEndian, rleHeader, 16*OFstatic_cast(Uint32, sizeof(Uint32)), sizeof(Uint32));
+
+    // determine number of stripes.
+    numberOfStripes = rleHeader[0];
+
+    // check that number of stripes in RLE header matches our expectation
+    if ((numberOfStripes < 1) || (numberOfStripes > 15) ||
+        (numberOfStripes != OFstatic_cast(Uint32, bytesAllocated_) * samplesPerPixel_))
+        result = EC_CannotChangeRepresentation;
+  }
+
+  if (result.good())
+  {
+    // check whether all stripes are contained in the first fragment, which is the
+    // normal case. If so, the stripes can be decompressed independently of each other.
+    OFBool singleFragment = (rleHeader[numberOfStripes] <= fragmentLength);
+    for (i=1; (i<numberOfStripes) && singleFragment; ++i)
+    {
+      if (rleHeader[i] > rleHeader[i+1]) singleFragment = OFFalse;
+    }
+    if (singleFragment)
+    {
+      DcmRLEStripeDecoder stripeDecoder(*this, rleData, fragmentLength, rleHeader, imageData8);
+      if (stripeDecoder.run(0, numberOfStripes, stripeThreads_).good()) return EC_Normal;
+
+      // otherwise decompress the frame again as described below, which also
+      // handles RLE data continuing in the next fragment or reports the error
+      DCMDATA_DEBUG("RLE decoder failed to decompress the stripes independently, retrying");
+    }
+  }
+
+  if (result.good())
+  {
+    // this variable keeps the number of bytes we have processed
+    // for the current frame in earlier pixel fragments
+    Uint32 fragmentOffset = 0;
+
+    // this variable keeps the current position within the current fragment
+    Uint32 byteOffset = 0;
+
+    OFBool lastStripe = OFFalse;
+    Uint32 inputBytes = 0;
+
+    // for each stripe in stripe set
+    for (i=0; (i<numberOfStripes) && result.good(); ++i)
+    {
+      // reset RLE codec
+      rledecoder.clear();
+
+      // adjust start point for RLE stripe, ignoring trailing garbage from the last run
+      byteOffset = rleHeader[i+1];
+      if (byteOffset < fragmentOffset) result = EC_CannotChangeRepresentation;
+      else
+      {
+        byteOffset -= fragmentOffset; // now byteOffset is correct but may point to next fragment
+        while ((byteOffset > fragmentLength) && result.good())
+        {
+          DCMDATA_DEBUG("RLE decoder processes pixel item " << currentItem);
+          byteOffset -= fragmentLength;
+          fragmentOffset += fragmentLength;
+          result = getFragment(currentItem, fragmentLength, rleData);
+        }
+      }
+
+      // byteOffset now points to the first byte of the new RLE stripe
+      // check if the current stripe is the last one for this frame
+      if (i+1 == numberOfStripes) lastStripe = OFTrue; else lastStripe = OFFalse;
+
+      if (lastStripe)
+      {
+        // the last stripe needs special handling because we cannot use the
+        // offset table to determine the number of bytes to feed to the codec
+        // if the RLE data is split in multiple fragments. We need to feed
+        // data fragment by fragment until the RLE codec has produced
+        // sufficient output.
+        while ((rledecoder.size() < bytesPerStripe) && result.good())
+        {
+          // feed complete remaining content of fragment to RLE codec and
+          // switch to next fragment
+          result = rledecoder.decompress(rleData + byteOffset, OFstatic_cast(size_t, fragmentLength - byteOffset));
+
+          // special handling for zero pad byte at the end of the RLE stream
+          // which results in an EC_StreamNotifyClient return code
+          // or trailing garbage data which results in EC_CorruptedData
+          if (rledecoder.size() == bytesPerStripe) result = EC_Normal;
+
+          // Check if we're already done. If yes, don't change fragment
+          if (result.good() || result == EC_StreamNotifyClient)
+          {
+            if (rledecoder.size() < bytesPerStripe)
+            {
+              DCMDATA_WARN("RLE decoder is finished but has produced insufficient data for this stripe, will continue with next pixel item");
+              DCMDATA_DEBUG("RLE decoder processes pixel item " << currentItem);
+              byteOffset = 0;
+              fragmentOffset += fragmentLength;
+              result = getFragment(currentItem, fragmentLength, rleData);
+            }
+            else byteOffset = fragmentLength;
+          }
+        } /* while */
+      }
+      else
+      {
+        // not the last stripe. We can use the offset table to determine
+        // the number of bytes to feed to the RLE codec.
+        inputBytes = rleHeader[i+2];
+        if (inputBytes < rleHeader[i+1]) result = EC_CannotChangeRepresentation;
+        else
+        {
+          inputBytes -= rleHeader[i+1]; // number of bytes to feed to codec
+          while ((inputBytes > (fragmentLength - byteOffset)) && result.good())
+          {
+            // feed complete remaining content of fragment to RLE codec and
+            // switch to next fragment
+            result = rledecoder.decompress(rleData + byteOffset, OFstatic_cast(size_t, fragmentLength - byteOffset));
+
+            if (result.good() || result == EC_StreamNotifyClient)
+            {
+              DCMDATA_DEBUG("RLE decoder processes pixel item " << currentItem);
+              inputBytes -= fragmentLength - byteOffset;
+              byteOffset = 0;
+              fragmentOffset += fragmentLength;
+              result = getFragment(currentItem, fragmentLength, rleData);
+            }
+          } /* while */
+
+          // last fragment for this RLE stripe
+          result = rledecoder.decompress(rleData + byteOffset, OFstatic_cast(size_t, inputBytes));
+
+          // special handling for zero pad byte at the end of the RLE stream
+          // which results in an EC_StreamNotifyClient return code
+          // or trailing garbage data which results in EC_CorruptedData
+          if (rledecoder.size() == bytesPerStripe) result = EC_Normal;
+
+          byteOffset += inputBytes;
+        }
+      }
+
+      // make sure the RLE decoder has produced the right amount of data
+      if (result.good() && (rledecoder.size() != bytesPerStripe))
+      {
+          DCMDATA_ERROR("RLE decoder is finished but has produced insufficient data for this stripe");
+          result = EC_CannotChangeRepresentation;
+      }
+
+      // distribute decompressed bytes into output image array
+      if (result.good())
+      {
+        distributeStripe(i, OFstatic_cast(Uint8 *, rledecoder.getOutputBuffer()), imageData8);
+      }
+    } /* for */
+  }
+  return result;
+}
+
+
+OFCondition DcmRLEFrameDecoder::decodeStripe(Uint32 stripe, Uint8 *rleData, size_t rleLength, Uint8 *imageData8) const
+{
+  const size_t bytesPerStripe = columns_ * rows_;
+  DcmRLEDecoder rledecoder(bytesPerStripe);
+  if (rledecoder.fail()) return EC_MemoryExhausted;  // RLE decoder failed to initialize
+
+  // a zero pad byte at the end of the RLE stream (EC_StreamNotifyClient) or
+  // trailing garbage data (EC_CorruptedData) are ignored as long as the
+  // decoder has produced exactly the expected amount of data
+  (void) rledecoder.decompress(rleData, rleLength);
+  if (rledecoder.size() != bytesPerStripe) return EC_CannotChangeRepresentation;
+
+  distributeStripe(stripe, OFstatic_cast(Uint8 *, rledecoder.getOutputBuffer()), imageData8);
+  return EC_Normal;
+}
+
+
+void DcmRLEFrameDecoder::distributeStripe(Uint32 stripe, const Uint8 *stripeData, Uint8 *imageData8) const
+{
+  const size_t bytesPerStripe = columns_ * rows_;
+
+  // which sample and byte are we currently decompressing?
+  const Uint32 sample = stripe / bytesAllocated_;
+  const Uint32 byte = stripe % bytesAllocated_;
+
+  // byte offset for first sample in frame
+  Uint32 sampleOffset = 0;
+
+  // byte offset between samples
+  Uint32 offsetBetweenSamples = 0;
+
+  Uint8 *pixelPointer = NULL;
+  register size_t pixel = 0;
+
+  // compute byte offsets
+  if (planarConfiguration_ == 0)
+  {
+     sampleOffset = sample * bytesAllocated_;
+     offsetBetweenSamples = samplesPerPixel_ * bytesAllocated_;
+  }
+  else
+  {
+     sampleOffset = sample * bytesAllocated_ * columns_ * rows_;
+     offsetBetweenSamples = bytesAllocated_;
+  }
+
+  // initialize pointer to output data
+  if (reverseByteOrder_)
+  {
+    // assume incorrect LSB to MSB order of RLE segments as produced by some tools
+    pixelPointer = imageData8 + sampleOffset + byte;
+  }
+  else
+  {
+    pixelPointer = imageData8 + sampleOffset + bytesAllocated_ - byte - 1;
+  }
+
+  // loop through all pixels of the frame
+  if (offsetBetweenSamples == 1)
+  {
+    memcpy(pixelPointer, stripeData, bytesPerStripe);
+  }
+  else for (pixel = 0; pixel < bytesPerStripe; ++pixel)
+  {
+    *pixelPointer = *stripeData++;
+    pixelPointer += offsetBetweenSamples;
+  }
+}
+
 
 
 DcmRLECodecDecoder::DcmRLECodecDecoder()
@@ -85,7 +547,6 @@ OFCondition DcmRLECodecDecoder::decode(
     Uint16 imageBitsAllocated = 0;
     Uint16 imageBytesAllocated = 0;
     Uint16 imagePlanarConfiguration = 0;
-    Uint32 rleHeader[16];
     DcmItem *ditem = OFstatic_cast(DcmItem *, dataset);
     OFBool numberOfFramesPresent = OFFalse;
 
@@ -116,13 +577,10 @@ OFCondition DcmRLECodecDecoder::decode(
 
     if (result.good())
     {
-      DcmPixelItem *pixItem = NULL;
-      Uint8 * rleData = NULL;
-      const size_t bytesPerStripe = imageColumns * imageRows;
-
-      DcmRLEDecoder rledecoder(bytesPerStripe);
-      if (rledecoder.fail()) result = EC_MemoryExhausted;  // RLE decoder failed to initialize
-      else
+      // load all fragments so that frames can be decompressed independently
+      DcmFragmentTable fragments;
+      result = fragments.create(pixSeq, OFstatic_cast(Uint32, imageFrames));
+      if (result.good())
       {
         size_t frameSize = imageBytesAllocated * imageRows * imageColumns * imageSamplesPerPixel;
         size_t totalSize = frameSize * imageFrames;
@@ -130,234 +588,30 @@ OFCondition DcmRLECodecDecoder::decode(
         Uint16 *imageData16 = NULL;
         Sint32 currentFrame = 0;
         Uint32 currentItem = 1; // ignore offset table
-        Uint32 numberOfStripes = 0;
-        Uint32 fragmentLength = 0;
-        Uint32 i;
 
         result = uncompressedPixelData.createUint16Array(OFstatic_cast(Uint32, totalSize/sizeof(Uint16)), imageData16);
         if (result.good())
         {
           Uint8 *imageData8 = OFreinterpret_cast(Uint8 *, imageData16);
-
-          while ((currentFrame < imageFrames) && result.good())
+          // if there are less frames than threads, the stripes of each frame are
+          // decompressed in parallel as well
+          const Uint32 maxThreads = dcmCodecMaxThreads.get();
+          const OFBool parallelFrames = (imageFrames > 1) && (maxThreads > 1) && fragments.hasFrameIndex();
+          Uint32 stripeThreads = maxThreads;
+          if (parallelFrames)
+            stripeThreads = (OFstatic_cast(Uint32, imageFrames) < maxThreads) ? maxThreads / OFstatic_cast(Uint32, imageFrames) : 1;
+          DcmRLEFrameDecoder rledecoder(fragments, imageData8, frameSize, imageColumns, imageRows,
+            imageSamplesPerPixel, imageBytesAllocated, imagePlanarConfiguration, enableReverseByteOrder, stripeThreads);
+
+          if (parallelFrames)
+          {
+            // frames are independent of each other, decompress them in parallel
+            result = rledecoder.run(0, OFstatic_cast(Uint32, imageFrames));
+          }
+          else while ((currentFrame < imageFrames) && result.good())
           {
             DCMDATA_DEBUG("RLE decoder processes frame " << currentFrame);
-            DCMDATA_DEBUG("RLE decoder processes pixel item " << currentItem);
-            // get first pixel item of this frame
-            result = pixSeq->getItem(pixItem, currentItem++);
-            if (result.good())
-            {
-              fragmentLength = pixItem->getLength();
-              result = pixItem->getUint8Array(rleData);
-              if (result.good())
-              {
-                // we require that the RLE header must be completely
-                // contained in the first fragment; otherwise bail out
-                if (fragmentLength < 64) result = EC_CannotChangeRepresentation;
-              }
-            }
-
-            if (result.good())
-            {
-              // copy RLE header to buffer and adjust byte order
-              memcpy(rleHeader, rleData, 64);
-              swapIfNecessary(gLocalByteOrder, EBO_LittleEndian, rleHeader, 16*OFstatic_cast(Uint32, sizeof(Uint32)), sizeof(Uint32));
-
-              // determine number of stripes.
-              numberOfStripes = rleHeader[0];
-
-              // check that number of stripes in RLE header matches our expectation
-              if ((numberOfStripes < 1) || (numberOfStripes > 15) ||
-                  (numberOfStripes != OFstatic_cast(Uint32, imageBytesAllocated) * imageSamplesPerPixel))
-                  result = EC_CannotChangeRepresentation;
-            }
-
-            if (result.good())
-            {
-              // this variable keeps the number of bytes we have processed
-              // for the current frame in earlier pixel fragments
-              Uint32 fragmentOffset = 0;
-
-              // this variable keeps the current position within the current fragment
-              Uint32 byteOffset = 0;
-
-              OFBool lastStripe = OFFalse;
-              Uint32 inputBytes = 0;
-
-              // pointers for buffer copy operations
-              Uint8 *outputBuffer = NULL;
-              Uint8 *pixelPointer = NULL;
-
-              // byte offset for first sample in frame
-              Uint32 sampleOffset = 0;
-
-              // byte offset between samples
-              Uint32 offsetBetweenSamples = 0;
-
-              // temporary variables
-              Uint32 sample = 0;
-              Uint32 byte = 0;
-              register Uint32 pixel = 0;
-
-              // for each stripe in stripe set
-              for (i=0; (i<numberOfStripes) && result.good(); ++i)
-              {
-                // reset RLE codec
-                rledecoder.clear();
-
-                // adjust start point for RLE stripe, ignoring trailing garbage from the last run
-                byteOffset = rleHeader[i+1];
-                if (byteOffset < fragmentOffset) result = EC_CannotChangeRepresentation;
-                else
-                {
-                  byteOffset -= fragmentOffset; // now byteOffset is correct but may point to next fragment
-                  while ((byteOffset > fragmentLength) && result.good())
-                  {
-                    DCMDATA_DEBUG("RLE decoder processes pixel item " << currentItem);
-                    result = pixSeq->getItem(pixItem, currentItem++);
-                    if (result.good())
-                    {
-                      byteOffset -= fragmentLength;
-                      fragmentOffset += fragmentLength;
-                      fragmentLength = pixItem->getLength();
-                      result = pixItem->getUint8Array(rleData);
-                    }
-                  }
-                }
-
-                // byteOffset now points to the first byte of the new RLE stripe
-                // check if the current stripe is the last one for this frame
-                if (i+1 == numberOfStripes) lastStripe = OFTrue; else lastStripe = OFFalse;
-
-                if (lastStripe)
-                {
-                  // the last stripe needs special handling because we cannot use the
-                  // offset table to determine the number of bytes to feed to the codec
-                  // if the RLE data is split in multiple fragments. We need to feed
-                  // data fragment by fragment until the RLE codec has produced
-                  // sufficient output.
-                  while ((rledecoder.size() < bytesPerStripe) && result.good())
-                  {
-                    // feed complete remaining content of fragment to RLE codec and
-                    // switch to next fragment
-                    result = rledecoder.decompress(rleData + byteOffset, OFstatic_cast(size_t, fragmentLength - byteOffset));
-
-                    // special handling for zero pad byte at the end of the RLE stream
-                    // which results in an EC_StreamNotifyClient return code
-                    // or trailing garbage data which results in EC_CorruptedData
-                    if (rledecoder.size() == bytesPerStripe) result = EC_Normal;
-
-                    // Check if we're already done. If yes, don't change fragment
-                    if (result.good() || result == EC_StreamNotifyClient)
-                    {
-                      if (rledecoder.size() < bytesPerStripe)
-                      {
-                        DCMDATA_WARN("RLE decoder is finished but has produced insufficient data for this stripe, will continue with next pixel item");
-                        DCMDATA_DEBUG("RLE decoder processes pixel item " << currentItem);
-                        result = pixSeq->getItem(pixItem, currentItem++);
-                        if (result.good())
-                        {
-                          byteOffset = 0;
-                          fragmentOffset += fragmentLength;
-                          fragmentLength = pixItem->getLength();
-                          result = pixItem->getUint8Array(rleData);
-                        }
-                      }
-                      else byteOffset = fragmentLength;
-                    }
-                  } /* while */
-                }
-                else
-                {
-                  // not the last stripe. We can use the offset table to determine
-                  // the number of bytes to feed to the RLE codec.
-                  inputBytes = rleHeader[i+2];
-                  if (inputBytes < rleHeader[i+1]) result = EC_CannotChangeRepresentation;
-                  else
-                  {
-                    inputBytes -= rleHeader[i+1]; // number of bytes to feed to codec
-                    while ((inputBytes > (fragmentLength - byteOffset)) && result.good())
-                    {
-                      // feed complete remaining content of fragment to RLE codec and
-                      // switch to next fragment
-                      result = rledecoder.decompress(rleData + byteOffset, OFstatic_cast(size_t, fragmentLength - byteOffset));
-
-                      if (result.good() || result == EC_StreamNotifyClient)
-                      {
-                        DCMDATA_DEBUG("RLE decoder processes pixel item " << currentItem);
-                        result = pixSeq->getItem(pixItem, currentItem++);
-                      }
-                      if (result.good())
-                      {
-                        inputBytes -= fragmentLength - byteOffset;
-                        byteOffset = 0;
-                        fragmentOffset += fragmentLength;
-                        fragmentLength = pixItem->getLength();
-                        result = pixItem->getUint8Array(rleData);
-                      }
-                    } /* while */
-
-                    // last fragment for this RLE stripe
-                    result = rledecoder.decompress(rleData + byteOffset, OFstatic_cast(size_t, inputBytes));
-
-                    // special handling for zero pad byte at the end of the RLE stream
-                    // which results in an EC_StreamNotifyClient return code
-                    // or trailing garbage data which results in EC_CorruptedData
-                    if (rledecoder.size() == bytesPerStripe) result = EC_Normal;
-
-                    byteOffset += inputBytes;
-                  }
-                }
-
-                // make sure the RLE decoder has produced the right amount of data
-                if (result.good() && (rledecoder.size() != bytesPerStripe))
-                {
-                    DCMDATA_ERROR("RLE decoder is finished but has produced insufficient data for this stripe");
-                    result = EC_CannotChangeRepresentation;
-                }
-
-                // distribute decompressed bytes into output image array
-                if (result.good())
-                {
-                  // which sample and byte are we currently compressing?
-                  sample = i / imageBytesAllocated;
-                  byte = i % imageBytesAllocated;
-
-                  // raw buffer containing bytesPerStripe bytes of uncompressed data
-                  outputBuffer = OFstatic_cast(Uint8 *, rledecoder.getOutputBuffer());
-
-                  // compute byte offsets
-                  if (imagePlanarConfiguration == 0)
-                  {
-                     sampleOffset = sample * imageBytesAllocated;
-                     offsetBetweenSamples = imageSamplesPerPixel * imageBytesAllocated;
-                  }
-                  else
-                  {
-                     sampleOffset = sample * imageBytesAllocated * imageColumns * imageRows;
-                     offsetBetweenSamples = imageBytesAllocated;
-                  }
-
-                  // initialize pointer to output data
-                  if (enableReverseByteOrder)
-                  {
-                    // assume incorrect LSB to MSB order of RLE segments as produced by some tools
-                    pixelPointer = imageData8 + sampleOffset + byte;
-                  }
-                  else
-                  {
-                    pixelPointer = imageData8 + sampleOffset + imageBytesAllocated - byte - 1;
-                  }
-
-                  // loop through all pixels of the frame
-                  for (pixel = 0; pixel < bytesPerStripe; ++pixel)
-                  {
-                    *pixelPointer = *outputBuffer++;
-                    pixelPointer += offsetBetweenSamples;
-                  }
-                }
-              } /* for */
-            }
+            result = rledecoder.decodeFrame(currentItem, imageData8);
 
             // advance by one frame
             if (result.good())
@@ -29,14 +29,338 @@
 #include "dcmtk/dcmdata/dcpxitem.h"  /* for class DcmPixelItem */
 #include "dcmtk/dcmdata/dcswap.h"    /* for swapIfNecessary */
 #include "dcmtk/dcmdata/dcitem.h"
+#include "dcmtk/dcmdata/dcfrmpar.h"  /* for classes DcmFrameCompressor and DcmFrameProcessor */
 #include "dcmtk/ofstd/ofstd.h"
 
 #define INCLUDE_CSTDIO
 #include "dcmtk/ofstd/ofstdinc.h"
 
 
-typedef OFList<DcmRLEEncoder *> DcmRLEEncoderList;
-typedef OFListIterator(DcmRLEEncoder *) DcmRLEEncoderListIterator;
+/** helper class compressing the stripes (i.e.\ the byte planes of the samples)
+ *  of a single frame with RLE. The stripes are independent of each other and
+ *  can therefore be compressed in parallel.
+ */
+class DcmRLEStripeCompressor: public DcmFrameProcessor
+{
+public:
+
+  /** constructor
+   *  @param frameData uncompressed frame in little endian byte order
+   *  @param columns number of columns
+   *  @param rows number of rows
+   *  @param samplesPerPixel number of samples per pixel
+   *  @param bytesAllocated number of bytes allocated per sample
+   *  @param planarConfiguration planar configuration of the uncompressed image
+   */
+  DcmRLEStripeCompressor(
+    const Uint8 *frameData,
+    Uint16 columns,
+    Uint16 rows,
+    Uint16 samplesPerPixel,
+    Uint16 bytesAllocated,
+    Uint16 planarConfiguration)
+  : DcmFrameProcessor()
+  , frameData_(frameData)
+  , columns_(columns)
+  , rows_(rows)
+  , samplesPerPixel_(samplesPerPixel)
+  , bytesAllocated_(bytesAllocated)
+  , planarConfiguration_(planarConfiguration)
+  , encoders_(samplesPerPixel * bytesAllocated, OFstatic_cast(DcmRLEEncoder *, NULL))
+  {
+  }
+
+  /// destructor, deletes the RLE encoders
+  virtual ~DcmRLEStripeCompressor()
+  {
+    for (size_t i = 0; i < encoders_.size(); ++i) delete encoders_[i];
+  }
+
+  /** get the number of stripes
+   *  @return number of stripes
+   */
+  Uint32 numberOfStripes() const
+  {
+    return OFstatic_cast(Uint32, encoders_.size());
+  }
+
+  /** get the RLE encoder of the given stripe. May only be called
+   *  after the stripe has been compressed successfully.
+   *  @param stripe index of the stripe
+   *  @return RLE encoder containing the compressed stripe
+   */
+  const DcmRLEEncoder& getEncoder(Uint32 stripe) const
+  {
+    return *encoders_[stripe];
+  }
+
+protected:
+
+  /** compress the given stripe
+   *  @param stripe index of the stripe
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition processFrame(Uint32 stripe);
+
+private:
+
+  /// private undefined copy constructor
+  DcmRLEStripeCompressor(const DcmRLEStripeCompressor&);
+
+  /// private undefined copy assignment operator
+  DcmRLEStripeCompressor& operator=(const DcmRLEStripeCompressor&);
+
+  /// uncompressed frame in little endian byte order
+  const Uint8 *frameData_;
+
+  /// number of columns
+  Uint16 columns_;
+
+  /// number of rows
+  Uint16 rows_;
+
+  /// number of samples per pixel
+  Uint16 samplesPerPixel_;
+
+  /// number of bytes allocated per sample
+  Uint16 bytesAllocated_;
+
+  /// planar configuration of the uncompressed image
+  Uint16 planarConfiguration_;
+
+  /// RLE encoders of the stripes
+  OFVector<DcmRLEEncoder *> encoders_;
+};
+
+
+OFCondition DcmRLEStripeCompressor::processFrame(Uint32 stripe)
+{
+  // which sample and byte are we currently compressing?
+  const Uint32 sample = stripe / bytesAllocated_;
+  const Uint32 byte = stripe % bytesAllocated_;
+  Uint32 sampleOffset = 0;
+  Uint32 offsetBetweenSamples = 0;
+  Uint32 row = 0;
+  register Uint32 column = 0;
+
+  // compute byte offsets
+  if (planarConfiguration_ == 0)
+  {
+     sampleOffset = sample * bytesAllocated_;
+     offsetBetweenSamples = samplesPerPixel_ * bytesAllocated_;
+  }
+  else
+  {
+     sampleOffset = sample * bytesAllocated_ * columns_ * rows_;
+     offsetBetweenSamples = bytesAllocated_;
+  }
+  const Uint8 *pixelPointer = frameData_ + sampleOffset + bytesAllocated_ - byte - 1;
+
+  // initialize new RLE codec for this stripe
+  DcmRLEEncoder *rleEncoder = new DcmRLEEncoder(1 /* DICOM padding required */);
+  if ((rleEncoder == NULL) || rleEncoder->fail())
+  {
+    delete rleEncoder;
+    return EC_MemoryExhausted;
+  }
+  encoders_[stripe] = rleEncoder;
+
+  // unless the bytes of this stripe are contiguous, they are collected row by row
+  Uint8 *rowBuffer = NULL;
+  if (offsetBetweenSamples > 1)
+  {
+    rowBuffer = new Uint8[columns_];
+    if (rowBuffer == NULL) return EC_MemoryExhausted;
+  }
+
+  // loop through all rows of the frame
+  for (row = 0; row < rows_; ++row)
+  {
+    if (rowBuffer)
+    {
+      for (column = 0; column < columns_; ++column)
+      {
+        rowBuffer[column] = *pixelPointer;
+        pixelPointer += offsetBetweenSamples;
+      }
+      rleEncoder->add(rowBuffer, columns_);
+    }
+    else
+    {
+      rleEncoder->add(pixelPointer, columns_);
+      pixelPointer += columns_;
+    }
+
+    // enforce DICOM rule that "Each row of the image shall be encoded
+    // separately and not cross a row boundary."
+    // (see DICOM part 5 section G.3.1)
+    rleEncoder->flush();
+  }
+  delete[] rowBuffer;
+
+  return rleEncoder->fail() ? EC_MemoryExhausted : EC_Normal;
+}
+
+
+/** helper class compressing the frames of an image with RLE. The frames
+ *  are either taken from the uncompressed pixel data or decompressed batch
+ *  by batch by a frame source.
+ */
+class DcmRLEFrameCompressor: public DcmFrameCompressor
+{
+public:
+
+  /** constructor
+   *  @param pixelData uncompressed pixel data in little endian byte order,
+   *    NULL if the frames are provided by the frame source
+   *  @param frames source of the uncompressed frames, NULL if pixelData is used
+   *  @param columns number of columns
+   *  @param rows number of rows
+   *  @param samplesPerPixel number of samples per pixel
+   *  @param bytesAllocated number of bytes allocated per sample
+   *  @param planarConfiguration planar configuration of the uncompressed image
+   *  @param stripeThreads maximum number of threads used for the stripes of a frame
+   */
+  DcmRLEFrameCompressor(
+    const Uint8 *pixelData,
+    DcmFrameSource *frames,
+    Uint16 columns,
+    Uint16 rows,
+    Uint16 samplesPerPixel,
+    Uint16 bytesAllocated,
+    Uint16 planarConfiguration,
+    Uint32 stripeThreads)
+  : DcmFrameCompressor()
+  , pixelData_(pixelData)
+  , frames_(frames)
+  , columns_(columns)
+  , rows_(rows)
+  , samplesPerPixel_(samplesPerPixel)
+  , bytesAllocated_(bytesAllocated)
+  , planarConfiguration_(planarConfiguration)
+  , stripeThreads_(stripeThreads)
+  {
+  }
+
+protected:
+
+  /** decompress a batch of frames if a frame source is used
+   *  @param firstFrame number of the first frame of the batch
+   *  @param numberOfFrames number of frames in the batch
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition prepareFrames(Uint32 firstFrame, Uint32 numberOfFrames);
+
+  /** compress a single frame
+   *  @param frameNo number of the frame to be compressed
+   *  @param compressedData returns the compressed frame including RLE header
+   *  @param compressedLength returns the length of the compressed frame
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition compressFrame(Uint32 frameNo, Uint8 *&compressedData, Uint32 &compressedLength);
+
+private:
+
+  /// uncompressed pixel data in little endian byte order
+  const Uint8 *pixelData_;
+
+  /// source of the uncompressed frames, NULL if pixelData_ is used
+  DcmFrameSource *frames_;
+
+  /// number of columns
+  Uint16 columns_;
+
+  /// number of rows
+  Uint16 rows_;
+
+  /// number of samples per pixel
+  Uint16 samplesPerPixel_;
+
+  /// number of bytes allocated per sample
+  Uint16 bytesAllocated_;
+
+  /// planar configuration of the uncompressed image
+  Uint16 planarConfiguration_;
+
+  /// maximum number of threads used for the stripes of a frame
+  Uint32 stripeThreads_;
+};
+
+
+OFCondition DcmRLEFrameCompressor::prepareFrames(Uint32 firstFrame, Uint32 numberOfFrames)
+{
+  if (frames_ == NULL) return EC_Normal;
+  OFCondition result = frames_->decompressFrames(firstFrame, numberOfFrames);
+
+  // byte swap the frames to little endian
+  if (result.good() && (gLocalByteOrder == EBO_BigEndian))
+  {
+    const Uint32 frameSize = frames_->getFrameSize();
+    for (Uint32 i = 0; (i < numberOfFrames) && result.good(); ++i)
+      result = swapIfNecessary(EBO_LittleEndian, gLocalByteOrder, frames_->getFrame(firstFrame + i), frameSize + (frameSize & 1), sizeof(Uint16));
+  }
+  return result;
+}
+
+
+OFCondition DcmRLEFrameCompressor::compressFrame(Uint32 frameNo, Uint8 *&compressedData, Uint32 &compressedLength)
+{
+  const Uint32 frameSize = columns_ * rows_ * samplesPerPixel_ * bytesAllocated_;
+  Uint32 rleHeader[16];
+  Uint32 rleSize = 0;
+  Uint8 *rleData = NULL;
+  Uint8 *rleData2 = NULL;
+  Uint32 i;
+
+  DCMDATA_DEBUG("RLE encoder processes frame " << frameNo);
+
+  const Uint8 *frameData = frames_ ? frames_->getFrame(frameNo) : pixelData_ + frameSize * frameNo;
+  if (frameData == NULL) return EC_IllegalCall;
+
+  // compress the stripes of the frame, possibly in parallel
+  DcmRLEStripeCompressor stripes(frameData, columns_, rows_,
+    samplesPerPixel_, bytesAllocated_, planarConfiguration_);
+  const Uint32 numberOfStripes = stripes.numberOfStripes();
+  OFCondition result = stripes.run(0, numberOfStripes, stripeThreads_);
+
+  // create compressed frame
+  if (result.good() && (numberOfStripes > 0) && (numberOfStripes < 16))
+  {
+    // compute size of compressed frame including RLE header
+    // and populate RLE header
+    for (i=0; i<16; i++) rleHeader[i] = 0;
+    rleHeader[0] = numberOfStripes;
+    rleSize = 64;
+    for (i=0; i<numberOfStripes; i++)
+    {
+      rleHeader[i+1] = rleSize;
+      rleSize += OFstatic_cast(Uint32, stripes.getEncoder(i).size());
+    }
+
+    // allocate buffer for compressed frame
+    rleData = new Uint8[rleSize];
+
+    if (rleData)
+    {
+      // copy RLE header to compressed frame buffer
+      swapIfNecessary(EBO_LittleEndian, gLocalByteOrder, rleHeader, OFstatic_cast(Uint32, 16*sizeof(Uint32)), sizeof(Uint32));
+      memcpy(rleData, rleHeader, 64);
+
+      // store RLE stripe sets in compressed frame buffer
+      rleData2 = rleData + 64;
+      for (i=0; i<numberOfStripes; i++)
+      {
+        stripes.getEncoder(i).write(rleData2);
+        rleData2 += stripes.getEncoder(i).size();
+      }
+      compressedData = rleData;
+      compressedLength = rleSize;
+    } else result = EC_MemoryExhausted;
+  }
+  else if (result.good()) result = EC_CannotChangeRepresentation;
+
+  return result;
+}
 
 
 // =======================================================================
@@ -103,7 +427,8 @@ OFCondition DcmRLECodecEncoder::encode(
     const DcmCodecParameter * /* cp */,
     DcmStack & /* objStack */) const
 {
-  // we don't support re-coding for now.
+  // we don't support direct re-coding, compressed images are
+  // transcoded frame by frame with encodeFrames()
   return EC_IllegalCall;
 }
 
@@ -115,6 +440,29 @@ OFCondition DcmRLECodecEncoder::encode(
     DcmPixelSequence * & pixSeq,
     const DcmCodecParameter *cp,
     DcmStack & objStack) const
+{
+  return encodeImage(pixelData, length, NULL, pixSeq, cp, objStack);
+}
+
+
+OFCondition DcmRLECodecEncoder::encodeFrames(
+    DcmFrameSource& frames,
+    const DcmRepresentationParameter * /* toRepParam */ ,
+    DcmPixelSequence * & pixSeq,
+    const DcmCodecParameter *cp,
+    DcmStack & objStack) const
+{
+  return encodeImage(NULL, 0, &frames, pixSeq, cp, objStack);
+}
+
+
+OFCondition DcmRLECodecEncoder::encodeImage(
+    const Uint16 *pixelData,
+    const Uint32 length,
+    DcmFrameSource *frames,
+    DcmPixelSequence * & pixSeq,
+    const DcmCodecParameter *cp,
+    DcmStack & objStack) const
 {
   OFCondition result = EC_Normal;
 
@@ -124,13 +472,7 @@ OFCondition DcmRLECodecEncoder::encode(
   (void)localStack.pop();             // pop pixel data element from stack
   DcmObject *dataset = localStack.pop(); // this is the item in which the pixel data is located
   Uint8 *pixelData8 = OFreinterpret_cast(Uint8 *, OFconst_cast(Uint16 *, pixelData));
-  Uint8 *pixelPointer = NULL;
   DcmOffsetList offsetList;
-  DcmRLEEncoderList rleEncoderList;
-  DcmRLEEncoderListIterator first = rleEncoderList.begin();
-  DcmRLEEncoderListIterator last = rleEncoderList.end();
-  Uint32 rleHeader[16];
-  Uint32 i;
   OFBool byteSwapped = OFFalse;  // true if we have byte-swapped the original pixel data
 
   if ((!dataset)||((dataset->ident()!= EVR_dataset) && (dataset->ident()!= EVR_item))) result = EC_InvalidTag;
@@ -145,7 +487,7 @@ OFCondition DcmRLECodecEncoder::encode(
     Uint16 rows = 0;
     Sint32 numberOfFrames = 1;
     Uint32 numberOfStripes = 0;
-    Uint32 compressedSize = 0;
+    size_t compressedSize = 0;
 
     result = ditem->findAndGetUint16(DCM_BitsAllocated, bitsAllocated);
     if (result.good()) result = ditem->findAndGetUint16(DCM_SamplesPerPixel, samplesPerPixel);
@@ -176,7 +518,11 @@ OFCondition DcmRLECodecEncoder::encode(
       if (numberOfStripes > 15) result = EC_CannotChangeRepresentation;
 
       // make sure that we have at least as many bytes of pixel data as we expect
-      if (numberOfStripes * columns * rows * numberOfFrames > length) result = EC_CannotChangeRepresentation;
+      if (frames)
+      {
+        if (numberOfStripes * columns * rows > frames->getFrameSize()) result = EC_CannotChangeRepresentation;
+      }
+      else if (numberOfStripes * columns * rows * numberOfFrames > length) result = EC_CannotChangeRepresentation;
     }
 
     DcmPixelSequence *pixelSequence = NULL;
@@ -196,8 +542,9 @@ OFCondition DcmRLECodecEncoder::encode(
       }
     }
 
-    // byte swap pixel data to little endian
-    if (gLocalByteOrder == EBO_BigEndian)
+    // byte swap pixel data to little endian. Frames provided by a frame source
+    // are swapped after decompression.
+    if (pixelData && (gLocalByteOrder == EBO_BigEndian))
     {
       swapIfNecessary(EBO_LittleEndian, gLocalByteOrder, OFstatic_cast(void *, OFconst_cast(Uint16 *, pixelData)), length, sizeof(Uint16));
     }
@@ -205,137 +552,17 @@ OFCondition DcmRLECodecEncoder::encode(
     // create RLE stripe sets
     if (result.good())
     {
-      const Uint32 bytesPerStripe = columns * rows;
-      const Uint32 frameSize = columns * rows * samplesPerPixel * bytesAllocated;
-      Uint32 frameOffset = 0;
-      Uint32 sampleOffset = 0;
-      Uint32 offsetBetweenSamples = 0;
-      Uint32 sample = 0;
-      Uint32 byte = 0;
-      register Uint32 pixel = 0;
-      register Uint32 columnCounter = 0;
-
-      DcmRLEEncoder *rleEncoder = NULL;
-      Uint32 rleSize = 0;
-      Uint8 *rleData = NULL;
-      Uint8 *rleData2 = NULL;
-
       // warn about (possibly) non-standard fragmentation
       if (djcp->getFragmentSize() > 0)
          DCMDATA_WARN("DcmRLECodecEncoder: limiting the fragment size may result in non-standard conformant encoding");
 
-      // compute byte offset between samples
-      if (planarConfiguration == 0)
-         offsetBetweenSamples = samplesPerPixel * bytesAllocated;
-         else offsetBetweenSamples = bytesAllocated;
-
-      // loop through all frames of the image
-      for (Uint32 currentFrame = 0; ((currentFrame < OFstatic_cast(Uint32, numberOfFrames)) && result.good()); currentFrame++)
-      {
-        // offset to start of frame, in bytes
-        frameOffset = frameSize * currentFrame;
-
-        // loop through all samples of one frame
-        for (sample = 0; sample < samplesPerPixel; sample++)
-        {
-          // compute byte offset for first sample in frame
-          if (planarConfiguration == 0)
-             sampleOffset = sample * bytesAllocated;
-             else sampleOffset = sample * bytesAllocated * columns * rows;
-
-          // loop through the bytes of one sample
-          for (byte = 0; byte < bytesAllocated; byte++)
-          {
-            pixelPointer = pixelData8 + frameOffset + sampleOffset + bytesAllocated - byte - 1;
-
-            // initialize new RLE codec for this stripe
-            rleEncoder = new DcmRLEEncoder(1 /* DICOM padding required */);
-            if (rleEncoder)
-            {
-              rleEncoderList.push_back(rleEncoder);
-              columnCounter = columns;
-
-              // loop through all pixels of the frame
-              for (pixel = 0; pixel < bytesPerStripe; ++pixel)
-              {
-                rleEncoder->add(*pixelPointer);
-
-                // enforce DICOM rule that "Each row of the image shall be encoded
-                // separately and not cross a row boundary."
-                // (see DICOM part 5 section G.3.1)
-                if (--columnCounter == 0)
-                {
-                  rleEncoder->flush();
-                  columnCounter = columns;
-                }
-                pixelPointer += offsetBetweenSamples;
-              }
-
-              rleEncoder->flush();
-              if (rleEncoder->fail()) result = EC_MemoryExhausted;
-            } else result = EC_MemoryExhausted;
-          }
-        }
-
-        // store frame and erase RLE codec list
-        if (result.good() && (rleEncoderList.size() > 0) && (rleEncoderList.size() < 16))
-        {
-          // compute size of compressed frame including RLE header
-          // and populate RLE header
-          for (i=0; i<16; i++) rleHeader[i] = 0;
-          rleHeader[0] = OFstatic_cast(Uint32, rleEncoderList.size());
-          rleSize = 64;
-          i = 1;
-          first = rleEncoderList.begin();
-          while (first != last)
-          {
-            rleHeader[i++] = rleSize;
-            rleSize += OFstatic_cast(Uint32, (*first)->size());
-            ++first;
-          }
-
-          // allocate buffer for compressed frame
-          rleData = new Uint8[rleSize];
-
-          if (rleData)
-          {
-            // copy RLE header to compressed frame buffer
-            swapIfNecessary(EBO_LittleEndian, gLocalByteOrder, rleHeader, OFstatic_cast(Uint32, 16*sizeof(Uint32)), sizeof(Uint32));
-            memcpy(rleData, rleHeader, 64);
-
-            // store RLE stripe sets in compressed frame buffer
-            rleData2 = rleData + 64;
-            first = rleEncoderList.begin();
-            while (first != last)
-            {
-              (*first)->write(rleData2);
-              rleData2 += (*first)->size();
-              delete *first;
-              first = rleEncoderList.erase(first);
-            }
-
-            // store compressed frame, breaking into segments if necessary
-            result = pixelSequence->storeCompressedFrame(offsetList, rleData, rleSize, djcp->getFragmentSize());
-            compressedSize += rleSize;
-
-            // erase buffer for compressed frame
-            delete[] rleData;
-          } else result = EC_MemoryExhausted;
-        }
-        else
-        {
-          // erase RLE codec list
-          first = rleEncoderList.begin();
-          while (first != last)
-          {
-            delete *first;
-            first = rleEncoderList.erase(first);
-          }
-          if (result.good()) result = EC_CannotChangeRepresentation;
-        }
-
-      }
-
+      // compress all frames, possibly in parallel, and store them in the pixel sequence.
+      // If there are less frames than threads, the stripes of each frame are compressed
+      // in parallel as well.
+      const Uint32 maxThreads = dcmCodecMaxThreads.get();
+      const Uint32 stripeThreads = (OFstatic_cast(Uint32, numberOfFrames) < maxThreads) ? maxThreads / OFstatic_cast(Uint32, numberOfFrames) : 1;
+      DcmRLEFrameCompressor compressor(pixelData8, frames, columns, rows, samplesPerPixel, bytesAllocated, planarConfiguration, stripeThreads);
+      result = compressor.compress(pixelSequence, offsetList, OFstatic_cast(Uint32, numberOfFrames), djcp->getFragmentSize(), compressedSize, maxThreads);
     }
 
     // store pixel sequence if everything went well.
@@ -0,0 +1,142 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: RLE compressor
+ *
+ */
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+#include "dcmtk/dcmdata/dcrleenc.h"
+
+/* SSE2 is part of the x86-64 base instruction set, so no runtime check is needed */
+#if defined(__GNUC__) && defined(__SSE2__)
+#define DCRLEENC_SSE2
+#include <emmintrin.h>
+#endif
+
+
+/* find the end of the run of identical bytes starting at 'pos'
+ * @return pointer to the first byte different from *pos, or 'end'
+ */
+static inline const unsigned char *findRunEnd(const unsigned char *pos,
+                                              const unsigned char *end)
+{
+    const unsigned char value = *pos;
+#ifdef DCRLEENC_SSE2
+    const __m128i v = _mm_set1_epi8(OFstatic_cast(char, value));
+    while (end - pos >= 16)
+    {
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(OFreinterpret_cast(const __m128i *, pos)), v));
+        if (mask != 0xffff)
+            return pos + __builtin_ctz(~mask);
+        pos += 16;
+    }
+#endif
+    while ((pos < end) && (*pos == value))
+        ++pos;
+    return pos;
+}
+
+
+/* find the start of the next run of at least three identical bytes,
+ * i.e. the first position 'i' with pos[i] == pos[i+1] == pos[i+2]
+ * @return pointer to the start of the run, or 'end' if there is none
+ */
+static inline const unsigned char *findReplicateRun(const unsigned char *pos,
+                                                    const unsigned char *end)
+{
+#ifdef DCRLEENC_SSE2
+    while (end - pos >= 18)
+    {
+        const __m128i v0 = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, pos));
+        const __m128i v1 = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, pos + 1));
+        const __m128i v2 = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, pos + 2));
+        const int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(v0, v1), _mm_cmpeq_epi8(v1, v2)));
+        if (mask != 0)
+            return pos + __builtin_ctz(mask);
+        pos += 16;
+    }
+#endif
+    while (end - pos >= 3)
+    {
+        if ((pos[0] == pos[1]) && (pos[1] == pos[2]))
+            return pos;
+        ++pos;
+    }
+    return end;
+}
+
+
+void DcmRLEEncoder::add(const unsigned char *buf, size_t bufcount)
+{
+  if (buf)
+  {
+    const unsigned char *end = buf + bufcount;
+    const unsigned char *start;
+    const unsigned char *next;
+    while ((buf < end) && (! fail_)) // if fail_ is true, just ignore input
+    {
+      if (OFstatic_cast(int, *buf) == RLE_prev_)
+      {
+        // continuation of the current repeat run, just increase the repeat counter
+        next = findRunEnd(buf, end);
+        RLE_pcount_ += OFstatic_cast(int, next - buf);
+        buf = next;
+      }
+      else
+      {
+        // byte is different from last byte read, flush the repeat run.
+        // The byte then starts a new repeat run with RLE_pcount_ 1.
+        start = buf;
+        add(*buf++);
+
+        // all runs of one or two bytes up to the next run of three or more
+        // bytes end up in the literal run, so copy them there in one go.
+        next = findReplicateRun(start, end);
+        if (next > buf)
+        {
+          // the last run before 'next' (one or two bytes) is kept as the
+          // repeat run, since it may be continued by the next call of add()
+          buf = next - 1;
+          if ((buf > start) && (buf[-1] == *buf)) --buf;
+          appendLiteral(start, buf - start);
+          RLE_prev_ = *buf;
+          RLE_pcount_ = OFstatic_cast(int, next - buf);
+          buf = next;
+        }
+      }
+    }
+  }
+}
+
+
+void DcmRLEEncoder::appendLiteral(const unsigned char *buf, size_t bufcount)
+{
+  size_t count;
+  while ((bufcount > 0) && (! fail_))
+  {
+    // fill the literal run up to 129 bytes, i.e. RLE_bindex_ 130
+    count = 130 - RLE_bindex_;
+    if (count > bufcount) count = bufcount;
+    memcpy(RLE_buff_ + RLE_bindex_, buf, count);
+    RLE_bindex_ += OFstatic_cast(unsigned int, count);
+    buf += count;
+    bufcount -= count;
+
+    // if we have more than 128 bytes in the literal run, flush buffer
+    if (RLE_bindex_ > 129)
+    {
+      RLE_buff_[0] = 127;
+      move(129);
+      RLE_bindex_ -= 128;
+      RLE_buff_[1] = RLE_buff_[129];
+    }
+  }
+}
@@ -34,7 +34,6 @@ void DcmWriteCache::init(void *owner,
 {
   if (! buf_)
   {
-    capacity_ = DcmWriteCacheBufsize;
     buf_ = new Uint8[capacity_];
   }
 
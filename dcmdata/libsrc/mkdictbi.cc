@@ -75,6 +75,107 @@ rr2s(DcmDictRangeRestriction rr)
     return s;
 }
 
+/*
+** Compute a minimal perfect hash function for the given entries (see
+** DcmStaticHashDict): each key is assigned to one of 'count' first level
+** buckets.  For each bucket with more than one key, a seed is searched that
+** maps all keys of the bucket to free slots.  Keys of the remaining buckets
+** are stored in the remaining free slots directly.  The entries are returned
+** in slot order.
+*/
+static OFBool
+computePerfectHash(DcmDictEntry** entries, int count, Sint32* seeds, DcmDictEntry** slots)
+{
+    int i, j;
+    int maxBucketSize = 0;
+    const Uint32 n = OFstatic_cast(Uint32, count);
+    int* bucketOf = new int[count];
+    int* bucketSize = new int[count];
+    Uint32* members = new Uint32[count];
+
+    for (i = 0; i < count; i++) {
+        seeds[i] = 0;
+        slots[i] = NULL;
+        bucketSize[i] = 0;
+    }
+    for (i = 0; i < count; i++) {
+        bucketOf[i] = OFstatic_cast(int, DcmStaticHashDict::hash(*entries[i], entries[i]->getPrivateCreator(), 0) % n);
+        if (++bucketSize[bucketOf[i]] > maxBucketSize)
+            maxBucketSize = bucketSize[bucketOf[i]];
+    }
+
+    OFBool result = OFTrue;
+    /* largest buckets first, since these are the hardest to place */
+    for (int size = maxBucketSize; result && (size > 1); size--) {
+        for (int b = 0; result && (b < count); b++) {
+            if (bucketSize[b] != size)
+                continue;
+            int m = 0;
+            for (i = 0; i < count; i++) {
+                if (bucketOf[i] == b)
+                    members[m++] = OFstatic_cast(Uint32, i);
+            }
+            Sint32 seed;
+            for (seed = 1; seed < 0x1000000; seed++) {
+                OFBool ok = OFTrue;
+                for (i = 0; ok && (i < m); i++) {
+                    DcmDictEntry* e = entries[members[i]];
+                    const Uint32 slot = DcmStaticHashDict::hash(*e, e->getPrivateCreator(), OFstatic_cast(Uint32, seed)) % n;
+                    ok = (slots[slot] == NULL);
+                    if (ok) {
+                        /* mark the slot as used (for the keys of this bucket) */
+                        slots[slot] = e;
+                    } else {
+                        /* slot already in use: undo the marks of this bucket */
+                        for (j = 0; j < i; j++) {
+                            const DcmDictEntry* f = entries[members[j]];
+                            slots[DcmStaticHashDict::hash(*f, f->getPrivateCreator(), OFstatic_cast(Uint32, seed)) % n] = NULL;
+                        }
+                    }
+                }
+                if (ok)
+                    break;
+            }
+            if (seed < 0x1000000)
+                seeds[b] = seed;
+            else
+                result = OFFalse;
+        }
+    }
+
+    /* buckets with a single key are stored in the remaining free slots */
+    int freeSlot = 0;
+    for (int b = 0; result && (b < count); b++) {
+        if (bucketSize[b] == 1) {
+            for (i = 0; bucketOf[i] != b; i++) /*loop*/;
+            while (slots[freeSlot] != NULL)
+                freeSlot++;
+            slots[freeSlot] = entries[i];
+            seeds[b] = -(freeSlot + 1);
+        }
+    }
+
+    delete[] bucketOf;
+    delete[] bucketSize;
+    delete[] members;
+    return result;
+}
+
+static void
+printSeeds(FILE* fout, const char* name, const Sint32* seeds, int count)
+{
+    fprintf(fout, "static const Sint32 %s[] = {\n", name);
+    for (int i = 0; i < count; i++) {
+        if (i % 8 == 0)
+            fprintf(fout, "   ");
+        fprintf(fout, " %d%s", OFstatic_cast(int, seeds[i]), (i + 1 < count) ? "," : "");
+        if ((i % 8 == 7) || (i + 1 == count))
+            fprintf(fout, "\n");
+    }
+    fprintf(fout, "};\n");
+    fprintf(fout, "\n");
+}
+
 static void
 printSimpleEntry(FILE* fout, const DcmDictEntry* e, OFBool& isFirst, OFBool& isPrivate)
 {
@@ -120,6 +221,7 @@ main(int argc, char* argv[])
 {
     char* progname;
     const char* filename = NULL;
+    int i;
     FILE* fout = NULL;
     DcmDictEntry* e = NULL;
 
@@ -139,8 +241,9 @@ main(int argc, char* argv[])
 
     DcmDataDictionary& globalDataDict = dcmDataDict.wrlock();
 
-    /* clear out any preloaded dictionary */
-    globalDataDict.clear();
+    /* clear out any preloaded dictionary, but keep the skeleton entries in
+     * order to get the same order of repeating tags as at runtime */
+    globalDataDict.reloadDictionaries(OFFalse /*loadBuiltin*/, OFFalse /*loadExternal*/);
 
     progname = argv[0];
 
@@ -150,7 +253,6 @@ main(int argc, char* argv[])
         argc -= 2;
     }
 
-    int i;
     for (i=1; i<argc; i++) {
         globalDataDict.loadDictionary(argv[i]);
     }
@@ -194,6 +296,9 @@ main(int argc, char* argv[])
     fprintf(fout, "#ifdef ENABLE_BUILTIN_DICTIONARY\n");
     fprintf(fout, "#include \"dcmtk/dcmdata/dcdicent.h\"\n");
     fprintf(fout, "\n");
+    fprintf(fout, "#define INCLUDE_NEW\n");
+    fprintf(fout, "#include \"dcmtk/ofstd/ofstdinc.h\"\n");
+    fprintf(fout, "\n");
     fprintf(fout, "struct DBI_SimpleEntry {\n");
     fprintf(fout, "    Uint16 group;\n");
     fprintf(fout, "    Uint16 element;\n");
@@ -209,7 +314,6 @@ main(int argc, char* argv[])
     fprintf(fout, "    const char* privateCreator;\n");
     fprintf(fout, "};\n");
     fprintf(fout, "\n");
-    fprintf(fout, "static const DBI_SimpleEntry simpleBuiltinDict[] = {\n");
 
     OFBool isFirst = OFTrue;
     OFBool isPrivate = OFFalse;
@@ -225,22 +329,80 @@ main(int argc, char* argv[])
         e = new DcmDictEntry(*(*iter));
         list.insertAndReplace(e);
     }
-    /* output the list contents */
 
-    /* non-repeating standard elements */
+    /* separate the entries without and with private creator */
+    const int normalCount = OFstatic_cast(int, list.size());
+    DcmDictEntry** publicEntries = new DcmDictEntry*[normalCount];
+    DcmDictEntry** privateEntries = new DcmDictEntry*[normalCount];
+    int publicCount = 0;
+    int privateCount = 0;
     DcmDictEntryListIterator listIter(list.begin());
     DcmDictEntryListIterator listLast(list.end());
     for (; listIter != listLast; ++listIter)
     {
-        printSimpleEntry(fout, *listIter, isFirst, isPrivate);
+        if ((*listIter)->getPrivateCreator() == NULL)
+            publicEntries[publicCount++] = *listIter;
+        else
+            privateEntries[privateCount++] = *listIter;
     }
 
-    /* repeating standard elements */
+    /* compute the perfect hash functions */
+    DcmDictEntry** publicSlots = new DcmDictEntry*[normalCount];
+    DcmDictEntry** privateSlots = new DcmDictEntry*[normalCount];
+    Sint32* publicSeeds = new Sint32[normalCount];
+    Sint32* privateSeeds = new Sint32[normalCount];
+    if (!computePerfectHash(publicEntries, publicCount, publicSeeds, publicSlots) ||
+        !computePerfectHash(privateEntries, privateCount, privateSeeds, privateSlots))
+    {
+        fprintf(stderr, "Failed to compute perfect hash function, giving up\n");
+        return -1;
+    }
+
+    /* count the repeating tags without and with private creator */
+    int publicRepCount = 0;
+    int privateRepCount = 0;
     DcmDictEntryListIterator repIter(globalDataDict.repeatingBegin());
     DcmDictEntryListIterator repLast(globalDataDict.repeatingEnd());
     for (; repIter != repLast; ++repIter)
     {
-        printSimpleEntry(fout, *repIter, isFirst, isPrivate);
+        if ((*repIter)->getPrivateCreator() == NULL)
+            publicRepCount++;
+        else
+            privateRepCount++;
+    }
+
+    fprintf(fout, "/*\n");
+    fprintf(fout, "** The entries of the builtin dictionary: the normal (non-repeating) tags\n");
+    fprintf(fout, "** without and with private creator, each part ordered by the slots of its\n");
+    fprintf(fout, "** perfect hash table, followed by the repeating tags without and with\n");
+    fprintf(fout, "** private creator, each part in the order of the lookup.\n");
+    fprintf(fout, "*/\n");
+    fprintf(fout, "static const DBI_SimpleEntry simpleBuiltinDict[] = {\n");
+
+    /* non-repeating standard elements */
+    for (i = 0; i < publicCount; i++)
+    {
+        printSimpleEntry(fout, publicSlots[i], isFirst, isPrivate);
+    }
+
+    /* non-repeating private elements */
+    for (i = 0; i < privateCount; i++)
+    {
+        printSimpleEntry(fout, privateSlots[i], isFirst, isPrivate);
+    }
+
+    /* repeating standard elements */
+    for (repIter = globalDataDict.repeatingBegin(); repIter != repLast; ++repIter)
+    {
+        if ((*repIter)->getPrivateCreator() == NULL)
+            printSimpleEntry(fout, *repIter, isFirst, isPrivate);
+    }
+
+    /* repeating private elements */
+    for (repIter = globalDataDict.repeatingBegin(); repIter != repLast; ++repIter)
+    {
+        if ((*repIter)->getPrivateCreator() != NULL)
+            printSimpleEntry(fout, *repIter, isFirst, isPrivate);
     }
 
     if (isPrivate)
@@ -253,23 +415,68 @@ main(int argc, char* argv[])
     fprintf(fout, "static const size_t simpleBuiltinDict_count =\n");
     fprintf(fout, "    sizeof(simpleBuiltinDict)/sizeof(DBI_SimpleEntry);\n");
     fprintf(fout, "\n");
-
+    fprintf(fout, "static const int publicBuiltinDict_count = %d;\n", publicCount);
+    fprintf(fout, "static const int publicRepBuiltinDict_count = %d;\n", publicRepCount);
+    fprintf(fout, "#ifdef %s\n", PRIVATE_TAGS_IFNAME);
+    fprintf(fout, "static const int privateBuiltinDict_count = %d;\n", privateCount);
+    fprintf(fout, "static const int privateRepBuiltinDict_count = %d;\n", privateRepCount);
+    fprintf(fout, "#else\n");
+    fprintf(fout, "static const int privateBuiltinDict_count = 0;\n");
+    fprintf(fout, "static const int privateRepBuiltinDict_count = 0;\n");
+    fprintf(fout, "#endif\n");
+    fprintf(fout, "\n");
+    fprintf(fout, "/* seeds of the perfect hash function (see DcmStaticHashDict) */\n");
+    printSeeds(fout, "publicBuiltinDict_seeds", publicSeeds, publicCount);
+    fprintf(fout, "#ifdef %s\n", PRIVATE_TAGS_IFNAME);
+    printSeeds(fout, "privateBuiltinDict_seeds", privateSeeds, privateCount);
+    fprintf(fout, "#else\n");
+    fprintf(fout, "static const Sint32 *privateBuiltinDict_seeds = NULL;\n");
+    fprintf(fout, "#endif\n");
+    fprintf(fout, "\n");
+    fprintf(fout, "/* memory for the dictionary entries, which are constructed in place */\n");
+    fprintf(fout, "static union {\n");
+    fprintf(fout, "    char data[sizeof(DcmDictEntry) * simpleBuiltinDict_count];\n");
+    fprintf(fout, "    double alignDouble;\n");
+    fprintf(fout, "    void *alignPointer;\n");
+    fprintf(fout, "} builtinDictStorage;\n");
+    fprintf(fout, "\n");
+    fprintf(fout, "static OFBool builtinDictConstructed = OFFalse;\n");
+    fprintf(fout, "#ifdef WITH_THREADS\n");
+    fprintf(fout, "static OFMutex builtinDictMutex;\n");
+    fprintf(fout, "#endif\n");
+    fprintf(fout, "\n");
     fprintf(fout, "\n");
     fprintf(fout, "void\n");
     fprintf(fout, "DcmDataDictionary::loadBuiltinDictionary()\n");
     fprintf(fout, "{\n");
-    fprintf(fout, "    DcmDictEntry* e = NULL;\n");
-    fprintf(fout, "    const DBI_SimpleEntry *b = simpleBuiltinDict;\n");
-    fprintf(fout, "    for (size_t i=0; i<simpleBuiltinDict_count; ++i) {\n");
-    fprintf(fout, "        b = simpleBuiltinDict + i;\n");
-    fprintf(fout, "        e = new DcmDictEntry(b->group, b->element,\n");
-    fprintf(fout, "            b->upperGroup, b->upperElement, b->evr,\n");
-    fprintf(fout, "            b->tagName, b->vmMin, b->vmMax,\n");
-    fprintf(fout, "            b->standardVersion, OFFalse, b->privateCreator);\n");
-    fprintf(fout, "        e->setGroupRangeRestriction(b->groupRestriction);\n");
-    fprintf(fout, "        e->setElementRangeRestriction(b->elementRestriction);\n");
-    fprintf(fout, "        addEntry(e);\n");
+    fprintf(fout, "    DcmDictEntry* entries = OFreinterpret_cast(DcmDictEntry*, builtinDictStorage.data);\n");
+    fprintf(fout, "#ifdef WITH_THREADS\n");
+    fprintf(fout, "    builtinDictMutex.lock();\n");
+    fprintf(fout, "#endif\n");
+    fprintf(fout, "    /* the entries do not own any memory, so they are never destroyed */\n");
+    fprintf(fout, "    if (!builtinDictConstructed) {\n");
+    fprintf(fout, "        DcmDictEntry* e = NULL;\n");
+    fprintf(fout, "        const DBI_SimpleEntry *b = simpleBuiltinDict;\n");
+    fprintf(fout, "        for (size_t i=0; i<simpleBuiltinDict_count; ++i) {\n");
+    fprintf(fout, "            b = simpleBuiltinDict + i;\n");
+    fprintf(fout, "            e = new (entries + i) DcmDictEntry(b->group, b->element,\n");
+    fprintf(fout, "                b->upperGroup, b->upperElement, b->evr,\n");
+    fprintf(fout, "                b->tagName, b->vmMin, b->vmMax,\n");
+    fprintf(fout, "                b->standardVersion, OFFalse, b->privateCreator);\n");
+    fprintf(fout, "            e->setGroupRangeRestriction(b->groupRestriction);\n");
+    fprintf(fout, "            e->setElementRangeRestriction(b->elementRestriction);\n");
+    fprintf(fout, "        }\n");
+    fprintf(fout, "        builtinDictConstructed = OFTrue;\n");
     fprintf(fout, "    }\n");
+    fprintf(fout, "#ifdef WITH_THREADS\n");
+    fprintf(fout, "    builtinDictMutex.unlock();\n");
+    fprintf(fout, "#endif\n");
+    fprintf(fout, "    const int normalCount = publicBuiltinDict_count + privateBuiltinDict_count;\n");
+    fprintf(fout, "    setStaticEntries(\n");
+    fprintf(fout, "        DcmStaticHashDict(entries, publicBuiltinDict_seeds, publicBuiltinDict_count),\n");
+    fprintf(fout, "        DcmStaticHashDict(entries + publicBuiltinDict_count, privateBuiltinDict_seeds, privateBuiltinDict_count),\n");
+    fprintf(fout, "        entries + normalCount, publicRepBuiltinDict_count,\n");
+    fprintf(fout, "        publicRepBuiltinDict_count + privateRepBuiltinDict_count);\n");
     fprintf(fout, "}\n");
     fprintf(fout, "\n");
     fprintf(fout, "\n");
@@ -293,5 +500,11 @@ main(int argc, char* argv[])
     {
         fclose(fout);
     }
+    delete[] publicEntries;
+    delete[] privateEntries;
+    delete[] publicSlots;
+    delete[] privateSlots;
+    delete[] publicSeeds;
+    delete[] privateSeeds;
     return 0;
 }
@@ -27,6 +27,9 @@
 #include "dcmtk/dcmdata/dctagkey.h"
 #include "dcmtk/dcmdata/dcvr.h"
 #include "dcmtk/dcmdata/dcdicent.h"
+#include "dcmtk/dcmdata/dchashdi.h"
+#include "dcmtk/dcmdata/dcdeftag.h"
+#include "dcmtk/ofstd/ofthread.h"
 
 OFTEST(dcmdata_readingDataDictionary)
 {
@@ -106,3 +109,193 @@ OFTEST(dcmdata_usingDataDictionary)
 
 #undef checkDictionary
 }
+
+OFTEST(dcmdata_staticDictionaryTables)
+{
+    // A static table with a single entry: bucket 0 refers to slot 0 directly
+    const DcmDictEntry staticEntry(2, 2, DcmVR(EVR_PN), "StaticEntry", 1, 1,
+            "test", OFFalse, NULL);
+    const Sint32 seeds[] = { -1 };
+    DcmHashDict dict;
+    DcmTagKey key1(2, 2);
+    DcmTagKey key2(4, 4);
+
+    dict.setStaticTables(DcmStaticHashDict(&staticEntry, seeds, 1), DcmStaticHashDict());
+    OFCHECK_EQUAL(dict.size(), 1);
+    OFCHECK(dict.get(key1, NULL) == &staticEntry);
+    OFCHECK(dict.get(key1, "Test") == NULL);
+    OFCHECK(dict.get(key2, NULL) == NULL);
+    OFCHECK(*dict.begin() == &staticEntry);
+    OFCHECK(++dict.begin() == dict.end());
+
+    // An inserted entry replaces the static one with the same tag
+    DcmDictEntry *entry1 = new DcmDictEntry(2, 2, DcmVR(EVR_PN), "InsertedEntry", 1, 1,
+            "test", OFTrue, NULL);
+    DcmDictEntry *entry2 = new DcmDictEntry(4, 4, DcmVR(EVR_PN), "OtherEntry", 1, 1,
+            "test", OFTrue, NULL);
+    dict.put(entry1);
+    dict.put(entry2);
+    OFCHECK_EQUAL(dict.size(), 2);
+    OFCHECK(dict.get(key1, NULL) == entry1);
+    OFCHECK(dict.get(key2, NULL) == entry2);
+    int count = 0;
+    for (DcmHashDictIterator iter = dict.begin(); iter != dict.end(); ++iter) {
+        OFCHECK(*iter != &staticEntry);
+        count++;
+    }
+    OFCHECK_EQUAL(count, 2);
+
+    // Clearing the hash table also detaches the static table
+    dict.clear();
+    OFCHECK_EQUAL(dict.size(), 0);
+    OFCHECK(dict.get(key1, NULL) == NULL);
+    OFCHECK(dict.begin() == dict.end());
+}
+
+OFTEST(dcmdata_dictionarySnapshots)
+{
+    const DcmTagKey key(0x0009, 0x1001);
+    const char *creator = "DCMTK_SNAPSHOT_TEST";
+
+    // A copy of the dictionary is not affected by later modifications
+    const DcmDataDictionary &current = dcmDataDict.rdlock();
+    DcmDataDictionary copy(current);
+    OFCHECK_EQUAL(copy.numberOfEntries(), current.numberOfEntries());
+    OFCHECK_EQUAL(copy.numberOfRepeatingTagEntries(), current.numberOfRepeatingTagEntries());
+    OFCHECK(copy.findEntry(DCM_PatientName, NULL) != NULL);
+    copy.addEntry(new DcmDictEntry(key.getGroup(), key.getElement(), DcmVR(EVR_LO),
+        "SnapshotTest", 1, 1, "private", OFTrue, creator));
+    OFCHECK(copy.findEntry(key, creator) != NULL);
+    OFCHECK(current.findEntry(key, creator) == NULL);
+#ifndef DCMDICT_LOCKFREE_READ
+    // Without snapshots, the read lock has to be released before write access
+    dcmDataDict.unlock();
+#endif
+
+    // Modifications of the global dictionary are visible after unlock()
+    dcmDataDict.wrlock().addEntry(new DcmDictEntry(key.getGroup(), key.getElement(), DcmVR(EVR_LO),
+        "SnapshotTest", 1, 1, "private", OFTrue, creator));
+    dcmDataDict.unlock();
+    const DcmDictEntry *entry = dcmDataDict.rdlock().findEntry(key, creator);
+    OFCHECK(entry != NULL && entry->getVR().getEVR() == EVR_LO);
+    dcmDataDict.unlock();
+#ifdef DCMDICT_LOCKFREE_READ
+    // The snapshot used by a reader is neither modified nor deleted before unlock()
+    OFCHECK(current.findEntry(key, creator) == NULL);
+    OFCHECK(current.findEntry(DCM_PatientName, NULL) != NULL);
+    dcmDataDict.unlock();
+#endif
+
+    // Remove the entry from the global dictionary again
+    dcmDataDict.wrlock().deleteEntry(DcmDictEntry(key.getGroup(), key.getElement(), DcmVR(EVR_LO),
+        "SnapshotTest", 1, 1, "private", OFTrue, creator));
+    dcmDataDict.unlock();
+    OFCHECK(dcmDataDict.rdlock().findEntry(key, creator) == NULL);
+    dcmDataDict.unlock();
+}
+
+#ifdef WITH_THREADS
+
+/* thread reading the global dictionary while it is modified by another thread */
+class DictionaryReader
+  : public OFThread
+{
+public:
+    DictionaryReader() : OFThread(), failures(0) { }
+
+    int failures;
+
+protected:
+    virtual void run()
+    {
+        for (int i = 0; i < 20000; ++i)
+        {
+            const DcmDictEntry *entry = dcmDataDict.rdlock().findEntry(DCM_PatientName, NULL);
+            if (entry == NULL || entry->getVR().getEVR() != EVR_PN)
+                ++failures;
+            dcmDataDict.unlock();
+        }
+    }
+};
+
+OFTEST(dcmdata_dictionaryConcurrentAccess)
+{
+    const DcmTagKey key(0x0009, 0x1002);
+    const char *creator = "DCMTK_CONCURRENT_TEST";
+    DictionaryReader readers[4];
+    for (int i = 0; i < 4; ++i)
+        OFCHECK(readers[i].start() == 0);
+    // Replaced snapshots are deleted while the readers are running
+    for (int i = 0; i < 50; ++i)
+    {
+        dcmDataDict.wrlock().addEntry(new DcmDictEntry(key.getGroup(), key.getElement(), DcmVR(EVR_LO),
+            "ConcurrentTest", 1, 1, "private", OFTrue, creator));
+        dcmDataDict.unlock();
+        dcmDataDict.wrlock().deleteEntry(DcmDictEntry(key.getGroup(), key.getElement(), DcmVR(EVR_LO),
+            "ConcurrentTest", 1, 1, "private", OFTrue, creator));
+        dcmDataDict.unlock();
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        OFCHECK(readers[i].join() == 0);
+        OFCHECK_EQUAL(readers[i].failures, 0);
+    }
+    OFCHECK(dcmDataDict.rdlock().findEntry(key, creator) == NULL);
+    dcmDataDict.unlock();
+}
+
+/* thread reading the global dictionary with nested read locks */
+class NestedDictionaryReader
+  : public OFThread
+{
+public:
+    NestedDictionaryReader() : OFThread(), failures(0) { }
+
+    int failures;
+
+protected:
+    virtual void run()
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            const DcmDataDictionary &outer = dcmDataDict.rdlock();
+            const DcmDictEntry *entry = dcmDataDict.rdlock().findEntry(DCM_PatientName, NULL);
+            if (entry == NULL || entry->getVR().getEVR() != EVR_PN)
+                ++failures;
+            dcmDataDict.unlock();
+            // the outer snapshot is still valid after the inner unlock()
+            entry = outer.findEntry(DCM_PatientID, NULL);
+            if (entry == NULL || entry->getVR().getEVR() != EVR_LO)
+                ++failures;
+            dcmDataDict.unlock();
+        }
+    }
+};
+
+OFTEST(dcmdata_dictionaryShortLivedReaders)
+{
+    const DcmTagKey key(0x0009, 0x1003);
+    const char *creator = "DCMTK_SHORT_LIVED_TEST";
+    // The slots of terminated threads are reused by the following ones
+    for (int round = 0; round < 20; ++round)
+    {
+        NestedDictionaryReader readers[4];
+        for (int i = 0; i < 4; ++i)
+            OFCHECK(readers[i].start() == 0);
+        dcmDataDict.wrlock().addEntry(new DcmDictEntry(key.getGroup(), key.getElement(), DcmVR(EVR_LO),
+            "ShortLivedTest", 1, 1, "private", OFTrue, creator));
+        dcmDataDict.unlock();
+        dcmDataDict.wrlock().deleteEntry(DcmDictEntry(key.getGroup(), key.getElement(), DcmVR(EVR_LO),
+            "ShortLivedTest", 1, 1, "private", OFTrue, creator));
+        dcmDataDict.unlock();
+        for (int i = 0; i < 4; ++i)
+        {
+            OFCHECK(readers[i].join() == 0);
+            OFCHECK_EQUAL(readers[i].failures, 0);
+        }
+    }
+    OFCHECK(dcmDataDict.rdlock().findEntry(key, creator) == NULL);
+    dcmDataDict.unlock();
+}
+
+#endif
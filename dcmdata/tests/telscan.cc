@@ -0,0 +1,130 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test program for class DcmElementScanner
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dcelscan.h"
+#include "dcmtk/dcmdata/dcostrmb.h"
+
+#define BUFFER_SIZE 65536
+
+
+/* create a dataset with nested sequences of undefined length in front of the requested elements */
+static void createDataset(DcmDataset& dset)
+{
+    OFCHECK(dset.putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage).good());
+    OFCHECK(dset.putAndInsertString(DCM_SOPInstanceUID, "1.2.276.0.7230010.3.1.4.1").good());
+    DcmItem *item = NULL;
+    DcmItem *nested = NULL;
+    OFCHECK(dset.findOrCreateSequenceItem(DCM_ReferencedImageSequence, item, -2).good());
+    OFCHECK(item->putAndInsertString(DCM_ReferencedSOPInstanceUID, "1.2.3").good());
+    OFCHECK(item->findOrCreateSequenceItem(DCM_PurposeOfReferenceCodeSequence, nested, -2).good());
+    OFCHECK(nested->putAndInsertString(DCM_CodeValue, "121320").good());
+    OFCHECK(dset.findOrCreateSequenceItem(DCM_ReferencedImageSequence, item, -2).good());
+    OFCHECK(dset.putAndInsertString(DCM_PatientName, "Doe^John\\Doe^J ").good());
+    OFCHECK(dset.putAndInsertString(DCM_PatientID, "").good());
+    OFCHECK(dset.putAndInsertString(DCM_StudyInstanceUID, "1.2.276.0.7230010.3.1.2.1").good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Rows, 100).good());
+    Uint8 pixels[10000];
+    memset(pixels, 0, sizeof(pixels));
+    OFCHECK(dset.putAndInsertUint8Array(DCM_PixelData, pixels, sizeof(pixels)).good());
+}
+
+static void checkScanner(E_TransferSyntax xfer, size_t chunkSize)
+{
+    DcmDataset dset;
+    createDataset(dset);
+
+    Uint8 *buf = new Uint8[BUFFER_SIZE];
+    DcmOutputBufferStream stream(buf, BUFFER_SIZE);
+    dset.transferInit();
+    OFCHECK(dset.write(stream, xfer, EET_UndefinedLength, NULL).good());
+    dset.transferEnd();
+    void *data = NULL;
+    offile_off_t length = 0;
+    stream.flushBuffer(data, length);
+
+    DcmElementScanner scanner;
+    scanner.addTag(DCM_StudyInstanceUID);
+    scanner.addTag(DCM_SeriesInstanceUID);
+    scanner.addTag(DCM_SOPInstanceUID);
+    scanner.addTag(DCM_PatientName);
+    scanner.addTag(DCM_PatientID);
+    scanner.start(xfer);
+    size_t scanned = 0;
+    while (!scanner.finished() && (scanned < OFstatic_cast(size_t, length)))
+    {
+        const size_t n = (length - scanned < chunkSize) ? OFstatic_cast(size_t, length - scanned) : chunkSize;
+        scanner.scan(buf + scanned, n);
+        scanned += n;
+    }
+
+    // scanning stops at the first element following the requested ones
+    OFCHECK(scanner.finished());
+    OFCHECK(scanner.status().good());
+    if (chunkSize < 100) OFCHECK(scanned < 1000);
+
+    OFString value;
+    OFCHECK(scanner.getValue(DCM_StudyInstanceUID, value).good());
+    OFCHECK_EQUAL(value, "1.2.276.0.7230010.3.1.2.1");
+    OFCHECK(scanner.getValue(DCM_SOPInstanceUID, value).good());
+    OFCHECK_EQUAL(value, "1.2.276.0.7230010.3.1.4.1");
+    OFCHECK(scanner.getValue(DCM_PatientName, value).good());
+    OFCHECK_EQUAL(value, "Doe^John");
+    OFCHECK(scanner.getValue(DCM_PatientID, value).good());
+    OFCHECK(value.empty());
+    OFCHECK(scanner.getValue(DCM_SeriesInstanceUID, value) == EC_TagNotFound);
+    OFCHECK(scanner.getValue(DCM_CodeValue, value) == EC_TagNotFound);
+
+    delete[] buf;
+}
+
+
+OFTEST(dcmdata_elementScanner_littleEndianImplicit)
+{
+    checkScanner(EXS_LittleEndianImplicit, BUFFER_SIZE);
+    checkScanner(EXS_LittleEndianImplicit, 1);
+}
+
+OFTEST(dcmdata_elementScanner_littleEndianExplicit)
+{
+    checkScanner(EXS_LittleEndianExplicit, BUFFER_SIZE);
+    checkScanner(EXS_LittleEndianExplicit, 7);
+}
+
+OFTEST(dcmdata_elementScanner_bigEndianExplicit)
+{
+    checkScanner(EXS_BigEndianExplicit, BUFFER_SIZE);
+    checkScanner(EXS_BigEndianExplicit, 3);
+}
+
+OFTEST(dcmdata_elementScanner_unsupported)
+{
+    DcmElementScanner scanner;
+    scanner.addTag(DCM_StudyInstanceUID);
+    scanner.start(EXS_DeflatedLittleEndianExplicit);
+    OFCHECK(scanner.finished());
+    OFCHECK(scanner.status() == EC_UnsupportedEncoding);
+
+    // a sequence delimitation item at top level is invalid
+    const Uint8 data[] = { 0xfe, 0xff, 0xdd, 0xe0, 0, 0, 0, 0 };
+    scanner.start(EXS_LittleEndianImplicit);
+    OFCHECK(!scanner.finished());
+    scanner.scan(data, sizeof(data));
+    OFCHECK(scanner.finished());
+    OFCHECK(scanner.status() == EC_CorruptedData);
+}
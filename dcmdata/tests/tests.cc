@@ -24,6 +24,7 @@
 #include "dcmtk/ofstd/oftest.h"
 
 OFTEST_REGISTER(dcmdata_partialElementAccess);
+OFTEST_REGISTER(dcmdata_partialFrameAccess);
 OFTEST_REGISTER(dcmdata_i2d_bmp);
 OFTEST_REGISTER(dcmdata_checkStringValue);
 OFTEST_REGISTER(dcmdata_determineVM);
@@ -96,9 +97,33 @@ OFTEST_REGISTER(dcmdata_parser_wrongExplicitVRinDataset_preferDataDict);
 OFTEST_REGISTER(dcmdata_parser_undefinedLengthUNSequence);
 OFTEST_REGISTER(dcmdata_readingDataDictionary);
 OFTEST_REGISTER(dcmdata_usingDataDictionary);
+OFTEST_REGISTER(dcmdata_staticDictionaryTables);
+OFTEST_REGISTER(dcmdata_dictionarySnapshots);
+#ifdef WITH_THREADS
+OFTEST_REGISTER(dcmdata_dictionaryConcurrentAccess);
+OFTEST_REGISTER(dcmdata_dictionaryShortLivedReaders);
+#endif
 OFTEST_REGISTER(dcmdata_specificCharacterSet_1);
 OFTEST_REGISTER(dcmdata_specificCharacterSet_2);
 OFTEST_REGISTER(dcmdata_specificCharacterSet_3);
 OFTEST_REGISTER(dcmdata_specificCharacterSet_4);
 OFTEST_REGISTER(dcmdata_attribute_filter);
+OFTEST_REGISTER(dcmdata_memoryMappedFile_littleEndian);
+OFTEST_REGISTER(dcmdata_memoryMappedFile_bigEndian);
+OFTEST_REGISTER(dcmdata_elementList);
+OFTEST_REGISTER(dcmdata_insertAndSearchElements);
+OFTEST_REGISTER(dcmdata_frameProcessor);
+OFTEST_REGISTER(dcmdata_parallelRLECoding_oneFragmentPerFrame);
+OFTEST_REGISTER(dcmdata_parallelRLECoding_offsetTable);
+OFTEST_REGISTER(dcmdata_parallelRLECoding_singleFrame);
+OFTEST_REGISTER(dcmdata_frameByFrameTranscoding);
+OFTEST_REGISTER(dcmdata_elementScanner_littleEndianImplicit);
+OFTEST_REGISTER(dcmdata_elementScanner_littleEndianExplicit);
+OFTEST_REGISTER(dcmdata_elementScanner_bigEndianExplicit);
+OFTEST_REGISTER(dcmdata_elementScanner_unsupported);
+OFTEST_REGISTER(dcmdata_sharedFile_cache);
+OFTEST_REGISTER(dcmdata_sharedFile_threads);
+OFTEST_REGISTER(dcmdata_RLEEncoder_literal);
+OFTEST_REGISTER(dcmdata_RLEEncoder_replicate);
+OFTEST_REGISTER(dcmdata_RLEEncoder_mixed);
 OFTEST_MAIN("dcmdata")
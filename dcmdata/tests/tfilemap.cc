@@ -0,0 +1,135 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test program for reading from memory mapped files
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dcistrmf.h"   /* for dcmUseMemoryMappedFileInput */
+
+#define TEST_FILENAME "test_map.dcm"
+#define NUM_WORDS 16384
+
+/* memory mapped files are silently disabled on platforms not supporting them */
+#define CHECK_MAPPED(elem) OFCHECK_EQUAL((elem)->valueMapped(), DcmFileMapping::supported())
+
+
+static void createTestFile(const E_TransferSyntax xfer)
+{
+    DcmFileFormat dfile;
+    DcmDataset *dset = dfile.getDataset();
+    Uint16 *words = new Uint16[NUM_WORDS];
+    for (Uint32 i = 0; i < NUM_WORDS; ++i)
+        words[i] = OFstatic_cast(Uint16, i);
+    OFCHECK(dset->putAndInsertString(DCM_SOPInstanceUID, "1.2.3.4").good());
+    OFCHECK(dset->putAndInsertUint16Array(DCM_PixelData, words, NUM_WORDS).good());
+    OFCHECK(dset->putAndInsertUint16(DCM_Columns, 128).good());
+    OFCHECK(dfile.saveFile(TEST_FILENAME, xfer).good());
+    delete[] words;
+}
+
+static void checkMappedFile(const E_TransferSyntax xfer)
+{
+    createTestFile(xfer);
+    dcmUseMemoryMappedFileInput.set(OFTrue);
+
+    DcmFileFormat dfile;
+    OFCHECK(dfile.loadFile(TEST_FILENAME, EXS_Unknown, EGL_noChange, DCM_MaxReadLength * 16).good());
+    DcmDataset *dset = dfile.getDataset();
+
+    DcmElement *elem = NULL;
+    OFCHECK(dset->findAndGetElement(DCM_PixelData, elem).good());
+    if (elem)
+    {
+        // large binary values refer to the mapped file, short ones are copied
+        CHECK_MAPPED(elem);
+
+        // a copy of the element owns its value
+        DcmElement *copy = OFstatic_cast(DcmElement *, elem->clone());
+        OFCHECK(!copy->valueMapped());
+        delete copy;
+
+        Uint16 *words = NULL;
+        OFCHECK(elem->getUint16Array(words).good());
+        if (words)
+        {
+            OFCHECK_EQUAL(words[1], 1);
+            OFCHECK_EQUAL(words[NUM_WORDS - 1], NUM_WORDS - 1);
+            // modifications must not affect the file
+            words[1] = 0xffff;
+        }
+    }
+    OFCHECK(dset->findAndGetElement(DCM_Columns, elem).good());
+    if (elem)
+        OFCHECK(!elem->valueMapped());
+
+    DcmFileFormat dfile2;
+    OFCHECK(dfile2.loadFile(TEST_FILENAME).good());
+    Uint16 word = 0;
+    OFCHECK(dfile2.getDataset()->findAndGetUint16(DCM_PixelData, word, 1).good());
+    OFCHECK_EQUAL(word, 1);
+
+    // values that are not loaded yet are mapped on demand
+    DcmFileFormat dfile3;
+    OFCHECK(dfile3.loadFile(TEST_FILENAME, EXS_Unknown, EGL_noChange, 1024).good());
+    OFCHECK(dfile3.getDataset()->findAndGetElement(DCM_PixelData, elem).good());
+    if (elem)
+    {
+        OFCHECK(!elem->valueLoaded());
+        OFCHECK(elem->loadAllDataIntoMemory().good());
+        CHECK_MAPPED(elem);
+        OFCHECK(dfile3.getDataset()->findAndGetUint16(DCM_PixelData, word, NUM_WORDS - 1).good());
+        OFCHECK_EQUAL(word, NUM_WORDS - 1);
+
+        // a mapped value is copied into main memory when it is detached
+        OFCHECK(elem->detachValueField(OFTrue).good());
+        OFCHECK(!elem->valueMapped());
+        Uint16 *words = NULL;
+        OFCHECK(elem->getUint16Array(words).good());
+        OFCHECK(elem->detachValueField().good());
+        OFCHECK_EQUAL(elem->getLength(), 0);
+        if (words)
+            OFCHECK_EQUAL(words[NUM_WORDS - 1], NUM_WORDS - 1);
+        delete[] words;
+    }
+
+    // deferred values are loaded from the mapping created when the file was read,
+    // i.e. they can still be loaded after the file has been deleted
+    DcmFileFormat dfile4;
+    OFCHECK(dfile4.loadFile(TEST_FILENAME, EXS_Unknown, EGL_noChange, 1024).good());
+    if (DcmFileMapping::supported())
+        OFStandard::deleteFile(TEST_FILENAME);
+    OFCHECK(dfile4.getDataset()->findAndGetElement(DCM_PixelData, elem).good());
+    if (elem)
+    {
+        OFCHECK(elem->loadAllDataIntoMemory().good());
+        CHECK_MAPPED(elem);
+        OFCHECK(dfile4.getDataset()->findAndGetUint16(DCM_PixelData, word, NUM_WORDS - 1).good());
+        OFCHECK_EQUAL(word, NUM_WORDS - 1);
+    }
+
+    dcmUseMemoryMappedFileInput.set(OFFalse);
+    OFStandard::deleteFile(TEST_FILENAME);
+}
+
+OFTEST(dcmdata_memoryMappedFile_littleEndian)
+{
+    checkMappedFile(EXS_LittleEndianExplicit);
+}
+
+OFTEST(dcmdata_memoryMappedFile_bigEndian)
+{
+    checkMappedFile(EXS_BigEndianExplicit);
+}
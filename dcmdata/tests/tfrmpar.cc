@@ -0,0 +1,437 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test program for parallel processing of multi-frame images
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dccodec.h"
+#include "dcmtk/dcmdata/dcfrmpar.h"
+#include "dcmtk/dcmdata/dcpixseq.h"
+#include "dcmtk/dcmdata/dcpxitem.h"
+#include "dcmtk/dcmdata/dcrleerg.h"
+#include "dcmtk/dcmdata/dcrledrg.h"
+
+#define NUM_FRAMES 16
+#define NUM_ROWS 64
+#define NUM_COLUMNS 64
+#define FRAME_WORDS (NUM_ROWS * NUM_COLUMNS)
+
+
+/* frame processor counting the calls for each frame, fails from a given frame on */
+class FrameCounter : public DcmFrameProcessor
+{
+public:
+    FrameCounter(Uint32 failingFrame)
+    : failingFrame_(failingFrame)
+    {
+        for (Uint32 i = 0; i < NUM_FRAMES; ++i)
+            calls_[i] = 0;
+    }
+
+    Uint32 calls(Uint32 frameNo) const
+    {
+        return calls_[frameNo];
+    }
+
+protected:
+    virtual OFCondition processFrame(Uint32 frameNo)
+    {
+        ++calls_[frameNo];
+        return (frameNo >= failingFrame_) ? EC_CorruptedData : EC_Normal;
+    }
+
+private:
+    Uint32 failingFrame_;
+    Uint32 calls_[NUM_FRAMES];
+};
+
+
+OFTEST(dcmdata_frameProcessor)
+{
+    // every frame is processed exactly once
+    FrameCounter counter(NUM_FRAMES);
+    OFCHECK(counter.run(2, NUM_FRAMES - 2, 4).good());
+    OFCHECK_EQUAL(counter.calls(0), 0);
+    OFCHECK_EQUAL(counter.calls(1), 0);
+    for (Uint32 i = 2; i < NUM_FRAMES; ++i)
+        OFCHECK_EQUAL(counter.calls(i), 1);
+
+    // frames before the first failing one are all processed
+    FrameCounter failing(5);
+    OFCHECK(failing.run(0, NUM_FRAMES, 4) == EC_CorruptedData);
+    for (Uint32 j = 0; j < NUM_FRAMES; ++j)
+    {
+        if (j <= 5)
+            OFCHECK_EQUAL(failing.calls(j), 1);
+        else
+            OFCHECK(failing.calls(j) <= 1);
+    }
+}
+
+
+/* get the compressed pixel sequence of the given dataset */
+static DcmPixelSequence *getRLEPixelSequence(DcmDataset& dset)
+{
+    DcmElement *elem = NULL;
+    DcmPixelSequence *pixSeq = NULL;
+    if (dset.findAndGetElement(DCM_PixelData, elem).good())
+        OFstatic_cast(DcmPixelData *, elem)->getEncapsulatedRepresentation(EXS_RLELossless, NULL, pixSeq);
+    return pixSeq;
+}
+
+static void checkRLEMultiFrame(Uint32 fragmentSize)
+{
+    DcmRLEEncoderRegistration::registerCodecs(OFFalse, fragmentSize);
+    DcmRLEDecoderRegistration::registerCodecs();
+
+    // create noisy image data that does not compress too well
+    Uint16 *words = new Uint16[NUM_FRAMES * FRAME_WORDS];
+    Uint32 seed = 1;
+    for (Uint32 i = 0; i < NUM_FRAMES * FRAME_WORDS; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        words[i] = OFstatic_cast(Uint16, (seed >> 16) & 0x0fff);
+    }
+
+    DcmDataset dset;
+    OFCHECK(dset.putAndInsertString(DCM_SOPClassUID, UID_MultiframeGrayscaleWordSecondaryCaptureImageStorage).good());
+    OFCHECK(dset.putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2").good());
+    OFCHECK(dset.putAndInsertUint16(DCM_SamplesPerPixel, 1).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Rows, NUM_ROWS).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Columns, NUM_COLUMNS).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_BitsAllocated, 16).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_BitsStored, 12).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_HighBit, 11).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_PixelRepresentation, 0).good());
+    OFCHECK(dset.putAndInsertString(DCM_NumberOfFrames, "16").good());
+    OFCHECK(dset.putAndInsertUint16Array(DCM_PixelData, words, NUM_FRAMES * FRAME_WORDS).good());
+
+    DcmDataset parallel(dset);
+
+    // compress and drop the uncompressed representation
+    OFCHECK(dset.chooseRepresentation(EXS_RLELossless, NULL).good());
+    dset.removeAllButCurrentRepresentations();
+
+    // compressing with multiple threads must give the same result
+    dcmCodecMaxThreads.set(4);
+    OFCHECK(parallel.chooseRepresentation(EXS_RLELossless, NULL).good());
+    dcmCodecMaxThreads.set(1);
+    DcmPixelSequence *pixSeq = getRLEPixelSequence(dset);
+    DcmPixelSequence *parallelPixSeq = getRLEPixelSequence(parallel);
+    OFCHECK(pixSeq != NULL);
+    OFCHECK(parallelPixSeq != NULL);
+    if (pixSeq && parallelPixSeq)
+    {
+        OFCHECK_EQUAL(pixSeq->card(), parallelPixSeq->card());
+        DcmPixelItem *item = NULL;
+        DcmPixelItem *parallelItem = NULL;
+        Uint8 *data = NULL;
+        Uint8 *parallelData = NULL;
+        for (unsigned long i = 0; (i < pixSeq->card()) && (i < parallelPixSeq->card()); ++i)
+        {
+            OFCHECK(pixSeq->getItem(item, i).good());
+            OFCHECK(parallelPixSeq->getItem(parallelItem, i).good());
+            OFCHECK_EQUAL(item->getLength(), parallelItem->getLength());
+            if (item->getLength() == parallelItem->getLength() && item->getLength() > 0)
+            {
+                OFCHECK(item->getUint8Array(data).good());
+                OFCHECK(parallelItem->getUint8Array(parallelData).good());
+                OFCHECK(memcmp(data, parallelData, item->getLength()) == 0);
+            }
+        }
+    }
+
+    // decompress with multiple threads
+    dcmCodecMaxThreads.set(4);
+    OFCHECK(dset.chooseRepresentation(EXS_LittleEndianExplicit, NULL).good());
+    dcmCodecMaxThreads.set(1);
+
+    const Uint16 *result = NULL;
+    OFCHECK(dset.findAndGetUint16Array(DCM_PixelData, result).good());
+    if (result)
+        OFCHECK(memcmp(result, words, NUM_FRAMES * FRAME_WORDS * sizeof(Uint16)) == 0);
+
+    delete[] words;
+    DcmRLEEncoderRegistration::cleanup();
+    DcmRLEDecoderRegistration::cleanup();
+}
+
+OFTEST(dcmdata_parallelRLECoding_oneFragmentPerFrame)
+{
+    checkRLEMultiFrame(0);
+}
+
+OFTEST(dcmdata_parallelRLECoding_offsetTable)
+{
+    checkRLEMultiFrame(1);
+}
+
+OFTEST(dcmdata_parallelRLECoding_singleFrame)
+{
+    DcmRLEEncoderRegistration::registerCodecs();
+    DcmRLEDecoderRegistration::registerCodecs();
+
+    // create a color image with a dark background and some noise
+    const Uint32 frameBytes = 3 * FRAME_WORDS;
+    Uint8 *bytes = new Uint8[frameBytes];
+    Uint32 seed = 1;
+    for (Uint32 i = 0; i < frameBytes; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        bytes[i] = (i % (3 * NUM_COLUMNS) < NUM_COLUMNS) ? 0 : OFstatic_cast(Uint8, seed >> 24);
+    }
+
+    DcmDataset dset;
+    OFCHECK(dset.putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage).good());
+    OFCHECK(dset.putAndInsertString(DCM_PhotometricInterpretation, "RGB").good());
+    OFCHECK(dset.putAndInsertUint16(DCM_SamplesPerPixel, 3).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_PlanarConfiguration, 0).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Rows, NUM_ROWS).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Columns, NUM_COLUMNS).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_BitsAllocated, 8).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_BitsStored, 8).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_HighBit, 7).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_PixelRepresentation, 0).good());
+    OFCHECK(dset.putAndInsertUint8Array(DCM_PixelData, bytes, frameBytes).good());
+
+    DcmDataset parallel(dset);
+
+    // compress the stripes one after another and in parallel
+    OFCHECK(dset.chooseRepresentation(EXS_RLELossless, NULL).good());
+    dset.removeAllButCurrentRepresentations();
+    dcmCodecMaxThreads.set(4);
+    OFCHECK(parallel.chooseRepresentation(EXS_RLELossless, NULL).good());
+    dcmCodecMaxThreads.set(1);
+    DcmPixelSequence *pixSeq = getRLEPixelSequence(dset);
+    DcmPixelSequence *parallelPixSeq = getRLEPixelSequence(parallel);
+    OFCHECK(pixSeq != NULL);
+    OFCHECK(parallelPixSeq != NULL);
+    if (pixSeq && parallelPixSeq)
+    {
+        DcmPixelItem *item = NULL;
+        DcmPixelItem *parallelItem = NULL;
+        Uint8 *data = NULL;
+        Uint8 *parallelData = NULL;
+        OFCHECK(pixSeq->getItem(item, 1).good());
+        OFCHECK(parallelPixSeq->getItem(parallelItem, 1).good());
+        if (item && parallelItem)
+        {
+            OFCHECK_EQUAL(item->getLength(), parallelItem->getLength());
+            OFCHECK(item->getUint8Array(data).good());
+            OFCHECK(parallelItem->getUint8Array(parallelData).good());
+            if (data && parallelData && (item->getLength() == parallelItem->getLength()))
+                OFCHECK(memcmp(data, parallelData, item->getLength()) == 0);
+        }
+    }
+
+    // decompress the stripes in parallel
+    dcmCodecMaxThreads.set(4);
+    OFCHECK(dset.chooseRepresentation(EXS_LittleEndianExplicit, NULL).good());
+    dcmCodecMaxThreads.set(1);
+
+    const Uint8 *result = NULL;
+    OFCHECK(dset.findAndGetUint8Array(DCM_PixelData, result).good());
+    if (result)
+        OFCHECK(memcmp(result, bytes, frameBytes) == 0);
+
+    delete[] bytes;
+    DcmRLEEncoderRegistration::cleanup();
+    DcmRLEDecoderRegistration::cleanup();
+}
+
+
+/* codec parameter for the uncompressed frame codec below */
+class RawFrameCodecParameter : public DcmCodecParameter
+{
+public:
+    virtual DcmCodecParameter *clone() const
+    {
+        return new RawFrameCodecParameter();
+    }
+
+    virtual const char *className() const
+    {
+        return "RawFrameCodecParameter";
+    }
+};
+
+/* decoder for an encapsulated transfer syntax that stores each frame uncompressed
+ * in a fragment of its own. Complete decompression with decode() is not supported.
+ */
+class RawFrameCodec : public DcmCodec
+{
+public:
+    RawFrameCodec()
+    : decodeCalls_(0)
+    {
+    }
+
+    Uint32 decodeCalls() const
+    {
+        return decodeCalls_;
+    }
+
+    virtual OFCondition decode(const DcmRepresentationParameter *, DcmPixelSequence *, DcmPolymorphOBOW&,
+                               const DcmCodecParameter *, const DcmStack&) const
+    {
+        ++decodeCalls_;
+        return EC_IllegalCall;
+    }
+
+    virtual OFCondition decodeFrame(const DcmRepresentationParameter *, DcmPixelSequence *fromPixSeq,
+                                    const DcmCodecParameter *, DcmItem *dataset, Uint32 frameNo,
+                                    Uint32& startFragment, void *buffer, Uint32 bufSize,
+                                    OFString& decompressedColorModel) const
+    {
+        // the first item is the offset table
+        DcmPixelItem *item = NULL;
+        Uint8 *data = NULL;
+        if (fromPixSeq->getItem(item, frameNo + 1).bad() || item->getUint8Array(data).bad() || (item->getLength() > bufSize))
+            return EC_CorruptedData;
+        memcpy(buffer, data, item->getLength());
+        startFragment = frameNo + 2;
+        return dataset->findAndGetOFString(DCM_PhotometricInterpretation, decompressedColorModel);
+    }
+
+    virtual OFCondition encode(const Uint16 *, const Uint32, const DcmRepresentationParameter *,
+                               DcmPixelSequence *&, const DcmCodecParameter *, DcmStack&) const
+    {
+        return EC_IllegalCall;
+    }
+
+    virtual OFCondition encode(const E_TransferSyntax, const DcmRepresentationParameter *, DcmPixelSequence *,
+                               const DcmRepresentationParameter *, DcmPixelSequence *&,
+                               const DcmCodecParameter *, DcmStack&) const
+    {
+        return EC_IllegalCall;
+    }
+
+    virtual OFBool canChangeCoding(const E_TransferSyntax oldRepType, const E_TransferSyntax newRepType) const
+    {
+        return (oldRepType == EXS_JPEGProcess14SV1) && (newRepType == EXS_LittleEndianExplicit);
+    }
+
+    virtual OFCondition determineDecompressedColorModel(const DcmRepresentationParameter *, DcmPixelSequence *,
+                                                        const DcmCodecParameter *, DcmItem *dataset,
+                                                        OFString& decompressedColorModel) const
+    {
+        return dataset->findAndGetOFString(DCM_PhotometricInterpretation, decompressedColorModel);
+    }
+
+private:
+    mutable Uint32 decodeCalls_;
+};
+
+
+OFTEST(dcmdata_frameByFrameTranscoding)
+{
+    RawFrameCodec codec;
+    RawFrameCodecParameter codecParameter;
+    OFCHECK(DcmCodecList::registerCodec(&codec, NULL, &codecParameter).good());
+    DcmRLEEncoderRegistration::registerCodecs();
+    DcmRLEDecoderRegistration::registerCodecs();
+
+    // create 8 bit image data with an odd frame size
+    const Uint32 frameBytes = (NUM_ROWS - 1) * (NUM_COLUMNS - 1);
+    Uint8 *bytes = new Uint8[NUM_FRAMES * frameBytes];
+    Uint32 seed = 1;
+    for (Uint32 i = 0; i < NUM_FRAMES * frameBytes; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        bytes[i] = OFstatic_cast(Uint8, (seed >> 16) & 0x0f);
+    }
+
+    DcmDataset dset;
+    OFCHECK(dset.putAndInsertString(DCM_SOPClassUID, UID_MultiframeGrayscaleByteSecondaryCaptureImageStorage).good());
+    OFCHECK(dset.putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2").good());
+    OFCHECK(dset.putAndInsertUint16(DCM_SamplesPerPixel, 1).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Rows, NUM_ROWS - 1).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Columns, NUM_COLUMNS - 1).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_BitsAllocated, 8).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_BitsStored, 8).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_HighBit, 7).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_PixelRepresentation, 0).good());
+    OFCHECK(dset.putAndInsertString(DCM_NumberOfFrames, "16").good());
+    OFCHECK(dset.putAndInsertUint8Array(DCM_PixelData, bytes, NUM_FRAMES * frameBytes).good());
+
+    // reference: compress the uncompressed image data
+    DcmDataset reference(dset);
+    OFCHECK(reference.chooseRepresentation(EXS_RLELossless, NULL).good());
+
+    // replace the pixel data by an encapsulated representation with one fragment per frame
+    DcmPixelSequence *fromPixSeq = new DcmPixelSequence(DCM_PixelSequenceTag);
+    fromPixSeq->insert(new DcmPixelItem(DCM_PixelItemTag));
+    for (Uint32 j = 0; j < NUM_FRAMES; ++j)
+    {
+        DcmPixelItem *fragment = new DcmPixelItem(DCM_PixelItemTag);
+        OFCHECK(fragment->putUint8Array(bytes + j * frameBytes, frameBytes).good());
+        fromPixSeq->insert(fragment);
+    }
+    DcmElement *elem = NULL;
+    OFCHECK(dset.findAndGetElement(DCM_PixelData, elem).good());
+    if (elem)
+        OFstatic_cast(DcmPixelData *, elem)->putOriginalRepresentation(EXS_JPEGProcess14SV1, NULL, fromPixSeq);
+    DcmDataset parallel(dset);
+
+    // transcode frame by frame, with and without multiple threads
+    OFCHECK(dset.chooseRepresentation(EXS_RLELossless, NULL).good());
+    dcmCodecMaxThreads.set(4);
+    OFCHECK(parallel.chooseRepresentation(EXS_RLELossless, NULL).good());
+    dcmCodecMaxThreads.set(1);
+    OFCHECK_EQUAL(codec.decodeCalls(), 0);
+
+    // the result must be the same as for the uncompressed image data
+    DcmPixelSequence *referencePixSeq = getRLEPixelSequence(reference);
+    DcmPixelSequence *pixSeqs[2] = { getRLEPixelSequence(dset), getRLEPixelSequence(parallel) };
+    OFCHECK(referencePixSeq != NULL);
+    for (int k = 0; k < 2; ++k)
+    {
+        OFCHECK(pixSeqs[k] != NULL);
+        if (referencePixSeq && pixSeqs[k])
+        {
+            OFCHECK_EQUAL(pixSeqs[k]->card(), referencePixSeq->card());
+            DcmPixelItem *item = NULL;
+            DcmPixelItem *referenceItem = NULL;
+            Uint8 *data = NULL;
+            Uint8 *referenceData = NULL;
+            for (unsigned long i = 1; (i < pixSeqs[k]->card()) && (i < referencePixSeq->card()); ++i)
+            {
+                OFCHECK(pixSeqs[k]->getItem(item, i).good());
+                OFCHECK(referencePixSeq->getItem(referenceItem, i).good());
+                OFCHECK_EQUAL(item->getLength(), referenceItem->getLength());
+                if (item->getLength() == referenceItem->getLength() && item->getLength() > 0)
+                {
+                    OFCHECK(item->getUint8Array(data).good());
+                    OFCHECK(referenceItem->getUint8Array(referenceData).good());
+                    OFCHECK(memcmp(data, referenceData, item->getLength()) == 0);
+                }
+            }
+        }
+    }
+
+    // and decompress to the original image data
+    dset.removeAllButCurrentRepresentations();
+    OFCHECK(dset.chooseRepresentation(EXS_LittleEndianExplicit, NULL).good());
+    const Uint8 *result = NULL;
+    OFCHECK(dset.findAndGetUint8Array(DCM_PixelData, result).good());
+    if (result)
+        OFCHECK(memcmp(result, bytes, NUM_FRAMES * frameBytes) == 0);
+
+    delete[] bytes;
+    DcmRLEEncoderRegistration::cleanup();
+    DcmRLEDecoderRegistration::cleanup();
+    OFCHECK(DcmCodecList::deregisterCodec(&codec).good());
+}
@@ -0,0 +1,116 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test program for element list handling in class DcmItem
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dctk.h"
+
+#define NUM_ELEMENTS 1000
+
+
+OFTEST(dcmdata_elementList)
+{
+    DcmList list;
+    DcmObject *obj1 = new DcmUnsignedShort(DcmTag(0x0009, 0x0001));
+    DcmObject *obj2 = new DcmUnsignedShort(DcmTag(0x0009, 0x0002));
+    DcmObject *obj3 = new DcmUnsignedShort(DcmTag(0x0009, 0x0003));
+
+    OFCHECK(list.empty());
+    OFCHECK(!list.valid());
+    OFCHECK(list.seek(ELP_first) == NULL);
+
+    list.append(obj3);
+    list.prepend(obj1);
+    OFCHECK(list.get() == obj1);
+    list.insert(obj2, ELP_next);
+    OFCHECK_EQUAL(list.card(), 3);
+    OFCHECK(list.seek_to(0) == obj1);
+    OFCHECK(list.seek_to(1) == obj2);
+    OFCHECK(list.seek_to(2) == obj3);
+    OFCHECK(list.seek_to(3) == NULL);
+    OFCHECK(!list.valid());
+
+    // iterating beyond both ends invalidates the current position
+    OFCHECK(list.seek(ELP_last) == obj3);
+    OFCHECK(list.seek(ELP_next) == NULL);
+    OFCHECK(list.seek(ELP_prev) == NULL);
+    OFCHECK(list.seek(ELP_first) == obj1);
+    OFCHECK(list.seek(ELP_prev) == NULL);
+
+    // removing makes the successor the current element
+    list.seek_to(1);
+    OFCHECK(list.remove() == obj2);
+    OFCHECK(list.get() == obj3);
+    OFCHECK(list.remove() == obj3);
+    OFCHECK(!list.valid());
+    OFCHECK(list.remove() == NULL);
+    OFCHECK_EQUAL(list.card(), 1);
+
+    // inserting without a current element appends
+    list.insert(obj3, ELP_prev);
+    OFCHECK(list.seek(ELP_last) == obj3);
+    list.insert(obj2, ELP_prev);
+    OFCHECK(list.seek_to(1) == obj2);
+
+    list.deleteAllElements();
+    OFCHECK(list.empty());
+    OFCHECK_EQUAL(list.card(), 0);
+}
+
+
+OFTEST(dcmdata_insertAndSearchElements)
+{
+    DcmItem item;
+    Uint16 elementNum;
+    // insert elements in reverse and then in random order
+    for (elementNum = NUM_ELEMENTS; elementNum > 0; elementNum -= 2)
+        OFCHECK(item.putAndInsertUint16(DcmTag(0x0009, elementNum, EVR_US), elementNum).good());
+    for (elementNum = 1; elementNum < NUM_ELEMENTS; elementNum += 2)
+    {
+        // permutation of all odd element numbers
+        const Uint16 num = OFstatic_cast(Uint16, (elementNum * 7) % NUM_ELEMENTS);
+        OFCHECK(item.putAndInsertUint16(DcmTag(0x0009, num, EVR_US), num).good());
+    }
+    OFCHECK_EQUAL(item.card(), NUM_ELEMENTS);
+
+    // the element list must be sorted
+    for (unsigned long i = 1; i < item.card(); ++i)
+        OFCHECK(item.getElement(i - 1)->getTag() < item.getElement(i)->getTag());
+
+    // search for existing and non-existing elements
+    Uint16 value = 0;
+    OFCHECK(item.findAndGetUint16(DcmTagKey(0x0009, 1), value).good());
+    OFCHECK_EQUAL(value, 1);
+    OFCHECK(item.findAndGetUint16(DcmTagKey(0x0009, NUM_ELEMENTS), value).good());
+    OFCHECK_EQUAL(value, NUM_ELEMENTS);
+    OFCHECK(item.findAndGetUint16(DcmTagKey(0x0009, 501), value).good());
+    OFCHECK_EQUAL(value, 501);
+    OFCHECK(!item.tagExists(DcmTagKey(0x0009, 0)));
+    OFCHECK(!item.tagExists(DcmTagKey(0x0009, NUM_ELEMENTS + 1)));
+    OFCHECK(!item.tagExists(DcmTagKey(0x0008, 1)));
+
+    // replace and remove elements
+    OFCHECK(item.putAndInsertUint16(DcmTag(0x0009, 500, EVR_US), 1234).good());
+    OFCHECK(item.findAndGetUint16(DcmTagKey(0x0009, 500), value).good());
+    OFCHECK_EQUAL(value, 1234);
+    DcmElement *elem = new DcmUnsignedShort(DcmTag(0x0009, 500, EVR_US));
+    OFCHECK(item.insert(elem, OFFalse) == EC_DoubledTag);
+    delete elem;
+    OFCHECK(item.findAndDeleteElement(DcmTagKey(0x0009, 500)).good());
+    OFCHECK(!item.tagExists(DcmTagKey(0x0009, 500)));
+    OFCHECK(item.findAndDeleteElement(DcmTagKey(0x0009, 500)).bad());
+    OFCHECK_EQUAL(item.card(), NUM_ELEMENTS - 1);
+}
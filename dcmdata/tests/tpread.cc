@@ -420,3 +420,58 @@ OFTEST(dcmdata_partialElementAccess)
 #endif
     delete[] buffer;
 }
+
+OFTEST(dcmdata_partialFrameAccess)
+{
+    // create a multi-frame image with 5 frames of 4x4 pixels (16 bit)
+    const Uint32 frameWords = 16;
+    const Uint32 numFrames = 5;
+    Uint16 pixels[frameWords * numFrames];
+    for (Uint32 i = 0; i < frameWords * numFrames; ++i)
+      pixels[i] = OFstatic_cast(Uint16, 0x1000 * (i / frameWords) + i);
+
+    DcmFileFormat dfile;
+    DcmDataset *dset = dfile.getDataset();
+    OFCHECK(dset->putAndInsertUint16(DCM_Rows, 4).good());
+    OFCHECK(dset->putAndInsertUint16(DCM_Columns, 4).good());
+    OFCHECK(dset->putAndInsertUint16(DCM_SamplesPerPixel, 1).good());
+    OFCHECK(dset->putAndInsertUint16(DCM_BitsAllocated, 16).good());
+    OFCHECK(dset->putAndInsertString(DCM_NumberOfFrames, "5").good());
+    OFCHECK(dset->putAndInsertUint16Array(DCM_PixelData, pixels, frameWords * numFrames).good());
+    OFCHECK(dfile.saveFile("test_frames.dcm", EXS_BigEndianExplicit).good());
+
+    // the pixel data is not loaded into memory when the file is read
+    DcmFileFormat dfile2;
+    OFCHECK(dfile2.loadFile("test_frames.dcm", EXS_Unknown, EGL_noChange, 64).good());
+    dset = dfile2.getDataset();
+    DcmElement *delem = NULL;
+    OFCHECK(dset->findAndGetElement(DCM_PixelData, delem).good());
+    DcmPixelData *pixelData = OFstatic_cast(DcmPixelData *, delem);
+    OFCHECK(!pixelData->valueLoaded());
+
+    // read frames 2 and 3 directly from file
+    DcmFileCache cache;
+    Uint16 target[frameWords * numFrames];
+    Uint32 length = 0;
+    OFCHECK(pixelData->getUncompressedFrames(dset, 2, 2, target, sizeof(target), length, &cache).good());
+    OFCHECK_EQUAL(length, 2 * frameWords * sizeof(Uint16));
+    OFCHECK(memcmp(target, pixels + 2 * frameWords, length) == 0);
+    OFCHECK(!pixelData->valueLoaded());
+
+    // a frame range exceeding the pixel data is truncated
+    OFCHECK(pixelData->getUncompressedFrames(dset, 3, 10, target, sizeof(target), length, &cache).good());
+    OFCHECK_EQUAL(length, 2 * frameWords * sizeof(Uint16));
+    OFCHECK(memcmp(target, pixels + 3 * frameWords, length) == 0);
+
+    // the first frame must exist and the buffer must be large enough
+    OFCHECK(pixelData->getUncompressedFrames(dset, 5, 1, target, sizeof(target), length, &cache) == EC_InvalidOffset);
+    OFCHECK(pixelData->getUncompressedFrames(dset, 0, 2, target, frameWords * sizeof(Uint16), length, &cache) == EC_IllegalCall);
+
+    // the result is the same once the pixel data has been loaded
+    OFCHECK(pixelData->loadAllDataIntoMemory().good());
+    OFCHECK(pixelData->getUncompressedFrames(dset, 4, 1, target, sizeof(target), length).good());
+    OFCHECK_EQUAL(length, frameWords * sizeof(Uint16));
+    OFCHECK(memcmp(target, pixels + 4 * frameWords, length) == 0);
+
+    unlink("test_frames.dcm");
+}
@@ -0,0 +1,128 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test program for the RLE compressor and decompressor
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dcrleenc.h"
+#include "dcmtk/dcmdata/dcrledec.h"
+
+#define BUFFER_SIZE 100000
+
+
+/* simple pseudo random number generator, for reproducible results */
+static Uint32 nextRandom(Uint32& seed)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+}
+
+/* create test data consisting of literal stretches and runs of various lengths */
+static void createData(unsigned char *data, size_t size, Uint32 maxRun, Uint32 seed)
+{
+    size_t i = 0;
+    while (i < size)
+    {
+        const unsigned char value = OFstatic_cast(unsigned char, nextRandom(seed) & 0x03);
+        Uint32 run = nextRandom(seed) % maxRun + 1;
+        while ((run-- > 0) && (i < size))
+            data[i++] = value;
+    }
+}
+
+/* compress the given data in blocks of random size with the bulk and the bytewise
+ * interface, flushing from time to time, and check that the results are identical
+ */
+static void checkEncoder(const unsigned char *data, size_t size, Uint32 seed)
+{
+    DcmRLEEncoder bulkEncoder(1);
+    DcmRLEEncoder byteEncoder(1);
+    size_t i = 0;
+    while (i < size)
+    {
+        size_t count = nextRandom(seed) % 1000;
+        if (count > size - i)
+            count = size - i;
+        bulkEncoder.add(data + i, count);
+        for (size_t j = 0; j < count; ++j)
+            byteEncoder.add(data[i + j]);
+        i += count;
+        if (nextRandom(seed) % 4 == 0)
+        {
+            bulkEncoder.flush();
+            byteEncoder.flush();
+        }
+    }
+    bulkEncoder.flush();
+    byteEncoder.flush();
+    OFCHECK(!bulkEncoder.fail());
+    OFCHECK_EQUAL(bulkEncoder.size(), byteEncoder.size());
+    if (bulkEncoder.size() == byteEncoder.size())
+    {
+        unsigned char *bulkData = new unsigned char[bulkEncoder.size()];
+        unsigned char *byteData = new unsigned char[byteEncoder.size()];
+        bulkEncoder.write(bulkData);
+        byteEncoder.write(byteData);
+        OFCHECK(memcmp(bulkData, byteData, bulkEncoder.size()) == 0);
+
+        // decompress in blocks of random size, i.e. with suspension
+        DcmRLEDecoder decoder(size);
+        i = 0;
+        while (i < bulkEncoder.size())
+        {
+            size_t count = nextRandom(seed) % 300 + 1;
+            if (count > bulkEncoder.size() - i)
+                count = bulkEncoder.size() - i;
+            OFCondition result = decoder.decompress(bulkData + i, count);
+            OFCHECK(result.good() || (result == EC_StreamNotifyClient));
+            i += count;
+        }
+        OFCHECK_EQUAL(decoder.size(), size);
+        if (decoder.size() == size)
+            OFCHECK(memcmp(decoder.getOutputBuffer(), data, size) == 0);
+        delete[] bulkData;
+        delete[] byteData;
+    }
+}
+
+
+OFTEST(dcmdata_RLEEncoder_literal)
+{
+    // mostly literal runs, which are sometimes interrupted by short repeat runs
+    unsigned char *data = new unsigned char[BUFFER_SIZE];
+    createData(data, BUFFER_SIZE, 4, 1);
+    checkEncoder(data, BUFFER_SIZE, 2);
+    delete[] data;
+}
+
+OFTEST(dcmdata_RLEEncoder_replicate)
+{
+    // repeat runs of up to 300 bytes, i.e. exceeding the maximum length of 128
+    unsigned char *data = new unsigned char[BUFFER_SIZE];
+    createData(data, BUFFER_SIZE, 300, 3);
+    checkEncoder(data, BUFFER_SIZE, 4);
+    delete[] data;
+}
+
+OFTEST(dcmdata_RLEEncoder_mixed)
+{
+    // all kinds of runs, including very short input
+    unsigned char *data = new unsigned char[BUFFER_SIZE];
+    createData(data, BUFFER_SIZE, 40, 5);
+    checkEncoder(data, BUFFER_SIZE, 6);
+    for (size_t size = 1; size < 300; size += 7)
+        checkEncoder(data + size, size, OFstatic_cast(Uint32, size));
+    delete[] data;
+}
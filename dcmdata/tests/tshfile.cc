@@ -0,0 +1,160 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test program for loading element values through shared file handles
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/ofstd/ofthread.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dcistrmf.h"   /* for dcmFileHandleCacheSize */
+
+#define TEST_FILENAME1 "test_shfile1.dcm"
+#define TEST_FILENAME2 "test_shfile2.dcm"
+#define NUM_WORDS 16384
+#define NUM_THREADS 4
+
+
+/* create a file with two large values of different content */
+static void createTestFile(const char *filename, Uint16 seed)
+{
+    DcmFileFormat dfile;
+    DcmDataset *dset = dfile.getDataset();
+    Uint16 *words = new Uint16[NUM_WORDS];
+    for (Uint32 i = 0; i < NUM_WORDS; ++i)
+        words[i] = OFstatic_cast(Uint16, i + seed);
+    OFCHECK(dset->putAndInsertString(DCM_SOPInstanceUID, "1.2.3.4").good());
+    OFCHECK(dset->putAndInsertUint16Array(DCM_RedPaletteColorLookupTableData, words, NUM_WORDS).good());
+    OFCHECK(dset->putAndInsertUint16Array(DCM_PixelData, words, NUM_WORDS).good());
+    OFCHECK(dfile.saveFile(filename, EXS_LittleEndianExplicit).good());
+    delete[] words;
+}
+
+/* load the large values of the given file on demand and check their content */
+static void checkValues(const char *filename, Uint16 seed)
+{
+    DcmFileFormat dfile;
+    OFCHECK(dfile.loadFile(filename, EXS_Unknown, EGL_noChange, 1024).good());
+    DcmDataset *dset = dfile.getDataset();
+    const DcmTagKey tags[2] = { DCM_PixelData, DCM_RedPaletteColorLookupTableData };
+    for (size_t t = 0; t < 2; ++t)
+    {
+        DcmElement *elem = NULL;
+        OFCHECK(dset->findAndGetElement(tags[t], elem).good());
+        if (elem)
+        {
+            OFCHECK(!elem->valueLoaded());
+            Uint16 *words = NULL;
+            OFCHECK(elem->getUint16Array(words).good());
+            if (words)
+            {
+                OFCHECK_EQUAL(words[0], seed);
+                OFCHECK_EQUAL(words[NUM_WORDS - 1], OFstatic_cast(Uint16, NUM_WORDS - 1 + seed));
+            }
+        }
+    }
+}
+
+
+#ifdef WITH_THREADS
+
+/* thread loading the values of a file */
+class LoadThread : public OFThread
+{
+public:
+    LoadThread(const char *filename, Uint16 seed) : filename_(filename), seed_(seed) {}
+protected:
+    virtual void run()
+    {
+        for (int i = 0; i < 10; ++i)
+            checkValues(filename_, seed_);
+    }
+private:
+    const char *filename_;
+    Uint16 seed_;
+};
+
+#endif
+
+
+OFTEST(dcmdata_sharedFile_cache)
+{
+    createTestFile(TEST_FILENAME1, 1);
+    createTestFile(TEST_FILENAME2, 2);
+    dcmFileHandleCacheSize.set(1);
+
+    // the least recently used file is closed when the other one is opened
+    checkValues(TEST_FILENAME1, 1);
+    checkValues(TEST_FILENAME2, 2);
+    checkValues(TEST_FILENAME1, 1);
+
+    // the same file handle is returned for the same file
+    DcmSharedFile *file1 = DcmSharedFile::getCachedInstance(TEST_FILENAME1);
+    DcmSharedFile *file2 = DcmSharedFile::getCachedInstance(TEST_FILENAME1);
+    OFCHECK(file1 != NULL);
+    OFCHECK(file1 == file2);
+    if (file1) file1->decreaseRefCount();
+    if (file2) file2->decreaseRefCount();
+
+    // a stream keeps its file open after the file has been removed from the cache
+    DcmInputFileStreamFactory factory(TEST_FILENAME1, 0);
+    DcmInputStream *stream = factory.create();
+    OFCHECK(stream->good());
+    DcmSharedFile::clearCache();
+    Uint8 preamble[4];
+    OFCHECK_EQUAL(stream->skip(128), 128);
+    stream->mark();
+    OFCHECK_EQUAL(stream->read(preamble, 4), 4);
+    OFCHECK(memcmp(preamble, "DICM", 4) == 0);
+    stream->putback();
+    OFCHECK(stream->good());
+    OFCHECK_EQUAL(stream->read(preamble, 4), 4);
+    OFCHECK(memcmp(preamble, "DICM", 4) == 0);
+    delete stream;
+
+    // files that cannot be opened are not cached
+    OFCHECK(DcmSharedFile::getCachedInstance("does_not_exist.dcm") == NULL);
+    dcmFileHandleCacheSize.set(0);
+    OFCHECK(DcmSharedFile::getCachedInstance(TEST_FILENAME1) == NULL);
+    OFStandard::deleteFile(TEST_FILENAME1);
+    OFStandard::deleteFile(TEST_FILENAME2);
+}
+
+OFTEST(dcmdata_sharedFile_threads)
+{
+    createTestFile(TEST_FILENAME1, 1);
+    createTestFile(TEST_FILENAME2, 2);
+    dcmFileHandleCacheSize.set(2);
+#ifdef WITH_THREADS
+    // multiple threads load values through the same file handles
+    LoadThread *threads[NUM_THREADS];
+    for (size_t i = 0; i < NUM_THREADS; ++i)
+    {
+        threads[i] = new LoadThread((i & 1) ? TEST_FILENAME2 : TEST_FILENAME1, (i & 1) ? 2 : 1);
+        OFCHECK(threads[i]->start() == 0);
+    }
+    for (size_t j = 0; j < NUM_THREADS; ++j)
+    {
+        threads[j]->join();
+        delete threads[j];
+    }
+#else
+    checkValues(TEST_FILENAME1, 1);
+    checkValues(TEST_FILENAME2, 2);
+#endif
+    DcmSharedFile::clearCache();
+    dcmFileHandleCacheSize.set(0);
+    OFStandard::deleteFile(TEST_FILENAME1);
+    OFStandard::deleteFile(TEST_FILENAME2);
+}
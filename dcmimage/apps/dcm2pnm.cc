@@ -38,12 +38,15 @@
 #include "dcmtk/dcmimgle/dcmimage.h"     /* for DicomImage */
 #include "dcmtk/dcmimgle/digsdfn.h"      /* for DiGSDFunction */
 #include "dcmtk/dcmimgle/diciefn.h"      /* for DiCIELABFunction */
+#include "dcmtk/dcmimgle/diparal.h"      /* for dcmRenderingMaxThreads */
 
 #include "dcmtk/ofstd/ofconapp.h"        /* for OFConsoleApplication */
 #include "dcmtk/ofstd/ofcmdln.h"         /* for OFCommandLine */
 
 #include "dcmtk/dcmimage/diregist.h"     /* include to support color images */
 #include "dcmtk/ofstd/ofstd.h"           /* for OFStandard */
+#include "dcmtk/ofstd/ofvector.h"        /* for OFVector */
+#include "dcmtk/ofstd/ofthread.h"        /* for OFThread, OFMutex */
 
 #ifdef BUILD_DCM2PNM_AS_DCMJ2PNM
 #include "dcmtk/dcmjpeg/djdecode.h"      /* for dcmjpeg decoders */
@@ -69,7 +72,11 @@
 #include "dcmtk/ofstd/ofstream.h"
 #include "dcmtk/oflog/oflog.h"
 
-#define OFFIS_OUTFILE_DESCRIPTION "output filename to be written (default: stdout)"
+#if defined (HAVE_WINDOWS_H) || defined(HAVE_FNMATCH_H)
+#define PATTERN_MATCHING_AVAILABLE
+#endif
+
+#define OFFIS_OUTFILE_DESCRIPTION "output filename to be written (default: stdout),\nfilename template in batch mode"
 
 #ifdef BUILD_DCM2PNM_AS_DCML2PNM
 # define OFFIS_CONSOLE_APPLICATION "dcml2pnm"
@@ -120,88 +127,131 @@ enum E_FileType
 };
 
 
-// ********************************************
-
-int main(int argc, char *argv[])
-{
-    OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION, consoleDescription, rcsid);
-    OFCommandLine cmd;
-
-    E_FileReadMode      opt_readMode = ERM_autoDetect;    /* default: fileformat or dataset */
-    E_TransferSyntax    opt_transferSyntax = EXS_Unknown; /* default: xfer syntax recognition */
-
-    unsigned long       opt_compatibilityMode = CIF_MayDetachPixelData | CIF_TakeOverExternalDataset;
-    OFBool              opt_ignoreVoiLutDepth = OFFalse;  /* default: do not ignore VOI LUT bit depth */
-    OFCmdUnsignedInt    opt_frame = 1;                    /* default: first frame */
-    OFCmdUnsignedInt    opt_frameCount = 1;               /* default: one frame */
-    OFBool              opt_useFrameNumber = OFFalse;     /* default: use frame counter */
-    OFBool              opt_multiFrame = OFFalse;         /* default: no multiframes */
-    int                 opt_convertToGrayscale = 0;       /* default: color or grayscale */
-    int                 opt_changePolarity = 0;           /* default: normal polarity */
-    int                 opt_useAspectRatio = 1;           /* default: use aspect ratio for scaling */
-    OFCmdUnsignedInt    opt_useInterpolation = 1;         /* default: use interpolation method '1' for scaling */
-    int                 opt_useClip = 0;                  /* default: don't clip */
-    OFCmdSignedInt      opt_left = 0, opt_top = 0;        /* clip region (origin) */
-    OFCmdUnsignedInt    opt_width = 0, opt_height = 0;    /* clip region (extension) */
-    int                 opt_rotateDegree = 0;             /* default: no rotation */
-    int                 opt_flipType = 0;                 /* default: no flipping */
-    int                 opt_scaleType = 0;                /* default: no scaling */
-                        /* 1 = X-factor, 2 = Y-factor, 3=X-size, 4=Y-size */
-    OFCmdFloat          opt_scale_factor = 1.0;
-    OFCmdUnsignedInt    opt_scale_size = 1;
-    int                 opt_windowType = 0;               /* default: no windowing */
-                        /* 1=Wi, 2=Wl, 3=Wm, 4=Wh, 5=Ww, 6=Wn, 7=Wr */
-    OFCmdUnsignedInt    opt_windowParameter = 0;
-    OFCmdUnsignedInt    opt_roiLeft = 0, opt_roiTop = 0, opt_roiWidth = 0, opt_roiHeight = 0;
-    OFCmdFloat          opt_windowCenter = 0.0, opt_windowWidth = 0.0;
-
-    EF_VoiLutFunction   opt_voiFunction = EFV_Default;
-    ES_PresentationLut  opt_presShape = ESP_Default;
-    OFString            opt_displayFile;
-    int                 opt_displayFunction = 0;          /* default: GSDF */
-                        /* 0=GSDF, 1=CIELAB */
-    OFCmdFloat          opt_ambientLight = -1;            /* default: not set */
-    OFCmdFloat          opt_illumination = -1;            /* default: not set */
-    OFCmdFloat          opt_minDensity = -1;              /* default: not set */
-    OFCmdFloat          opt_maxDensity = -1;              /* default: not set */
-    DiDisplayFunction::E_DeviceType deviceType = DiDisplayFunction::EDT_Monitor;
+/* command line options */
+static E_FileReadMode      opt_readMode = ERM_autoDetect;    /* default: fileformat or dataset */
+static E_TransferSyntax    opt_transferSyntax = EXS_Unknown; /* default: xfer syntax recognition */
+
+static unsigned long       opt_compatibilityMode = CIF_MayDetachPixelData | CIF_TakeOverExternalDataset;
+static OFBool              opt_ignoreVoiLutDepth = OFFalse;  /* default: do not ignore VOI LUT bit depth */
+static OFCmdUnsignedInt    opt_frame = 1;                    /* default: first frame */
+static OFCmdUnsignedInt    opt_frameCount = 1;               /* default: one frame */
+static OFBool              opt_useFrameNumber = OFFalse;     /* default: use frame counter */
+static OFBool              opt_multiFrame = OFFalse;         /* default: no multiframes */
+static int                 opt_convertToGrayscale = 0;       /* default: color or grayscale */
+static int                 opt_changePolarity = 0;           /* default: normal polarity */
+static int                 opt_useAspectRatio = 1;           /* default: use aspect ratio for scaling */
+static OFCmdUnsignedInt    opt_useInterpolation = 1;         /* default: use interpolation method '1' for scaling */
+static int                 opt_useClip = 0;                  /* default: don't clip */
+static OFCmdSignedInt      opt_left = 0, opt_top = 0;        /* clip region (origin) */
+static OFCmdUnsignedInt    opt_width = 0, opt_height = 0;    /* clip region (extension) */
+static OFCmdUnsignedInt    opt_threads = 1;                  /* default: render in a single thread */
+static int                 opt_rotateDegree = 0;             /* default: no rotation */
+static int                 opt_flipType = 0;                 /* default: no flipping */
+static int                 opt_scaleType = 0;                /* default: no scaling */
+                           /* 1 = X-factor, 2 = Y-factor, 3=X-size, 4=Y-size */
+static OFCmdFloat          opt_scale_factor = 1.0;
+static OFCmdUnsignedInt    opt_scale_size = 1;
+static int                 opt_windowType = 0;               /* default: no windowing */
+                           /* 1=Wi, 2=Wl, 3=Wm, 4=Wh, 5=Ww, 6=Wn, 7=Wr */
+static OFCmdUnsignedInt    opt_windowParameter = 0;
+static OFCmdUnsignedInt    opt_roiLeft = 0, opt_roiTop = 0, opt_roiWidth = 0, opt_roiHeight = 0;
+static OFCmdFloat          opt_windowCenter = 0.0, opt_windowWidth = 0.0;
+
+static EF_VoiLutFunction   opt_voiFunction = EFV_Default;
+static ES_PresentationLut  opt_presShape = ESP_Default;
+static OFString            opt_displayFile;
+static int                 opt_displayFunction = 0;          /* default: GSDF */
+                           /* 0=GSDF, 1=CIELAB */
+static OFCmdFloat          opt_ambientLight = -1;            /* default: not set */
+static OFCmdFloat          opt_illumination = -1;            /* default: not set */
+static OFCmdFloat          opt_minDensity = -1;              /* default: not set */
+static OFCmdFloat          opt_maxDensity = -1;              /* default: not set */
+static DiDisplayFunction::E_DeviceType deviceType = DiDisplayFunction::EDT_Monitor;
 
 #ifdef WITH_LIBTIFF
-    // TIFF parameters
+// TIFF parameters
 #ifdef HAVE_LIBTIFF_LZW_COMPRESSION
-    DiTIFFCompression   opt_tiffCompression = E_tiffLZWCompression;
+static DiTIFFCompression   opt_tiffCompression = E_tiffLZWCompression;
 #else
-    DiTIFFCompression   opt_tiffCompression = E_tiffPackBitsCompression;
+static DiTIFFCompression   opt_tiffCompression = E_tiffPackBitsCompression;
 #endif
-    DiTIFFLZWPredictor  opt_lzwPredictor = E_tiffLZWPredictorDefault;
-    OFCmdUnsignedInt    opt_rowsPerStrip = 0;
+static DiTIFFLZWPredictor  opt_lzwPredictor = E_tiffLZWPredictorDefault;
+static OFCmdUnsignedInt    opt_rowsPerStrip = 0;
 #endif
 
 #ifdef WITH_LIBPNG
-    // PNG parameters
-    DiPNGInterlace      opt_interlace = E_pngInterlaceAdam7;
-    DiPNGMetainfo       opt_metainfo  = E_pngFileMetainfo;
+// PNG parameters
+static DiPNGInterlace      opt_interlace = E_pngInterlaceAdam7;
+static DiPNGMetainfo       opt_metainfo  = E_pngFileMetainfo;
 #endif
 
 #ifdef BUILD_DCM2PNM_AS_DCMJ2PNM
-    // JPEG parameters
-    OFCmdUnsignedInt    opt_quality = 90;                 /* default: 90% JPEG quality */
-    E_SubSampling       opt_sampling = ESS_422;           /* default: 4:2:2 sub-sampling */
-    E_DecompressionColorSpaceConversion opt_decompCSconversion = EDC_photometricInterpretation;
+// JPEG parameters
+static OFCmdUnsignedInt    opt_quality = 90;                 /* default: 90% JPEG quality */
+static E_SubSampling       opt_sampling = ESS_422;           /* default: 4:2:2 sub-sampling */
+static E_DecompressionColorSpaceConversion opt_decompCSconversion = EDC_photometricInterpretation;
+#endif
+
+static int                 opt_Overlay[16];
+static int                 opt_O_used = 0;                   /* flag for +O parameter */
+static EM_Overlay          opt_OverlayMode = EMO_Default;    /* default: Replace or ROI */
+
+static OFCmdFloat          opt_foregroundDensity = 1.0;
+static OFCmdFloat          opt_thresholdDensity  = 0.5;
+
+static int                 opt_imageInfo = 0;                /* default: no info */
+static int                 opt_suppressOutput = 0;           /* default: create output */
+static E_FileType          opt_fileType = EFT_RawPNM;        /* default: 8-bit PGM/PPM */
+                                                             /* (binary for file output and ASCII for stdout) */
+static OFCmdUnsignedInt    opt_fileBits = 0;                 /* default: 0 */
+
+/* batch mode */
+static OFBool              opt_scanDir = OFFalse;            /* default: dcmfile-in is a DICOM file */
+static OFBool              opt_readFileList = OFFalse;
+static OFString            opt_scanPattern;
+static OFBool              opt_recurse = OFFalse;
+static OFCmdUnsignedInt    opt_batchThreads = 1;             /* default: convert one file at a time */
+
+/* input files and output filename template in batch mode */
+static OFVector<OFString>  batchFiles;
+static const char *        batchTemplate = NULL;
+static size_t              batchNextFile = 0;
+static size_t              batchErrors = 0;
+#ifdef WITH_THREADS
+static OFMutex             batchMutex;
 #endif
 
-    int                 opt_Overlay[16];
-    int                 opt_O_used = 0;                   /* flag for +O parameter */
-    EM_Overlay          opt_OverlayMode = EMO_Default;    /* default: Replace or ROI */
 
-    OFCmdFloat          opt_foregroundDensity = 1.0;
-    OFCmdFloat          opt_thresholdDensity  = 0.5;
+static int processFile(const char *inputName,
+                       const char *outputName,
+                       const size_t fileIndex);
+
+static int convertImage(DicomImage *&di,
+                        DcmDataset *dataset,
+                        const char *inputName,
+                        const char *outputName,
+                        const size_t fileIndex,
+                        const unsigned long firstFrame);
+
+static void createOutputFilename(const char *tmpl,
+                                 const char *inputName,
+                                 const size_t fileIndex,
+                                 const char *extension,
+                                 OFString &outputName);
+
+static OFBool readFileList(const char *filename,
+                           OFVector<OFString> &fileList);
+
+static void processBatch(const Uint32 threads);
+
+
+// ********************************************
+
+int main(int argc, char *argv[])
+{
+    OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION, consoleDescription, rcsid);
+    OFCommandLine cmd;
 
-    int                 opt_imageInfo = 0;                /* default: no info */
-    int                 opt_suppressOutput = 0;           /* default: create output */
-    E_FileType          opt_fileType = EFT_RawPNM;        /* default: 8-bit PGM/PPM */
-                                                          /* (binary for file output and ASCII for stdout) */
-    OFCmdUnsignedInt    opt_fileBits = 0;                 /* default: 0 */
     const char *        opt_ifname = NULL;
     const char *        opt_ofname = NULL;
 
@@ -212,7 +262,7 @@ int main(int argc, char *argv[])
     prepareCmdLineArgs(argc, argv, OFFIS_CONSOLE_APPLICATION);
     cmd.setOptionColumns(LONGCOL, SHORTCOL);
 
-    cmd.addParam("dcmfile-in",  "DICOM input filename to be converted");
+    cmd.addParam("dcmfile-in",  "DICOM input filename to be converted,\ndirectory or list of files in batch mode");
     cmd.addParam("bitmap-out", OFFIS_OUTFILE_DESCRIPTION, OFCmdParam::PM_Optional);
 
     cmd.addGroup("general options:", LONGCOL, SHORTCOL + 2);
@@ -234,6 +284,16 @@ int main(int argc, char *argv[])
       cmd.addOption("--read-xfer-big",      "-tb",     "read with explicit VR big endian TS");
       cmd.addOption("--read-xfer-implicit", "-ti",     "read with implicit VR little endian TS");
 
+     cmd.addSubGroup("batch mode:");
+      cmd.addOption("--scan-directories",   "+sd",     "scan directory dcmfile-in for input files");
+#ifdef PATTERN_MATCHING_AVAILABLE
+      cmd.addOption("--scan-pattern",       "+sp",  1, "[p]attern: string (only with --scan-directories)",
+                                                       "pattern for filename matching (wildcards)");
+#endif
+      cmd.addOption("--no-recurse",         "-r",      "do not recurse within directories (default)");
+      cmd.addOption("--recurse",            "+r",      "recurse within specified directories");
+      cmd.addOption("--read-file-list",     "+rl",     "read names of input files from text file\ndcmfile-in (one per line, \"-\" for stdin)");
+
     cmd.addGroup("image processing options:");
 
      cmd.addSubGroup("frame selection:");
@@ -257,7 +317,7 @@ int main(int argc, char *argv[])
       cmd.addOption("--recognize-aspect",   "+a",      "recognize pixel aspect ratio (default)");
       cmd.addOption("--ignore-aspect",      "-a",      "ignore pixel aspect ratio when scaling");
       cmd.addOption("--interpolate",        "+i",   1, "[n]umber of algorithm: integer",
-                                                       "use interpolation when scaling (1..4, def: 1)");
+                                                       "use interpolation when scaling (1..5, def: 1)");
       cmd.addOption("--no-interpolation",   "-i",      "no interpolation when scaling");
       cmd.addOption("--no-scaling",         "-S",      "no scaling, ignore pixel aspect ratio (default)");
       cmd.addOption("--scale-x-factor",     "+Sxf", 1, "[f]actor: float",
@@ -380,6 +440,11 @@ int main(int argc, char *argv[])
       cmd.addOption("--change-polarity",    "+P",      "change polarity (invert pixel output)");
       cmd.addOption("--clip-region",        "+C",   4, "[l]eft [t]op [w]idth [h]eight: integer",
                                                        "clip image region (l, t, w, h)");
+     cmd.addSubGroup("multi-threading:");
+      cmd.addOption("--threads",            "+mt",  1, "[n]umber: integer (default: 1)",
+                                                       "use up to n threads for rendering a frame");
+      cmd.addOption("--batch-threads",      "+bt",  1, "[n]umber: integer (default: 1)",
+                                                       "convert up to n files at the same time\n(batch mode only)");
 
     cmd.addGroup("output options:");
      cmd.addSubGroup("general:");
@@ -491,6 +556,31 @@ int main(int argc, char *argv[])
         }
         cmd.endOptionBlock();
 
+        /* input options: batch mode */
+
+        cmd.beginOptionBlock();
+        if (cmd.findOption("--scan-directories"))
+            opt_scanDir = OFTrue;
+        if (cmd.findOption("--read-file-list"))
+            opt_readFileList = OFTrue;
+        cmd.endOptionBlock();
+#ifdef PATTERN_MATCHING_AVAILABLE
+        if (cmd.findOption("--scan-pattern"))
+        {
+            app.checkDependence("--scan-pattern", "--scan-directories", opt_scanDir);
+            app.checkValue(cmd.getValue(opt_scanPattern));
+        }
+#endif
+        cmd.beginOptionBlock();
+        if (cmd.findOption("--no-recurse"))
+            opt_recurse = OFFalse;
+        if (cmd.findOption("--recurse"))
+        {
+            app.checkDependence("--recurse", "--scan-directories", opt_scanDir);
+            opt_recurse = OFTrue;
+        }
+        cmd.endOptionBlock();
+
         /* image processing options: compatibility options */
 
         if (cmd.findOption("--accept-acr-nema"))
@@ -538,6 +628,19 @@ int main(int argc, char *argv[])
             opt_useClip = 1;
         }
 
+        /* image processing options: multi-threading */
+
+        if (cmd.findOption("--threads"))
+        {
+            app.checkValue(cmd.getValueAndCheckMin(opt_threads, 1));
+            dcmRenderingMaxThreads.set(OFstatic_cast(Uint32, opt_threads));
+        }
+        if (cmd.findOption("--batch-threads"))
+        {
+            app.checkDependence("--batch-threads", "--scan-directories or --read-file-list", opt_scanDir || opt_readFileList);
+            app.checkValue(cmd.getValueAndCheckMin(opt_batchThreads, 1));
+        }
+
         /* image processing options: rotation */
 
         cmd.beginOptionBlock();
@@ -571,7 +674,7 @@ int main(int argc, char *argv[])
 
         cmd.beginOptionBlock();
         if (cmd.findOption("--interpolate"))
-            app.checkValue(cmd.getValueAndCheckMinMax(opt_useInterpolation, 1, 4));
+            app.checkValue(cmd.getValueAndCheckMinMax(opt_useInterpolation, 1, 5));
         if (cmd.findOption("--no-interpolation"))
             opt_useInterpolation = 0;
         cmd.endOptionBlock();
@@ -885,6 +988,10 @@ int main(int argc, char *argv[])
             opt_fileType = EFT_PastelPNM;
 #endif
         cmd.endOptionBlock();
+
+        /* batch mode: output to stdout is not possible */
+        if ((opt_scanDir || opt_readFileList) && (opt_ofname == NULL) && !opt_suppressOutput)
+            app.printError("missing parameter bitmap-out (filename template required in batch mode)");
     }
 
     /* print resource identifier */
@@ -897,8 +1004,6 @@ int main(int argc, char *argv[])
             << DCM_DICT_ENVIRONMENT_VARIABLE);
     }
 
-    OFLOG_INFO(dcm2pnmLogger, "reading DICOM file: " << opt_ifname);
-
     // register RLE decompression codec
     DcmRLEDecoderRegistration::registerCodecs();
 #ifdef BUILD_DCM2PNM_AS_DCMJ2PNM
@@ -910,12 +1015,77 @@ int main(int argc, char *argv[])
     DJLSDecoderRegistration::registerCodecs();
 #endif
 
+    int result = 0;
+    if (opt_scanDir || opt_readFileList)
+    {
+        /* batch mode: determine input files */
+        if (opt_scanDir)
+        {
+            if (!OFStandard::dirExists(opt_ifname))
+            {
+                OFLOG_FATAL(dcm2pnmLogger, "cannot access directory: " << opt_ifname);
+                return 1;
+            }
+            OFLOG_INFO(dcm2pnmLogger, "scanning directory for input files: " << opt_ifname);
+            OFList<OFString> fileList;
+            OFStandard::searchDirectoryRecursively(opt_ifname, fileList, opt_scanPattern, "" /*dirPrefix*/, opt_recurse);
+            OFListIterator(OFString) iter = fileList.begin();
+            while (iter != fileList.end())
+                batchFiles.push_back(*iter++);
+        }
+        else if (!readFileList(opt_ifname, batchFiles))
+        {
+            OFLOG_FATAL(dcm2pnmLogger, "cannot read list of input files: " << opt_ifname);
+            return 1;
+        }
+        if (batchFiles.empty())
+            OFLOG_WARN(dcm2pnmLogger, "no input files to be converted");
+        else
+        {
+            OFLOG_INFO(dcm2pnmLogger, "converting " << batchFiles.size() << " file(s) using up to "
+                << opt_batchThreads << " thread(s)");
+            batchTemplate = opt_ofname;
+            processBatch(OFstatic_cast(Uint32, opt_batchThreads));
+            if (batchErrors > 0)
+            {
+                OFLOG_ERROR(dcm2pnmLogger, batchErrors << " of " << batchFiles.size() << " file(s) could not be converted");
+                result = 1;
+            }
+        }
+    } else
+        result = processFile(opt_ifname, opt_ofname, 0);
+
+    // deregister RLE decompression codec
+    DcmRLEDecoderRegistration::cleanup();
+#ifdef BUILD_DCM2PNM_AS_DCMJ2PNM
+    // deregister JPEG decompression codecs
+    DJDecoderRegistration::cleanup();
+#endif
+#ifdef BUILD_DCM2PNM_AS_DCML2PNM
+    // deregister JPEG-LS decompression codecs
+    DJLSDecoderRegistration::cleanup();
+#endif
+
+    return result;
+}
+
+
+// ********************************************
+
+/* convert the given DICOM file (the file index is used for the filename template in batch mode) */
+static int processFile(const char *inputName,
+                       const char *outputName,
+                       const size_t fileIndex)
+{
+    OFLOG_INFO(dcm2pnmLogger, "reading DICOM file: " << inputName);
+
     DcmFileFormat *dfile = new DcmFileFormat();
-    OFCondition cond = dfile->loadFile(opt_ifname, opt_transferSyntax, EGL_withoutGL, DCM_MaxReadLength, opt_readMode);
+    OFCondition cond = dfile->loadFile(inputName, opt_transferSyntax, EGL_withoutGL, DCM_MaxReadLength, opt_readMode);
 
     if (cond.bad())
     {
-        OFLOG_FATAL(dcm2pnmLogger, cond.text() << ": reading file: " << opt_ifname);
+        OFLOG_FATAL(dcm2pnmLogger, cond.text() << ": reading file: " << inputName);
+        delete dfile;
         return 1;
     }
 
@@ -924,34 +1094,29 @@ int main(int argc, char *argv[])
     DcmDataset *dataset = dfile->getDataset();
     E_TransferSyntax xfer = dataset->getOriginalXfer();
 
+    /* the dataset is deleted below, since it is shared by all images created from it */
+    unsigned long compatibilityMode = opt_compatibilityMode & ~CIF_TakeOverExternalDataset;
+    unsigned long firstFrame = opt_frame;
+    unsigned long lastFrame = opt_frame;
+    unsigned long imageFrameCount = opt_frameCount;
     Sint32 frameCount;
-    if (dataset->findAndGetSint32(DCM_NumberOfFrames, frameCount).bad())
+    if (dataset->findAndGetSint32(DCM_NumberOfFrames, frameCount).bad() || (frameCount < 1))
         frameCount = 1;
     if ((opt_frameCount == 0) || ((opt_frame == 1) && (opt_frameCount == OFstatic_cast(Uint32, frameCount))))
     {
-        // since we process all frames anyway, decompress the complete pixel data (if required)
-        opt_compatibilityMode |= CIF_DecompressCompletePixelData;
+        // since we process all frames anyway, create one image per frame, so that the pixel data
+        // of large multi-frame images does not have to be decompressed and stored completely
+        firstFrame = 1;
+        lastFrame = OFstatic_cast(unsigned long, frameCount);
+        imageFrameCount = 1;
     }
-    if ((frameCount > 1) && !(opt_compatibilityMode & CIF_DecompressCompletePixelData))
+    if (frameCount > 1)
     {
-        // use partial read access to pixel data (only in case of multiple frames, but not for all frames)
-        opt_compatibilityMode |= CIF_UsePartialAccessToPixelData;
+        // use partial read access to pixel data (only in case of multiple frames)
+        compatibilityMode |= CIF_UsePartialAccessToPixelData;
     }
 
-    DicomImage *di = new DicomImage(dfile, xfer, opt_compatibilityMode, opt_frame - 1, opt_frameCount);
-    if (di == NULL)
-    {
-        OFLOG_FATAL(dcm2pnmLogger, "Out of memory");
-        return 1;
-    }
-
-    if (di->getStatus() != EIS_Normal)
-    {
-        OFLOG_FATAL(dcm2pnmLogger, DicomImage::getString(di->getStatus()));
-        return 1;
-    }
-
-    /* create & set display function */
+    /* create display function */
     DiDisplayFunction *disp = NULL;
     if (!opt_displayFile.empty())
     {
@@ -969,20 +1134,60 @@ int main(int argc, char *argv[])
                 disp->setMinDensityValue(opt_minDensity);
             if (opt_maxDensity >= 0)
                 disp->setMaxDensityValue(opt_maxDensity);
-            if ((di != NULL) && (disp->isValid()))
+            if (disp->isValid())
             {
                 OFLOG_INFO(dcm2pnmLogger, "activating "
                     << ((opt_displayFunction == 1) ? "CIELAB" : "GSDF")
                     << " display function for "
                     << ((deviceType == DiDisplayFunction::EDT_Monitor) ? "softcopy" : "hardcopy")
                     << " devices");
-                if (!di->setDisplayFunction(disp))
-                    OFLOG_WARN(dcm2pnmLogger, "cannot select display function");
             }
         }
     }
 
-    if (opt_imageInfo)
+    int result = 0;
+    for (unsigned long frame = firstFrame; (frame <= lastFrame) && (result == 0); frame++)
+    {
+        DicomImage *di = new DicomImage(dfile, xfer, compatibilityMode, frame - 1, imageFrameCount);
+        if (di == NULL)
+        {
+            OFLOG_FATAL(dcm2pnmLogger, "Out of memory");
+            result = 1;
+        }
+        else if (di->getStatus() != EIS_Normal)
+        {
+            OFLOG_FATAL(dcm2pnmLogger, DicomImage::getString(di->getStatus()));
+            result = 1;
+        } else {
+            /* set display function */
+            if ((disp != NULL) && disp->isValid() && !di->setDisplayFunction(disp))
+                OFLOG_WARN(dcm2pnmLogger, "cannot select display function");
+            result = convertImage(di, dataset, inputName, outputName, fileIndex, frame);
+        }
+        delete di;
+    }
+
+    /* done, now cleanup. */
+    OFLOG_INFO(dcm2pnmLogger, "cleaning up memory");
+    delete disp;
+    delete dfile;
+
+    return result;
+}
+
+
+/* dump information on and write the selected frame(s) of the given image to file(s) */
+static int convertImage(DicomImage *&di,
+                        DcmDataset *dataset,
+                        const char *inputName,
+                        const char *outputName,
+                        const size_t fileIndex,
+                        const unsigned long firstFrame)
+{
+    E_TransferSyntax xfer = dataset->getOriginalXfer();
+
+    /* if all frames are processed one after the other, dump the parameters only once */
+    if (opt_imageInfo && (firstFrame == opt_frame))
     {
         /* dump image parameters */
         OFLOG_INFO(dcm2pnmLogger, "dumping image parameters");
@@ -1016,7 +1221,7 @@ int main(int argc, char *argv[])
         OFStandard::ftoa(aspectRatio, sizeof(aspectRatio), di->getHeightWidthRatio(), OFStandard::ftoa_format_f, 0, 2);
 
         /* dump some general information */
-        OFLOG_INFO(dcm2pnmLogger, "  filename            : " << opt_ifname << OFendl
+        OFLOG_INFO(dcm2pnmLogger, "  filename            : " << inputName << OFendl
             << "  transfer syntax     : " << XferText << OFendl
             << "  SOP class           : " << SOPClassText << OFendl
             << "  SOP instance UID    : " << SOPInstanceUID << OFendl
@@ -1029,7 +1234,7 @@ int main(int argc, char *argv[])
             OFLOG_INFO(dcm2pnmLogger, "  frame time (in ms)  : " << di->getFrameTime());
 
         /* dump VOI windows */
-        unsigned long count;
+        unsigned long i, count;
         OFString explStr, funcStr;
         count = di->getWindowCount();
         switch (di->getVoiLutFunction())
@@ -1100,9 +1305,9 @@ int main(int argc, char *argv[])
     if (!opt_suppressOutput)
     {
         /* try to select frame */
-        if (opt_frame != di->getFirstFrame() + 1)
+        if (firstFrame != di->getFirstFrame() + 1)
         {
-            OFLOG_FATAL(dcm2pnmLogger, "cannot select frame " << opt_frame << ", invalid frame number");
+            OFLOG_FATAL(dcm2pnmLogger, "cannot select frame " << firstFrame << ", invalid frame number");
             return 1;
         }
 
@@ -1402,6 +1607,14 @@ int main(int argc, char *argv[])
             break;
         }
 
+        /* create output filename from template (batch mode) */
+        OFString outputFile;
+        if ((outputName != NULL) && (opt_scanDir || opt_readFileList))
+        {
+            createOutputFilename(outputName, inputName, fileIndex, ofext, outputFile);
+            outputName = outputFile.c_str();
+        }
+
         if (fcount < opt_frameCount)
         {
             OFLOG_WARN(dcm2pnmLogger, "cannot select " << opt_frameCount << " frames, limiting to "
@@ -1410,26 +1623,26 @@ int main(int argc, char *argv[])
 
         for (unsigned int frame = 0; frame < fcount; frame++)
         {
-            if (opt_ofname)
+            if (outputName)
             {
                 /* output to file */
                 if (opt_multiFrame)
                 {
                     OFOStringStream stream;
                     /* generate output filename */
-                    stream << opt_ofname << ".";
+                    stream << outputName << ".";
                     if (opt_useFrameNumber)
-                        stream << "f" << (opt_frame + frame);
+                        stream << "f" << (firstFrame + frame);
                     else
-                        stream << frame;
+                        stream << (firstFrame - opt_frame + frame);
                     stream << "." << ofext << OFStringStream_ends;
                     /* convert string stream into a character string */
                     OFSTRINGSTREAM_GETSTR(stream, buffer_str)
                     ofname.assign(buffer_str);
                     OFSTRINGSTREAM_FREESTR(buffer_str)
                 } else
-                    ofname.assign(opt_ofname);
-                OFLOG_INFO(dcm2pnmLogger, "writing frame " << (opt_frame + frame) << " to " << ofname);
+                    ofname.assign(outputName);
+                OFLOG_INFO(dcm2pnmLogger, "writing frame " << (firstFrame + frame) << " to " << ofname);
                 ofile = fopen(ofname.c_str(), "wb");
                 if (ofile == NULL)
                 {
@@ -1439,7 +1652,7 @@ int main(int argc, char *argv[])
             } else {
                 /* output to stdout */
                 ofile = stdout;
-                OFLOG_INFO(dcm2pnmLogger, "writing frame " << (opt_frame + frame) << " to stdout");
+                OFLOG_INFO(dcm2pnmLogger, "writing frame " << (firstFrame + frame) << " to stdout");
             }
 
             /* finally create output image file */
@@ -1513,14 +1726,14 @@ int main(int argc, char *argv[])
                     break;
 #endif
                 default:
-                    if (opt_ofname)
+                    if (outputName)
                         result = di->writeRawPPM(ofile, 8, frame);
                     else /* stdout */
                         result = di->writePPM(ofile, 8, frame);
                     break;
             }
 
-            if (opt_ofname)
+            if (outputName)
                 fclose(ofile);
 
             if (!result)
@@ -1531,21 +1744,160 @@ int main(int argc, char *argv[])
         }
     }
 
-    /* done, now cleanup. */
-    OFLOG_INFO(dcm2pnmLogger, "cleaning up memory");
-    delete di;
-    delete disp;
+    return 0;
+}
 
-    // deregister RLE decompression codec
-    DcmRLEDecoderRegistration::cleanup();
-#ifdef BUILD_DCM2PNM_AS_DCMJ2PNM
-    // deregister JPEG decompression codecs
-    DJDecoderRegistration::cleanup();
+
+/* create output filename from the given template (batch mode), the following
+ * placeholders are replaced: %d = directory of the input file, %b = filename of
+ * the input file (without directory), %n = 0-based index of the input file,
+ * %e = default file extension, %% = percent sign
+ */
+static void createOutputFilename(const char *tmpl,
+                                 const char *inputName,
+                                 const size_t fileIndex,
+                                 const char *extension,
+                                 OFString &outputName)
+{
+    OFString dirName, fileName;
+    OFStandard::getDirNameFromPath(dirName, inputName, OFFalse /*assumeDirName*/);
+    OFStandard::getFilenameFromPath(fileName, inputName, OFFalse /*assumeFilename*/);
+    if (dirName.empty())
+        dirName = ".";
+    OFOStringStream stream;
+    for (const char *c = tmpl; *c != '\0'; c++)
+    {
+        if ((*c == '%') && (*(c + 1) != '\0'))
+        {
+            switch (*(++c))
+            {
+                case 'd':
+                    stream << dirName;
+                    break;
+                case 'b':
+                    stream << fileName;
+                    break;
+                case 'n':
+                    stream << fileIndex;
+                    break;
+                case 'e':
+                    stream << extension;
+                    break;
+                default:
+                    stream << *c;
+                    break;
+            }
+        } else
+            stream << *c;
+    }
+    stream << OFStringStream_ends;
+    OFSTRINGSTREAM_GETSTR(stream, buffer_str)
+    outputName.assign(buffer_str);
+    OFSTRINGSTREAM_FREESTR(buffer_str)
+}
+
+
+/* read names of input files from the given text file (batch mode), one name per line */
+static OFBool readFileList(const char *filename,
+                           OFVector<OFString> &fileList)
+{
+    FILE *file = (strcmp(filename, "-") == 0) ? stdin : fopen(filename, "r");
+    if (file == NULL)
+        return OFFalse;
+    char line[4096];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        /* remove line break and trailing whitespace */
+        size_t len = strlen(line);
+        while ((len > 0) && ((line[len - 1] == '\n') || (line[len - 1] == '\r') || (line[len - 1] == ' ') || (line[len - 1] == '\t')))
+            line[--len] = '\0';
+        /* ignore empty lines */
+        if (len > 0)
+            fileList.push_back(line);
+    }
+    if (file != stdin)
+        fclose(file);
+    return OFTrue;
+}
+
+
+/* convert the remaining input files of the batch (called by all threads) */
+static void processBatchFiles()
+{
+    OFBool done = OFFalse;
+    while (!done)
+    {
+        /* get index of the next file to be converted */
+        size_t fileIndex = 0;
+#ifdef WITH_THREADS
+        batchMutex.lock();
 #endif
-#ifdef BUILD_DCM2PNM_AS_DCML2PNM
-    // deregister JPEG-LS decompression codecs
-    DJLSDecoderRegistration::cleanup();
+        if (batchNextFile < batchFiles.size())
+            fileIndex = batchNextFile++;
+        else
+            done = OFTrue;
+#ifdef WITH_THREADS
+        batchMutex.unlock();
+#endif
+        if (!done && (processFile(batchFiles[fileIndex].c_str(), batchTemplate, fileIndex) != 0))
+        {
+            OFLOG_ERROR(dcm2pnmLogger, "cannot convert file: " << batchFiles[fileIndex]);
+#ifdef WITH_THREADS
+            batchMutex.lock();
+#endif
+            ++batchErrors;
+#ifdef WITH_THREADS
+            batchMutex.unlock();
 #endif
+        }
+    }
+}
 
-    return 0;
+
+#ifdef WITH_THREADS
+
+/* thread converting input files of the batch */
+class DcmBatchThread
+  : public OFThread
+{
+  protected:
+
+    virtual void run()
+    {
+        processBatchFiles();
+    }
+};
+
+#endif
+
+
+/* convert all input files of the batch using the given number of threads */
+static void processBatch(const Uint32 threads)
+{
+#ifdef WITH_THREADS
+    OFVector<DcmBatchThread *> threadList;
+    /* the calling thread also converts files */
+    for (Uint32 t = 1; (t < threads) && (t < batchFiles.size()); ++t)
+    {
+        DcmBatchThread *thread = new DcmBatchThread();
+        if (thread->start() == 0)
+            threadList.push_back(thread);
+        else
+        {
+            OFLOG_WARN(dcm2pnmLogger, "cannot start thread, using " << t << " thread(s)");
+            delete thread;
+            break;
+        }
+    }
+    processBatchFiles();
+    for (size_t i = 0; i < threadList.size(); ++i)
+    {
+        threadList[i]->join();
+        delete threadList[i];
+    }
+#else
+    if (threads > 1)
+        OFLOG_WARN(dcm2pnmLogger, "no thread support, converting files sequentially");
+    processBatchFiles();
+#endif
 }
@@ -41,6 +41,7 @@
 
 #include "dcmtk/dcmimgle/dcmimage.h"     /* for DicomImage */
 #include "dcmtk/dcmimage/diregist.h"     /* include to support color images */
+#include "dcmtk/dcmimgle/diparal.h"      /* for dcmRenderingMaxThreads */
 #include "dcmtk/dcmdata/dcrledrg.h"      /* for DcmRLEDecoderRegistration */
 
 #ifdef BUILD_DCMSCALE_AS_DCMJSCAL
@@ -107,6 +108,8 @@ int main(int argc, char *argv[])
     OFCmdSignedInt   opt_left = 0, opt_top = 0;        /* clip region (origin) */
     OFCmdUnsignedInt opt_width = 0, opt_height = 0;    /* clip region (extension) */
 
+    OFCmdUnsignedInt opt_threads = 1;                  /* default: scale in a single thread */
+
     const char *opt_ifname = NULL;
     const char *opt_ofname = NULL;
 
@@ -147,7 +150,7 @@ int main(int argc, char *argv[])
       cmd.addOption("--recognize-aspect",    "+a",      "recognize pixel aspect ratio (default)");
       cmd.addOption("--ignore-aspect",       "-a",      "ignore pixel aspect ratio when scaling");
       cmd.addOption("--interpolate",         "+i",   1, "[n]umber of algorithm: integer",
-                                                        "use interpolation when scaling (1..4, def: 1)");
+                                                        "use interpolation when scaling (1..5, def: 1)");
       cmd.addOption("--no-interpolation",    "-i",      "no interpolation when scaling");
       cmd.addOption("--no-scaling",          "-S",      "no scaling, ignore pixel aspect ratio (default)");
       cmd.addOption("--scale-x-factor",      "+Sxf", 1, "[f]actor: float",
@@ -161,6 +164,9 @@ int main(int argc, char *argv[])
      cmd.addSubGroup("other transformations:");
       cmd.addOption("--clip-region",         "+C",   4, "[l]eft [t]op [w]idth [h]eight: integer",
                                                         "clip rectangular image region (l, t, w, h)");
+     cmd.addSubGroup("multi-threading:");
+      cmd.addOption("--threads",             "+mt",  1, "[n]umber: integer (default: 1)",
+                                                        "use up to n threads for scaling a frame");
      cmd.addSubGroup("SOP Instance UID:");
       cmd.addOption("--uid-always",          "+ua",     "always assign new SOP Instance UID (default)");
       cmd.addOption("--uid-never",           "+un",     "never assign new SOP Instance UID");
@@ -283,7 +289,7 @@ int main(int argc, char *argv[])
 
       cmd.beginOptionBlock();
       if (cmd.findOption("--interpolate"))
-          app.checkValue(cmd.getValueAndCheckMinMax(opt_useInterpolation, 1, 4));
+          app.checkValue(cmd.getValueAndCheckMinMax(opt_useInterpolation, 1, 5));
       if (cmd.findOption("--no-interpolation"))
           opt_useInterpolation = 0;
       cmd.endOptionBlock();
@@ -324,6 +330,14 @@ int main(int argc, char *argv[])
           opt_useClip = OFTrue;
       }
 
+      /* image processing options: multi-threading */
+
+      if (cmd.findOption("--threads"))
+      {
+          app.checkValue(cmd.getValueAndCheckMin(opt_threads, 1));
+          dcmRenderingMaxThreads.set(OFstatic_cast(Uint32, opt_threads));
+      }
+
       /* image processing options: SOP Instance UID options */
 
       cmd.beginOptionBlock();
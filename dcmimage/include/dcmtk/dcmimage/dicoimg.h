@@ -117,6 +117,30 @@ class DCMTK_DCMIMAGE_EXPORT DiColorImage
                       const int bits,
                       const int planar = 0);
 
+    /** get pixel data of a strip of rows with specified format.
+     *  (memory is handled externally)
+     *
+     ** @param  buffer    untyped pointer to the externally allocated memory buffer
+     *  @param  size      size of the memory buffer in bytes (will be checked)
+     *  @param  frame     number of frame to be rendered
+     *  @param  bits      number of bits per sample for the output pixel data (depth)
+     *  @param  firstRow  first row to be rendered (starting from 0)
+     *  @param  rowCount  number of rows to be rendered
+     *  @param  planar    0 = color-by-pixel (R1G1B1...R2G2B2...R3G3B3...)
+     *                    1 = color-by-plane (R1R2R3...G1G2G3...B1B2B3...), planes of the strip
+     *  @param  sharedLUT not used for color images
+     *
+     ** @return status, true if successful, false otherwise
+     */
+    int getOutputRows(void *buffer,
+                      const unsigned long size,
+                      const unsigned long frame,
+                      const int bits,
+                      const unsigned long firstRow,
+                      const unsigned long rowCount,
+                      const int planar = 0,
+                      DiMonoOutputLUT *sharedLUT = NULL);
+
     /** get pixel data of specified plane.
      *  (memory is handled internally)
      *
@@ -153,7 +177,7 @@ class DCMTK_DCMIMAGE_EXPORT DiColorImage
      *  @param  interpolate   specifies whether scaling algorithm should use interpolation (if necessary).
      *                        default: no interpolation (0), preferred interpolation algorithm (if applicable):
      *                          1 = pbmplus algorithm, 2 = c't algorithm, 3 = bilinear magnification,
-     *                          4 = bicubic magnification
+     *                          4 = bicubic magnification, 5 = area averaging reduction (box filter)
      *  @param  aspect        specifies whether pixel aspect ratio should be taken into consideration
      *                        (if true, width OR height should be 0, i.e. this component will be calculated
      *                         automatically)
@@ -361,7 +385,7 @@ class DCMTK_DCMIMAGE_EXPORT DiColorImage
      *  @param  interpolate  specifies whether scaling algorithm should use interpolation (if necessary).
      *                       default: no interpolation (0), preferred interpolation algorithm (if applicable):
      *                         1 = pbmplus algorithm, 2 = c't algorithm, 3 = bilinear magnification,
-     *                         4 = bicubic magnification
+     *                         4 = bicubic magnification, 5 = area averaging reduction (box filter)
      *  @param  aspect       specifies whether pixel aspect ratio should be taken into consideration
      *                       (if true, width OR height should be 0, i.e. this component will be calculated
      *                        automatically)
@@ -408,6 +432,8 @@ class DCMTK_DCMIMAGE_EXPORT DiColorImage
      *  @param  frame     number of frame to be rendered
      *  @param  bits      number of bits for the output pixel data (depth)
      *  @param  planar    flag, 0 = color-by-pixel and 1 = color-by-plane
+     *  @param  firstRow  first row to be rendered (optional, used to render a strip of rows)
+     *  @param  rowCount  number of rows to be rendered (optional, 0 = all rows starting from 'firstRow')
      *
      ** @return untyped pointer to the pixel data if successful, NULL otherwise
      */
@@ -415,7 +441,9 @@ class DCMTK_DCMIMAGE_EXPORT DiColorImage
                         const unsigned long size,
                         const unsigned long frame,
                         const int bits,
-                        const int planar);
+                        const int planar,
+                        const unsigned long firstRow = 0,
+                        const unsigned long rowCount = 0);
 
     /** update Image Pixel Module attributes in the given dataset.
      *  Removes color palette lookup tables.  Used in writeXXXToDataset() routines.
@@ -0,0 +1,594 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimage
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomColorKernels (Header)
+ *
+ */
+
+
+#ifndef DICOKRNL_H
+#define DICOKRNL_H
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/dcmimage/dicdefin.h"
+#include "dcmtk/dcmimage/dicopxt.h"
+#include "dcmtk/dcmimgle/diparal.h"
+
+#include "dcmtk/ofstd/oftypes.h"
+#include "dcmtk/ofstd/ofcast.h"
+
+
+/*---------------------*
+ *  class declaration  *
+ *---------------------*/
+
+/** Class collecting the innermost loops of the color pixel templates, i.e. the
+ *  conversion from YCbCr to RGB, the separation of color-by-pixel data into planes
+ *  and the interleaving of planes for the output. For 8 bit unsigned data, which
+ *  is most common for color images, vectorized versions of these loops are used if
+ *  supported by the CPU (SSE4.1 and AVX2 on x86, the instruction set is determined
+ *  by DiMonoKernels). All other data types use the generic version.
+ *  The results of the vectorized versions are identical to the generic version.
+ */
+class DCMTK_DCMIMAGE_EXPORT DiColorKernels
+{
+
+ public:
+
+    /** convert YCbCr (full) to RGB by means of integer tables (generic version).
+     *  Should only be used for unsigned input with 8 bits stored.
+     *
+     ** @param  y         luminance values
+     *  @param  cb        blue chrominance values
+     *  @param  cr        red chrominance values
+     *  @param  step      distance between two consecutive input values of a
+     *                    component (1 = color-by-plane, 3 = color-by-pixel)
+     *  @param  r         red output values
+     *  @param  g         green output values
+     *  @param  b         blue output values
+     *  @param  count     number of pixels
+     *  @param  maxvalue  maximum output value
+     */
+    template<class T1, class T2>
+    static inline void convertYBRToRGB(const T1 *y,
+                                       const T1 *cb,
+                                       const T1 *cr,
+                                       const unsigned long step,
+                                       T2 *r,
+                                       T2 *g,
+                                       T2 *b,
+                                       const unsigned long count,
+                                       const T2 maxvalue)
+    {
+        Sint16 rcr_tab[256];
+        Sint16 gcb_tab[256];
+        Sint16 gcr_tab[256];
+        Sint16 bcb_tab[256];
+        createYBRTables(rcr_tab, gcb_tab, gcr_tab, bcb_tab, OFstatic_cast(double, maxvalue));
+        Sint32 sr;
+        Sint32 sg;
+        Sint32 sb;
+        for (unsigned long i = count; i != 0; --i, y += step, cb += step, cr += step)
+        {
+            sr = OFstatic_cast(Sint32, *y) + OFstatic_cast(Sint32, rcr_tab[OFstatic_cast(Uint32, *cr)]);
+            sg = OFstatic_cast(Sint32, *y) - OFstatic_cast(Sint32, gcb_tab[OFstatic_cast(Uint32, *cb)]) - OFstatic_cast(Sint32, gcr_tab[OFstatic_cast(Uint32, *cr)]);
+            sb = OFstatic_cast(Sint32, *y) + OFstatic_cast(Sint32, bcb_tab[OFstatic_cast(Uint32, *cb)]);
+            *(r++) = (sr < 0) ? 0 : (sr > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sr);
+            *(g++) = (sg < 0) ? 0 : (sg > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sg);
+            *(b++) = (sb < 0) ? 0 : (sb > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sb);
+        }
+    }
+
+    /// convert YCbCr (full) to RGB by means of integer tables (vectorized version, see above)
+    static void convertYBRToRGB(const Uint8 *y, const Uint8 *cb, const Uint8 *cr, const unsigned long step,
+                                Uint8 *r, Uint8 *g, Uint8 *b, const unsigned long count, const Uint8 maxvalue);
+
+    /** convert YCbCr 4:2:2 (full or partial) to RGB (generic version).
+     *  The input consists of pixel pairs sharing the chrominance values (Y1 Y2 Cb Cr).
+     *
+     ** @param  src       input values
+     *  @param  offset    offset used to remove the sign of the input values
+     *  @param  r         red output values
+     *  @param  g         green output values
+     *  @param  b         blue output values
+     *  @param  pairs     number of pixel pairs
+     *  @param  maxvalue  maximum output value
+     *  @param  partial   convert YCbCr partial if true, YCbCr full otherwise
+     */
+    template<class T1, class T2>
+    static inline void convertYBR422ToRGB(const T1 *src,
+                                          const T1 offset,
+                                          T2 *r,
+                                          T2 *g,
+                                          T2 *b,
+                                          const unsigned long pairs,
+                                          const T2 maxvalue,
+                                          const OFBool partial)
+    {
+        T2 y1;
+        T2 y2;
+        T2 cb;
+        T2 cr;
+        for (unsigned long i = pairs; i != 0; --i)
+        {
+            y1 = removeSign(*(src++), offset);
+            y2 = removeSign(*(src++), offset);
+            cb = removeSign(*(src++), offset);
+            cr = removeSign(*(src++), offset);
+            if (partial)
+            {
+                convertPartialValue(*(r++), *(g++), *(b++), y1, cb, cr, maxvalue);
+                convertPartialValue(*(r++), *(g++), *(b++), y2, cb, cr, maxvalue);
+            } else {
+                convertFullValue(*(r++), *(g++), *(b++), y1, cb, cr, maxvalue);
+                convertFullValue(*(r++), *(g++), *(b++), y2, cb, cr, maxvalue);
+            }
+        }
+    }
+
+    /// convert YCbCr 4:2:2 (full or partial) to RGB (vectorized version, see above)
+    static void convertYBR422ToRGB(const Uint8 *src, const Uint8 offset, Uint8 *r, Uint8 *g, Uint8 *b,
+                                   const unsigned long pairs, const Uint8 maxvalue, const OFBool partial);
+
+    /** separate color-by-pixel data into three planes (generic version)
+     *
+     ** @param  src     input values (color-by-pixel)
+     *  @param  offset  offset used to remove the sign of the input values
+     *  @param  dst0    output values of the first plane
+     *  @param  dst1    output values of the second plane
+     *  @param  dst2    output values of the third plane
+     *  @param  count   number of pixels
+     */
+    template<class T1, class T2>
+    static inline void splitPlanes(const T1 *src,
+                                   const T1 offset,
+                                   T2 *dst0,
+                                   T2 *dst1,
+                                   T2 *dst2,
+                                   const unsigned long count)
+    {
+        for (unsigned long i = count; i != 0; --i)
+        {
+            *(dst0++) = removeSign(*(src++), offset);
+            *(dst1++) = removeSign(*(src++), offset);
+            *(dst2++) = removeSign(*(src++), offset);
+        }
+    }
+
+    /// separate color-by-pixel data into three planes (vectorized version, see above)
+    static void splitPlanes(const Uint8 *src, const Uint8 offset, Uint8 *dst0, Uint8 *dst1, Uint8 *dst2,
+                            const unsigned long count);
+
+    /** interleave three planes to color-by-pixel data, optionally inverting the values
+     *  (generic version)
+     *
+     ** @param  src0     input values of the first plane
+     *  @param  src1     input values of the second plane
+     *  @param  src2     input values of the third plane
+     *  @param  dst      output values (color-by-pixel)
+     *  @param  count    number of pixels
+     *  @param  inverse  invert values if true, i.e. output 'maxvalue - value'
+     *  @param  maxvalue maximum output value (only used if 'inverse' is true)
+     */
+    template<class T1, class T2>
+    static inline void mergePlanes(const T1 *src0,
+                                   const T1 *src1,
+                                   const T1 *src2,
+                                   T2 *dst,
+                                   const unsigned long count,
+                                   const OFBool inverse,
+                                   const T2 maxvalue)
+    {
+        unsigned long i;
+        if (inverse)
+        {
+            for (i = count; i != 0; --i)
+            {
+                *(dst++) = maxvalue - OFstatic_cast(T2, *(src0++));
+                *(dst++) = maxvalue - OFstatic_cast(T2, *(src1++));
+                *(dst++) = maxvalue - OFstatic_cast(T2, *(src2++));
+            }
+        } else {
+            for (i = count; i != 0; --i)
+            {
+                *(dst++) = OFstatic_cast(T2, *(src0++));
+                *(dst++) = OFstatic_cast(T2, *(src1++));
+                *(dst++) = OFstatic_cast(T2, *(src2++));
+            }
+        }
+    }
+
+    /// interleave three planes to color-by-pixel data (vectorized version, see above)
+    static void mergePlanes(const Uint8 *src0, const Uint8 *src1, const Uint8 *src2, Uint8 *dst,
+                            const unsigned long count, const OFBool inverse, const Uint8 maxvalue);
+
+    /** create the integer tables used for the conversion from YCbCr (full) to RGB
+     *
+     ** @param  rcr_tab   table for the red component (depending on Cr), 256 entries
+     *  @param  gcb_tab   table for the green component (depending on Cb), 256 entries
+     *  @param  gcr_tab   table for the green component (depending on Cr), 256 entries
+     *  @param  bcb_tab   table for the blue component (depending on Cb), 256 entries
+     *  @param  maxvalue  maximum output value
+     */
+    static inline void createYBRTables(Sint16 *rcr_tab,
+                                       Sint16 *gcb_tab,
+                                       Sint16 *gcr_tab,
+                                       Sint16 *bcb_tab,
+                                       const double maxvalue)
+    {
+        const double r_const = 0.7010 * maxvalue;
+        const double g_const = 0.5291 * maxvalue;
+        const double b_const = 0.8859 * maxvalue;
+        for (unsigned long l = 0; l < 256; ++l)
+        {
+            rcr_tab[l] = OFstatic_cast(Sint16, 1.4020 * OFstatic_cast(double, l) - r_const);
+            gcb_tab[l] = OFstatic_cast(Sint16, 0.3441 * OFstatic_cast(double, l));
+            gcr_tab[l] = OFstatic_cast(Sint16, 0.7141 * OFstatic_cast(double, l) - g_const);
+            bcb_tab[l] = OFstatic_cast(Sint16, 1.7720 * OFstatic_cast(double, l) - b_const);
+        }
+    }
+
+    /** convert a single YCbCr (full) value to RGB
+     */
+    template<class T2>
+    static inline void convertFullValue(T2 &red,
+                                        T2 &green,
+                                        T2 &blue,
+                                        const T2 y,
+                                        const T2 cb,
+                                        const T2 cr,
+                                        const T2 maxvalue)
+    {
+        double dr = OFstatic_cast(double, y) + 1.4020 * OFstatic_cast(double, cr) - 0.7010 * OFstatic_cast(double, maxvalue);
+        double dg = OFstatic_cast(double, y) - 0.3441 * OFstatic_cast(double, cb) - 0.7141 * OFstatic_cast(double, cr) + 0.5291 * OFstatic_cast(double, maxvalue);
+        double db = OFstatic_cast(double, y) + 1.7720 * OFstatic_cast(double, cb) - 0.8859 * OFstatic_cast(double, maxvalue);
+        red   = (dr < 0.0) ? 0 : (dr > OFstatic_cast(double, maxvalue)) ? maxvalue : OFstatic_cast(T2, dr);
+        green = (dg < 0.0) ? 0 : (dg > OFstatic_cast(double, maxvalue)) ? maxvalue : OFstatic_cast(T2, dg);
+        blue  = (db < 0.0) ? 0 : (db > OFstatic_cast(double, maxvalue)) ? maxvalue : OFstatic_cast(T2, db);
+    }
+
+    /** convert a single YCbCr (partial) value to RGB
+     */
+    template<class T2>
+    static inline void convertPartialValue(T2 &red,
+                                           T2 &green,
+                                           T2 &blue,
+                                           const T2 y,
+                                           const T2 cb,
+                                           const T2 cr,
+                                           const T2 maxvalue)
+    {
+        double dr = 1.1631 * OFstatic_cast(double, y) + 1.5969 * OFstatic_cast(double, cr) - 0.8713 * OFstatic_cast(double, maxvalue);
+        double dg = 1.1631 * OFstatic_cast(double, y) - 0.3913 * OFstatic_cast(double, cb) - 0.8121 * OFstatic_cast(double, cr) + 0.5290 * OFstatic_cast(double, maxvalue);
+        double db = 1.1631 * OFstatic_cast(double, y) + 2.0177 * OFstatic_cast(double, cb) - 1.0820 * OFstatic_cast(double, maxvalue);
+        red   = (dr < 0.0) ? 0 : (dr > OFstatic_cast(double, maxvalue)) ? maxvalue : OFstatic_cast(T2, dr);
+        green = (dg < 0.0) ? 0 : (dg > OFstatic_cast(double, maxvalue)) ? maxvalue : OFstatic_cast(T2, dg);
+        blue  = (db < 0.0) ? 0 : (db > OFstatic_cast(double, maxvalue)) ? maxvalue : OFstatic_cast(T2, db);
+    }
+};
+
+
+/** Template class converting YCbCr (full) to RGB by means of integer tables, possibly
+ *  split into several blocks processed in parallel (see DiParallelLoop).
+ *  Color-by-plane data of a multi-frame image (three planes per frame) is processed
+ *  by a single loop, i.e. the frames are converted in parallel.
+ */
+template<class T1, class T2>
+class DiColorYBRLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor (see DiColorKernels::convertYBRToRGB() for details on the parameters)
+     *
+     ** @param  planeSize  number of pixels per plane if the input consists of frames
+     *                     with three planes each (color-by-plane, 'step' has to be 1),
+     *                     0 if the input values of a component are contiguous
+     */
+    DiColorYBRLoop(const T1 *y,
+                   const T1 *cb,
+                   const T1 *cr,
+                   const unsigned long step,
+                   T2 *r,
+                   T2 *g,
+                   T2 *b,
+                   const unsigned long count,
+                   const T2 maxvalue,
+                   const unsigned long planeSize = 0)
+      : DiParallelLoop(count),
+        Y(y), Cb(cb), Cr(cr),
+        Step(step),
+        R(r), G(g), B(b),
+        MaxValue(maxvalue),
+        PlaneSize(planeSize)
+    {
+    }
+
+ protected:
+
+    /// convert the given block of pixels
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        if (PlaneSize == 0)
+        {
+            DiColorKernels::convertYBRToRGB(Y + start * Step, Cb + start * Step, Cr + start * Step, Step,
+                R + start, G + start, B + start, end - start, MaxValue);
+        } else {
+            /* the block might span several frames, convert the part of each frame separately */
+            unsigned long i = start;
+            while (i < end)
+            {
+                const unsigned long pos = i % PlaneSize;
+                const unsigned long n = (PlaneSize - pos < end - i) ? PlaneSize - pos : end - i;
+                /* skip two planes per preceding frame */
+                const unsigned long input = i + 2 * PlaneSize * (i / PlaneSize);
+                DiColorKernels::convertYBRToRGB(Y + input, Cb + input, Cr + input, 1, R + i, G + i, B + i, n, MaxValue);
+                i += n;
+            }
+        }
+    }
+
+ private:
+
+    /// input values
+    const T1 *Y, *Cb, *Cr;
+    /// distance between two consecutive input values of a component
+    const unsigned long Step;
+    /// output values
+    T2 *R, *G, *B;
+    /// maximum output value
+    const T2 MaxValue;
+    /// number of pixels per plane of color-by-plane frames (0 = contiguous input)
+    const unsigned long PlaneSize;
+};
+
+
+/** Template class converting YCbCr 4:2:2 to RGB, possibly split into several blocks
+ *  processed in parallel (see DiParallelLoop)
+ */
+template<class T1, class T2>
+class DiColorYBR422Loop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor (see DiColorKernels::convertYBR422ToRGB() for details on the parameters)
+     */
+    DiColorYBR422Loop(const T1 *src,
+                      const T1 offset,
+                      T2 *r,
+                      T2 *g,
+                      T2 *b,
+                      const unsigned long pairs,
+                      const T2 maxvalue,
+                      const OFBool partial)
+      : DiParallelLoop(pairs, dcmRenderingMaxThreads.get(), MinimumBlockSize / 2),
+        Source(src),
+        Offset(offset),
+        R(r), G(g), B(b),
+        MaxValue(maxvalue),
+        Partial(partial)
+    {
+    }
+
+ protected:
+
+    /// convert the given block of pixel pairs
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        DiColorKernels::convertYBR422ToRGB(Source + 4 * start, Offset, R + 2 * start, G + 2 * start, B + 2 * start,
+            end - start, MaxValue, Partial);
+    }
+
+ private:
+
+    /// input values
+    const T1 *Source;
+    /// offset used to remove the sign of the input values
+    const T1 Offset;
+    /// output values
+    T2 *R, *G, *B;
+    /// maximum output value
+    const T2 MaxValue;
+    /// convert YCbCr partial if true
+    const OFBool Partial;
+};
+
+
+/** Template class separating color-by-pixel data into three planes, possibly split
+ *  into several blocks processed in parallel (see DiParallelLoop)
+ */
+template<class T1, class T2>
+class DiColorSplitLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor (see DiColorKernels::splitPlanes() for details on the parameters)
+     */
+    DiColorSplitLoop(const T1 *src,
+                     const T1 offset,
+                     T2 *dst0,
+                     T2 *dst1,
+                     T2 *dst2,
+                     const unsigned long count)
+      : DiParallelLoop(count),
+        Source(src),
+        Offset(offset),
+        Dest0(dst0), Dest1(dst1), Dest2(dst2)
+    {
+    }
+
+ protected:
+
+    /// separate the given block of pixels
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        DiColorKernels::splitPlanes(Source + 3 * start, Offset, Dest0 + start, Dest1 + start, Dest2 + start, end - start);
+    }
+
+ private:
+
+    /// input values
+    const T1 *Source;
+    /// offset used to remove the sign of the input values
+    const T1 Offset;
+    /// output values
+    T2 *Dest0, *Dest1, *Dest2;
+};
+
+
+/** Template class copying color-by-plane data of one or more frames (three planes per
+ *  frame) to three separate planes, possibly split into several blocks processed in
+ *  parallel (see DiParallelLoop). The frames are processed by a single loop, i.e. in
+ *  parallel.
+ */
+template<class T1, class T2>
+class DiColorPlanesLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  src        input values (color-by-plane)
+     *  @param  offset     offset used to remove the sign of the input values
+     *  @param  dst0       output values of the first plane
+     *  @param  dst1       output values of the second plane
+     *  @param  dst2       output values of the third plane
+     *  @param  count      number of pixels (of all frames)
+     *  @param  planeSize  number of pixels per plane
+     */
+    DiColorPlanesLoop(const T1 *src,
+                      const T1 offset,
+                      T2 *dst0,
+                      T2 *dst1,
+                      T2 *dst2,
+                      const unsigned long count,
+                      const unsigned long planeSize)
+      : DiParallelLoop(count),
+        Source(src),
+        Offset(offset),
+        Dest0(dst0), Dest1(dst1), Dest2(dst2),
+        Count(count),
+        PlaneSize(planeSize)
+    {
+    }
+
+ protected:
+
+    /// copy the given block of pixels
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        unsigned long i = start;
+        while (i < end)
+        {
+            const unsigned long pos = i % PlaneSize;
+            const unsigned long n = (PlaneSize - pos < end - i) ? PlaneSize - pos : end - i;
+            const unsigned long frameStart = i - pos;
+            /* the planes of an incomplete last frame are stored one after the other */
+            const unsigned long size = (Count - frameStart < PlaneSize) ? Count - frameStart : PlaneSize;
+            const T1 *p = Source + 3 * frameStart + pos;
+            copyPlane(p, Dest0 + i, n);
+            copyPlane(p + size, Dest1 + i, n);
+            copyPlane(p + 2 * size, Dest2 + i, n);
+            i += n;
+        }
+    }
+
+ private:
+
+    /// copy 'count' values of a plane and remove their sign
+    inline void copyPlane(const T1 *src,
+                          T2 *dst,
+                          const unsigned long count) const
+    {
+        for (unsigned long i = count; i != 0; --i)
+            *(dst++) = removeSign(*(src++), Offset);
+    }
+
+    /// input values
+    const T1 *Source;
+    /// offset used to remove the sign of the input values
+    const T1 Offset;
+    /// output values
+    T2 *Dest0, *Dest1, *Dest2;
+    /// number of pixels (of all frames)
+    const unsigned long Count;
+    /// number of pixels per plane
+    const unsigned long PlaneSize;
+};
+
+
+/** Template class interleaving three planes to color-by-pixel data, possibly split
+ *  into several blocks processed in parallel (see DiParallelLoop)
+ */
+template<class T1, class T2>
+class DiColorMergeLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor (see DiColorKernels::mergePlanes() for details on the parameters)
+     */
+    DiColorMergeLoop(const T1 *src0,
+                     const T1 *src1,
+                     const T1 *src2,
+                     T2 *dst,
+                     const unsigned long count,
+                     const OFBool inverse,
+                     const T2 maxvalue)
+      : DiParallelLoop(count),
+        Source0(src0), Source1(src1), Source2(src2),
+        Dest(dst),
+        Inverse(inverse),
+        MaxValue(maxvalue)
+    {
+    }
+
+ protected:
+
+    /// interleave the given block of pixels
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        DiColorKernels::mergePlanes(Source0 + start, Source1 + start, Source2 + start, Dest + 3 * start,
+            end - start, Inverse, MaxValue);
+    }
+
+ private:
+
+    /// input values
+    const T1 *Source0, *Source1, *Source2;
+    /// output values
+    T2 *Dest;
+    /// invert values if true
+    const OFBool Inverse;
+    /// maximum output value
+    const T2 MaxValue;
+};
+
+
+#endif
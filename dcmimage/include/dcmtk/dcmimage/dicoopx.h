@@ -54,13 +54,16 @@ class DCMTK_DCMIMAGE_EXPORT DiColorOutputPixel
 
     /** constructor
      *
-     ** @param  pixel  pointer to intermediate pixel representation
-     *  @param  size   number of pixel per frame
-     *  @param  frame  frame to be rendered
+     ** @param  pixel   pointer to intermediate pixel representation
+     *  @param  size    number of pixel per frame (or per strip of rows, see 'offset')
+     *  @param  frame   frame to be rendered
+     *  @param  offset  number of pixels to be skipped in addition to 'frame' * 'size'
+     *                  (optional, used to render a strip of rows of a frame)
      */
     DiColorOutputPixel(const DiPixel *pixel,
                        const unsigned long size,
-                       const unsigned long frame);
+                       const unsigned long frame,
+                       const unsigned long offset = 0);
 
     /** destructor
      */
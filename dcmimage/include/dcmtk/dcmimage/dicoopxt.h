@@ -27,6 +27,7 @@
 
 #include "dcmtk/dcmimage/dicoopx.h"
 #include "dcmtk/dcmimage/dicopx.h"
+#include "dcmtk/dcmimage/dicokrnl.h"
 #include "dcmtk/dcmimgle/dipxrept.h"
 
 #include "dcmtk/ofstd/ofbmanip.h"
@@ -56,6 +57,8 @@ class DiColorOutputPixelTemplate
      *  @param  bits2    bit depth of output data
      *  @param  planar   flag indicating whether data shall be stored color-by-pixel or color-by-plane
      *  @param  inverse  invert pixel data if true (0/0/0 = white)
+     *  @param  offset   number of pixels to be skipped in addition to 'frame' * 'count'
+     *                   (optional, used to render a strip of rows, 'count' is the size of the strip then)
      */
     DiColorOutputPixelTemplate(void *buffer,
                                const DiColorPixel *pixel,
@@ -64,8 +67,9 @@ class DiColorOutputPixelTemplate
                                const int bits1, /* input depth */
                                const int bits2, /* output depth */
                                const int planar,
-                               const int inverse)
-      : DiColorOutputPixel(pixel, count, frame),
+                               const int inverse,
+                               const unsigned long offset = 0)
+      : DiColorOutputPixel(pixel, count, frame, offset),
         Data(NULL),
         DeleteData(buffer == NULL),
         isPlanar(planar)
@@ -73,7 +77,7 @@ class DiColorOutputPixelTemplate
         if ((pixel != NULL) && (Count > 0) && (FrameSize >= Count))
         {
             Data = OFstatic_cast(T2 *, buffer);
-            convert(OFstatic_cast(const T1 **, OFconst_cast(void *, pixel->getData())), frame * FrameSize, bits1, bits2, planar, inverse);
+            convert(OFstatic_cast(const T1 **, OFconst_cast(void *, pixel->getData())), frame * FrameSize + offset, bits1, bits2, planar, inverse);
         }
     }
 
@@ -335,17 +339,10 @@ class DiColorOutputPixelTemplate
                     register int j;
                     if (bits1 == bits2)
                     {
-                        /* invert output data */
-                        if (inverse)
-                        {
-                            for (i = start; i < start + Count; ++i)
-                                for (j = 0; j < 3; ++j)                         // copy inverted data
-                                    *(q++) = max2 - OFstatic_cast(T2, pixel[j][i]);
-                        } else {
-                            for (i = start; i < start + Count; ++i)
-                                for (j = 0; j < 3; ++j)                         // copy
-                                    *(q++) = OFstatic_cast(T2, pixel[j][i]);
-                        }
+                        /* interleave planes, invert output data if required (vectorized for 8 bit, see DiColorKernels) */
+                        DiColorMergeLoop<T1, T2> loop(pixel[0] + start, pixel[1] + start, pixel[2] + start, q, Count,
+                            inverse != 0, max2);
+                        loop.run();
                     }
                     else if (bits1 < bits2)                                     // optimization possible using LUT
                     {
@@ -27,6 +27,7 @@
 
 #include "dcmtk/dcmimage/dicopxt.h"
 #include "dcmtk/dcmimgle/diluptab.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
 #include "dcmtk/dcmimgle/diinpx.h"  /* gcc 3.4 needs this */
 
 
@@ -64,7 +65,8 @@ class DiPalettePixelTemplate
                 DCMIMAGE_ERROR("invalid value for 'PlanarConfiguration' (" << this->PlanarConfiguration << ")");
             }
             else
-                convert(OFstatic_cast(const T1 *, pixel->getData()) + pixel->getPixelStart(), palette);
+                convert(OFstatic_cast(const T1 *, pixel->getData()) + pixel->getPixelStart(), palette,
+                    pixel->getAbsMinimum(), OFstatic_cast(unsigned long, pixel->getAbsMaxRange()));
         }
     }
 
@@ -79,12 +81,16 @@ class DiPalettePixelTemplate
 
     /** convert input pixel data to intermediate representation
      *
-     ** @param  pixel    pointer to input pixel data
-     *  @param  palette  pointer to RGB color palette
+     ** @param  pixel        pointer to input pixel data
+     *  @param  palette      pointer to RGB color palette
+     *  @param  absMinimum   smallest possible input value
+     *  @param  absMaxRange  number of possible input values
      */
     void convert(const T1 *pixel,
-                 DiLookupTable *palette[3])
-    {                                                                // can be optimized if necessary !
+                 DiLookupTable *palette[3],
+                 const double absMinimum,
+                 const unsigned long absMaxRange)
+    {
         if (this->Init(pixel))
         {
             register const T1 *p = pixel;
@@ -94,17 +100,45 @@ class DiPalettePixelTemplate
             // use the number of input pixels derived from the length of the 'PixelData'
             // attribute), but not more than the size of the intermediate buffer
             const unsigned long count = (this->InputCount < this->Count) ? this->InputCount : this->Count;
-            for (i = 0; i < count; ++i)
-            {
-                value = OFstatic_cast(T2, *(p++));
+            T3 *lut = NULL;
+            if ((sizeof(T1) <= 2) && (count > 3 * absMaxRange))               // optimization criteria
+                lut = new T3[absMaxRange + 4];                                // padding required by DiMonoKernels::applyLUT()
+            if (lut != NULL)
+            {                                                                 // use LUT for optimization
+                DCMIMAGE_DEBUG("using optimized routine with additional LUT");
+                const T2 absmin = OFstatic_cast(T2, absMinimum);
                 for (j = 0; j < 3; ++j)
                 {
-                    if (value <= palette[j]->getFirstEntry(value))
-                        this->Data[j][i] = OFstatic_cast(T3, palette[j]->getFirstValue());
-                    else if (value >= palette[j]->getLastEntry(value))
-                        this->Data[j][i] = OFstatic_cast(T3, palette[j]->getLastValue());
-                    else
-                        this->Data[j][i] = OFstatic_cast(T3, palette[j]->getValue(value));
+                    register T3 *q = lut;
+                    for (i = 0; i < absMaxRange; ++i)                         // calculating LUT entries
+                    {
+                        value = OFstatic_cast(T2, i) + absmin;
+                        if (value <= palette[j]->getFirstEntry(value))
+                            *(q++) = OFstatic_cast(T3, palette[j]->getFirstValue());
+                        else if (value >= palette[j]->getLastEntry(value))
+                            *(q++) = OFstatic_cast(T3, palette[j]->getLastValue());
+                        else
+                            *(q++) = OFstatic_cast(T3, palette[j]->getValue(value));
+                    }
+                    for (i = 0; i < 4; ++i)
+                        *(q++) = 0;
+                    const T3 *lut0 = lut - absmin;                            // points to 'zero' entry
+                    DiMonoLUTLoop<T1, T3>(p, this->Data[j], count, lut0).run();  // apply LUT (vectorized for 16 bit)
+                }
+                delete[] lut;
+            } else {
+                for (i = 0; i < count; ++i)
+                {
+                    value = OFstatic_cast(T2, *(p++));
+                    for (j = 0; j < 3; ++j)
+                    {
+                        if (value <= palette[j]->getFirstEntry(value))
+                            this->Data[j][i] = OFstatic_cast(T3, palette[j]->getFirstValue());
+                        else if (value >= palette[j]->getLastEntry(value))
+                            this->Data[j][i] = OFstatic_cast(T3, palette[j]->getLastValue());
+                        else
+                            this->Data[j][i] = OFstatic_cast(T3, palette[j]->getValue(value));
+                    }
                 }
             }
         }
@@ -26,6 +26,7 @@
 #include "dcmtk/config/osconfig.h"
 
 #include "dcmtk/dcmimage/dicopxt.h"
+#include "dcmtk/dcmimage/dicokrnl.h"
 #include "dcmtk/dcmimgle/diinpx.h"  /* gcc 3.4 needs this */
 
 
@@ -103,28 +104,15 @@ class DiRGBPixelTemplate
                     p += skip;
                 }
 */
-                register unsigned long l;
-                register unsigned long i = 0;
-                while (i < count)
-                {
-                    /* store current pixel index */
-                    const unsigned long iStart = i;
-                    /* for all planes ... */
-                    for (int j = 0; j < 3; ++j)
-                    {
-                        /* convert a single plane */
-                        for (l = planeSize, i = iStart; (l != 0) && (i < count); --l, ++i)
-                            this->Data[j][i] = removeSign(*(p++), offset);
-                    }
-                }
+                /* copy planes, all frames are processed by a single loop, i.e. in parallel */
+                DiColorPlanesLoop<T1, T2> loop(p, offset, this->Data[0], this->Data[1], this->Data[2], count, planeSize);
+                loop.run();
             }
             else
             {
-                register int j;
-                register unsigned long i;
-                for (i = 0; i < count; ++i)                             /* for all pixel ... */
-                    for (j = 0; j < 3; ++j)
-                        this->Data[j][i] = removeSign(*(p++), offset);  /* ... copy planes */
+                /* separate planes (vectorized for 8 bit, see DiColorKernels) */
+                DiColorSplitLoop<T1, T2> loop(p, offset, this->Data[0], this->Data[1], this->Data[2], count);
+                loop.run();
             }
         }
     }
@@ -26,6 +26,7 @@
 #include "dcmtk/config/osconfig.h"
 
 #include "dcmtk/dcmimage/dicopxt.h"
+#include "dcmtk/dcmimage/dicokrnl.h"
 #include "dcmtk/dcmimgle/diinpx.h"  /* gcc 3.4 needs this */
 
 
@@ -99,81 +100,17 @@ class DiYBRPixelTemplate
                 DiPixelRepresentationTemplate<T1> rep;
                 if (bits == 8 && !rep.isSigned())          // only for unsigned 8 bit
                 {
-                    Sint16 rcr_tab[256];
-                    Sint16 gcb_tab[256];
-                    Sint16 gcr_tab[256];
-                    Sint16 bcb_tab[256];
-                    const double r_const = 0.7010 * OFstatic_cast(double, maxvalue);
-                    const double g_const = 0.5291 * OFstatic_cast(double, maxvalue);
-                    const double b_const = 0.8859 * OFstatic_cast(double, maxvalue);
-                    register unsigned long l;
-                    for (l = 0; l < 256; ++l)
-                    {
-                        rcr_tab[l] = OFstatic_cast(Sint16, 1.4020 * OFstatic_cast(double, l) - r_const);
-                        gcb_tab[l] = OFstatic_cast(Sint16, 0.3441 * OFstatic_cast(double, l));
-                        gcr_tab[l] = OFstatic_cast(Sint16, 0.7141 * OFstatic_cast(double, l) - g_const);
-                        bcb_tab[l] = OFstatic_cast(Sint16, 1.7720 * OFstatic_cast(double, l) - b_const);
-                    }
-                    register Sint32 sr;
-                    register Sint32 sg;
-                    register Sint32 sb;
+                    /* integer tables and (if supported) vectorized version, see DiColorKernels */
                     if (this->PlanarConfiguration)
                     {
-/*
-                        register const T1 *y = pixel;
-                        register const T1 *cb = y + this->InputCount;
-                        register const T1 *cr = cb + this->InputCount;
-                        for (i = count; i != 0; --i, ++y, ++cb, ++cr)
-                        {
-                            sr = OFstatic_cast(Sint32, *y) + OFstatic_cast(Sint32, rcr_tab[*cr]);
-                            sg = OFstatic_cast(Sint32, *y) - OFstatic_cast(Sint32, gcb_tab[*cb]) - OFstatic_cast(Sint32, gcr_tab[*cr]);
-                            sb = OFstatic_cast(Sint32, *y) + OFstatic_cast(Sint32, bcb_tab[*cb]);
-                            *(r++) = (sr < 0) ? 0 : (sr > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sr);
-                            *(g++) = (sg < 0) ? 0 : (sg > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sg);
-                            *(b++) = (sb < 0) ? 0 : (sb > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sb);
-                        }
-*/
-                        register const T1 *y = pixel;
-                        register const T1 *cb = y + planeSize;
-                        register const T1 *cr = cb + planeSize;
-                        register unsigned long i = count;
-                        while (i != 0)
-                        {
-                            /* convert a single frame */
-                            for (l = planeSize; (l != 0) && (i != 0); --l, --i, ++y, ++cb, ++cr)
-                            {
-                                sr = OFstatic_cast(Sint32, *y) + OFstatic_cast(Sint32, rcr_tab[OFstatic_cast(Uint32, *cr)]);
-                                sg = OFstatic_cast(Sint32, *y) - OFstatic_cast(Sint32, gcb_tab[OFstatic_cast(Uint32, *cb)]) - OFstatic_cast(Sint32, gcr_tab[OFstatic_cast(Uint32, *cr)]);
-                                sb = OFstatic_cast(Sint32, *y) + OFstatic_cast(Sint32, bcb_tab[OFstatic_cast(Uint32, *cb)]);
-                                *(r++) = (sr < 0) ? 0 : (sr > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sr);
-                                *(g++) = (sg < 0) ? 0 : (sg > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sg);
-                                *(b++) = (sb < 0) ? 0 : (sb > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sb);
-                            }
-                            /* jump to next frame start (skip 2 planes) */
-                            y += 2 * planeSize;
-                            cb += 2 * planeSize;
-                            cr += 2 * planeSize;
-                        }
+                        /* all frames are converted by a single loop, i.e. in parallel */
+                        DiColorYBRLoop<T1, T2> loop(pixel, pixel + planeSize, pixel + 2 * planeSize, 1, r, g, b, count, maxvalue, planeSize);
+                        loop.run();
                     }
                     else
                     {
-                        register const T1 *p = pixel;
-                        register T1 y;
-                        register T1 cb;
-                        register T1 cr;
-                        register unsigned long i;
-                        for (i = count; i != 0; --i)
-                        {
-                            y  = *(p++);
-                            cb = *(p++);
-                            cr = *(p++);
-                            sr = OFstatic_cast(Sint32, y) + OFstatic_cast(Sint32, rcr_tab[OFstatic_cast(Uint32, cr)]);
-                            sg = OFstatic_cast(Sint32, y) - OFstatic_cast(Sint32, gcb_tab[OFstatic_cast(Uint32, cb)]) - OFstatic_cast(Sint32, gcr_tab[OFstatic_cast(Uint32, cr)]);
-                            sb = OFstatic_cast(Sint32, y) + OFstatic_cast(Sint32, bcb_tab[OFstatic_cast(Uint32, cb)]);
-                            *(r++) = (sr < 0) ? 0 : (sr > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sr);
-                            *(g++) = (sg < 0) ? 0 : (sg > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sg);
-                            *(b++) = (sb < 0) ? 0 : (sb > OFstatic_cast(Sint32, maxvalue)) ? maxvalue : OFstatic_cast(T2, sb);
-                        }
+                        DiColorYBRLoop<T1, T2> loop(pixel, pixel + 1, pixel + 2, 3, r, g, b, count, maxvalue);
+                        loop.run();
                     }
                 }
                 else
@@ -241,27 +178,15 @@ class DiYBRPixelTemplate
                         p += skip;
                     }
 */
-                    register unsigned long l;
-                    register unsigned long i = 0;
-                    while (i < count)
-                    {
-                        /* store current pixel index */
-                        const unsigned long iStart = i;
-                        for (int j = 0; j < 3; ++j)
-                        {
-                            /* convert a single plane */
-                            for (l = planeSize, i = iStart; (l != 0) && (i < count); --l, ++i)
-                                this->Data[j][i] = removeSign(*(p++), offset);
-                        }
-                    }
+                    /* copy planes, all frames are processed by a single loop, i.e. in parallel */
+                    DiColorPlanesLoop<T1, T2> loop(p, offset, this->Data[0], this->Data[1], this->Data[2], count, planeSize);
+                    loop.run();
                 }
                 else
                 {
-                    register int j;
-                    register unsigned long i;
-                    for (i = 0; i < count; ++i)                             /* for all pixel ... */
-                        for (j = 0; j < 3; ++j)
-                            this->Data[j][i] = removeSign(*(p++), offset);  /* ... copy planes */
+                    /* separate planes (vectorized for 8 bit, see DiColorKernels) */
+                    DiColorSplitLoop<T1, T2> loop(p, offset, this->Data[0], this->Data[1], this->Data[2], count);
+                    loop.run();
                 }
             }
         }
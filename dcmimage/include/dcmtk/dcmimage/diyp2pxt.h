@@ -26,6 +26,7 @@
 #include "dcmtk/config/osconfig.h"
 
 #include "dcmtk/dcmimage/dicopxt.h"
+#include "dcmtk/dcmimage/dicokrnl.h"
 #include "dcmtk/dcmimgle/diinpx.h"  /* gcc 3.4 needs this */
 
 
@@ -86,50 +87,17 @@ class DiYBRPart422PixelTemplate
     {
         if (this->Init(pixel))
         {
-            register T2 *r = this->Data[0];
-            register T2 *g = this->Data[1];
-            register T2 *b = this->Data[2];
-            register unsigned long i;
             const T2 maxvalue = OFstatic_cast(T2, DicomImageClass::maxval(bits));
             const T1 offset = OFstatic_cast(T1, DicomImageClass::maxval(bits - 1));
             // use the number of input pixels derived from the length of the 'PixelData'
             // attribute), but not more than the size of the intermediate buffer
             const unsigned long count = (this->InputCount < this->Count) ? this->InputCount : this->Count;
-
-            register const T1 *p = pixel;
-            register T2 y1;
-            register T2 y2;
-            register T2 cb;
-            register T2 cr;
-            for (i = count / 2; i != 0; --i)
-            {
-                y1 = removeSign(*(p++), offset);
-                y2 = removeSign(*(p++), offset);
-                cb = removeSign(*(p++), offset);
-                cr = removeSign(*(p++), offset);
-                convertValue(*(r++), *(g++), *(b++), y1, cb, cr, maxvalue);
-                convertValue(*(r++), *(g++), *(b++), y2, cb, cr, maxvalue);
-            }
+            /* vectorized for 8 bit (if supported), see DiColorKernels */
+            DiColorYBR422Loop<T1, T2> loop(pixel, offset, this->Data[0], this->Data[1], this->Data[2], count / 2,
+                maxvalue, OFTrue /*partial*/);
+            loop.run();
         }
     }
-
-    /** convert a single YCbCr value to RGB
-     */
-    inline void convertValue(T2 &red,
-                             T2 &green,
-                             T2 &blue,
-                             const T2 y,
-                             const T2 cb,
-                             const T2 cr,
-                             const T2 maxvalue)
-    {
-        double dr = 1.1631 * OFstatic_cast(double, y) + 1.5969 * OFstatic_cast(double, cr) - 0.8713 * OFstatic_cast(double, maxvalue);
-        double dg = 1.1631 * OFstatic_cast(double, y) - 0.3913 * OFstatic_cast(double, cb) - 0.8121 * OFstatic_cast(double, cr) + 0.5290 * OFstatic_cast(double, maxvalue);
-        double db = 1.1631 * OFstatic_cast(double, y) + 2.0177 * OFstatic_cast(double, cb) - 1.0820 * OFstatic_cast(double, maxvalue);
-        red   = (dr < 0.0) ? 0 : (dr > OFstatic_cast(double, maxvalue)) ? maxvalue : OFstatic_cast(T2, dr);
-        green = (dg < 0.0) ? 0 : (dg > OFstatic_cast(double, maxvalue)) ? maxvalue : OFstatic_cast(T2, dg);
-        blue  = (db < 0.0) ? 0 : (db > OFstatic_cast(double, maxvalue)) ? maxvalue : OFstatic_cast(T2, db);
-    }
 };
 
 
@@ -272,53 +272,80 @@ int DiColorImage::getOutputData(void *buffer,
 }
 
 
+int DiColorImage::getOutputRows(void *buffer,
+                                const unsigned long size,
+                                const unsigned long frame,
+                                const int bits,
+                                const unsigned long firstRow,
+                                const unsigned long rowCount,
+                                const int planar,
+                                DiMonoOutputLUT * /*sharedLUT*/)
+{
+    int result = 0;
+    if ((rowCount > 0) && (firstRow + rowCount <= Rows))
+    {
+        result = (getData(buffer, size, frame, bits, planar, firstRow, rowCount) != NULL);
+        /* output data only refer to the given buffer */
+        deleteOutputData();
+    }
+    return result;
+}
+
+
 const void *DiColorImage::getData(void *buffer,
                                   const unsigned long size,
                                   const unsigned long frame,
                                   const int bits,
-                                  const int planar)
+                                  const int planar,
+                                  const unsigned long firstRow,
+                                  const unsigned long rowCount)
 {
-    if ((InterData != NULL) && (ImageStatus == EIS_Normal) && (frame < NumberOfFrames) && (bits > 0) && (bits <= MAX_BITS))
+    if ((InterData != NULL) && (ImageStatus == EIS_Normal) && (frame < NumberOfFrames) && (firstRow < Rows) &&
+        (bits > 0) && (bits <= MAX_BITS))
     {
-        if ((buffer == NULL) || (size >= getOutputDataSize(bits)))
+        /* number of rows to be rendered */
+        const unsigned long rows = ((rowCount > 0) && (firstRow + rowCount < Rows)) ? rowCount : Rows - firstRow;
+        if ((buffer == NULL) || (size >= getOutputDataSize(bits) / Rows * rows))
         {
             deleteOutputData();                             // delete old image data
-            const unsigned long count = OFstatic_cast(unsigned long, Columns) * OFstatic_cast(unsigned long, Rows);
+            const unsigned long count = OFstatic_cast(unsigned long, Columns) * rows;
+            /* index of the first pixel to be rendered */
+            const unsigned long start = OFstatic_cast(unsigned long, Columns) * (frame * OFstatic_cast(unsigned long, Rows) + firstRow);
             const int inverse = (Polarity == EPP_Reverse);
             switch (InterData->getRepresentation())
             {
                 case EPR_Uint8:
                     if (bits <= 8)
-                        OutputData = new DiColorOutputPixelTemplate<Uint8, Uint8>(buffer, InterData, count, frame,
-                            getBits(), bits, planar, inverse);
+                        OutputData = new DiColorOutputPixelTemplate<Uint8, Uint8>(buffer, InterData, count, 0 /*frame*/,
+                            getBits(), bits, planar, inverse, start);
                     else if (bits <= 16)
-                        OutputData = new DiColorOutputPixelTemplate<Uint8, Uint16>(buffer, InterData, count, frame,
-                            getBits(), bits, planar, inverse);
+                        OutputData = new DiColorOutputPixelTemplate<Uint8, Uint16>(buffer, InterData, count, 0 /*frame*/,
+                            getBits(), bits, planar, inverse, start);
                     else
-                        OutputData = new DiColorOutputPixelTemplate<Uint8, Uint32>(buffer, InterData, count, frame,
-                            getBits(), bits, planar, inverse);
+                        OutputData = new DiColorOutputPixelTemplate<Uint8, Uint32>(buffer, InterData, count, 0 /*frame*/,
+                            getBits(), bits, planar, inverse, start);
                     break;
                 case EPR_Uint16:
                     if (bits <= 8)
-                        OutputData = new DiColorOutputPixelTemplate<Uint16, Uint8>(buffer, InterData, count, frame,
-                            getBits(), bits, planar, inverse);
+                        OutputData = new DiColorOutputPixelTemplate<Uint16, Uint8>(buffer, InterData, count, 0 /*frame*/,
+                            getBits(), bits, planar, inverse, start);
                     else if (bits <= 16)
-                        OutputData = new DiColorOutputPixelTemplate<Uint16, Uint16>(buffer, InterData, count, frame,
-                            getBits(), bits, planar, inverse);
+                        OutputData = new DiColorOutputPixelTemplate<Uint16, Uint16>(buffer, InterData, count, 0 /*frame*/,
+                            getBits(), bits, planar, inverse, start);
                     else
-                        OutputData = new DiColorOutputPixelTemplate<Uint16, Uint32>(buffer, InterData, count, frame,
-                            getBits(), bits, planar, inverse);
+                        OutputData = new DiColorOutputPixelTemplate<Uint16, Uint32>(buffer, InterData, count, 0 /*frame*/,
+                            getBits(), bits, planar, inverse, start);
                     break;
                 case EPR_Uint32:
                     if (bits <= 8)
-                        OutputData = new DiColorOutputPixelTemplate<Uint32, Uint8>(buffer, InterData, count, frame,
-                            getBits(), bits, planar, inverse);
+                        OutputData = new DiColorOutputPixelTemplate<Uint32, Uint8>(buffer, InterData, count, 0 /*frame*/,
+                            getBits(), bits, planar, inverse, start);
                     else if (bits <= 16)
-                        OutputData = new DiColorOutputPixelTemplate<Uint32, Uint16>(buffer, InterData, count, frame,
-                            getBits(), bits, planar, inverse);
+                        OutputData = new DiColorOutputPixelTemplate<Uint32, Uint16>(buffer, InterData, count, 0 /*frame*/,
+                            getBits(), bits, planar, inverse, start);
                     else
-                        OutputData = new DiColorOutputPixelTemplate<Uint32, Uint32>(buffer, InterData, count, frame,
-                            getBits(), bits, planar, inverse);
+                        OutputData = new DiColorOutputPixelTemplate<Uint32, Uint32>(buffer, InterData, count, 0 /*frame*/,
+                            getBits(), bits, planar, inverse, start);
                     break;
                 default:
                     DCMIMAGE_WARN("invalid value for inter-representation");
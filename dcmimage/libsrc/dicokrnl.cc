@@ -0,0 +1,541 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimage
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomColorKernels (Source)
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/dcmimage/dicokrnl.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
+
+/* vectorized kernels are only available for x86 with a compiler supporting function
+ * specific target attributes, the instruction set is selected at runtime
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define DICOKRNL_X86
+#define DICOKRNL_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#endif
+
+
+/*--------------------*
+ *  static functions  *
+ *--------------------*/
+
+#ifdef DICOKRNL_X86
+
+/* constant factors of the YCbCr (full) to RGB conversion in single precision, which
+ * reproduce the integer tables created by DiColorKernels::createYBRTables() exactly
+ * for the given maximum value (checked by the constructor)
+ */
+struct YBRFactors
+{
+    YBRFactors(const Uint8 maxvalue)
+      : RConst(OFstatic_cast(float, 0.7010 * OFstatic_cast(double, maxvalue))),
+        GConst(OFstatic_cast(float, 0.5291 * OFstatic_cast(double, maxvalue))),
+        BConst(OFstatic_cast(float, 0.8859 * OFstatic_cast(double, maxvalue))),
+        Valid(OFTrue)
+    {
+        Sint16 rcr_tab[256];
+        Sint16 gcb_tab[256];
+        Sint16 gcr_tab[256];
+        Sint16 bcb_tab[256];
+        DiColorKernels::createYBRTables(rcr_tab, gcb_tab, gcr_tab, bcb_tab, OFstatic_cast(double, maxvalue));
+        for (int l = 0; Valid && (l < 256); ++l)
+        {
+            /* same operations as in the vectorized versions */
+            volatile float f = OFstatic_cast(float, l);
+            Valid = (OFstatic_cast(int, 1.4020f * f - RConst) == rcr_tab[l]) &&
+                    (OFstatic_cast(int, 0.3441f * f) == gcb_tab[l]) &&
+                    (OFstatic_cast(int, 0.7141f * f - GConst) == gcr_tab[l]) &&
+                    (OFstatic_cast(int, 1.7720f * f - BConst) == bcb_tab[l]);
+        }
+    }
+
+    float RConst;
+    float GConst;
+    float BConst;
+    OFBool Valid;
+};
+
+
+/* SSE4.1: separate 48 bytes of color-by-pixel data into three planes of 16 bytes each
+ */
+DICOKRNL_TARGET("sse4.1")
+static inline void deinterleave3_SSE41(const Uint8 *src,
+                                       __m128i &v0,
+                                       __m128i &v1,
+                                       __m128i &v2)
+{
+    const __m128i a = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, src));
+    const __m128i b = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, src + 16));
+    const __m128i c = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, src + 32));
+    /* an index of -1 results in a zero byte */
+    v0 = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(a, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(c, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+    v1 = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(a, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(c, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+    v2 = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(a, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(c, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+}
+
+
+/* SSE4.1: interleave three planes of 16 bytes each to 48 bytes of color-by-pixel data
+ */
+DICOKRNL_TARGET("sse4.1")
+static inline void interleave3_SSE41(const __m128i v0,
+                                     const __m128i v1,
+                                     const __m128i v2,
+                                     Uint8 *dst)
+{
+    const __m128i a = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(v0, _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5)),
+        _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1))),
+        _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1)));
+    const __m128i b = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(v0, _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1)),
+        _mm_shuffle_epi8(v1, _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10))),
+        _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1)));
+    const __m128i c = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(v0, _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1)),
+        _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1))),
+        _mm_shuffle_epi8(v2, _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15)));
+    _mm_storeu_si128(OFreinterpret_cast(__m128i *, dst), a);
+    _mm_storeu_si128(OFreinterpret_cast(__m128i *, dst + 16), b);
+    _mm_storeu_si128(OFreinterpret_cast(__m128i *, dst + 32), c);
+}
+
+
+/* SSE4.1: separate color-by-pixel data into three planes, 16 pixels per iteration
+ */
+DICOKRNL_TARGET("sse4.1")
+static unsigned long splitPlanes_SSE41(const Uint8 *src,
+                                       Uint8 *dst0,
+                                       Uint8 *dst1,
+                                       Uint8 *dst2,
+                                       const unsigned long count)
+{
+    __m128i v0, v1, v2;
+    unsigned long i = 0;
+    for (; i + 16 <= count; i += 16, src += 48)
+    {
+        deinterleave3_SSE41(src, v0, v1, v2);
+        _mm_storeu_si128(OFreinterpret_cast(__m128i *, dst0 + i), v0);
+        _mm_storeu_si128(OFreinterpret_cast(__m128i *, dst1 + i), v1);
+        _mm_storeu_si128(OFreinterpret_cast(__m128i *, dst2 + i), v2);
+    }
+    return i;
+}
+
+
+/* SSE4.1: interleave three planes to color-by-pixel data, 16 pixels per iteration
+ */
+DICOKRNL_TARGET("sse4.1")
+static unsigned long mergePlanes_SSE41(const Uint8 *src0,
+                                       const Uint8 *src1,
+                                       const Uint8 *src2,
+                                       Uint8 *dst,
+                                       const unsigned long count,
+                                       const OFBool inverse,
+                                       const Uint8 maxvalue)
+{
+    const __m128i max = _mm_set1_epi8(OFstatic_cast(char, maxvalue));
+    unsigned long i = 0;
+    for (; i + 16 <= count; i += 16, dst += 48)
+    {
+        __m128i v0 = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, src0 + i));
+        __m128i v1 = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, src1 + i));
+        __m128i v2 = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, src2 + i));
+        if (inverse)
+        {
+            /* wraps around like the generic version */
+            v0 = _mm_sub_epi8(max, v0);
+            v1 = _mm_sub_epi8(max, v1);
+            v2 = _mm_sub_epi8(max, v2);
+        }
+        interleave3_SSE41(v0, v1, v2, dst);
+    }
+    return i;
+}
+
+
+/* SSE4.1: convert 4 YCbCr (full) values (given as 32 bit integers) to RGB, the results
+ * are 32 bit integers which still have to be clipped
+ */
+DICOKRNL_TARGET("sse4.1")
+static inline void ybr4_SSE41(const __m128i y,
+                              const __m128i cb,
+                              const __m128i cr,
+                              const YBRFactors &factors,
+                              __m128i &r,
+                              __m128i &g,
+                              __m128i &b)
+{
+    const __m128 fcb = _mm_cvtepi32_ps(cb);
+    const __m128 fcr = _mm_cvtepi32_ps(cr);
+    /* the truncated terms correspond to the entries of the integer tables */
+    const __m128i rcr = _mm_cvttps_epi32(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.4020f), fcr), _mm_set1_ps(factors.RConst)));
+    const __m128i gcb = _mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(0.3441f), fcb));
+    const __m128i gcr = _mm_cvttps_epi32(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(0.7141f), fcr), _mm_set1_ps(factors.GConst)));
+    const __m128i bcb = _mm_cvttps_epi32(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.7720f), fcb), _mm_set1_ps(factors.BConst)));
+    r = _mm_add_epi32(y, rcr);
+    g = _mm_sub_epi32(_mm_sub_epi32(y, gcb), gcr);
+    b = _mm_add_epi32(y, bcb);
+}
+
+
+/* SSE4.1: convert 16 YCbCr (full) values to RGB by means of the integer table semantics
+ */
+DICOKRNL_TARGET("sse4.1")
+static inline void ybr16_SSE41(const __m128i y,
+                               const __m128i cb,
+                               const __m128i cr,
+                               const YBRFactors &factors,
+                               const __m128i max,
+                               Uint8 *r,
+                               Uint8 *g,
+                               Uint8 *b)
+{
+    __m128i rv[4], gv[4], bv[4];
+    ybr4_SSE41(_mm_cvtepu8_epi32(y), _mm_cvtepu8_epi32(cb), _mm_cvtepu8_epi32(cr), factors, rv[0], gv[0], bv[0]);
+    ybr4_SSE41(_mm_cvtepu8_epi32(_mm_srli_si128(y, 4)), _mm_cvtepu8_epi32(_mm_srli_si128(cb, 4)),
+        _mm_cvtepu8_epi32(_mm_srli_si128(cr, 4)), factors, rv[1], gv[1], bv[1]);
+    ybr4_SSE41(_mm_cvtepu8_epi32(_mm_srli_si128(y, 8)), _mm_cvtepu8_epi32(_mm_srli_si128(cb, 8)),
+        _mm_cvtepu8_epi32(_mm_srli_si128(cr, 8)), factors, rv[2], gv[2], bv[2]);
+    ybr4_SSE41(_mm_cvtepu8_epi32(_mm_srli_si128(y, 12)), _mm_cvtepu8_epi32(_mm_srli_si128(cb, 12)),
+        _mm_cvtepu8_epi32(_mm_srli_si128(cr, 12)), factors, rv[3], gv[3], bv[3]);
+    /* saturating pack clips to 0..255, the remaining upper limit is the maximum value */
+    _mm_storeu_si128(OFreinterpret_cast(__m128i *, r), _mm_min_epu8(max,
+        _mm_packus_epi16(_mm_packs_epi32(rv[0], rv[1]), _mm_packs_epi32(rv[2], rv[3]))));
+    _mm_storeu_si128(OFreinterpret_cast(__m128i *, g), _mm_min_epu8(max,
+        _mm_packus_epi16(_mm_packs_epi32(gv[0], gv[1]), _mm_packs_epi32(gv[2], gv[3]))));
+    _mm_storeu_si128(OFreinterpret_cast(__m128i *, b), _mm_min_epu8(max,
+        _mm_packus_epi16(_mm_packs_epi32(bv[0], bv[1]), _mm_packs_epi32(bv[2], bv[3]))));
+}
+
+
+/* SSE4.1: convert YCbCr (full) to RGB, 16 pixels per iteration
+ */
+DICOKRNL_TARGET("sse4.1")
+static unsigned long convertYBRToRGB_SSE41(const Uint8 *y,
+                                           const Uint8 *cb,
+                                           const Uint8 *cr,
+                                           const unsigned long step,
+                                           Uint8 *r,
+                                           Uint8 *g,
+                                           Uint8 *b,
+                                           const unsigned long count,
+                                           const YBRFactors &factors,
+                                           const Uint8 maxvalue)
+{
+    const __m128i max = _mm_set1_epi8(OFstatic_cast(char, maxvalue));
+    __m128i vy, vcb, vcr;
+    unsigned long i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        if (step == 3)
+        {
+            /* color-by-pixel: the three pointers refer to consecutive bytes */
+            deinterleave3_SSE41(y + 3 * i, vy, vcb, vcr);
+        } else {
+            vy = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, y + i));
+            vcb = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, cb + i));
+            vcr = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, cr + i));
+        }
+        ybr16_SSE41(vy, vcb, vcr, factors, max, r + i, g + i, b + i);
+    }
+    return i;
+}
+
+
+/* AVX2: convert 8 YCbCr (full) values (given as 32 bit integers) to RGB, the results
+ * are 32 bit integers which still have to be clipped
+ */
+DICOKRNL_TARGET("avx2")
+static inline void ybr8_AVX2(const __m256i y,
+                             const __m256i cb,
+                             const __m256i cr,
+                             const YBRFactors &factors,
+                             __m256i &r,
+                             __m256i &g,
+                             __m256i &b)
+{
+    const __m256 fcb = _mm256_cvtepi32_ps(cb);
+    const __m256 fcr = _mm256_cvtepi32_ps(cr);
+    const __m256i rcr = _mm256_cvttps_epi32(_mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(1.4020f), fcr), _mm256_set1_ps(factors.RConst)));
+    const __m256i gcb = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_set1_ps(0.3441f), fcb));
+    const __m256i gcr = _mm256_cvttps_epi32(_mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(0.7141f), fcr), _mm256_set1_ps(factors.GConst)));
+    const __m256i bcb = _mm256_cvttps_epi32(_mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(1.7720f), fcb), _mm256_set1_ps(factors.BConst)));
+    r = _mm256_add_epi32(y, rcr);
+    g = _mm256_sub_epi32(_mm256_sub_epi32(y, gcb), gcr);
+    b = _mm256_add_epi32(y, bcb);
+}
+
+
+/* AVX2: pack 16 values (32 bit integers) to 8 bit, clip to 0..maxvalue and store them
+ */
+DICOKRNL_TARGET("avx2")
+static inline void pack16_AVX2(const __m256i v0,
+                               const __m256i v1,
+                               const __m128i max,
+                               Uint8 *dst)
+{
+    /* restore the order of the 128 bit lanes after packing */
+    const __m256i w = _mm256_permute4x64_epi64(_mm256_packs_epi32(v0, v1), 0xd8);
+    _mm_storeu_si128(OFreinterpret_cast(__m128i *, dst), _mm_min_epu8(max,
+        _mm_packus_epi16(_mm256_castsi256_si128(w), _mm256_extracti128_si256(w, 1))));
+}
+
+
+/* AVX2: convert YCbCr (full) to RGB, 16 pixels per iteration
+ */
+DICOKRNL_TARGET("avx2")
+static unsigned long convertYBRToRGB_AVX2(const Uint8 *y,
+                                          const Uint8 *cb,
+                                          const Uint8 *cr,
+                                          const unsigned long step,
+                                          Uint8 *r,
+                                          Uint8 *g,
+                                          Uint8 *b,
+                                          const unsigned long count,
+                                          const YBRFactors &factors,
+                                          const Uint8 maxvalue)
+{
+    const __m128i max = _mm_set1_epi8(OFstatic_cast(char, maxvalue));
+    __m128i vy, vcb, vcr;
+    __m256i r0, g0, b0, r1, g1, b1;
+    unsigned long i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        if (step == 3)
+            deinterleave3_SSE41(y + 3 * i, vy, vcb, vcr);
+        else {
+            vy = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, y + i));
+            vcb = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, cb + i));
+            vcr = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, cr + i));
+        }
+        ybr8_AVX2(_mm256_cvtepu8_epi32(vy), _mm256_cvtepu8_epi32(vcb), _mm256_cvtepu8_epi32(vcr), factors, r0, g0, b0);
+        ybr8_AVX2(_mm256_cvtepu8_epi32(_mm_srli_si128(vy, 8)), _mm256_cvtepu8_epi32(_mm_srli_si128(vcb, 8)),
+            _mm256_cvtepu8_epi32(_mm_srli_si128(vcr, 8)), factors, r1, g1, b1);
+        pack16_AVX2(r0, r1, max, r + i);
+        pack16_AVX2(g0, g1, max, g + i);
+        pack16_AVX2(b0, b1, max, b + i);
+    }
+    return i;
+}
+
+
+/* AVX2: convert 4 YCbCr (partial) values to RGB in double precision, using the same
+ * order of operations as DiColorKernels::convertPartialValue()
+ */
+DICOKRNL_TARGET("avx2")
+static inline void ybrPartial4_AVX2(const __m128i y,
+                                    const __m128i cb,
+                                    const __m128i cr,
+                                    const __m256d rConst,
+                                    const __m256d gConst,
+                                    const __m256d bConst,
+                                    __m128i &r,
+                                    __m128i &g,
+                                    __m128i &b)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d dy = _mm256_mul_pd(_mm256_set1_pd(1.1631), _mm256_cvtepi32_pd(y));
+    const __m256d dcb = _mm256_cvtepi32_pd(cb);
+    const __m256d dcr = _mm256_cvtepi32_pd(cr);
+    const __m256d dr = _mm256_sub_pd(_mm256_add_pd(dy, _mm256_mul_pd(_mm256_set1_pd(1.5969), dcr)), rConst);
+    const __m256d dg = _mm256_add_pd(_mm256_sub_pd(_mm256_sub_pd(dy, _mm256_mul_pd(_mm256_set1_pd(0.3913), dcb)),
+        _mm256_mul_pd(_mm256_set1_pd(0.8121), dcr)), gConst);
+    const __m256d db = _mm256_sub_pd(_mm256_add_pd(dy, _mm256_mul_pd(_mm256_set1_pd(2.0177), dcb)), bConst);
+    /* negative values are mapped to zero before truncation, the upper limit is applied when packing */
+    r = _mm256_cvttpd_epi32(_mm256_max_pd(dr, zero));
+    g = _mm256_cvttpd_epi32(_mm256_max_pd(dg, zero));
+    b = _mm256_cvttpd_epi32(_mm256_max_pd(db, zero));
+}
+
+
+/* AVX2: convert 4 YCbCr (full) values to RGB in single precision, which gives the same
+ * results as DiColorKernels::convertFullValue() for a maximum value of 255 (verified for
+ * all possible input values)
+ */
+DICOKRNL_TARGET("avx2")
+static inline void ybrFull8_AVX2(const __m256i y,
+                                 const __m256i cb,
+                                 const __m256i cr,
+                                 __m256i &r,
+                                 __m256i &g,
+                                 __m256i &b)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 fy = _mm256_cvtepi32_ps(y);
+    const __m256 fcb = _mm256_cvtepi32_ps(cb);
+    const __m256 fcr = _mm256_cvtepi32_ps(cr);
+    const __m256 fr = _mm256_sub_ps(_mm256_add_ps(fy, _mm256_mul_ps(_mm256_set1_ps(1.4020f), fcr)),
+        _mm256_set1_ps(OFstatic_cast(float, 0.7010 * 255)));
+    const __m256 fg = _mm256_add_ps(_mm256_sub_ps(_mm256_sub_ps(fy, _mm256_mul_ps(_mm256_set1_ps(0.3441f), fcb)),
+        _mm256_mul_ps(_mm256_set1_ps(0.7141f), fcr)), _mm256_set1_ps(OFstatic_cast(float, 0.5291 * 255)));
+    const __m256 fb = _mm256_sub_ps(_mm256_add_ps(fy, _mm256_mul_ps(_mm256_set1_ps(1.7720f), fcb)),
+        _mm256_set1_ps(OFstatic_cast(float, 0.8859 * 255)));
+    r = _mm256_cvttps_epi32(_mm256_max_ps(fr, zero));
+    g = _mm256_cvttps_epi32(_mm256_max_ps(fg, zero));
+    b = _mm256_cvttps_epi32(_mm256_max_ps(fb, zero));
+}
+
+
+/* AVX2: convert YCbCr 4:2:2 to RGB, 8 pixel pairs (16 pixels) per iteration
+ */
+DICOKRNL_TARGET("avx2")
+static unsigned long convertYBR422ToRGB_AVX2(const Uint8 *src,
+                                             Uint8 *r,
+                                             Uint8 *g,
+                                             Uint8 *b,
+                                             const unsigned long pairs,
+                                             const Uint8 maxvalue,
+                                             const OFBool partial)
+{
+    /* duplicate the chrominance values of each pair (Y1 Y2 Cb Cr) */
+    const __m128i yIndex = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i cbIndex = _mm_setr_epi8(2, 2, 6, 6, 10, 10, 14, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i crIndex = _mm_setr_epi8(3, 3, 7, 7, 11, 11, 15, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i max = _mm_set1_epi8(OFstatic_cast(char, maxvalue));
+    const __m256d rConst = _mm256_set1_pd(0.8713 * OFstatic_cast(double, maxvalue));
+    const __m256d gConst = _mm256_set1_pd(0.5290 * OFstatic_cast(double, maxvalue));
+    const __m256d bConst = _mm256_set1_pd(1.0820 * OFstatic_cast(double, maxvalue));
+    __m256i rv[2], gv[2], bv[2];
+    unsigned long i = 0;
+    for (; i + 8 <= pairs; i += 8)
+    {
+        for (int k = 0; k < 2; ++k)
+        {
+            const __m128i v = _mm_loadu_si128(OFreinterpret_cast(const __m128i *, src + 4 * i + 16 * k));
+            const __m128i vy = _mm_shuffle_epi8(v, yIndex);
+            const __m128i vcb = _mm_shuffle_epi8(v, cbIndex);
+            const __m128i vcr = _mm_shuffle_epi8(v, crIndex);
+            if (partial)
+            {
+                __m128i r0, g0, b0, r1, g1, b1;
+                ybrPartial4_AVX2(_mm_cvtepu8_epi32(vy), _mm_cvtepu8_epi32(vcb), _mm_cvtepu8_epi32(vcr),
+                    rConst, gConst, bConst, r0, g0, b0);
+                ybrPartial4_AVX2(_mm_cvtepu8_epi32(_mm_srli_si128(vy, 4)), _mm_cvtepu8_epi32(_mm_srli_si128(vcb, 4)),
+                    _mm_cvtepu8_epi32(_mm_srli_si128(vcr, 4)), rConst, gConst, bConst, r1, g1, b1);
+                rv[k] = _mm256_inserti128_si256(_mm256_castsi128_si256(r0), r1, 1);
+                gv[k] = _mm256_inserti128_si256(_mm256_castsi128_si256(g0), g1, 1);
+                bv[k] = _mm256_inserti128_si256(_mm256_castsi128_si256(b0), b1, 1);
+            } else {
+                ybrFull8_AVX2(_mm256_cvtepu8_epi32(vy), _mm256_cvtepu8_epi32(vcb), _mm256_cvtepu8_epi32(vcr),
+                    rv[k], gv[k], bv[k]);
+            }
+        }
+        pack16_AVX2(rv[0], rv[1], max, r + 2 * i);
+        pack16_AVX2(gv[0], gv[1], max, g + 2 * i);
+        pack16_AVX2(bv[0], bv[1], max, b + 2 * i);
+    }
+    return i;
+}
+
+#endif
+
+
+/*------------------*
+ *  implementation  *
+ *------------------*/
+
+void DiColorKernels::convertYBRToRGB(const Uint8 *y,
+                                     const Uint8 *cb,
+                                     const Uint8 *cr,
+                                     const unsigned long step,
+                                     Uint8 *r,
+                                     Uint8 *g,
+                                     Uint8 *b,
+                                     const unsigned long count,
+                                     const Uint8 maxvalue)
+{
+    unsigned long done = 0;
+#ifdef DICOKRNL_X86
+    const DiMonoKernels::E_InstructionSet instructionSet = DiMonoKernels::getInstructionSet();
+    if ((instructionSet >= DiMonoKernels::IS_SSE41) && ((step == 1) || (step == 3)) && (count >= 16))
+    {
+        const YBRFactors factors(maxvalue);
+        if (factors.Valid)
+        {
+            if (instructionSet >= DiMonoKernels::IS_AVX2)
+                done = convertYBRToRGB_AVX2(y, cb, cr, step, r, g, b, count, factors, maxvalue);
+            else
+                done = convertYBRToRGB_SSE41(y, cb, cr, step, r, g, b, count, factors, maxvalue);
+        }
+    }
+#endif
+    convertYBRToRGB<Uint8, Uint8>(y + done * step, cb + done * step, cr + done * step, step,
+        r + done, g + done, b + done, count - done, maxvalue);
+}
+
+
+void DiColorKernels::convertYBR422ToRGB(const Uint8 *src,
+                                        const Uint8 offset,
+                                        Uint8 *r,
+                                        Uint8 *g,
+                                        Uint8 *b,
+                                        const unsigned long pairs,
+                                        const Uint8 maxvalue,
+                                        const OFBool partial)
+{
+    unsigned long done = 0;
+#ifdef DICOKRNL_X86
+    /* the single precision version of YCbCr full is only exact for 8 bit output */
+    if ((DiMonoKernels::getInstructionSet() >= DiMonoKernels::IS_AVX2) && (partial || (maxvalue == 255)))
+        done = convertYBR422ToRGB_AVX2(src, r, g, b, pairs, maxvalue, partial);
+#endif
+    convertYBR422ToRGB<Uint8, Uint8>(src + 4 * done, offset, r + 2 * done, g + 2 * done, b + 2 * done,
+        pairs - done, maxvalue, partial);
+}
+
+
+void DiColorKernels::splitPlanes(const Uint8 *src,
+                                 const Uint8 offset,
+                                 Uint8 *dst0,
+                                 Uint8 *dst1,
+                                 Uint8 *dst2,
+                                 const unsigned long count)
+{
+    unsigned long done = 0;
+#ifdef DICOKRNL_X86
+    /* removing the sign has no effect for unsigned values */
+    if (DiMonoKernels::getInstructionSet() >= DiMonoKernels::IS_SSE41)
+        done = splitPlanes_SSE41(src, dst0, dst1, dst2, count);
+#endif
+    splitPlanes<Uint8, Uint8>(src + 3 * done, offset, dst0 + done, dst1 + done, dst2 + done, count - done);
+}
+
+
+void DiColorKernels::mergePlanes(const Uint8 *src0,
+                                 const Uint8 *src1,
+                                 const Uint8 *src2,
+                                 Uint8 *dst,
+                                 const unsigned long count,
+                                 const OFBool inverse,
+                                 const Uint8 maxvalue)
+{
+    unsigned long done = 0;
+#ifdef DICOKRNL_X86
+    if (DiMonoKernels::getInstructionSet() >= DiMonoKernels::IS_SSE41)
+        done = mergePlanes_SSE41(src0, src1, src2, dst, count, inverse, maxvalue);
+#endif
+    mergePlanes<Uint8, Uint8>(src0 + done, src1 + done, src2 + done, dst + 3 * done, count - done, inverse, maxvalue);
+}
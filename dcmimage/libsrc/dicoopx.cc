@@ -32,14 +32,15 @@
 
 DiColorOutputPixel::DiColorOutputPixel(const DiPixel *pixel,
                                        const unsigned long size,
-                                       const unsigned long frame)
+                                       const unsigned long frame,
+                                       const unsigned long offset)
   : Count(0),
     FrameSize(size)
 {
     if (pixel != NULL)
     {
-        if (pixel->getCount() > frame * size)
-            Count = pixel->getCount() - frame * size;       // number of pixels remaining for this 'frame'
+        if (pixel->getCount() > frame * size + offset)
+            Count = pixel->getCount() - frame * size - offset;  // number of pixels remaining for this 'frame'
     }
     if (Count > FrameSize)
         Count = FrameSize;                                  // cut off at frame 'size'
@@ -26,6 +26,7 @@
 
 #include "dcmtk/dcmdata/dctypes.h"
 #include "dcmtk/dcmimgle/diimage.h"
+#include "dcmtk/dcmimgle/distrip.h"
 #include "dcmtk/dcmimage/dipipng.h"
 #include "dcmtk/dcmdata/dcuid.h"      /* for dcmtk version */
 
@@ -62,7 +63,17 @@ int DiPNGPlugin::write(
   {
     /* create bitmap with 8 or 16 bits per sample */
     const int bit_depth = bitsPerSample;
-    const void *data = image->getOutputData(frame, bit_depth /*bits*/, 0 /*planar*/);
+    const void *data = NULL;
+    unsigned long first_row = 0;
+    unsigned long row_count = 0;
+    /* without interlacing, the frame is rendered and written strip by strip,
+       i.e. only a few rows are stored in memory at a time */
+    DiStripRenderer * volatile strips = NULL;
+    if( interlaceType == E_pngInterlaceNone ) {
+      strips = new DiStripRenderer( image, frame, bit_depth /*bits*/, 0 /*rowsPerStrip*/, 0 /*planar*/ );
+      data = strips->getNextStrip( first_row, row_count );
+    } else
+      data = image->getOutputData(frame, bit_depth /*bits*/, 0 /*planar*/);
     if (data != NULL)
     {
       png_struct *png_ptr = NULL;
@@ -83,6 +94,7 @@ int DiPNGPlugin::write(
       // create png write struct
       png_ptr = png_create_write_struct( PNG_LIBPNG_VER_STRING, NULL, NULL, NULL );
       if( png_ptr == NULL ) {
+        delete strips;
         return 0;
       }
 
@@ -90,6 +102,7 @@ int DiPNGPlugin::write(
       info_ptr = png_create_info_struct( png_ptr );
       if( info_ptr == NULL ) {
         png_destroy_write_struct( &png_ptr, NULL );
+        delete strips;
         return 0;
       }
 
@@ -98,6 +111,7 @@ int DiPNGPlugin::write(
         png_destroy_write_struct( &png_ptr, NULL );
         if( row_ptr )  delete[] row_ptr;
         if( text_ptr ) delete[] text_ptr;
+        delete strips;
         return 0;
       }
 
@@ -133,6 +147,7 @@ int DiPNGPlugin::write(
         text_ptr = new png_text[3];
         if( text_ptr == NULL ) {
           png_destroy_write_struct( &png_ptr, NULL );
+          delete strips;
           return result;
         }
         text_ptr[0].key         = OFconst_cast(char *, "Title");
@@ -157,35 +172,53 @@ int DiPNGPlugin::write(
 
       // write header
       png_write_info( png_ptr, info_ptr );
-      row_ptr = new png_bytep[height];
-      if( row_ptr == NULL ) {
-        png_destroy_write_struct( &png_ptr, NULL );
-        if( text_ptr ) delete[] text_ptr;
-        return result;
-      }
-      for( row=0, pix_ptr=OFstatic_cast(png_byte*, OFconst_cast(void*, data));
-        row<height;
-        row++, pix_ptr+=width*bpp )
-      {
-        row_ptr[row] = pix_ptr;
-      }
 
       // swap bytes (if needed)
       if ( (bit_depth == 16) && (gLocalByteOrder != EBO_BigEndian) )
         png_set_swap( png_ptr );
 
-      // write image
-      png_write_image( png_ptr, row_ptr );
+      if( strips != NULL ) {
+        // write image strip by strip
+        while( data != NULL ) {
+          pix_ptr = OFstatic_cast(png_byte*, OFconst_cast(void*, data));
+          for( row=0; row<OFstatic_cast(int, row_count); row++, pix_ptr+=width*bpp )
+            png_write_row( png_ptr, pix_ptr );
+          // check whether all rows have been written
+          if( first_row + row_count >= OFstatic_cast(unsigned long, height) ) {
+            result = 1;
+            break;
+          }
+          data = strips->getNextStrip( first_row, row_count );
+        }
+      } else {
+        row_ptr = new png_bytep[height];
+        if( row_ptr == NULL ) {
+          png_destroy_write_struct( &png_ptr, NULL );
+          if( text_ptr ) delete[] text_ptr;
+          return result;
+        }
+        for( row=0, pix_ptr=OFstatic_cast(png_byte*, OFconst_cast(void*, data));
+          row<height;
+          row++, pix_ptr+=width*bpp )
+        {
+          row_ptr[row] = pix_ptr;
+        }
+
+        // write image
+        png_write_image( png_ptr, row_ptr );
+        result = 1;
+      }
 
       // write additional chunks
-      png_write_end( png_ptr, info_ptr );
+      if( result )
+        png_write_end( png_ptr, info_ptr );
 
       // finish
       png_destroy_write_struct( &png_ptr, NULL );
-      delete[] row_ptr;
+      if( row_ptr )  delete[] row_ptr;
       if( text_ptr ) delete[] text_ptr;
-      result = 1;
     }
+    delete strips;
   }
 
   return result;
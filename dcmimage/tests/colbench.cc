@@ -0,0 +1,309 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimage
+ *
+ *  Author:  agent
+ *
+ *  Purpose: Measure the throughput of the color conversion kernels
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/ofstream.h"
+#include "dcmtk/ofstd/oftimer.h"
+#include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmimgle/dcmimage.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
+#include "dcmtk/dcmimgle/diparal.h"
+#include "dcmtk/dcmimage/diregist.h"  /* include to support color images */
+#include "dcmtk/dcmimage/dicokrnl.h"
+
+#define INCLUDE_CSTDLIB
+#define INCLUDE_CSTRING
+#define INCLUDE_CSTDIO
+#include "dcmtk/ofstd/ofstdinc.h"
+
+
+/* kernels to be measured */
+enum E_Kernel
+{
+    K_YBRPlanar,
+    K_YBRPixel,
+    K_YBR422Full,
+    K_YBR422Partial,
+    K_Split,
+    K_Merge,
+    K_MergeInverse
+};
+
+
+/* names of the kernels */
+static const char *KernelNames[] =
+{
+    "YBR planar", "YBR pixel", "YBR422", "YBRP422", "split", "merge", "merge inv"
+};
+
+
+/* number of pixels per second in millions */
+static double mpixels(const unsigned long count, const int iterations, const double seconds)
+{
+    return (seconds > 0) ? OFstatic_cast(double, count) * iterations / seconds / 1000000.0 : 0;
+}
+
+
+/* print one line of the result table */
+static void report(const char *kernel, const char *types, const DiMonoKernels::E_InstructionSet instructionSet,
+                   const double throughput, const OFBool ok)
+{
+    char line[128];
+    sprintf(line, "%-10s %-18s %-8s %10.1f Mpixels/s  %s", kernel, types,
+        DiMonoKernels::getInstructionSetName(instructionSet), throughput, ok ? "ok" : "MISMATCH");
+    COUT << line << OFendl;
+}
+
+
+/* call the generic (if 'generic' is true) or the best available version of a kernel,
+ * 'src' contains three planes of 'count' values each, 'dst' receives three planes
+ */
+static void runKernel(const E_Kernel kernel,
+                      const OFBool generic,
+                      const Uint8 *src,
+                      Uint8 *dst,
+                      const unsigned long count)
+{
+    const Uint8 *src1 = src + count;
+    const Uint8 *src2 = src + 2 * count;
+    Uint8 *dst1 = dst + count;
+    Uint8 *dst2 = dst + 2 * count;
+    switch (kernel)
+    {
+        case K_YBRPlanar:
+            if (generic)
+                DiColorKernels::convertYBRToRGB<Uint8, Uint8>(src, src1, src2, 1, dst, dst1, dst2, count, 255);
+            else
+                DiColorKernels::convertYBRToRGB(src, src1, src2, 1, dst, dst1, dst2, count, 255);
+            break;
+        case K_YBRPixel:
+            if (generic)
+                DiColorKernels::convertYBRToRGB<Uint8, Uint8>(src, src + 1, src + 2, 3, dst, dst1, dst2, count, 255);
+            else
+                DiColorKernels::convertYBRToRGB(src, src + 1, src + 2, 3, dst, dst1, dst2, count, 255);
+            break;
+        case K_YBR422Full:
+        case K_YBR422Partial:
+            if (generic)
+                DiColorKernels::convertYBR422ToRGB<Uint8, Uint8>(src, 0, dst, dst1, dst2, count / 2, 255, kernel == K_YBR422Partial);
+            else
+                DiColorKernels::convertYBR422ToRGB(src, 0, dst, dst1, dst2, count / 2, 255, kernel == K_YBR422Partial);
+            break;
+        case K_Split:
+            if (generic)
+                DiColorKernels::splitPlanes<Uint8, Uint8>(src, 0, dst, dst1, dst2, count);
+            else
+                DiColorKernels::splitPlanes(src, 0, dst, dst1, dst2, count);
+            break;
+        case K_Merge:
+        case K_MergeInverse:
+            if (generic)
+                DiColorKernels::mergePlanes<Uint8, Uint8>(src, src1, src2, dst, count, kernel == K_MergeInverse, 255);
+            else
+                DiColorKernels::mergePlanes(src, src1, src2, dst, count, kernel == K_MergeInverse, 255);
+            break;
+    }
+}
+
+
+/* measure the color kernels for 8 bit data, the results of the vectorized versions
+ * are compared with the generic version
+ */
+static OFBool benchmarkKernels(const Uint8 *src,
+                               const unsigned long count,
+                               const int iterations)
+{
+    OFBool result = OFTrue;
+    Uint8 *expected = new Uint8[3 * count];
+    Uint8 *dst = new Uint8[3 * count];
+    for (int kernel = K_YBRPlanar; kernel <= K_MergeInverse; ++kernel)
+    {
+        runKernel(OFstatic_cast(E_Kernel, kernel), OFTrue, src, expected, count);
+        for (int i = DiMonoKernels::IS_Scalar; i <= DiMonoKernels::IS_AVX2; ++i)
+        {
+            DiMonoKernels::setMaxInstructionSet(OFstatic_cast(DiMonoKernels::E_InstructionSet, i));
+            if (DiMonoKernels::getInstructionSet() != i)
+                continue;
+            memset(dst, 0, 3 * count);
+            OFTimer timer;
+            for (int j = 0; j < iterations; ++j)
+                runKernel(OFstatic_cast(E_Kernel, kernel), OFFalse, src, dst, count);
+            const double seconds = timer.getDiff();
+            const OFBool ok = (memcmp(dst, expected, 3 * count) == 0);
+            report(KernelNames[kernel], "Uint8 -> Uint8", DiMonoKernels::getInstructionSet(),
+                mpixels(count, iterations, seconds), ok);
+            result &= ok;
+        }
+    }
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+    delete[] dst;
+    delete[] expected;
+    return result;
+}
+
+
+/* add a palette color lookup table with 'entries' values starting at 'first' to the dataset
+ */
+static void addPalette(DcmDataset &dset,
+                       const DcmTagKey &descriptor,
+                       const DcmTagKey &data,
+                       const Uint16 entries,
+                       const Uint16 first,
+                       const int channel)
+{
+    const Uint16 desc[3] = { entries, first, 16 };
+    dset.putAndInsertUint16Array(descriptor, desc, 3);
+    Uint16 *values = new Uint16[entries];
+    for (unsigned long i = 0; i < entries; ++i)
+        values[i] = OFstatic_cast(Uint16, (i * (channel + 3) * 977) & 0xffff);
+    dset.putAndInsertUint16Array(data, values, entries);
+    delete[] values;
+}
+
+
+/* measure the complete rendering of an 8 bit color image (16 bit for palette color)
+ */
+static OFBool benchmarkRendering(const Uint8 *pixels,
+                                 const Uint16 columns,
+                                 const Uint16 rows,
+                                 const char *photometricInterpretation,
+                                 const Uint16 planarConfiguration,
+                                 const int iterations)
+{
+    OFBool result = OFTrue;
+    const unsigned long count = OFstatic_cast(unsigned long, columns) * rows;
+    const OFBool palette = (strcmp(photometricInterpretation, "PALETTE COLOR") == 0);
+    DcmDataset dset;
+    dset.putAndInsertString(DCM_PhotometricInterpretation, photometricInterpretation);
+    dset.putAndInsertUint16(DCM_SamplesPerPixel, palette ? 1 : 3);
+    dset.putAndInsertUint16(DCM_Rows, rows);
+    dset.putAndInsertUint16(DCM_Columns, columns);
+    dset.putAndInsertUint16(DCM_PixelRepresentation, 0);
+    if (palette)
+    {
+        dset.putAndInsertUint16(DCM_BitsAllocated, 16);
+        dset.putAndInsertUint16(DCM_BitsStored, 16);
+        dset.putAndInsertUint16(DCM_HighBit, 15);
+        dset.putAndInsertUint16Array(DCM_PixelData, OFreinterpret_cast(const Uint16 *, pixels), count);
+        addPalette(dset, DCM_RedPaletteColorLookupTableDescriptor, DCM_RedPaletteColorLookupTableData, 4096, 1000, 0);
+        addPalette(dset, DCM_GreenPaletteColorLookupTableDescriptor, DCM_GreenPaletteColorLookupTableData, 4096, 1000, 1);
+        addPalette(dset, DCM_BluePaletteColorLookupTableDescriptor, DCM_BluePaletteColorLookupTableData, 4096, 1000, 2);
+    } else {
+        dset.putAndInsertUint16(DCM_PlanarConfiguration, planarConfiguration);
+        dset.putAndInsertUint16(DCM_BitsAllocated, 8);
+        dset.putAndInsertUint16(DCM_BitsStored, 8);
+        dset.putAndInsertUint16(DCM_HighBit, 7);
+        /* YCbCr 4:2:2 requires two samples per pixel only */
+        const unsigned long length = (strstr(photometricInterpretation, "422") != NULL) ? 2 * count : 3 * count;
+        dset.putAndInsertUint8Array(DCM_PixelData, pixels, length);
+    }
+    DicomImage image(&dset, EXS_LittleEndianExplicit);
+    if (image.getStatus() != EIS_Normal)
+    {
+        CERR << "Error: cannot create image: " << DicomImage::getString(image.getStatus()) << OFendl;
+        return OFFalse;
+    }
+    const size_t size = image.getOutputDataSize(8);
+    Uint8 *expected = new Uint8[size];
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_Scalar);
+    image.getOutputData(expected, size, 8);
+    char types[32];
+    sprintf(types, "%.15s%s", photometricInterpretation, (planarConfiguration != 0) ? " (pl)" : "");
+    for (int i = DiMonoKernels::IS_Scalar; i <= DiMonoKernels::IS_AVX2; ++i)
+    {
+        DiMonoKernels::setMaxInstructionSet(OFstatic_cast(DiMonoKernels::E_InstructionSet, i));
+        if (DiMonoKernels::getInstructionSet() != i)
+            continue;
+        OFTimer timer;
+        OFBool ok = OFTrue;
+        for (int j = 0; j < iterations; ++j)
+        {
+            /* the color model is converted when the image is created */
+            DicomImage copy(&dset, EXS_LittleEndianExplicit);
+            const void *data = copy.getOutputData(8);
+            ok &= (data != NULL) && (memcmp(data, expected, size) == 0);
+        }
+        const double seconds = timer.getDiff();
+        report("rendering", types, DiMonoKernels::getInstructionSet(), mpixels(count, iterations, seconds), ok);
+        result &= ok;
+    }
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+    delete[] expected;
+    return result;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long columns = 2048;
+    unsigned long rows = 2048;
+    int iterations = 10;
+    if ((argc > 1) && ((argc < 3) || (argc > 5) || (atol(argv[1]) <= 0) || (atol(argv[2]) <= 0) || (atol(argv[1]) > 65535) ||
+        (atol(argv[2]) > 65535) || ((argc >= 4) && (atoi(argv[3]) <= 0)) || ((argc == 5) && (atoi(argv[4]) <= 0))))
+    {
+        COUT << "colbench: Measure the throughput of the color conversion kernels" << OFendl;
+        COUT << "usage: colbench [columns rows [iterations [threads]]]" << OFendl;
+        return 1;
+    }
+    if (argc > 2)
+    {
+        columns = atol(argv[1]);
+        rows = atol(argv[2]);
+    }
+    if (argc > 3)
+        iterations = atoi(argv[3]);
+    if (argc > 4)
+        dcmRenderingMaxThreads.set(OFstatic_cast(Uint32, atoi(argv[4])));
+
+    /* make sure data dictionary is loaded */
+    if (!dcmDataDict.isDictionaryLoaded())
+    {
+        CERR << "Warning: no data dictionary loaded, "
+             << "check environment variable: "
+             << DCM_DICT_ENVIRONMENT_VARIABLE << OFendl;
+    }
+
+    /* YCbCr 4:2:2 requires an even number of columns */
+    columns &= ~1UL;
+    if (columns == 0)
+        columns = 2;
+
+    /* create pixel data with a simple pseudo random generator, so the results are reproducible */
+    const unsigned long count = columns * rows;
+    Uint8 *pixels = new Uint8[3 * count];
+    Uint32 seed = 1;
+    for (unsigned long i = 0; i < 3 * count; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        pixels[i] = OFstatic_cast(Uint8, seed >> 16);
+    }
+
+    COUT << "image size: " << columns << " x " << rows << ", " << iterations << " iterations, " << dcmRenderingMaxThreads.get()
+         << " rendering thread(s), best instruction set: "
+         << DiMonoKernels::getInstructionSetName(DiMonoKernels::getInstructionSet()) << OFendl;
+    OFBool ok = benchmarkKernels(pixels, count, iterations);
+    const Uint16 c = OFstatic_cast(Uint16, columns);
+    const Uint16 r = OFstatic_cast(Uint16, rows);
+    ok &= benchmarkRendering(pixels, c, r, "RGB", 0, iterations);
+    ok &= benchmarkRendering(pixels, c, r, "YBR_FULL", 0, iterations);
+    ok &= benchmarkRendering(pixels, c, r, "YBR_FULL", 1, iterations);
+    ok &= benchmarkRendering(pixels, c, r, "YBR_FULL_422", 0, iterations);
+    ok &= benchmarkRendering(pixels, c, r, "YBR_PARTIAL_422", 0, iterations);
+    ok &= benchmarkRendering(pixels, c, r, "PALETTE COLOR", 0, iterations);
+    delete[] pixels;
+    return ok ? 0 : 2;
+}
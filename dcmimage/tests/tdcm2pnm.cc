@@ -0,0 +1,306 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimage
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the batch mode and the conversion of all frames of dcm2pnm
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTDLIB
+#define INCLUDE_CSTDIO
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/ofstd/oflist.h"
+#include "dcmtk/dcmdata/dctk.h"
+
+/* path of the dcm2pnm executable, defined by the build system */
+#ifndef DCM2PNM_PATH
+#define DCM2PNM_PATH "../apps/dcm2pnm"
+#endif
+
+/* directory for the input and output files of the tests */
+#define WORK_DIR "tdcm2pnm.dir"
+/* directory for the input files of the batch mode tests */
+#define INPUT_DIR WORK_DIR "/in"
+/* file for the output of dcm2pnm */
+#define LOG_FILE "tdcm2pnm.log"
+
+/* size of the test images */
+#define IMAGE_COLUMNS 37
+#define IMAGE_ROWS 23
+
+
+/* delete all files in the working directory (and create it if necessary) */
+static void cleanWorkDir()
+{
+    OFList<OFString> fileList;
+    OFStandard::searchDirectoryRecursively(WORK_DIR, fileList);
+    OFListIterator(OFString) iter = fileList.begin();
+    while (iter != fileList.end())
+        OFStandard::deleteFile(*iter++);
+    OFCHECK(OFStandard::createDirectory(INPUT_DIR "/sub", "").good());
+}
+
+
+/* write an 8 bit monochrome image with the given number of frames */
+static void createImage(const OFString &filename,
+                        const Uint16 frames,
+                        const Uint8 seed)
+{
+    const unsigned long frameSize = IMAGE_COLUMNS * IMAGE_ROWS;
+    DcmFileFormat fileformat;
+    DcmDataset *dset = fileformat.getDataset();
+    dset->putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage);
+    dset->putAndInsertString(DCM_SOPInstanceUID, "1.2.276.0.7230010.3.1.4.0.18");
+    dset->putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+    dset->putAndInsertUint16(DCM_SamplesPerPixel, 1);
+    dset->putAndInsertUint16(DCM_Rows, IMAGE_ROWS);
+    dset->putAndInsertUint16(DCM_Columns, IMAGE_COLUMNS);
+    dset->putAndInsertUint16(DCM_BitsAllocated, 8);
+    dset->putAndInsertUint16(DCM_BitsStored, 8);
+    dset->putAndInsertUint16(DCM_HighBit, 7);
+    dset->putAndInsertUint16(DCM_PixelRepresentation, 0);
+    if (frames > 1)
+    {
+        char buf[16];
+        sprintf(buf, "%u", OFstatic_cast(unsigned int, frames));
+        dset->putAndInsertString(DCM_NumberOfFrames, buf);
+    }
+    Uint8 *pixels = new Uint8[frameSize * frames];
+    for (unsigned long i = 0; i < frameSize * frames; ++i)
+        pixels[i] = OFstatic_cast(Uint8, seed + i * 3 + (i / frameSize) * 50);
+    /* use the full range of pixel values in each frame */
+    for (Uint16 f = 0; f < frames; ++f)
+    {
+        pixels[f * frameSize] = 0;
+        pixels[f * frameSize + 1] = 255;
+    }
+    dset->putAndInsertUint8Array(DCM_PixelData, pixels, frameSize * frames);
+    delete[] pixels;
+    OFCHECK(fileformat.saveFile(filename.c_str(), EXS_LittleEndianExplicit).good());
+}
+
+
+/* run dcm2pnm with the given arguments, the output is written to a log file */
+static OFBool runDcm2pnm(const OFString &arguments)
+{
+    OFString command = "\"" DCM2PNM_PATH "\" ";
+    command += arguments;
+    command += " > " LOG_FILE " 2>&1";
+    return system(command.c_str()) == 0;
+}
+
+
+/* read the content of the given file */
+static OFString readFile(const OFString &filename)
+{
+    OFString content;
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (file != NULL)
+    {
+        char buf[1024];
+        size_t count;
+        while ((count = fread(buf, 1, sizeof(buf), file)) > 0)
+            content.append(buf, count);
+        fclose(file);
+    }
+    return content;
+}
+
+
+/* check that the given file exists and is identical to the reference file */
+static void checkOutput(const OFString &filename,
+                        const OFString &reference)
+{
+    if (!OFStandard::fileExists(filename))
+        OFCHECK_FAIL("missing output file: " << filename);
+    else
+    {
+        const OFString content = readFile(filename);
+        OFCHECK(!content.empty());
+        OFCHECK(content == readFile(reference));
+    }
+}
+
+
+/* create three input files (one of them in a sub-directory) and their reference output */
+static void createInputFiles()
+{
+    cleanWorkDir();
+    createImage(INPUT_DIR "/a.dcm", 1, 10);
+    createImage(INPUT_DIR "/b.dcm", 1, 20);
+    createImage(INPUT_DIR "/sub/c.dcm", 1, 30);
+    OFCHECK(runDcm2pnm(INPUT_DIR "/a.dcm " WORK_DIR "/a.ref"));
+    OFCHECK(runDcm2pnm(INPUT_DIR "/b.dcm " WORK_DIR "/b.ref"));
+    OFCHECK(runDcm2pnm(INPUT_DIR "/sub/c.dcm " WORK_DIR "/c.ref"));
+    /* the images differ */
+    OFCHECK(readFile(WORK_DIR "/a.ref") != readFile(WORK_DIR "/b.ref"));
+}
+
+
+OFTEST(dcmimage_dcm2pnm_scanDirectories)
+{
+    createInputFiles();
+    /* without recursion, files in sub-directories are ignored */
+    OFCHECK(runDcm2pnm("--scan-directories " INPUT_DIR " \"" WORK_DIR "/%b.%e\""));
+    checkOutput(WORK_DIR "/a.dcm.pgm", WORK_DIR "/a.ref");
+    checkOutput(WORK_DIR "/b.dcm.pgm", WORK_DIR "/b.ref");
+    OFCHECK(!OFStandard::fileExists(WORK_DIR "/c.dcm.pgm"));
+    OFCHECK(runDcm2pnm("--scan-directories --recurse " INPUT_DIR " \"" WORK_DIR "/%b.%e\""));
+    checkOutput(WORK_DIR "/c.dcm.pgm", WORK_DIR "/c.ref");
+    /* a directory that does not exist */
+    OFCHECK(!runDcm2pnm("--scan-directories " WORK_DIR "/missing \"%b.%e\""));
+    cleanWorkDir();
+}
+
+
+OFTEST(dcmimage_dcm2pnm_readFileList)
+{
+    createInputFiles();
+    /* empty lines and trailing whitespace are ignored */
+    FILE *list = fopen(WORK_DIR "/list.txt", "w");
+    OFCHECK(list != NULL);
+    if (list == NULL)
+        return;
+    fputs(INPUT_DIR "/sub/c.dcm\n\n" INPUT_DIR "/a.dcm  \r\n" INPUT_DIR "/b.dcm", list);
+    fclose(list);
+    OFCHECK(runDcm2pnm("--read-file-list " WORK_DIR "/list.txt \"" WORK_DIR "/out%n_%b.%e\""));
+    checkOutput(WORK_DIR "/out0_c.dcm.pgm", WORK_DIR "/c.ref");
+    checkOutput(WORK_DIR "/out1_a.dcm.pgm", WORK_DIR "/a.ref");
+    checkOutput(WORK_DIR "/out2_b.dcm.pgm", WORK_DIR "/b.ref");
+    /* read the list from stdin */
+    OFCHECK(runDcm2pnm("--read-file-list - \"" WORK_DIR "/stdin%n.%e\" < " WORK_DIR "/list.txt"));
+    checkOutput(WORK_DIR "/stdin0.pgm", WORK_DIR "/c.ref");
+    checkOutput(WORK_DIR "/stdin1.pgm", WORK_DIR "/a.ref");
+    checkOutput(WORK_DIR "/stdin2.pgm", WORK_DIR "/b.ref");
+    /* a list file that does not exist */
+    OFCHECK(!runDcm2pnm("--read-file-list " WORK_DIR "/missing.txt \"%b.%e\""));
+    /* an output filename template is required */
+    OFCHECK(!runDcm2pnm("--read-file-list " WORK_DIR "/list.txt"));
+    cleanWorkDir();
+}
+
+
+OFTEST(dcmimage_dcm2pnm_filenameTemplate)
+{
+    createInputFiles();
+    FILE *list = fopen(WORK_DIR "/list.txt", "w");
+    OFCHECK(list != NULL);
+    if (list == NULL)
+        return;
+    fputs(INPUT_DIR "/a.dcm\n" INPUT_DIR "/sub/c.dcm\n", list);
+    fclose(list);
+    /* the file extension depends on the output format, "%%" is a percent sign */
+    OFCHECK(runDcm2pnm("+ob --read-file-list " WORK_DIR "/list.txt \"%d/%b_100%%.%e\""));
+    OFCHECK(OFStandard::fileExists(INPUT_DIR "/a.dcm_100%.bmp"));
+    OFCHECK(OFStandard::fileExists(INPUT_DIR "/sub/c.dcm_100%.bmp"));
+    /* the frame number is appended to the filename created from the template */
+    createImage(WORK_DIR "/m.dcm", 3, 40);
+    list = fopen(WORK_DIR "/list.txt", "w");
+    OFCHECK(list != NULL);
+    if (list == NULL)
+        return;
+    fputs(WORK_DIR "/m.dcm\n", list);
+    fclose(list);
+    OFCHECK(runDcm2pnm("+Fa --read-file-list " WORK_DIR "/list.txt \"%d/%b\""));
+    OFCHECK(OFStandard::fileExists(WORK_DIR "/m.dcm.0.pgm"));
+    OFCHECK(OFStandard::fileExists(WORK_DIR "/m.dcm.1.pgm"));
+    OFCHECK(OFStandard::fileExists(WORK_DIR "/m.dcm.2.pgm"));
+    cleanWorkDir();
+}
+
+
+OFTEST(dcmimage_dcm2pnm_batchThreads)
+{
+    cleanWorkDir();
+    FILE *list = fopen(WORK_DIR "/list.txt", "w");
+    OFCHECK(list != NULL);
+    if (list == NULL)
+        return;
+    for (int i = 0; i < 12; ++i)
+    {
+        const OFString filename = OFString(WORK_DIR "/") + OFstatic_cast(char, 'a' + i) + ".dcm";
+        createImage(filename, 1, OFstatic_cast(Uint8, i * 11));
+        fprintf(list, "%s\n", filename.c_str());
+    }
+    fclose(list);
+    /* the result does not depend on the number of threads */
+    OFCHECK(runDcm2pnm("--read-file-list " WORK_DIR "/list.txt \"%d/%n.ref\""));
+    OFCHECK(runDcm2pnm("--read-file-list --batch-threads 4 " WORK_DIR "/list.txt \"%d/%n.%e\""));
+    for (int i = 0; i < 12; ++i)
+    {
+        OFOStringStream stream;
+        stream << WORK_DIR "/" << i << OFStringStream_ends;
+        OFSTRINGSTREAM_GETOFSTRING(stream, prefix)
+        checkOutput(prefix + ".pgm", prefix + ".ref");
+    }
+    /* the number of threads is only accepted in batch mode */
+    OFCHECK(!runDcm2pnm("--batch-threads 2 " WORK_DIR "/a.dcm " WORK_DIR "/x.pgm"));
+    cleanWorkDir();
+}
+
+
+OFTEST(dcmimage_dcm2pnm_failedFiles)
+{
+    createInputFiles();
+    FILE *file = fopen(WORK_DIR "/nodicom.dcm", "w");
+    OFCHECK(file != NULL);
+    if (file == NULL)
+        return;
+    fputs("no DICOM file", file);
+    fclose(file);
+    file = fopen(WORK_DIR "/list.txt", "w");
+    OFCHECK(file != NULL);
+    if (file == NULL)
+        return;
+    fputs(INPUT_DIR "/a.dcm\n" WORK_DIR "/nodicom.dcm\n" WORK_DIR "/missing.dcm\n" INPUT_DIR "/b.dcm\n", file);
+    fclose(file);
+    /* all other files are converted, but the failure is reported */
+    OFCHECK(!runDcm2pnm("--read-file-list --batch-threads 2 " WORK_DIR "/list.txt \"%d/%b.%e\""));
+    checkOutput(INPUT_DIR "/a.dcm.pgm", WORK_DIR "/a.ref");
+    checkOutput(INPUT_DIR "/b.dcm.pgm", WORK_DIR "/b.ref");
+    OFCHECK(!OFStandard::fileExists(WORK_DIR "/nodicom.dcm.pgm"));
+    const OFString log = readFile(LOG_FILE);
+    OFCHECK(log.find("2 of 4 file(s) could not be converted") != OFString_npos);
+    OFCHECK(log.find("cannot convert file: " WORK_DIR "/nodicom.dcm") != OFString_npos);
+    OFCHECK(log.find("cannot convert file: " WORK_DIR "/missing.dcm") != OFString_npos);
+    cleanWorkDir();
+}
+
+
+OFTEST(dcmimage_dcm2pnm_allFrames)
+{
+    cleanWorkDir();
+    createImage(WORK_DIR "/m.dcm", 5, 60);
+    OFCHECK(runDcm2pnm("+F 1 " WORK_DIR "/m.dcm " WORK_DIR "/f1.ref"));
+    OFCHECK(runDcm2pnm("+F 2 " WORK_DIR "/m.dcm " WORK_DIR "/f2.ref"));
+    OFCHECK(runDcm2pnm("+F 5 " WORK_DIR "/m.dcm " WORK_DIR "/f5.ref"));
+    OFCHECK(readFile(WORK_DIR "/f1.ref") != readFile(WORK_DIR "/f2.ref"));
+    /* each frame is rendered separately, but written to a file of its own */
+    OFCHECK(runDcm2pnm("+Fa " WORK_DIR "/m.dcm " WORK_DIR "/all"));
+    checkOutput(WORK_DIR "/all.0.pgm", WORK_DIR "/f1.ref");
+    checkOutput(WORK_DIR "/all.1.pgm", WORK_DIR "/f2.ref");
+    checkOutput(WORK_DIR "/all.4.pgm", WORK_DIR "/f5.ref");
+    OFCHECK(!OFStandard::fileExists(WORK_DIR "/all.5.pgm"));
+    OFCHECK(runDcm2pnm("+Fa --use-frame-number " WORK_DIR "/m.dcm " WORK_DIR "/num"));
+    checkOutput(WORK_DIR "/num.f1.pgm", WORK_DIR "/f1.ref");
+    checkOutput(WORK_DIR "/num.f2.pgm", WORK_DIR "/f2.ref");
+    checkOutput(WORK_DIR "/num.f5.pgm", WORK_DIR "/f5.ref");
+    /* a frame range is still rendered at once */
+    OFCHECK(runDcm2pnm("+Fr 2 3 " WORK_DIR "/m.dcm " WORK_DIR "/range"));
+    checkOutput(WORK_DIR "/range.0.pgm", WORK_DIR "/f2.ref");
+    OFCHECK(runDcm2pnm("+Fr 4 2 --use-frame-number " WORK_DIR "/m.dcm " WORK_DIR "/range"));
+    checkOutput(WORK_DIR "/range.f5.pgm", WORK_DIR "/f5.ref");
+    cleanWorkDir();
+}
@@ -0,0 +1,29 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimage
+ *
+ *  Author:  agent
+ *
+ *  Purpose: main test program
+ *
+ */
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/ofstd/oftest.h"
+
+OFTEST_REGISTER(dcmimage_colorFrameLoops);
+OFTEST_REGISTER(dcmimage_colorKernels);
+OFTEST_REGISTER(dcmimage_multiFrameRendering);
+OFTEST_REGISTER(dcmimage_dcm2pnm_scanDirectories);
+OFTEST_REGISTER(dcmimage_dcm2pnm_readFileList);
+OFTEST_REGISTER(dcmimage_dcm2pnm_filenameTemplate);
+OFTEST_REGISTER(dcmimage_dcm2pnm_batchThreads);
+OFTEST_REGISTER(dcmimage_dcm2pnm_failedFiles);
+OFTEST_REGISTER(dcmimage_dcm2pnm_allFrames);
+
+OFTEST_MAIN("dcmimage")
@@ -0,0 +1,270 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimage
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the vectorized and multi-threaded color conversion kernels
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmimgle/dcmimage.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
+#include "dcmtk/dcmimgle/diparal.h"
+#include "dcmtk/dcmimage/diregist.h"  /* include to support color images */
+#include "dcmtk/dcmimage/dicokrnl.h"
+
+
+/* number of pixels, odd and not a multiple of any vector size */
+#define PIXEL_COUNT 4099
+/* the kernels are called with all offsets up to this value (unaligned access) */
+#define MAX_OFFSET 33
+
+/* number of pixels per plane and number of frames for the multi-frame tests,
+ * the frames are smaller than the minimum block size of a parallel loop */
+#define PLANE_SIZE 30001
+#define FRAMES 9
+
+
+/* simple pseudo random number generator, so that the test is reproducible */
+static Uint32 nextRandom(Uint32 &state)
+{
+    state = state * 1103515245 + 12345;
+    return state >> 8;
+}
+
+
+/* fill the given buffer with pseudo random values */
+static void fillRandom(Uint8 *buffer,
+                       const unsigned long count,
+                       Uint32 &state)
+{
+    for (unsigned long i = 0; i < count; ++i)
+        buffer[i] = OFstatic_cast(Uint8, nextRandom(state));
+}
+
+
+/* compare the vectorized color kernels with the generic version, 'src' contains at least
+ * three planes of PIXEL_COUNT values each
+ */
+static void checkColorKernels(const Uint8 *src)
+{
+    const char *isName = DiMonoKernels::getInstructionSetName(DiMonoKernels::getInstructionSet());
+    Uint8 *expected = new Uint8[3 * PIXEL_COUNT];
+    Uint8 *result = new Uint8[3 * PIXEL_COUNT];
+    for (unsigned long offset = 0; offset <= MAX_OFFSET; ++offset)
+    {
+        const unsigned long count = PIXEL_COUNT - offset;
+        const Uint8 *s = src + offset;
+        Uint8 *e0 = expected, *e1 = expected + count, *e2 = expected + 2 * count;
+        Uint8 *r0 = result, *r1 = result + count, *r2 = result + 2 * count;
+        /* YCbCr (full) color-by-plane and color-by-pixel */
+        memset(expected, 0, 3 * PIXEL_COUNT);
+        memset(result, 0, 3 * PIXEL_COUNT);
+        DiColorKernels::convertYBRToRGB<Uint8, Uint8>(s, s + count, s + 2 * count, 1, e0, e1, e2, count, 255);
+        DiColorKernels::convertYBRToRGB(s, s + count, s + 2 * count, 1, r0, r1, r2, count, 255);
+        if (memcmp(expected, result, 3 * count) != 0)
+            OFCHECK_FAIL("convertYBRToRGB() differs for color-by-plane with " << isName << " at offset " << offset);
+        memset(expected, 0, 3 * PIXEL_COUNT);
+        memset(result, 0, 3 * PIXEL_COUNT);
+        DiColorKernels::convertYBRToRGB<Uint8, Uint8>(s, s + 1, s + 2, 3, e0, e1, e2, count, 255);
+        DiColorKernels::convertYBRToRGB(s, s + 1, s + 2, 3, r0, r1, r2, count, 255);
+        if (memcmp(expected, result, 3 * count) != 0)
+            OFCHECK_FAIL("convertYBRToRGB() differs for color-by-pixel with " << isName << " at offset " << offset);
+        /* YCbCr 4:2:2 full and partial */
+        for (int partial = 0; partial < 2; ++partial)
+        {
+            memset(expected, 0, 3 * PIXEL_COUNT);
+            memset(result, 0, 3 * PIXEL_COUNT);
+            DiColorKernels::convertYBR422ToRGB<Uint8, Uint8>(s, 0, e0, e1, e2, count / 2, 255, partial != 0);
+            DiColorKernels::convertYBR422ToRGB(s, 0, r0, r1, r2, count / 2, 255, partial != 0);
+            if (memcmp(expected, result, 3 * count) != 0)
+            {
+                OFCHECK_FAIL("convertYBR422ToRGB() differs for YCbCr " << (partial ? "partial" : "full") << " with "
+                    << isName << " at offset " << offset);
+            }
+        }
+        /* separate and interleave planes */
+        memset(expected, 0, 3 * PIXEL_COUNT);
+        memset(result, 0, 3 * PIXEL_COUNT);
+        DiColorKernels::splitPlanes<Uint8, Uint8>(s, 0, e0, e1, e2, count);
+        DiColorKernels::splitPlanes(s, 0, r0, r1, r2, count);
+        if (memcmp(expected, result, 3 * count) != 0)
+            OFCHECK_FAIL("splitPlanes() differs with " << isName << " at offset " << offset);
+        for (int inverse = 0; inverse < 2; ++inverse)
+        {
+            memset(expected, 0, 3 * PIXEL_COUNT);
+            memset(result, 0, 3 * PIXEL_COUNT);
+            DiColorKernels::mergePlanes<Uint8, Uint8>(s, s + count, s + 2 * count, expected, count, inverse != 0, 255);
+            DiColorKernels::mergePlanes(s, s + count, s + 2 * count, result, count, inverse != 0, 255);
+            if (memcmp(expected, result, 3 * count) != 0)
+                OFCHECK_FAIL("mergePlanes() differs with " << isName << " at offset " << offset << (inverse ? " (inverse)" : ""));
+        }
+    }
+    delete[] result;
+    delete[] expected;
+}
+
+
+/* convert color-by-plane frames frame by frame with the generic kernels, an incomplete
+ * last frame is handled like the pixel templates do
+ */
+static void convertFrames(const Uint8 *src,
+                          Uint8 *dst0,
+                          Uint8 *dst1,
+                          Uint8 *dst2,
+                          const unsigned long count,
+                          const OFBool ybr)
+{
+    for (unsigned long start = 0; start < count; start += PLANE_SIZE)
+    {
+        const Uint8 *s = src + 3 * start;
+        const unsigned long n = (count - start < PLANE_SIZE) ? count - start : PLANE_SIZE;
+        if (ybr)
+        {
+            DiColorKernels::convertYBRToRGB<Uint8, Uint8>(s, s + PLANE_SIZE, s + 2 * PLANE_SIZE, 1,
+                dst0 + start, dst1 + start, dst2 + start, n, 255);
+        } else {
+            memcpy(dst0 + start, s, n);
+            memcpy(dst1 + start, s + n, n);
+            memcpy(dst2 + start, s + 2 * n, n);
+        }
+    }
+}
+
+
+OFTEST(dcmimage_colorKernels)
+{
+    Uint32 state = 4711;
+    Uint8 *src = new Uint8[3 * PIXEL_COUNT + MAX_OFFSET];
+    fillRandom(src, 3 * PIXEL_COUNT + MAX_OFFSET, state);
+    /* the extreme values are placed in the last pixels (and therefore in the scalar tail of the vectorized versions) */
+    src[3 * PIXEL_COUNT - 2] = 0;
+    src[3 * PIXEL_COUNT - 1] = 255;
+    /* check all instruction sets supported by the CPU (the scalar one is compared with itself) */
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+    const DiMonoKernels::E_InstructionSet supported = DiMonoKernels::getInstructionSet();
+    for (int level = DiMonoKernels::IS_Scalar; level <= supported; ++level)
+    {
+        DiMonoKernels::setMaxInstructionSet(OFstatic_cast(DiMonoKernels::E_InstructionSet, level));
+        OFCHECK_EQUAL(DiMonoKernels::getInstructionSet(), level);
+        checkColorKernels(src);
+    }
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+    delete[] src;
+}
+
+
+OFTEST(dcmimage_colorFrameLoops)
+{
+    Uint32 state = 815;
+    const unsigned long size = 3 * FRAMES * PLANE_SIZE;
+    Uint8 *src = new Uint8[size];
+    Uint8 *expected = new Uint8[size];
+    Uint8 *result = new Uint8[size];
+    fillRandom(src, size, state);
+    const Uint32 maxThreads = dcmRenderingMaxThreads.get();
+    /* complete frames and an incomplete last frame */
+    const unsigned long counts[2] = { FRAMES * PLANE_SIZE, FRAMES * PLANE_SIZE - 12345 };
+    for (int c = 0; c < 2; ++c)
+    {
+        const unsigned long count = counts[c];
+        for (int ybr = 0; ybr < 2; ++ybr)
+        {
+            memset(expected, 0, size);
+            convertFrames(src, expected, expected + count, expected + 2 * count, count, ybr != 0);
+            for (Uint32 threads = 1; threads <= 4; ++threads)
+            {
+                dcmRenderingMaxThreads.set(threads);
+                memset(result, 0, size);
+                if (ybr)
+                {
+                    DiColorYBRLoop<Uint8, Uint8> loop(src, src + PLANE_SIZE, src + 2 * PLANE_SIZE, 1,
+                        result, result + count, result + 2 * count, count, 255, PLANE_SIZE);
+                    loop.run();
+                } else {
+                    DiColorPlanesLoop<Uint8, Uint8> loop(src, 0, result, result + count, result + 2 * count, count, PLANE_SIZE);
+                    loop.run();
+                }
+                if (memcmp(expected, result, 3 * count) != 0)
+                {
+                    OFCHECK_FAIL((ybr ? "DiColorYBRLoop" : "DiColorPlanesLoop") << " differs for " << count << " pixels with "
+                        << threads << " thread(s)");
+                }
+            }
+        }
+    }
+    dcmRenderingMaxThreads.set(maxThreads);
+    delete[] result;
+    delete[] expected;
+    delete[] src;
+}
+
+
+OFTEST(dcmimage_multiFrameRendering)
+{
+    const Uint16 columns = 173;
+    const Uint16 rows = 149;
+    const unsigned long count = OFstatic_cast(unsigned long, columns) * rows;
+    const unsigned long frames = 11;
+    Uint32 state = 1;
+    Uint8 *pixels = new Uint8[3 * frames * count];
+    fillRandom(pixels, 3 * frames * count, state);
+    Uint8 *rgb = new Uint8[3 * count];
+    Uint8 *expected = new Uint8[3 * count];
+    const Uint32 maxThreads = dcmRenderingMaxThreads.get();
+    for (int ybr = 0; ybr < 2; ++ybr)
+    {
+        DcmDataset dset;
+        dset.putAndInsertString(DCM_PhotometricInterpretation, ybr ? "YBR_FULL" : "RGB");
+        dset.putAndInsertUint16(DCM_SamplesPerPixel, 3);
+        dset.putAndInsertUint16(DCM_PlanarConfiguration, 1);
+        dset.putAndInsertUint16(DCM_Rows, rows);
+        dset.putAndInsertUint16(DCM_Columns, columns);
+        dset.putAndInsertString(DCM_NumberOfFrames, "11");
+        dset.putAndInsertUint16(DCM_BitsAllocated, 8);
+        dset.putAndInsertUint16(DCM_BitsStored, 8);
+        dset.putAndInsertUint16(DCM_HighBit, 7);
+        dset.putAndInsertUint16(DCM_PixelRepresentation, 0);
+        dset.putAndInsertUint8Array(DCM_PixelData, pixels, 3 * frames * count);
+        for (Uint32 threads = 1; threads <= 4; threads += 3)
+        {
+            dcmRenderingMaxThreads.set(threads);
+            /* the color model is converted for all frames when the image is created */
+            DicomImage image(&dset, EXS_LittleEndianExplicit);
+            OFCHECK(image.getStatus() == EIS_Normal);
+            OFCHECK_EQUAL(image.getFrameCount(), frames);
+            for (unsigned long frame = 0; frame < image.getFrameCount(); ++frame)
+            {
+                const Uint8 *src = pixels + 3 * frame * count;
+                if (ybr)
+                    DiColorKernels::convertYBRToRGB<Uint8, Uint8>(src, src + count, src + 2 * count, 1, rgb, rgb + count, rgb + 2 * count, count, 255);
+                else
+                    memcpy(rgb, src, 3 * count);
+                DiColorKernels::mergePlanes<Uint8, Uint8>(rgb, rgb + count, rgb + 2 * count, expected, count, OFFalse, 255);
+                const void *data = image.getOutputData(8, frame);
+                if ((data == NULL) || (memcmp(data, expected, 3 * count) != 0))
+                {
+                    OFCHECK_FAIL("rendering of " << (ybr ? "YBR_FULL" : "RGB") << " frame " << frame << " differs with "
+                        << threads << " thread(s)");
+                }
+            }
+        }
+    }
+    dcmRenderingMaxThreads.set(maxThreads);
+    delete[] expected;
+    delete[] rgb;
+    delete[] pixels;
+}
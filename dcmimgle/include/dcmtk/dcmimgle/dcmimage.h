@@ -451,6 +451,38 @@ class DCMTK_DCMIMGLE_EXPORT DicomImage
             Image->getOutputData(buffer, size, frame, Image->getBits(bits), planar) : 0;
     }
 
+    /** render a strip of rows of the pixel data and output to given memory buffer.
+     *  Same as getOutputData() but only the rows 'firstRow' to 'firstRow + rowCount - 1'
+     *  are rendered, so a frame can be processed step by step without the need for a
+     *  memory buffer that holds the complete frame (see also DiStripRenderer).
+     *  The pastel color mode is not supported.
+     *
+     ** @param  buffer    pointer to memory buffer (must already be allocated)
+     *  @param  size      size of memory buffer (will be checked whether it is sufficient,
+     *                    i.e. getOutputDataSize(bits) / getHeight() * rowCount bytes)
+     *  @param  firstRow  first row to be rendered (0..height-1)
+     *  @param  rowCount  number of rows to be rendered (1..height-firstRow)
+     *  @param  bits      number of bits per sample used to render the pixel data
+     *                    (image depth, 1..MAX_BITS, 0 means 'bits stored' in the image)
+     *  @param  frame     number of frame to be rendered (0..n-1)
+     *  @param  planar    0 = color-by-pixel (R1G1B1...R2G2B2...R3G3B3...),
+     *                    1 = color-by-plane (R1R2R3...G1G2G3...B1B2B3..., for the given rows)
+     *                    (only applicable to multi-planar/color images, otherwise ignored)
+     *
+     ** @return status code (true if successful)
+     */
+    inline int getOutputRows(void *buffer,
+                             const unsigned long size,
+                             const unsigned long firstRow,
+                             const unsigned long rowCount,
+                             const int bits = 0,
+                             const unsigned long frame = 0,
+                             const int planar = 0)
+    {
+        return (Image != NULL) ?
+            Image->getOutputRows(buffer, size, frame, Image->getBits(bits), firstRow, rowCount, planar) : 0;
+    }
+
     /** render pixel data and return pointer to given plane (internal memory buffer).
      *  apply VOI/PLUT transformation and (visible) overlay planes
      *  internal memory buffer will be delete for the next getBitmap/Output operation.
@@ -1371,7 +1403,7 @@ class DCMTK_DCMIMGLE_EXPORT DicomImage
      *  @param  interpolate  specifies whether scaling algorithm should use interpolation (if necessary).
      *                       default: no interpolation (0), preferred interpolation algorithm (if applicable):
      *                         1 = pbmplus algorithm, 2 = c't algorithm, 3 = bilinear magnification,
-     *                         4 = bicubic magnification
+     *                         4 = bicubic magnification, 5 = area averaging reduction (box filter)
      *  @param  aspect       specifies whether pixel aspect ratio should be taken into consideration
      *                       (if true, width OR height should be 0, i.e. this component will be calculated
      *                        automatically)
@@ -1391,7 +1423,7 @@ class DCMTK_DCMIMGLE_EXPORT DicomImage
      *  @param  interpolate  specifies whether scaling algorithm should use interpolation (if necessary).
      *                       default: no interpolation (0), preferred interpolation algorithm (if applicable):
      *                         1 = pbmplus algorithm, 2 = c't algorithm, 3 = bilinear magnification,
-     *                         4 = bicubic magnification
+     *                         4 = bicubic magnification, 5 = area averaging reduction (box filter)
      *  @param  aspect       specifies whether pixel aspect ratio should be taken into consideration
      *                       (if true, width OR height should be 0, i.e. this component will be calculated
      *                        automatically)
@@ -1417,7 +1449,7 @@ class DCMTK_DCMIMGLE_EXPORT DicomImage
      *  @param  interpolate   specifies whether scaling algorithm should use interpolation (if necessary).
      *                        default: no interpolation (0), preferred interpolation algorithm (if applicable):
      *                          1 = pbmplus algorithm, 2 = c't algorithm, 3 = bilinear magnification,
-     *                          4 = bicubic magnification
+     *                          4 = bicubic magnification, 5 = area averaging reduction (box filter)
      *  @param  aspect        specifies whether pixel aspect ratio should be taken into consideration
      *                        (if true, width OR height should be 0, i.e. this component will be calculated
      *                         automatically)
@@ -1449,7 +1481,7 @@ class DCMTK_DCMIMGLE_EXPORT DicomImage
      *  @param  interpolate  specifies whether scaling algorithm should use interpolation (if necessary).
      *                       default: no interpolation (0), preferred interpolation algorithm (if applicable):
      *                         1 = pbmplus algorithm, 2 = c't algorithm, 3 = bilinear magnification,
-     *                         4 = bicubic magnification
+     *                         4 = bicubic magnification, 5 = area averaging reduction (box filter)
      *  @param  aspect       specifies whether pixel aspect ratio should be taken into consideration
      *                       (if true, width OR height should be 0, i.e. this component will be calculated
      *                        automatically)
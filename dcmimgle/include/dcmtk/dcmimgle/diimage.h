@@ -55,6 +55,7 @@ class DcmUnsignedShort;
 class DiPixel;
 class DiMonoImage;
 class DiInputPixel;
+class DiMonoOutputLUT;
 
 
 /*---------------------*
@@ -302,6 +303,33 @@ class DCMTK_DCMIMGLE_EXPORT DiImage
                               const int bits,
                               const int planar) = 0;
 
+    /** get pixel data of a strip of rows with specified format (abstract).
+     *  (memory is handled externally)
+     *  This allows for rendering a frame step by step, e.g. while it is written to a file.
+     *
+     ** @param  buffer    untyped pointer to the externally allocated memory buffer
+     *  @param  size      size of the memory buffer in bytes (will be checked, at least
+     *                    getOutputDataSize() / getRows() * 'rowCount' bytes required)
+     *  @param  frame     number of frame to be rendered
+     *  @param  bits      number of bits for the output pixel data (depth)
+     *  @param  firstRow  first row to be rendered (starting from 0)
+     *  @param  rowCount  number of rows to be rendered (at least 1, 'firstRow' + 'rowCount'
+     *                    should not be greater than the number of rows)
+     *  @param  planar    flag, whether the output data (for multi-planar images) should be planar or not
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (optional, maybe NULL,
+     *                    only used for monochrome images)
+     *
+     ** @return status, true if successful, false otherwise
+     */
+    virtual int getOutputRows(void *buffer,
+                              const unsigned long size,
+                              const unsigned long frame,
+                              const int bits,
+                              const unsigned long firstRow,
+                              const unsigned long rowCount,
+                              const int planar,
+                              DiMonoOutputLUT *sharedLUT = NULL) = 0;
+
     /** get pixel data of specified plane (abstract).
      *  (memory is handled internally)
      *
@@ -357,7 +385,7 @@ class DCMTK_DCMIMGLE_EXPORT DiImage
      *  @param  interpolate   specifies whether scaling algorithm should use interpolation (if necessary).
      *                        default: no interpolation (0), preferred interpolation algorithm (if applicable):
      *                          1 = pbmplus algorithm, 2 = c't algorithm, 3 = bilinear magnification,
-     *                          4 = bicubic magnification
+     *                          4 = bicubic magnification, 5 = area averaging reduction (box filter)
      *  @param  aspect        specifies whether pixel aspect ratio should be taken into consideration
      *                        (if true, width OR height should be 0, i.e. this component will be calculated
      *                         automatically)
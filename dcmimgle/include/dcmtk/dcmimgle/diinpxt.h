@@ -32,6 +32,7 @@
 #include "dcmtk/dcmimgle/diinpx.h"
 #include "dcmtk/dcmimgle/didocu.h"
 #include "dcmtk/dcmimgle/dipxrept.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
 
 
 /*--------------------*
@@ -182,102 +183,34 @@ class DiInputPixelTemplate
         if (Data != NULL)
         {
             DCMIMGLE_DEBUG("determining minimum and maximum pixel values for input data");
-            register T2 *p = Data;
-            register unsigned long i;
-            const unsigned long ocnt = OFstatic_cast(unsigned long, getAbsMaxRange());
-            Uint8 *lut = NULL;
-            if ((sizeof(T2) <= 2) && (Count > 3 * ocnt))               // optimization criteria
+            /* the vectorized routine is also faster than the LUT-based method used before */
+            if (Count > PixelCount)                                    // calculate min/max for selected range
             {
-                lut = new Uint8[ocnt];
-                if (lut != NULL)
-                {
-                    DCMIMGLE_DEBUG("using optimized routine with additional LUT");
-                    OFBitmanipTemplate<Uint8>::zeroMem(lut, ocnt);
-                    register Uint8 *q = lut - OFstatic_cast(T2, getAbsMinimum());
-                    for (i = Count; i != 0; --i)                       // fill lookup table
-                        *(q + *(p++)) = 1;
-                    q = lut;
-                    for (i = 0; i < ocnt; ++i)                         // search for minimum
-                    {
-                        if (*(q++) != 0)
-                        {
-                            MinValue[0] = OFstatic_cast(T2, OFstatic_cast(double, i) + getAbsMinimum());
-                            break;
-                        }
-                    }
-                    q = lut + ocnt;
-                    for (i = ocnt; i != 0; --i)                        // search for maximum
-                    {
-                        if (*(--q) != 0)
-                        {
-                            MaxValue[0] = OFstatic_cast(T2, OFstatic_cast(double, i - 1) + getAbsMinimum());
-                            break;
-                        }
-                    }
-                    if (Count >= PixelCount)                           // use global min/max value
-                    {
-                        MinValue[1] = MinValue[0];
-                        MaxValue[1] = MaxValue[0];
-                    } else {                                           // calculate min/max for selected range
-                        OFBitmanipTemplate<Uint8>::zeroMem(lut, ocnt);
-                        p = Data + PixelStart;
-                        q = lut - OFstatic_cast(T2, getAbsMinimum());
-                        for (i = PixelCount; i != 0; --i)                  // fill lookup table
-                            *(q + *(p++)) = 1;
-                        q = lut;
-                        for (i = 0; i < ocnt; ++i)                         // search for minimum
-                        {
-                            if (*(q++) != 0)
-                            {
-                                MinValue[1] = OFstatic_cast(T2, OFstatic_cast(double, i) + getAbsMinimum());
-                                break;
-                            }
-                        }
-                        q = lut + ocnt;
-                        for (i = ocnt; i != 0; --i)                         // search for maximum
-                        {
-                            if (*(--q) != 0)
-                            {
-                                MaxValue[1] = OFstatic_cast(T2, OFstatic_cast(double, i - 1) + getAbsMinimum());
-                                break;
-                            }
-                        }
-                    }
-                }
+                MinValue[1] = Data[PixelStart];
+                MaxValue[1] = MinValue[1];
+                DiMonoKernels::determineMinMax(Data + PixelStart, PixelCount, MinValue[1], MaxValue[1]);
+                /* global min/max = selected range plus pixels before and after this range */
+                MinValue[0] = MinValue[1];
+                MaxValue[0] = MaxValue[1];
+                T2 minvalue = MinValue[0];
+                T2 maxvalue = MaxValue[0];
+                DiMonoKernels::determineMinMax(Data, PixelStart, minvalue, maxvalue);
+                if (minvalue < MinValue[0])
+                    MinValue[0] = minvalue;
+                if (maxvalue > MaxValue[0])
+                    MaxValue[0] = maxvalue;
+                DiMonoKernels::determineMinMax(Data + PixelStart + PixelCount, Count - PixelStart - PixelCount, minvalue, maxvalue);
+                if (minvalue < MinValue[0])
+                    MinValue[0] = minvalue;
+                if (maxvalue > MaxValue[0])
+                    MaxValue[0] = maxvalue;
             }
-            if (lut == NULL)                                           // use conventional method
+            else if (Count > 0)                                        // use global min/max value
             {
-                register T2 value = *p;
-                MinValue[0] = value;
-                MaxValue[0] = value;
-                for (i = Count; i > 1; --i)
-                {
-                    value = *(++p);
-                    if (value < MinValue[0])
-                        MinValue[0] = value;
-                    else if (value > MaxValue[0])
-                        MaxValue[0] = value;
-                }
-                if (Count <= PixelCount)                               // use global min/max value
-                {
-                    MinValue[1] = MinValue[0];
-                    MaxValue[1] = MaxValue[0];
-                } else {                                               // calculate min/max for selected range
-                    p = Data + PixelStart;
-                    value = *p;
-                    MinValue[1] = value;
-                    MaxValue[1] = value;
-                    for (i = PixelCount; i > 1; --i)
-                    {
-                        value = *(++p);
-                        if (value < MinValue[1])
-                            MinValue[1] = value;
-                        else if (value > MaxValue[1])
-                            MaxValue[1] = value;
-                    }
-                }
+                DiMonoKernels::determineMinMax(Data, Count, MinValue[0], MaxValue[0]);
+                MinValue[1] = MinValue[0];
+                MaxValue[1] = MaxValue[0];
             }
-            delete[] lut;
             return 1;
         }
         return 0;
@@ -377,6 +310,49 @@ class DiInputPixelTemplate
 #ifdef DEBUG
             DCMIMGLE_TRACE("PixelCount: " << PixelCount << ", byteFactor: " << byteFactor << ", bytes_T1: " << bytes_T1 << ", count_T1: " << count_T1);
 #endif
+            /* read uncompressed frames directly into the output buffer if no conversion is required */
+            if (uncompressed && (sizeof(T1) == sizeof(T2)) && (bitsof_T1 == bitsAllocated) && (bitsStored == bitsAllocated))
+            {
+#ifdef HAVE_STD__NOTHROW
+                /* use a non-throwing new here (if available) because the allocated buffer can be huge */
+                Data = new (std::nothrow) T2[count_T1];
+#else
+                /* make sure that the pointer is set to NULL in case of error */
+                try
+                {
+                    Data = new T2[count_T1];
+                }
+                catch (STD_NAMESPACE bad_alloc const &)
+                {
+                    Data = NULL;
+                }
+#endif
+                if (Data != NULL)
+                {
+                    DCMIMGLE_DEBUG("using partial read access to uncompressed pixel data (without conversion)");
+                    const OFCondition status = pixelData->getUncompressedFrames(document->getDataset(), FirstFrame, NumberOfFrames,
+                        Data, count_T1 * bytes_T1, lengthBytes, fileCache);
+                    if (status.good())
+                    {
+                        PixelStart = 0;
+                        Count = lengthBytes / bytes_T1;
+                    } else {
+                        DCMIMGLE_ERROR("can't access frames " << FirstFrame << " to " << (FirstFrame + NumberOfFrames - 1)
+                            << ": " << status.text());
+                        /* in case of error, reset pixel count variable */
+                        Count = 0;
+#if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
+                        /* use a non-throwing delete (if available) */
+                        operator delete[] (Data, std::nothrow);
+#else
+                        delete[] Data;
+#endif
+                        Data = NULL;
+                    }
+                } else
+                    DCMIMGLE_DEBUG("cannot allocate memory buffer for 'Data' in DiInputPixelTemplate::convert()");
+                return;
+            }
             /* allocate temporary buffer, even number of bytes required for getUncompressedFrame() */
             const Uint32 extraByte = ((sizeof(T1) == 1) && (count_T1 & 1)) ? 1 : 0;
 #ifdef HAVE_STD__NOTHROW
@@ -398,16 +374,13 @@ class DiInputPixelTemplate
                 if (uncompressed)
                 {
                     DCMIMGLE_DEBUG("using partial read access to uncompressed pixel data");
-                    const Uint32 offset = PixelStart * byteFactor;
-                    const Uint32 bufSize = PixelCount * byteFactor;
-                    const OFCondition status = pixelData->getPartialValue(pixel, offset, bufSize, fileCache);
+                    const OFCondition status = pixelData->getUncompressedFrames(document->getDataset(), FirstFrame, NumberOfFrames,
+                        pixel, (count_T1 + extraByte) * bytes_T1, lengthBytes, fileCache);
                     if (status.good())
-                    {
                         PixelStart = 0;
-                        lengthBytes = bufSize;
-                    } else {
-                        DCMIMGLE_ERROR("can't access partial value from byte offset " << offset << " to "
-                            << (offset + bufSize - 1) << ": " << status.text());
+                    else {
+                        DCMIMGLE_ERROR("can't access frames " << FirstFrame << " to " << (FirstFrame + NumberOfFrames - 1)
+                            << ": " << status.text());
                     }
                 } else {
                     DCMIMGLE_DEBUG("using partial read access to compressed pixel data");
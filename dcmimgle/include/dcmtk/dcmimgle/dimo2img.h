@@ -142,6 +142,29 @@ class DCMTK_DCMIMGLE_EXPORT DiMono2Image
                               const int bits,
                               const int planar = 0);
 
+    /** get pixel data of a strip of rows with specified format.
+     *  (memory is handled externally)
+     *
+     ** @param  buffer    untyped pointer to the externally allocated memory buffer
+     *  @param  size      size of the memory buffer in bytes (will be checked)
+     *  @param  frame     number of frame to be rendered
+     *  @param  bits      number of bits for the output pixel data (depth)
+     *  @param  firstRow  first row to be rendered (starting from 0)
+     *  @param  rowCount  number of rows to be rendered
+     *  @param  planar    flags, whether the output data (for multi-planar images) should be planar or not
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (optional, maybe NULL)
+     *
+     ** @return status, true if successful, false otherwise
+     */
+    virtual int getOutputRows(void *buffer,
+                              const unsigned long size,
+                              const unsigned long frame,
+                              const int bits,
+                              const unsigned long firstRow,
+                              const unsigned long rowCount,
+                              const int planar = 0,
+                              DiMonoOutputLUT *sharedLUT = NULL);
+
     /** create copy of current image object
      *
      ** @param  fstart  first frame to be processed
@@ -164,7 +187,7 @@ class DCMTK_DCMIMGLE_EXPORT DiMono2Image
      *  @param  interpolate   specifies whether scaling algorithm should use interpolation (if necessary).
      *                        default: no interpolation (0), preferred interpolation algorithm (if applicable):
      *                          1 = pbmplus algorithm, 2 = c't algorithm, 3 = bilinear magnification,
-     *                          4 = bicubic magnification
+     *                          4 = bicubic magnification, 5 = area averaging reduction (box filter)
      *  @param  aspect        specifies whether pixel aspect ratio should be taken into consideration
      *                        (if true, width OR height should be 0, i.e. this component will be calculated
      *                         automatically)
@@ -249,7 +272,7 @@ class DCMTK_DCMIMGLE_EXPORT DiMono2Image
      *  @param  interpolate   specifies whether scaling algorithm should use interpolation (if necessary).
      *                        default: no interpolation (0), preferred interpolation algorithm (if applicable):
      *                          1 = pbmplus algorithm, 2 = c't algorithm, 3 = bilinear magnification,
-     *                          4 = bicubic magnification
+     *                          4 = bicubic magnification, 5 = area averaging reduction (box filter)
      *  @param  aspect        specifies whether pixel aspect ratio should be taken into consideration
      *                        (if true, width OR height should be 0, i.e. this component will be calculated
      *                         automatically)
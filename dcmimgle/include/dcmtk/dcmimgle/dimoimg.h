@@ -561,6 +561,29 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoImage
                               const int bits,
                               const int planar = 0) = 0;
 
+    /** get pixel data of a strip of rows with specified format.
+     *  (memory is handled externally)
+     *
+     ** @param  buffer    untyped pointer to the externally allocated memory buffer
+     *  @param  size      size of the memory buffer in bytes (will be checked)
+     *  @param  frame     number of frame to be rendered
+     *  @param  bits      number of bits for the output pixel data (depth)
+     *  @param  firstRow  first row to be rendered (starting from 0)
+     *  @param  rowCount  number of rows to be rendered
+     *  @param  planar    flag, only useful for multi-planar images (color)
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (optional, maybe NULL)
+     *
+     ** @return status, true if successful, false otherwise
+     */
+    virtual int getOutputRows(void *buffer,
+                              const unsigned long size,
+                              const unsigned long frame,
+                              const int bits,
+                              const unsigned long firstRow,
+                              const unsigned long rowCount,
+                              const int planar = 0,
+                              DiMonoOutputLUT *sharedLUT = NULL) = 0;
+
     /** get pixel data of specified plane.
      *  (memory is handled internally)
      *
@@ -846,7 +869,7 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoImage
      *  @param  interpolate   specifies whether scaling algorithm should use interpolation (if necessary).
      *                        default: no interpolation (0), preferred interpolation algorithm (if applicable):
      *                          1 = pbmplus algorithm, 2 = c't algorithm, 3 = bilinear magnification,
-     *                          4 = bicubic magnification
+     *                          4 = bicubic magnification, 5 = area averaging reduction (box filter)
      *  @param  aspect        specifies whether pixel aspect ratio should be taken into consideration
      *                        (if true, width OR height should be 0, i.e. this component will be calculated
      *                         automatically)
@@ -963,6 +986,9 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoImage
      *  @param  bits      number of bits for the output pixel data (depth)
      *  @param  planar    flag, only useful for multi-planar images (color)
      *  @param  negative  invert pixel data if true
+     *  @param  firstRow  first row to be rendered (optional, used to render a strip of rows)
+     *  @param  rowCount  number of rows to be rendered (optional, 0 = all rows starting from 'firstRow')
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (optional, maybe NULL)
      *
      ** @return untyped pointer to the pixel data if successful, NULL otherwise
      */
@@ -971,18 +997,24 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoImage
                         const unsigned long frame,
                         int bits,
                         const int planar,
-                        const int negative);
+                        const int negative,
+                        const unsigned long firstRow = 0,
+                        const unsigned long rowCount = 0,
+                        DiMonoOutputLUT *sharedLUT = NULL);
 
     /** get pixel data with specified format for Uint8 input (helper function).
      *  (memory is handled externally)
      *
-     ** @param  buffer   untyped pointer to the externally allocated memory buffer
-     *  @param  disp     pointer to current display function object
-     *  @param  samples  number of samples per pixel
-     *  @param  frame    number of frame to be rendered
-     *  @param  bits     number of bits for the output pixel data (depth)
-     *  @param  low      output pixel value to which 0 is mapped (min)
-     *  @param  high     output pixel value to which 2^bits-1 is mapped (max)
+     ** @param  buffer    untyped pointer to the externally allocated memory buffer
+     *  @param  disp      pointer to current display function object
+     *  @param  samples   number of samples per pixel
+     *  @param  frame     number of frame to be rendered
+     *  @param  bits      number of bits for the output pixel data (depth)
+     *  @param  low       output pixel value to which 0 is mapped (min)
+     *  @param  high      output pixel value to which 2^bits-1 is mapped (max)
+     *  @param  firstRow  first row to be rendered
+     *  @param  rowCount  number of rows to be rendered (0 = all rows starting from 'firstRow')
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (maybe NULL)
      */
     void getDataUint8(void *buffer,
                       DiDisplayFunction *disp,
@@ -990,18 +1022,24 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoImage
                       const unsigned long frame,
                       const int bits,
                       const Uint32 low,
-                      const Uint32 high);
+                      const Uint32 high,
+                      const unsigned long firstRow,
+                      const unsigned long rowCount,
+                      DiMonoOutputLUT *sharedLUT);
 
     /** get pixel data with specified format for Sint8 input (helper function).
      *  (memory is handled externally)
      *
-     ** @param  buffer   untyped pointer to the externally allocated memory buffer
-     *  @param  disp     pointer to current display function object
-     *  @param  samples  number of samples per pixel
-     *  @param  frame    number of frame to be rendered
-     *  @param  bits     number of bits for the output pixel data (depth)
-     *  @param  low      output pixel value to which 0 is mapped (min)
-     *  @param  high     output pixel value to which 2^bits-1 is mapped (max)
+     ** @param  buffer    untyped pointer to the externally allocated memory buffer
+     *  @param  disp      pointer to current display function object
+     *  @param  samples   number of samples per pixel
+     *  @param  frame     number of frame to be rendered
+     *  @param  bits      number of bits for the output pixel data (depth)
+     *  @param  low       output pixel value to which 0 is mapped (min)
+     *  @param  high      output pixel value to which 2^bits-1 is mapped (max)
+     *  @param  firstRow  first row to be rendered
+     *  @param  rowCount  number of rows to be rendered (0 = all rows starting from 'firstRow')
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (maybe NULL)
      */
     void getDataSint8(void *buffer,
                       DiDisplayFunction *disp,
@@ -1009,18 +1047,24 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoImage
                       const unsigned long frame,
                       const int bits,
                       const Uint32 low,
-                      const Uint32 high);
+                      const Uint32 high,
+                      const unsigned long firstRow,
+                      const unsigned long rowCount,
+                      DiMonoOutputLUT *sharedLUT);
 
     /** get pixel data with specified format for Uint16 input (helper function).
      *  (memory is handled externally)
      *
-     ** @param  buffer   untyped pointer to the externally allocated memory buffer
-     *  @param  disp     pointer to current display function object
-     *  @param  samples  number of samples per pixel
-     *  @param  frame    number of frame to be rendered
-     *  @param  bits     number of bits for the output pixel data (depth)
-     *  @param  low      output pixel value to which 0 is mapped (min)
-     *  @param  high     output pixel value to which 2^bits-1 is mapped (max)
+     ** @param  buffer    untyped pointer to the externally allocated memory buffer
+     *  @param  disp      pointer to current display function object
+     *  @param  samples   number of samples per pixel
+     *  @param  frame     number of frame to be rendered
+     *  @param  bits      number of bits for the output pixel data (depth)
+     *  @param  low       output pixel value to which 0 is mapped (min)
+     *  @param  high      output pixel value to which 2^bits-1 is mapped (max)
+     *  @param  firstRow  first row to be rendered
+     *  @param  rowCount  number of rows to be rendered (0 = all rows starting from 'firstRow')
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (maybe NULL)
      */
     void getDataUint16(void *buffer,
                        DiDisplayFunction *disp,
@@ -1028,18 +1072,24 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoImage
                        const unsigned long frame,
                        const int bits,
                        const Uint32 low,
-                       const Uint32 high);
+                       const Uint32 high,
+                       const unsigned long firstRow,
+                       const unsigned long rowCount,
+                       DiMonoOutputLUT *sharedLUT);
 
     /** get pixel data with specified format for Sint16 input (helper function).
      *  (memory is handled externally)
      *
-     ** @param  buffer   untyped pointer to the externally allocated memory buffer
-     *  @param  disp     pointer to current display function object
-     *  @param  samples  number of samples per pixel
-     *  @param  frame    number of frame to be rendered
-     *  @param  bits     number of bits for the output pixel data (depth)
-     *  @param  low      output pixel value to which 0 is mapped (min)
-     *  @param  high     output pixel value to which 2^bits-1 is mapped (max)
+     ** @param  buffer    untyped pointer to the externally allocated memory buffer
+     *  @param  disp      pointer to current display function object
+     *  @param  samples   number of samples per pixel
+     *  @param  frame     number of frame to be rendered
+     *  @param  bits      number of bits for the output pixel data (depth)
+     *  @param  low       output pixel value to which 0 is mapped (min)
+     *  @param  high      output pixel value to which 2^bits-1 is mapped (max)
+     *  @param  firstRow  first row to be rendered
+     *  @param  rowCount  number of rows to be rendered (0 = all rows starting from 'firstRow')
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (maybe NULL)
      */
     void getDataSint16(void *buffer,
                        DiDisplayFunction *disp,
@@ -1047,18 +1097,24 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoImage
                        const unsigned long frame,
                        const int bits,
                        const Uint32 low,
-                       const Uint32 high);
+                       const Uint32 high,
+                       const unsigned long firstRow,
+                       const unsigned long rowCount,
+                       DiMonoOutputLUT *sharedLUT);
 
     /** get pixel data with specified format for Uint32 input (helper function).
      *  (memory is handled externally)
      *
-     ** @param  buffer   untyped pointer to the externally allocated memory buffer
-     *  @param  disp     pointer to current display function object
-     *  @param  samples  number of samples per pixel
-     *  @param  frame    number of frame to be rendered
-     *  @param  bits     number of bits for the output pixel data (depth)
-     *  @param  low      output pixel value to which 0 is mapped (min)
-     *  @param  high     output pixel value to which 2^bits-1 is mapped (max)
+     ** @param  buffer    untyped pointer to the externally allocated memory buffer
+     *  @param  disp      pointer to current display function object
+     *  @param  samples   number of samples per pixel
+     *  @param  frame     number of frame to be rendered
+     *  @param  bits      number of bits for the output pixel data (depth)
+     *  @param  low       output pixel value to which 0 is mapped (min)
+     *  @param  high      output pixel value to which 2^bits-1 is mapped (max)
+     *  @param  firstRow  first row to be rendered
+     *  @param  rowCount  number of rows to be rendered (0 = all rows starting from 'firstRow')
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (maybe NULL)
      */
     void getDataUint32(void *buffer,
                        DiDisplayFunction *disp,
@@ -1066,18 +1122,24 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoImage
                        const unsigned long frame,
                        const int bits,
                        const Uint32 low,
-                       const Uint32 high);
+                       const Uint32 high,
+                       const unsigned long firstRow,
+                       const unsigned long rowCount,
+                       DiMonoOutputLUT *sharedLUT);
 
     /** get pixel data with specified format for Sint32 input (helper function).
      *  (memory is handled externally)
      *
-     ** @param  buffer   untyped pointer to the externally allocated memory buffer
-     *  @param  disp     pointer to current display function object
-     *  @param  samples  number of samples per pixel
-     *  @param  frame    number of frame to be rendered
-     *  @param  bits     number of bits for the output pixel data (depth)
-     *  @param  low      output pixel value to which 0 is mapped (min)
-     *  @param  high     output pixel value to which 2^bits-1 is mapped (max)
+     ** @param  buffer    untyped pointer to the externally allocated memory buffer
+     *  @param  disp      pointer to current display function object
+     *  @param  samples   number of samples per pixel
+     *  @param  frame     number of frame to be rendered
+     *  @param  bits      number of bits for the output pixel data (depth)
+     *  @param  low       output pixel value to which 0 is mapped (min)
+     *  @param  high      output pixel value to which 2^bits-1 is mapped (max)
+     *  @param  firstRow  first row to be rendered
+     *  @param  rowCount  number of rows to be rendered (0 = all rows starting from 'firstRow')
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (maybe NULL)
      */
     void getDataSint32(void *buffer,
                        DiDisplayFunction *disp,
@@ -1085,7 +1147,10 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoImage
                        const unsigned long frame,
                        const int bits,
                        const Uint32 low,
-                       const Uint32 high);
+                       const Uint32 high,
+                       const unsigned long firstRow,
+                       const unsigned long rowCount,
+                       DiMonoOutputLUT *sharedLUT);
 
     /** create a presentation look-up table converting the pixel data which is linear to
      *  Optical Density to DDLs of the softcopy device (used to display print images on screen).
@@ -30,12 +30,90 @@
 
 #include "dcmtk/dcmimgle/dimopxt.h"
 #include "dcmtk/dcmimgle/diinpx.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
+#include "dcmtk/dcmimgle/diparal.h"
 
 
 /*---------------------*
  *  class declaration  *
  *---------------------*/
 
+/** Template class to perform the rescale slope/intercept transform without LUT,
+ *  possibly split into several blocks processed in parallel (see DiParallelLoop)
+ */
+template<class T1, class T3>
+class DiMonoRescaleLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  src        input pixels
+     *  @param  dst        output pixels
+     *  @param  count      number of pixels
+     *  @param  slope      rescale slope value
+     *  @param  intercept  rescale intercept value
+     */
+    DiMonoRescaleLoop(const T1 *src,
+                      T3 *dst,
+                      const unsigned long count,
+                      const double slope,
+                      const double intercept)
+      : DiParallelLoop(count),
+        Source(src),
+        Destination(dst),
+        Slope(slope),
+        Intercept(intercept)
+    {
+    }
+
+ protected:
+
+    /// perform the transform for the given block of pixels
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        const T1 *p = Source + start;
+        T3 *q = Destination + start;
+        unsigned long i;
+        if (Slope == 1.0)
+        {
+            if (Intercept == 0.0)
+            {
+                for (i = end - start; i != 0; --i)   // copy pixel data: can't use copyMem because T1 isn't always equal to T3
+                    *(q++) = OFstatic_cast(T3, *(p++));
+            } else {
+                for (i = end - start; i != 0; --i)
+                    *(q++) = OFstatic_cast(T3, OFstatic_cast(double, *(p++)) + Intercept);
+            }
+        } else {
+            if (Intercept == 0.0)
+            {
+                for (i = end - start; i != 0; --i)
+                    *(q++) = OFstatic_cast(T3, OFstatic_cast(double, *(p++)) * Slope);
+            } else {
+                for (i = end - start; i != 0; --i)
+                    *(q++) = OFstatic_cast(T3, OFstatic_cast(double, *(p++)) * Slope + Intercept);
+            }
+        }
+    }
+
+ private:
+
+    /// input pixels
+    const T1 *Source;
+    /// output pixels
+    T3 *Destination;
+    /// rescale slope value
+    const double Slope;
+    /// rescale intercept value
+    const double Intercept;
+};
+
+
 /** Template class to convert monochrome pixel data to intermediate representation
  */
 template<class T1, class T2, class T3>
@@ -99,7 +177,7 @@ class DiMonoInputPixelTemplate
         int result = 0;
         if ((sizeof(T1) <= 2) && (this->InputCount > 3 * ocnt))               // optimization criteria
         {                                                                     // use LUT for optimization
-            lut = new T3[ocnt];
+            lut = new T3[ocnt + 4];                                           // padding required by DiMonoKernels::applyLUT()
             if (lut != NULL)
             {
                 DCMIMGLE_DEBUG("using optimized routine with additional LUT");
@@ -157,9 +235,7 @@ class DiMonoInputPixelTemplate
                                 *(q++) = OFstatic_cast(T3, mlut->getValue(value));
                         }
                         const T3 *lut0 = lut - OFstatic_cast(T2, absmin);                 // points to 'zero' entry
-                        q = this->Data;
-                        for (i = this->InputCount; i != 0; --i)                           // apply LUT
-                            *(q++) = *(lut0 + (*(p++)));
+                        DiMonoLUTLoop<T1, T3>(p, this->Data, this->InputCount, lut0).run();  // apply LUT
                     }
                     if (lut == NULL)                                                      // use "normal" transformation
                     {
@@ -207,12 +283,8 @@ class DiMonoInputPixelTemplate
                 register unsigned long i;
                 if ((slope == 1.0) && (intercept == 0.0))
                 {
-                    if (!useInputBuffer)
-                    {
-                        register const T1 *p = pixel + input->getPixelStart();
-                        for (i = this->InputCount; i != 0; --i)   // copy pixel data: can't use copyMem because T1 isn't always equal to T3
-                            *(q++) = OFstatic_cast(T3, *(p++));
-                    }
+                    if (!useInputBuffer)                          // copy pixel data
+                        DiMonoRescaleLoop<T1, T3>(pixel + input->getPixelStart(), q, this->InputCount, slope, intercept).run();
                 } else {
                     DCMIMGLE_DEBUG("applying modality transformation with rescale slope = " << slope << ", intercept = " << intercept);
                     T3 *lut = NULL;
@@ -237,27 +309,10 @@ class DiMonoInputPixelTemplate
                             }
                         }
                         const T3 *lut0 = lut - OFstatic_cast(T2, absmin);                 // points to 'zero' entry
-                        q = this->Data;
-                        for (i = this->InputCount; i != 0; --i)                           // apply LUT
-                            *(q++) = *(lut0 + (*(p++)));
+                        DiMonoLUTLoop<T1, T3>(p, this->Data, this->InputCount, lut0).run();  // apply LUT
                     }
                     if (lut == NULL)                                                      // use "normal" transformation
-                    {
-                        if (slope == 1.0)
-                        {
-                            for (i = this->InputCount; i != 0; --i)
-                                *(q++) = OFstatic_cast(T3, OFstatic_cast(double, *(p++)) + intercept);
-                        } else {
-                            if (intercept == 0.0)
-                            {
-                                for (i = this->InputCount; i != 0; --i)
-                                    *(q++) = OFstatic_cast(T3, OFstatic_cast(double, *(p++)) * slope);
-                            } else {
-                                for (i = this->InputCount; i != 0; --i)
-                                    *(q++) = OFstatic_cast(T3, OFstatic_cast(double, *(p++)) * slope + intercept);
-                            }
-                        }
-                    }
+                        DiMonoRescaleLoop<T1, T3>(p, this->Data, this->InputCount, slope, intercept).run();
                     delete[] lut;
                 }
             }
@@ -0,0 +1,317 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomMonoKernels (Header)
+ *
+ */
+
+
+#ifndef DIMOKRNL_H
+#define DIMOKRNL_H
+
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmimgle/didefine.h"
+#include "dcmtk/dcmimgle/diparal.h"
+
+#include "dcmtk/ofstd/oftypes.h"
+#include "dcmtk/ofstd/ofcast.h"
+
+
+/*---------------------*
+ *  class declaration  *
+ *---------------------*/
+
+/** Class collecting the innermost loops of the monochrome rendering pipeline,
+ *  i.e. the application of an optimization LUT and of a linear VOI window to
+ *  the pixels of a frame as well as the determination of the minimum and maximum
+ *  pixel value. For the most common combinations of input and output type
+ *  (signed/unsigned 16 bit input, 8 or 16 bit output), vectorized versions of
+ *  these loops are used if supported by the CPU (SSE4.1 and AVX2 on x86,
+ *  selected at runtime). All other combinations use the generic version.
+ *  The results of the vectorized versions are identical to the generic version.
+ */
+class DCMTK_DCMIMGLE_EXPORT DiMonoKernels
+{
+
+ public:
+
+    /** instruction sets used for the vectorized kernels
+     */
+    enum E_InstructionSet
+    {
+        /// generic version only
+        IS_Scalar = 0,
+        /// SSE4.1 (linear VOI window and minimum/maximum only)
+        IS_SSE41 = 1,
+        /// AVX2 (linear VOI window, LUT and minimum/maximum)
+        IS_AVX2 = 2
+    };
+
+    /** get the instruction set used for the vectorized kernels, i.e. the best
+     *  one supported by the CPU but not higher than the one set by
+     *  setMaxInstructionSet()
+     *
+     ** @return instruction set used
+     */
+    static E_InstructionSet getInstructionSet();
+
+    /** limit the instruction set used for the vectorized kernels, e.g. in order
+     *  to compare the different versions. By default, no limit is set.
+     *
+     ** @param  instructionSet  best instruction set to be used
+     */
+    static void setMaxInstructionSet(const E_InstructionSet instructionSet);
+
+    /** get the name of an instruction set
+     *
+     ** @param  instructionSet  instruction set
+     *
+     ** @return name of the instruction set
+     */
+    static const char *getInstructionSetName(const E_InstructionSet instructionSet);
+
+    /** apply a lookup table to the given pixels (generic version)
+     *
+     ** @param  src    input pixels
+     *  @param  dst    output pixels
+     *  @param  count  number of pixels
+     *  @param  lut0   pointer to the LUT entry for the input value 0, which might
+     *                 be outside the table for signed input. The vectorized
+     *                 versions read up to 4 bytes beyond the entry of the largest
+     *                 input value, so the table has to be padded accordingly.
+     */
+    template<class T1, class T3>
+    static inline void applyLUT(const T1 *src,
+                                T3 *dst,
+                                const unsigned long count,
+                                const T3 *lut0)
+    {
+        for (unsigned long i = count; i != 0; --i)
+            *(dst++) = *(lut0 + (*(src++)));
+    }
+
+    /// apply a lookup table to the given pixels (vectorized version, see above)
+    static void applyLUT(const Uint16 *src, Uint8 *dst, const unsigned long count, const Uint8 *lut0);
+    /// apply a lookup table to the given pixels (vectorized version, see above)
+    static void applyLUT(const Sint16 *src, Uint8 *dst, const unsigned long count, const Uint8 *lut0);
+    /// apply a lookup table to the given pixels (vectorized version, see above)
+    static void applyLUT(const Uint16 *src, Uint16 *dst, const unsigned long count, const Uint16 *lut0);
+    /// apply a lookup table to the given pixels (vectorized version, see above)
+    static void applyLUT(const Sint16 *src, Uint16 *dst, const unsigned long count, const Uint16 *lut0);
+
+    /** apply a linear VOI window to the given pixels (generic version).
+     *  Pixel values up to the left border are mapped to 'low', values above the
+     *  right border to 'high', all other values to 'offset + value * gradient'.
+     *
+     ** @param  src          input pixels
+     *  @param  dst          output pixels
+     *  @param  count        number of pixels
+     *  @param  leftBorder   left border of the window
+     *  @param  rightBorder  right border of the window
+     *  @param  offset       offset of the linear function
+     *  @param  gradient     gradient of the linear function
+     *  @param  low          output value for pixels left of the window
+     *  @param  high         output value for pixels right of the window
+     */
+    template<class T1, class T3>
+    static inline void applyWindow(const T1 *src,
+                                   T3 *dst,
+                                   const unsigned long count,
+                                   const double leftBorder,
+                                   const double rightBorder,
+                                   const double offset,
+                                   const double gradient,
+                                   const T3 low,
+                                   const T3 high)
+    {
+        double value;
+        for (unsigned long i = count; i != 0; --i)
+        {
+            value = OFstatic_cast(double, *(src++));
+            if (value <= leftBorder)
+                *(dst++) = low;                                          // black/white
+            else if (value > rightBorder)
+                *(dst++) = high;                                         // white/black
+            else
+                *(dst++) = OFstatic_cast(T3, offset + value * gradient); // gray value
+        }
+    }
+
+    /// apply a linear VOI window to the given pixels (vectorized version, see above)
+    static void applyWindow(const Uint16 *src, Uint8 *dst, const unsigned long count, const double leftBorder,
+                            const double rightBorder, const double offset, const double gradient, const Uint8 low, const Uint8 high);
+    /// apply a linear VOI window to the given pixels (vectorized version, see above)
+    static void applyWindow(const Sint16 *src, Uint8 *dst, const unsigned long count, const double leftBorder,
+                            const double rightBorder, const double offset, const double gradient, const Uint8 low, const Uint8 high);
+    /// apply a linear VOI window to the given pixels (vectorized version, see above)
+    static void applyWindow(const Uint16 *src, Uint16 *dst, const unsigned long count, const double leftBorder,
+                            const double rightBorder, const double offset, const double gradient, const Uint16 low, const Uint16 high);
+    /// apply a linear VOI window to the given pixels (vectorized version, see above)
+    static void applyWindow(const Sint16 *src, Uint16 *dst, const unsigned long count, const double leftBorder,
+                            const double rightBorder, const double offset, const double gradient, const Uint16 low, const Uint16 high);
+
+    /** determine the minimum and maximum value of the given pixels (generic version)
+     *
+     ** @param  src       input pixels
+     *  @param  count     number of pixels (should be greater than 0, the output
+     *                    parameters are not changed otherwise)
+     *  @param  minvalue  reference to storage area for the minimum value
+     *  @param  maxvalue  reference to storage area for the maximum value
+     */
+    template<class T>
+    static inline void determineMinMax(const T *src,
+                                       const unsigned long count,
+                                       T &minvalue,
+                                       T &maxvalue)
+    {
+        if (count > 0)
+        {
+            T value = *(src++);
+            T minval = value;
+            T maxval = value;
+            for (unsigned long i = count; i > 1; --i)
+            {
+                value = *(src++);
+                if (value < minval)
+                    minval = value;
+                if (value > maxval)
+                    maxval = value;
+            }
+            minvalue = minval;
+            maxvalue = maxval;
+        }
+    }
+
+    /// determine the minimum and maximum value of the given pixels (vectorized version, see above)
+    static void determineMinMax(const Uint8 *src, const unsigned long count, Uint8 &minvalue, Uint8 &maxvalue);
+    /// determine the minimum and maximum value of the given pixels (vectorized version, see above)
+    static void determineMinMax(const Sint8 *src, const unsigned long count, Sint8 &minvalue, Sint8 &maxvalue);
+    /// determine the minimum and maximum value of the given pixels (vectorized version, see above)
+    static void determineMinMax(const Uint16 *src, const unsigned long count, Uint16 &minvalue, Uint16 &maxvalue);
+    /// determine the minimum and maximum value of the given pixels (vectorized version, see above)
+    static void determineMinMax(const Sint16 *src, const unsigned long count, Sint16 &minvalue, Sint16 &maxvalue);
+};
+
+
+/** Template class applying a lookup table to the pixels of a frame, possibly
+ *  split into several blocks processed in parallel (see DiParallelLoop)
+ */
+template<class T1, class T3>
+class DiMonoLUTLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  src    input pixels
+     *  @param  dst    output pixels
+     *  @param  count  number of pixels
+     *  @param  lut0   pointer to the LUT entry for the input value 0
+     */
+    DiMonoLUTLoop(const T1 *src,
+                  T3 *dst,
+                  const unsigned long count,
+                  const T3 *lut0)
+      : DiParallelLoop(count),
+        Source(src),
+        Destination(dst),
+        LUT0(lut0)
+    {
+    }
+
+ protected:
+
+    /// apply the lookup table to the given block of pixels
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        DiMonoKernels::applyLUT(Source + start, Destination + start, end - start, LUT0);
+    }
+
+ private:
+
+    /// input pixels
+    const T1 *Source;
+    /// output pixels
+    T3 *Destination;
+    /// pointer to the LUT entry for the input value 0
+    const T3 *LUT0;
+};
+
+
+/** Template class applying a linear VOI window to the pixels of a frame, possibly
+ *  split into several blocks processed in parallel (see DiParallelLoop)
+ */
+template<class T1, class T3>
+class DiMonoWindowLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor (see DiMonoKernels::applyWindow() for details on the parameters)
+     */
+    DiMonoWindowLoop(const T1 *src,
+                     T3 *dst,
+                     const unsigned long count,
+                     const double leftBorder,
+                     const double rightBorder,
+                     const double offset,
+                     const double gradient,
+                     const T3 low,
+                     const T3 high)
+      : DiParallelLoop(count),
+        Source(src),
+        Destination(dst),
+        LeftBorder(leftBorder),
+        RightBorder(rightBorder),
+        Offset(offset),
+        Gradient(gradient),
+        Low(low),
+        High(high)
+    {
+    }
+
+ protected:
+
+    /// apply the VOI window to the given block of pixels
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        DiMonoKernels::applyWindow(Source + start, Destination + start, end - start, LeftBorder, RightBorder,
+            Offset, Gradient, Low, High);
+    }
+
+ private:
+
+    /// input pixels
+    const T1 *Source;
+    /// output pixels
+    T3 *Destination;
+    /// left border of the window
+    const double LeftBorder;
+    /// right border of the window
+    const double RightBorder;
+    /// offset of the linear function
+    const double Offset;
+    /// gradient of the linear function
+    const double Gradient;
+    /// output value for pixels left of the window
+    const T3 Low;
+    /// output value for pixels right of the window
+    const T3 High;
+};
+
+
+#endif
@@ -49,15 +49,18 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoOutputPixel
 
     /** constructor
      *
-     ** @param  pixel  pointer to intermediate pixel representation
-     *  @param  size   number of pixel per frame
-     *  @param  frame  frame to be rendered
-     *  @param  max    maximum output value
+     ** @param  pixel   pointer to intermediate pixel representation
+     *  @param  size    number of pixel per frame (or per strip of rows, see 'offset')
+     *  @param  frame   frame to be rendered
+     *  @param  max     maximum output value
+     *  @param  offset  number of pixels to be skipped in addition to 'frame' * 'size'
+     *                  (optional, used to render a strip of rows of a frame)
      */
     DiMonoOutputPixel(const DiMonoPixel *pixel,
                       const unsigned long size,
                       const unsigned long frame,
-                      const unsigned long max);
+                      const unsigned long max,
+                      const unsigned long offset = 0);
 
     /** destructor
      */
@@ -154,4 +157,77 @@ class DCMTK_DCMIMGLE_EXPORT DiMonoOutputPixel
 };
 
 
+/** Class to share the optimization LUT of the monochrome output transformation between
+ *  the strips of a frame (see DiStripRenderer). The LUT is created when the first strip
+ *  is rendered and reused for all further strips, so the decision whether to use a LUT
+ *  is based on the size of the frame and not on the (smaller) size of a strip. An object
+ *  of this class must only be used for strips of the same frame that are rendered with
+ *  the same parameters (e.g. VOI window, presentation LUT and display function).
+ */
+class DCMTK_DCMIMGLE_EXPORT DiMonoOutputLUT
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  frameSize  number of pixels per frame
+     */
+    DiMonoOutputLUT(const unsigned long frameSize);
+
+    /** destructor
+     */
+    ~DiMonoOutputLUT();
+
+    /** get number of pixels per frame
+     *
+     ** @return number of pixels per frame
+     */
+    inline unsigned long getFrameSize() const
+    {
+        return FrameSize;
+    }
+
+    /** get the previously created LUT
+     *
+     ** @param  representation  integer representation of the LUT entries
+     *  @param  count           number of LUT entries (including padding)
+     *
+     ** @return pointer to the LUT, NULL if no LUT with the given characteristics exists
+     */
+    void *getData(const EP_Representation representation,
+                  const unsigned long count) const;
+
+    /** create a new LUT (replaces the previously created LUT, if any).
+     *  The LUT entries are not initialized.
+     *
+     ** @param  representation  integer representation of the LUT entries
+     *  @param  count           number of LUT entries (including padding)
+     *  @param  itemSize        size of a LUT entry (in bytes)
+     *
+     ** @return pointer to the LUT, NULL in case of error
+     */
+    void *createData(const EP_Representation representation,
+                     const unsigned long count,
+                     const size_t itemSize);
+
+
+ private:
+
+    /// number of pixels per frame
+    const unsigned long FrameSize;
+    /// integer representation of the LUT entries
+    EP_Representation Representation;
+    /// number of LUT entries
+    unsigned long Count;
+    /// LUT entries (NULL if not yet created)
+    Uint32 *Data;
+
+ // --- declarations to avoid compiler warnings
+
+    DiMonoOutputLUT(const DiMonoOutputLUT &);
+    DiMonoOutputLUT &operator=(const DiMonoOutputLUT &);
+};
+
+
 #endif
@@ -35,6 +35,7 @@
 #include "dcmtk/dcmimgle/dipxrept.h"
 #include "dcmtk/dcmimgle/didispfn.h"
 #include "dcmtk/dcmimgle/didislut.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
 
 #ifdef PASTEL_COLOR_OUTPUT
 #include "dimcopxt.h"
@@ -76,6 +77,10 @@ class DiMonoOutputPixelTemplate
      *  @param  frame     frame to be rendered
      * (#)param frames    total number of frames present in intermediate representation
      *  @param  pastel    flag indicating whether to use not only 'real' grayscale values (optional, experimental)
+     *  @param  firstRow  first row of the frame to be rendered (optional, used to render a strip of rows)
+     *  @param  rowCount  number of rows to be rendered (optional, 0 = all rows starting from 'firstRow').
+     *                    Rendering of a strip of rows is not supported for pastel color output.
+     *  @param  sharedLUT optimization LUT shared by all strips of the frame (optional, maybe NULL)
      */
     DiMonoOutputPixelTemplate(void *buffer,
                               const DiMonoPixel *pixel,
@@ -96,39 +101,54 @@ class DiMonoOutputPixelTemplate
 #else
                               const unsigned long /*frames*/,
 #endif
-                              const int pastel = 0)
-      : DiMonoOutputPixel(pixel, OFstatic_cast(unsigned long, columns) * OFstatic_cast(unsigned long, rows), frame,
-                          OFstatic_cast(unsigned long, fabs(OFstatic_cast(double, high - low)))),
+                              const int pastel = 0,
+                              const unsigned long firstRow = 0,
+                              const unsigned long rowCount = 0,
+                              DiMonoOutputLUT *sharedLUT = NULL)
+      : DiMonoOutputPixel(pixel, OFstatic_cast(unsigned long, columns) * getRowCount(rows, firstRow, rowCount), 0 /*frame*/,
+                          OFstatic_cast(unsigned long, fabs(OFstatic_cast(double, high - low))),
+                          OFstatic_cast(unsigned long, columns) * (frame * OFstatic_cast(unsigned long, rows) + firstRow)),
         Data(NULL),
         DeleteData(buffer == NULL),
-        ColorData(NULL)
+        ColorData(NULL),
+        SharedLUT(sharedLUT)
     {
-        if ((pixel != NULL) && (Count > 0) && (FrameSize >= Count))
+        if ((pixel != NULL) && (Count > 0) && (FrameSize >= Count) && (firstRow < rows))
         {
+            /* index of the first pixel to be rendered */
+            const unsigned long start = OFstatic_cast(unsigned long, columns) * (frame * OFstatic_cast(unsigned long, rows) + firstRow);
             if (pastel)
 #ifdef PASTEL_COLOR_OUTPUT
-                color(buffer, pixel, frame, frames);
+            {
+                if (FrameSize == OFstatic_cast(unsigned long, columns) * OFstatic_cast(unsigned long, rows))
+                    color(buffer, pixel, frame, frames);
+                else
+                    DCMIMGLE_ERROR("pastel color output of a strip of rows not supported");
+            }
 #else
                 DCMIMGLE_ERROR("pastel color output not supported");
 #endif
             else
             {
                 DCMIMGLE_TRACE("monochrome output image - columns: " << columns << ", rows: " << rows << ", frame: " << frame);
+                if (FrameSize < OFstatic_cast(unsigned long, columns) * OFstatic_cast(unsigned long, rows))
+                    DCMIMGLE_TRACE("rendering rows " << firstRow << " to " << (firstRow + FrameSize / columns - 1) << " only");
                 DCMIMGLE_TRACE("monochrome output values - low: " << OFstatic_cast(unsigned long, low) << ", high: "
                     << OFstatic_cast(unsigned long, high) << ((low > high) ? " (inverted)" : ""));
                 Data = OFstatic_cast(T3 *, buffer);
                 if ((vlut != NULL) && (vlut->isValid()))            // valid VOI LUT ?
-                    voilut(pixel, frame * FrameSize, vlut, plut, disp, OFstatic_cast(T3, low), OFstatic_cast(T3, high));
+                    voilut(pixel, start, vlut, plut, disp, OFstatic_cast(T3, low), OFstatic_cast(T3, high));
                 else
                 {
                     if (width < 1)                                  // no valid window according to supplement 33
-                        nowindow(pixel, frame * FrameSize, plut, disp, OFstatic_cast(T3, low), OFstatic_cast(T3, high));
+                        nowindow(pixel, start, plut, disp, OFstatic_cast(T3, low), OFstatic_cast(T3, high));
                     else if (vfunc == EFV_Sigmoid)
-                        sigmoid(pixel, frame * FrameSize, plut, disp, center, width, OFstatic_cast(T3, low), OFstatic_cast(T3, high));
+                        sigmoid(pixel, start, plut, disp, center, width, OFstatic_cast(T3, low), OFstatic_cast(T3, high));
                     else // linear
-                        window(pixel, frame * FrameSize, plut, disp, center, width, OFstatic_cast(T3, low), OFstatic_cast(T3, high));
+                        window(pixel, start, plut, disp, center, width, OFstatic_cast(T3, low), OFstatic_cast(T3, high));
                 }
-                overlay(overlays, disp, columns, rows, frame);      // add (visible) overlay planes to output bitmap
+                /* add (visible) overlay planes to output bitmap */
+                overlay(overlays, disp, columns, rows, frame, firstRow, firstRow + getRowCount(rows, firstRow, rowCount));
             }
         }
     }
@@ -283,9 +303,15 @@ class DiMonoOutputPixelTemplate
                                    const unsigned long ocnt)
     {
         int result = 0;
-        if ((sizeof(T1) <= 2) && (Count > 3 * ocnt))                          // optimization criteria
+        /* a shared LUT is used for all strips of a frame, so the frame size is decisive */
+        const unsigned long count = (SharedLUT != NULL) ? SharedLUT->getFrameSize() : Count;
+        if ((sizeof(T1) <= 2) && (count > 3 * ocnt))                          // optimization criteria
         {                                                                     // use LUT for optimization
-            lut = new T3[ocnt];
+            /* padding required by DiMonoKernels::applyLUT() */
+            if (SharedLUT != NULL)                                            // reused for the next strips
+                lut = OFstatic_cast(T3 *, SharedLUT->createData(getRepresentation(), ocnt + 4, sizeof(T3)));
+            else
+                lut = new T3[ocnt + 4];
             if (lut != NULL)
             {
                 DCMIMGLE_DEBUG("using optimized routine with additional LUT (" << ocnt << " entries)");
@@ -295,6 +321,23 @@ class DiMonoOutputPixelTemplate
         return result;
     }
 
+    /** get the optimization LUT that has been created for a previous strip of the frame (if any)
+     *
+     ** @param  lut   reference to storage area where the optimization LUT should be stored
+     *  @param  ocnt  number of entries for the optimization LUT
+     *
+     ** @return true if a shared LUT exists, false otherwise
+     */
+    inline int reuseOptimizationLUT(T3 *&lut,
+                                    const unsigned long ocnt)
+    {
+        if (SharedLUT != NULL)
+        {
+            lut = OFstatic_cast(T3 *, SharedLUT->getData(getRepresentation(), ocnt + 4));
+        }
+        return (lut != NULL);
+    }
+
 #ifdef PASTEL_COLOR_OUTPUT
     void color(void *buffer,                               // create true color pastel image
                const DiMonoPixel *inter,
@@ -389,7 +432,9 @@ class DiMonoOutputPixelTemplate
                         const double gradient1 = OFstatic_cast(double, pcnt) / OFstatic_cast(double, vlut->getAbsMaxRange());
                         const Uint32 firstvalue = OFstatic_cast(Uint32, OFstatic_cast(double, vlut->getFirstValue()) * gradient1);
                         const Uint32 lastvalue = OFstatic_cast(Uint32, OFstatic_cast(double, vlut->getLastValue()) * gradient1);
-                        if (initOptimizationLUT(lut, ocnt))
+                        if (reuseOptimizationLUT(lut, ocnt))                              // use shared LUT (see DiMonoOutputLUT)
+                            DiMonoLUTLoop<T1, T3>(p, Data, Count, lut - OFstatic_cast(T2, inter->getAbsMinimum())).run();
+                        else if (initOptimizationLUT(lut, ocnt))
                         {                                                                 // use LUT for optimization
                             q = lut;
                             if (dlut != NULL)                                             // perform display transformation
@@ -438,9 +483,7 @@ class DiMonoOutputPixelTemplate
                                 }
                             }
                             const T3 *lut0 = lut - OFstatic_cast(T2, inter->getAbsMinimum());  // points to 'zero' entry
-                            q = Data;
-                            for (i = Count; i != 0; --i)                                  // apply LUT
-                                *(q++) = *(lut0 + (*(p++)));
+                            DiMonoLUTLoop<T1, T3>(p, Data, Count, lut0).run();          // apply LUT
                         }
                         if (lut == NULL)                                                  // use "normal" transformation
                         {
@@ -495,7 +538,9 @@ class DiMonoOutputPixelTemplate
                         const double gradient = outrange / OFstatic_cast(double, vlut->getAbsMaxRange());
                         const T3 firstvalue = OFstatic_cast(T3, OFstatic_cast(double, low) + OFstatic_cast(double, vlut->getFirstValue()) * gradient);
                         const T3 lastvalue = OFstatic_cast(T3, OFstatic_cast(double, low) + OFstatic_cast(double, vlut->getLastValue()) * gradient);
-                        if (initOptimizationLUT(lut, ocnt))
+                        if (reuseOptimizationLUT(lut, ocnt))                              // use shared LUT (see DiMonoOutputLUT)
+                            DiMonoLUTLoop<T1, T3>(p, Data, Count, lut - OFstatic_cast(T2, inter->getAbsMinimum())).run();
+                        else if (initOptimizationLUT(lut, ocnt))
                         {                                                                 // use LUT for optimization
                             q = lut;
                             if (dlut != NULL)                                             // perform display transformation
@@ -538,9 +583,7 @@ class DiMonoOutputPixelTemplate
                                 }
                             }
                             const T3 *lut0 = lut - OFstatic_cast(T2, inter->getAbsMinimum());   // points to 'zero' entry
-                            q = Data;
-                            for (i = Count; i != 0; --i)                                  // apply LUT
-                                *(q++) = *(lut0 + (*(p++)));
+                            DiMonoLUTLoop<T1, T3>(p, Data, Count, lut0).run();          // apply LUT
                         }
                         if (lut == NULL)                                                  // use "normal" transformation
                         {
@@ -585,7 +628,8 @@ class DiMonoOutputPixelTemplate
                             }
                         }
                     }
-                    delete[] lut;
+                    if (SharedLUT == NULL)                                              // shared LUT is deleted by its owner
+                        delete[] lut;
                 }
                 if (Count < FrameSize)
                     OFBitmanipTemplate<T3>::zeroMem(Data + Count, FrameSize - Count);     // set remaining pixels of frame to zero
@@ -635,7 +679,9 @@ class DiMonoOutputPixelTemplate
                     register Uint32 value;                                            // presentation LUT is always unsigned
                     const double gradient1 = OFstatic_cast(double, plut->getCount()) / inter->getAbsMaxRange();
                     const double gradient2 = outrange / OFstatic_cast(double, plut->getAbsMaxRange());
-                    if (initOptimizationLUT(lut, ocnt))
+                    if (reuseOptimizationLUT(lut, ocnt))                              // use shared LUT (see DiMonoOutputLUT)
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut - OFstatic_cast(T2, inter->getAbsMinimum())).run();
+                    else if (initOptimizationLUT(lut, ocnt))
                     {                                                                 // use LUT for optimization
                         q = lut;
                         if (dlut != NULL)                                             // perform display transformation
@@ -665,9 +711,7 @@ class DiMonoOutputPixelTemplate
                             }
                         }
                         const T3 *lut0 = lut - OFstatic_cast(T2, inter->getAbsMinimum());  // points to 'zero' entry
-                        q = Data;
-                        for (i = Count; i != 0; --i)                                  // apply LUT
-                            *(q++) = *(lut0 + (*(p++)));
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut0).run();              // apply LUT
                     }
                     if (lut == NULL)                                                  // use "normal" transformation
                     {
@@ -701,7 +745,9 @@ class DiMonoOutputPixelTemplate
                 } else {                                                              // has no presentation LUT
                     createDisplayLUT(dlut, disp, inter->getBits());
                     register const double gradient = outrange / (inter->getAbsMaxRange());
-                    if (initOptimizationLUT(lut, ocnt))
+                    if (reuseOptimizationLUT(lut, ocnt))                              // use shared LUT (see DiMonoOutputLUT)
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut - OFstatic_cast(T2, inter->getAbsMinimum())).run();
+                    else if (initOptimizationLUT(lut, ocnt))
                     {                                                                 // use LUT for optimization
                         q = lut;
                         if (dlut != NULL)                                             // perform display transformation
@@ -721,9 +767,7 @@ class DiMonoOutputPixelTemplate
                                 *(q++) = OFstatic_cast(T3, OFstatic_cast(double, low) + OFstatic_cast(double, i) * gradient);
                         }
                         const T3 *lut0 = lut - OFstatic_cast(T2, inter->getAbsMinimum());  // points to 'zero' entry
-                        q = Data;
-                        for (i = Count; i != 0; --i)                                  // apply LUT
-                            *(q++) = *(lut0 + (*(p++)));
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut0).run();              // apply LUT
                     }
                     if (lut == NULL)                                                  // use "normal" transformation
                     {
@@ -745,7 +789,8 @@ class DiMonoOutputPixelTemplate
                         }
                     }
                 }
-                delete[] lut;
+                if (SharedLUT == NULL)                                              // shared LUT is deleted by its owner
+                    delete[] lut;
                 if (Count < FrameSize)
                     OFBitmanipTemplate<T3>::zeroMem(Data + Count, FrameSize - Count); // set remaining pixels of frame to zero
             }
@@ -797,7 +842,9 @@ class DiMonoOutputPixelTemplate
                     register Uint32 value2;                                           // presentation LUT is always unsigned
                     const double plutcnt_1 = OFstatic_cast(double, plut->getCount() - 1);
                     const double plutmax_1 = OFstatic_cast(double, plut->getAbsMaxRange() - 1);
-                    if (initOptimizationLUT(lut, ocnt))
+                    if (reuseOptimizationLUT(lut, ocnt))                              // use shared LUT (see DiMonoOutputLUT)
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut - OFstatic_cast(T2, inter->getAbsMinimum())).run();
+                    else if (initOptimizationLUT(lut, ocnt))
                     {                                                                 // use LUT for optimization
                         q = lut;
                         if (dlut != NULL)                                             // perform display transformation
@@ -823,9 +870,7 @@ class DiMonoOutputPixelTemplate
                             }
                         }
                         const T3 *lut0 = lut - OFstatic_cast(T2, absmin);             // points to 'zero' entry
-                        q = Data;
-                        for (i = Count; i != 0; --i)                                  // apply LUT
-                            *(q++) = *(lut0 + (*(p++)));
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut0).run();              // apply LUT
                     }
                     if (lut == NULL)                                                  // use "normal" transformation
                     {
@@ -854,7 +899,9 @@ class DiMonoOutputPixelTemplate
                     }
                 } else {                                                              // has no presentation LUT
                     createDisplayLUT(dlut, disp, bitsof(T1));
-                    if (initOptimizationLUT(lut, ocnt))
+                    if (reuseOptimizationLUT(lut, ocnt))                              // use shared LUT (see DiMonoOutputLUT)
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut - OFstatic_cast(T2, inter->getAbsMinimum())).run();
+                    else if (initOptimizationLUT(lut, ocnt))
                     {                                                                 // use LUT for optimization
                         q = lut;
                         if (dlut != NULL)                                             // perform display transformation
@@ -877,9 +924,7 @@ class DiMonoOutputPixelTemplate
                             }
                         }
                         const T3 *lut0 = lut - OFstatic_cast(T2, absmin);             // points to 'zero' entry
-                        q = Data;
-                        for (i = Count; i != 0; --i)                                  // apply LUT
-                            *(q++) = *(lut0 + (*(p++)));
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut0).run();              // apply LUT
                     }
                     if (lut == NULL)                                                  // use "normal" transformation
                     {
@@ -904,7 +949,8 @@ class DiMonoOutputPixelTemplate
                         }
                     }
                 }
-                delete[] lut;
+                if (SharedLUT == NULL)                                              // shared LUT is deleted by its owner
+                    delete[] lut;
                 if (Count < FrameSize)
                     OFBitmanipTemplate<T3>::zeroMem(Data + Count, FrameSize - Count);        // set remaining pixels of frame to zero
             }
@@ -960,7 +1006,9 @@ class DiMonoOutputPixelTemplate
                     const Uint32 pcnt = plut->getCount();
                     const double plutmax_1 = OFstatic_cast(double, plut->getAbsMaxRange()) - 1;
                     const double gradient1 = (width_1 == 0) ? 0 : OFstatic_cast(double, pcnt - 1) / width_1;
-                    if (initOptimizationLUT(lut, ocnt))
+                    if (reuseOptimizationLUT(lut, ocnt))                              // use shared LUT (see DiMonoOutputLUT)
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut - OFstatic_cast(T2, inter->getAbsMinimum())).run();
+                    else if (initOptimizationLUT(lut, ocnt))
                     {                                                                 // use LUT for optimization
                         q = lut;
                         if (dlut != NULL)                                             // perform display transformation
@@ -996,9 +1044,7 @@ class DiMonoOutputPixelTemplate
                             }
                         }
                         const T3 *lut0 = lut - OFstatic_cast(T2, absmin);             // points to 'zero' entry
-                        q = Data;
-                        for (i = Count; i != 0; --i)                                  // apply LUT
-                            *(q++) = *(lut0 + (*(p++)));
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut0).run();              // apply LUT
                     }
                     if (lut == NULL)                                                  // use "normal" transformation
                     {
@@ -1037,7 +1083,9 @@ class DiMonoOutputPixelTemplate
                     }
                 } else {                                                              // has no presentation LUT
                     createDisplayLUT(dlut, disp, bitsof(T1));
-                    if (initOptimizationLUT(lut, ocnt))
+                    if (reuseOptimizationLUT(lut, ocnt))                              // use shared LUT (see DiMonoOutputLUT)
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut - OFstatic_cast(T2, inter->getAbsMinimum())).run();
+                    else if (initOptimizationLUT(lut, ocnt))
                     {                                                                 // use LUT for optimization
                         q = lut;
                         if (dlut != NULL)                                             // perform display transformation
@@ -1071,9 +1119,7 @@ class DiMonoOutputPixelTemplate
                             }
                         }
                         const T3 *lut0 = lut - OFstatic_cast(T2, absmin);             // points to 'zero' entry
-                        q = Data;
-                        for (i = Count; i != 0; --i)                                  // apply LUT
-                            *(q++) = *(lut0 + (*(p++)));
+                        DiMonoLUTLoop<T1, T3>(p, Data, Count, lut0).run();              // apply LUT
                     }
                     if (lut == NULL)                                                  // use "normal" transformation
                     {
@@ -1096,20 +1142,12 @@ class DiMonoOutputPixelTemplate
                             DCMIMGLE_TRACE("monochrome rendering: VOI LINEAR #8");
                             const double offset = (width_1 == 0) ? 0 : (high - ((center - 0.5) / width_1 + 0.5) * outrange);
                             const double gradient = (width_1 == 0) ? 0 : outrange / width_1;
-                            for (i = Count; i != 0; --i)
-                            {
-                                value = OFstatic_cast(double, *(p++));
-                                if (value <= leftBorder)
-                                    *(q++) = low;                                            // black/white
-                                else if (value > rightBorder)
-                                    *(q++) = high;                                           // white/black
-                                else
-                                    *(q++) = OFstatic_cast(T3, offset + value * gradient);   // gray value
-                            }
+                            DiMonoWindowLoop<T1, T3>(p, q, Count, leftBorder, rightBorder, offset, gradient, low, high).run();
                         }
                     }
                 }
-                delete[] lut;
+                if (SharedLUT == NULL)                                              // shared LUT is deleted by its owner
+                    delete[] lut;
                 if (Count < FrameSize)
                     OFBitmanipTemplate<T3>::zeroMem(Data + Count, FrameSize - Count);        // set remaining pixels of frame to zero
             }
@@ -1125,12 +1163,16 @@ class DiMonoOutputPixelTemplate
      *  @param  columns   image's width (in pixels)
      *  @param  rows      image's height (in pixels)
      *  @param  frame     number of frame to be rendered
+     *  @param  firstRow  first row stored in the output bitmap
+     *  @param  endRow    row following the last row stored in the output bitmap
      */
     void overlay(DiOverlay *overlays[2],
                  DiDisplayFunction *disp,
                  const Uint16 columns,
                  const Uint16 rows,
-                 const unsigned long frame)
+                 const unsigned long frame,
+                 const unsigned long firstRow,
+                 const unsigned long endRow)
     {
         if ((Data != NULL) && (overlays != NULL))
         {
@@ -1152,9 +1194,14 @@ class DiMonoOutputPixelTemplate
                             register Uint16 x;
                             register Uint16 y;
                             const Uint16 xmin = (plane->getLeft(left_pos) > 0) ? plane->getLeft(left_pos) : 0;
-                            const Uint16 ymin = (plane->getTop(top_pos) > 0) ? plane->getTop(top_pos) : 0;
+                            Uint16 ymin = (plane->getTop(top_pos) > 0) ? plane->getTop(top_pos) : 0;
                             const Uint16 xmax = (plane->getRight(left_pos) < columns) ? plane->getRight(left_pos) : columns;
-                            const Uint16 ymax = (plane->getBottom(top_pos) < rows) ? plane->getBottom(top_pos) : rows;
+                            Uint16 ymax = (plane->getBottom(top_pos) < rows) ? plane->getBottom(top_pos) : rows;
+                            /* restrict to the rows stored in the output bitmap */
+                            if (ymin < firstRow)
+                                ymin = OFstatic_cast(Uint16, firstRow);
+                            if (ymax > endRow)
+                                ymax = OFstatic_cast(Uint16, endRow);
                             const T3 maxvalue = OFstatic_cast(T3, DicomImageClass::maxval(bitsof(T3)));
                             switch (plane->getMode())
                             {
@@ -1165,7 +1212,7 @@ class DiMonoOutputPixelTemplate
                                     for (y = ymin; y < ymax; ++y)
                                     {
                                         plane->setStart(OFstatic_cast(Uint16, left_pos + xmin), OFstatic_cast(Uint16, top_pos + y));
-                                        q = Data + OFstatic_cast(unsigned long, y) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
+                                        q = Data + (OFstatic_cast(unsigned long, y) - firstRow) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
                                         for (x = xmin; x < xmax; ++x, ++q)
                                         {
                                             if (plane->getNextBit())
@@ -1182,7 +1229,7 @@ class DiMonoOutputPixelTemplate
                                     for (y = ymin; y < ymax; ++y)
                                     {
                                         plane->setStart(OFstatic_cast(Uint16, left_pos + xmin), OFstatic_cast(Uint16, top_pos + y));
-                                        q = Data + OFstatic_cast(unsigned long, y) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
+                                        q = Data + (OFstatic_cast(unsigned long, y) - firstRow) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
                                         for (x = xmin; x < xmax; ++x, ++q)
                                         {
                                             if (plane->getNextBit())
@@ -1198,7 +1245,7 @@ class DiMonoOutputPixelTemplate
                                     for (y = ymin; y < ymax; ++y)
                                     {
                                         plane->setStart(OFstatic_cast(Uint16, left_pos + xmin), OFstatic_cast(Uint16, top_pos + y));
-                                        q = Data + OFstatic_cast(unsigned long, y) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
+                                        q = Data + (OFstatic_cast(unsigned long, y) - firstRow) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
                                         for (x = xmin; x < xmax; ++x, ++q)
                                         {
                                             if (plane->getNextBit())
@@ -1214,7 +1261,7 @@ class DiMonoOutputPixelTemplate
                                     for (y = ymin; y < ymax; ++y)
                                     {
                                         plane->setStart(OFstatic_cast(Uint16, left_pos + xmin), OFstatic_cast(Uint16, top_pos + y));
-                                        q = Data + OFstatic_cast(unsigned long, y) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
+                                        q = Data + (OFstatic_cast(unsigned long, y) - firstRow) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
                                         for (x = xmin; x < xmax; ++x, ++q)
                                         {
                                             if (!plane->getNextBit())
@@ -1230,7 +1277,7 @@ class DiMonoOutputPixelTemplate
                                     for (y = ymin; y < ymax; ++y)
                                     {
                                         plane->setStart(OFstatic_cast(Uint16, left_pos + xmin), OFstatic_cast(Uint16, top_pos + y));
-                                        q = Data + OFstatic_cast(unsigned long, y) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
+                                        q = Data + (OFstatic_cast(unsigned long, y) - firstRow) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
                                         for (x = xmin; x < xmax; ++x, ++q)
                                         {
                                             if (!plane->getNextBit())
@@ -1252,7 +1299,7 @@ class DiMonoOutputPixelTemplate
                                     for (y = ymin; y < ymax; ++y)
                                     {
                                         plane->setStart(OFstatic_cast(Uint16, left_pos + xmin), OFstatic_cast(Uint16, top_pos + y));
-                                        q = Data + OFstatic_cast(unsigned long, y) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
+                                        q = Data + (OFstatic_cast(unsigned long, y) - firstRow) * OFstatic_cast(unsigned long, columns) + OFstatic_cast(unsigned long, xmin);
                                         for (x = xmin; x < xmax; ++x, ++q)
                                         {
                                             if (plane->getNextBit())
@@ -1272,6 +1319,25 @@ class DiMonoOutputPixelTemplate
     }
 
 
+    /** get number of rows to be rendered (helper function)
+     *
+     ** @param  rows      image's height (in pixels)
+     *  @param  firstRow  first row to be rendered
+     *  @param  rowCount  number of rows to be rendered (0 = all rows starting from 'firstRow')
+     *
+     ** @return number of rows to be rendered (might be 0)
+     */
+    static inline unsigned long getRowCount(const Uint16 rows,
+                                            const unsigned long firstRow,
+                                            const unsigned long rowCount)
+    {
+        if (firstRow >= rows)
+            return 0;
+        if ((rowCount == 0) || (firstRow + rowCount > rows))
+            return rows - firstRow;
+        return rowCount;
+    }
+
     /// pointer to the storage area where the output data should be stored
     T3 *Data;
     /// flag indicating whether the output data buffer should be deleted in the destructor
@@ -1284,6 +1350,9 @@ class DiMonoOutputPixelTemplate
     DiMonoOutputPixel *ColorData;
 #endif
 
+    /// optimization LUT shared by all strips of a frame (not deleted, maybe NULL)
+    DiMonoOutputLUT *SharedLUT;
+
  // --- declarations to avoid compiler warnings
 
     DiMonoOutputPixelTemplate(const DiMonoOutputPixelTemplate<T1,T2,T3> &);
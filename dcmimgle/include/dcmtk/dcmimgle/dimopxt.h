@@ -31,12 +31,277 @@
 #include "dcmtk/dcmimgle/dipxrept.h"
 #include "dcmtk/dcmimgle/dimopx.h"
 #include "dcmtk/dcmimgle/dimoopx.h"
+#include "dcmtk/dcmimgle/diparal.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
+
+#include "dcmtk/ofstd/ofvector.h"
 
 
 /*---------------------*
  *  class declaration  *
  *---------------------*/
 
+/** Template class to determine the minimum and maximum pixel value of a frame,
+ *  possibly split into several blocks processed in parallel (see DiParallelLoop).
+ *  The values are determined for each block and merged afterwards, so the result
+ *  does not depend on the number of blocks.
+ */
+template<class T>
+class DiMonoMinMaxLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  data   pixel data
+     *  @param  count  number of pixels
+     */
+    DiMonoMinMaxLoop(const T *data,
+                     const unsigned long count)
+      : DiParallelLoop(count),
+        Data(data),
+        Global(OFTrue),
+        Lower(0),
+        Upper(0),
+        MinValues(getNumberOfBlocks(), 0),
+        MaxValues(getNumberOfBlocks(), 0),
+        FoundMin(getNumberOfBlocks(), 0),
+        FoundMax(getNumberOfBlocks(), 0)
+    {
+    }
+
+    /** determine the global minimum and maximum pixel value
+     *
+     ** @param  minvalue  reference to storage area for the minimum value
+     *  @param  maxvalue  reference to storage area for the maximum value
+     */
+    void determineGlobal(T &minvalue,
+                         T &maxvalue)
+    {
+        Global = OFTrue;
+        run();
+        minvalue = MinValues[0];
+        maxvalue = MaxValues[0];
+        for (unsigned long i = 1; i < getNumberOfBlocks(); ++i)
+        {
+            if (MinValues[i] < minvalue)
+                minvalue = MinValues[i];
+            if (MaxValues[i] > maxvalue)
+                maxvalue = MaxValues[i];
+        }
+    }
+
+    /** determine the smallest pixel value above 'lower' and the largest pixel value
+     *  below 'upper'. The output parameters are not changed if no such value exists.
+     *
+     ** @param  lower     lower limit (excluded)
+     *  @param  upper     upper limit (excluded)
+     *  @param  minvalue  reference to storage area for the next minimum value
+     *  @param  maxvalue  reference to storage area for the next maximum value
+     */
+    void determineNext(const T lower,
+                       const T upper,
+                       T &minvalue,
+                       T &maxvalue)
+    {
+        Global = OFFalse;
+        Lower = lower;
+        Upper = upper;
+        run();
+        OFBool firstmin = OFTrue;
+        OFBool firstmax = OFTrue;
+        for (unsigned long i = 0; i < getNumberOfBlocks(); ++i)
+        {
+            if (FoundMin[i] && ((MinValues[i] < minvalue) || firstmin))
+            {
+                minvalue = MinValues[i];
+                firstmin = OFFalse;
+            }
+            if (FoundMax[i] && ((MaxValues[i] > maxvalue) || firstmax))
+            {
+                maxvalue = MaxValues[i];
+                firstmax = OFFalse;
+            }
+        }
+    }
+
+ protected:
+
+    /// determine the values for the given block of pixels
+    virtual void processBlock(const unsigned long block,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        const T *p = Data + start;
+        T value;
+        unsigned long i;
+        if (Global)
+        {
+            /* vectorized for 8 and 16 bit data */
+            DiMonoKernels::determineMinMax(p, end - start, MinValues[block], MaxValues[block]);
+        } else {
+            T minvalue = 0;
+            T maxvalue = 0;
+            int firstmin = 1;
+            int firstmax = 1;
+            for (i = end - start; i != 0; --i)
+            {
+                value = *(p++);
+                if ((value > Lower) && ((value < minvalue) || firstmin))
+                {
+                    minvalue = value;
+                    firstmin = 0;
+                }
+                if ((value < Upper) && ((value > maxvalue) || firstmax))
+                {
+                    maxvalue = value;
+                    firstmax = 0;
+                }
+            }
+            MinValues[block] = minvalue;
+            MaxValues[block] = maxvalue;
+            FoundMin[block] = !firstmin;
+            FoundMax[block] = !firstmax;
+        }
+    }
+
+ private:
+
+    /// pixel data
+    const T *Data;
+    /// determine global minimum/maximum if true, next minimum/maximum otherwise
+    OFBool Global;
+    /// lower limit for the next minimum
+    T Lower;
+    /// upper limit for the next maximum
+    T Upper;
+    /// minimum value of each block
+    OFVector<T> MinValues;
+    /// maximum value of each block
+    OFVector<T> MaxValues;
+    /// next minimum value found in each block (no OFVector<OFBool> since the blocks are processed concurrently)
+    OFVector<int> FoundMin;
+    /// next maximum value found in each block
+    OFVector<int> FoundMax;
+};
+
+
+/** Template class to determine the histogram of the pixel values of a frame, possibly
+ *  split into several blocks processed in parallel (see DiParallelLoop). Each block
+ *  counts the values in a separate array, which are summed up afterwards.
+ */
+template<class T>
+class DiMonoHistogramLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  data      pixel data
+     *  @param  count     number of pixels
+     *  @param  minvalue  smallest value to be counted
+     *  @param  maxvalue  largest value to be counted (values outside the range are ignored)
+     */
+    DiMonoHistogramLoop(const T *data,
+                        const unsigned long count,
+                        const T minvalue,
+                        const T maxvalue)
+      : DiParallelLoop(count, (OFstatic_cast(Uint32, maxvalue - minvalue) < MaximumParallelEntries) ? dcmRenderingMaxThreads.get() : 1),
+        Data(data),
+        MinValue(minvalue),
+        MaxValue(maxvalue),
+        Entries(OFstatic_cast(Uint32, maxvalue - minvalue + 1)),
+        Histogram(NULL),
+        BlockHistograms(NULL)
+    {
+    }
+
+    /** destructor
+     */
+    virtual ~DiMonoHistogramLoop()
+    {
+        delete[] BlockHistograms;
+    }
+
+    /** determine the histogram
+     *
+     ** @param  histogram  array of 'maxvalue - minvalue + 1' entries, which is filled
+     *                     with the histogram
+     *
+     ** @return number of pixels counted, i.e. not outside the range of the histogram
+     */
+    unsigned long determine(Uint32 *histogram)
+    {
+        const unsigned long blocks = getNumberOfBlocks();
+        Histogram = histogram;
+        OFBitmanipTemplate<Uint32>::zeroMem(Histogram, Entries);
+        if (blocks > 1)
+        {
+            BlockHistograms = new Uint32[(blocks - 1) * Entries];
+            OFBitmanipTemplate<Uint32>::zeroMem(BlockHistograms, (blocks - 1) * Entries);
+        }
+        run();
+        /* sum up the histograms of the other blocks */
+        const Uint32 *p = BlockHistograms;
+        for (unsigned long i = 1; i < blocks; ++i)
+        {
+            Uint32 *q = Histogram;
+            for (Uint32 j = Entries; j != 0; --j)
+                *(q++) += *(p++);
+        }
+        unsigned long counted = 0;
+        for (Uint32 j = 0; j < Entries; ++j)
+            counted += Histogram[j];
+        return counted;
+    }
+
+ protected:
+
+    /// count the values of the given block of pixels
+    virtual void processBlock(const unsigned long block,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        Uint32 *q = (block == 0) ? Histogram : BlockHistograms + (block - 1) * Entries;
+        const T *p = Data + start;
+        T value;
+        for (unsigned long i = end - start; i != 0; --i)
+        {
+            value = *(p++);
+            if ((value >= MinValue) && (value <= MaxValue))             // only for stability !
+                ++q[OFstatic_cast(Uint32, value - MinValue)];           // count values
+#ifdef DEBUG
+            else
+                DCMIMGLE_WARN("invalid value (" << value << ") in DiMonoPixelTemplate<T>::getHistogramWindow()");
+#endif
+        }
+    }
+
+ private:
+
+    /// maximum number of histogram entries for which the pixels are processed in parallel
+    /// (each block requires a separate array)
+    enum { MaximumParallelEntries = 1 << 20 };
+
+    /// pixel data
+    const T *Data;
+    /// smallest value to be counted
+    const T MinValue;
+    /// largest value to be counted
+    const T MaxValue;
+    /// number of histogram entries
+    const Uint32 Entries;
+    /// histogram of the first block (and of the whole frame afterwards)
+    Uint32 *Histogram;
+    /// histograms of the other blocks
+    Uint32 *BlockHistograms;
+};
+
+
 /** Template class to handle monochrome pixel data
  */
 template<class T>
@@ -53,7 +318,12 @@ class DiMonoPixelTemplate
      */
     DiMonoPixelTemplate(const unsigned long count)
       : DiMonoPixel(count),
-        Data(NULL)
+        Data(NULL),
+        Histogram(NULL),
+        HistogramComplete(OFFalse),
+        TileFrame(0),
+        TileColumns(0),
+        TileRows(0)
     {
         MinValue[0] = 0;
         MinValue[1] = 0;
@@ -86,7 +356,12 @@ class DiMonoPixelTemplate
     DiMonoPixelTemplate(const DiInputPixel *pixel,
                         DiMonoModality *modality)
       : DiMonoPixel(pixel, modality),
-        Data(NULL)
+        Data(NULL),
+        Histogram(NULL),
+        HistogramComplete(OFFalse),
+        TileFrame(0),
+        TileColumns(0),
+        TileRows(0)
     {
         MinValue[0] = 0;
         MinValue[1] = 0;
@@ -102,7 +377,12 @@ class DiMonoPixelTemplate
     DiMonoPixelTemplate(DiMonoOutputPixel *pixel,
                         DiMonoModality *modality)
       : DiMonoPixel(pixel, modality),
-        Data(OFstatic_cast(T *, pixel->getDataPtr()))
+        Data(OFstatic_cast(T *, pixel->getDataPtr())),
+        Histogram(NULL),
+        HistogramComplete(OFFalse),
+        TileFrame(0),
+        TileColumns(0),
+        TileRows(0)
     {
         MinValue[0] = 0;
         MinValue[1] = 0;
@@ -114,6 +394,7 @@ class DiMonoPixelTemplate
      */
     virtual ~DiMonoPixelTemplate()
     {
+        delete[] Histogram;
 #if defined(HAVE_STD__NOTHROW) && defined(HAVE_NOTHROW_DELETE)
         /* use a non-throwing delete (if available) */
         operator delete[] (Data, std::nothrow);
@@ -146,6 +427,8 @@ class DiMonoPixelTemplate
      */
     inline void *getDataPtr()
     {
+        /* pixel data might be modified by the caller */
+        invalidateCaches();
         return OFstatic_cast(void *, Data);
     }
 
@@ -157,6 +440,8 @@ class DiMonoPixelTemplate
      */
     inline void *getDataArrayPtr()
     {
+        /* pixel data might be modified by the caller (e.g. flipped or rotated) */
+        invalidateCaches();
         return OFstatic_cast(void *, &Data);
     }
 
@@ -191,7 +476,11 @@ class DiMonoPixelTemplate
         if ((idx >= 0) && (idx <= 1))
         {
             if ((idx == 1) && (MinValue[1] == 0) && (MaxValue[1] == 0))
-                determineMinMax(0, 0, 0x2);                                     // determine on demand
+            {
+                /* use the histogram (if already computed) or determine on demand */
+                if (!determineNextMinMaxFromHistogram())
+                    determineMinMax(0, 0, 0x2);
+            }
             /* suppl. 33: "A Window Center of 2^n-1 and a Window Width of 2^n
                            selects the range of input values from 0 to 2^n-1."
             */
@@ -238,17 +527,63 @@ class DiMonoPixelTemplate
             register T value = 0;
             register T min = *p;                    // get first pixel as initial value for min ...
             register T max = min;                   // ... and max
-            for (y = top_pos; y < bottom; ++y)
+            /* first and last (excluded) tile that is completely covered by the ROI */
+            const unsigned long first_tile = (left_pos + TileWidth - 1) / TileWidth;
+            const unsigned long last_tile = right_pos / TileWidth;
+            if ((last_tile >= first_tile + 2) && (columns * rows * (frame + 1) <= Count))
             {
-                for (x = left_pos; x < right_pos; ++x)
+                /* use (and create on demand) the minimum/maximum values of the tiles */
+                prepareTiles(columns, rows, frame);
+                const unsigned long tiles_x = columns / TileWidth;
+                const unsigned long tile_start = first_tile * TileWidth;
+                const unsigned long tile_end = last_tile * TileWidth;
+                unsigned long t;
+                for (y = top_pos; y < bottom; ++y)
                 {
-                    value = *(p++);
-                    if (value < min)
-                        min = value;
-                    else if (value > max)
-                        max = value;
+                    for (x = left_pos; x < tile_start; ++x)
+                    {
+                        value = *(p++);
+                        if (value < min)
+                            min = value;
+                        else if (value > max)
+                            max = value;
+                    }
+                    for (t = y * tiles_x + first_tile; t < y * tiles_x + last_tile; ++t)
+                    {
+                        if (!TileValid[t])
+                        {
+                            DiMonoKernels::determineMinMax(p, TileWidth, TileMin[t], TileMax[t]);
+                            TileValid[t] = 1;
+                        }
+                        if (TileMin[t] < min)
+                            min = TileMin[t];
+                        if (TileMax[t] > max)
+                            max = TileMax[t];
+                        p += TileWidth;
+                    }
+                    for (x = tile_end; x < right_pos; ++x)
+                    {
+                        value = *(p++);
+                        if (value < min)
+                            min = value;
+                        else if (value > max)
+                            max = value;
+                    }
+                    p += skip_x;                    // skip rest of current line and beginning of next
+                }
+            } else {
+                for (y = top_pos; y < bottom; ++y)
+                {
+                    for (x = left_pos; x < right_pos; ++x)
+                    {
+                        value = *(p++);
+                        if (value < min)
+                            min = value;
+                        else if (value > max)
+                            max = value;
+                    }
+                    p += skip_x;                    // skip rest of current line and beginning of next
                 }
-                p += skip_x;                        // skip rest of current line and beginning of next
             }
             /* suppl. 33: "A Window Center of 2^n-1 and a Window Width of 2^n
                            selects the range of input values from 0 to 2^n-1."
@@ -268,27 +603,18 @@ class DiMonoPixelTemplate
      *
      ** @return status, true if successful, false otherwise
      */
-    int getHistogramWindow(const double thresh,                 // could be optimized if necessary (see diinpxt.h)!
+    int getHistogramWindow(const double thresh,
                            double &center,
                            double &width)
     {
         if ((Data != NULL) && (MinValue[0] < MaxValue[0]))
         {
             const Uint32 count = OFstatic_cast(Uint32, MaxValue[0] - MinValue[0] + 1);
-            Uint32 *quant = new Uint32[count];
+            /* the histogram is computed only once and reused for subsequent calls */
+            const Uint32 *quant = determineHistogram();
             if (quant != NULL)
             {
                 register unsigned long i;
-                OFBitmanipTemplate<Uint32>::zeroMem(quant, count);                  // initialize array
-                for (i = 0; i < Count; ++i)
-                {
-                    if ((Data[i] >= MinValue[0]) && (Data[i] <= MaxValue[0]))       // only for stability !
-                        ++quant[OFstatic_cast(Uint32, Data[i] - MinValue[0])];      // count values
-#ifdef DEBUG
-                    else
-                        DCMIMGLE_WARN("invalid value (" << Data[i] << ") in DiMonoPixelTemplate<T>::getHistogramWindow()");
-#endif
-                }
                 const Uint32 threshvalue = OFstatic_cast(Uint32, thresh * OFstatic_cast(double, Count));
                 register Uint32 t = 0;
                 i = 0;
@@ -300,7 +626,6 @@ class DiMonoPixelTemplate
                 while ((i > 0) && (t < threshvalue))
                     t += quant[--i];
                 const T maxvalue = (i > 0) ? OFstatic_cast(T, MinValue[0] + i) : 0;
-                delete[] quant;
                 if (minvalue < maxvalue)
                 {
                     /* suppl. 33: "A Window Center of 2^n-1 and a Window Width of 2^n
@@ -326,7 +651,12 @@ class DiMonoPixelTemplate
     DiMonoPixelTemplate(const DiPixel *pixel,
                         DiMonoModality *modality)
       : DiMonoPixel(pixel, modality),
-        Data(NULL)
+        Data(NULL),
+        Histogram(NULL),
+        HistogramComplete(OFFalse),
+        TileFrame(0),
+        TileColumns(0),
+        TileRows(0)
     {
         MinValue[0] = 0;
         MinValue[1] = 0;
@@ -342,7 +672,12 @@ class DiMonoPixelTemplate
     DiMonoPixelTemplate(const DiMonoPixel *pixel,
                         const unsigned long count)
       : DiMonoPixel(pixel, count),
-        Data(NULL)
+        Data(NULL),
+        Histogram(NULL),
+        HistogramComplete(OFFalse),
+        TileFrame(0),
+        TileColumns(0),
+        TileRows(0)
     {
         MinValue[0] = 0;
         MinValue[1] = 0;
@@ -368,24 +703,15 @@ class DiMonoPixelTemplate
                 if ((minvalue == 0) && (maxvalue == 0))
                 {
                     DCMIMGLE_DEBUG("determining global minimum and maximum pixel values for monochrome image");
-                    register T *p = Data;
-                    register T value = *p;
-                    register unsigned long i;
-                    minvalue = value;
-                    maxvalue = value;
-                    for (i = Count; i > 1; --i)                 // could be optimized if necessary (see diinpxt.h) !
-                    {
-                        value = *(++p);
-                        if (value < minvalue)
-                            minvalue = value;
-                        else if (value > maxvalue)
-                            maxvalue = value;
-                    }
+                    DiMonoMinMaxLoop<T>(Data, Count).determineGlobal(minvalue, maxvalue);
                 }
                 MinValue[0] = minvalue;                         // global minimum
                 MaxValue[0] = maxvalue;                         // global maximum
                 MinValue[1] = 0;                                // invalidate value
                 MaxValue[1] = 0;
+                delete[] Histogram;                             // invalidate histogram
+                Histogram = NULL;
+                HistogramComplete = OFFalse;
             } else {
                 minvalue = MinValue[0];
                 maxvalue = MaxValue[0];
@@ -393,25 +719,7 @@ class DiMonoPixelTemplate
             if (mode & 0x2)
             {
                 DCMIMGLE_DEBUG("determining next minimum and maximum pixel values for monochrome image");
-                register T *p = Data;
-                register T value;
-                register int firstmin = 1;
-                register int firstmax = 1;
-                register unsigned long i;
-                for (i = Count; i != 0; --i)                    // could be optimized if necessary (see diinpxt.h) !
-                {
-                    value = *(p++);
-                    if ((value > minvalue) && ((value < MinValue[1]) || firstmin))
-                    {
-                        MinValue[1] = value;
-                        firstmin = 0;
-                    }
-                    if ((value < maxvalue) && ((value > MaxValue[1]) || firstmax))
-                    {
-                        MaxValue[1] = value;
-                        firstmax = 0;
-                    }
-                }
+                DiMonoMinMaxLoop<T>(Data, Count).determineNext(minvalue, maxvalue, MinValue[1], MaxValue[1]);
             }
         }
     }
@@ -422,11 +730,128 @@ class DiMonoPixelTemplate
 
  private:
 
+    /// width of a tile (in pixels) for which the minimum and maximum value is cached
+    enum { TileWidth = 32 };
+
+    /** determine the histogram of the pixel values (from global minimum to maximum).
+     *  The histogram is computed only once and kept until the global minimum and
+     *  maximum values are determined again.
+     *
+     ** @return pointer to histogram (NULL in case of error)
+     */
+    const Uint32 *determineHistogram()
+    {
+        if ((Histogram == NULL) && (Data != NULL) && (MinValue[0] < MaxValue[0]))
+        {
+            const Uint32 count = OFstatic_cast(Uint32, MaxValue[0] - MinValue[0] + 1);
+            Histogram = new Uint32[count];
+            if (Histogram != NULL)
+            {
+                DCMIMGLE_DEBUG("determining histogram of pixel values for monochrome image");
+                /* check whether all pixel values are within the range of the histogram */
+                HistogramComplete = (DiMonoHistogramLoop<T>(Data, Count, MinValue[0], MaxValue[0]).determine(Histogram) == Count);
+            }
+        }
+        return Histogram;
+    }
+
+    /** determine next minimum and maximum pixel values from the histogram (if available).
+     *  The pixel data are not accessed, i.e. this method does only succeed if the
+     *  histogram has already been computed and contains all pixel values.
+     *
+     ** @return true if successful, false otherwise
+     */
+    OFBool determineNextMinMaxFromHistogram()
+    {
+        if ((Histogram != NULL) && HistogramComplete)
+        {
+            const Uint32 count = OFstatic_cast(Uint32, MaxValue[0] - MinValue[0] + 1);
+            Uint32 i;
+            for (i = 1; i < count; ++i)
+            {
+                if (Histogram[i] > 0)
+                {
+                    MinValue[1] = OFstatic_cast(T, MinValue[0] + i);
+                    break;
+                }
+            }
+            for (i = count - 1; i > 0; --i)
+            {
+                if (Histogram[i - 1] > 0)
+                {
+                    MaxValue[1] = OFstatic_cast(T, MinValue[0] + i - 1);
+                    break;
+                }
+            }
+            return OFTrue;
+        }
+        return OFFalse;
+    }
+
+    /** prepare cache of minimum and maximum values of the tiles of the given frame.
+     *  The values of the individual tiles are determined on demand.
+     *
+     ** @param  columns  number of columns of the associated image
+     *  @param  rows     number of rows of the associated image
+     *  @param  frame    index of the frame
+     */
+    void prepareTiles(const unsigned long columns,
+                      const unsigned long rows,
+                      const unsigned long frame)
+    {
+        if ((TileColumns != columns) || (TileRows != rows) || (TileFrame != frame))
+        {
+            const unsigned long tiles = (columns / TileWidth) * rows;
+            TileMin.resize(tiles, 0);
+            TileMax.resize(tiles, 0);
+            TileValid.clear();
+            TileValid.resize(tiles, 0);
+            TileColumns = columns;
+            TileRows = rows;
+            TileFrame = frame;
+        }
+    }
+
+    /** invalidate all values derived from the pixel data on demand, i.e. the minimum
+     *  and maximum values of the tiles, the histogram and the next minimum and maximum
+     *  values. They are determined again from the (modified) pixel data when needed.
+     *  The global minimum and maximum values are kept, since they might also have
+     *  been specified by the modality transformation.
+     */
+    inline void invalidateCaches()
+    {
+        TileColumns = 0;
+        TileRows = 0;
+        delete[] Histogram;
+        Histogram = NULL;
+        HistogramComplete = OFFalse;
+        MinValue[1] = 0;
+        MaxValue[1] = 0;
+    }
+
     /// minimum pixel values (0 = global, 1 = ignoring global)
     T MinValue[2];
     /// maximum pixel values
     T MaxValue[2];
 
+    /// histogram of the pixel values from global minimum to maximum (computed on demand)
+    Uint32 *Histogram;
+    /// status flag indicating whether all pixel values are counted in the histogram
+    OFBool HistogramComplete;
+
+    /// minimum pixel value of each tile (used for ROI windows)
+    OFVector<T> TileMin;
+    /// maximum pixel value of each tile
+    OFVector<T> TileMax;
+    /// status flag for each tile indicating whether the above values are valid
+    OFVector<Uint8> TileValid;
+    /// index of the frame the tiles refer to
+    unsigned long TileFrame;
+    /// number of columns of the image the tiles refer to (0 = invalid)
+    unsigned long TileColumns;
+    /// number of rows of the image the tiles refer to
+    unsigned long TileRows;
+
  // --- declarations to avoid compiler warnings
 
     DiMonoPixelTemplate(const DiMonoPixelTemplate<T> &);
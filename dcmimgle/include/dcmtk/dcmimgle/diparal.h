@@ -0,0 +1,131 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomParallelLoop (Header)
+ *
+ */
+
+
+#ifndef DIPARAL_H
+#define DIPARAL_H
+
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmimgle/didefine.h"
+
+#include "dcmtk/ofstd/ofglobal.h"
+#include "dcmtk/ofstd/oftypes.h"
+#include "dcmtk/dcmdata/dcfrmpar.h"
+
+
+/*------------------------*
+ *  global configuration  *
+ *------------------------*/
+
+/** Maximum number of threads used for rendering a single frame of a monochrome
+ *  image, i.e. for the modality transformation, the determination of the minimum
+ *  and maximum pixel value and the VOI/presentation LUT transformation, and for
+ *  scaling an image with interpolation. The pixels are split into contiguous blocks
+ *  of at least DiParallelLoop::MinimumBlockSize pixels, so small images are still
+ *  processed by a single thread. The output does not depend on the number of threads.
+ *  If the toolkit has been compiled without thread support, this flag has no effect.
+ *  Default is 1, i.e. all pixels are processed by the calling thread.
+ */
+extern DCMTK_DCMIMGLE_EXPORT OFGlobal<Uint32> dcmRenderingMaxThreads; /* default 1 */
+
+
+/*---------------------*
+ *  class declaration  *
+ *---------------------*/
+
+/** Abstract base class for a loop over the pixels of a frame that can be split
+ *  into independent blocks. Derived classes implement processBlock() for a range
+ *  of pixels, run() distributes the blocks over a number of threads. The threads
+ *  are taken from the pool that is also used for processing the frames of a
+ *  multi-frame image in parallel (see DcmFrameProcessor).
+ *  Each block should only write to its own part of the output, results that have
+ *  to be combined (e.g. minimum and maximum values) should be stored per block
+ *  and merged after run() has returned.
+ */
+class DCMTK_DCMIMGLE_EXPORT DiParallelLoop
+  : private DcmFrameProcessor
+{
+
+ public:
+
+    /// minimum number of pixels per block (smaller frames are not split)
+    static const unsigned long MinimumBlockSize;
+
+    /** constructor
+     *
+     ** @param  count             number of pixels (or rows) to be processed
+     *  @param  numberOfThreads   maximum number of threads to be used
+     *  @param  minimumBlockSize  minimum number of pixels (or rows) per block
+     */
+    DiParallelLoop(const unsigned long count,
+                   const Uint32 numberOfThreads = dcmRenderingMaxThreads.get(),
+                   const unsigned long minimumBlockSize = MinimumBlockSize);
+
+    /** destructor
+     */
+    virtual ~DiParallelLoop();
+
+    /** get number of blocks the pixels are split into
+     *
+     ** @return number of blocks (at least 1)
+     */
+    inline unsigned long getNumberOfBlocks() const
+    {
+        return Blocks;
+    }
+
+    /** process all pixels by calling processBlock() once for each block.
+     *  If more than one block exists, the blocks are processed in parallel.
+     *  Returns after all blocks have been processed.
+     */
+    void run();
+
+
+ protected:
+
+    /** process a block of pixels. Is called exactly once for each block,
+     *  possibly by different threads at the same time.
+     *
+     ** @param  block  index of the block (0..getNumberOfBlocks()-1)
+     *  @param  start  index of the first pixel of the block
+     *  @param  end    index of the first pixel following the block
+     */
+    virtual void processBlock(const unsigned long block,
+                              const unsigned long start,
+                              const unsigned long end) = 0;
+
+
+ private:
+
+    /** process the given block (called by DcmFrameProcessor::run())
+     *
+     ** @param  block  index of the block
+     *
+     ** @return always EC_Normal
+     */
+    virtual OFCondition processFrame(Uint32 block);
+
+    /// number of pixels to be processed
+    const unsigned long Count;
+    /// number of blocks
+    unsigned long Blocks;
+
+ // --- declarations to avoid compiler warnings
+
+    DiParallelLoop(const DiParallelLoop &);
+    DiParallelLoop &operator=(const DiParallelLoop &);
+};
+
+
+#endif
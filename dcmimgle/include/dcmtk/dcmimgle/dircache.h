@@ -0,0 +1,545 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomRenderCache (Header)
+ *
+ */
+
+
+#ifndef DIRCACHE_H
+#define DIRCACHE_H
+
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmimgle/didefine.h"
+#include "dcmtk/dcmimgle/diutils.h"
+
+#include "dcmtk/ofstd/oflist.h"
+#include "dcmtk/ofstd/ofmap.h"
+#include "dcmtk/ofstd/ofstring.h"
+#include "dcmtk/ofstd/ofthread.h"
+
+
+/*------------------------*
+ *  forward declarations  *
+ *------------------------*/
+
+class DicomImage;
+
+
+/*---------------------*
+ *  class declaration  *
+ *---------------------*/
+
+/** Class describing a rendered frame stored in a DiRenderCache, i.e. the SOP instance,
+ *  the frame number, the size and format of the output data as well as all parameters
+ *  of the rendering pipeline that have an effect on the resulting pixel values.
+ *  Two keys refer to the same rendered frame if their string representations are equal.
+ */
+class DCMTK_DCMIMGLE_EXPORT DiRenderCacheKey
+{
+
+ public:
+
+    /** constructor.
+     *  By default, the VOI transformation, presentation LUT shape and polarity are not
+     *  specified, i.e. the current settings of the image are used (see applyTo()).
+     *
+     ** @param  sopInstanceUID  SOP instance UID of the image
+     *  @param  frame           number of the frame (0..n-1)
+     *  @param  width           width of the rendered frame (0 = original width)
+     *  @param  height          height of the rendered frame (0 = original height)
+     *  @param  bits            number of bits per sample of the output data
+     *                          (see DicomImage::getOutputData())
+     *  @param  planar          0 = color-by-pixel, 1 = color-by-plane
+     *                          (only applicable to color images)
+     */
+    DiRenderCacheKey(const OFString &sopInstanceUID,
+                     const unsigned long frame = 0,
+                     const unsigned long width = 0,
+                     const unsigned long height = 0,
+                     const int bits = 8,
+                     const int planar = 0);
+
+    /** destructor
+     */
+    virtual ~DiRenderCacheKey();
+
+    /** set interpolation algorithm used for scaling the frame
+     *
+     ** @param  interpolate  interpolation algorithm (see DicomImage::createScaledImage())
+     */
+    void setInterpolation(const int interpolate);
+
+    /** set VOI window with the given parameters (monochrome images only)
+     *
+     ** @param  center    window center
+     *  @param  width     window width
+     *  @param  function  VOI LUT function
+     */
+    void setWindow(const double center,
+                   const double width,
+                   const EF_VoiLutFunction function = EFV_Default);
+
+    /** set VOI window stored in the image (monochrome images only)
+     *
+     ** @param  window  index of the VOI window (0..n-1)
+     */
+    void setWindow(const unsigned long window);
+
+    /** set VOI LUT stored in the image (monochrome images only)
+     *
+     ** @param  table  index of the VOI LUT (0..n-1)
+     */
+    void setVoiLut(const unsigned long table);
+
+    /** set VOI window computed from the minimum and maximum pixel value (monochrome images only)
+     *
+     ** @param  idx  ignore global extreme values if true (see DicomImage::setMinMaxWindow())
+     */
+    void setMinMaxWindow(const int idx = 0);
+
+    /** disable VOI transformation (monochrome images only)
+     */
+    void setNoVoiTransformation();
+
+    /** set presentation LUT shape (monochrome images only)
+     *
+     ** @param  shape  presentation LUT shape
+     */
+    void setPresentationLutShape(const ES_PresentationLut shape);
+
+    /** set polarity
+     *
+     ** @param  polarity  polarity of the output data
+     */
+    void setPolarity(const EP_Polarity polarity);
+
+    /** set further parameters that have an effect on the rendered pixel values, e.g. the
+     *  display function or the visible overlay planes. These parameters are not applied
+     *  to the image by applyTo(), they are only used to distinguish the rendered frames.
+     *
+     ** @param  parameters  textual description of the further parameters
+     */
+    void setFurtherParameters(const OFString &parameters);
+
+    /** get SOP instance UID
+     *
+     ** @return SOP instance UID of the image
+     */
+    inline const OFString &getSOPInstanceUID() const
+    {
+        return SOPInstanceUID;
+    }
+
+    /** get frame number
+     *
+     ** @return number of the frame (0..n-1)
+     */
+    inline unsigned long getFrame() const
+    {
+        return Frame;
+    }
+
+    /** get width of the rendered frame
+     *
+     ** @return width of the rendered frame (0 = original width)
+     */
+    inline unsigned long getWidth() const
+    {
+        return Width;
+    }
+
+    /** get height of the rendered frame
+     *
+     ** @return height of the rendered frame (0 = original height)
+     */
+    inline unsigned long getHeight() const
+    {
+        return Height;
+    }
+
+    /** get number of bits per sample of the output data
+     *
+     ** @return number of bits per sample
+     */
+    inline int getBits() const
+    {
+        return Bits;
+    }
+
+    /** get planar configuration of the output data
+     *
+     ** @return 0 = color-by-pixel, 1 = color-by-plane
+     */
+    inline int getPlanar() const
+    {
+        return Planar;
+    }
+
+    /** get interpolation algorithm used for scaling the frame
+     *
+     ** @return interpolation algorithm
+     */
+    inline int getInterpolation() const
+    {
+        return Interpolation;
+    }
+
+    /** get string representation of this key.
+     *  All parameters are contained, floating point values with full precision.
+     *
+     ** @return string representation
+     */
+    OFString getString() const;
+
+    /** apply the VOI transformation, presentation LUT shape and polarity of this key to
+     *  the given image. Parameters that have not been specified are left unchanged.
+     *  The VOI transformation and presentation LUT shape are ignored for color images.
+     *
+     ** @param  image  image to be modified
+     *
+     ** @return true if successful, false otherwise
+     */
+    OFBool applyTo(DicomImage &image) const;
+
+
+ private:
+
+    /// type of VOI transformation
+    enum E_VoiMode
+    {
+        /// not specified, use current settings of the image
+        EVM_Unspecified,
+        /// VOI window with given parameters
+        EVM_Window,
+        /// VOI window stored in the image
+        EVM_StoredWindow,
+        /// VOI LUT stored in the image
+        EVM_StoredLut,
+        /// VOI window computed from the minimum and maximum pixel value
+        EVM_MinMaxWindow,
+        /// no VOI transformation
+        EVM_None
+    };
+
+    /// SOP instance UID of the image
+    OFString SOPInstanceUID;
+    /// number of the frame
+    unsigned long Frame;
+    /// width of the rendered frame
+    unsigned long Width;
+    /// height of the rendered frame
+    unsigned long Height;
+    /// number of bits per sample of the output data
+    int Bits;
+    /// planar configuration of the output data
+    int Planar;
+    /// interpolation algorithm used for scaling
+    int Interpolation;
+
+    /// type of VOI transformation
+    E_VoiMode VoiMode;
+    /// window center (EVM_Window)
+    double WindowCenter;
+    /// window width (EVM_Window)
+    double WindowWidth;
+    /// VOI LUT function (EVM_Window)
+    EF_VoiLutFunction VoiLutFunction;
+    /// index of the stored window or VOI LUT (EVM_StoredWindow, EVM_StoredLut),
+    /// or whether to ignore global extreme values (EVM_MinMaxWindow)
+    unsigned long VoiIndex;
+
+    /// presentation LUT shape (unspecified if PresLutShapeValid is false)
+    ES_PresentationLut PresLutShape;
+    /// status flag indicating whether the presentation LUT shape has been specified
+    OFBool PresLutShapeValid;
+    /// polarity (unspecified if PolarityValid is false)
+    EP_Polarity Polarity;
+    /// status flag indicating whether the polarity has been specified
+    OFBool PolarityValid;
+
+    /// further parameters
+    OFString FurtherParameters;
+};
+
+
+/** Class caching the output data of rendered frames (see DicomImage::getOutputData()),
+ *  e.g. the previews of an image in different sizes requested repeatedly by a viewer.
+ *  The cached frames are kept in memory up to a given limit. If this limit is exceeded,
+ *  the least recently used frames are removed or, if a spill directory has been
+ *  specified, moved to a file in this directory (again up to a given limit). Frames
+ *  read from a spill file are moved back to memory. The spill files are created
+ *  exclusively with random names and deleted when they are no longer needed, at the
+ *  latest by the destructor. Spill files are read and written without locking the cache.
+ *  All methods of this class can be called by multiple threads at the same time.
+ *  Derived classes may replace the storage by overriding getData() and putData().
+ */
+class DCMTK_DCMIMGLE_EXPORT DiRenderCache
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  memoryLimit     maximum number of bytes of output data kept in memory
+     *  @param  spillDirectory  directory used for storing frames that do not fit into
+     *                          memory (empty = frames are removed from the cache)
+     *  @param  diskLimit       maximum number of bytes of output data stored in the
+     *                          spill directory (0 = no limit)
+     */
+    DiRenderCache(const unsigned long memoryLimit,
+                  const OFString &spillDirectory = "",
+                  const unsigned long diskLimit = 0);
+
+    /** destructor.
+     *  Deletes all spill files created by this object.
+     */
+    virtual ~DiRenderCache();
+
+    /** copy the output data of a cached frame to the given buffer
+     *
+     ** @param  key     key of the rendered frame
+     *  @param  buffer  buffer the output data is copied to
+     *  @param  size    size of the buffer (in bytes), has to match the size of the
+     *                  cached output data exactly
+     *
+     ** @return true if the frame has been found in the cache, false otherwise
+     */
+    virtual OFBool getData(const DiRenderCacheKey &key,
+                           void *buffer,
+                           const unsigned long size);
+
+    /** add the output data of a rendered frame to the cache.
+     *  An existing entry for the same key is replaced.
+     *
+     ** @param  key     key of the rendered frame
+     *  @param  data    output data of the rendered frame
+     *  @param  size    size of the output data (in bytes)
+     *
+     ** @return true if the frame has been added to the cache, false otherwise
+     *          (e.g. it is larger than the memory limit and no spill directory is used)
+     */
+    virtual OFBool putData(const DiRenderCacheKey &key,
+                           const void *data,
+                           const unsigned long size);
+
+    /** get the output data of a rendered frame from the cache or render it.
+     *  If the frame is not cached, the parameters of the key are applied to the given
+     *  image (see DiRenderCacheKey::applyTo()), the frame is scaled to the size
+     *  specified by the key (if necessary), rendered and added to the cache.
+     *  The image is therefore only needed (and should only be loaded) if this method
+     *  has been called with a NULL pointer before, i.e. as follows:
+     *  \code
+     *  if (!cache.getOutputData(key, NULL, buffer, size))
+     *  {
+     *      DicomImage image(filename, CIF_UsePartialAccessToPixelData, key.getFrame(), 1);
+     *      cache.getOutputData(key, &image, buffer, size, key.getFrame());
+     *  }
+     *  \endcode
+     *
+     ** @param  key         key of the rendered frame
+     *  @param  image       image to be rendered if the frame is not cached (might be NULL)
+     *  @param  buffer      buffer the output data is copied to
+     *  @param  size        size of the buffer (in bytes), has to match the size of the
+     *                      output data exactly
+     *  @param  firstFrame  number of the first frame contained in 'image', e.g. if the
+     *                      image has been created with a frame range
+     *
+     ** @return true if successful, false otherwise
+     */
+    OFBool getOutputData(const DiRenderCacheKey &key,
+                         DicomImage *image,
+                         void *buffer,
+                         const unsigned long size,
+                         const unsigned long firstFrame = 0);
+
+    /** remove all frames from the cache and delete the spill files
+     */
+    void clear();
+
+    /** get number of bytes of output data kept in memory
+     *
+     ** @return number of bytes kept in memory
+     */
+    unsigned long getMemoryUsage();
+
+    /** get number of bytes of output data stored in the spill directory
+     *
+     ** @return number of bytes stored in spill files
+     */
+    unsigned long getDiskUsage();
+
+    /** get number of successful calls of getData() since the creation of the cache
+     *
+     ** @return number of cache hits
+     */
+    unsigned long getHits();
+
+    /** get number of unsuccessful calls of getData() since the creation of the cache
+     *
+     ** @return number of cache misses
+     */
+    unsigned long getMisses();
+
+
+ private:
+
+    /// cached frame kept in memory
+    struct MemoryEntry
+    {
+        /// output data
+        Uint8 *Data;
+        /// size of the output data (in bytes)
+        unsigned long Size;
+        /// position in the list of recently used keys
+        OFListIterator(OFString) Position;
+    };
+
+    /// cached frame stored in a spill file
+    struct DiskEntry
+    {
+        /// name of the spill file
+        OFString Filename;
+        /// size of the output data (in bytes)
+        unsigned long Size;
+        /// position in the list of recently used keys
+        OFListIterator(OFString) Position;
+    };
+
+    /// frame to be written to a spill file after the mutex has been unlocked
+    struct SpillRequest
+    {
+        /// string representation of the key
+        OFString Key;
+        /// output data (owned by the request)
+        Uint8 *Data;
+        /// size of the output data (in bytes)
+        unsigned long Size;
+    };
+
+    /** check whether a frame of the given size can be stored in a spill file
+     *
+     ** @param  size  size of the output data (in bytes)
+     *
+     ** @return true if a spill directory is used and the frame does not exceed the limit
+     */
+    OFBool canSpill(const unsigned long size) const;
+
+    /** write output data to a new spill file and add it to the cache.
+     *  Should only be called if the mutex is not locked, since the file is written
+     *  without holding the lock.
+     *
+     ** @param  key      string representation of the key
+     *  @param  data     output data
+     *  @param  size     size of the output data (in bytes)
+     *  @param  replace  replace an existing entry for the same key if true, discard the
+     *                   new spill file otherwise
+     *
+     ** @return true if successful, false otherwise
+     */
+    OFBool spill(const OFString &key,
+                 const Uint8 *data,
+                 const unsigned long size,
+                 const OFBool replace);
+
+    /** write the given frames to spill files (see spill()) and free their output data.
+     *  Should only be called if the mutex is not locked.
+     *
+     ** @param  spills  frames to be written, empty afterwards
+     */
+    void writeSpillFiles(OFList<SpillRequest> &spills);
+
+    /** add output data to the memory cache. The least recently used frames are removed
+     *  and, if possible, added to the given list of frames to be written to spill files.
+     *  Should only be called if the mutex is locked.
+     *
+     ** @param  key     string representation of the key
+     *  @param  data    output data (the cache takes ownership)
+     *  @param  size    size of the output data (in bytes)
+     *  @param  spills  list the removed frames are added to
+     */
+    void addToMemory(const OFString &key,
+                     Uint8 *data,
+                     const unsigned long size,
+                     OFList<SpillRequest> &spills);
+
+    /** add a spill file to the cache and remove the least recently used spill files if
+     *  necessary. Should only be called if the mutex is locked.
+     *
+     ** @param  key            string representation of the key
+     *  @param  filename       name of the spill file (the cache takes ownership)
+     *  @param  size           size of the output data (in bytes)
+     *  @param  replace        replace an existing entry for the same key if true,
+     *                         discard the spill file otherwise
+     *  @param  obsoleteFiles  list the names of spill files to be deleted are added to
+     *
+     ** @return true if the spill file has been added, false otherwise
+     */
+    OFBool addToDisk(const OFString &key,
+                     const OFString &filename,
+                     const unsigned long size,
+                     const OFBool replace,
+                     OFList<OFString> &obsoleteFiles);
+
+    /** remove a frame from the memory cache. Should only be called if the mutex is locked.
+     *
+     ** @param  key  string representation of the key
+     */
+    void removeFromMemory(const OFString &key);
+
+    /** remove a frame from the spill directory. The spill file is not deleted but added
+     *  to the given list, so it can be deleted after the mutex has been unlocked.
+     *  Should only be called if the mutex is locked.
+     *
+     ** @param  key            string representation of the key
+     *  @param  obsoleteFiles  list the name of the spill file is added to
+     */
+    void removeFromDisk(const OFString &key,
+                        OFList<OFString> &obsoleteFiles);
+
+    /// maximum number of bytes kept in memory
+    const unsigned long MemoryLimit;
+    /// directory for spill files (empty = none)
+    const OFString SpillDirectory;
+    /// maximum number of bytes stored in spill files (0 = no limit)
+    const unsigned long DiskLimit;
+
+    /// frames kept in memory
+    OFMap<OFString, MemoryEntry> MemoryEntries;
+    /// keys of the frames kept in memory, most recently used first
+    OFList<OFString> MemoryList;
+    /// number of bytes kept in memory
+    unsigned long MemoryUsage;
+
+    /// frames stored in spill files
+    OFMap<OFString, DiskEntry> DiskEntries;
+    /// keys of the frames stored in spill files, most recently used first
+    OFList<OFString> DiskList;
+    /// number of bytes stored in spill files
+    unsigned long DiskUsage;
+
+    /// number of cache hits
+    unsigned long Hits;
+    /// number of cache misses
+    unsigned long Misses;
+
+#ifdef WITH_THREADS
+    /// mutex protecting all member variables
+    OFMutex Mutex;
+#endif
+
+ // --- declarations to avoid compiler warnings
+
+    DiRenderCache(const DiRenderCache &);
+    DiRenderCache &operator=(const DiRenderCache &);
+};
+
+
+#endif
@@ -0,0 +1,192 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomScaleFilter (Header)
+ *
+ */
+
+
+#ifndef DISCALEF_H
+#define DISCALEF_H
+
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmimgle/didefine.h"
+
+#include "dcmtk/ofstd/ofvector.h"
+#include "dcmtk/ofstd/oftypes.h"
+
+
+/*---------------------*
+ *  class declaration  *
+ *---------------------*/
+
+/** Class describing a one-dimensional resampling filter, i.e. the weights with which
+ *  the source pixels of a row (or column) contribute to each destination pixel.
+ *  Two such filters (one for each axis) describe a separable scaling algorithm.
+ *  After all weights have been added, the filter is converted to a table of fixed
+ *  width: each destination pixel is computed from 'width' consecutive source pixels
+ *  (starting at the respective start index), some of them possibly with weight 0.
+ */
+class DCMTK_DCMIMGLE_EXPORT DiScaleFilter
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  srcCount   number of source pixels
+     *  @param  destCount  number of destination pixels
+     */
+    DiScaleFilter(const Uint16 srcCount,
+                  const Uint16 destCount);
+
+    /** destructor
+     */
+    virtual ~DiScaleFilter();
+
+    /** set up the filter for bilinear interpolation (magnification only).
+     *  Based on the scaling algorithm contributed by Eduard Stanescu.
+     */
+    void setupBilinear();
+
+    /** set up the filter for bicubic interpolation (magnification only).
+     *  Based on the scaling algorithm contributed by Eduard Stanescu, which treats
+     *  the last few columns and the last few lines slightly differently.
+     *
+     ** @param  lines  set up filter for the lines (vertical axis) if true,
+     *                 for the columns (horizontal axis) otherwise
+     */
+    void setupBicubic(const OFBool lines);
+
+    /** set up the filter for expansion with interpolation (magnification only).
+     *  Based on the scaling algorithm from "c't - Magazin fuer Computertechnik" (c't 11/94).
+     */
+    void setupExpansion();
+
+    /** set up the filter for reduction with interpolation (reduction only), i.e. each
+     *  destination pixel is the average of the source pixels covered by its area.
+     *  Based on the scaling algorithm from "c't - Magazin fuer Computertechnik" (c't 11/94).
+     */
+    void setupReduction();
+
+    /** add the contribution of a source pixel to a destination pixel.
+     *  Source indices outside the valid range are mapped to the first or last pixel,
+     *  i.e. the border pixels are replicated. Multiple contributions of the same
+     *  source pixel are summed up.
+     *
+     ** @param  dest    index of the destination pixel
+     *  @param  src     index of the source pixel
+     *  @param  weight  weight of the source pixel
+     */
+    void addWeight(const Uint16 dest,
+                   const signed long src,
+                   const double weight);
+
+    /** convert the added weights to a table of fixed width.
+     *  Should be called after all weights have been added and before any of the
+     *  following methods is called. The setup methods call it automatically.
+     */
+    void createTable();
+
+    /** get number of destination pixels
+     *
+     ** @return number of destination pixels
+     */
+    inline Uint16 getDestinationCount() const
+    {
+        return DestCount;
+    }
+
+    /** get number of consecutive source pixels used for each destination pixel
+     *
+     ** @return width of the filter (at least 1)
+     */
+    inline unsigned long getWidth() const
+    {
+        return Width;
+    }
+
+    /** get index of the first source pixel used for each destination pixel
+     *
+     ** @return array of 'getDestinationCount()' start indices
+     */
+    inline const Sint32 *getStart() const
+    {
+        return &Start[0];
+    }
+
+    /** get weights of the source pixels. The weights are stored tap by tap, i.e. the
+     *  weight of source pixel 'start[i] + k' for destination pixel 'i' is stored at
+     *  index 'k * getDestinationCount() + i'.
+     *
+     ** @return array of 'getWidth() * getDestinationCount()' weights
+     */
+    inline const double *getWeights() const
+    {
+        return &Weights[0];
+    }
+
+
+ private:
+
+    /** add the contributions for a linear interpolation between two source pixels
+     *
+     ** @param  dest    index of the destination pixel
+     *  @param  src     index of the first source pixel
+     *  @param  offset  offset of the destination pixel from the first source pixel (0..1)
+     */
+    void addLinearWeights(const Uint16 dest,
+                          const signed long src,
+                          const double offset);
+
+    /** add the contributions for a cubic interpolation (Catmull-Rom) between the
+     *  second and third of four source pixels
+     *
+     ** @param  dest    index of the destination pixel
+     *  @param  src     index of the second source pixel
+     *  @param  offset  offset of the destination pixel from the second source pixel (0..1)
+     */
+    void addCubicWeights(const Uint16 dest,
+                         const signed long src,
+                         const double offset);
+
+    /// contribution of a source pixel to a destination pixel
+    struct Contribution
+    {
+        /// index of the destination pixel
+        Uint16 Dest;
+        /// index of the source pixel
+        Uint16 Source;
+        /// weight of the source pixel
+        double Weight;
+    };
+
+    /// number of source pixels
+    const Uint16 SrcCount;
+    /// number of destination pixels
+    const Uint16 DestCount;
+    /// width of the filter table
+    unsigned long Width;
+
+    /// contributions added so far (cleared by createTable)
+    OFVector<Contribution> Contributions;
+    /// index of the first source pixel for each destination pixel
+    OFVector<Sint32> Start;
+    /// weights of the filter table
+    OFVector<double> Weights;
+
+ // --- declarations to avoid compiler warnings
+
+    DiScaleFilter(const DiScaleFilter &);
+    DiScaleFilter &operator=(const DiScaleFilter &);
+};
+
+
+#endif
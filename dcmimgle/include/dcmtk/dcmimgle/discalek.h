@@ -0,0 +1,126 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomScaleKernels (Header)
+ *
+ */
+
+
+#ifndef DISCALEK_H
+#define DISCALEK_H
+
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmimgle/didefine.h"
+
+#include "dcmtk/ofstd/oftypes.h"
+#include "dcmtk/ofstd/ofcast.h"
+
+
+/*---------------------*
+ *  class declaration  *
+ *---------------------*/
+
+/** Class collecting the innermost loops of the separable scaling algorithms (see
+ *  DiScaleTemplate), i.e. the weighted sum of source rows and the application of a
+ *  filter table (see DiScaleFilter) to a row. For 8 and 16 bit pixel data, which is
+ *  processed with single precision, vectorized versions of these loops are used if
+ *  supported by the CPU (the instruction set is determined by DiMonoKernels).
+ *  The results of the vectorized versions are identical to the generic version.
+ */
+class DCMTK_DCMIMGLE_EXPORT DiScaleKernels
+{
+
+ public:
+
+    /** add a weighted source row to an accumulator row (generic version),
+     *  i.e. dst[i] += weight * src[i]
+     *
+     ** @param  src     source pixels
+     *  @param  dst     accumulator values
+     *  @param  count   number of pixels
+     *  @param  weight  weight of the source row
+     */
+    template<class T, class A>
+    static inline void addWeightedRow(const T *src,
+                                      A *dst,
+                                      const unsigned long count,
+                                      const A weight)
+    {
+        for (unsigned long i = count; i != 0; --i)
+            *(dst++) += weight * OFstatic_cast(A, *(src++));
+    }
+
+    /// add a weighted source row to an accumulator row (vectorized version, see above)
+    static void addWeightedRow(const Uint8 *src, float *dst, const unsigned long count, const float weight);
+    /// add a weighted source row to an accumulator row (vectorized version, see above)
+    static void addWeightedRow(const Uint16 *src, float *dst, const unsigned long count, const float weight);
+    /// add a weighted source row to an accumulator row (vectorized version, see above)
+    static void addWeightedRow(const Sint16 *src, float *dst, const unsigned long count, const float weight);
+
+    /** add a source row to an accumulator row (generic version), i.e. dst[i] += src[i]
+     *
+     ** @param  src    source pixels
+     *  @param  dst    accumulator values
+     *  @param  count  number of pixels
+     */
+    template<class T, class A>
+    static inline void addRow(const T *src,
+                              A *dst,
+                              const unsigned long count)
+    {
+        for (unsigned long i = count; i != 0; --i)
+            *(dst++) += OFstatic_cast(A, *(src++));
+    }
+
+    /// add a source row to an accumulator row (vectorized version, see above)
+    static void addRow(const Uint8 *src, Sint32 *dst, const unsigned long count);
+    /// add a source row to an accumulator row (vectorized version, see above)
+    static void addRow(const Uint16 *src, Sint32 *dst, const unsigned long count);
+    /// add a source row to an accumulator row (vectorized version, see above)
+    static void addRow(const Sint16 *src, Sint32 *dst, const unsigned long count);
+
+    /** apply a filter table to a row (generic version), i.e. compute each destination
+     *  value as the weighted sum of 'width' consecutive source values
+     *
+     ** @param  src      source values
+     *  @param  dst      destination values
+     *  @param  count    number of destination values
+     *  @param  start    index of the first source value for each destination value
+     *  @param  weights  weights stored tap by tap (see DiScaleFilter::getWeights())
+     *  @param  width    number of source values per destination value
+     */
+    template<class A>
+    static inline void applyFilter(const A *src,
+                                   A *dst,
+                                   const unsigned long count,
+                                   const Sint32 *start,
+                                   const A *weights,
+                                   const unsigned long width)
+    {
+        unsigned long i, k;
+        const A *w;
+        A value;
+        for (i = 0; i < count; ++i)
+        {
+            value = 0;
+            w = weights + i;
+            for (k = 0; k < width; ++k, w += count)
+                value += *w * src[start[i] + k];
+            dst[i] = value;
+        }
+    }
+
+    /// apply a filter table to a row (vectorized version, see above)
+    static void applyFilter(const float *src, float *dst, const unsigned long count, const Sint32 *start,
+                            const float *weights, const unsigned long width);
+};
+
+
+#endif
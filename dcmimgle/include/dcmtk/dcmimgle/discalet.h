@@ -26,9 +26,14 @@
 #include "dcmtk/config/osconfig.h"
 
 #include "dcmtk/ofstd/ofcast.h"
+#include "dcmtk/ofstd/ofbmanip.h"
+#include "dcmtk/ofstd/ofvector.h"
 
 #include "dcmtk/dcmimgle/ditranst.h"
 #include "dcmtk/dcmimgle/dipxrept.h"
+#include "dcmtk/dcmimgle/diparal.h"
+#include "dcmtk/dcmimgle/discalef.h"
+#include "dcmtk/dcmimgle/discalek.h"
 
 
 /*---------------------*
@@ -73,25 +78,255 @@ static inline void setScaleValues(Uint16 data[],
     }
 }
 
-// cubic value interpolation using Catmull-Rom formula.
-// the interpolated pixel lies between the second and the third original pixels
-static inline double cubicValue(const double v1,
-                                const double v2,
-                                const double v3,
-                                const double v4,
-                                const double dD,
-                                const double minVal,
-                                const double maxVal)
-{
-    double dVal = 0.5 * ((((-v1 + 3 * v2 - 3 * v3 + v4) * dD + (2 * v1 - 5 * v2 + 4 * v3 - v4)) * dD + (-v1 + v3)) * dD + (v2 + v2));
-    return (dVal < minVal) ? minVal : ((dVal > maxVal) ? maxVal : dVal);
-}
-
 
 /*---------------------*
  *  class declaration  *
  *---------------------*/
 
+/** Template class to scale the rows of a frame with a separable algorithm described by
+ *  two filters (see DiScaleFilter), possibly split into several blocks of rows processed
+ *  in parallel (see DiParallelLoop). Each destination row is computed from the weighted
+ *  sum of the source rows followed by the horizontal filter. The resulting values are
+ *  either rounded (by adding 0.5 and truncating) or truncated.
+ */
+template<class T, class A>
+class DiScaleResampleLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  src       source pixels (first pixel of the clipping area)
+     *  @param  columns   number of pixels per row of the source image
+     *  @param  dest      destination pixels
+     *  @param  srcCols   width of the clipping area
+     *  @param  xFilter   filter for the horizontal axis (columns)
+     *  @param  yFilter   filter for the vertical axis (rows)
+     *  @param  clip      limit the resulting values to the range [minValue, maxValue] if true
+     *  @param  minValue  minimum resulting value (only used if 'clip' is true)
+     *  @param  maxValue  maximum resulting value (only used if 'clip' is true)
+     *  @param  round     round the resulting values if true, truncate them otherwise
+     */
+    DiScaleResampleLoop(const T *src,
+                        const unsigned long columns,
+                        T *dest,
+                        const Uint16 srcCols,
+                        const DiScaleFilter &xFilter,
+                        const DiScaleFilter &yFilter,
+                        const OFBool clip,
+                        const double minValue,
+                        const double maxValue,
+                        const OFBool round)
+      : DiParallelLoop(yFilter.getDestinationCount(), dcmRenderingMaxThreads.get(), MinimumBlockSize /
+            (OFstatic_cast(unsigned long, srcCols) * yFilter.getWidth() + xFilter.getDestinationCount() * xFilter.getWidth()) + 1),
+        Source(src),
+        Columns(columns),
+        Destination(dest),
+        SrcCols(srcCols),
+        XFilter(xFilter),
+        YFilter(yFilter),
+        XWeights(xFilter.getWidth() * xFilter.getDestinationCount()),
+        YWeights(yFilter.getWidth() * yFilter.getDestinationCount()),
+        Clip(clip),
+        MinValue(OFstatic_cast(A, minValue)),
+        MaxValue(OFstatic_cast(A, maxValue)),
+        Round(round)
+    {
+        // convert the weights to the type used for the computation
+        unsigned long i;
+        for (i = 0; i < XWeights.size(); ++i)
+            XWeights[i] = OFstatic_cast(A, xFilter.getWeights()[i]);
+        for (i = 0; i < YWeights.size(); ++i)
+            YWeights[i] = OFstatic_cast(A, yFilter.getWeights()[i]);
+    }
+
+ protected:
+
+    /// scale the given block of rows
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        const unsigned long destCols = XFilter.getDestinationCount();
+        const unsigned long destRows = YFilter.getDestinationCount();
+        const unsigned long width = YFilter.getWidth();
+        const Sint32 *rowStart = YFilter.getStart();
+        A *row = new A[SrcCols];
+        A *result = new A[destCols];
+        if ((row != NULL) && (result != NULL))
+        {
+            const T *p;
+            T *q = Destination + start * destCols;
+            unsigned long x;
+            A value;
+            for (unsigned long y = start; y < end; ++y)
+            {
+                // first, sum up the weighted source rows
+                OFBitmanipTemplate<A>::zeroMem(row, SrcCols);
+                p = Source + OFstatic_cast(unsigned long, rowStart[y]) * Columns;
+                for (unsigned long k = 0; k < width; ++k, p += Columns)
+                {
+                    const A weight = YWeights[k * destRows + y];
+                    if (weight != 0)
+                        DiScaleKernels::addWeightedRow(p, row, SrcCols, weight);
+                }
+                // then, apply the horizontal filter to the resulting row
+                DiScaleKernels::applyFilter(row, result, destCols, XFilter.getStart(), &XWeights[0], XFilter.getWidth());
+                for (x = 0; x < destCols; ++x)
+                {
+                    value = result[x];
+                    if (Clip)
+                        value = (value < MinValue) ? MinValue : ((value > MaxValue) ? MaxValue : value);
+                    *(q++) = OFstatic_cast(T, Round ? value + 0.5 : value);
+                }
+            }
+        }
+        delete[] row;
+        delete[] result;
+    }
+
+ private:
+
+    /// source pixels
+    const T *Source;
+    /// number of pixels per row of the source image
+    const unsigned long Columns;
+    /// destination pixels
+    T *Destination;
+    /// width of the clipping area
+    const Uint16 SrcCols;
+    /// filter for the horizontal axis
+    const DiScaleFilter &XFilter;
+    /// filter for the vertical axis
+    const DiScaleFilter &YFilter;
+    /// weights of the horizontal filter (converted to the type used for the computation)
+    OFVector<A> XWeights;
+    /// weights of the vertical filter (converted to the type used for the computation)
+    OFVector<A> YWeights;
+    /// limit the resulting values if true
+    const OFBool Clip;
+    /// minimum resulting value
+    const A MinValue;
+    /// maximum resulting value
+    const A MaxValue;
+    /// round the resulting values if true
+    const OFBool Round;
+
+ // --- declarations to avoid compiler warnings
+
+    DiScaleResampleLoop(const DiScaleResampleLoop<T, A> &);
+    DiScaleResampleLoop<T, A> &operator=(const DiScaleResampleLoop<T, A> &);
+};
+
+
+/** Template class to reduce the rows of a frame by area averaging (box filter), possibly
+ *  split into several blocks of rows processed in parallel (see DiParallelLoop). Each
+ *  destination pixel is the average of a block of source pixels, the sums are determined
+ *  with the accumulator type A (e.g. a 32 bit integer for 8 and 16 bit pixel data).
+ */
+template<class T, class A>
+class DiScaleBoxLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  src       source pixels (first pixel of the clipping area)
+     *  @param  columns   number of pixels per row of the source image
+     *  @param  dest      destination pixels
+     *  @param  srcCols   width of the clipping area
+     *  @param  destCols  width of the destination image
+     *  @param  destRows  height of the destination image
+     *  @param  xBorders  first source column of each block ('destCols' + 1 entries)
+     *  @param  yBorders  first source row of each block ('destRows' + 1 entries)
+     */
+    DiScaleBoxLoop(const T *src,
+                   const unsigned long columns,
+                   T *dest,
+                   const Uint16 srcCols,
+                   const Uint16 destCols,
+                   const Uint16 destRows,
+                   const unsigned long *xBorders,
+                   const unsigned long *yBorders)
+      : DiParallelLoop(destRows, dcmRenderingMaxThreads.get(), MinimumBlockSize /
+            (OFstatic_cast(unsigned long, srcCols) * (yBorders[destRows] / destRows)) + 1),
+        Source(src),
+        Columns(columns),
+        Destination(dest),
+        SrcCols(srcCols),
+        DestCols(destCols),
+        XBorders(xBorders),
+        YBorders(yBorders)
+    {
+    }
+
+ protected:
+
+    /// reduce the given block of rows
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        A *row = new A[SrcCols];
+        if (row != NULL)
+        {
+            const A *p;
+            T *q = Destination + start * DestCols;
+            unsigned long x;
+            unsigned long i;
+            A sum;
+            double value;
+            for (unsigned long y = start; y < end; ++y)
+            {
+                // first, sum up the source rows of the block
+                OFBitmanipTemplate<A>::zeroMem(row, SrcCols);
+                for (i = YBorders[y]; i < YBorders[y + 1]; ++i)
+                    DiScaleKernels::addRow(Source + i * Columns, row, SrcCols);
+                const double rows = OFstatic_cast(double, YBorders[y + 1] - YBorders[y]);
+                // then, sum up the columns of each block and determine the average
+                p = row;
+                for (x = 0; x < DestCols; ++x)
+                {
+                    sum = 0;
+                    for (i = XBorders[x + 1] - XBorders[x]; i != 0; --i)
+                        sum += *(p++);
+                    value = OFstatic_cast(double, sum) / (rows * OFstatic_cast(double, XBorders[x + 1] - XBorders[x]));
+                    // rounded like the c't reduction (see DiScaleResampleLoop)
+                    *(q++) = OFstatic_cast(T, value + 0.5);
+                }
+            }
+        }
+        delete[] row;
+    }
+
+ private:
+
+    /// source pixels
+    const T *Source;
+    /// number of pixels per row of the source image
+    const unsigned long Columns;
+    /// destination pixels
+    T *Destination;
+    /// width of the clipping area
+    const Uint16 SrcCols;
+    /// width of the destination image
+    const Uint16 DestCols;
+    /// first source column of each block
+    const unsigned long *XBorders;
+    /// first source row of each block
+    const unsigned long *YBorders;
+
+ // --- declarations to avoid compiler warnings
+
+    DiScaleBoxLoop(const DiScaleBoxLoop<T, A> &);
+    DiScaleBoxLoop<T, A> &operator=(const DiScaleBoxLoop<T, A> &);
+};
+
+
 /** Template class to scale images (on pixel data level).
  *  with and without interpolation
  */
@@ -181,7 +416,8 @@ class DiScaleTemplate
      ** @param  src          array of pointers to source image pixels
      *  @param  dest         array of pointers to destination image pixels
      *  @param  interpolate  preferred interpolation algorithm (0 = no interpolation, 1 = pbmplus algorithm,
-     *                         2 = c't algorithm, 3 = bilinear magnification, 4 = bicubic magnification)
+     *                         2 = c't algorithm, 3 = bilinear magnification, 4 = bicubic magnification,
+     *                         5 = area averaging reduction/bilinear magnification)
      *  @param  value        value to be set outside the image boundaries (used for clipping, default: 0)
      */
     void scaleData(const T *src[],
@@ -211,6 +447,8 @@ class DiScaleTemplate
                 else
                     clipBorderPixel(src, dest, value);                                // clipping (with border)
             }
+            else if ((interpolate == 5) && (this->Src_X >= this->Dest_X) && (this->Src_Y >= this->Dest_Y))
+                boxPixel(src, dest);                                                  // area averaging (box filter)
             else if ((interpolate == 1) && (this->Bits <= MAX_INTERPOLATION_BITS))
                 interpolatePixel(src, dest);                                          // interpolation (pbmplus)
             else if ((interpolate == 4) && (this->Dest_X >= this->Src_X) && (this->Dest_Y >= this->Src_Y) &&
@@ -691,25 +929,6 @@ class DiScaleTemplate
                      T *dest[])
     {
         DCMIMGLE_DEBUG("using expand pixel scaling algorithm with interpolation from c't magazine");
-        const double x_factor = OFstatic_cast(double, this->Src_X) / OFstatic_cast(double, this->Dest_X);
-        const double y_factor = OFstatic_cast(double, this->Src_Y) / OFstatic_cast(double, this->Dest_Y);
-        const unsigned long f_size = OFstatic_cast(unsigned long, Rows) * OFstatic_cast(unsigned long, Columns);
-        const T *sp;
-        double bx, ex;
-        double by, ey;
-        int bxi, exi;
-        int byi, eyi;
-        unsigned long offset;
-        double value, sum;
-        double x_part, y_part;
-        double l_factor, r_factor;
-        double t_factor, b_factor;
-        register int xi;
-        register int yi;
-        register Uint16 x;
-        register Uint16 y;
-        register const T *p;
-        register T *q;
 
         /*
          *   based on scaling algorithm from "c't - Magazin fuer Computertechnik" (c't 11/94)
@@ -717,92 +936,11 @@ class DiScaleTemplate
          *    various bit depths, multi-frame and multi-plane/color images, combined clipping/scaling)
          */
 
-        for (int j = 0; j < this->Planes; ++j)
-        {
-            sp = src[j] + OFstatic_cast(unsigned long, Top) * OFstatic_cast(unsigned long, Columns) + Left;
-            q = dest[j];
-            for (unsigned long f = 0; f < this->Frames; ++f)
-            {
-                for (y = 0; y < this->Dest_Y; ++y)
-                {
-                    by = y_factor * OFstatic_cast(double, y);
-                    ey = y_factor * (OFstatic_cast(double, y) + 1.0);
-                    if (ey > this->Src_Y)
-                    {
-#ifdef DEBUG            // this output is only useful for debugging purposes
-                        DCMIMGLE_TRACE("  limiting value of 'ey' to 'Src_Y': " << ey << " -> " << this->Src_Y);
-#endif
-                        // see reducePixel()
-                        ey = this->Src_Y;
-                    }
-                    byi = OFstatic_cast(int, by);
-                    eyi = OFstatic_cast(int, ey);
-                    if (OFstatic_cast(double, eyi) == ey)
-                    {
-#ifdef DEBUG            // this output is only useful for debugging purposes
-                        DCMIMGLE_TRACE("  decreasing value of 'eyi' by 1: " << eyi << " -> " << (eyi - 1));
-#endif
-                        --eyi;
-                    }
-                    y_part = OFstatic_cast(double, eyi) / y_factor;
-                    b_factor = y_part - OFstatic_cast(double, y);
-                    t_factor = (OFstatic_cast(double, y) + 1.0) - y_part;
-                    for (x = 0; x < this->Dest_X; ++x)
-                    {
-                        value = 0;
-                        bx = x_factor * OFstatic_cast(double, x);
-                        ex = x_factor * (OFstatic_cast(double, x) + 1.0);
-                        if (ex > this->Src_X)
-                        {
-#ifdef DEBUG                // this output is only useful for debugging purposes
-                            DCMIMGLE_TRACE("  limiting value of 'ex' to 'Src_X': " << ex << " -> " << this->Src_X);
-#endif
-                            // see reducePixel()
-                            ex = this->Src_X;
-                        }
-                        bxi = OFstatic_cast(int, bx);
-                        exi = OFstatic_cast(int, ex);
-                        if (OFstatic_cast(double, exi) == ex)
-                        {
-#ifdef DEBUG                // this output is only useful for debugging purposes
-                            DCMIMGLE_TRACE("  decreasing value of 'exi' by 1: " << exi << " -> " << (exi - 1));
-#endif
-                            --exi;
-                        }
-                        x_part = OFstatic_cast(double, exi) / x_factor;
-                        l_factor = x_part - OFstatic_cast(double, x);
-                        r_factor = (OFstatic_cast(double, x) + 1.0) - x_part;
-                        offset = OFstatic_cast(unsigned long, byi) * OFstatic_cast(unsigned long, Columns);
-                        for (yi = byi; yi <= eyi; ++yi)
-                        {
-                            p = sp + offset + bxi;
-                            for (xi = bxi; xi <= exi; ++xi)
-                            {
-                                sum = OFstatic_cast(double, *(p++));
-                                if (bxi != exi)
-                                {
-                                    if (xi == bxi)
-                                        sum *= l_factor;
-                                    else
-                                        sum *= r_factor;
-                                }
-                                if (byi != eyi)
-                                {
-                                    if (yi == byi)
-                                        sum *= b_factor;
-                                    else
-                                        sum *= t_factor;
-                                }
-                                value += sum;
-                            }
-                            offset += Columns;
-                        }
-                        *(q++) = OFstatic_cast(T, value + 0.5);
-                    }
-                }
-                sp += f_size;
-            }
-        }
+        DiScaleFilter xFilter(this->Src_X, this->Dest_X);
+        DiScaleFilter yFilter(this->Src_Y, this->Dest_Y);
+        xFilter.setupExpansion();
+        yFilter.setupExpansion();
+        resamplePixel(src, dest, xFilter, yFilter, OFTrue /*round*/);
     }
 
 
@@ -815,25 +953,6 @@ class DiScaleTemplate
                      T *dest[])
     {
         DCMIMGLE_DEBUG("using reduce pixel scaling algorithm with interpolation from c't magazine");
-        const double x_factor = OFstatic_cast(double, this->Src_X) / OFstatic_cast(double, this->Dest_X);
-        const double y_factor = OFstatic_cast(double, this->Src_Y) / OFstatic_cast(double, this->Dest_Y);
-        const double xy_factor = x_factor * y_factor;
-        const unsigned long f_size = OFstatic_cast(unsigned long, Rows) * OFstatic_cast(unsigned long, Columns);
-        const T *sp;
-        double bx, ex;
-        double by, ey;
-        int bxi, exi;
-        int byi, eyi;
-        unsigned long offset;
-        double value, sum;
-        double l_factor, r_factor;
-        double t_factor, b_factor;
-        register int xi;
-        register int yi;
-        register Uint16 x;
-        register Uint16 y;
-        register const T *p;
-        register T *q;
 
         /*
          *   based on scaling algorithm from "c't - Magazin fuer Computertechnik" (c't 11/94)
@@ -841,88 +960,57 @@ class DiScaleTemplate
          *    various bit depths, multi-frame and multi-plane/color images, combined clipping/scaling)
          */
 
+        DiScaleFilter xFilter(this->Src_X, this->Dest_X);
+        DiScaleFilter yFilter(this->Src_Y, this->Dest_Y);
+        xFilter.setupReduction();
+        yFilter.setupReduction();
+        resamplePixel(src, dest, xFilter, yFilter, OFTrue /*round*/);
+    }
+
+
+    /** reduction method with area averaging (box filter), i.e. each destination pixel
+     *  is the average of a block of source pixels. In contrast to reducePixel(), the
+     *  blocks do not overlap, so the sums can be determined with integer arithmetic.
+     *
+     ** @param  src   array of pointers to source image pixels
+     *  @param  dest  array of pointers to destination image pixels
+     */
+    void boxPixel(const T *src[],
+                  T *dest[])
+    {
+        DCMIMGLE_DEBUG("using reduce pixel scaling algorithm with area averaging (box filter)");
+        const unsigned long f_size = OFstatic_cast(unsigned long, Rows) * OFstatic_cast(unsigned long, Columns);
+        const unsigned long d_size = OFstatic_cast(unsigned long, this->Dest_X) * OFstatic_cast(unsigned long, this->Dest_Y);
+        // first source column/row of each block, the last entry marks the end of the clipping area
+        OFVector<unsigned long> xBorders(this->Dest_X + 1);
+        OFVector<unsigned long> yBorders(this->Dest_Y + 1);
+        Uint16 i;
+        for (i = 0; i <= this->Dest_X; ++i)
+            xBorders[i] = OFstatic_cast(unsigned long, i) * this->Src_X / this->Dest_X;
+        for (i = 0; i <= this->Dest_Y; ++i)
+            yBorders[i] = OFstatic_cast(unsigned long, i) * this->Src_Y / this->Dest_Y;
+        // maximum number of source pixels per block
+        const unsigned long maxBlock = ((this->Src_X + this->Dest_X - 1) / this->Dest_X) * ((this->Src_Y + this->Dest_Y - 1) / this->Dest_Y);
+        const T *sp;
+        T *q;
         for (int j = 0; j < this->Planes; ++j)
         {
             sp = src[j] + OFstatic_cast(unsigned long, Top) * OFstatic_cast(unsigned long, Columns) + Left;
             q = dest[j];
-            for (unsigned long f = 0; f < this->Frames; ++f)
+            for (unsigned long f = this->Frames; f != 0; --f)
             {
-                for (y = 0; y < this->Dest_Y; ++y)
-                {
-                    by = y_factor * OFstatic_cast(double, y);
-                    ey = y_factor * (OFstatic_cast(double, y) + 1.0);
-                    if (ey > this->Src_Y)
-                    {
-#ifdef DEBUG            // this output is only useful for debugging purposes
-                        DCMIMGLE_TRACE("  limiting value of 'ey' to 'Src_Y': " << ey << " -> " << this->Src_Y);
-#endif
-                        // yes, this can happen due to rounding, e.g. double(943) / double(471) * double(471)
-                        // is something like 943.00000000000011368683772161602974 and then, the eyi == ey check
-                        // fails to bring eyi back into range!
-                        ey = this->Src_Y;
-                    }
-                    byi = OFstatic_cast(int, by);
-                    eyi = OFstatic_cast(int, ey);
-                    if (OFstatic_cast(double, eyi) == ey)
-                    {
-#ifdef DEBUG            // this output is only useful for debugging purposes
-                        DCMIMGLE_TRACE("  decreasing value of 'eyi' by 1: " << eyi << " -> " << (eyi - 1));
-#endif
-                        --eyi;
-                    }
-                    b_factor = 1 + OFstatic_cast(double, byi) - by;
-                    t_factor = ey - OFstatic_cast(double, eyi);
-                    for (x = 0; x < this->Dest_X; ++x)
-                    {
-                        value = 0;
-                        bx = x_factor * OFstatic_cast(double, x);
-                        ex = x_factor * (OFstatic_cast(double, x) + 1.0);
-                        if (ex > this->Src_X)
-                        {
-#ifdef DEBUG                // this output is only useful for debugging purposes
-                            DCMIMGLE_TRACE("  limiting value of 'ex' to 'Src_X': " << ex << " -> " << this->Src_X);
-#endif
-                            // see above comment
-                            ex = this->Src_X;
-                        }
-                        bxi = OFstatic_cast(int, bx);
-                        exi = OFstatic_cast(int, ex);
-                        if (OFstatic_cast(double, exi) == ex)
-                        {
-#ifdef DEBUG                // this output is only useful for debugging purposes
-                            DCMIMGLE_TRACE("  decreasing value of 'exi' by 1: " << exi << " -> " << (exi - 1));
-#endif
-                            --exi;
-                        }
-                        l_factor = 1 + OFstatic_cast(double, bxi) - bx;
-                        r_factor = ex - OFstatic_cast(double, exi);
-                        offset = OFstatic_cast(unsigned long, byi) * OFstatic_cast(unsigned long, Columns);
-                        for (yi = byi; yi <= eyi; ++yi)
-                        {
-                            p = sp + offset + bxi;
-                            for (xi = bxi; xi <= exi; ++xi)
-                            {
-                                sum = OFstatic_cast(double, *(p++)) / xy_factor;
-                                if (xi == bxi)
-                                    sum *= l_factor;
-                                else if (xi == exi)
-                                    sum *= r_factor;
-                                if (yi == byi)
-                                    sum *= b_factor;
-                                else if (yi == eyi)
-                                    sum *= t_factor;
-                                value += sum;
-                            }
-                            offset += Columns;
-                        }
-                        *(q++) = OFstatic_cast(T, value + 0.5);
-                    }
-                }
+                // the sums of up to 32768 pixels with 16 bits fit into a 32 bit integer
+                if ((sizeof(T) <= 2) && (maxBlock <= 32768))
+                    DiScaleBoxLoop<T, Sint32>(sp, Columns, q, this->Src_X, this->Dest_X, this->Dest_Y, &xBorders[0], &yBorders[0]).run();
+                else
+                    DiScaleBoxLoop<T, double>(sp, Columns, q, this->Src_X, this->Dest_X, this->Dest_Y, &xBorders[0], &yBorders[0]).run();
                 sp += f_size;
+                q += d_size;
             }
         }
     }
 
+
    /** bilinear interpolation method (only for magnification)
     *
     ** @param  src   array of pointers to source image pixels
@@ -932,121 +1020,18 @@ class DiScaleTemplate
                        T *dest[])
     {
         DCMIMGLE_DEBUG("using magnification algorithm with bilinear interpolation contributed by Eduard Stanescu");
-        const double x_factor = OFstatic_cast(double, this->Src_X) / OFstatic_cast(double, this->Dest_X);
-        const double y_factor = OFstatic_cast(double, this->Src_Y) / OFstatic_cast(double, this->Dest_Y);
-        const unsigned long f_size = OFstatic_cast(unsigned long, Rows) * OFstatic_cast(unsigned long, Columns);
-        const unsigned long l_offset = OFstatic_cast(unsigned long, this->Src_Y - 1) * OFstatic_cast(unsigned long, this->Dest_X);
-        register Uint16 x;
-        register Uint16 y;
-        register T *pD;
-        register T *pCurrTemp;
-        register const T *pCurrSrc;
-        Uint16 nSrcIndex;
-        double dOff;
-        T *pT;
-        const T *pS;
-        const T *pF;
-
-        // buffer used for storing temporarily the interpolated lines
-        T *pTemp = new T[OFstatic_cast(unsigned long, this->Src_Y) * OFstatic_cast(unsigned long, this->Dest_X)];
-        if (pTemp == NULL)
-        {
-            DCMIMGLE_ERROR("can't allocate temporary buffer for interpolation scaling");
-            this->clearPixel(dest);
-        } else {
 
-            /*
-             *   based on scaling algorithm contributed by Eduard Stanescu
-             *   (adapted to be used with signed pixel representation, inverse images - mono1,
-             *    various bit depths, multi-frame multi-plane/color images, combined clipping/scaling)
-             */
+        /*
+         *   based on scaling algorithm contributed by Eduard Stanescu
+         *   (adapted to be used with signed pixel representation, inverse images - mono1,
+         *    various bit depths, multi-frame multi-plane/color images, combined clipping/scaling)
+         */
 
-            for (int j = 0; j < this->Planes; ++j)
-            {
-                pF = src[j] + OFstatic_cast(unsigned long, Top) * OFstatic_cast(unsigned long, Columns) + Left;
-                pD = dest[j];
-                for (unsigned long f = this->Frames; f != 0; --f)
-                {
-                    pT = pCurrTemp = pTemp;
-                    pS = pCurrSrc = pF;
-                    // first, interpolate the columns:
-                    // column 0, just copy the source data column 0
-                    for (y = this->Src_Y; y != 0; --y)
-                    {
-                        *(pCurrTemp) = *(pCurrSrc);
-                        pCurrSrc += Columns;
-                        pCurrTemp += this->Dest_X;
-                    }
-                    pCurrSrc = pS;
-                    nSrcIndex = 0;
-                    // column 1 to column Dest_X - 1
-                    for (x = 1; x < this->Dest_X - 1; ++x)
-                    {
-                        pCurrTemp = ++pT;
-                        dOff = x * x_factor - nSrcIndex;
-                        dOff = (1.0 < dOff) ? 1.0 : dOff;
-                        for (y = 0; y < this->Src_Y; ++y)
-                        {
-                            // use floating points in order to avoid possible integer overflow
-                            const double v1 = OFstatic_cast(double, *(pCurrSrc));
-                            const double v2 = OFstatic_cast(double, *(pCurrSrc + 1));
-                            *(pCurrTemp) = OFstatic_cast(T, v1 + (v2 - v1) * dOff);
-                            pCurrSrc += Columns;
-                            pCurrTemp += this->Dest_X;
-                        }
-                        // don't go beyond the source data
-                        if ((nSrcIndex < this->Src_X - 2) &&  (x * x_factor >= nSrcIndex + 1))
-                        {
-                            pS++;
-                            nSrcIndex++;
-                        }
-                        pCurrSrc = pS;
-                    }
-                    pCurrTemp = ++pT;
-                    // last column, just copy the source data column Src_X
-                    for (y = this->Src_Y; y != 0; --y)
-                    {
-                        *(pCurrTemp) = *(pCurrSrc);
-                        pCurrSrc += Columns;
-                        pCurrTemp += this->Dest_X;
-                    }
-                    // now the columns are interpolated in temp buffer, so interpolate the lines
-                    pT = pCurrTemp = pTemp;
-                    // line 0, just copy the temp buffer line 0
-                    for (x = this->Dest_X; x != 0; --x)
-                       *(pD++) = *(pCurrTemp++);
-                    nSrcIndex = 0;
-                    pCurrTemp = pTemp;
-                    for (y = 1; y < this->Dest_Y - 1; ++y)
-                    {
-                        dOff = y * y_factor - nSrcIndex;
-                        dOff = (1.0 < dOff) ? 1.0 : dOff;
-                        for (x = this->Dest_X; x != 0; --x)
-                        {
-                            // use floating points in order to avoid possible integer overflow
-                            const double v1 = OFstatic_cast(double, *(pCurrTemp));
-                            const double v2 = OFstatic_cast(double, *(pCurrTemp + this->Dest_X));
-                            *(pD++) = OFstatic_cast(T, v1 + (v2 - v1) * dOff);
-                            pCurrTemp++;
-                        }
-                        // don't go beyond the source data
-                        if ((nSrcIndex < this->Src_Y - 2) && (y * y_factor >= nSrcIndex + 1))
-                        {
-                            pT += this->Dest_X;
-                            nSrcIndex++;
-                        }
-                        pCurrTemp = pT;
-                    }
-                    // the last line, just copy the temp buffer line Src_X
-                    pCurrTemp = pTemp + l_offset;
-                    for (x = this->Dest_X; x != 0; --x)
-                        *(pD++) = *(pCurrTemp++);
-                    // skip to next frame
-                    pF += f_size;
-                }
-            }
-        }
-        delete[] pTemp;
+        DiScaleFilter xFilter(this->Src_X, this->Dest_X);
+        DiScaleFilter yFilter(this->Src_Y, this->Dest_Y);
+        xFilter.setupBilinear();
+        yFilter.setupBilinear();
+        resamplePixel(src, dest, xFilter, yFilter, OFFalse /*round*/);
     }
 
    /** bicubic interpolation method (only for magnification)
@@ -1060,179 +1045,61 @@ class DiScaleTemplate
         DCMIMGLE_DEBUG("using magnification algorithm with bicubic interpolation contributed by Eduard Stanescu");
         const double minVal = (isSigned()) ? -OFstatic_cast(double, DicomImageClass::maxval(this->Bits - 1, 0)) : 0.0;
         const double maxVal = OFstatic_cast(double, DicomImageClass::maxval(this->Bits - isSigned()));
-        const double x_factor = OFstatic_cast(double, this->Src_X) / OFstatic_cast(double, this->Dest_X);
-        const double y_factor = OFstatic_cast(double, this->Src_Y) / OFstatic_cast(double, this->Dest_Y);
-        const Uint16 xDelta = OFstatic_cast(Uint16, 1 / x_factor);
-        const Uint16 yDelta = OFstatic_cast(Uint16, 1 / y_factor);
-        const unsigned long f_size = OFstatic_cast(unsigned long, Rows) * OFstatic_cast(unsigned long, Columns);
-        const unsigned long l_offset = OFstatic_cast(unsigned long, this->Src_Y - 1) * OFstatic_cast(unsigned long, this->Dest_X);
-        register Uint16 x;
-        register Uint16 y;
-        register T *pD;
-        register T *pCurrTemp;
-        register const T *pCurrSrc;
-        Uint16 nSrcIndex;
-        double dOff;
-        T *pT;
-        const T *pS;
-        const T *pF;
-
-        // buffer used for storing temporarily the interpolated lines
-        T *pTemp = pT = pCurrTemp = new T[OFstatic_cast(unsigned long, this->Src_Y) * OFstatic_cast(unsigned long, this->Dest_X)];
-        if (pTemp == NULL)
-        {
-            DCMIMGLE_ERROR("can't allocate temporary buffer for interpolation scaling");
-            this->clearPixel(dest);
-        } else {
 
-            /*
-             *   based on scaling algorithm contributed by Eduard Stanescu
-             *   (adapted to be used with signed pixel representation, inverse images - mono1,
-             *    various bit depths, multi-frame multi-plane/color images, combined clipping/scaling)
-             */
+        /*
+         *   based on scaling algorithm contributed by Eduard Stanescu
+         *   (adapted to be used with signed pixel representation, inverse images - mono1,
+         *    various bit depths, multi-frame multi-plane/color images, combined clipping/scaling)
+         */
+
+        DiScaleFilter xFilter(this->Src_X, this->Dest_X);
+        DiScaleFilter yFilter(this->Src_Y, this->Dest_Y);
+        xFilter.setupBicubic(OFFalse /*lines*/);
+        yFilter.setupBicubic(OFTrue /*lines*/);
+        resamplePixel(src, dest, xFilter, yFilter, OFFalse /*round*/, OFTrue /*clip*/, minVal, maxVal);
+    }
 
-            for (int j = 0; j < this->Planes; ++j)
+    /** scale the image with a separable algorithm, i.e. compute each row of the destination
+     *  image from a weighted sum of source rows followed by a weighted sum of the resulting
+     *  pixels. The rows of each frame are processed in parallel (see DiParallelLoop).
+     *
+     ** @param  src       array of pointers to source image pixels
+     *  @param  dest      array of pointers to destination image pixels
+     *  @param  xFilter   filter for the horizontal axis (columns)
+     *  @param  yFilter   filter for the vertical axis (rows)
+     *  @param  round     round the resulting values if true, truncate them otherwise
+     *  @param  clip      limit the resulting values to the range [minValue, maxValue] if true
+     *  @param  minValue  minimum resulting value (only used if 'clip' is true)
+     *  @param  maxValue  maximum resulting value (only used if 'clip' is true)
+     */
+    void resamplePixel(const T *src[],
+                       T *dest[],
+                       const DiScaleFilter &xFilter,
+                       const DiScaleFilter &yFilter,
+                       const OFBool round,
+                       const OFBool clip = OFFalse,
+                       const double minValue = 0,
+                       const double maxValue = 0)
+    {
+        const unsigned long f_size = OFstatic_cast(unsigned long, Rows) * OFstatic_cast(unsigned long, Columns);
+        const unsigned long d_size = OFstatic_cast(unsigned long, this->Dest_X) * OFstatic_cast(unsigned long, this->Dest_Y);
+        const T *sp;
+        T *q;
+        for (int j = 0; j < this->Planes; ++j)
+        {
+            sp = src[j] + OFstatic_cast(unsigned long, Top) * OFstatic_cast(unsigned long, Columns) + Left;
+            q = dest[j];
+            for (unsigned long f = this->Frames; f != 0; --f)
             {
-                pF = src[j] + OFstatic_cast(unsigned long, Top) * OFstatic_cast(unsigned long, Columns) + Left;
-                pD = dest[j];
-                for (unsigned long f = this->Frames; f != 0; --f)
-                {
-                    pT = pCurrTemp = pTemp;
-                    pS = pCurrSrc = pF;
-                    // first, interpolate the columns:
-                    // column 0, just copy the source data column 0
-                    for (y = this->Src_Y; y != 0; --y)
-                    {
-                        *(pCurrTemp) = *(pCurrSrc);
-                        pCurrSrc += Columns;
-                        pCurrTemp += this->Dest_X;
-                    }
-                    pCurrSrc = pS;
-                    // for the next few columns, linear interpolation
-                    for (x = 1; x < xDelta + 1; ++x)
-                    {
-                        pCurrSrc = pS;
-                        pCurrTemp = ++pT;
-                        dOff = x * x_factor;
-                        dOff = (1.0 < dOff) ? 1.0 : dOff;
-                        for (y = this->Src_Y; y != 0; --y)
-                        {
-                            *(pCurrTemp) = OFstatic_cast(T, *(pCurrSrc) + (*(pCurrSrc + 1) - *(pCurrSrc)) * dOff);
-                            pCurrSrc += Columns;
-                            pCurrTemp += this->Dest_X;
-                        }
-                    }
-                    nSrcIndex = 1;
-                    pCurrSrc = ++pS;
-                    // the majority of the columns
-                    for (x = xDelta + 1; x < this->Dest_X - 2 * xDelta; ++x)
-                    {
-                        pCurrTemp = ++pT;
-                        dOff = x * x_factor - nSrcIndex;
-                        dOff = (1.0 < dOff) ? 1.0 : dOff;
-                        for (y = this->Src_Y; y != 0; --y)
-                        {
-                            *(pCurrTemp) = OFstatic_cast(T, cubicValue(*(pCurrSrc - 1), *(pCurrSrc), *(pCurrSrc + 1), *(pCurrSrc + 2), dOff, minVal, maxVal));
-                            pCurrSrc += Columns;
-                            pCurrTemp += this->Dest_X;
-                        }
-                        // don't go beyond the source data
-                        if ((nSrcIndex < this->Src_X - 3) && (x * x_factor >= nSrcIndex + 1))
-                        {
-                            pS++;
-                            nSrcIndex++;
-                        }
-                        pCurrSrc = pS;
-                    }
-                    // last few columns except the very last one, linear interpolation
-                    for (x = this->Dest_X - 2 * xDelta; x < this->Dest_X - 1; ++x)
-                    {
-                        pCurrTemp = ++pT;
-                        dOff = x * x_factor - nSrcIndex;
-                        dOff = (1.0 < dOff) ? 1.0 : dOff;
-                        for (y = this->Src_Y; y != 0; --y)
-                        {
-                            *(pCurrTemp) = OFstatic_cast(T, *(pCurrSrc) + (*(pCurrSrc + 1) - *(pCurrSrc)) * dOff);
-                            pCurrSrc += Columns;
-                            pCurrTemp += this->Dest_X;
-                        }
-                        // don't go beyond the source data
-                        if ((nSrcIndex < this->Src_X - 2) && (x * x_factor >= nSrcIndex + 1))
-                        {
-                            pS++;
-                            nSrcIndex++;
-                        }
-                        pCurrSrc = pS;
-                    }
-                    // last column, just copy the source data column Src_X
-                    pCurrTemp = pTemp + this->Dest_X - 1;
-                    pCurrSrc = pF + this->Src_X - 1;
-                    for (y = this->Src_Y; y != 0; --y)
-                    {
-                        *(pCurrTemp) = *(pCurrSrc);
-                        pCurrSrc += Columns;
-                        pCurrTemp += this->Dest_X;
-                    }
-                    // now the columns are interpolated in temp buffer, so interpolate the lines
-                    pT = pCurrTemp = pTemp;
-                    // line 0, just copy the temp buffer line 0
-                    for (x = this->Dest_X; x != 0; --x)
-                        *(pD++) = *(pCurrTemp++);
-                    // for the next few lines, linear interpolation between line 0 and 1 of the temp buffer
-                    for (y = 1; y < yDelta + 1; ++y)
-                    {
-                        pCurrTemp = pTemp;
-                        dOff = y * y_factor;
-                        dOff = (1.0 < dOff) ? 1.0 : dOff;
-                        for (x = this->Dest_X; x != 0; --x)
-                        {
-                            *(pD++) = OFstatic_cast(T, *(pCurrTemp) + (*(pCurrTemp + this->Dest_X) - *(pCurrTemp)) * dOff);
-                            pCurrTemp++;
-                        }
-                    }
-                    nSrcIndex = 1;
-                    pCurrTemp = pT = pTemp + this->Dest_X;
-                    for (y = yDelta + 1; y < this->Dest_Y - yDelta - 1; ++y)
-                    {
-                        dOff = y * y_factor - nSrcIndex;
-                        dOff = (1.0 < dOff) ? 1.0 : dOff;
-                        for (x = this->Dest_X; x != 0; --x)
-                        {
-                            *(pD++) = OFstatic_cast(T, cubicValue(*(pCurrTemp - this->Dest_X),*(pCurrTemp), *(pCurrTemp + this->Dest_X),
-                                                                  *(pCurrTemp + this->Dest_X + this->Dest_X), dOff, minVal, maxVal));
-                            pCurrTemp++;
-                        }
-                        // don't go beyond the source data
-                        if ((nSrcIndex < this->Src_Y - 3) && (y * y_factor >= nSrcIndex + 1))
-                        {
-                            pT += this->Dest_X;
-                            nSrcIndex++;
-                        }
-                        pCurrTemp = pT;
-                    }
-                    // the last few lines except the very last one, linear interpolation in between the second last and the last lines
-                    pCurrTemp = pT = pTemp + OFstatic_cast(unsigned long, this->Src_Y - 2) * OFstatic_cast(unsigned long, this->Dest_X);
-                    for (y = this->Dest_Y - yDelta - 1; y < this->Dest_Y - 1; ++y)
-                    {
-                        dOff = y * y_factor - nSrcIndex;
-                        dOff = (1.0 < dOff) ? 1.0 : dOff;
-                        for (x = this->Dest_X; x != 0; --x)
-                        {
-                            *(pD++) = OFstatic_cast(T, *(pCurrTemp) + (*(pCurrTemp + this->Dest_X) - *(pCurrTemp)) * dOff);
-                            pCurrTemp++;
-                        }
-                        pCurrTemp = pT;
-                    }
-                    // the the last line, just copy the temp buffer line Src_X
-                    pCurrTemp = pTemp + l_offset;
-                    for (x = this->Dest_X; x != 0; --x)
-                        *(pD++) = *(pCurrTemp++);
-                    // skip to next frame
-                    pF += f_size;
-                }
+                // single precision is sufficient for up to 16 bits per pixel
+                if (sizeof(T) <= 2)
+                    DiScaleResampleLoop<T, float>(sp, Columns, q, this->Src_X, xFilter, yFilter, clip, minValue, maxValue, round).run();
+                else
+                    DiScaleResampleLoop<T, double>(sp, Columns, q, this->Src_X, xFilter, yFilter, clip, minValue, maxValue, round).run();
+                sp += f_size;
+                q += d_size;
             }
         }
-        delete[] pTemp;
     }
 };
 
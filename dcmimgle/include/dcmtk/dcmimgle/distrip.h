@@ -0,0 +1,173 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomStripRenderer (Header)
+ *
+ */
+
+
+#ifndef DISTRIP_H
+#define DISTRIP_H
+
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmimgle/didefine.h"
+
+#include "dcmtk/ofstd/oftypes.h"
+
+
+/*------------------------*
+ *  forward declarations  *
+ *------------------------*/
+
+class DiImage;
+class DiMonoOutputLUT;
+class OFSemaphore;
+
+
+/*---------------------*
+ *  class declaration  *
+ *---------------------*/
+
+/** Class to render a frame strip by strip, i.e. a few rows at a time.
+ *  This allows for passing the rendered pixel data to an encoder (e.g. JPEG or PNG)
+ *  without the need for a memory buffer that holds the complete frame. If more than
+ *  one rendering thread is allowed (see dcmRenderingMaxThreads) and the toolkit has
+ *  been compiled with thread support, the next strip is rendered by a separate thread
+ *  while the current strip is being processed by the caller. The optimization LUT of
+ *  the monochrome output transformation (if any) is created only once per frame and
+ *  shared by all strips. The image object must not be accessed by the caller as long
+ *  as this object exists.
+ */
+class DCMTK_DCMIMGLE_EXPORT DiStripRenderer
+{
+
+ public:
+
+    /// default number of pixels per strip (the number of rows is derived from this value)
+    static const unsigned long DefaultStripSize;
+
+    /** constructor
+     *
+     ** @param  image         pointer to image object to be rendered (not deleted)
+     *  @param  frame         number of frame to be rendered
+     *  @param  bits          number of bits per sample of the rendered pixel data
+     *  @param  rowsPerStrip  number of rows per strip (0 = use DefaultStripSize)
+     *  @param  planar        0 = color-by-pixel, 1 = color-by-plane (for each strip)
+     */
+    DiStripRenderer(DiImage *image,
+                    const unsigned long frame,
+                    const int bits,
+                    const unsigned long rowsPerStrip = 0,
+                    const int planar = 0);
+
+    /** destructor.
+     *  Waits for the rendering thread (if any) to terminate.
+     */
+    virtual ~DiStripRenderer();
+
+    /** get number of bytes per rendered row
+     *
+     ** @return number of bytes per row (0 if the image is invalid)
+     */
+    inline unsigned long getRowSize() const
+    {
+        return RowSize;
+    }
+
+    /** get number of rows per strip (the last strip might contain less rows)
+     *
+     ** @return number of rows per strip
+     */
+    inline unsigned long getRowsPerStrip() const
+    {
+        return RowsPerStrip;
+    }
+
+    /** get the next strip of rendered rows.
+     *  The returned memory buffer is valid until the next call of this method or
+     *  until this object is destroyed.
+     *
+     ** @param  firstRow  reference to storage area for the index of the first row of the strip
+     *  @param  rowCount  reference to storage area for the number of rows of the strip
+     *
+     ** @return pointer to the rendered rows, NULL if all rows have been retrieved or in
+     *          case of error (e.g. invalid image, rendering failed)
+     */
+    const void *getNextStrip(unsigned long &firstRow,
+                             unsigned long &rowCount);
+
+
+ private:
+
+    /// rendering thread (only used if the toolkit is compiled with thread support)
+    class Worker;
+
+    // Needed to keep MS VC6 happy
+    friend class Worker;
+
+    /** render the given strip to the given buffer
+     *
+     ** @param  strip   index of the strip
+     *  @param  buffer  index of the buffer (0 or 1)
+     *
+     ** @return true if successful, false otherwise
+     */
+    OFBool render(const unsigned long strip,
+                  const int buffer);
+
+    /** render all strips (called by the rendering thread).
+     *  Uses the semaphores to synchronize with getNextStrip().
+     */
+    void renderAll();
+
+    /// image object to be rendered
+    DiImage *Image;
+    /// number of frame to be rendered
+    const unsigned long Frame;
+    /// number of bits per sample
+    const int Bits;
+    /// color-by-plane if true
+    const int Planar;
+    /// number of rows of the frame
+    unsigned long Rows;
+    /// number of bytes per row
+    unsigned long RowSize;
+    /// number of rows per strip
+    unsigned long RowsPerStrip;
+    /// number of strips
+    unsigned long Strips;
+    /// index of the next strip returned by getNextStrip()
+    unsigned long NextStrip;
+
+    /// optimization LUT shared by all strips (created only once per frame)
+    DiMonoOutputLUT *OutputLUT;
+
+    /// memory buffers for the rendered strips (two if rendered by a separate thread)
+    Uint8 *Buffer[2];
+    /// status of the rendered strip in each buffer
+    OFBool Status[2];
+
+    /// rendering thread (NULL if not used)
+    Worker *Thread;
+    /// number of buffers that can be filled by the rendering thread
+    OFSemaphore *FreeBuffers;
+    /// number of buffers that have been filled by the rendering thread
+    OFSemaphore *FilledBuffers;
+    /// flag indicating that the rendering thread should stop
+    volatile OFBool Abort;
+
+ // --- declarations to avoid compiler warnings
+
+    DiStripRenderer(const DiStripRenderer &);
+    DiStripRenderer &operator=(const DiStripRenderer &);
+};
+
+
+#endif
@@ -91,6 +91,8 @@ const unsigned long CIF_UseAbsolutePixelRange        = 0x0000200;
 /// use partial access to pixel data, i.e. without decompressing or loading a complete multi-frame image.
 /// Please note that the use of this flag can cause another copy of the pixel data to be created in memory,
 /// e.g. in case the pixel data element value has already been loaded or decompressed completely in memory.
+/// This flag is set automatically for uncompressed pixel data that has not yet been loaded into memory
+/// if only some of the frames are to be processed, so that only these frames are read from file.
 const unsigned long CIF_UsePartialAccessToPixelData  = 0x0000400;
 
 /// always decompress complete pixel data when processing an image, i.e. even if partial access is used
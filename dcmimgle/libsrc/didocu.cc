@@ -139,6 +139,14 @@ void DiDocument::convertPixelData()
                             << "the transfer syntax of the dataset refers to encapsulated format");
                     }
                 }
+                // read only the requested frames of uncompressed pixel data that is still in file
+                if (((FrameStart > 0) || (FrameCount > 0)) && !PixelData->valueLoaded() &&
+                    PixelData->canWriteXfer(EXS_LittleEndianExplicit, EXS_Unknown))
+                {
+                    if (!(Flags & CIF_UsePartialAccessToPixelData))
+                        DCMIMGLE_DEBUG("enabling partial access to uncompressed pixel data not yet loaded into memory");
+                    Flags |= CIF_UsePartialAccessToPixelData;
+                }
                 // convert pixel data to uncompressed format (if required)
                 if ((Flags & CIF_DecompressCompletePixelData) || !(Flags & CIF_UsePartialAccessToPixelData))
                 {
@@ -106,6 +106,26 @@ int DiMono1Image::getOutputData(void *buffer,
 }
 
 
+int DiMono1Image::getOutputRows(void *buffer,
+                                const unsigned long size,
+                                const unsigned long frame,
+                                const int bits,
+                                const unsigned long firstRow,
+                                const unsigned long rowCount,
+                                const int planar,
+                                DiMonoOutputLUT *sharedLUT)
+{
+    int result = 0;
+    if ((rowCount > 0) && (firstRow + rowCount <= Rows))
+    {
+        result = (DiMonoImage::getData(buffer, size, frame, bits, planar, 1, firstRow, rowCount, sharedLUT) != NULL);
+        /* output data only refer to the given buffer */
+        deleteOutputData();
+    }
+    return result;
+}
+
+
 DiImage *DiMono1Image::createImage(const unsigned long fstart,
                                    const unsigned long fcount) const
 {
@@ -152,6 +152,26 @@ int DiMono2Image::getOutputData(void *buffer,
 }
 
 
+int DiMono2Image::getOutputRows(void *buffer,
+                                const unsigned long size,
+                                const unsigned long frame,
+                                const int bits,
+                                const unsigned long firstRow,
+                                const unsigned long rowCount,
+                                const int planar,
+                                DiMonoOutputLUT *sharedLUT)
+{
+    int result = 0;
+    if ((rowCount > 0) && (firstRow + rowCount <= Rows))
+    {
+        result = (DiMonoImage::getData(buffer, size, frame, bits, planar, 0, firstRow, rowCount, sharedLUT) != NULL);
+        /* output data only refer to the given buffer */
+        deleteOutputData();
+    }
+    return result;
+}
+
+
 DiImage *DiMono2Image::createImage(const unsigned long fstart,
                                    const unsigned long fcount) const
 {
@@ -1492,12 +1492,21 @@ const void *DiMonoImage::getData(void *buffer,
                                  const unsigned long frame,
                                  int bits,
                                  const int /*planar*/,            /* not yet supported, needed for pastel color images !! */
-                                 const int negative)
+                                 const int negative,
+                                 const unsigned long firstRow,
+                                 const unsigned long rowCount,
+                                 DiMonoOutputLUT *sharedLUT)
 {
-    if ((InterData != NULL) && (ImageStatus == EIS_Normal) && (frame < NumberOfFrames) &&
+    if ((InterData != NULL) && (ImageStatus == EIS_Normal) && (frame < NumberOfFrames) && (firstRow < Rows) &&
         (((bits > 0) && (bits <= MAX_BITS)) || (bits == MI_PastelColor)))
     {
-        if ((buffer == NULL) || (size >= getOutputDataSize(bits)))
+        /* number of bytes required for the given rows */
+        unsigned long required = getOutputDataSize(bits);
+        if ((rowCount > 0) && (firstRow + rowCount < Rows))
+            required = required / Rows * rowCount;
+        else if (firstRow > 0)
+            required = required / Rows * (Rows - firstRow);
+        if ((buffer == NULL) || (size >= required))
         {
             deleteOutputData();                             // delete old image data
             if (!ValidWindow)
@@ -1537,22 +1546,22 @@ const void *DiMonoImage::getData(void *buffer,
             switch (InterData->getRepresentation())
             {
                 case EPR_Uint8:
-                    getDataUint8(buffer, disp, samples, frame, bits, low, high);
+                    getDataUint8(buffer, disp, samples, frame, bits, low, high, firstRow, rowCount, sharedLUT);
                     break;
                 case EPR_Sint8:
-                    getDataSint8(buffer, disp, samples, frame, bits, low, high);
+                    getDataSint8(buffer, disp, samples, frame, bits, low, high, firstRow, rowCount, sharedLUT);
                     break;
                 case EPR_Uint16:
-                    getDataUint16(buffer, disp, samples, frame, bits, low, high);
+                    getDataUint16(buffer, disp, samples, frame, bits, low, high, firstRow, rowCount, sharedLUT);
                     break;
                 case EPR_Sint16:
-                    getDataSint16(buffer, disp, samples, frame, bits, low, high);
+                    getDataSint16(buffer, disp, samples, frame, bits, low, high, firstRow, rowCount, sharedLUT);
                     break;
                 case EPR_Uint32:
-                    getDataUint32(buffer, disp, samples, frame, bits, low, high);
+                    getDataUint32(buffer, disp, samples, frame, bits, low, high, firstRow, rowCount, sharedLUT);
                     break;
                 case EPR_Sint32:
-                    getDataSint32(buffer, disp, samples, frame, bits, low, high);
+                    getDataSint32(buffer, disp, samples, frame, bits, low, high, firstRow, rowCount, sharedLUT);
                     break;
             }
             if (OutputData == NULL)
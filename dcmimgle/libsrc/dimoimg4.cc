@@ -34,7 +34,10 @@ void DiMonoImage::getDataUint16(void *buffer,
                                 const unsigned long frame,
                                 const int bits,
                                 const Uint32 low,
-                                const Uint32 high)
+                                const Uint32 high,
+                                const unsigned long firstRow,
+                                const unsigned long rowCount,
+                                DiMonoOutputLUT *sharedLUT)
 {
     if (InterData != NULL)
     {
@@ -42,23 +45,23 @@ void DiMonoImage::getDataUint16(void *buffer,
         {
             if (bits <= 8)
                 OutputData = new DiMonoOutputPixelTemplate<Uint16, Sint32, Uint8>(buffer, InterData, Overlays, VoiLutData, PresLutData,
-                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, samples > 1);
+                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, samples > 1, firstRow, rowCount, sharedLUT);
             else if (bits <= 16)
                 OutputData = new DiMonoOutputPixelTemplate<Uint16, Sint32, Uint16>(buffer, InterData, Overlays, VoiLutData, PresLutData,
-                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames);
+                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, 0, firstRow, rowCount, sharedLUT);
             else
                 OutputData = new DiMonoOutputPixelTemplate<Uint16, Sint32, Uint32>(buffer, InterData, Overlays, VoiLutData, PresLutData,
-                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames);
+                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, 0, firstRow, rowCount, sharedLUT);
         } else {
             if (bits <= 8)
                 OutputData = new DiMonoOutputPixelTemplate<Uint16, Uint32, Uint8>(buffer, InterData, Overlays, VoiLutData, PresLutData,
-                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, samples > 1);
+                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, samples > 1, firstRow, rowCount, sharedLUT);
             else if (bits <= 16)
                 OutputData = new DiMonoOutputPixelTemplate<Uint16, Uint32, Uint16>(buffer, InterData, Overlays, VoiLutData, PresLutData,
-                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames);
+                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, 0, firstRow, rowCount, sharedLUT);
             else
                 OutputData = new DiMonoOutputPixelTemplate<Uint16, Uint32, Uint32>(buffer, InterData, Overlays, VoiLutData, PresLutData,
-                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames);
+                    disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, 0, firstRow, rowCount, sharedLUT);
         }
     }
 }
@@ -70,15 +73,18 @@ void DiMonoImage::getDataSint16(void *buffer,
                                 const unsigned long frame,
                                 const int bits,
                                 const Uint32 low,
-                                const Uint32 high)
+                                const Uint32 high,
+                                const unsigned long firstRow,
+                                const unsigned long rowCount,
+                                DiMonoOutputLUT *sharedLUT)
 {
     if (bits <= 8)
         OutputData = new DiMonoOutputPixelTemplate<Sint16, Sint32, Uint8>(buffer, InterData, Overlays, VoiLutData, PresLutData,
-            disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, samples > 1);
+            disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, samples > 1, firstRow, rowCount, sharedLUT);
     else if (bits <= 16)
         OutputData = new DiMonoOutputPixelTemplate<Sint16, Sint32, Uint16>(buffer, InterData, Overlays, VoiLutData, PresLutData,
-            disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames);
+            disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, 0, firstRow, rowCount, sharedLUT);
     else
         OutputData = new DiMonoOutputPixelTemplate<Sint16, Sint32, Uint32>(buffer, InterData, Overlays, VoiLutData, PresLutData,
-            disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames);
+            disp, VoiLutFunction, WindowCenter, WindowWidth, low, high, Columns, Rows, frame, NumberOfFrames, 0, firstRow, rowCount, sharedLUT);
 }
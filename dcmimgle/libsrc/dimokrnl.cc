@@ -0,0 +1,515 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomMonoKernels (Source)
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/dcmimgle/dimokrnl.h"
+#include "dcmtk/ofstd/ofglobal.h"
+
+/* the vectorized kernels are compiled for the respective instruction set by means of
+ * function attributes, so the rest of the library does not depend on the CPU features
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define DIMOKRNL_X86
+#define DIMOKRNL_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#endif
+
+
+/*-------------------*
+ *  local variables  *
+ *-------------------*/
+
+/* determine the best instruction set supported by the CPU */
+static DiMonoKernels::E_InstructionSet determineSupportedInstructionSet()
+{
+    DiMonoKernels::E_InstructionSet supported = DiMonoKernels::IS_Scalar;
+#ifdef DIMOKRNL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        supported = DiMonoKernels::IS_AVX2;
+    else if (__builtin_cpu_supports("sse4.1"))
+        supported = DiMonoKernels::IS_SSE41;
+#endif
+    return supported;
+}
+
+/// best instruction set supported by the CPU, determined once when the library is loaded
+static const DiMonoKernels::E_InstructionSet SupportedInstructionSet = determineSupportedInstructionSet();
+
+/// best instruction set to be used (see setMaxInstructionSet), protected by a mutex
+static OFGlobal<DiMonoKernels::E_InstructionSet> MaxInstructionSet(DiMonoKernels::IS_AVX2);
+
+
+/*--------------------*
+ *  static functions  *
+ *--------------------*/
+
+#ifdef DIMOKRNL_X86
+
+/* AVX2: apply LUT to 16 pixels per iteration using gather instructions, which read 32 bits
+ * at the address of each entry, so only the lower 8 or 16 bits of each result are valid
+ */
+template<bool SignedInput, class T3>
+DIMOKRNL_TARGET("avx2")
+static unsigned long applyLUT_AVX2(const void *src,
+                                   T3 *dst,
+                                   const unsigned long count,
+                                   const T3 *lut0)
+{
+    const __m256i *p = OFstatic_cast(const __m256i *, src);
+    const int *base = OFreinterpret_cast(const int *, lut0);
+    const __m256i mask = _mm256_set1_epi32((sizeof(T3) == 1) ? 0xff : 0xffff);
+    unsigned long i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m256i v = _mm256_loadu_si256(p++);
+        const __m128i v0 = _mm256_castsi256_si128(v);
+        const __m128i v1 = _mm256_extracti128_si256(v, 1);
+        const __m256i i0 = SignedInput ? _mm256_cvtepi16_epi32(v0) : _mm256_cvtepu16_epi32(v0);
+        const __m256i i1 = SignedInput ? _mm256_cvtepi16_epi32(v1) : _mm256_cvtepu16_epi32(v1);
+        __m256i r0, r1;
+        if (sizeof(T3) == 1)
+        {
+            r0 = _mm256_i32gather_epi32(base, i0, 1);
+            r1 = _mm256_i32gather_epi32(base, i1, 1);
+        } else {
+            r0 = _mm256_i32gather_epi32(base, i0, 2);
+            r1 = _mm256_i32gather_epi32(base, i1, 2);
+        }
+        /* pack 16 x 32 bit to 16 x 16 bit, restoring the order of the 128 bit lanes */
+        const __m256i w = _mm256_permute4x64_epi64(_mm256_packus_epi32(_mm256_and_si256(r0, mask),
+            _mm256_and_si256(r1, mask)), 0xd8);
+        if (sizeof(T3) == 1)
+        {
+            _mm_storeu_si128(OFreinterpret_cast(__m128i *, dst + i),
+                _mm_packus_epi16(_mm256_castsi256_si128(w), _mm256_extracti128_si256(w, 1)));
+        } else
+            _mm256_storeu_si256(OFreinterpret_cast(__m256i *, dst + i), w);
+    }
+    return i;
+}
+
+
+/* AVX2: apply linear window to 4 pixels (converted to double)
+ */
+DIMOKRNL_TARGET("avx2")
+static inline __m128i window4_AVX2(const __m256d value,
+                                   const __m256d leftBorder,
+                                   const __m256d rightBorder,
+                                   const __m256d offset,
+                                   const __m256d gradient,
+                                   const __m256d low,
+                                   const __m256d high)
+{
+    /* same order of operations as in the generic version, the left border takes precedence */
+    __m256d result = _mm256_add_pd(offset, _mm256_mul_pd(value, gradient));
+    result = _mm256_blendv_pd(result, high, _mm256_cmp_pd(value, rightBorder, _CMP_GT_OQ));
+    result = _mm256_blendv_pd(result, low, _mm256_cmp_pd(value, leftBorder, _CMP_LE_OQ));
+    return _mm256_cvttpd_epi32(result);
+}
+
+
+/* AVX2: apply linear window to 8 pixels per iteration
+ */
+template<bool SignedInput, class T3>
+DIMOKRNL_TARGET("avx2")
+static unsigned long applyWindow_AVX2(const void *src,
+                                      T3 *dst,
+                                      const unsigned long count,
+                                      const double leftBorder,
+                                      const double rightBorder,
+                                      const double offset,
+                                      const double gradient,
+                                      const T3 low,
+                                      const T3 high)
+{
+    const __m128i *p = OFstatic_cast(const __m128i *, src);
+    const __m256d l = _mm256_set1_pd(leftBorder);
+    const __m256d r = _mm256_set1_pd(rightBorder);
+    const __m256d o = _mm256_set1_pd(offset);
+    const __m256d g = _mm256_set1_pd(gradient);
+    const __m256d lo = _mm256_set1_pd(OFstatic_cast(double, low));
+    const __m256d hi = _mm256_set1_pd(OFstatic_cast(double, high));
+    unsigned long i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128(p++);
+        const __m256i w = SignedInput ? _mm256_cvtepi16_epi32(v) : _mm256_cvtepu16_epi32(v);
+        const __m128i r0 = window4_AVX2(_mm256_cvtepi32_pd(_mm256_castsi256_si128(w)), l, r, o, g, lo, hi);
+        const __m128i r1 = window4_AVX2(_mm256_cvtepi32_pd(_mm256_extracti128_si256(w, 1)), l, r, o, g, lo, hi);
+        const __m128i result = _mm_packus_epi32(r0, r1);
+        if (sizeof(T3) == 1)
+            _mm_storel_epi64(OFreinterpret_cast(__m128i *, dst + i), _mm_packus_epi16(result, result));
+        else
+            _mm_storeu_si128(OFreinterpret_cast(__m128i *, dst + i), result);
+    }
+    return i;
+}
+
+
+/* SSE4.1: apply linear window to 2 pixels (converted to double)
+ */
+DIMOKRNL_TARGET("sse4.1")
+static inline __m128i window2_SSE41(const __m128d value,
+                                    const __m128d leftBorder,
+                                    const __m128d rightBorder,
+                                    const __m128d offset,
+                                    const __m128d gradient,
+                                    const __m128d low,
+                                    const __m128d high)
+{
+    __m128d result = _mm_add_pd(offset, _mm_mul_pd(value, gradient));
+    result = _mm_blendv_pd(result, high, _mm_cmpgt_pd(value, rightBorder));
+    result = _mm_blendv_pd(result, low, _mm_cmple_pd(value, leftBorder));
+    return _mm_cvttpd_epi32(result);
+}
+
+
+/* SSE4.1: apply linear window to 8 pixels per iteration
+ */
+template<bool SignedInput, class T3>
+DIMOKRNL_TARGET("sse4.1")
+static unsigned long applyWindow_SSE41(const void *src,
+                                       T3 *dst,
+                                       const unsigned long count,
+                                       const double leftBorder,
+                                       const double rightBorder,
+                                       const double offset,
+                                       const double gradient,
+                                       const T3 low,
+                                       const T3 high)
+{
+    const __m128i *p = OFstatic_cast(const __m128i *, src);
+    const __m128d l = _mm_set1_pd(leftBorder);
+    const __m128d r = _mm_set1_pd(rightBorder);
+    const __m128d o = _mm_set1_pd(offset);
+    const __m128d g = _mm_set1_pd(gradient);
+    const __m128d lo = _mm_set1_pd(OFstatic_cast(double, low));
+    const __m128d hi = _mm_set1_pd(OFstatic_cast(double, high));
+    unsigned long i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128(p++);
+        const __m128i w0 = SignedInput ? _mm_cvtepi16_epi32(v) : _mm_cvtepu16_epi32(v);
+        const __m128i w1 = SignedInput ? _mm_cvtepi16_epi32(_mm_srli_si128(v, 8)) : _mm_cvtepu16_epi32(_mm_srli_si128(v, 8));
+        const __m128i r0 = window2_SSE41(_mm_cvtepi32_pd(w0), l, r, o, g, lo, hi);
+        const __m128i r1 = window2_SSE41(_mm_cvtepi32_pd(_mm_srli_si128(w0, 8)), l, r, o, g, lo, hi);
+        const __m128i r2 = window2_SSE41(_mm_cvtepi32_pd(w1), l, r, o, g, lo, hi);
+        const __m128i r3 = window2_SSE41(_mm_cvtepi32_pd(_mm_srli_si128(w1, 8)), l, r, o, g, lo, hi);
+        const __m128i result = _mm_packus_epi32(_mm_unpacklo_epi64(r0, r1), _mm_unpacklo_epi64(r2, r3));
+        if (sizeof(T3) == 1)
+            _mm_storel_epi64(OFreinterpret_cast(__m128i *, dst + i), _mm_packus_epi16(result, result));
+        else
+            _mm_storeu_si128(OFreinterpret_cast(__m128i *, dst + i), result);
+    }
+    return i;
+}
+
+
+/* SSE4.1: determine the minimum and maximum of 8 unsigned 16 bit values
+ * (the 'phminposuw' instruction only determines the minimum)
+ */
+DIMOKRNL_TARGET("sse4.1")
+static inline void reduceMinMax_SSE41(const __m128i vmin,
+                                      const __m128i vmax,
+                                      Uint16 &minvalue,
+                                      Uint16 &maxvalue)
+{
+    const __m128i ones = _mm_set1_epi32(-1);
+    minvalue = OFstatic_cast(Uint16, _mm_cvtsi128_si32(_mm_minpos_epu16(vmin)));
+    maxvalue = OFstatic_cast(Uint16, ~_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(vmax, ones))));
+}
+
+
+/* SSE4.1: merge the 16 byte values of the minimum and maximum to 16 bit values
+ */
+DIMOKRNL_TARGET("sse4.1")
+static inline void reduceMinMax8_SSE41(__m128i vmin,
+                                       __m128i vmax,
+                                       Uint16 &minvalue,
+                                       Uint16 &maxvalue)
+{
+    const __m128i mask = _mm_set1_epi16(0xff);
+    vmin = _mm_and_si128(_mm_min_epu8(vmin, _mm_srli_epi16(vmin, 8)), mask);
+    vmax = _mm_and_si128(_mm_max_epu8(vmax, _mm_srli_epi16(vmax, 8)), mask);
+    reduceMinMax_SSE41(vmin, vmax, minvalue, maxvalue);
+}
+
+
+/* SSE4.1: determine minimum and maximum of 16 byte per iteration, signed values are
+ * mapped to unsigned values by flipping the sign bit ('bias'), the results are
+ * returned in this representation
+ */
+template<int Size>
+DIMOKRNL_TARGET("sse4.1")
+static unsigned long determineMinMax_SSE41(const void *src,
+                                           const unsigned long count,
+                                           const OFBool signedInput,
+                                           Uint16 &minvalue,
+                                           Uint16 &maxvalue)
+{
+    const unsigned long step = 16 / Size;
+    if (count < step)
+        return 0;
+    const __m128i *p = OFstatic_cast(const __m128i *, src);
+    const __m128i bias = signedInput ? ((Size == 1) ? _mm_set1_epi8(OFstatic_cast(char, 0x80)) : _mm_set1_epi16(OFstatic_cast(short, 0x8000)))
+                                     : _mm_setzero_si128();
+    __m128i vmin = _mm_xor_si128(_mm_loadu_si128(p++), bias);
+    __m128i vmax = vmin;
+    unsigned long i = step;
+    for (; i + step <= count; i += step)
+    {
+        const __m128i v = _mm_xor_si128(_mm_loadu_si128(p++), bias);
+        vmin = (Size == 1) ? _mm_min_epu8(vmin, v) : _mm_min_epu16(vmin, v);
+        vmax = (Size == 1) ? _mm_max_epu8(vmax, v) : _mm_max_epu16(vmax, v);
+    }
+    if (Size == 1)
+        reduceMinMax8_SSE41(vmin, vmax, minvalue, maxvalue);
+    else
+        reduceMinMax_SSE41(vmin, vmax, minvalue, maxvalue);
+    return i;
+}
+
+
+/* AVX2: determine minimum and maximum of 32 byte per iteration (see SSE4.1 version)
+ */
+template<int Size>
+DIMOKRNL_TARGET("avx2")
+static unsigned long determineMinMax_AVX2(const void *src,
+                                          const unsigned long count,
+                                          const OFBool signedInput,
+                                          Uint16 &minvalue,
+                                          Uint16 &maxvalue)
+{
+    const unsigned long step = 32 / Size;
+    if (count < step)
+        return 0;
+    const __m256i *p = OFstatic_cast(const __m256i *, src);
+    const __m256i bias = signedInput ? ((Size == 1) ? _mm256_set1_epi8(OFstatic_cast(char, 0x80)) : _mm256_set1_epi16(OFstatic_cast(short, 0x8000)))
+                                     : _mm256_setzero_si256();
+    __m256i vmin = _mm256_xor_si256(_mm256_loadu_si256(p++), bias);
+    __m256i vmax = vmin;
+    unsigned long i = step;
+    for (; i + step <= count; i += step)
+    {
+        const __m256i v = _mm256_xor_si256(_mm256_loadu_si256(p++), bias);
+        vmin = (Size == 1) ? _mm256_min_epu8(vmin, v) : _mm256_min_epu16(vmin, v);
+        vmax = (Size == 1) ? _mm256_max_epu8(vmax, v) : _mm256_max_epu16(vmax, v);
+    }
+    /* merge the two 128 bit lanes */
+    const __m128i min128 = _mm256_castsi256_si128(vmin);
+    const __m128i max128 = _mm256_castsi256_si128(vmax);
+    const __m128i minHigh = _mm256_extracti128_si256(vmin, 1);
+    const __m128i maxHigh = _mm256_extracti128_si256(vmax, 1);
+    if (Size == 1)
+        reduceMinMax8_SSE41(_mm_min_epu8(min128, minHigh), _mm_max_epu8(max128, maxHigh), minvalue, maxvalue);
+    else
+        reduceMinMax_SSE41(_mm_min_epu16(min128, minHigh), _mm_max_epu16(max128, maxHigh), minvalue, maxvalue);
+    return i;
+}
+
+#endif
+
+
+/* determine minimum and maximum using the best available kernel, the remaining pixels are processed by the generic version
+ */
+template<class T>
+static void determineMinMaxDispatch(const T *src,
+                                    const unsigned long count,
+                                    const OFBool signedInput,
+                                    T &minvalue,
+                                    T &maxvalue)
+{
+    unsigned long done = 0;
+#ifdef DIMOKRNL_X86
+    const DiMonoKernels::E_InstructionSet instructionSet = DiMonoKernels::getInstructionSet();
+    Uint16 minval = 0;
+    Uint16 maxval = 0;
+    if (instructionSet >= DiMonoKernels::IS_AVX2)
+        done = determineMinMax_AVX2<sizeof(T)>(src, count, signedInput, minval, maxval);
+    else if (instructionSet >= DiMonoKernels::IS_SSE41)
+        done = determineMinMax_SSE41<sizeof(T)>(src, count, signedInput, minval, maxval);
+    if (done > 0)
+    {
+        /* remove the bias from the results */
+        const Uint16 bias = signedInput ? OFstatic_cast(Uint16, 1 << (8 * sizeof(T) - 1)) : 0;
+        minvalue = OFstatic_cast(T, minval ^ bias);
+        maxvalue = OFstatic_cast(T, maxval ^ bias);
+        if (done < count)
+        {
+            T minrest = minvalue;
+            T maxrest = maxvalue;
+            DiMonoKernels::determineMinMax<T>(src + done, count - done, minrest, maxrest);
+            if (minrest < minvalue)
+                minvalue = minrest;
+            if (maxrest > maxvalue)
+                maxvalue = maxrest;
+        }
+        return;
+    }
+#endif
+    DiMonoKernels::determineMinMax<T>(src, count, minvalue, maxvalue);
+}
+
+
+/* apply LUT using the best available kernel, the remaining pixels are processed by the generic version
+ */
+template<bool SignedInput, class T1, class T3>
+static void applyLUTDispatch(const T1 *src,
+                             T3 *dst,
+                             const unsigned long count,
+                             const T3 *lut0)
+{
+    unsigned long done = 0;
+#ifdef DIMOKRNL_X86
+    if (DiMonoKernels::getInstructionSet() >= DiMonoKernels::IS_AVX2)
+        done = applyLUT_AVX2<SignedInput, T3>(src, dst, count, lut0);
+#endif
+    DiMonoKernels::applyLUT<T1, T3>(src + done, dst + done, count - done, lut0);
+}
+
+
+/* apply linear window using the best available kernel, the remaining pixels are processed by the generic version
+ */
+template<bool SignedInput, class T1, class T3>
+static void applyWindowDispatch(const T1 *src,
+                                T3 *dst,
+                                const unsigned long count,
+                                const double leftBorder,
+                                const double rightBorder,
+                                const double offset,
+                                const double gradient,
+                                const T3 low,
+                                const T3 high)
+{
+    unsigned long done = 0;
+#ifdef DIMOKRNL_X86
+    const DiMonoKernels::E_InstructionSet instructionSet = DiMonoKernels::getInstructionSet();
+    if (instructionSet >= DiMonoKernels::IS_AVX2)
+        done = applyWindow_AVX2<SignedInput, T3>(src, dst, count, leftBorder, rightBorder, offset, gradient, low, high);
+    else if (instructionSet >= DiMonoKernels::IS_SSE41)
+        done = applyWindow_SSE41<SignedInput, T3>(src, dst, count, leftBorder, rightBorder, offset, gradient, low, high);
+#endif
+    DiMonoKernels::applyWindow<T1, T3>(src + done, dst + done, count - done, leftBorder, rightBorder, offset, gradient, low, high);
+}
+
+
+/*------------------*
+ *  implementation  *
+ *------------------*/
+
+DiMonoKernels::E_InstructionSet DiMonoKernels::getInstructionSet()
+{
+    const E_InstructionSet maxInstructionSet = MaxInstructionSet.get();
+    return (SupportedInstructionSet < maxInstructionSet) ? SupportedInstructionSet : maxInstructionSet;
+}
+
+
+void DiMonoKernels::setMaxInstructionSet(const E_InstructionSet instructionSet)
+{
+    MaxInstructionSet.set(instructionSet);
+}
+
+
+const char *DiMonoKernels::getInstructionSetName(const E_InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case IS_SSE41:
+            return "SSE4.1";
+        case IS_AVX2:
+            return "AVX2";
+        default:
+            return "scalar";
+    }
+}
+
+
+void DiMonoKernels::applyLUT(const Uint16 *src, Uint8 *dst, const unsigned long count, const Uint8 *lut0)
+{
+    applyLUTDispatch<OFFalse>(src, dst, count, lut0);
+}
+
+
+void DiMonoKernels::applyLUT(const Sint16 *src, Uint8 *dst, const unsigned long count, const Uint8 *lut0)
+{
+    applyLUTDispatch<OFTrue>(src, dst, count, lut0);
+}
+
+
+void DiMonoKernels::applyLUT(const Uint16 *src, Uint16 *dst, const unsigned long count, const Uint16 *lut0)
+{
+    applyLUTDispatch<OFFalse>(src, dst, count, lut0);
+}
+
+
+void DiMonoKernels::applyLUT(const Sint16 *src, Uint16 *dst, const unsigned long count, const Uint16 *lut0)
+{
+    applyLUTDispatch<OFTrue>(src, dst, count, lut0);
+}
+
+
+void DiMonoKernels::applyWindow(const Uint16 *src, Uint8 *dst, const unsigned long count, const double leftBorder,
+                                const double rightBorder, const double offset, const double gradient, const Uint8 low, const Uint8 high)
+{
+    applyWindowDispatch<OFFalse>(src, dst, count, leftBorder, rightBorder, offset, gradient, low, high);
+}
+
+
+void DiMonoKernels::applyWindow(const Sint16 *src, Uint8 *dst, const unsigned long count, const double leftBorder,
+                                const double rightBorder, const double offset, const double gradient, const Uint8 low, const Uint8 high)
+{
+    applyWindowDispatch<OFTrue>(src, dst, count, leftBorder, rightBorder, offset, gradient, low, high);
+}
+
+
+void DiMonoKernels::applyWindow(const Uint16 *src, Uint16 *dst, const unsigned long count, const double leftBorder,
+                                const double rightBorder, const double offset, const double gradient, const Uint16 low, const Uint16 high)
+{
+    applyWindowDispatch<OFFalse>(src, dst, count, leftBorder, rightBorder, offset, gradient, low, high);
+}
+
+
+void DiMonoKernels::applyWindow(const Sint16 *src, Uint16 *dst, const unsigned long count, const double leftBorder,
+                                const double rightBorder, const double offset, const double gradient, const Uint16 low, const Uint16 high)
+{
+    applyWindowDispatch<OFTrue>(src, dst, count, leftBorder, rightBorder, offset, gradient, low, high);
+}
+
+
+void DiMonoKernels::determineMinMax(const Uint8 *src, const unsigned long count, Uint8 &minvalue, Uint8 &maxvalue)
+{
+    determineMinMaxDispatch(src, count, OFFalse, minvalue, maxvalue);
+}
+
+
+void DiMonoKernels::determineMinMax(const Sint8 *src, const unsigned long count, Sint8 &minvalue, Sint8 &maxvalue)
+{
+    determineMinMaxDispatch(src, count, OFTrue, minvalue, maxvalue);
+}
+
+
+void DiMonoKernels::determineMinMax(const Uint16 *src, const unsigned long count, Uint16 &minvalue, Uint16 &maxvalue)
+{
+    determineMinMaxDispatch(src, count, OFFalse, minvalue, maxvalue);
+}
+
+
+void DiMonoKernels::determineMinMax(const Sint16 *src, const unsigned long count, Sint16 &minvalue, Sint16 &maxvalue)
+{
+    determineMinMaxDispatch(src, count, OFTrue, minvalue, maxvalue);
+}
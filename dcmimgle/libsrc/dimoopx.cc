@@ -33,7 +33,8 @@
 DiMonoOutputPixel::DiMonoOutputPixel(const DiMonoPixel *pixel,
                                      const unsigned long size,
                                      const unsigned long frame,
-                                     const unsigned long max)
+                                     const unsigned long max,
+                                     const unsigned long offset)
   : Count(0),
     FrameSize(size),
     UsedValues(NULL),
@@ -41,8 +42,8 @@ DiMonoOutputPixel::DiMonoOutputPixel(const DiMonoPixel *pixel,
 {
     if (pixel != NULL)
     {
-        if (pixel->getCount() > frame * size)
-            Count = pixel->getCount() - frame * size;       // number of pixels remaining for this 'frame'
+        if (pixel->getCount() > frame * size + offset)
+            Count = pixel->getCount() - frame * size - offset;  // number of pixels remaining for this 'frame'
     }
     if (Count > FrameSize)
         Count = FrameSize;                                  // cut off at frame 'size'
@@ -74,3 +75,44 @@ int DiMonoOutputPixel::isUnused(const unsigned long value)
     }
     return 0;
 }
+
+
+/*---------------------------*
+ *  shared optimization LUT  *
+ *---------------------------*/
+
+DiMonoOutputLUT::DiMonoOutputLUT(const unsigned long frameSize)
+  : FrameSize(frameSize),
+    Representation(EPR_Uint8),
+    Count(0),
+    Data(NULL)
+{
+}
+
+
+DiMonoOutputLUT::~DiMonoOutputLUT()
+{
+    delete[] Data;
+}
+
+
+void *DiMonoOutputLUT::getData(const EP_Representation representation,
+                               const unsigned long count) const
+{
+    if ((Data != NULL) && (representation == Representation) && (count == Count))
+        return Data;
+    return NULL;
+}
+
+
+void *DiMonoOutputLUT::createData(const EP_Representation representation,
+                                  const unsigned long count,
+                                  const size_t itemSize)
+{
+    delete[] Data;
+    /* use 32 bit words in order to be properly aligned for all LUT entry types */
+    Data = new Uint32[(count * itemSize + sizeof(Uint32) - 1) / sizeof(Uint32)];
+    Representation = representation;
+    Count = (Data != NULL) ? count : 0;
+    return Data;
+}
@@ -0,0 +1,88 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomParallelLoop (Source)
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/dcmimgle/diparal.h"
+
+#include "dcmtk/dcmdata/dcerror.h"
+
+
+/*------------------------*
+ *  global configuration  *
+ *------------------------*/
+
+OFGlobal<Uint32> dcmRenderingMaxThreads(1);
+
+
+/*----------------*
+ *  constructors  *
+ *----------------*/
+
+const unsigned long DiParallelLoop::MinimumBlockSize = 65536;
+
+
+DiParallelLoop::DiParallelLoop(const unsigned long count,
+                               const Uint32 numberOfThreads,
+                               const unsigned long minimumBlockSize)
+  : DcmFrameProcessor(),
+    Count(count),
+    Blocks(1)
+{
+#ifdef WITH_THREADS
+    if (numberOfThreads > 1)
+    {
+        Blocks = (minimumBlockSize > 0) ? Count / minimumBlockSize : Count;
+        if (Blocks > numberOfThreads)
+            Blocks = numberOfThreads;
+        else if (Blocks == 0)
+            Blocks = 1;
+    }
+#else
+    (void) numberOfThreads;
+    (void) minimumBlockSize;
+#endif
+}
+
+
+/*--------------*
+ *  destructor  *
+ *--------------*/
+
+DiParallelLoop::~DiParallelLoop()
+{
+}
+
+
+/********************************************************************/
+
+
+void DiParallelLoop::run()
+{
+    /* the calling thread takes part in processing the blocks, so they are all processed even if no other thread is available */
+    DcmFrameProcessor::run(0, OFstatic_cast(Uint32, Blocks), OFstatic_cast(Uint32, Blocks));
+}
+
+
+OFCondition DiParallelLoop::processFrame(Uint32 block)
+{
+    // distribute the remainder over the first blocks, avoids an overflow for large images
+    const unsigned long size = Count / Blocks;
+    const unsigned long remainder = Count % Blocks;
+    const unsigned long start = block * size + ((block < remainder) ? block : remainder);
+    const unsigned long end = start + size + ((block < remainder) ? 1 : 0);
+    processBlock(block, start, end);
+    return EC_Normal;
+}
@@ -0,0 +1,701 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomRenderCache (Source)
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/dcmimgle/dircache.h"
+#include "dcmtk/dcmimgle/dcmimage.h"
+
+#include "dcmtk/ofstd/offile.h"
+#include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/ofstd/oftempf.h"
+
+#define INCLUDE_CSTDIO
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+BEGIN_EXTERN_C
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>      /* for close() */
+#endif
+#ifdef HAVE_IO_H
+#include <io.h>          /* for close() on Win32 */
+#endif
+END_EXTERN_C
+
+
+/*----------------*
+ *  helper class  *
+ *----------------*/
+
+#ifdef WITH_THREADS
+
+/** helper class locking a mutex for the lifetime of the object
+ */
+class DiRenderCacheLock
+{
+
+ public:
+
+    /** constructor, locks the mutex
+     *
+     ** @param  mutex  mutex to be locked
+     */
+    DiRenderCacheLock(OFMutex &mutex)
+      : Mutex(mutex)
+    {
+        Mutex.lock();
+    }
+
+    /** destructor, unlocks the mutex
+     */
+    ~DiRenderCacheLock()
+    {
+        Mutex.unlock();
+    }
+
+ private:
+
+    /// the mutex
+    OFMutex &Mutex;
+
+ // --- declarations to avoid compiler warnings
+
+    DiRenderCacheLock(const DiRenderCacheLock &);
+    DiRenderCacheLock &operator=(const DiRenderCacheLock &);
+};
+
+#define DIRCACHE_LOCK DiRenderCacheLock lock(Mutex)
+#else
+#define DIRCACHE_LOCK
+#endif
+
+
+/*--------------------*
+ *  static functions  *
+ *--------------------*/
+
+/* append an unsigned integer value and a separator to the given string
+ */
+static void appendValue(OFString &result,
+                        const unsigned long value)
+{
+    char buffer[32];
+    sprintf(buffer, "%lu\\", value);
+    result += buffer;
+}
+
+
+/* append a floating point value (with full precision) and a separator to the given string
+ */
+static void appendValue(OFString &result,
+                        const double value)
+{
+    char buffer[64];
+    OFStandard::ftoa(buffer, sizeof(buffer), value, 0, 0, 17 /* DBL_DIG + 2 */);
+    result += buffer;
+    result += '\\';
+}
+
+
+/* write output data to a new spill file in the given directory.
+ * The file is created exclusively with a random name that cannot be predicted by others.
+ */
+static OFBool writeSpillFile(const OFString &directory,
+                             const Uint8 *data,
+                             const unsigned long size,
+                             OFString &filename)
+{
+    unsigned int flags = O_RDWR;
+#ifdef O_BINARY
+    flags |= O_BINARY;
+#endif
+    int fd = -1;
+    if (OFTempFile::createFile(filename, &fd, flags, directory, "dcmrc_", ".tmp").bad())
+        return OFFalse;
+    OFFile file;
+    OFBool result = OFFalse;
+    if (file.fdopen(fd, "wb"))
+    {
+        result = (file.fwrite(data, 1, OFstatic_cast(size_t, size)) == OFstatic_cast(size_t, size));
+        if (file.fclose() != 0)
+            result = OFFalse;
+    } else
+        close(fd);
+    if (!result)
+        OFStandard::deleteFile(filename);
+    return result;
+}
+
+
+/* read output data from the given spill file
+ */
+static OFBool readSpillFile(const OFString &filename,
+                            Uint8 *buffer,
+                            const unsigned long size)
+{
+    OFFile file;
+    OFBool result = OFFalse;
+    if (file.fopen(filename.c_str(), "rb"))
+    {
+        result = (file.fread(buffer, 1, OFstatic_cast(size_t, size)) == OFstatic_cast(size_t, size));
+        file.fclose();
+    }
+    return result;
+}
+
+
+/* delete the given spill files
+ */
+static void deleteSpillFiles(const OFList<OFString> &filenames)
+{
+    OFListConstIterator(OFString) iter = filenames.begin();
+    while (iter != filenames.end())
+    {
+        OFStandard::deleteFile(*iter);
+        ++iter;
+    }
+}
+
+
+/*----------------*
+ *  constructors  *
+ *----------------*/
+
+DiRenderCacheKey::DiRenderCacheKey(const OFString &sopInstanceUID,
+                                   const unsigned long frame,
+                                   const unsigned long width,
+                                   const unsigned long height,
+                                   const int bits,
+                                   const int planar)
+  : SOPInstanceUID(sopInstanceUID),
+    Frame(frame),
+    Width(width),
+    Height(height),
+    Bits(bits),
+    Planar(planar),
+    Interpolation(0),
+    VoiMode(EVM_Unspecified),
+    WindowCenter(0),
+    WindowWidth(0),
+    VoiLutFunction(EFV_Default),
+    VoiIndex(0),
+    PresLutShape(ESP_Default),
+    PresLutShapeValid(OFFalse),
+    Polarity(EPP_Normal),
+    PolarityValid(OFFalse),
+    FurtherParameters()
+{
+}
+
+
+DiRenderCache::DiRenderCache(const unsigned long memoryLimit,
+                             const OFString &spillDirectory,
+                             const unsigned long diskLimit)
+  : MemoryLimit(memoryLimit),
+    SpillDirectory(spillDirectory),
+    DiskLimit(diskLimit),
+    MemoryEntries(),
+    MemoryList(),
+    MemoryUsage(0),
+    DiskEntries(),
+    DiskList(),
+    DiskUsage(0),
+    Hits(0),
+    Misses(0)
+#ifdef WITH_THREADS
+  , Mutex()
+#endif
+{
+}
+
+
+/*--------------*
+ *  destructor  *
+ *--------------*/
+
+DiRenderCacheKey::~DiRenderCacheKey()
+{
+}
+
+
+DiRenderCache::~DiRenderCache()
+{
+    clear();
+}
+
+
+/********************************************************************/
+
+
+void DiRenderCacheKey::setInterpolation(const int interpolate)
+{
+    Interpolation = interpolate;
+}
+
+
+void DiRenderCacheKey::setWindow(const double center,
+                                 const double width,
+                                 const EF_VoiLutFunction function)
+{
+    VoiMode = EVM_Window;
+    WindowCenter = center;
+    WindowWidth = width;
+    VoiLutFunction = function;
+}
+
+
+void DiRenderCacheKey::setWindow(const unsigned long window)
+{
+    VoiMode = EVM_StoredWindow;
+    VoiIndex = window;
+}
+
+
+void DiRenderCacheKey::setVoiLut(const unsigned long table)
+{
+    VoiMode = EVM_StoredLut;
+    VoiIndex = table;
+}
+
+
+void DiRenderCacheKey::setMinMaxWindow(const int idx)
+{
+    VoiMode = EVM_MinMaxWindow;
+    VoiIndex = (idx) ? 1 : 0;
+}
+
+
+void DiRenderCacheKey::setNoVoiTransformation()
+{
+    VoiMode = EVM_None;
+}
+
+
+void DiRenderCacheKey::setPresentationLutShape(const ES_PresentationLut shape)
+{
+    PresLutShape = shape;
+    PresLutShapeValid = OFTrue;
+}
+
+
+void DiRenderCacheKey::setPolarity(const EP_Polarity polarity)
+{
+    Polarity = polarity;
+    PolarityValid = OFTrue;
+}
+
+
+void DiRenderCacheKey::setFurtherParameters(const OFString &parameters)
+{
+    FurtherParameters = parameters;
+}
+
+
+OFString DiRenderCacheKey::getString() const
+{
+    /* the backslash never occurs in a UID and separates the values */
+    OFString result = SOPInstanceUID;
+    result += '\\';
+    appendValue(result, Frame);
+    appendValue(result, Width);
+    appendValue(result, Height);
+    appendValue(result, OFstatic_cast(unsigned long, Bits + 1));    // MI_PastelColor is -1
+    appendValue(result, OFstatic_cast(unsigned long, Planar));
+    appendValue(result, OFstatic_cast(unsigned long, Interpolation));
+    appendValue(result, OFstatic_cast(unsigned long, VoiMode));
+    switch (VoiMode)
+    {
+        case EVM_Window:
+            appendValue(result, WindowCenter);
+            appendValue(result, WindowWidth);
+            appendValue(result, OFstatic_cast(unsigned long, VoiLutFunction));
+            break;
+        case EVM_StoredWindow:
+        case EVM_StoredLut:
+        case EVM_MinMaxWindow:
+            appendValue(result, VoiIndex);
+            break;
+        default:
+            break;
+    }
+    appendValue(result, (PresLutShapeValid) ? OFstatic_cast(unsigned long, PresLutShape) + 1 : 0);
+    appendValue(result, (PolarityValid) ? OFstatic_cast(unsigned long, Polarity) + 1 : 0);
+    result += FurtherParameters;
+    return result;
+}
+
+
+OFBool DiRenderCacheKey::applyTo(DicomImage &image) const
+{
+    int status = 1;
+    if (image.isMonochrome())
+    {
+        switch (VoiMode)
+        {
+            case EVM_Window:
+                status = image.setWindow(WindowCenter, WindowWidth) && image.setVoiLutFunction(VoiLutFunction);
+                break;
+            case EVM_StoredWindow:
+                status = image.setWindow(VoiIndex);
+                break;
+            case EVM_StoredLut:
+                status = image.setVoiLut(VoiIndex);
+                break;
+            case EVM_MinMaxWindow:
+                status = image.setMinMaxWindow(OFstatic_cast(int, VoiIndex));
+                break;
+            case EVM_None:
+                status = image.setNoVoiTransformation();
+                break;
+            default:
+                break;
+        }
+        if (status && PresLutShapeValid)
+            status = image.setPresentationLutShape(PresLutShape);
+    }
+    if (status && PolarityValid)
+        status = image.setPolarity(Polarity);
+    return (status != 0);
+}
+
+
+/********************************************************************/
+
+
+OFBool DiRenderCache::getData(const DiRenderCacheKey &key,
+                              void *buffer,
+                              const unsigned long size)
+{
+    const OFString string = key.getString();
+    OFString filename;
+    {
+        DIRCACHE_LOCK;
+        if (buffer != NULL)
+        {
+            OFMap<OFString, MemoryEntry>::iterator memory = MemoryEntries.find(string);
+            if (memory != MemoryEntries.end())
+            {
+                if (memory->second.Size == size)
+                {
+                    memcpy(buffer, memory->second.Data, OFstatic_cast(size_t, size));
+                    /* mark as most recently used */
+                    MemoryList.erase(memory->second.Position);
+                    memory->second.Position = MemoryList.insert(MemoryList.begin(), string);
+                    ++Hits;
+                    return OFTrue;
+                }
+            } else {
+                OFMap<OFString, DiskEntry>::iterator disk = DiskEntries.find(string);
+                if ((disk != DiskEntries.end()) && (disk->second.Size == size))
+                {
+                    /* take over the spill file, so it is not deleted while being read */
+                    filename = disk->second.Filename;
+                    DiskUsage -= size;
+                    DiskList.erase(disk->second.Position);
+                    DiskEntries.erase(disk);
+                }
+            }
+        }
+        if (filename.empty())
+        {
+            ++Misses;
+            return OFFalse;
+        }
+    }
+    /* read the spill file without locking the cache */
+    const OFBool result = readSpillFile(filename, OFstatic_cast(Uint8 *, buffer), size);
+    OFList<SpillRequest> spills;
+    OFList<OFString> obsoleteFiles;
+    {
+        DIRCACHE_LOCK;
+        if (result)
+        {
+            ++Hits;
+            if ((MemoryEntries.find(string) != MemoryEntries.end()) || (DiskEntries.find(string) != DiskEntries.end()))
+            {
+                /* the frame has been added again in the meantime */
+                obsoleteFiles.push_back(filename);
+            }
+            else if (size <= MemoryLimit)
+            {
+                /* move the frame back to memory */
+                Uint8 *data = new Uint8[size];
+                memcpy(data, buffer, OFstatic_cast(size_t, size));
+                addToMemory(string, data, size, spills);
+                obsoleteFiles.push_back(filename);
+            } else {
+                /* mark as most recently used */
+                addToDisk(string, filename, size, OFFalse /*replace*/, obsoleteFiles);
+            }
+        } else {
+            /* the spill file is not usable anymore */
+            ++Misses;
+            obsoleteFiles.push_back(filename);
+        }
+    }
+    deleteSpillFiles(obsoleteFiles);
+    writeSpillFiles(spills);
+    return result;
+}
+
+
+OFBool DiRenderCache::putData(const DiRenderCacheKey &key,
+                              const void *data,
+                              const unsigned long size)
+{
+    OFBool result = OFFalse;
+    if ((data != NULL) && (size > 0))
+    {
+        const OFString string = key.getString();
+        OFList<SpillRequest> spills;
+        OFList<OFString> obsoleteFiles;
+        {
+            DIRCACHE_LOCK;
+            removeFromMemory(string);
+            removeFromDisk(string, obsoleteFiles);
+            if (size <= MemoryLimit)
+            {
+                Uint8 *copy = new Uint8[size];
+                memcpy(copy, data, OFstatic_cast(size_t, size));
+                addToMemory(string, copy, size, spills);
+                result = OFTrue;
+            }
+        }
+        deleteSpillFiles(obsoleteFiles);
+        writeSpillFiles(spills);
+        /* frames that do not fit into memory are stored in a spill file directly */
+        if (size > MemoryLimit)
+            result = spill(string, OFstatic_cast(const Uint8 *, data), size, OFTrue /*replace*/);
+    }
+    return result;
+}
+
+
+OFBool DiRenderCache::getOutputData(const DiRenderCacheKey &key,
+                                    DicomImage *image,
+                                    void *buffer,
+                                    const unsigned long size,
+                                    const unsigned long firstFrame)
+{
+    if ((buffer == NULL) || (size == 0))
+        return OFFalse;
+    if (getData(key, buffer, size))
+        return OFTrue;
+    /* the frame has to be rendered */
+    if ((image == NULL) || (image->getStatus() != EIS_Normal) || (key.getFrame() < firstFrame) ||
+        (key.getFrame() - firstFrame >= image->getFrameCount()) || !key.applyTo(*image))
+    {
+        return OFFalse;
+    }
+    unsigned long frame = key.getFrame() - firstFrame;
+    const unsigned long width = (key.getWidth() > 0) ? key.getWidth() : image->getWidth();
+    const unsigned long height = (key.getHeight() > 0) ? key.getHeight() : image->getHeight();
+    OFBool result = OFFalse;
+    if ((width == image->getWidth()) && (height == image->getHeight()))
+        result = image->getOutputData(buffer, size, key.getBits(), frame, key.getPlanar()) != 0;
+    else {
+        /* scale the requested frame only */
+        DicomImage *single = NULL;
+        if (image->getFrameCount() > 1)
+        {
+            single = image->createDicomImage(frame, 1);
+            frame = 0;
+        }
+        DicomImage *scaled = NULL;
+        if (single != NULL)
+            scaled = single->createScaledImage(width, height, key.getInterpolation(), 0 /*aspect*/);
+        else if (frame == 0)
+            scaled = image->createScaledImage(width, height, key.getInterpolation(), 0 /*aspect*/);
+        if (scaled != NULL)
+            result = scaled->getOutputData(buffer, size, key.getBits(), frame, key.getPlanar()) != 0;
+        delete scaled;
+        delete single;
+    }
+    if (result)
+        putData(key, buffer, size);
+    return result;
+}
+
+
+void DiRenderCache::clear()
+{
+    OFList<OFString> obsoleteFiles;
+    {
+        DIRCACHE_LOCK;
+        while (!MemoryList.empty())
+            removeFromMemory(MemoryList.back());
+        while (!DiskList.empty())
+            removeFromDisk(DiskList.back(), obsoleteFiles);
+    }
+    deleteSpillFiles(obsoleteFiles);
+}
+
+
+unsigned long DiRenderCache::getMemoryUsage()
+{
+    DIRCACHE_LOCK;
+    return MemoryUsage;
+}
+
+
+unsigned long DiRenderCache::getDiskUsage()
+{
+    DIRCACHE_LOCK;
+    return DiskUsage;
+}
+
+
+unsigned long DiRenderCache::getHits()
+{
+    DIRCACHE_LOCK;
+    return Hits;
+}
+
+
+unsigned long DiRenderCache::getMisses()
+{
+    DIRCACHE_LOCK;
+    return Misses;
+}
+
+
+/********************************************************************/
+
+
+OFBool DiRenderCache::canSpill(const unsigned long size) const
+{
+    return !SpillDirectory.empty() && ((DiskLimit == 0) || (size <= DiskLimit));
+}
+
+
+OFBool DiRenderCache::spill(const OFString &key,
+                            const Uint8 *data,
+                            const unsigned long size,
+                            const OFBool replace)
+{
+    OFBool result = OFFalse;
+    OFString filename;
+    if (canSpill(size) && writeSpillFile(SpillDirectory, data, size, filename))
+    {
+        OFList<OFString> obsoleteFiles;
+        {
+            DIRCACHE_LOCK;
+            result = addToDisk(key, filename, size, replace, obsoleteFiles);
+        }
+        deleteSpillFiles(obsoleteFiles);
+    }
+    return result;
+}
+
+
+void DiRenderCache::writeSpillFiles(OFList<SpillRequest> &spills)
+{
+    while (!spills.empty())
+    {
+        SpillRequest &request = spills.front();
+        spill(request.Key, request.Data, request.Size, OFFalse /*replace*/);
+        delete[] request.Data;
+        spills.pop_front();
+    }
+}
+
+
+void DiRenderCache::addToMemory(const OFString &key,
+                                Uint8 *data,
+                                const unsigned long size,
+                                OFList<SpillRequest> &spills)
+{
+    /* make room for the new frame, move the least recently used frames to disk (if possible) */
+    while (!MemoryList.empty() && (MemoryUsage + size > MemoryLimit))
+    {
+        const OFString oldest = MemoryList.back();
+        OFMap<OFString, MemoryEntry>::iterator entry = MemoryEntries.find(oldest);
+        if ((entry != MemoryEntries.end()) && canSpill(entry->second.Size))
+        {
+            /* the spill file is written after the mutex has been unlocked */
+            SpillRequest request;
+            request.Key = oldest;
+            request.Data = entry->second.Data;
+            request.Size = entry->second.Size;
+            spills.push_back(request);
+            entry->second.Data = NULL;
+        }
+        removeFromMemory(oldest);
+    }
+    MemoryEntry entry;
+    entry.Data = data;
+    entry.Size = size;
+    entry.Position = MemoryList.insert(MemoryList.begin(), key);
+    MemoryEntries[key] = entry;
+    MemoryUsage += size;
+}
+
+
+OFBool DiRenderCache::addToDisk(const OFString &key,
+                                const OFString &filename,
+                                const unsigned long size,
+                                const OFBool replace,
+                                OFList<OFString> &obsoleteFiles)
+{
+    if (replace)
+    {
+        removeFromMemory(key);
+        removeFromDisk(key, obsoleteFiles);
+    }
+    else if ((MemoryEntries.find(key) != MemoryEntries.end()) || (DiskEntries.find(key) != DiskEntries.end()))
+    {
+        /* the frame has been added again while the spill file was written */
+        obsoleteFiles.push_back(filename);
+        return OFFalse;
+    }
+    /* make room for the new frame, remove the least recently used frames */
+    while (!DiskList.empty() && (DiskLimit > 0) && (DiskUsage + size > DiskLimit))
+        removeFromDisk(DiskList.back(), obsoleteFiles);
+    DiskEntry entry;
+    entry.Filename = filename;
+    entry.Size = size;
+    entry.Position = DiskList.insert(DiskList.begin(), key);
+    DiskEntries[key] = entry;
+    DiskUsage += size;
+    return OFTrue;
+}
+
+
+void DiRenderCache::removeFromMemory(const OFString &key)
+{
+    OFMap<OFString, MemoryEntry>::iterator entry = MemoryEntries.find(key);
+    if (entry != MemoryEntries.end())
+    {
+        delete[] entry->second.Data;
+        MemoryUsage -= entry->second.Size;
+        MemoryList.erase(entry->second.Position);
+        MemoryEntries.erase(entry);
+    }
+}
+
+
+void DiRenderCache::removeFromDisk(const OFString &key,
+                                   OFList<OFString> &obsoleteFiles)
+{
+    OFMap<OFString, DiskEntry>::iterator entry = DiskEntries.find(key);
+    if (entry != DiskEntries.end())
+    {
+        obsoleteFiles.push_back(entry->second.Filename);
+        DiskUsage -= entry->second.Size;
+        DiskList.erase(entry->second.Position);
+        DiskEntries.erase(entry);
+    }
+}
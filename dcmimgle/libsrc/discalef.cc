@@ -0,0 +1,268 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomScaleFilter (Source)
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/dcmimgle/discalef.h"
+
+
+/*----------------*
+ *  constructors  *
+ *----------------*/
+
+DiScaleFilter::DiScaleFilter(const Uint16 srcCount,
+                             const Uint16 destCount)
+  : SrcCount(srcCount),
+    DestCount(destCount),
+    Width(1),
+    Contributions(),
+    Start(),
+    Weights()
+{
+}
+
+
+/*--------------*
+ *  destructor  *
+ *--------------*/
+
+DiScaleFilter::~DiScaleFilter()
+{
+}
+
+
+/********************************************************************/
+
+
+void DiScaleFilter::setupBilinear()
+{
+    /*
+     *   based on scaling algorithm contributed by Eduard Stanescu
+     *   (the first and the last pixel are just copied from the source data)
+     */
+
+    const double factor = OFstatic_cast(double, SrcCount) / OFstatic_cast(double, DestCount);
+    signed long srcIndex = 0;
+    double offset;
+    addWeight(0, 0, 1.0);
+    for (Uint16 i = 1; i + 1 < DestCount; ++i)
+    {
+        offset = i * factor - srcIndex;
+        addLinearWeights(i, srcIndex, (1.0 < offset) ? 1.0 : offset);
+        // don't go beyond the source data
+        if ((srcIndex < SrcCount - 2) && (i * factor >= srcIndex + 1))
+            ++srcIndex;
+    }
+    addWeight(DestCount - 1, SrcCount - 1, 1.0);
+    createTable();
+}
+
+
+void DiScaleFilter::setupBicubic(const OFBool lines)
+{
+    /*
+     *   based on scaling algorithm contributed by Eduard Stanescu
+     *   (cubic interpolation for the majority of pixels, linear interpolation near the borders)
+     */
+
+    const double factor = OFstatic_cast(double, SrcCount) / OFstatic_cast(double, DestCount);
+    const signed long delta = OFstatic_cast(signed long, 1 / factor);
+    const signed long lastCubic = lines ? OFstatic_cast(signed long, DestCount) - delta - 1 : OFstatic_cast(signed long, DestCount) - 2 * delta;
+    signed long srcIndex = 0;
+    signed long i;
+    double offset;
+    addWeight(0, 0, 1.0);
+    // for the next few pixels, linear interpolation (unless overridden by the last few pixels)
+    for (i = 1; (i < delta + 1) && (i < lastCubic); ++i)
+    {
+        offset = i * factor;
+        addLinearWeights(OFstatic_cast(Uint16, i), 0, (1.0 < offset) ? 1.0 : offset);
+    }
+    // the majority of the pixels
+    srcIndex = 1;
+    for (i = delta + 1; i < lastCubic; ++i)
+    {
+        offset = i * factor - srcIndex;
+        addCubicWeights(OFstatic_cast(Uint16, i), srcIndex, (1.0 < offset) ? 1.0 : offset);
+        // don't go beyond the source data
+        if ((srcIndex < SrcCount - 3) && (i * factor >= srcIndex + 1))
+            ++srcIndex;
+    }
+    // last few pixels except the very last one, linear interpolation
+    for (i = (lastCubic > 1) ? lastCubic : 1; i + 1 < OFstatic_cast(signed long, DestCount); ++i)
+    {
+        offset = i * factor - srcIndex;
+        if (lines)
+        {
+            // in between the second last and the last line
+            addLinearWeights(OFstatic_cast(Uint16, i), SrcCount - 2, (1.0 < offset) ? 1.0 : offset);
+        } else {
+            addLinearWeights(OFstatic_cast(Uint16, i), srcIndex, (1.0 < offset) ? 1.0 : offset);
+            // don't go beyond the source data
+            if ((srcIndex < SrcCount - 2) && (i * factor >= srcIndex + 1))
+                ++srcIndex;
+        }
+    }
+    addWeight(DestCount - 1, SrcCount - 1, 1.0);
+    createTable();
+}
+
+
+void DiScaleFilter::setupExpansion()
+{
+    /*
+     *   based on scaling algorithm from "c't - Magazin fuer Computertechnik" (c't 11/94)
+     *   (each destination pixel is covered by at most two source pixels)
+     */
+
+    const double factor = OFstatic_cast(double, SrcCount) / OFstatic_cast(double, DestCount);
+    double b, e, part;
+    signed long bi, ei;
+    for (Uint16 i = 0; i < DestCount; ++i)
+    {
+        b = factor * OFstatic_cast(double, i);
+        e = factor * (OFstatic_cast(double, i) + 1.0);
+        // see setupReduction()
+        if (e > SrcCount)
+            e = SrcCount;
+        bi = OFstatic_cast(signed long, b);
+        ei = OFstatic_cast(signed long, e);
+        if (OFstatic_cast(double, ei) == e)
+            --ei;
+        if (bi == ei)
+            addWeight(i, bi, 1.0);
+        else {
+            part = OFstatic_cast(double, ei) / factor;
+            addWeight(i, bi, part - OFstatic_cast(double, i));
+            for (signed long k = bi + 1; k <= ei; ++k)
+                addWeight(i, k, (OFstatic_cast(double, i) + 1.0) - part);
+        }
+    }
+    createTable();
+}
+
+
+void DiScaleFilter::setupReduction()
+{
+    /*
+     *   based on scaling algorithm from "c't - Magazin fuer Computertechnik" (c't 11/94)
+     *   (the weight of each source pixel is the part of its area covered by the destination pixel)
+     */
+
+    const double factor = OFstatic_cast(double, SrcCount) / OFstatic_cast(double, DestCount);
+    double b, e;
+    signed long bi, ei;
+    for (Uint16 i = 0; i < DestCount; ++i)
+    {
+        b = factor * OFstatic_cast(double, i);
+        e = factor * (OFstatic_cast(double, i) + 1.0);
+        // yes, this can happen due to rounding, e.g. double(943) / double(471) * double(471)
+        // is something like 943.00000000000011368683772161602974 and then, the ei == e check
+        // fails to bring ei back into range!
+        if (e > SrcCount)
+            e = SrcCount;
+        bi = OFstatic_cast(signed long, b);
+        ei = OFstatic_cast(signed long, e);
+        if (OFstatic_cast(double, ei) == e)
+            --ei;
+        addWeight(i, bi, (1.0 + OFstatic_cast(double, bi) - b) / factor);
+        for (signed long k = bi + 1; k < ei; ++k)
+            addWeight(i, k, 1.0 / factor);
+        if (ei > bi)
+            addWeight(i, ei, (e - OFstatic_cast(double, ei)) / factor);
+    }
+    createTable();
+}
+
+
+void DiScaleFilter::addWeight(const Uint16 dest,
+                              const signed long src,
+                              const double weight)
+{
+    if ((dest < DestCount) && (SrcCount > 0))
+    {
+        Contribution contribution;
+        contribution.Dest = dest;
+        if (src < 0)
+            contribution.Source = 0;
+        else if (src >= OFstatic_cast(signed long, SrcCount))
+            contribution.Source = SrcCount - 1;
+        else
+            contribution.Source = OFstatic_cast(Uint16, src);
+        contribution.Weight = weight;
+        Contributions.push_back(contribution);
+    }
+}
+
+
+void DiScaleFilter::createTable()
+{
+    /* determine the range of source pixels used for each destination pixel */
+    OFVector<Sint32> first(DestCount, -1);
+    OFVector<Sint32> last(DestCount, -1);
+    OFVector<Contribution>::const_iterator it;
+    for (it = Contributions.begin(); it != Contributions.end(); ++it)
+    {
+        if ((first[it->Dest] < 0) || (it->Source < first[it->Dest]))
+            first[it->Dest] = it->Source;
+        if (it->Source > last[it->Dest])
+            last[it->Dest] = it->Source;
+    }
+    Width = 1;
+    Uint16 i;
+    for (i = 0; i < DestCount; ++i)
+    {
+        if ((first[i] >= 0) && (OFstatic_cast(unsigned long, last[i] - first[i] + 1) > Width))
+            Width = OFstatic_cast(unsigned long, last[i] - first[i] + 1);
+    }
+    /* all source pixels are within the image, so the width never exceeds the number of source pixels */
+    Start.clear();
+    Start.resize(DestCount, 0);
+    for (i = 0; i < DestCount; ++i)
+    {
+        if (first[i] > OFstatic_cast(Sint32, SrcCount - Width))
+            Start[i] = OFstatic_cast(Sint32, SrcCount - Width);
+        else if (first[i] > 0)
+            Start[i] = first[i];
+    }
+    Weights.clear();
+    Weights.resize(Width * DestCount, 0);
+    for (it = Contributions.begin(); it != Contributions.end(); ++it)
+        Weights[(it->Source - Start[it->Dest]) * DestCount + it->Dest] += it->Weight;
+    Contributions.clear();
+}
+
+
+void DiScaleFilter::addLinearWeights(const Uint16 dest,
+                                     const signed long src,
+                                     const double offset)
+{
+    addWeight(dest, src, 1.0 - offset);
+    addWeight(dest, src + 1, offset);
+}
+
+
+void DiScaleFilter::addCubicWeights(const Uint16 dest,
+                                    const signed long src,
+                                    const double offset)
+{
+    /* coefficients of the Catmull-Rom formula */
+    const double d2 = offset * offset;
+    const double d3 = d2 * offset;
+    addWeight(dest, src - 1, 0.5 * (-d3 + 2 * d2 - offset));
+    addWeight(dest, src, 0.5 * (3 * d3 - 5 * d2 + 2));
+    addWeight(dest, src + 1, 0.5 * (-3 * d3 + 4 * d2 + offset));
+    addWeight(dest, src + 2, 0.5 * (d3 - d2));
+}
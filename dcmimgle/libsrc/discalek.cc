@@ -0,0 +1,291 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomScaleKernels (Source)
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/dcmimgle/discalek.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
+
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+/* the vectorized kernels are compiled for the respective instruction set by means of
+ * function attributes, so the rest of the library does not depend on the CPU features
+ * (see dimokrnl.cc)
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define DISCALEK_X86
+#define DISCALEK_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#endif
+
+
+/*--------------------*
+ *  static functions  *
+ *--------------------*/
+
+#ifdef DISCALEK_X86
+
+/* AVX2: load 8 pixels and convert them to 32 bit integers
+ */
+DISCALEK_TARGET("avx2")
+static inline __m256i load8_AVX2(const Uint8 *src)
+{
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(OFreinterpret_cast(const __m128i *, src)));
+}
+
+DISCALEK_TARGET("avx2")
+static inline __m256i load8_AVX2(const Uint16 *src)
+{
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128(OFreinterpret_cast(const __m128i *, src)));
+}
+
+DISCALEK_TARGET("avx2")
+static inline __m256i load8_AVX2(const Sint16 *src)
+{
+    return _mm256_cvtepi16_epi32(_mm_loadu_si128(OFreinterpret_cast(const __m128i *, src)));
+}
+
+
+/* SSE4.1: load 4 pixels and convert them to 32 bit integers
+ */
+DISCALEK_TARGET("sse4.1")
+static inline __m128i load4_SSE41(const Uint8 *src)
+{
+    Sint32 value;
+    memcpy(&value, src, sizeof(value));
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(value));
+}
+
+DISCALEK_TARGET("sse4.1")
+static inline __m128i load4_SSE41(const Uint16 *src)
+{
+    return _mm_cvtepu16_epi32(_mm_loadl_epi64(OFreinterpret_cast(const __m128i *, src)));
+}
+
+DISCALEK_TARGET("sse4.1")
+static inline __m128i load4_SSE41(const Sint16 *src)
+{
+    return _mm_cvtepi16_epi32(_mm_loadl_epi64(OFreinterpret_cast(const __m128i *, src)));
+}
+
+
+/* AVX2: add weighted row, 8 pixels per iteration (multiplication and addition are not fused,
+ * so the results are identical to the generic version)
+ */
+template<class T>
+DISCALEK_TARGET("avx2")
+static unsigned long addWeightedRow_AVX2(const T *src,
+                                         float *dst,
+                                         const unsigned long count,
+                                         const float weight)
+{
+    const __m256 w = _mm256_set1_ps(weight);
+    unsigned long i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 v = _mm256_mul_ps(w, _mm256_cvtepi32_ps(load8_AVX2(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), v));
+    }
+    return i;
+}
+
+
+/* SSE4.1: add weighted row, 4 pixels per iteration
+ */
+template<class T>
+DISCALEK_TARGET("sse4.1")
+static unsigned long addWeightedRow_SSE41(const T *src,
+                                          float *dst,
+                                          const unsigned long count,
+                                          const float weight)
+{
+    const __m128 w = _mm_set1_ps(weight);
+    unsigned long i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 v = _mm_mul_ps(w, _mm_cvtepi32_ps(load4_SSE41(src + i)));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), v));
+    }
+    return i;
+}
+
+
+/* AVX2: add row, 8 pixels per iteration
+ */
+template<class T>
+DISCALEK_TARGET("avx2")
+static unsigned long addRow_AVX2(const T *src,
+                                 Sint32 *dst,
+                                 const unsigned long count)
+{
+    unsigned long i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i *q = OFreinterpret_cast(__m256i *, dst + i);
+        _mm256_storeu_si256(q, _mm256_add_epi32(_mm256_loadu_si256(q), load8_AVX2(src + i)));
+    }
+    return i;
+}
+
+
+/* SSE4.1: add row, 4 pixels per iteration
+ */
+template<class T>
+DISCALEK_TARGET("sse4.1")
+static unsigned long addRow_SSE41(const T *src,
+                                  Sint32 *dst,
+                                  const unsigned long count)
+{
+    unsigned long i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i *q = OFreinterpret_cast(__m128i *, dst + i);
+        _mm_storeu_si128(q, _mm_add_epi32(_mm_loadu_si128(q), load4_SSE41(src + i)));
+    }
+    return i;
+}
+
+
+/* AVX2: apply filter table to 8 destination values per iteration using gather instructions,
+ * the taps are summed up in the same order as in the generic version
+ */
+DISCALEK_TARGET("avx2")
+static unsigned long applyFilter_AVX2(const float *src,
+                                      float *dst,
+                                      const unsigned long count,
+                                      const Sint32 *start,
+                                      const float *weights,
+                                      const unsigned long width)
+{
+    const __m256i one = _mm256_set1_epi32(1);
+    unsigned long i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i index = _mm256_loadu_si256(OFreinterpret_cast(const __m256i *, start + i));
+        __m256 value = _mm256_setzero_ps();
+        const float *w = weights + i;
+        for (unsigned long k = 0; k < width; ++k, w += count)
+        {
+            value = _mm256_add_ps(value, _mm256_mul_ps(_mm256_loadu_ps(w), _mm256_i32gather_ps(src, index, 4)));
+            index = _mm256_add_epi32(index, one);
+        }
+        _mm256_storeu_ps(dst + i, value);
+    }
+    return i;
+}
+
+#endif
+
+
+/* add weighted row using the best available kernel, the remaining pixels are processed by the generic version
+ */
+template<class T>
+static void addWeightedRowDispatch(const T *src,
+                                   float *dst,
+                                   const unsigned long count,
+                                   const float weight)
+{
+    unsigned long done = 0;
+#ifdef DISCALEK_X86
+    const DiMonoKernels::E_InstructionSet instructionSet = DiMonoKernels::getInstructionSet();
+    if (instructionSet >= DiMonoKernels::IS_AVX2)
+        done = addWeightedRow_AVX2(src, dst, count, weight);
+    else if (instructionSet >= DiMonoKernels::IS_SSE41)
+        done = addWeightedRow_SSE41(src, dst, count, weight);
+#endif
+    DiScaleKernels::addWeightedRow<T, float>(src + done, dst + done, count - done, weight);
+}
+
+
+/* add row using the best available kernel, the remaining pixels are processed by the generic version
+ */
+template<class T>
+static void addRowDispatch(const T *src,
+                           Sint32 *dst,
+                           const unsigned long count)
+{
+    unsigned long done = 0;
+#ifdef DISCALEK_X86
+    const DiMonoKernels::E_InstructionSet instructionSet = DiMonoKernels::getInstructionSet();
+    if (instructionSet >= DiMonoKernels::IS_AVX2)
+        done = addRow_AVX2(src, dst, count);
+    else if (instructionSet >= DiMonoKernels::IS_SSE41)
+        done = addRow_SSE41(src, dst, count);
+#endif
+    DiScaleKernels::addRow<T, Sint32>(src + done, dst + done, count - done);
+}
+
+
+/*------------------*
+ *  implementation  *
+ *------------------*/
+
+void DiScaleKernels::addWeightedRow(const Uint8 *src, float *dst, const unsigned long count, const float weight)
+{
+    addWeightedRowDispatch(src, dst, count, weight);
+}
+
+
+void DiScaleKernels::addWeightedRow(const Uint16 *src, float *dst, const unsigned long count, const float weight)
+{
+    addWeightedRowDispatch(src, dst, count, weight);
+}
+
+
+void DiScaleKernels::addWeightedRow(const Sint16 *src, float *dst, const unsigned long count, const float weight)
+{
+    addWeightedRowDispatch(src, dst, count, weight);
+}
+
+
+void DiScaleKernels::addRow(const Uint8 *src, Sint32 *dst, const unsigned long count)
+{
+    addRowDispatch(src, dst, count);
+}
+
+
+void DiScaleKernels::addRow(const Uint16 *src, Sint32 *dst, const unsigned long count)
+{
+    addRowDispatch(src, dst, count);
+}
+
+
+void DiScaleKernels::addRow(const Sint16 *src, Sint32 *dst, const unsigned long count)
+{
+    addRowDispatch(src, dst, count);
+}
+
+
+void DiScaleKernels::applyFilter(const float *src, float *dst, const unsigned long count, const Sint32 *start,
+                                 const float *weights, const unsigned long width)
+{
+    unsigned long done = 0;
+#ifdef DISCALEK_X86
+    if (DiMonoKernels::getInstructionSet() >= DiMonoKernels::IS_AVX2)
+        done = applyFilter_AVX2(src, dst, count, start, weights, width);
+#endif
+    /* the weights of the remaining values are stored with the same stride */
+    const float *w = weights + done;
+    for (unsigned long i = done; i < count; ++i, ++w)
+    {
+        float value = 0;
+        const float *wk = w;
+        for (unsigned long k = 0; k < width; ++k, wk += count)
+            value += *wk * src[start[i] + k];
+        dst[i] = value;
+    }
+}
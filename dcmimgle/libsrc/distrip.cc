@@ -0,0 +1,226 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: DicomStripRenderer (Source)
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/dcmimgle/distrip.h"
+#include "dcmtk/dcmimgle/diimage.h"
+#include "dcmtk/dcmimgle/dimoopx.h"
+#include "dcmtk/dcmimgle/diparal.h"
+
+#include "dcmtk/ofstd/ofthread.h"
+
+
+/*----------------*
+ *  worker class  *
+ *----------------*/
+
+#ifdef WITH_THREADS
+
+/** thread rendering all strips of a DiStripRenderer
+ */
+class DiStripRenderer::Worker
+  : public OFThread
+{
+
+ public:
+
+    /** constructor
+     *
+     ** @param  renderer  the strip renderer
+     */
+    Worker(DiStripRenderer &renderer)
+      : OFThread(),
+        Renderer(renderer)
+    {
+    }
+
+ protected:
+
+    /// render all strips
+    virtual void run()
+    {
+        Renderer.renderAll();
+    }
+
+ private:
+
+    /// the strip renderer
+    DiStripRenderer &Renderer;
+};
+
+#else
+
+/// dummy declaration, not used without thread support
+class DiStripRenderer::Worker
+{
+};
+
+#endif
+
+
+/*----------------*
+ *  constructors  *
+ *----------------*/
+
+const unsigned long DiStripRenderer::DefaultStripSize = 65536;
+
+
+DiStripRenderer::DiStripRenderer(DiImage *image,
+                                 const unsigned long frame,
+                                 const int bits,
+                                 const unsigned long rowsPerStrip,
+                                 const int planar)
+  : Image(image),
+    Frame(frame),
+    Bits(bits),
+    Planar(planar),
+    Rows(0),
+    RowSize(0),
+    RowsPerStrip(0),
+    Strips(0),
+    NextStrip(0),
+    OutputLUT(NULL),
+    Thread(NULL),
+    FreeBuffers(NULL),
+    FilledBuffers(NULL),
+    Abort(OFFalse)
+{
+    Buffer[0] = NULL;
+    Buffer[1] = NULL;
+    Status[0] = OFFalse;
+    Status[1] = OFFalse;
+    if ((Image != NULL) && (Image->getRows() > 0) && (Image->getColumns() > 0))
+    {
+        Rows = Image->getRows();
+        RowSize = Image->getOutputDataSize(bits) / Rows;
+        if (RowSize > 0)
+        {
+            if (rowsPerStrip > 0)
+                RowsPerStrip = rowsPerStrip;
+            else
+                RowsPerStrip = DefaultStripSize / Image->getColumns();
+            if (RowsPerStrip == 0)
+                RowsPerStrip = 1;
+            else if (RowsPerStrip > Rows)
+                RowsPerStrip = Rows;
+            Strips = (Rows + RowsPerStrip - 1) / RowsPerStrip;
+            Buffer[0] = new Uint8[RowSize * RowsPerStrip];
+            /* the same rendering parameters are used for all strips, so the LUT needs to be created only once */
+            OutputLUT = new DiMonoOutputLUT(OFstatic_cast(unsigned long, Image->getColumns()) * Rows);
+#ifdef WITH_THREADS
+            /* render the next strip by a separate thread (if allowed) */
+            if ((dcmRenderingMaxThreads.get() > 1) && (Strips > 1))
+            {
+                Buffer[1] = new Uint8[RowSize * RowsPerStrip];
+                FreeBuffers = new OFSemaphore(2);
+                FilledBuffers = new OFSemaphore(0);
+                Thread = new Worker(*this);
+                if (Thread->start() != 0)
+                {
+                    DCMIMGLE_DEBUG("cannot start rendering thread ... rendering strips in the calling thread");
+                    delete Thread;
+                    Thread = NULL;
+                }
+            }
+#endif
+        }
+    }
+}
+
+
+/*--------------*
+ *  destructor  *
+ *--------------*/
+
+DiStripRenderer::~DiStripRenderer()
+{
+#ifdef WITH_THREADS
+    if (Thread != NULL)
+    {
+        /* stop the rendering thread (if still running) */
+        Abort = OFTrue;
+        FreeBuffers->post();
+        FreeBuffers->post();
+        Thread->join();
+        delete Thread;
+    }
+#endif
+    delete FreeBuffers;
+    delete FilledBuffers;
+    delete[] Buffer[0];
+    delete[] Buffer[1];
+    delete OutputLUT;
+}
+
+
+/********************************************************************/
+
+
+const void *DiStripRenderer::getNextStrip(unsigned long &firstRow,
+                                          unsigned long &rowCount)
+{
+    const void *result = NULL;
+    if ((Buffer[0] != NULL) && (NextStrip < Strips))
+    {
+        const unsigned long strip = NextStrip++;
+        firstRow = strip * RowsPerStrip;
+        rowCount = (firstRow + RowsPerStrip <= Rows) ? RowsPerStrip : Rows - firstRow;
+#ifdef WITH_THREADS
+        if (Thread != NULL)
+        {
+            /* the buffer of the previous strip is no longer needed */
+            if (strip > 0)
+                FreeBuffers->post();
+            FilledBuffers->wait();
+            const int buffer = OFstatic_cast(int, strip % 2);
+            if (Status[buffer])
+                result = Buffer[buffer];
+        } else
+#endif
+        if (render(strip, 0))
+            result = Buffer[0];
+        /* do not continue after an error */
+        if (result == NULL)
+            NextStrip = Strips;
+    }
+    return result;
+}
+
+
+OFBool DiStripRenderer::render(const unsigned long strip,
+                               const int buffer)
+{
+    const unsigned long firstRow = strip * RowsPerStrip;
+    const unsigned long rowCount = (firstRow + RowsPerStrip <= Rows) ? RowsPerStrip : Rows - firstRow;
+    return Image->getOutputRows(Buffer[buffer], RowSize * RowsPerStrip, Frame, Bits, firstRow, rowCount, Planar, OutputLUT) != 0;
+}
+
+
+void DiStripRenderer::renderAll()
+{
+    for (unsigned long strip = 0; strip < Strips; ++strip)
+    {
+        FreeBuffers->wait();
+        if (Abort)
+            break;
+        const int buffer = OFstatic_cast(int, strip % 2);
+        Status[buffer] = render(strip, buffer);
+        FilledBuffers->post();
+        /* do not continue after an error */
+        if (!Status[buffer])
+            break;
+    }
+}
@@ -0,0 +1,31 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: main test program
+ *
+ */
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/ofstd/oftest.h"
+
+OFTEST_REGISTER(dcmimgle_monoKernels);
+OFTEST_REGISTER(dcmimgle_parallelLoop);
+OFTEST_REGISTER(dcmimgle_parallelRendering);
+OFTEST_REGISTER(dcmimgle_renderCacheEviction);
+OFTEST_REGISTER(dcmimgle_renderCacheKey);
+OFTEST_REGISTER(dcmimgle_renderCacheSpillFiles);
+OFTEST_REGISTER(dcmimgle_scaleBilinearLastColumn);
+OFTEST_REGISTER(dcmimgle_scaleBoxReduction);
+OFTEST_REGISTER(dcmimgle_scaleThreadsAndInstructionSets);
+OFTEST_REGISTER(dcmimgle_stripRendering);
+OFTEST_REGISTER(dcmimgle_voiWindowsAfterModification);
+
+OFTEST_MAIN("dcmimgle")
@@ -0,0 +1,169 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: compare the vectorized monochrome kernels with the generic version
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
+
+
+/* number of pixels, odd and not a multiple of any vector size */
+#define PIXEL_COUNT 4099
+/* the kernels are called with all offsets up to this value (unaligned access) */
+#define MAX_OFFSET 33
+
+
+/* simple pseudo random number generator, so that the test is reproducible */
+static Uint32 nextRandom(Uint32 &state)
+{
+    state = state * 1103515245 + 12345;
+    return state >> 8;
+}
+
+
+/* compare the vectorized kernels for the given input and output type with the generic version */
+template<class T1, class T3>
+static void checkKernels(const T1 *src,
+                         const T3 *lut0,
+                         const char *typeName)
+{
+    const DiMonoKernels::E_InstructionSet instructionSet = DiMonoKernels::getInstructionSet();
+    T3 expected[PIXEL_COUNT];
+    T3 result[PIXEL_COUNT];
+    const T3 maxValue = OFstatic_cast(T3, ~OFstatic_cast(T3, 0));
+    const double width = OFstatic_cast(double, maxValue) / 2;
+    for (unsigned long offset = 0; offset <= MAX_OFFSET; ++offset)
+    {
+        const unsigned long count = PIXEL_COUNT - offset;
+        /* lookup table */
+        memset(expected, 0, sizeof(expected));
+        memset(result, 0, sizeof(result));
+        DiMonoKernels::applyLUT<T1, T3>(src + offset, expected, count, lut0);
+        DiMonoKernels::applyLUT(src + offset, result, count, lut0);
+        if (memcmp(expected, result, count * sizeof(T3)) != 0)
+        {
+            OFCHECK_FAIL("applyLUT() differs for " << typeName << " with " << DiMonoKernels::getInstructionSetName(instructionSet)
+                << " at offset " << offset);
+        }
+        /* linear VOI window, normal and inverse */
+        const double leftBorder = -1000.0 + OFstatic_cast(double, offset);
+        const double rightBorder = leftBorder + width;
+        const double gradient = OFstatic_cast(double, maxValue) / width;
+        for (int inverse = 0; inverse < 2; ++inverse)
+        {
+            const double grad = inverse ? -gradient : gradient;
+            const double off = inverse ? OFstatic_cast(double, maxValue) + leftBorder * gradient : -leftBorder * gradient;
+            const T3 low = inverse ? maxValue : 0;
+            const T3 high = inverse ? 0 : maxValue;
+            memset(expected, 0, sizeof(expected));
+            memset(result, 0, sizeof(result));
+            DiMonoKernels::applyWindow<T1, T3>(src + offset, expected, count, leftBorder, rightBorder, off, grad, low, high);
+            DiMonoKernels::applyWindow(src + offset, result, count, leftBorder, rightBorder, off, grad, low, high);
+            if (memcmp(expected, result, count * sizeof(T3)) != 0)
+            {
+                OFCHECK_FAIL("applyWindow() differs for " << typeName << " with " << DiMonoKernels::getInstructionSetName(instructionSet)
+                    << " at offset " << offset << (inverse ? " (inverse)" : ""));
+            }
+        }
+    }
+}
+
+
+/* compare the vectorized minimum/maximum determination with the generic version */
+template<class T>
+static void checkMinMax(const T *src,
+                        const char *typeName)
+{
+    const DiMonoKernels::E_InstructionSet instructionSet = DiMonoKernels::getInstructionSet();
+    for (unsigned long offset = 0; offset <= MAX_OFFSET; ++offset)
+    {
+        /* also check very short arrays that are not processed by vector instructions at all */
+        const unsigned long counts[3] = { 1, offset + 1, PIXEL_COUNT - offset };
+        for (int i = 0; i < 3; ++i)
+        {
+            T expectedMin = 0, expectedMax = 0, resultMin = 1, resultMax = 1;
+            DiMonoKernels::determineMinMax<T>(src + offset, counts[i], expectedMin, expectedMax);
+            DiMonoKernels::determineMinMax(src + offset, counts[i], resultMin, resultMax);
+            if ((expectedMin != resultMin) || (expectedMax != resultMax))
+            {
+                OFCHECK_FAIL("determineMinMax() differs for " << typeName << " with " << DiMonoKernels::getInstructionSetName(instructionSet)
+                    << " at offset " << offset << " for " << counts[i] << " pixels");
+            }
+        }
+    }
+}
+
+
+OFTEST(dcmimgle_monoKernels)
+{
+    Uint32 state = 4711;
+    Uint16 usrc[PIXEL_COUNT];
+    Sint16 ssrc[PIXEL_COUNT];
+    Uint8 u8src[PIXEL_COUNT];
+    Sint8 s8src[PIXEL_COUNT];
+    unsigned long i;
+    for (i = 0; i < PIXEL_COUNT; ++i)
+    {
+        const Uint32 value = nextRandom(state);
+        usrc[i] = OFstatic_cast(Uint16, value);
+        ssrc[i] = OFstatic_cast(Sint16, OFstatic_cast(Uint16, value >> 4));
+        u8src[i] = OFstatic_cast(Uint8, value >> 2);
+        s8src[i] = OFstatic_cast(Sint8, OFstatic_cast(Uint8, value >> 6));
+    }
+    /* the extreme values are placed in the last pixels (and therefore in the scalar tail of the vectorized versions) */
+    usrc[PIXEL_COUNT - 2] = 0;
+    usrc[PIXEL_COUNT - 1] = 65535;
+    ssrc[PIXEL_COUNT - 2] = -32768;
+    ssrc[PIXEL_COUNT - 1] = 32767;
+    u8src[PIXEL_COUNT - 2] = 0;
+    u8src[PIXEL_COUNT - 1] = 255;
+    s8src[PIXEL_COUNT - 2] = -128;
+    s8src[PIXEL_COUNT - 1] = 127;
+
+    /* lookup tables covering the full input range, padded by 4 bytes (see DiMonoKernels::applyLUT) */
+    const unsigned long lutSize = 65536 + 4;
+    Uint8 *lut8 = new Uint8[lutSize];
+    Uint16 *lut16 = new Uint16[lutSize];
+    for (i = 0; i < lutSize; ++i)
+    {
+        const Uint32 value = nextRandom(state);
+        lut8[i] = OFstatic_cast(Uint8, value);
+        lut16[i] = OFstatic_cast(Uint16, value);
+    }
+
+    /* check all instruction sets supported by the CPU (the scalar one is compared with itself) */
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+    const DiMonoKernels::E_InstructionSet supported = DiMonoKernels::getInstructionSet();
+    for (int level = DiMonoKernels::IS_Scalar; level <= supported; ++level)
+    {
+        DiMonoKernels::setMaxInstructionSet(OFstatic_cast(DiMonoKernels::E_InstructionSet, level));
+        OFCHECK_EQUAL(DiMonoKernels::getInstructionSet(), level);
+        checkKernels<Uint16, Uint8>(usrc, lut8, "Uint16/Uint8");
+        checkKernels<Uint16, Uint16>(usrc, lut16, "Uint16/Uint16");
+        checkKernels<Sint16, Uint8>(ssrc, lut8 + 32768, "Sint16/Uint8");
+        checkKernels<Sint16, Uint16>(ssrc, lut16 + 32768, "Sint16/Uint16");
+        checkMinMax<Uint8>(u8src, "Uint8");
+        checkMinMax<Sint8>(s8src, "Sint8");
+        checkMinMax<Uint16>(usrc, "Uint16");
+        checkMinMax<Sint16>(ssrc, "Sint16");
+    }
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+
+    delete[] lut8;
+    delete[] lut16;
+}
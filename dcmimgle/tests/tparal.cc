@@ -0,0 +1,208 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the rendering of monochrome images with multiple threads
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/ofstd/ofvector.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmimgle/dcmimage.h"
+#include "dcmtk/dcmimgle/diparal.h"
+
+
+/* image size, large enough to be split into several blocks */
+#define IMAGE_ROWS 600
+#define IMAGE_COLUMNS 500
+#define IMAGE_PIXELS (IMAGE_ROWS * IMAGE_COLUMNS)
+
+
+/* parallel loop counting how often each pixel has been processed */
+class CountingLoop
+  : public DiParallelLoop
+{
+
+ public:
+
+    CountingLoop(const unsigned long count,
+                 const Uint32 numberOfThreads)
+      : DiParallelLoop(count, numberOfThreads, 1000),
+        Counts(count, 0)
+    {
+    }
+
+    OFBool check(const int runs) const
+    {
+        for (size_t i = 0; i < Counts.size(); ++i)
+        {
+            if (Counts[i] != runs)
+                return OFFalse;
+        }
+        return OFTrue;
+    }
+
+ protected:
+
+    virtual void processBlock(const unsigned long /*block*/,
+                              const unsigned long start,
+                              const unsigned long end)
+    {
+        for (unsigned long i = start; i < end; ++i)
+            ++Counts[i];
+    }
+
+ private:
+
+    OFVector<int> Counts;
+};
+
+
+/* frame processor running a parallel loop for each frame (nested use of the thread pool) */
+class NestedLoops
+  : public DcmFrameProcessor
+{
+
+ public:
+
+ protected:
+
+    virtual OFCondition processFrame(Uint32 frameNo)
+    {
+        CountingLoop loop(10000 + frameNo, 4);
+        loop.run();
+        if (!loop.check(1))
+            return EC_IllegalCall;
+        return EC_Normal;
+    }
+};
+
+
+OFTEST(dcmimgle_parallelLoop)
+{
+    const unsigned long counts[4] = { 1, 999, 4001, 100003 };
+    for (int i = 0; i < 4; ++i)
+    {
+        for (Uint32 threads = 1; threads <= 8; ++threads)
+        {
+            /* run the same loop several times, every pixel has to be processed once per run */
+            CountingLoop loop(counts[i], threads);
+            for (int j = 0; j < 3; ++j)
+                loop.run();
+            if (!loop.check(3))
+                OFCHECK_FAIL("pixels not processed exactly once for " << counts[i] << " pixels and " << threads << " threads");
+        }
+    }
+    NestedLoops nested;
+    OFCHECK(nested.run(0, 16, 4).good());
+}
+
+
+/* create a monochrome image with noise and a gradient, stored with a rescale slope/intercept */
+static void createImage(DcmDataset &dset)
+{
+    Uint16 *pixels = new Uint16[IMAGE_PIXELS];
+    Uint32 seed = 4711;
+    for (unsigned long i = 0; i < IMAGE_PIXELS; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        pixels[i] = OFstatic_cast(Uint16, ((i % IMAGE_COLUMNS) * 4 + ((seed >> 16) & 0x3ff)) & 0x0fff);
+    }
+    /* a few outliers for the "next" min/max window */
+    pixels[IMAGE_PIXELS / 3] = 0;
+    pixels[IMAGE_PIXELS / 2] = 4095;
+    OFCHECK(dset.putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage).good());
+    OFCHECK(dset.putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2").good());
+    OFCHECK(dset.putAndInsertUint16(DCM_SamplesPerPixel, 1).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Rows, IMAGE_ROWS).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Columns, IMAGE_COLUMNS).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_BitsAllocated, 16).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_BitsStored, 12).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_HighBit, 11).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_PixelRepresentation, 0).good());
+    OFCHECK(dset.putAndInsertString(DCM_RescaleSlope, "1.5").good());
+    OFCHECK(dset.putAndInsertString(DCM_RescaleIntercept, "-1024").good());
+    OFCHECK(dset.putAndInsertUint16Array(DCM_PixelData, pixels, IMAGE_PIXELS).good());
+    delete[] pixels;
+}
+
+
+/* render the image with the given number of threads and VOI transformation */
+static void renderImage(DcmDataset &dset,
+                        const Uint32 threads,
+                        const int voi,
+                        const int bits,
+                        Uint8 *output,
+                        double &minValue,
+                        double &maxValue)
+{
+    dcmRenderingMaxThreads.set(threads);
+    DicomImage image(&dset, EXS_LittleEndianExplicit);
+    OFCHECK(image.getStatus() == EIS_Normal);
+    OFCHECK(image.getMinMaxValues(minValue, maxValue));
+    switch (voi)
+    {
+        case 0:
+            OFCHECK(image.setMinMaxWindow(0));
+            break;
+        case 1:
+            OFCHECK(image.setMinMaxWindow(1));
+            break;
+        case 2:
+            OFCHECK(image.setHistogramWindow(0.05));
+            break;
+        default:
+            OFCHECK(image.setWindow(500.0, 1200.0));
+            break;
+    }
+    OFCHECK_EQUAL(image.getOutputDataSize(bits), OFstatic_cast(unsigned long, IMAGE_PIXELS * bits / 8));
+    const void *data = image.getOutputData(bits);
+    OFCHECK(data != NULL);
+    if (data != NULL)
+        memcpy(output, data, IMAGE_PIXELS * bits / 8);
+    dcmRenderingMaxThreads.set(1);
+}
+
+
+OFTEST(dcmimgle_parallelRendering)
+{
+    DcmDataset dset;
+    createImage(dset);
+    const int bits[2] = { 8, 16 };
+    Uint8 *expected = new Uint8[IMAGE_PIXELS * 2];
+    Uint8 *result = new Uint8[IMAGE_PIXELS * 2];
+    for (int voi = 0; voi < 4; ++voi)
+    {
+        for (int b = 0; b < 2; ++b)
+        {
+            double expectedMin = 0, expectedMax = 0;
+            memset(expected, 0, IMAGE_PIXELS * 2);
+            renderImage(dset, 1, voi, bits[b], expected, expectedMin, expectedMax);
+            for (Uint32 threads = 2; threads <= 5; ++threads)
+            {
+                double resultMin = 0, resultMax = 0;
+                memset(result, 0xff, IMAGE_PIXELS * 2);
+                renderImage(dset, threads, voi, bits[b], result, resultMin, resultMax);
+                OFCHECK_EQUAL(expectedMin, resultMin);
+                OFCHECK_EQUAL(expectedMax, resultMax);
+                if (memcmp(expected, result, IMAGE_PIXELS * bits[b] / 8) != 0)
+                    OFCHECK_FAIL("output differs for VOI transformation " << voi << ", " << bits[b] << " bits and " << threads << " threads");
+            }
+        }
+    }
+    delete[] expected;
+    delete[] result;
+}
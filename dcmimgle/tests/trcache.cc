@@ -0,0 +1,284 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the render cache (keys, LRU eviction, spill files)
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTDIO
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+BEGIN_EXTERN_C
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>    /* for rmdir() */
+#endif
+END_EXTERN_C
+
+#ifdef _WIN32
+#include <direct.h>    /* for rmdir() */
+#endif
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/dcmimgle/dircache.h"
+
+
+/* private directory for the spill files of the tests */
+#define SPILL_DIRECTORY "trcache_spill"
+
+/* size of the frames used for the tests */
+#define FRAME_SIZE 100UL
+
+
+/* fill a frame with a pattern that depends on the given value */
+static void fillFrame(Uint8 *frame,
+                      const unsigned int value)
+{
+    for (unsigned long i = 0; i < FRAME_SIZE; ++i)
+        frame[i] = OFstatic_cast(Uint8, value * 31 + i);
+}
+
+
+/* add a frame with the given SOP instance UID and pattern to the cache */
+static OFBool putFrame(DiRenderCache &cache,
+                       const char *uid,
+                       const unsigned int value,
+                       const unsigned long size = FRAME_SIZE)
+{
+    Uint8 frame[FRAME_SIZE * 4];
+    for (unsigned long i = 0; i < size; i += FRAME_SIZE)
+        fillFrame(frame + i, value);
+    return cache.putData(DiRenderCacheKey(uid), frame, size);
+}
+
+
+/* check whether a frame with the given SOP instance UID and pattern is cached */
+static OFBool hasFrame(DiRenderCache &cache,
+                       const char *uid,
+                       const unsigned int value,
+                       const unsigned long size = FRAME_SIZE)
+{
+    Uint8 expected[FRAME_SIZE * 4];
+    Uint8 frame[FRAME_SIZE * 4];
+    for (unsigned long i = 0; i < size; i += FRAME_SIZE)
+        fillFrame(expected + i, value);
+    memset(frame, 0, sizeof(frame));
+    return cache.getData(DiRenderCacheKey(uid), frame, size) && (memcmp(frame, expected, OFstatic_cast(size_t, size)) == 0);
+}
+
+
+/* get the number of files in the spill directory */
+static size_t countSpillFiles()
+{
+    OFList<OFString> files;
+    return OFStandard::searchDirectoryRecursively(SPILL_DIRECTORY, files);
+}
+
+
+/* remove the spill directory including all files */
+static void removeSpillDirectory()
+{
+    OFList<OFString> files;
+    OFStandard::searchDirectoryRecursively(SPILL_DIRECTORY, files);
+    for (OFListIterator(OFString) it = files.begin(); it != files.end(); ++it)
+        OFStandard::deleteFile(*it);
+    rmdir(SPILL_DIRECTORY);
+}
+
+
+OFTEST(dcmimgle_renderCacheKey)
+{
+    const OFString reference = DiRenderCacheKey("1.2.3", 1, 128, 64, 8, 0).getString();
+    /* same parameters, same key */
+    OFCHECK_EQUAL(DiRenderCacheKey("1.2.3", 1, 128, 64, 8, 0).getString(), reference);
+    /* each parameter of the constructor is part of the key */
+    OFCHECK(DiRenderCacheKey("1.2.34", 1, 128, 64, 8, 0).getString() != reference);
+    OFCHECK(DiRenderCacheKey("1.2.3", 2, 128, 64, 8, 0).getString() != reference);
+    OFCHECK(DiRenderCacheKey("1.2.3", 1, 64, 128, 8, 0).getString() != reference);
+    OFCHECK(DiRenderCacheKey("1.2.3", 1, 128, 64, 16, 0).getString() != reference);
+    OFCHECK(DiRenderCacheKey("1.2.3", 1, 128, 64, 8, 1).getString() != reference);
+    OFCHECK(DiRenderCacheKey("1.2.3", 1, 128, 64, -1 /*MI_PastelColor*/, 0).getString() != reference);
+    /* the values are separated, i.e. "1.2.3" + frame 11 differs from "1.2.31" + frame 1 */
+    OFCHECK(DiRenderCacheKey("1.2.3", 11).getString() != DiRenderCacheKey("1.2.31", 1).getString());
+
+    DiRenderCacheKey key1("1.2.3");
+    DiRenderCacheKey key2("1.2.3");
+    /* interpolation */
+    key1.setInterpolation(1);
+    OFCHECK(key1.getString() != key2.getString());
+    key2.setInterpolation(1);
+    OFCHECK_EQUAL(key1.getString(), key2.getString());
+    /* window parameters are stored with full precision */
+    key1.setWindow(40.0, 400.0);
+    key2.setWindow(40.0 + 1e-12, 400.0);
+    OFCHECK(key1.getString() != key2.getString());
+    key2.setWindow(40.0, 400.0, EFV_Sigmoid);
+    OFCHECK(key1.getString() != key2.getString());
+    key2.setWindow(40.0, 400.0);
+    OFCHECK_EQUAL(key1.getString(), key2.getString());
+    /* stored window, VOI LUT and min-max window with the same index differ */
+    key1.setWindow(0UL);
+    key2.setVoiLut(0UL);
+    OFCHECK(key1.getString() != key2.getString());
+    key2.setMinMaxWindow(0);
+    OFCHECK(key1.getString() != key2.getString());
+    key1.setMinMaxWindow(1);
+    OFCHECK(key1.getString() != key2.getString());
+    key1.setMinMaxWindow(0);
+    OFCHECK_EQUAL(key1.getString(), key2.getString());
+    /* no VOI transformation differs from unspecified VOI transformation */
+    key1.setNoVoiTransformation();
+    OFCHECK(key1.getString() != DiRenderCacheKey("1.2.3").getString());
+    /* presentation LUT shape and polarity differ from unspecified values */
+    DiRenderCacheKey key3("1.2.3");
+    key3.setPresentationLutShape(ESP_Default);
+    OFCHECK(key3.getString() != reference);
+    OFCHECK(key3.getString() != DiRenderCacheKey("1.2.3").getString());
+    DiRenderCacheKey key4("1.2.3");
+    key4.setPolarity(EPP_Normal);
+    OFCHECK(key4.getString() != DiRenderCacheKey("1.2.3").getString());
+    key3.setPolarity(EPP_Normal);
+    key4.setPresentationLutShape(ESP_Default);
+    OFCHECK_EQUAL(key3.getString(), key4.getString());
+    /* further parameters */
+    key4.setFurtherParameters("overlay 1");
+    OFCHECK(key3.getString() != key4.getString());
+    key3.setFurtherParameters("overlay 1");
+    OFCHECK_EQUAL(key3.getString(), key4.getString());
+}
+
+
+OFTEST(dcmimgle_renderCacheEviction)
+{
+    DiRenderCache cache(3 * FRAME_SIZE);
+    OFCHECK(putFrame(cache, "1", 1));
+    OFCHECK(putFrame(cache, "2", 2));
+    OFCHECK(putFrame(cache, "3", 3));
+    OFCHECK_EQUAL(cache.getMemoryUsage(), 3 * FRAME_SIZE);
+    /* make frame 1 the most recently used one, so frame 2 is evicted next */
+    OFCHECK(hasFrame(cache, "1", 1));
+    OFCHECK(putFrame(cache, "4", 4));
+    OFCHECK_EQUAL(cache.getMemoryUsage(), 3 * FRAME_SIZE);
+    OFCHECK(!hasFrame(cache, "2", 2));
+    OFCHECK(hasFrame(cache, "1", 1));
+    OFCHECK(hasFrame(cache, "3", 3));
+    OFCHECK(hasFrame(cache, "4", 4));
+    /* frame 1 is now the least recently used one */
+    OFCHECK(putFrame(cache, "5", 5));
+    OFCHECK(!hasFrame(cache, "1", 1));
+    /* replace an existing frame */
+    OFCHECK(putFrame(cache, "3", 33));
+    OFCHECK_EQUAL(cache.getMemoryUsage(), 3 * FRAME_SIZE);
+    OFCHECK(hasFrame(cache, "3", 33));
+    /* the size has to match exactly */
+    Uint8 buffer[2 * FRAME_SIZE];
+    OFCHECK(!cache.getData(DiRenderCacheKey("3"), buffer, FRAME_SIZE - 1));
+    OFCHECK(!cache.getData(DiRenderCacheKey("3"), buffer, FRAME_SIZE + 1));
+    OFCHECK(!cache.getData(DiRenderCacheKey("3"), NULL, FRAME_SIZE));
+    /* a frame larger than the memory limit cannot be cached without spill directory */
+    OFCHECK(!putFrame(cache, "6", 6, 3 * FRAME_SIZE + 1));
+    OFCHECK_EQUAL(cache.getMemoryUsage(), 3 * FRAME_SIZE);
+    /* hits: 1, 1, 3, 4, 3 -- misses: 2, 1, 3 (three times) */
+    OFCHECK_EQUAL(cache.getHits(), 5);
+    OFCHECK_EQUAL(cache.getMisses(), 5);
+    cache.clear();
+    OFCHECK_EQUAL(cache.getMemoryUsage(), 0);
+    OFCHECK(!hasFrame(cache, "4", 4));
+}
+
+
+OFTEST(dcmimgle_renderCacheSpillFiles)
+{
+    removeSpillDirectory();
+    OFCHECK(OFStandard::createDirectory(SPILL_DIRECTORY, "").good());
+    {
+        DiRenderCache cache(2 * FRAME_SIZE, SPILL_DIRECTORY, 3 * FRAME_SIZE);
+        OFCHECK(putFrame(cache, "1", 1));
+        OFCHECK(putFrame(cache, "2", 2));
+        OFCHECK_EQUAL(countSpillFiles(), 0);
+        /* frame 1 is moved to a spill file */
+        OFCHECK(putFrame(cache, "3", 3));
+        OFCHECK_EQUAL(cache.getMemoryUsage(), 2 * FRAME_SIZE);
+        OFCHECK_EQUAL(cache.getDiskUsage(), FRAME_SIZE);
+        OFCHECK_EQUAL(countSpillFiles(), 1);
+        /* the spill files have unpredictable names */
+        OFList<OFString> files;
+        OFStandard::searchDirectoryRecursively(SPILL_DIRECTORY, files);
+        if (!files.empty())
+        {
+            OFString name;
+            OFStandard::getFilenameFromPath(name, files.front());
+            OFCHECK(name.compare(0, 6, "dcmrc_") == 0);
+            char predictable[64];
+            sprintf(predictable, "dcmrc_%ld_1.tmp", OFStandard::getProcessID());
+            OFCHECK(name != predictable);
+        }
+        /* frame 1 is restored from the spill file, frame 2 moved to a spill file instead */
+        OFCHECK(hasFrame(cache, "1", 1));
+        OFCHECK_EQUAL(cache.getMemoryUsage(), 2 * FRAME_SIZE);
+        OFCHECK_EQUAL(cache.getDiskUsage(), FRAME_SIZE);
+        OFCHECK_EQUAL(countSpillFiles(), 1);
+        OFCHECK(hasFrame(cache, "2", 2));
+        OFCHECK(hasFrame(cache, "3", 3));
+        /* frames larger than the memory limit are stored in a spill file directly */
+        OFCHECK(putFrame(cache, "4", 4, 3 * FRAME_SIZE));
+        OFCHECK_EQUAL(cache.getMemoryUsage(), 2 * FRAME_SIZE);
+        OFCHECK_EQUAL(cache.getDiskUsage(), 3 * FRAME_SIZE);
+        OFCHECK_EQUAL(countSpillFiles(), 1);
+        /* ... and stay there after being read */
+        OFCHECK(hasFrame(cache, "4", 4, 3 * FRAME_SIZE));
+        OFCHECK_EQUAL(cache.getDiskUsage(), 3 * FRAME_SIZE);
+        /* the disk limit removes the least recently used spill files */
+        OFCHECK(putFrame(cache, "5", 5));
+        OFCHECK_EQUAL(cache.getMemoryUsage(), 2 * FRAME_SIZE);
+        OFCHECK_EQUAL(cache.getDiskUsage(), FRAME_SIZE);
+        OFCHECK_EQUAL(countSpillFiles(), 1);
+        OFCHECK(!hasFrame(cache, "4", 4, 3 * FRAME_SIZE));
+        /* frames larger than the disk limit are not cached at all */
+        OFCHECK(!putFrame(cache, "6", 6, 3 * FRAME_SIZE + 1));
+        /* a missing spill file results in a cache miss */
+        OFCHECK(putFrame(cache, "7", 7));
+        OFCHECK_EQUAL(cache.getDiskUsage(), 2 * FRAME_SIZE);
+        files.clear();
+        OFStandard::searchDirectoryRecursively(SPILL_DIRECTORY, files);
+        for (OFListIterator(OFString) it = files.begin(); it != files.end(); ++it)
+            OFStandard::deleteFile(*it);
+        const unsigned long misses = cache.getMisses();
+        OFCHECK(!hasFrame(cache, "2", 2));
+        OFCHECK(!hasFrame(cache, "3", 3));
+        OFCHECK_EQUAL(cache.getMisses(), misses + 2);
+        OFCHECK_EQUAL(cache.getDiskUsage(), 0);
+        OFCHECK(hasFrame(cache, "5", 5));
+        OFCHECK(hasFrame(cache, "7", 7));
+        /* replacing a frame removes its spill file */
+        OFCHECK(putFrame(cache, "8", 8));
+        OFCHECK_EQUAL(countSpillFiles(), 1);
+        OFCHECK(putFrame(cache, "5", 55));
+        OFCHECK(hasFrame(cache, "5", 55));
+        OFCHECK(hasFrame(cache, "7", 7));
+        OFCHECK(hasFrame(cache, "8", 8));
+        /* clear() deletes all spill files */
+        cache.clear();
+        OFCHECK_EQUAL(cache.getMemoryUsage(), 0);
+        OFCHECK_EQUAL(cache.getDiskUsage(), 0);
+        OFCHECK_EQUAL(countSpillFiles(), 0);
+        /* the destructor deletes all spill files */
+        OFCHECK(putFrame(cache, "1", 1));
+        OFCHECK(putFrame(cache, "2", 2));
+        OFCHECK(putFrame(cache, "3", 3));
+        OFCHECK_EQUAL(countSpillFiles(), 1);
+    }
+    OFCHECK_EQUAL(countSpillFiles(), 0);
+    removeSpillDirectory();
+}
@@ -0,0 +1,196 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the scaling algorithms with interpolation
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmimgle/discalet.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
+#include "dcmtk/dcmimgle/diparal.h"
+
+
+/* size of the source image */
+#define SOURCE_COLUMNS 301
+#define SOURCE_ROWS 203
+
+
+/* create a source image with a gradient and noise covering the given number of bits */
+template<class T>
+static T *createImage(const Uint16 columns,
+                      const Uint16 rows,
+                      const int bits,
+                      const OFBool isSigned)
+{
+    T *image = new T[OFstatic_cast(unsigned long, columns) * rows];
+    const double range = OFstatic_cast(double, (bits < 32) ? (1UL << bits) - 1 : 0xffffffffUL);
+    const double offset = isSigned ? -range / 2 : 0;
+    Uint32 seed = 4711;
+    for (unsigned long i = 0; i < OFstatic_cast(unsigned long, columns) * rows; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        /* three quarters gradient, one quarter noise */
+        const double value = range * (0.75 * OFstatic_cast(double, i % columns) / columns + 0.25 * OFstatic_cast(double, seed >> 16) / 65535.0);
+        image[i] = OFstatic_cast(T, value + offset);
+    }
+    return image;
+}
+
+
+/* scale the given image with the given interpolation mode */
+template<class T>
+static void scaleImage(const T *source,
+                       T *result,
+                       const Uint16 destCols,
+                       const Uint16 destRows,
+                       const int bits,
+                       const int interpolate)
+{
+    const T *src[1] = { source };
+    T *dest[1] = { result };
+    DiScaleTemplate<T> scale(1, SOURCE_COLUMNS, SOURCE_ROWS, destCols, destRows, 1, bits);
+    scale.scaleData(src, dest, interpolate);
+}
+
+
+/* check that the output does not depend on the instruction set and the number of threads */
+template<class T>
+static void checkScaling(const char *typeName,
+                         const int bits,
+                         const OFBool isSigned)
+{
+    /* reduction (c't and box filter) and magnification (c't, bilinear and bicubic) */
+    const Uint16 destCols[5] = { 120, 120, 650, 650, 650 };
+    const Uint16 destRows[5] = { 80, 80, 450, 450, 450 };
+    const int modes[5] = { 2, 5, 2, 3, 4 };
+    const Uint32 threads[3] = { 1, 3, 4 };
+    T *source = createImage<T>(SOURCE_COLUMNS, SOURCE_ROWS, bits, isSigned);
+    for (int i = 0; i < 5; ++i)
+    {
+        const unsigned long count = OFstatic_cast(unsigned long, destCols[i]) * destRows[i];
+        T *expected = new T[count];
+        T *result = new T[count];
+        /* reference: generic version, single thread */
+        DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_Scalar);
+        dcmRenderingMaxThreads.set(1);
+        scaleImage(source, expected, destCols[i], destRows[i], bits, modes[i]);
+        DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+        const DiMonoKernels::E_InstructionSet supported = DiMonoKernels::getInstructionSet();
+        for (int level = DiMonoKernels::IS_Scalar; level <= supported; ++level)
+        {
+            DiMonoKernels::setMaxInstructionSet(OFstatic_cast(DiMonoKernels::E_InstructionSet, level));
+            for (int t = 0; t < 3; ++t)
+            {
+                dcmRenderingMaxThreads.set(threads[t]);
+                memset(result, 0, count * sizeof(T));
+                scaleImage(source, result, destCols[i], destRows[i], bits, modes[i]);
+                if (memcmp(expected, result, count * sizeof(T)) != 0)
+                {
+                    OFCHECK_FAIL("output of mode " << modes[i] << " differs for " << typeName << " to " << destCols[i] << "x" << destRows[i]
+                        << " with " << DiMonoKernels::getInstructionSetName(OFstatic_cast(DiMonoKernels::E_InstructionSet, level))
+                        << " and " << threads[t] << " threads");
+                }
+            }
+        }
+        DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+        dcmRenderingMaxThreads.set(1);
+        delete[] expected;
+        delete[] result;
+    }
+    delete[] source;
+}
+
+
+/* check that the box filter gives the same result as the c't reduction for integer factors */
+template<class T>
+static void checkBoxReduction(const char *typeName,
+                              const int bits,
+                              const OFBool isSigned)
+{
+    /* the source image is not an integer multiple of the destination, so only part of it is used */
+    const Uint16 xFactors[4] = { 2, 4, 3, 1 };
+    const Uint16 yFactors[4] = { 2, 2, 3, 5 };
+    T *source = createImage<T>(SOURCE_COLUMNS, SOURCE_ROWS, bits, isSigned);
+    for (int i = 0; i < 4; ++i)
+    {
+        /* clip the source image to a multiple of the factors */
+        const Uint16 srcCols = OFstatic_cast(Uint16, SOURCE_COLUMNS - SOURCE_COLUMNS % xFactors[i]);
+        const Uint16 srcRows = OFstatic_cast(Uint16, SOURCE_ROWS - SOURCE_ROWS % yFactors[i]);
+        const Uint16 destCols = OFstatic_cast(Uint16, srcCols / xFactors[i]);
+        const Uint16 destRows = OFstatic_cast(Uint16, srcRows / yFactors[i]);
+        const unsigned long count = OFstatic_cast(unsigned long, destCols) * destRows;
+        T *expected = new T[count];
+        T *result = new T[count];
+        const T *src[1] = { source };
+        T *dest[1] = { expected };
+        DiScaleTemplate<T> reduction(1, SOURCE_COLUMNS, SOURCE_ROWS, 0, 0, srcCols, srcRows, destCols, destRows, 1, bits);
+        reduction.scaleData(src, dest, 2 /* c't */);
+        dest[0] = result;
+        DiScaleTemplate<T> box(1, SOURCE_COLUMNS, SOURCE_ROWS, 0, 0, srcCols, srcRows, destCols, destRows, 1, bits);
+        box.scaleData(src, dest, 5 /* box filter */);
+        if (memcmp(expected, result, count * sizeof(T)) != 0)
+        {
+            OFCHECK_FAIL("box filter differs from c't reduction for " << typeName << " and factors "
+                << xFactors[i] << "x" << yFactors[i]);
+        }
+        delete[] expected;
+        delete[] result;
+    }
+    delete[] source;
+}
+
+
+OFTEST(dcmimgle_scaleThreadsAndInstructionSets)
+{
+    checkScaling<Uint8>("Uint8", 8, OFFalse);
+    checkScaling<Uint16>("Uint16", 12, OFFalse);
+    checkScaling<Sint16>("Sint16", 16, OFTrue);
+    checkScaling<Uint32>("Uint32", 20, OFFalse);
+}
+
+
+OFTEST(dcmimgle_scaleBoxReduction)
+{
+    checkBoxReduction<Uint8>("Uint8", 8, OFFalse);
+    checkBoxReduction<Uint16>("Uint16", 16, OFFalse);
+    checkBoxReduction<Sint16>("Sint16", 12, OFTrue);
+}
+
+
+OFTEST(dcmimgle_scaleBilinearLastColumn)
+{
+    /* each column has a different value, the rows are identical */
+    const Uint16 srcCols = 4;
+    const Uint16 srcRows = 2;
+    const Uint16 destCols = 10;
+    const Uint16 destRows = 4;
+    Uint16 source[srcCols * srcRows] = { 0, 100, 200, 300, 0, 100, 200, 300 };
+    Uint16 result[destCols * destRows];
+    const Uint16 *src[1] = { source };
+    Uint16 *dest[1] = { result };
+    DiScaleTemplate<Uint16> scale(1, srcCols, srcRows, destCols, destRows, 1, 16);
+    scale.scaleData(src, dest, 3 /* bilinear */);
+    for (Uint16 y = 0; y < destRows; ++y)
+    {
+        /* the first and the last column are copies of the first and the last source column */
+        OFCHECK_EQUAL(result[y * destCols], 0);
+        OFCHECK_EQUAL(result[y * destCols + destCols - 1], 300);
+        /* the values in between increase from left to right */
+        for (Uint16 x = 1; x < destCols; ++x)
+            OFCHECK(result[y * destCols + x] >= result[y * destCols + x - 1]);
+    }
+}
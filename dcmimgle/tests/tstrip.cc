@@ -0,0 +1,285 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the rendering of monochrome images strip by strip
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTDIO
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmimgle/dcmimage.h"
+#include "dcmtk/dcmimgle/diimage.h"
+#include "dcmtk/dcmimgle/diparal.h"
+#include "dcmtk/dcmimgle/diplugin.h"
+#include "dcmtk/dcmimgle/distrip.h"
+
+
+/* image size, the number of rows is not a multiple of the strip sizes used below */
+#define IMAGE_ROWS 257
+#define IMAGE_COLUMNS 300
+#define IMAGE_FRAMES 2
+#define IMAGE_PIXELS (IMAGE_ROWS * IMAGE_COLUMNS)
+
+/* number of VOI transformations tested (the last three with a presentation LUT) */
+#define VOI_COUNT 9
+
+
+/* "plugin" writing the strips returned by the strip renderer to the stream */
+class StripWriter
+  : public DiPluginFormat
+{
+
+ public:
+
+    StripWriter(const unsigned long rowsPerStrip,
+                const int bits)
+      : RowsPerStrip(rowsPerStrip),
+        Bits(bits)
+    {
+    }
+
+    virtual int write(DiImage *image,
+                      FILE *stream,
+                      const unsigned long frame) const
+    {
+        DiStripRenderer strips(image, frame, Bits, RowsPerStrip);
+        unsigned long nextRow = 0;
+        unsigned long firstRow = 0;
+        unsigned long rowCount = 0;
+        const void *data;
+        while ((data = strips.getNextStrip(firstRow, rowCount)) != NULL)
+        {
+            /* the strips are returned in the correct order */
+            if ((firstRow != nextRow) || (rowCount == 0) || (rowCount > strips.getRowsPerStrip()))
+                return 0;
+            if (fwrite(data, 1, strips.getRowSize() * rowCount, stream) != strips.getRowSize() * rowCount)
+                return 0;
+            nextRow += rowCount;
+        }
+        return (nextRow == image->getRows());
+    }
+
+ private:
+
+    const unsigned long RowsPerStrip;
+    const int Bits;
+};
+
+
+/* add an overlay plane with a checkerboard pattern */
+static void addOverlay(DcmDataset &dset,
+                       const Uint16 group,
+                       const Uint16 rows,
+                       const Uint16 columns,
+                       const Sint16 top,
+                       const Sint16 left)
+{
+    const unsigned long words = (OFstatic_cast(unsigned long, rows) * columns + 15) / 16;
+    Uint16 *data = new Uint16[words];
+    memset(data, 0, words * sizeof(Uint16));
+    for (unsigned long y = 0; y < rows; ++y)
+    {
+        for (unsigned long x = 0; x < columns; ++x)
+        {
+            const unsigned long i = y * columns + x;
+            if (((x / 3) + (y / 5)) % 2)
+                data[i / 16] |= OFstatic_cast(Uint16, 1 << (i % 16));
+        }
+    }
+    OFCHECK(dset.putAndInsertUint16(DcmTagKey(group, 0x0010), rows).good());
+    OFCHECK(dset.putAndInsertUint16(DcmTagKey(group, 0x0011), columns).good());
+    OFCHECK(dset.putAndInsertString(DcmTagKey(group, 0x0040), "G").good());
+    const Sint16 origin[2] = { top, left };
+    OFCHECK(dset.putAndInsertSint16Array(DcmTagKey(group, 0x0050), origin, 2).good());
+    OFCHECK(dset.putAndInsertUint16(DcmTagKey(group, 0x0100), 1).good());
+    OFCHECK(dset.putAndInsertUint16(DcmTagKey(group, 0x0102), 0).good());
+    OFCHECK(dset.putAndInsertUint16Array(DcmTag(group, 0x3000, EVR_OW), data, words).good());
+    delete[] data;
+}
+
+
+/* create a multi-frame monochrome image with noise and a gradient, a VOI LUT and two overlay planes */
+static void createImage(DcmDataset &dset)
+{
+    Uint16 *pixels = new Uint16[IMAGE_PIXELS * IMAGE_FRAMES];
+    Uint32 seed = 4711;
+    for (unsigned long i = 0; i < IMAGE_PIXELS * IMAGE_FRAMES; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        pixels[i] = OFstatic_cast(Uint16, ((i % IMAGE_COLUMNS) * 8 + (i / IMAGE_PIXELS) * 500 + ((seed >> 16) & 0x3ff)) & 0x0fff);
+    }
+    OFCHECK(dset.putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage).good());
+    OFCHECK(dset.putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2").good());
+    OFCHECK(dset.putAndInsertUint16(DCM_SamplesPerPixel, 1).good());
+    OFCHECK(dset.putAndInsertString(DCM_NumberOfFrames, "2").good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Rows, IMAGE_ROWS).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_Columns, IMAGE_COLUMNS).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_BitsAllocated, 16).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_BitsStored, 12).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_HighBit, 11).good());
+    OFCHECK(dset.putAndInsertUint16(DCM_PixelRepresentation, 0).good());
+    OFCHECK(dset.putAndInsertUint16Array(DCM_PixelData, pixels, IMAGE_PIXELS * IMAGE_FRAMES).good());
+    delete[] pixels;
+    /* VOI LUT with a non-linear curve */
+    Uint16 lut[4096];
+    for (int i = 0; i < 4096; ++i)
+        lut[i] = OFstatic_cast(Uint16, (i * i) / 4096);
+    DcmItem *item = NULL;
+    OFCHECK(dset.findOrCreateSequenceItem(DCM_VOILUTSequence, item).good());
+    if (item != NULL)
+    {
+        const Uint16 descriptor[3] = { 4096, 0, 12 };
+        OFCHECK(item->putAndInsertUint16Array(DCM_LUTDescriptor, descriptor, 3).good());
+        OFCHECK(item->putAndInsertUint16Array(DCM_LUTData, lut, 4096).good());
+    }
+    /* overlay planes crossing the strip boundaries and clipped at the image borders */
+    addOverlay(dset, 0x6000, 120, 100, 200, 230);
+    addOverlay(dset, 0x6002, 45, 60, -9, -19);
+}
+
+
+/* create a presentation LUT with a non-linear curve */
+static void createPresentationLut(DcmUnsignedShort &data,
+                                  DcmUnsignedShort &descriptor)
+{
+    Uint16 lut[256];
+    for (int i = 0; i < 256; ++i)
+        lut[i] = OFstatic_cast(Uint16, 4095 - (255 - i) * (255 - i) / 16);
+    const Uint16 values[3] = { 256, 0, 12 };
+    OFCHECK(data.putUint16Array(lut, 256).good());
+    OFCHECK(descriptor.putUint16Array(values, 3).good());
+}
+
+
+/* select the VOI transformation and presentation state of the image */
+static void setupImage(DicomImage &image,
+                       const int voi,
+                       const DcmUnsignedShort &plutData,
+                       const DcmUnsignedShort &plutDescriptor)
+{
+    OFCHECK_EQUAL(image.getOverlayCount(), 2);
+    OFCHECK(image.showAllOverlays() != 0);
+    switch (voi)
+    {
+        case 0:
+            OFCHECK(image.setWindow(1500.0, 2000.0));
+            break;
+        case 1:
+            OFCHECK(image.setWindow(2000.0, 1000.0));
+            OFCHECK(image.setPolarity(EPP_Reverse));
+            break;
+        case 2:
+            OFCHECK(image.setVoiLutFunction(EFV_Sigmoid));
+            OFCHECK(image.setWindow(2000.0, 1500.0));
+            break;
+        case 3:
+            OFCHECK(image.setVoiLut(0));
+            break;
+        case 4:
+            OFCHECK(image.setNoVoiTransformation());
+            OFCHECK(image.setPresentationLutShape(ESP_Inverse));
+            break;
+        case 5:
+            OFCHECK(image.setNoVoiTransformation());
+            break;
+        case 6:
+            OFCHECK(image.setWindow(1500.0, 2000.0));
+            OFCHECK(image.setPresentationLut(plutData, plutDescriptor));
+            break;
+        case 7:
+            OFCHECK(image.setVoiLut(0));
+            OFCHECK(image.setPresentationLut(plutData, plutDescriptor));
+            break;
+        default:
+            OFCHECK(image.setNoVoiTransformation());
+            OFCHECK(image.setInversePresentationLut(plutData, plutDescriptor));
+            break;
+    }
+}
+
+
+OFTEST(dcmimgle_stripRendering)
+{
+    DcmDataset dset;
+    createImage(dset);
+    DcmUnsignedShort plutData(DCM_LUTData);
+    DcmUnsignedShort plutDescriptor(DCM_LUTDescriptor);
+    createPresentationLut(plutData, plutDescriptor);
+    const int bits[3] = { 8, 12, 16 };
+    const unsigned long rowsPerStrip[5] = { 1, 7, 64, 256, IMAGE_ROWS };
+    Uint8 *expected = new Uint8[IMAGE_PIXELS * 2];
+    Uint8 *result = new Uint8[IMAGE_PIXELS * 2];
+    for (int voi = 0; voi < VOI_COUNT; ++voi)
+    {
+        for (int b = 0; b < 3; ++b)
+        {
+            const unsigned long rowSize = IMAGE_COLUMNS * ((bits[b] > 8) ? 2 : 1);
+            for (unsigned long frame = 0; frame < IMAGE_FRAMES; ++frame)
+            {
+                /* render the complete frame */
+                DicomImage image(&dset, EXS_LittleEndianExplicit);
+                OFCHECK(image.getStatus() == EIS_Normal);
+                setupImage(image, voi, plutData, plutDescriptor);
+                OFCHECK_EQUAL(image.getOutputDataSize(bits[b]), rowSize * IMAGE_ROWS);
+                const void *data = image.getOutputData(bits[b], frame);
+                OFCHECK(data != NULL);
+                if (data == NULL)
+                    continue;
+                memcpy(expected, data, rowSize * IMAGE_ROWS);
+                image.deleteOutputData();
+                for (int s = 0; s < 5; ++s)
+                {
+                    /* render the frame strip by strip, the last strip might contain less rows */
+                    memset(result, 0xaa, rowSize * IMAGE_ROWS);
+                    for (unsigned long firstRow = 0; firstRow < IMAGE_ROWS; firstRow += rowsPerStrip[s])
+                    {
+                        const unsigned long rowCount = (firstRow + rowsPerStrip[s] <= IMAGE_ROWS) ? rowsPerStrip[s] : IMAGE_ROWS - firstRow;
+                        OFCHECK(image.getOutputRows(result + firstRow * rowSize, rowCount * rowSize, firstRow, rowCount, bits[b], frame));
+                    }
+                    if (memcmp(expected, result, rowSize * IMAGE_ROWS) != 0)
+                    {
+                        OFCHECK_FAIL("rendered rows differ for VOI transformation " << voi << ", " << bits[b] << " bits, frame "
+                            << frame << " and " << rowsPerStrip[s] << " rows per strip");
+                    }
+                    /* use the strip renderer (with and without a separate rendering thread) */
+                    for (Uint32 threads = 1; threads <= 2; ++threads)
+                    {
+                        dcmRenderingMaxThreads.set(threads);
+                        FILE *stream = tmpfile();
+                        OFCHECK(stream != NULL);
+                        if (stream == NULL)
+                            break;
+                        StripWriter writer(rowsPerStrip[s], bits[b]);
+                        OFCHECK(image.writePluginFormat(&writer, stream, frame));
+                        memset(result, 0xaa, rowSize * IMAGE_ROWS);
+                        rewind(stream);
+                        OFCHECK_EQUAL(fread(result, 1, rowSize * IMAGE_ROWS + 1, stream), rowSize * IMAGE_ROWS);
+                        fclose(stream);
+                        if (memcmp(expected, result, rowSize * IMAGE_ROWS) != 0)
+                        {
+                            OFCHECK_FAIL("rendered strips differ for VOI transformation " << voi << ", " << bits[b] << " bits, frame "
+                                << frame << ", " << rowsPerStrip[s] << " rows per strip and " << threads << " threads");
+                        }
+                    }
+                    dcmRenderingMaxThreads.set(1);
+                }
+            }
+        }
+    }
+    delete[] expected;
+    delete[] result;
+}
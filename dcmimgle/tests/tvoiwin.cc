@@ -0,0 +1,207 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the cached pixel statistics used for automatic VOI windows
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmimgle/dcmimage.h"
+#include "dcmtk/dcmimgle/dipixel.h"
+
+
+/* size of the test image */
+#define COLUMNS 300
+#define ROWS 200
+#define COUNT (COLUMNS * ROWS)
+
+/* global minimum and maximum pixel value */
+#define GLOBAL_MIN 100
+#define GLOBAL_MAX 4000
+
+
+/* get the window of the image */
+static void getWindow(DicomImage &image,
+                      double &center,
+                      double &width)
+{
+    center = 0;
+    width = 0;
+    OFCHECK(image.getWindow(center, width));
+}
+
+
+/* determine the next minimum and maximum pixel value, i.e. ignoring the global extremes */
+static void nextMinMax(const Uint16 *data,
+                       Uint16 &min,
+                       Uint16 &max)
+{
+    min = GLOBAL_MAX;
+    max = GLOBAL_MIN;
+    for (unsigned long i = 0; i < COUNT; ++i)
+    {
+        if ((data[i] > GLOBAL_MIN) && (data[i] < min))
+            min = data[i];
+        if ((data[i] < GLOBAL_MAX) && (data[i] > max))
+            max = data[i];
+    }
+}
+
+
+/* determine the histogram window, ignoring 'thresh' pixels at both ends */
+static void histogramWindow(const Uint16 *data,
+                            const double thresh,
+                            double &center,
+                            double &width)
+{
+    OFVector<Uint32> histogram(GLOBAL_MAX - GLOBAL_MIN + 1, 0);
+    for (unsigned long i = 0; i < COUNT; ++i)
+        ++histogram[data[i] - GLOBAL_MIN];
+    const Uint32 threshvalue = OFstatic_cast(Uint32, thresh * COUNT);
+    Uint32 t = 0;
+    unsigned long i = 0;
+    while (t < threshvalue)
+        t += histogram[i++];
+    const double min = GLOBAL_MIN + i;
+    t = 0;
+    i = histogram.size();
+    while (t < threshvalue)
+        t += histogram[--i];
+    const double max = GLOBAL_MIN + i;
+    center = (min + max + 1) / 2;
+    width = max - min + 1;
+}
+
+
+/* determine the window of the given region of interest */
+static void roiWindow(const Uint16 *data,
+                      const unsigned long left,
+                      const unsigned long top,
+                      const unsigned long width,
+                      const unsigned long height,
+                      double &voiCenter,
+                      double &voiWidth)
+{
+    Uint16 min = data[top * COLUMNS + left];
+    Uint16 max = min;
+    for (unsigned long y = top; y < top + height; ++y)
+    {
+        for (unsigned long x = left; x < left + width; ++x)
+        {
+            const Uint16 value = data[y * COLUMNS + x];
+            if (value < min)
+                min = value;
+            if (value > max)
+                max = value;
+        }
+    }
+    voiCenter = (OFstatic_cast(double, min) + OFstatic_cast(double, max) + 1) / 2;
+    voiWidth = OFstatic_cast(double, max) - OFstatic_cast(double, min) + 1;
+}
+
+
+/* compare all automatically computed windows with the values determined from the pixel data */
+static void checkWindows(DicomImage &image,
+                         const Uint16 *data,
+                         const char *state)
+{
+    double center, width, expectedCenter, expectedWidth;
+    double min = 0, max = 0;
+    /* the global minimum and maximum are kept */
+    OFCHECK(image.getMinMaxValues(min, max));
+    OFCHECK_EQUAL(min, GLOBAL_MIN);
+    OFCHECK_EQUAL(max, GLOBAL_MAX);
+    /* next minimum and maximum */
+    Uint16 nextMin, nextMax;
+    nextMinMax(data, nextMin, nextMax);
+    OFCHECK(image.setMinMaxWindow(1));
+    getWindow(image, center, width);
+    if ((center != (nextMin + nextMax + 1) / 2.0) || (width != nextMax - nextMin + 1))
+        OFCHECK_FAIL("next min-max window differs " << state);
+    /* histogram window */
+    OFCHECK(image.setHistogramWindow(0.05));
+    getWindow(image, center, width);
+    histogramWindow(data, 0.05, expectedCenter, expectedWidth);
+    if ((center != expectedCenter) || (width != expectedWidth))
+        OFCHECK_FAIL("histogram window differs " << state);
+    /* the next minimum and maximum are also taken from the histogram */
+    OFCHECK(image.setMinMaxWindow(1));
+    getWindow(image, center, width);
+    if ((center != (nextMin + nextMax + 1) / 2.0) || (width != nextMax - nextMin + 1))
+        OFCHECK_FAIL("next min-max window (from histogram) differs " << state);
+    /* region of interest (large enough to use the tiles) */
+    OFCHECK(image.setRoiWindow(37, 21, 200, 150));
+    getWindow(image, center, width);
+    roiWindow(data, 37, 21, 200, 150, expectedCenter, expectedWidth);
+    if ((center != expectedCenter) || (width != expectedWidth))
+        OFCHECK_FAIL("ROI window differs " << state);
+}
+
+
+OFTEST(dcmimgle_voiWindowsAfterModification)
+{
+    Uint16 *pixels = new Uint16[COUNT];
+    Uint32 seed = 4711;
+    for (unsigned long i = 0; i < COUNT; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        pixels[i] = OFstatic_cast(Uint16, 1000 + (seed >> 16) % 2000);
+    }
+    pixels[0] = GLOBAL_MIN;
+    pixels[COUNT - 1] = GLOBAL_MAX;
+    DcmDataset dset;
+    dset.putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+    dset.putAndInsertUint16(DCM_SamplesPerPixel, 1);
+    dset.putAndInsertUint16(DCM_Rows, ROWS);
+    dset.putAndInsertUint16(DCM_Columns, COLUMNS);
+    dset.putAndInsertUint16(DCM_BitsAllocated, 16);
+    dset.putAndInsertUint16(DCM_BitsStored, 12);
+    dset.putAndInsertUint16(DCM_HighBit, 11);
+    dset.putAndInsertUint16(DCM_PixelRepresentation, 0);
+    dset.putAndInsertUint16Array(DCM_PixelData, pixels, COUNT);
+    delete[] pixels;
+    DicomImage image(&dset, EXS_LittleEndianExplicit);
+    OFCHECK(image.getStatus() == EIS_Normal);
+    DiPixel *inter = OFconst_cast(DiPixel *, image.getInterData());
+    OFCHECK(inter != NULL);
+    if ((inter == NULL) || (inter->getRepresentation() != EPR_Uint16) || (inter->getCount() != COUNT))
+    {
+        OFCHECK_FAIL("unexpected representation of the intermediate pixel data");
+        return;
+    }
+    checkWindows(image, OFstatic_cast(const Uint16 *, inter->getData()), "initially");
+
+    /* modify the pixel data, the global extreme values are kept */
+    Uint16 *data = OFstatic_cast(Uint16 *, inter->getDataPtr());
+    for (unsigned long i = 1; i < COUNT - 1; ++i)
+        data[i] = OFstatic_cast(Uint16, (data[i] < 2000) ? data[i] / 2 + 200 : data[i] + 900);
+    data[COUNT / 2] = GLOBAL_MIN + 1;
+    data[COUNT / 2 + 1] = GLOBAL_MAX - 1;
+    checkWindows(image, data, "after modifying the pixel data");
+
+    /* flip and rotate the image, which moves the pixels (and the tiles) */
+    OFCHECK(image.flipImage(1, 0));
+    checkWindows(image, OFstatic_cast(const Uint16 *, inter->getData()), "after flipping the image");
+    OFCHECK(image.rotateImage(180));
+    checkWindows(image, OFstatic_cast(const Uint16 *, inter->getData()), "after rotating the image");
+
+    /* modify the pixel data again, after the histogram and the tiles have been determined */
+    data = OFstatic_cast(Uint16 *, inter->getDataPtr());
+    for (unsigned long i = 0; i < COUNT; ++i)
+    {
+        if ((data[i] != GLOBAL_MIN) && (data[i] != GLOBAL_MAX))
+            data[i] = OFstatic_cast(Uint16, GLOBAL_MIN + 500 + (i % 1000));
+    }
+    checkWindows(image, data, "after modifying the pixel data again");
+}
@@ -0,0 +1,301 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmimgle
+ *
+ *  Author:  agent
+ *
+ *  Purpose: Measure the throughput of the monochrome VOI rendering kernels
+ *           and of the pixel statistics used for automatic VOI windows
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/ofstream.h"
+#include "dcmtk/ofstd/oftimer.h"
+#include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmimgle/dcmimage.h"
+#include "dcmtk/dcmimgle/dimokrnl.h"
+#include "dcmtk/dcmimgle/diparal.h"
+
+#define INCLUDE_CSTDLIB
+#define INCLUDE_CSTRING
+#define INCLUDE_CSTDIO
+#include "dcmtk/ofstd/ofstdinc.h"
+
+
+/* number of pixels per second in millions */
+static double mpixels(const unsigned long count, const int iterations, const double seconds)
+{
+    return (seconds > 0) ? OFstatic_cast(double, count) * iterations / seconds / 1000000.0 : 0;
+}
+
+
+/* print one line of the result table */
+static void report(const char *kernel, const char *types, const DiMonoKernels::E_InstructionSet instructionSet,
+                   const double throughput, const OFBool ok)
+{
+    char line[128];
+    sprintf(line, "%-10s %-18s %-8s %10.1f Mpixels/s  %s", kernel, types,
+        DiMonoKernels::getInstructionSetName(instructionSet), throughput, ok ? "ok" : "MISMATCH");
+    COUT << line << OFendl;
+}
+
+
+/* measure the LUT and window kernels for one combination of input and output type,
+ * the results of the vectorized versions are compared with the generic version
+ */
+template<class T1, class T3>
+static OFBool benchmarkKernels(const char *types,
+                               const T1 *src,
+                               const unsigned long count,
+                               const double absmin,
+                               const unsigned long ocnt,
+                               const T3 maxvalue,
+                               const int iterations)
+{
+    OFBool result = OFTrue;
+    const double leftBorder = absmin + ocnt / 4;
+    const double rightBorder = absmin + ocnt / 2;
+    const double gradient = maxvalue / (rightBorder - leftBorder);
+    const double offset = -leftBorder * gradient;
+    T3 *lut = new T3[ocnt + 4];
+    for (unsigned long i = 0; i < ocnt; ++i)
+        lut[i] = OFstatic_cast(T3, (OFstatic_cast(double, i) * maxvalue) / ocnt);
+    const T3 *lut0 = lut - OFstatic_cast(long, absmin);
+    T3 *expected = new T3[count];
+    T3 *dst = new T3[count];
+    for (int kernel = 0; kernel < 2; ++kernel)
+    {
+        if (kernel == 0)
+            DiMonoKernels::applyLUT<T1, T3>(src, expected, count, lut0);
+        else
+            DiMonoKernels::applyWindow<T1, T3>(src, expected, count, leftBorder, rightBorder, offset, gradient, 0, maxvalue);
+        for (int i = DiMonoKernels::IS_Scalar; i <= DiMonoKernels::IS_AVX2; ++i)
+        {
+            DiMonoKernels::setMaxInstructionSet(OFstatic_cast(DiMonoKernels::E_InstructionSet, i));
+            if (DiMonoKernels::getInstructionSet() != i)
+                continue;
+            memset(dst, 0, count * sizeof(T3));
+            OFTimer timer;
+            for (int j = 0; j < iterations; ++j)
+            {
+                if (kernel == 0)
+                    DiMonoKernels::applyLUT(src, dst, count, lut0);
+                else
+                    DiMonoKernels::applyWindow(src, dst, count, leftBorder, rightBorder, offset, gradient, 0, maxvalue);
+            }
+            const double seconds = timer.getDiff();
+            const OFBool ok = (memcmp(dst, expected, count * sizeof(T3)) == 0);
+            report((kernel == 0) ? "LUT" : "window", types, DiMonoKernels::getInstructionSet(),
+                mpixels(count, iterations, seconds), ok);
+            result &= ok;
+        }
+    }
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+    delete[] dst;
+    delete[] expected;
+    delete[] lut;
+    return result;
+}
+
+
+/* measure the minimum/maximum kernel for one input type,
+ * the results of the vectorized versions are compared with the generic version
+ */
+template<class T>
+static OFBool benchmarkMinMax(const char *types,
+                              const T *src,
+                              const unsigned long count,
+                              const int iterations)
+{
+    OFBool result = OFTrue;
+    T expectedMin = 0;
+    T expectedMax = 0;
+    DiMonoKernels::determineMinMax<T>(src, count, expectedMin, expectedMax);
+    for (int i = DiMonoKernels::IS_Scalar; i <= DiMonoKernels::IS_AVX2; ++i)
+    {
+        DiMonoKernels::setMaxInstructionSet(OFstatic_cast(DiMonoKernels::E_InstructionSet, i));
+        if (DiMonoKernels::getInstructionSet() != i)
+            continue;
+        T minvalue = 0;
+        T maxvalue = 0;
+        OFTimer timer;
+        for (int j = 0; j < iterations; ++j)
+            DiMonoKernels::determineMinMax(src, count, minvalue, maxvalue);
+        const double seconds = timer.getDiff();
+        const OFBool ok = (minvalue == expectedMin) && (maxvalue == expectedMax);
+        report("min/max", types, DiMonoKernels::getInstructionSet(), mpixels(count, iterations, seconds), ok);
+        result &= ok;
+    }
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+    return result;
+}
+
+
+/* measure the repeated computation of the automatic VOI windows (min-max, histogram
+ * and ROI) of a 16 bit image, the results are compared with those of the first call
+ */
+static OFBool benchmarkAutoWindows(const Uint16 *pixels,
+                                   const Uint16 columns,
+                                   const Uint16 rows,
+                                   const int iterations)
+{
+    DcmDataset dset;
+    dset.putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+    dset.putAndInsertUint16(DCM_SamplesPerPixel, 1);
+    dset.putAndInsertUint16(DCM_Rows, rows);
+    dset.putAndInsertUint16(DCM_Columns, columns);
+    dset.putAndInsertUint16(DCM_BitsAllocated, 16);
+    dset.putAndInsertUint16(DCM_BitsStored, 12);
+    dset.putAndInsertUint16(DCM_HighBit, 11);
+    dset.putAndInsertUint16(DCM_PixelRepresentation, 0);
+    dset.putAndInsertUint16Array(DCM_PixelData, pixels, OFstatic_cast(unsigned long, columns) * rows);
+    DicomImage image(&dset, EXS_LittleEndianExplicit);
+    if (image.getStatus() != EIS_Normal)
+    {
+        CERR << "Error: cannot create image: " << DicomImage::getString(image.getStatus()) << OFendl;
+        return OFFalse;
+    }
+    const unsigned long count = OFstatic_cast(unsigned long, columns) * rows;
+    double expected[6];
+    double values[6];
+    OFTimer timer;
+    for (int j = 0; j < iterations; ++j)
+    {
+        image.setMinMaxWindow(1);
+        image.getWindow(values[0], values[1]);
+        image.setHistogramWindow(0.05);
+        image.getWindow(values[2], values[3]);
+        image.setRoiWindow(columns / 8, rows / 8, columns / 2, rows / 2);
+        image.getWindow(values[4], values[5]);
+        if (j == 0)
+            memcpy(expected, values, sizeof(values));
+    }
+    const double seconds = timer.getDiff();
+    const OFBool ok = (iterations == 0) || (memcmp(values, expected, sizeof(values)) == 0);
+    report("autowindow", "Uint16 (12 bit)", DiMonoKernels::getInstructionSet(), mpixels(count, iterations, seconds), ok);
+    return ok;
+}
+
+
+/* measure the complete rendering of a 16 bit image with a linear VOI window
+ */
+static OFBool benchmarkRendering(const Uint16 *pixels,
+                                 const Uint16 columns,
+                                 const Uint16 rows,
+                                 const OFBool isSigned,
+                                 const int bits,
+                                 const int iterations)
+{
+    OFBool result = OFTrue;
+    DcmDataset dset;
+    dset.putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+    dset.putAndInsertUint16(DCM_SamplesPerPixel, 1);
+    dset.putAndInsertUint16(DCM_Rows, rows);
+    dset.putAndInsertUint16(DCM_Columns, columns);
+    dset.putAndInsertUint16(DCM_BitsAllocated, 16);
+    dset.putAndInsertUint16(DCM_BitsStored, 16);
+    dset.putAndInsertUint16(DCM_HighBit, 15);
+    dset.putAndInsertUint16(DCM_PixelRepresentation, isSigned ? 1 : 0);
+    dset.putAndInsertUint16Array(DCM_PixelData, pixels, OFstatic_cast(unsigned long, columns) * rows);
+    DicomImage image(&dset, EXS_LittleEndianExplicit);
+    if (image.getStatus() != EIS_Normal)
+    {
+        CERR << "Error: cannot create image: " << DicomImage::getString(image.getStatus()) << OFendl;
+        return OFFalse;
+    }
+    image.setWindow(isSigned ? 40 : 2048, isSigned ? 400 : 1024);
+    const unsigned long count = OFstatic_cast(unsigned long, columns) * rows;
+    const size_t size = image.getOutputDataSize(bits);
+    Uint8 *expected = new Uint8[size];
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_Scalar);
+    image.getOutputData(expected, size, bits);
+    char types[32];
+    sprintf(types, "%s -> %i bit", isSigned ? "Sint16" : "Uint16", bits);
+    for (int i = DiMonoKernels::IS_Scalar; i <= DiMonoKernels::IS_AVX2; ++i)
+    {
+        DiMonoKernels::setMaxInstructionSet(OFstatic_cast(DiMonoKernels::E_InstructionSet, i));
+        if (DiMonoKernels::getInstructionSet() != i)
+            continue;
+        OFTimer timer;
+        const void *data = NULL;
+        for (int j = 0; j < iterations; ++j)
+            data = image.getOutputData(bits);
+        const double seconds = timer.getDiff();
+        const OFBool ok = (data != NULL) && (memcmp(data, expected, size) == 0);
+        report("rendering", types, DiMonoKernels::getInstructionSet(), mpixels(count, iterations, seconds), ok);
+        result &= ok;
+    }
+    DiMonoKernels::setMaxInstructionSet(DiMonoKernels::IS_AVX2);
+    delete[] expected;
+    return result;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long columns = 2048;
+    unsigned long rows = 2048;
+    int iterations = 10;
+    if ((argc > 1) && ((argc < 3) || (argc > 5) || (atol(argv[1]) <= 0) || (atol(argv[2]) <= 0) || (atol(argv[1]) > 65535) ||
+        (atol(argv[2]) > 65535) || ((argc >= 4) && (atoi(argv[3]) <= 0)) || ((argc == 5) && (atoi(argv[4]) <= 0))))
+    {
+        COUT << "voibench: Measure the throughput of the monochrome VOI rendering kernels" << OFendl;
+        COUT << "usage: voibench [columns rows [iterations [threads]]]" << OFendl;
+        return 1;
+    }
+    if (argc > 2)
+    {
+        columns = atol(argv[1]);
+        rows = atol(argv[2]);
+    }
+    if (argc > 3)
+        iterations = atoi(argv[3]);
+    if (argc > 4)
+        dcmRenderingMaxThreads.set(OFstatic_cast(Uint32, atoi(argv[4])));
+
+    /* make sure data dictionary is loaded */
+    if (!dcmDataDict.isDictionaryLoaded())
+    {
+        CERR << "Warning: no data dictionary loaded, "
+             << "check environment variable: "
+             << DCM_DICT_ENVIRONMENT_VARIABLE << OFendl;
+    }
+
+    /* create pixel data with a simple pseudo random generator, so the results are reproducible */
+    const unsigned long count = columns * rows;
+    Uint16 *pixels = new Uint16[count];
+    Uint32 seed = 1;
+    for (unsigned long i = 0; i < count; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        pixels[i] = OFstatic_cast(Uint16, seed >> 16);
+    }
+    const Sint16 *spixels = OFreinterpret_cast(const Sint16 *, pixels);
+
+    COUT << "image size: " << columns << " x " << rows << ", " << iterations << " iterations, " << dcmRenderingMaxThreads.get()
+         << " rendering thread(s), best instruction set: "
+         << DiMonoKernels::getInstructionSetName(DiMonoKernels::getInstructionSet()) << OFendl;
+    OFBool ok = OFTrue;
+    ok &= benchmarkKernels<Uint16, Uint8>("Uint16 -> Uint8", pixels, count, 0, 65536, 255, iterations);
+    ok &= benchmarkKernels<Sint16, Uint8>("Sint16 -> Uint8", spixels, count, -32768, 65536, 255, iterations);
+    ok &= benchmarkKernels<Uint16, Uint16>("Uint16 -> Uint16", pixels, count, 0, 65536, 65535, iterations);
+    ok &= benchmarkKernels<Sint16, Uint16>("Sint16 -> Uint16", spixels, count, -32768, 65536, 65535, iterations);
+    ok &= benchmarkMinMax<Uint8>("Uint8", OFreinterpret_cast(const Uint8 *, pixels), 2 * count, iterations);
+    ok &= benchmarkMinMax<Sint8>("Sint8", OFreinterpret_cast(const Sint8 *, pixels), 2 * count, iterations);
+    ok &= benchmarkMinMax<Uint16>("Uint16", pixels, count, iterations);
+    ok &= benchmarkMinMax<Sint16>("Sint16", spixels, count, iterations);
+    ok &= benchmarkAutoWindows(pixels, OFstatic_cast(Uint16, columns), OFstatic_cast(Uint16, rows), iterations);
+    ok &= benchmarkRendering(pixels, OFstatic_cast(Uint16, columns), OFstatic_cast(Uint16, rows), OFFalse, 8, iterations);
+    ok &= benchmarkRendering(pixels, OFstatic_cast(Uint16, columns), OFstatic_cast(Uint16, rows), OFTrue, 8, iterations);
+    ok &= benchmarkRendering(pixels, OFstatic_cast(Uint16, columns), OFstatic_cast(Uint16, rows), OFTrue, 16, iterations);
+    delete[] pixels;
+    return ok ? 0 : 2;
+}
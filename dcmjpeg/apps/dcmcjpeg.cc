@@ -34,6 +34,7 @@
 #include "dcmtk/dcmdata/cmdlnarg.h"
 #include "dcmtk/ofstd/ofconapp.h"
 #include "dcmtk/dcmdata/dcuid.h"     /* for dcmtk version name */
+#include "dcmtk/dcmdata/dcfrmpar.h"  /* for dcmCodecMaxThreads */
 #include "dcmtk/dcmjpeg/djdecode.h"  /* for dcmjpeg decoders */
 #include "dcmtk/dcmjpeg/djencode.h"  /* for dcmjpeg encoders */
 #include "dcmtk/dcmjpeg/djrplol.h"   /* for DJ_RPLossless */
@@ -93,6 +94,7 @@ int main(int argc, char *argv[])
   E_SubSampling    opt_sampleFactors = ESS_444;
   OFBool           opt_useYBR422 = OFFalse;
   OFCmdUnsignedInt opt_fragmentSize = 0; // 0=unlimited
+  OFCmdUnsignedInt opt_threads = 1;
   OFBool           opt_createOffsetTable = OFTrue;
   int              opt_windowType = 0;  /* default: no windowing; 1=Wi, 2=Wl, 3=Wm, 4=Wh, 5=Ww, 6=Wn, 7=Wr */
   OFCmdUnsignedInt opt_windowParameter = 0;
@@ -197,6 +199,9 @@ int main(int argc, char *argv[])
     cmd.addSubGroup("basic offset table encoding:");
       cmd.addOption("--offset-table-create", "+ot",    "create offset table (default)");
       cmd.addOption("--offset-table-empty",  "-ot",    "leave offset table empty");
+    cmd.addSubGroup("multi-frame images:");
+      cmd.addOption("--threads",             "+mt", 1, "[n]umber: integer (default: 1)",
+                                                       "compress up to n frames in parallel");
 
     cmd.addSubGroup("VOI windowing for monochrome images (not with +tl):");
       cmd.addOption("--no-windowing",        "-W",     "no VOI windowing (default)");
@@ -488,6 +493,12 @@ int main(int argc, char *argv[])
       if (cmd.findOption("--offset-table-empty")) opt_createOffsetTable = OFFalse;
       cmd.endOptionBlock();
 
+      if (cmd.findOption("--threads"))
+      {
+        app.checkValue(cmd.getValueAndCheckMin(opt_threads, 1));
+        dcmCodecMaxThreads.set(OFstatic_cast(Uint32, opt_threads));
+      }
+
       cmd.beginOptionBlock();
       if (cmd.findOption("--no-windowing")) opt_windowType = 0;
       if (cmd.findOption("--use-window"))
@@ -34,6 +34,7 @@
 #include "dcmtk/dcmdata/cmdlnarg.h"
 #include "dcmtk/ofstd/ofconapp.h"
 #include "dcmtk/dcmdata/dcuid.h"       /* for dcmtk version name */
+#include "dcmtk/dcmdata/dcfrmpar.h"    /* for dcmCodecMaxThreads */
 #include "dcmtk/dcmjpeg/djdecode.h"    /* for dcmjpeg decoders */
 #include "dcmtk/dcmjpeg/dipijpeg.h"    /* for dcmimage JPEG plugin */
 
@@ -80,6 +81,7 @@ int main(int argc, char *argv[])
   E_UIDCreation opt_uidcreation = EUC_default;
   E_PlanarConfiguration opt_planarconfig = EPC_default;
   OFBool opt_predictor6WorkaroundEnable = OFFalse;
+  OFCmdUnsignedInt opt_threads = 1;
 
   OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION, "Decode JPEG-compressed DICOM file", rcsid);
   OFCommandLine cmd;
@@ -121,6 +123,10 @@ int main(int argc, char *argv[])
     cmd.addSubGroup("workaround options for incorrect JPEG encodings:");
       cmd.addOption("--workaround-pred6",    "+w6",    "enable workaround for JPEG lossless images\nwith overflow in predictor 6");
 
+    cmd.addSubGroup("multi-frame images:");
+      cmd.addOption("--threads",             "+mt", 1, "[n]umber: integer (default: 1)",
+                                                       "decompress up to n frames in parallel");
+
   cmd.addGroup("output options:");
     cmd.addSubGroup("output file format:");
       cmd.addOption("--write-file",          "+F",     "write file format (default)");
@@ -195,6 +201,12 @@ int main(int argc, char *argv[])
 
       if (cmd.findOption("--workaround-pred6")) opt_predictor6WorkaroundEnable = OFTrue;
 
+      if (cmd.findOption("--threads"))
+      {
+        app.checkValue(cmd.getValueAndCheckMin(opt_threads, 1));
+        dcmCodecMaxThreads.set(OFstatic_cast(Uint32, opt_threads));
+      }
+
       cmd.beginOptionBlock();
       if (cmd.findOption("--read-file"))
       {
@@ -190,6 +190,12 @@ public:
 
 private:
 
+  /// helper class decompressing the frames of a multi-frame image in parallel
+  class FrameDecoder;
+
+  // Needed to keep MS VC6 happy
+  friend class FrameDecoder;
+
   /** creates an instance of the compression library to be used for decoding.
    *  @param toRepParam representation parameter passed to decode()
    *  @param cp codec parameter passed to decode()
@@ -236,6 +236,12 @@ protected:
 
 private:
 
+  /// helper class compressing the frames of an image, possibly in parallel
+  class FrameCompressor;
+
+  // Needed to keep MS VC6 happy
+  friend class FrameCompressor;
+
   /** compresses the given uncompressed DICOM color image and stores
    *  the result in the given pixSeq element.
    *  @param YBRmode true if the source image has YBR_FULL or YBR_FULL_422
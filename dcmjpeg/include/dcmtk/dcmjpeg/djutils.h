@@ -218,6 +218,22 @@ public:
    *  @return photometric interpretation enum, EPI_Unknown if unknown string or attribute missing
    */
   static EP_Interpretation getPhotometricInterpretation(DcmItem *item);
+
+  /** get the instruction set used by the vectorized routines (DCT, color
+   *  conversion and upsampling) of the 8 bit and 12 bit IJG libraries.
+   *  The instruction set is determined at runtime from the capabilities of
+   *  the processor and the limit set by setMaxSIMDLevel().
+   *  @return 0 = portable code only, 1 = SSE4.1, 2 = AVX2
+   */
+  static int getSIMDLevel();
+
+  /** limit the instruction set used by the vectorized routines of the 8 bit
+   *  and 12 bit IJG libraries, e.g. for testing or benchmarking purposes.
+   *  The output of the codec does not depend on the instruction set.
+   *  This function should not be called while images are encoded or decoded.
+   *  @param level 0 = portable code only, 1 = up to SSE4.1, 2 = up to AVX2 (default)
+   */
+  static void setMaxSIMDLevel(const int level);
 };
 
 #endif
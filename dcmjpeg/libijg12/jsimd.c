@@ -0,0 +1,1442 @@
+/*
+ * jsimd.c
+ *
+ * Copyright (C) 2026, agent.
+ * This file is part of the DCMTK version of the Independent JPEG Group's
+ * software.  For conditions of distribution and use, see the accompanying
+ * README file.
+ *
+ * This file contains vectorized versions of the most time-consuming routines
+ * of the lossy codec: the accurate integer forward and inverse DCT, the
+ * quantization of the DCT coefficients, the RGB <=> YCbCr color conversion
+ * and the "fancy" h2v1/h2v2 upsampling.  All routines produce exactly the
+ * same output as their portable counterparts in jfdctint.c, jidctint.c,
+ * jcdctmgr.c, jccolor.c, jdcolor.c and jdsample.c.  (Like the original IJG
+ * code, the DCT routines rely on the 32-bit range analysis in jidctint.c,
+ * i.e. they only differ from the portable code for corrupt input data.)
+ *
+ * The routines use SSE4.1 or AVX2 instructions (x86/x86-64 processors only).
+ * Since they are compiled with target-specific function attributes, they are
+ * only available with GCC-compatible compilers.  The instruction set is
+ * determined at runtime (see jpeg_simd_level); if neither SSE4.1 nor AVX2 is
+ * supported by the processor, the portable code is used.
+ *
+ * The DCT and color conversion kernels work on 32-bit integer lanes, so the
+ * same code serves the 8-bit and the (widened) 12-bit sample path.
+ */
+
+#define JPEG_INTERNALS
+#include "jinclude12.h"
+#include "jpeglib12.h"
+#include "jdct12.h"		/* Private declarations for DCT subsystem */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define JSIMD_X86
+#define JSIMD_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#endif
+
+#if DCTSIZE != 8
+  Sorry, this code only copes with 8x8 DCTs. /* deliberate syntax err */
+#endif
+
+#if RGB_PIXELSIZE != 3
+  Sorry, this code only copes with 3 samples per RGB pixel. /* deliberate syntax err */
+#endif
+
+
+/*
+ * Runtime selection of the instruction set.
+ *
+ * Both variables may be accessed by several threads at the same time, so
+ * they are only read and written atomically (if supported by the compiler).
+ * The instruction set supported by the CPU is determined on the first call;
+ * since all threads compute the same value, it does not matter which one
+ * stores it first.
+ */
+
+#ifdef __ATOMIC_RELAXED
+#define JSIMD_LOAD(var)		__atomic_load_n(&(var), __ATOMIC_RELAXED)
+#define JSIMD_STORE(var,val)	__atomic_store_n(&(var), (val), __ATOMIC_RELAXED)
+#else
+#define JSIMD_LOAD(var)		(var)
+#define JSIMD_STORE(var,val)	((var) = (val))
+#endif
+
+static volatile int max_simd_level = JSIMD_AVX2;	/* limit set by the application */
+static volatile int cpu_simd_level = -1;	/* supported by the CPU, -1 = unknown */
+
+LOCAL(int)
+detect_simd_level (void)
+{
+  int level = JSIMD_NONE;
+#ifdef JSIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    level = JSIMD_AVX2;
+  else if (__builtin_cpu_supports("sse4.1"))
+    level = JSIMD_SSE41;
+#endif
+  return level;
+}
+
+GLOBAL(int)
+jpeg_simd_level (void)
+{
+  int cpu_level = JSIMD_LOAD(cpu_simd_level);
+  int max_level = JSIMD_LOAD(max_simd_level);
+  if (cpu_level < 0) {
+    cpu_level = detect_simd_level();
+    JSIMD_STORE(cpu_simd_level, cpu_level);
+  }
+  return (cpu_level < max_level) ? cpu_level : max_level;
+}
+
+GLOBAL(void)
+jpeg_simd_set_max_level (int level)
+{
+  JSIMD_STORE(max_simd_level, level);
+}
+
+
+#ifdef JSIMD_X86
+
+/*
+ * Constants of the accurate integer DCT, see jfdctint.c and jidctint.c.
+ */
+
+#if BITS_IN_JSAMPLE == 8
+#define CONST_BITS  13
+#define PASS1_BITS  2
+#else
+#define CONST_BITS  13
+#define PASS1_BITS  1		/* lose a little precision to avoid overflow */
+#endif
+
+#define FIX_0_298631336  2446
+#define FIX_0_390180644  3196
+#define FIX_0_541196100  4433
+#define FIX_0_765366865  6270
+#define FIX_0_899976223  7373
+#define FIX_1_175875602  9633
+#define FIX_1_501321110  12299
+#define FIX_1_847759065  15137
+#define FIX_1_961570560  16069
+#define FIX_2_053119869  16819
+#define FIX_2_562915447  20995
+#define FIX_3_072711026  25172
+
+/* The IDCT output is range-limited by masking with RANGE_MASK (see jdct12.h
+ * and prepare_range_limit_table in jdmaster.c), i.e. only the lowest
+ * RANGE_BITS bits of the value are significant.
+ */
+#define RANGE_BITS  (BITS_IN_JSAMPLE + 2)
+
+#define DEQUANTIZE(coef,quantval)  (((ISLOW_MULT_TYPE) (coef)) * (quantval))
+
+/*
+ * Constants of the color conversion, see jccolor.c and jdcolor.c.
+ */
+
+#define SCALEBITS	16
+#define CBCR_OFFSET	((IJG_INT32) CENTERJSAMPLE << SCALEBITS)
+#define ONE_HALF	((IJG_INT32) 1 << (SCALEBITS-1))
+#define CFIX(x)		((int) ((x) * (1L<<SCALEBITS) + 0.5))
+
+/* Byte shuffle masks for converting three planes of 16 bytes (8-bit) or
+ * 8 words (12-bit) to 48 bytes of interleaved pixels and vice versa.
+ * interleave_mask[k][c] selects the bytes of plane c for output vector k,
+ * deinterleave_mask[c][k] selects the bytes of plane c from input vector k.
+ */
+
+#if BITS_IN_JSAMPLE == 8
+
+#define SIMD_PIXELS  16		/* pixels per 128-bit vector */
+
+static const signed char interleave_mask[3][3][16] = {
+  {
+    {    0, -128, -128,    1, -128, -128,    2, -128, -128,    3, -128, -128,    4, -128, -128,    5 },
+    { -128,    0, -128, -128,    1, -128, -128,    2, -128, -128,    3, -128, -128,    4, -128, -128 },
+    { -128, -128,    0, -128, -128,    1, -128, -128,    2, -128, -128,    3, -128, -128,    4, -128 }
+  },
+  {
+    { -128, -128,    6, -128, -128,    7, -128, -128,    8, -128, -128,    9, -128, -128,   10, -128 },
+    {    5, -128, -128,    6, -128, -128,    7, -128, -128,    8, -128, -128,    9, -128, -128,   10 },
+    { -128,    5, -128, -128,    6, -128, -128,    7, -128, -128,    8, -128, -128,    9, -128, -128 }
+  },
+  {
+    { -128,   11, -128, -128,   12, -128, -128,   13, -128, -128,   14, -128, -128,   15, -128, -128 },
+    { -128, -128,   11, -128, -128,   12, -128, -128,   13, -128, -128,   14, -128, -128,   15, -128 },
+    {   10, -128, -128,   11, -128, -128,   12, -128, -128,   13, -128, -128,   14, -128, -128,   15 }
+  }
+};
+
+static const signed char deinterleave_mask[3][3][16] = {
+  {
+    {    0,    3,    6,    9,   12,   15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128,    2,    5,    8,   11,   14, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,    1,    4,    7,   10,   13 }
+  },
+  {
+    {    1,    4,    7,   10,   13, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128,    0,    3,    6,    9,   12,   15, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,    2,    5,    8,   11,   14 }
+  },
+  {
+    {    2,    5,    8,   11,   14, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128,    1,    4,    7,   10,   13, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,    0,    3,    6,    9,   12,   15 }
+  }
+};
+
+#else
+
+#define SIMD_PIXELS  8		/* pixels per 128-bit vector */
+
+static const signed char interleave_mask[3][3][16] = {
+  {
+    {    0,    1, -128, -128, -128, -128,    2,    3, -128, -128, -128, -128,    4,    5, -128, -128 },
+    { -128, -128,    0,    1, -128, -128, -128, -128,    2,    3, -128, -128, -128, -128,    4,    5 },
+    { -128, -128, -128, -128,    0,    1, -128, -128, -128, -128,    2,    3, -128, -128, -128, -128 }
+  },
+  {
+    { -128, -128,    6,    7, -128, -128, -128, -128,    8,    9, -128, -128, -128, -128,   10,   11 },
+    { -128, -128, -128, -128,    6,    7, -128, -128, -128, -128,    8,    9, -128, -128, -128, -128 },
+    {    4,    5, -128, -128, -128, -128,    6,    7, -128, -128, -128, -128,    8,    9, -128, -128 }
+  },
+  {
+    { -128, -128, -128, -128,   12,   13, -128, -128, -128, -128,   14,   15, -128, -128, -128, -128 },
+    {   10,   11, -128, -128, -128, -128,   12,   13, -128, -128, -128, -128,   14,   15, -128, -128 },
+    { -128, -128,   10,   11, -128, -128, -128, -128,   12,   13, -128, -128, -128, -128,   14,   15 }
+  }
+};
+
+static const signed char deinterleave_mask[3][3][16] = {
+  {
+    {    0,    1,    6,    7,   12,   13, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128,    2,    3,    8,    9,   14,   15, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,    4,    5,   10,   11 }
+  },
+  {
+    {    2,    3,    8,    9,   14,   15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128,    4,    5,   10,   11, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,    0,    1,    6,    7,   12,   13 }
+  },
+  {
+    {    4,    5,   10,   11, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128,    0,    1,    6,    7,   12,   13, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,    2,    3,    8,    9,   14,   15 }
+  }
+};
+
+#endif
+
+#define LOAD_MASK(m)	_mm_loadu_si128((const __m128i *) (m))
+
+
+/**************** Helper routines for both instruction sets **************/
+
+/* Convert the 16 bytes (8-bit) or 8 words (12-bit) of three planes into
+ * interleaved pixels (48 bytes).
+ */
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+interleave_pixels (__m128i plane0, __m128i plane1, __m128i plane2,
+		   JSAMPROW outptr)
+{
+  int k;
+
+  for (k = 0; k < 3; k++) {
+    __m128i v = _mm_or_si128(
+      _mm_or_si128(_mm_shuffle_epi8(plane0, LOAD_MASK(interleave_mask[k][0])),
+		   _mm_shuffle_epi8(plane1, LOAD_MASK(interleave_mask[k][1]))),
+      _mm_shuffle_epi8(plane2, LOAD_MASK(interleave_mask[k][2])));
+    _mm_storeu_si128((__m128i *) outptr + k, v);
+  }
+}
+
+/* Convert 48 bytes of interleaved pixels into three planes. */
+
+JSIMD_TARGET("sse4.1")
+static INLINE __m128i
+deinterleave_plane (__m128i in0, __m128i in1, __m128i in2, int c)
+{
+  return _mm_or_si128(
+    _mm_or_si128(_mm_shuffle_epi8(in0, LOAD_MASK(deinterleave_mask[c][0])),
+		 _mm_shuffle_epi8(in1, LOAD_MASK(deinterleave_mask[c][1]))),
+    _mm_shuffle_epi8(in2, LOAD_MASK(deinterleave_mask[c][2])));
+}
+
+/* Load four DCTELEMs as 32-bit integers (DCTELEM may be a 64-bit type). */
+
+JSIMD_TARGET("sse4.1")
+static INLINE __m128i
+load_dctelem4 (const DCTELEM * ptr)
+{
+  if (SIZEOF(DCTELEM) == 4)
+    return _mm_loadu_si128((const __m128i *) ptr);
+  else {
+    __m128i a = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) ptr), 0x08);
+    __m128i b = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) ptr + 1), 0x08);
+    return _mm_unpacklo_epi64(a, b);
+  }
+}
+
+/* Store four 32-bit integers as DCTELEMs. */
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+store_dctelem4 (DCTELEM * ptr, __m128i v)
+{
+  if (SIZEOF(DCTELEM) == 4)
+    _mm_storeu_si128((__m128i *) ptr, v);
+  else {
+    _mm_storeu_si128((__m128i *) ptr, _mm_cvtepi32_epi64(v));
+    _mm_storeu_si128((__m128i *) ptr + 1, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+  }
+}
+
+/* Load four dequantization multipliers as 32-bit integers. */
+
+JSIMD_TARGET("sse4.1")
+static INLINE __m128i
+load_mult4 (const ISLOW_MULT_TYPE * ptr)
+{
+  if (SIZEOF(ISLOW_MULT_TYPE) == 4)
+    return _mm_loadu_si128((const __m128i *) ptr);
+  else
+    return _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *) ptr));
+}
+
+/* Store a row of 8 IDCT output values (32-bit integers) as samples,
+ * applying the same range limiting as the portable code.
+ */
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+store_idct_row (JSAMPROW outptr, __m128i lo, __m128i hi)
+{
+  const __m128i center = _mm_set1_epi32(CENTERJSAMPLE);
+  __m128i row;
+
+  /* Only the lowest RANGE_BITS bits are significant (see RANGE_MASK) */
+  lo = _mm_add_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 32-RANGE_BITS), 32-RANGE_BITS), center);
+  hi = _mm_add_epi32(_mm_srai_epi32(_mm_slli_epi32(hi, 32-RANGE_BITS), 32-RANGE_BITS), center);
+  row = _mm_packs_epi32(lo, hi);
+#if BITS_IN_JSAMPLE == 8
+  _mm_storel_epi64((__m128i *) outptr, _mm_packus_epi16(row, row));
+#else
+  row = _mm_min_epi16(_mm_max_epi16(row, _mm_setzero_si128()), _mm_set1_epi16(MAXJSAMPLE));
+  _mm_storeu_si128((__m128i *) outptr, row);
+#endif
+}
+
+/* Check whether all AC coefficients of a block are zero. */
+
+JSIMD_TARGET("sse4.1")
+static INLINE int
+ac_coefs_zero (JCOEFPTR coef_block)
+{
+  const __m128i * ptr = (const __m128i *) coef_block;
+  __m128i v = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(ptr + 1), _mm_loadu_si128(ptr + 2)),
+			   _mm_or_si128(_mm_loadu_si128(ptr + 3), _mm_loadu_si128(ptr + 4)));
+  v = _mm_or_si128(v, _mm_or_si128(_mm_or_si128(_mm_loadu_si128(ptr + 5), _mm_loadu_si128(ptr + 6)),
+				   _mm_loadu_si128(ptr + 7)));
+  /* ignore the DC coefficient in the first row */
+  v = _mm_or_si128(v, _mm_srli_si128(_mm_loadu_si128(ptr), 2));
+  return _mm_testz_si128(v, v);
+}
+
+/* Inverse DCT of a block with only a DC coefficient: all output samples
+ * have the same value.  This is the result of the "zero AC terms" shortcuts
+ * in both passes of jpeg_idct_islow.
+ */
+
+LOCAL(void)
+idct_dc_only (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+	      JCOEFPTR coef_block, JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+  ISLOW_MULT_TYPE * quantptr = (ISLOW_MULT_TYPE *) compptr->dct_table;
+  JSAMPLE *range_limit = IDCT_range_limit(cinfo);
+  int dcval = DEQUANTIZE(coef_block[0], quantptr[0]) << PASS1_BITS;
+  JSAMPLE outval = range_limit[(int) DESCALE((IJG_INT32) dcval, PASS1_BITS+3)
+			       & RANGE_MASK];
+  JSAMPROW outptr;
+  int ctr, col;
+
+  for (ctr = 0; ctr < DCTSIZE; ctr++) {
+    outptr = output_buf[ctr] + output_col;
+    for (col = 0; col < DCTSIZE; col++)
+      outptr[col] = outval;
+  }
+}
+
+
+/**************** SSE4.1 routines **************/
+
+/*
+ * One-dimensional DCT on four columns (or rows) in parallel.
+ * The code follows the scalar implementations step by step.
+ */
+
+JSIMD_TARGET("sse4.1")
+static INLINE __m128i
+mul_sse41 (__m128i v, int c)
+{
+  return _mm_mullo_epi32(v, _mm_set1_epi32(c));
+}
+
+JSIMD_TARGET("sse4.1")
+static INLINE __m128i
+descale_sse41 (__m128i v, int n)
+{
+  return _mm_srai_epi32(_mm_add_epi32(v, _mm_set1_epi32(1 << (n-1))), n);
+}
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+idct_1d_sse41 (__m128i * v, int n)
+{
+  __m128i tmp0, tmp1, tmp2, tmp3, tmp10, tmp11, tmp12, tmp13;
+  __m128i z1, z2, z3, z4, z5;
+
+  /* Even part */
+  z2 = v[2];
+  z3 = v[6];
+  z1 = mul_sse41(_mm_add_epi32(z2, z3), FIX_0_541196100);
+  tmp2 = _mm_add_epi32(z1, mul_sse41(z3, - FIX_1_847759065));
+  tmp3 = _mm_add_epi32(z1, mul_sse41(z2, FIX_0_765366865));
+  tmp0 = _mm_slli_epi32(_mm_add_epi32(v[0], v[4]), CONST_BITS);
+  tmp1 = _mm_slli_epi32(_mm_sub_epi32(v[0], v[4]), CONST_BITS);
+  tmp10 = _mm_add_epi32(tmp0, tmp3);
+  tmp13 = _mm_sub_epi32(tmp0, tmp3);
+  tmp11 = _mm_add_epi32(tmp1, tmp2);
+  tmp12 = _mm_sub_epi32(tmp1, tmp2);
+
+  /* Odd part */
+  tmp0 = v[7];
+  tmp1 = v[5];
+  tmp2 = v[3];
+  tmp3 = v[1];
+  z1 = _mm_add_epi32(tmp0, tmp3);
+  z2 = _mm_add_epi32(tmp1, tmp2);
+  z3 = _mm_add_epi32(tmp0, tmp2);
+  z4 = _mm_add_epi32(tmp1, tmp3);
+  z5 = mul_sse41(_mm_add_epi32(z3, z4), FIX_1_175875602);
+  tmp0 = mul_sse41(tmp0, FIX_0_298631336);
+  tmp1 = mul_sse41(tmp1, FIX_2_053119869);
+  tmp2 = mul_sse41(tmp2, FIX_3_072711026);
+  tmp3 = mul_sse41(tmp3, FIX_1_501321110);
+  z1 = mul_sse41(z1, - FIX_0_899976223);
+  z2 = mul_sse41(z2, - FIX_2_562915447);
+  z3 = _mm_add_epi32(mul_sse41(z3, - FIX_1_961570560), z5);
+  z4 = _mm_add_epi32(mul_sse41(z4, - FIX_0_390180644), z5);
+  tmp0 = _mm_add_epi32(tmp0, _mm_add_epi32(z1, z3));
+  tmp1 = _mm_add_epi32(tmp1, _mm_add_epi32(z2, z4));
+  tmp2 = _mm_add_epi32(tmp2, _mm_add_epi32(z2, z3));
+  tmp3 = _mm_add_epi32(tmp3, _mm_add_epi32(z1, z4));
+
+  /* Final output stage */
+  v[0] = descale_sse41(_mm_add_epi32(tmp10, tmp3), n);
+  v[7] = descale_sse41(_mm_sub_epi32(tmp10, tmp3), n);
+  v[1] = descale_sse41(_mm_add_epi32(tmp11, tmp2), n);
+  v[6] = descale_sse41(_mm_sub_epi32(tmp11, tmp2), n);
+  v[2] = descale_sse41(_mm_add_epi32(tmp12, tmp1), n);
+  v[5] = descale_sse41(_mm_sub_epi32(tmp12, tmp1), n);
+  v[3] = descale_sse41(_mm_add_epi32(tmp13, tmp0), n);
+  v[4] = descale_sse41(_mm_sub_epi32(tmp13, tmp0), n);
+}
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+fdct_1d_sse41 (__m128i * v, int pass)
+{
+  __m128i tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+  __m128i tmp10, tmp11, tmp12, tmp13;
+  __m128i z1, z2, z3, z4, z5;
+  const int n = (pass == 1) ? CONST_BITS-PASS1_BITS : CONST_BITS+PASS1_BITS;
+
+  tmp0 = _mm_add_epi32(v[0], v[7]);
+  tmp7 = _mm_sub_epi32(v[0], v[7]);
+  tmp1 = _mm_add_epi32(v[1], v[6]);
+  tmp6 = _mm_sub_epi32(v[1], v[6]);
+  tmp2 = _mm_add_epi32(v[2], v[5]);
+  tmp5 = _mm_sub_epi32(v[2], v[5]);
+  tmp3 = _mm_add_epi32(v[3], v[4]);
+  tmp4 = _mm_sub_epi32(v[3], v[4]);
+
+  /* Even part */
+  tmp10 = _mm_add_epi32(tmp0, tmp3);
+  tmp13 = _mm_sub_epi32(tmp0, tmp3);
+  tmp11 = _mm_add_epi32(tmp1, tmp2);
+  tmp12 = _mm_sub_epi32(tmp1, tmp2);
+  if (pass == 1) {
+    v[0] = _mm_slli_epi32(_mm_add_epi32(tmp10, tmp11), PASS1_BITS);
+    v[4] = _mm_slli_epi32(_mm_sub_epi32(tmp10, tmp11), PASS1_BITS);
+  } else {
+    v[0] = descale_sse41(_mm_add_epi32(tmp10, tmp11), PASS1_BITS);
+    v[4] = descale_sse41(_mm_sub_epi32(tmp10, tmp11), PASS1_BITS);
+  }
+  z1 = mul_sse41(_mm_add_epi32(tmp12, tmp13), FIX_0_541196100);
+  v[2] = descale_sse41(_mm_add_epi32(z1, mul_sse41(tmp13, FIX_0_765366865)), n);
+  v[6] = descale_sse41(_mm_add_epi32(z1, mul_sse41(tmp12, - FIX_1_847759065)), n);
+
+  /* Odd part */
+  z1 = _mm_add_epi32(tmp4, tmp7);
+  z2 = _mm_add_epi32(tmp5, tmp6);
+  z3 = _mm_add_epi32(tmp4, tmp6);
+  z4 = _mm_add_epi32(tmp5, tmp7);
+  z5 = mul_sse41(_mm_add_epi32(z3, z4), FIX_1_175875602);
+  tmp4 = mul_sse41(tmp4, FIX_0_298631336);
+  tmp5 = mul_sse41(tmp5, FIX_2_053119869);
+  tmp6 = mul_sse41(tmp6, FIX_3_072711026);
+  tmp7 = mul_sse41(tmp7, FIX_1_501321110);
+  z1 = mul_sse41(z1, - FIX_0_899976223);
+  z2 = mul_sse41(z2, - FIX_2_562915447);
+  z3 = _mm_add_epi32(mul_sse41(z3, - FIX_1_961570560), z5);
+  z4 = _mm_add_epi32(mul_sse41(z4, - FIX_0_390180644), z5);
+  v[7] = descale_sse41(_mm_add_epi32(tmp4, _mm_add_epi32(z1, z3)), n);
+  v[5] = descale_sse41(_mm_add_epi32(tmp5, _mm_add_epi32(z2, z4)), n);
+  v[3] = descale_sse41(_mm_add_epi32(tmp6, _mm_add_epi32(z2, z3)), n);
+  v[1] = descale_sse41(_mm_add_epi32(tmp7, _mm_add_epi32(z1, z4)), n);
+}
+
+/* Transpose a 4x4 matrix of 32-bit integers. */
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+transpose4_sse41 (__m128i * v)
+{
+  __m128i t0 = _mm_unpacklo_epi32(v[0], v[1]);
+  __m128i t1 = _mm_unpackhi_epi32(v[0], v[1]);
+  __m128i t2 = _mm_unpacklo_epi32(v[2], v[3]);
+  __m128i t3 = _mm_unpackhi_epi32(v[2], v[3]);
+  v[0] = _mm_unpacklo_epi64(t0, t2);
+  v[1] = _mm_unpackhi_epi64(t0, t2);
+  v[2] = _mm_unpacklo_epi64(t1, t3);
+  v[3] = _mm_unpackhi_epi64(t1, t3);
+}
+
+/* Transpose an 8x8 matrix stored as left (columns 0-3) and right
+ * (columns 4-7) halves of each row.
+ */
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+transpose8_sse41 (__m128i * left, __m128i * right)
+{
+  __m128i tmp;
+  int i;
+
+  transpose4_sse41(left);
+  transpose4_sse41(left + 4);
+  transpose4_sse41(right);
+  transpose4_sse41(right + 4);
+  for (i = 0; i < 4; i++) {
+    tmp = right[i];
+    right[i] = left[i + 4];
+    left[i + 4] = tmp;
+  }
+}
+
+JSIMD_TARGET("sse4.1")
+LOCAL(void)
+idct_islow_sse41 (jpeg_component_info * compptr, JCOEFPTR coef_block,
+		  JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+  const ISLOW_MULT_TYPE * quantptr = (const ISLOW_MULT_TYPE *) compptr->dct_table;
+  __m128i left[DCTSIZE], right[DCTSIZE];
+  __m128i coefs;
+  int i;
+
+  /* Dequantize the coefficients */
+  for (i = 0; i < DCTSIZE; i++) {
+    coefs = _mm_loadu_si128((const __m128i *) (coef_block + i*DCTSIZE));
+    left[i] = _mm_mullo_epi32(_mm_cvtepi16_epi32(coefs), load_mult4(quantptr + i*DCTSIZE));
+    right[i] = _mm_mullo_epi32(_mm_cvtepi16_epi32(_mm_srli_si128(coefs, 8)),
+			       load_mult4(quantptr + i*DCTSIZE + 4));
+  }
+
+  /* Pass 1: process columns */
+  idct_1d_sse41(left, CONST_BITS-PASS1_BITS);
+  idct_1d_sse41(right, CONST_BITS-PASS1_BITS);
+  transpose8_sse41(left, right);
+
+  /* Pass 2: process rows */
+  idct_1d_sse41(left, CONST_BITS+PASS1_BITS+3);
+  idct_1d_sse41(right, CONST_BITS+PASS1_BITS+3);
+  transpose8_sse41(left, right);
+
+  for (i = 0; i < DCTSIZE; i++)
+    store_idct_row(output_buf[i] + output_col, left[i], right[i]);
+}
+
+JSIMD_TARGET("sse4.1")
+LOCAL(void)
+fdct_islow_sse41 (DCTELEM * data)
+{
+  __m128i left[DCTSIZE], right[DCTSIZE];
+  int i;
+
+  for (i = 0; i < DCTSIZE; i++) {
+    left[i] = load_dctelem4(data + i*DCTSIZE);
+    right[i] = load_dctelem4(data + i*DCTSIZE + 4);
+  }
+
+  /* Pass 1: process rows */
+  transpose8_sse41(left, right);
+  fdct_1d_sse41(left, 1);
+  fdct_1d_sse41(right, 1);
+  transpose8_sse41(left, right);
+
+  /* Pass 2: process columns */
+  fdct_1d_sse41(left, 2);
+  fdct_1d_sse41(right, 2);
+
+  for (i = 0; i < DCTSIZE; i++) {
+    store_dctelem4(data + i*DCTSIZE, left[i]);
+    store_dctelem4(data + i*DCTSIZE + 4, right[i]);
+  }
+}
+
+/* Quantize four coefficients: divide by the divisor with rounding, as
+ * done in forward_DCT (jcdctmgr.c).  The quotient is computed in single
+ * precision (exact for the possible range of values) and corrected by one
+ * if necessary.
+ */
+
+JSIMD_TARGET("sse4.1")
+static INLINE __m128i
+quantize4_sse41 (__m128i coef, __m128i qval)
+{
+  __m128i a = _mm_add_epi32(_mm_abs_epi32(coef), _mm_srai_epi32(qval, 1));
+  __m128i q = _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(a), _mm_cvtepi32_ps(qval)));
+  __m128i r = _mm_sub_epi32(a, _mm_mullo_epi32(q, qval));
+  /* the comparison results are -1 (true) or 0 (false) */
+  q = _mm_sub_epi32(q, _mm_cmpgt_epi32(_mm_add_epi32(r, _mm_set1_epi32(1)), qval));
+  q = _mm_add_epi32(q, _mm_cmplt_epi32(r, _mm_setzero_si128()));
+  return _mm_sign_epi32(q, coef);
+}
+
+JSIMD_TARGET("sse4.1")
+LOCAL(void)
+quantize_sse41 (JCOEFPTR coef_block, DCTELEM * divisors, DCTELEM * workspace)
+{
+  __m128i lo, hi;
+  int i;
+
+  for (i = 0; i < DCTSIZE2; i += 8) {
+    lo = quantize4_sse41(load_dctelem4(workspace + i), load_dctelem4(divisors + i));
+    hi = quantize4_sse41(load_dctelem4(workspace + i + 4), load_dctelem4(divisors + i + 4));
+    /* truncate to JCOEF like the cast in the portable code */
+    lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+    hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+    _mm_storeu_si128((__m128i *) (coef_block + i), _mm_packs_epi32(lo, hi));
+  }
+}
+
+/* Convert 4 pixels from YCbCr to RGB (32-bit lanes). */
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+ycc_rgb4_sse41 (__m128i y, __m128i cb, __m128i cr,
+		__m128i * r, __m128i * g, __m128i * b)
+{
+  const __m128i center = _mm_set1_epi32(CENTERJSAMPLE);
+  const __m128i half = _mm_set1_epi32(ONE_HALF);
+
+  cb = _mm_sub_epi32(cb, center);
+  cr = _mm_sub_epi32(cr, center);
+  *r = _mm_add_epi32(y, _mm_srai_epi32(_mm_add_epi32(mul_sse41(cr, CFIX(1.40200)), half), SCALEBITS));
+  *g = _mm_add_epi32(y, _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(mul_sse41(cb, - CFIX(0.34414)),
+								      mul_sse41(cr, - CFIX(0.71414))),
+						     half), SCALEBITS));
+  *b = _mm_add_epi32(y, _mm_srai_epi32(_mm_add_epi32(mul_sse41(cb, CFIX(1.77200)), half), SCALEBITS));
+}
+
+/* Convert 8 pixels (16-bit lanes) from YCbCr to RGB and range-limit. */
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+ycc_rgb8_sse41 (__m128i y, __m128i cb, __m128i cr,
+		__m128i * r, __m128i * g, __m128i * b)
+{
+  __m128i r0, g0, b0, r1, g1, b1;
+
+  ycc_rgb4_sse41(_mm_cvtepi16_epi32(y), _mm_cvtepi16_epi32(cb), _mm_cvtepi16_epi32(cr),
+		 &r0, &g0, &b0);
+  ycc_rgb4_sse41(_mm_cvtepi16_epi32(_mm_srli_si128(y, 8)), _mm_cvtepi16_epi32(_mm_srli_si128(cb, 8)),
+		 _mm_cvtepi16_epi32(_mm_srli_si128(cr, 8)), &r1, &g1, &b1);
+  *r = _mm_packs_epi32(r0, r1);
+  *g = _mm_packs_epi32(g0, g1);
+  *b = _mm_packs_epi32(b0, b1);
+}
+
+/* Convert 4 pixels from RGB to YCbCr (32-bit lanes). */
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+rgb_ycc4_sse41 (__m128i r, __m128i g, __m128i b,
+		__m128i * y, __m128i * cb, __m128i * cr)
+{
+  const __m128i offset = _mm_set1_epi32(CBCR_OFFSET + ONE_HALF-1);
+
+  *y = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(mul_sse41(r, CFIX(0.29900)), mul_sse41(g, CFIX(0.58700))),
+				    _mm_add_epi32(mul_sse41(b, CFIX(0.11400)), _mm_set1_epi32(ONE_HALF))),
+		      SCALEBITS);
+  *cb = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(mul_sse41(r, - CFIX(0.16874)), mul_sse41(g, - CFIX(0.33126))),
+				     _mm_add_epi32(mul_sse41(b, CFIX(0.50000)), offset)),
+		       SCALEBITS);
+  *cr = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(mul_sse41(r, CFIX(0.50000)), mul_sse41(g, - CFIX(0.41869))),
+				     _mm_add_epi32(mul_sse41(b, - CFIX(0.08131)), offset)),
+		       SCALEBITS);
+}
+
+/* Convert 8 pixels (16-bit lanes) from RGB to YCbCr. */
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+rgb_ycc8_sse41 (__m128i r, __m128i g, __m128i b,
+		__m128i * y, __m128i * cb, __m128i * cr)
+{
+  __m128i y0, cb0, cr0, y1, cb1, cr1;
+
+  rgb_ycc4_sse41(_mm_cvtepu16_epi32(r), _mm_cvtepu16_epi32(g), _mm_cvtepu16_epi32(b),
+		 &y0, &cb0, &cr0);
+  rgb_ycc4_sse41(_mm_cvtepu16_epi32(_mm_srli_si128(r, 8)), _mm_cvtepu16_epi32(_mm_srli_si128(g, 8)),
+		 _mm_cvtepu16_epi32(_mm_srli_si128(b, 8)), &y1, &cb1, &cr1);
+  *y = _mm_packs_epi32(y0, y1);
+  *cb = _mm_packs_epi32(cb0, cb1);
+  *cr = _mm_packs_epi32(cr0, cr1);
+}
+
+
+/**************** AVX2 routines **************/
+
+JSIMD_TARGET("avx2")
+static INLINE __m256i
+mul_avx2 (__m256i v, int c)
+{
+  return _mm256_mullo_epi32(v, _mm256_set1_epi32(c));
+}
+
+JSIMD_TARGET("avx2")
+static INLINE __m256i
+descale_avx2 (__m256i v, int n)
+{
+  return _mm256_srai_epi32(_mm256_add_epi32(v, _mm256_set1_epi32(1 << (n-1))), n);
+}
+
+JSIMD_TARGET("avx2")
+static INLINE void
+idct_1d_avx2 (__m256i * v, int n)
+{
+  __m256i tmp0, tmp1, tmp2, tmp3, tmp10, tmp11, tmp12, tmp13;
+  __m256i z1, z2, z3, z4, z5;
+
+  /* Even part */
+  z2 = v[2];
+  z3 = v[6];
+  z1 = mul_avx2(_mm256_add_epi32(z2, z3), FIX_0_541196100);
+  tmp2 = _mm256_add_epi32(z1, mul_avx2(z3, - FIX_1_847759065));
+  tmp3 = _mm256_add_epi32(z1, mul_avx2(z2, FIX_0_765366865));
+  tmp0 = _mm256_slli_epi32(_mm256_add_epi32(v[0], v[4]), CONST_BITS);
+  tmp1 = _mm256_slli_epi32(_mm256_sub_epi32(v[0], v[4]), CONST_BITS);
+  tmp10 = _mm256_add_epi32(tmp0, tmp3);
+  tmp13 = _mm256_sub_epi32(tmp0, tmp3);
+  tmp11 = _mm256_add_epi32(tmp1, tmp2);
+  tmp12 = _mm256_sub_epi32(tmp1, tmp2);
+
+  /* Odd part */
+  tmp0 = v[7];
+  tmp1 = v[5];
+  tmp2 = v[3];
+  tmp3 = v[1];
+  z1 = _mm256_add_epi32(tmp0, tmp3);
+  z2 = _mm256_add_epi32(tmp1, tmp2);
+  z3 = _mm256_add_epi32(tmp0, tmp2);
+  z4 = _mm256_add_epi32(tmp1, tmp3);
+  z5 = mul_avx2(_mm256_add_epi32(z3, z4), FIX_1_175875602);
+  tmp0 = mul_avx2(tmp0, FIX_0_298631336);
+  tmp1 = mul_avx2(tmp1, FIX_2_053119869);
+  tmp2 = mul_avx2(tmp2, FIX_3_072711026);
+  tmp3 = mul_avx2(tmp3, FIX_1_501321110);
+  z1 = mul_avx2(z1, - FIX_0_899976223);
+  z2 = mul_avx2(z2, - FIX_2_562915447);
+  z3 = _mm256_add_epi32(mul_avx2(z3, - FIX_1_961570560), z5);
+  z4 = _mm256_add_epi32(mul_avx2(z4, - FIX_0_390180644), z5);
+  tmp0 = _mm256_add_epi32(tmp0, _mm256_add_epi32(z1, z3));
+  tmp1 = _mm256_add_epi32(tmp1, _mm256_add_epi32(z2, z4));
+  tmp2 = _mm256_add_epi32(tmp2, _mm256_add_epi32(z2, z3));
+  tmp3 = _mm256_add_epi32(tmp3, _mm256_add_epi32(z1, z4));
+
+  /* Final output stage */
+  v[0] = descale_avx2(_mm256_add_epi32(tmp10, tmp3), n);
+  v[7] = descale_avx2(_mm256_sub_epi32(tmp10, tmp3), n);
+  v[1] = descale_avx2(_mm256_add_epi32(tmp11, tmp2), n);
+  v[6] = descale_avx2(_mm256_sub_epi32(tmp11, tmp2), n);
+  v[2] = descale_avx2(_mm256_add_epi32(tmp12, tmp1), n);
+  v[5] = descale_avx2(_mm256_sub_epi32(tmp12, tmp1), n);
+  v[3] = descale_avx2(_mm256_add_epi32(tmp13, tmp0), n);
+  v[4] = descale_avx2(_mm256_sub_epi32(tmp13, tmp0), n);
+}
+
+JSIMD_TARGET("avx2")
+static INLINE void
+fdct_1d_avx2 (__m256i * v, int pass)
+{
+  __m256i tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+  __m256i tmp10, tmp11, tmp12, tmp13;
+  __m256i z1, z2, z3, z4, z5;
+  const int n = (pass == 1) ? CONST_BITS-PASS1_BITS : CONST_BITS+PASS1_BITS;
+
+  tmp0 = _mm256_add_epi32(v[0], v[7]);
+  tmp7 = _mm256_sub_epi32(v[0], v[7]);
+  tmp1 = _mm256_add_epi32(v[1], v[6]);
+  tmp6 = _mm256_sub_epi32(v[1], v[6]);
+  tmp2 = _mm256_add_epi32(v[2], v[5]);
+  tmp5 = _mm256_sub_epi32(v[2], v[5]);
+  tmp3 = _mm256_add_epi32(v[3], v[4]);
+  tmp4 = _mm256_sub_epi32(v[3], v[4]);
+
+  /* Even part */
+  tmp10 = _mm256_add_epi32(tmp0, tmp3);
+  tmp13 = _mm256_sub_epi32(tmp0, tmp3);
+  tmp11 = _mm256_add_epi32(tmp1, tmp2);
+  tmp12 = _mm256_sub_epi32(tmp1, tmp2);
+  if (pass == 1) {
+    v[0] = _mm256_slli_epi32(_mm256_add_epi32(tmp10, tmp11), PASS1_BITS);
+    v[4] = _mm256_slli_epi32(_mm256_sub_epi32(tmp10, tmp11), PASS1_BITS);
+  } else {
+    v[0] = descale_avx2(_mm256_add_epi32(tmp10, tmp11), PASS1_BITS);
+    v[4] = descale_avx2(_mm256_sub_epi32(tmp10, tmp11), PASS1_BITS);
+  }
+  z1 = mul_avx2(_mm256_add_epi32(tmp12, tmp13), FIX_0_541196100);
+  v[2] = descale_avx2(_mm256_add_epi32(z1, mul_avx2(tmp13, FIX_0_765366865)), n);
+  v[6] = descale_avx2(_mm256_add_epi32(z1, mul_avx2(tmp12, - FIX_1_847759065)), n);
+
+  /* Odd part */
+  z1 = _mm256_add_epi32(tmp4, tmp7);
+  z2 = _mm256_add_epi32(tmp5, tmp6);
+  z3 = _mm256_add_epi32(tmp4, tmp6);
+  z4 = _mm256_add_epi32(tmp5, tmp7);
+  z5 = mul_avx2(_mm256_add_epi32(z3, z4), FIX_1_175875602);
+  tmp4 = mul_avx2(tmp4, FIX_0_298631336);
+  tmp5 = mul_avx2(tmp5, FIX_2_053119869);
+  tmp6 = mul_avx2(tmp6, FIX_3_072711026);
+  tmp7 = mul_avx2(tmp7, FIX_1_501321110);
+  z1 = mul_avx2(z1, - FIX_0_899976223);
+  z2 = mul_avx2(z2, - FIX_2_562915447);
+  z3 = _mm256_add_epi32(mul_avx2(z3, - FIX_1_961570560), z5);
+  z4 = _mm256_add_epi32(mul_avx2(z4, - FIX_0_390180644), z5);
+  v[7] = descale_avx2(_mm256_add_epi32(tmp4, _mm256_add_epi32(z1, z3)), n);
+  v[5] = descale_avx2(_mm256_add_epi32(tmp5, _mm256_add_epi32(z2, z4)), n);
+  v[3] = descale_avx2(_mm256_add_epi32(tmp6, _mm256_add_epi32(z2, z3)), n);
+  v[1] = descale_avx2(_mm256_add_epi32(tmp7, _mm256_add_epi32(z1, z4)), n);
+}
+
+/* Transpose an 8x8 matrix of 32-bit integers (one row per register). */
+
+JSIMD_TARGET("avx2")
+static INLINE void
+transpose8_avx2 (__m256i * v)
+{
+  __m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+  __m256i t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+  __m256i t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+  __m256i t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+  __m256i t4 = _mm256_unpacklo_epi32(v[4], v[5]);
+  __m256i t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+  __m256i t6 = _mm256_unpacklo_epi32(v[6], v[7]);
+  __m256i t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+  __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+  __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+  __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+  __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+  __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+  __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+  __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+  __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+  v[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+  v[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+  v[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+  v[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+  v[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+  v[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+  v[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+  v[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/* Load eight DCTELEMs as 32-bit integers (DCTELEM may be a 64-bit type). */
+
+JSIMD_TARGET("avx2")
+static INLINE __m256i
+load_dctelem8 (const DCTELEM * ptr)
+{
+  if (SIZEOF(DCTELEM) == 4)
+    return _mm256_loadu_si256((const __m256i *) ptr);
+  else {
+    const __m256i idx = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    __m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) ptr), idx);
+    __m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) ptr + 1), idx);
+    return _mm256_permute2x128_si256(a, b, 0x20);
+  }
+}
+
+/* Store eight 32-bit integers as DCTELEMs. */
+
+JSIMD_TARGET("avx2")
+static INLINE void
+store_dctelem8 (DCTELEM * ptr, __m256i v)
+{
+  if (SIZEOF(DCTELEM) == 4)
+    _mm256_storeu_si256((__m256i *) ptr, v);
+  else {
+    _mm256_storeu_si256((__m256i *) ptr, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+    _mm256_storeu_si256((__m256i *) ptr + 1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+  }
+}
+
+/* Load eight dequantization multipliers as 32-bit integers. */
+
+JSIMD_TARGET("avx2")
+static INLINE __m256i
+load_mult8 (const ISLOW_MULT_TYPE * ptr)
+{
+  if (SIZEOF(ISLOW_MULT_TYPE) == 4)
+    return _mm256_loadu_si256((const __m256i *) ptr);
+  else
+    return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) ptr));
+}
+
+JSIMD_TARGET("avx2")
+LOCAL(void)
+idct_islow_avx2 (jpeg_component_info * compptr, JCOEFPTR coef_block,
+		 JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+  const ISLOW_MULT_TYPE * quantptr = (const ISLOW_MULT_TYPE *) compptr->dct_table;
+  __m256i v[DCTSIZE];
+  int i;
+
+  /* Dequantize the coefficients */
+  for (i = 0; i < DCTSIZE; i++)
+    v[i] = _mm256_mullo_epi32(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) (coef_block + i*DCTSIZE))),
+			      load_mult8(quantptr + i*DCTSIZE));
+
+  /* Pass 1: process columns */
+  idct_1d_avx2(v, CONST_BITS-PASS1_BITS);
+  transpose8_avx2(v);
+
+  /* Pass 2: process rows */
+  idct_1d_avx2(v, CONST_BITS+PASS1_BITS+3);
+  transpose8_avx2(v);
+
+  for (i = 0; i < DCTSIZE; i++)
+    store_idct_row(output_buf[i] + output_col, _mm256_castsi256_si128(v[i]),
+		   _mm256_extracti128_si256(v[i], 1));
+}
+
+JSIMD_TARGET("avx2")
+LOCAL(void)
+fdct_islow_avx2 (DCTELEM * data)
+{
+  __m256i v[DCTSIZE];
+  int i;
+
+  for (i = 0; i < DCTSIZE; i++)
+    v[i] = load_dctelem8(data + i*DCTSIZE);
+
+  /* Pass 1: process rows */
+  transpose8_avx2(v);
+  fdct_1d_avx2(v, 1);
+  transpose8_avx2(v);
+
+  /* Pass 2: process columns */
+  fdct_1d_avx2(v, 2);
+
+  for (i = 0; i < DCTSIZE; i++)
+    store_dctelem8(data + i*DCTSIZE, v[i]);
+}
+
+/* Quantize eight coefficients, see quantize4_sse41. */
+
+JSIMD_TARGET("avx2")
+LOCAL(void)
+quantize_avx2 (JCOEFPTR coef_block, DCTELEM * divisors, DCTELEM * workspace)
+{
+  __m256i coef, qval, a, q, r;
+  int i;
+
+  for (i = 0; i < DCTSIZE2; i += 8) {
+    coef = load_dctelem8(workspace + i);
+    qval = load_dctelem8(divisors + i);
+    a = _mm256_add_epi32(_mm256_abs_epi32(coef), _mm256_srai_epi32(qval, 1));
+    q = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(a), _mm256_cvtepi32_ps(qval)));
+    r = _mm256_sub_epi32(a, _mm256_mullo_epi32(q, qval));
+    q = _mm256_sub_epi32(q, _mm256_cmpgt_epi32(_mm256_add_epi32(r, _mm256_set1_epi32(1)), qval));
+    q = _mm256_add_epi32(q, _mm256_cmpgt_epi32(_mm256_setzero_si256(), r));
+    q = _mm256_sign_epi32(q, coef);
+    /* truncate to JCOEF like the cast in the portable code */
+    q = _mm256_srai_epi32(_mm256_slli_epi32(q, 16), 16);
+    _mm_storeu_si128((__m128i *) (coef_block + i),
+		     _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1)));
+  }
+}
+
+/* Convert 8 pixels (16-bit lanes) from YCbCr to RGB. */
+
+JSIMD_TARGET("avx2")
+static INLINE __m128i
+pack_avx2 (__m256i v)
+{
+  return _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+JSIMD_TARGET("avx2")
+static INLINE void
+ycc_rgb8_avx2 (__m128i y16, __m128i cb16, __m128i cr16,
+	       __m128i * r, __m128i * g, __m128i * b)
+{
+  const __m256i center = _mm256_set1_epi32(CENTERJSAMPLE);
+  const __m256i half = _mm256_set1_epi32(ONE_HALF);
+  __m256i y = _mm256_cvtepi16_epi32(y16);
+  __m256i cb = _mm256_sub_epi32(_mm256_cvtepi16_epi32(cb16), center);
+  __m256i cr = _mm256_sub_epi32(_mm256_cvtepi16_epi32(cr16), center);
+
+  *r = pack_avx2(_mm256_add_epi32(y, _mm256_srai_epi32(_mm256_add_epi32(mul_avx2(cr, CFIX(1.40200)), half),
+						       SCALEBITS)));
+  *g = pack_avx2(_mm256_add_epi32(y, _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(mul_avx2(cb, - CFIX(0.34414)),
+											mul_avx2(cr, - CFIX(0.71414))),
+									half), SCALEBITS)));
+  *b = pack_avx2(_mm256_add_epi32(y, _mm256_srai_epi32(_mm256_add_epi32(mul_avx2(cb, CFIX(1.77200)), half),
+						       SCALEBITS)));
+}
+
+/* Convert 8 pixels (16-bit lanes) from RGB to YCbCr. */
+
+JSIMD_TARGET("avx2")
+static INLINE void
+rgb_ycc8_avx2 (__m128i r16, __m128i g16, __m128i b16,
+	       __m128i * y, __m128i * cb, __m128i * cr)
+{
+  const __m256i offset = _mm256_set1_epi32(CBCR_OFFSET + ONE_HALF-1);
+  __m256i r = _mm256_cvtepu16_epi32(r16);
+  __m256i g = _mm256_cvtepu16_epi32(g16);
+  __m256i b = _mm256_cvtepu16_epi32(b16);
+
+  *y = pack_avx2(_mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(mul_avx2(r, CFIX(0.29900)), mul_avx2(g, CFIX(0.58700))),
+						    _mm256_add_epi32(mul_avx2(b, CFIX(0.11400)), _mm256_set1_epi32(ONE_HALF))),
+				   SCALEBITS));
+  *cb = pack_avx2(_mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(mul_avx2(r, - CFIX(0.16874)), mul_avx2(g, - CFIX(0.33126))),
+						     _mm256_add_epi32(mul_avx2(b, CFIX(0.50000)), offset)),
+				    SCALEBITS));
+  *cr = pack_avx2(_mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(mul_avx2(r, CFIX(0.50000)), mul_avx2(g, - CFIX(0.41869))),
+						     _mm256_add_epi32(mul_avx2(b, - CFIX(0.08131)), offset)),
+				    SCALEBITS));
+}
+
+
+/**************** Color conversion **************/
+
+/* Convert one vector of pixels (SIMD_PIXELS) from YCbCr to interleaved RGB.
+ * The level parameter is a constant in each instantiation, so the compiler
+ * removes the unused branch.
+ */
+
+#define YCC_RGB8(level, y, cb, cr, r, g, b) \
+  if ((level) == JSIMD_AVX2) ycc_rgb8_avx2(y, cb, cr, r, g, b); \
+  else ycc_rgb8_sse41(y, cb, cr, r, g, b)
+
+#define RGB_YCC8(level, r, g, b, y, cb, cr) \
+  if ((level) == JSIMD_AVX2) rgb_ycc8_avx2(r, g, b, y, cb, cr); \
+  else rgb_ycc8_sse41(r, g, b, y, cb, cr)
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+ycc_rgb_vector (int level, JSAMPROW inptr0, JSAMPROW inptr1, JSAMPROW inptr2,
+		JSAMPROW outptr)
+{
+  __m128i y = _mm_loadu_si128((const __m128i *) inptr0);
+  __m128i cb = _mm_loadu_si128((const __m128i *) inptr1);
+  __m128i cr = _mm_loadu_si128((const __m128i *) inptr2);
+  __m128i planes[3];
+  __m128i r, g, b;
+#if BITS_IN_JSAMPLE == 8
+  const __m128i zero = _mm_setzero_si128();
+  __m128i r1, g1, b1;
+
+  YCC_RGB8(level, _mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi8(cb, zero),
+	   _mm_unpacklo_epi8(cr, zero), &r, &g, &b);
+  YCC_RGB8(level, _mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi8(cb, zero),
+	   _mm_unpackhi_epi8(cr, zero), &r1, &g1, &b1);
+  /* saturation performs the range limiting */
+  planes[RGB_RED] = _mm_packus_epi16(r, r1);
+  planes[RGB_GREEN] = _mm_packus_epi16(g, g1);
+  planes[RGB_BLUE] = _mm_packus_epi16(b, b1);
+#else
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i maxval = _mm_set1_epi16(MAXJSAMPLE);
+
+  YCC_RGB8(level, y, cb, cr, &r, &g, &b);
+  planes[RGB_RED] = _mm_min_epi16(_mm_max_epi16(r, zero), maxval);
+  planes[RGB_GREEN] = _mm_min_epi16(_mm_max_epi16(g, zero), maxval);
+  planes[RGB_BLUE] = _mm_min_epi16(_mm_max_epi16(b, zero), maxval);
+#endif
+  interleave_pixels(planes[0], planes[1], planes[2], outptr);
+}
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+rgb_ycc_vector (int level, JSAMPROW inptr, JSAMPROW outptr0,
+		JSAMPROW outptr1, JSAMPROW outptr2)
+{
+  const __m128i * ptr = (const __m128i *) inptr;
+  __m128i in0 = _mm_loadu_si128(ptr);
+  __m128i in1 = _mm_loadu_si128(ptr + 1);
+  __m128i in2 = _mm_loadu_si128(ptr + 2);
+  __m128i planes[3];
+  __m128i y, cb, cr;
+
+  planes[0] = deinterleave_plane(in0, in1, in2, 0);
+  planes[1] = deinterleave_plane(in0, in1, in2, 1);
+  planes[2] = deinterleave_plane(in0, in1, in2, 2);
+#if BITS_IN_JSAMPLE == 8
+  {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i y1, cb1, cr1;
+
+    RGB_YCC8(level, _mm_unpacklo_epi8(planes[RGB_RED], zero), _mm_unpacklo_epi8(planes[RGB_GREEN], zero),
+	     _mm_unpacklo_epi8(planes[RGB_BLUE], zero), &y, &cb, &cr);
+    RGB_YCC8(level, _mm_unpackhi_epi8(planes[RGB_RED], zero), _mm_unpackhi_epi8(planes[RGB_GREEN], zero),
+	     _mm_unpackhi_epi8(planes[RGB_BLUE], zero), &y1, &cb1, &cr1);
+    y = _mm_packus_epi16(y, y1);
+    cb = _mm_packus_epi16(cb, cb1);
+    cr = _mm_packus_epi16(cr, cr1);
+  }
+#else
+  RGB_YCC8(level, planes[RGB_RED], planes[RGB_GREEN], planes[RGB_BLUE], &y, &cb, &cr);
+#endif
+  _mm_storeu_si128((__m128i *) outptr0, y);
+  _mm_storeu_si128((__m128i *) outptr1, cb);
+  _mm_storeu_si128((__m128i *) outptr2, cr);
+}
+
+/* The row loops are instantiated for each instruction set, so that the
+ * vector routines can be inlined.  The remaining pixels of each row are
+ * converted via a temporary buffer.
+ */
+
+#define YCC_RGB_ROWS(level) \
+  { \
+    JSAMPLE in0[SIMD_PIXELS], in1[SIMD_PIXELS], in2[SIMD_PIXELS]; \
+    JSAMPLE out[SIMD_PIXELS * 3]; \
+    JSAMPROW inptr0, inptr1, inptr2, outptr; \
+    JDIMENSION col, rest; \
+    while (--num_rows >= 0) { \
+      inptr0 = input_buf[0][input_row]; \
+      inptr1 = input_buf[1][input_row]; \
+      inptr2 = input_buf[2][input_row]; \
+      input_row++; \
+      outptr = *output_buf++; \
+      for (col = 0; col + SIMD_PIXELS <= num_cols; col += SIMD_PIXELS) \
+	ycc_rgb_vector(level, inptr0 + col, inptr1 + col, inptr2 + col, outptr + col * 3); \
+      if (col < num_cols) { \
+	rest = num_cols - col; \
+	MEMZERO(in0, SIZEOF(in0)); \
+	MEMZERO(in1, SIZEOF(in1)); \
+	MEMZERO(in2, SIZEOF(in2)); \
+	MEMCOPY(in0, inptr0 + col, rest * SIZEOF(JSAMPLE)); \
+	MEMCOPY(in1, inptr1 + col, rest * SIZEOF(JSAMPLE)); \
+	MEMCOPY(in2, inptr2 + col, rest * SIZEOF(JSAMPLE)); \
+	ycc_rgb_vector(level, in0, in1, in2, out); \
+	MEMCOPY(outptr + col * 3, out, rest * 3 * SIZEOF(JSAMPLE)); \
+      } \
+    } \
+  }
+
+#define RGB_YCC_ROWS(level) \
+  { \
+    JSAMPLE in[SIMD_PIXELS * 3]; \
+    JSAMPLE out0[SIMD_PIXELS], out1[SIMD_PIXELS], out2[SIMD_PIXELS]; \
+    JSAMPROW inptr, outptr0, outptr1, outptr2; \
+    JDIMENSION col, rest; \
+    while (--num_rows >= 0) { \
+      inptr = *input_buf++; \
+      outptr0 = output_buf[0][output_row]; \
+      outptr1 = output_buf[1][output_row]; \
+      outptr2 = output_buf[2][output_row]; \
+      output_row++; \
+      for (col = 0; col + SIMD_PIXELS <= num_cols; col += SIMD_PIXELS) \
+	rgb_ycc_vector(level, inptr + col * 3, outptr0 + col, outptr1 + col, outptr2 + col); \
+      if (col < num_cols) { \
+	rest = num_cols - col; \
+	MEMZERO(in, SIZEOF(in)); \
+	MEMCOPY(in, inptr + col * 3, rest * 3 * SIZEOF(JSAMPLE)); \
+	rgb_ycc_vector(level, in, out0, out1, out2); \
+	MEMCOPY(outptr0 + col, out0, rest * SIZEOF(JSAMPLE)); \
+	MEMCOPY(outptr1 + col, out1, rest * SIZEOF(JSAMPLE)); \
+	MEMCOPY(outptr2 + col, out2, rest * SIZEOF(JSAMPLE)); \
+      } \
+    } \
+  }
+
+JSIMD_TARGET("avx2")
+LOCAL(void)
+ycc_rgb_convert_avx2 (JSAMPIMAGE input_buf, JDIMENSION input_row,
+		      JSAMPARRAY output_buf, int num_rows, JDIMENSION num_cols)
+YCC_RGB_ROWS(JSIMD_AVX2)
+
+JSIMD_TARGET("sse4.1")
+LOCAL(void)
+ycc_rgb_convert_sse41 (JSAMPIMAGE input_buf, JDIMENSION input_row,
+		       JSAMPARRAY output_buf, int num_rows, JDIMENSION num_cols)
+YCC_RGB_ROWS(JSIMD_SSE41)
+
+JSIMD_TARGET("avx2")
+LOCAL(void)
+rgb_ycc_convert_avx2 (JSAMPARRAY input_buf, JSAMPIMAGE output_buf,
+		      JDIMENSION output_row, int num_rows, JDIMENSION num_cols)
+RGB_YCC_ROWS(JSIMD_AVX2)
+
+JSIMD_TARGET("sse4.1")
+LOCAL(void)
+rgb_ycc_convert_sse41 (JSAMPARRAY input_buf, JSAMPIMAGE output_buf,
+		       JDIMENSION output_row, int num_rows, JDIMENSION num_cols)
+RGB_YCC_ROWS(JSIMD_SSE41)
+
+
+/**************** Upsampling **************/
+
+/* The upsampling routines work on 16-bit lanes, which is sufficient for
+ * the intermediate values of 8-bit and 12-bit samples.  Only 128-bit
+ * vectors are used, since the routines are limited by memory bandwidth.
+ */
+
+JSIMD_TARGET("sse4.1")
+static INLINE __m128i
+load_words_lo (JSAMPROW ptr)
+{
+#if BITS_IN_JSAMPLE == 8
+  return _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *) ptr));
+#else
+  return _mm_loadu_si128((const __m128i *) ptr);
+#endif
+}
+
+JSIMD_TARGET("sse4.1")
+static INLINE void
+store_words (JSAMPROW ptr, __m128i even, __m128i odd)
+{
+#if BITS_IN_JSAMPLE == 8
+  /* input values are at most MAXJSAMPLE, i.e. no saturation occurs */
+  __m128i v = _mm_packus_epi16(even, odd);
+  _mm_storeu_si128((__m128i *) ptr, _mm_unpacklo_epi8(v, _mm_srli_si128(v, 8)));
+#else
+  _mm_storeu_si128((__m128i *) ptr, _mm_unpacklo_epi16(even, odd));
+  _mm_storeu_si128((__m128i *) ptr + 1, _mm_unpackhi_epi16(even, odd));
+#endif
+}
+
+JSIMD_TARGET("sse4.1")
+LOCAL(void)
+h2v1_fancy_upsample_sse41 (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+			   JSAMPARRAY input_data, JSAMPARRAY * output_data_ptr)
+{
+  JSAMPARRAY output_data = *output_data_ptr;
+  const JDIMENSION width = compptr->downsampled_width;
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i two = _mm_set1_epi16(2);
+  JSAMPROW inptr, outptr;
+  __m128i cur, prev, next;
+  int invalue;
+  JDIMENSION col;
+  int inrow;
+
+  for (inrow = 0; inrow < cinfo->max_v_samp_factor; inrow++) {
+    inptr = input_data[inrow];
+    outptr = output_data[inrow];
+    /* Special case for first column */
+    invalue = GETJSAMPLE(inptr[0]);
+    outptr[0] = (JSAMPLE) invalue;
+    outptr[1] = (JSAMPLE) ((invalue * 3 + GETJSAMPLE(inptr[1]) + 2) >> 2);
+
+    /* General case: 3/4 * nearer pixel + 1/4 * further pixel */
+    for (col = 1; col + 9 <= width; col += 8) {
+      cur = load_words_lo(inptr + col);
+      prev = load_words_lo(inptr + col - 1);
+      next = load_words_lo(inptr + col + 1);
+      cur = _mm_add_epi16(cur, _mm_add_epi16(cur, cur));
+      store_words(outptr + 2 * col,
+		  _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(cur, prev), one), 2),
+		  _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(cur, next), two), 2));
+    }
+    for (; col < width - 1; col++) {
+      invalue = GETJSAMPLE(inptr[col]) * 3;
+      outptr[2 * col] = (JSAMPLE) ((invalue + GETJSAMPLE(inptr[col - 1]) + 1) >> 2);
+      outptr[2 * col + 1] = (JSAMPLE) ((invalue + GETJSAMPLE(inptr[col + 1]) + 2) >> 2);
+    }
+
+    /* Special case for last column */
+    invalue = GETJSAMPLE(inptr[width - 1]);
+    outptr[2 * width - 2] = (JSAMPLE) ((invalue * 3 + GETJSAMPLE(inptr[width - 2]) + 1) >> 2);
+    outptr[2 * width - 1] = (JSAMPLE) invalue;
+  }
+}
+
+JSIMD_TARGET("sse4.1")
+static INLINE __m128i
+colsum_words (JSAMPROW inptr0, JSAMPROW inptr1)
+{
+  __m128i v = load_words_lo(inptr0);
+  return _mm_add_epi16(_mm_add_epi16(v, _mm_add_epi16(v, v)), load_words_lo(inptr1));
+}
+
+JSIMD_TARGET("sse4.1")
+LOCAL(void)
+h2v2_fancy_upsample_sse41 (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+			   JSAMPARRAY input_data, JSAMPARRAY * output_data_ptr)
+{
+  JSAMPARRAY output_data = *output_data_ptr;
+  const JDIMENSION width = compptr->downsampled_width;
+  const __m128i seven = _mm_set1_epi16(7);
+  const __m128i eight = _mm_set1_epi16(8);
+  JSAMPROW inptr0, inptr1, outptr;
+  __m128i cur, prev, next;
+  IJG_INT32 thiscolsum, lastcolsum, nextcolsum;
+  JDIMENSION col;
+  int inrow, outrow, v;
+
+  inrow = outrow = 0;
+  while (outrow < cinfo->max_v_samp_factor) {
+    for (v = 0; v < 2; v++) {
+      /* inptr0 points to nearest input row, inptr1 points to next nearest */
+      inptr0 = input_data[inrow];
+      if (v == 0)		/* next nearest is row above */
+	inptr1 = input_data[inrow-1];
+      else			/* next nearest is row below */
+	inptr1 = input_data[inrow+1];
+      outptr = output_data[outrow++];
+
+      /* Special case for first column */
+      thiscolsum = GETJSAMPLE(inptr0[0]) * 3 + GETJSAMPLE(inptr1[0]);
+      nextcolsum = GETJSAMPLE(inptr0[1]) * 3 + GETJSAMPLE(inptr1[1]);
+      outptr[0] = (JSAMPLE) ((thiscolsum * 4 + 8) >> 4);
+      outptr[1] = (JSAMPLE) ((thiscolsum * 3 + nextcolsum + 7) >> 4);
+
+      /* General case: 9/16, 3/16, 3/16, 1/16 of the four nearest pixels */
+      for (col = 1; col + 9 <= width; col += 8) {
+	cur = colsum_words(inptr0 + col, inptr1 + col);
+	prev = colsum_words(inptr0 + col - 1, inptr1 + col - 1);
+	next = colsum_words(inptr0 + col + 1, inptr1 + col + 1);
+	cur = _mm_add_epi16(cur, _mm_add_epi16(cur, cur));
+	store_words(outptr + 2 * col,
+		    _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(cur, prev), eight), 4),
+		    _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(cur, next), seven), 4));
+      }
+      lastcolsum = GETJSAMPLE(inptr0[col - 1]) * 3 + GETJSAMPLE(inptr1[col - 1]);
+      thiscolsum = GETJSAMPLE(inptr0[col]) * 3 + GETJSAMPLE(inptr1[col]);
+      for (; col < width - 1; col++) {
+	nextcolsum = GETJSAMPLE(inptr0[col + 1]) * 3 + GETJSAMPLE(inptr1[col + 1]);
+	outptr[2 * col] = (JSAMPLE) ((thiscolsum * 3 + lastcolsum + 8) >> 4);
+	outptr[2 * col + 1] = (JSAMPLE) ((thiscolsum * 3 + nextcolsum + 7) >> 4);
+	lastcolsum = thiscolsum; thiscolsum = nextcolsum;
+      }
+
+      /* Special case for last column */
+      outptr[2 * col] = (JSAMPLE) ((thiscolsum * 3 + lastcolsum + 8) >> 4);
+      outptr[2 * col + 1] = (JSAMPLE) ((thiscolsum * 4 + 7) >> 4);
+    }
+    inrow++;
+  }
+}
+
+#endif /* JSIMD_X86 */
+
+
+/*
+ * Entry points called by the DCT managers, the color converters and the
+ * upsampler.  They must only be used if jpeg_simd_level() != JSIMD_NONE.
+ */
+
+GLOBAL(void)
+jsimd_idct_islow (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+		  JCOEFPTR coef_block,
+		  JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+#ifdef JSIMD_X86
+  if (ac_coefs_zero(coef_block))
+    idct_dc_only(cinfo, compptr, coef_block, output_buf, output_col);
+  else if (jpeg_simd_level() == JSIMD_AVX2)
+    idct_islow_avx2(compptr, coef_block, output_buf, output_col);
+  else
+    idct_islow_sse41(compptr, coef_block, output_buf, output_col);
+#endif
+}
+
+GLOBAL(void)
+jsimd_fdct_islow (DCTELEM * data)
+{
+#ifdef JSIMD_X86
+  if (jpeg_simd_level() == JSIMD_AVX2)
+    fdct_islow_avx2(data);
+  else
+    fdct_islow_sse41(data);
+#endif
+}
+
+GLOBAL(void)
+jsimd_quantize (JCOEFPTR coef_block, DCTELEM * divisors, DCTELEM * workspace)
+{
+#ifdef JSIMD_X86
+  if (jpeg_simd_level() == JSIMD_AVX2)
+    quantize_avx2(coef_block, divisors, workspace);
+  else
+    quantize_sse41(coef_block, divisors, workspace);
+#endif
+}
+
+GLOBAL(void)
+jsimd_ycc_rgb_convert (j_decompress_ptr cinfo,
+		       JSAMPIMAGE input_buf, JDIMENSION input_row,
+		       JSAMPARRAY output_buf, int num_rows)
+{
+#ifdef JSIMD_X86
+  if (jpeg_simd_level() == JSIMD_AVX2)
+    ycc_rgb_convert_avx2(input_buf, input_row, output_buf, num_rows, cinfo->output_width);
+  else
+    ycc_rgb_convert_sse41(input_buf, input_row, output_buf, num_rows, cinfo->output_width);
+#endif
+}
+
+GLOBAL(void)
+jsimd_rgb_ycc_convert (j_compress_ptr cinfo,
+		       JSAMPARRAY input_buf, JSAMPIMAGE output_buf,
+		       JDIMENSION output_row, int num_rows)
+{
+#ifdef JSIMD_X86
+  if (jpeg_simd_level() == JSIMD_AVX2)
+    rgb_ycc_convert_avx2(input_buf, output_buf, output_row, num_rows, cinfo->image_width);
+  else
+    rgb_ycc_convert_sse41(input_buf, output_buf, output_row, num_rows, cinfo->image_width);
+#endif
+}
+
+GLOBAL(void)
+jsimd_h2v1_fancy_upsample (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+			   JSAMPARRAY input_data, JSAMPARRAY * output_data_ptr)
+{
+#ifdef JSIMD_X86
+  h2v1_fancy_upsample_sse41(cinfo, compptr, input_data, output_data_ptr);
+#endif
+}
+
+GLOBAL(void)
+jsimd_h2v2_fancy_upsample (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+			   JSAMPARRAY input_data, JSAMPARRAY * output_data_ptr)
+{
+#ifdef JSIMD_X86
+  h2v2_fancy_upsample_sse41(cinfo, compptr, input_data, output_data_ptr);
+#endif
+}
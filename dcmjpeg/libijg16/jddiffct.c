@@ -204,14 +204,21 @@ decompress_data (j_decompress_ptr cinfo, JSAMPIMAGE output_buf)
      row < (cinfo->input_iMCU_row == last_iMCU_row ?
         compptr->last_row_height : compptr->v_samp_factor);
      prev_row = row, row++) {
-      (*losslsd->predict_undifference[ci]) (cinfo, ci,
-                        diff->diff_buf[ci][row],
-                        diff->undiff_buf[ci][prev_row],
-                        diff->undiff_buf[ci][row],
-                        compptr->width_in_data_units);
-      (*losslsd->scaler_scale) (cinfo, diff->undiff_buf[ci][row],
-                output_buf[ci][row],
-                compptr->width_in_data_units);
+      if (losslsd->entropy_undifference) {
+        /* The entropy decoder has already undifferenced the samples */
+        (*losslsd->scaler_scale) (cinfo, diff->diff_buf[ci][row],
+                  output_buf[ci][row],
+                  compptr->width_in_data_units);
+      } else {
+        (*losslsd->predict_undifference[ci]) (cinfo, ci,
+                          diff->diff_buf[ci][row],
+                          diff->undiff_buf[ci][prev_row],
+                          diff->undiff_buf[ci][row],
+                          compptr->width_in_data_units);
+        (*losslsd->scaler_scale) (cinfo, diff->undiff_buf[ci][row],
+                  output_buf[ci][row],
+                  compptr->width_in_data_units);
+      }
     }
   }
 
@@ -27,6 +27,26 @@ typedef struct {
   int ci, yoffset, MCU_width;
 } lhd_output_ptr_info;
 
+/*
+ * DCMTK specific code: lookahead table for the fast path used for scans
+ * with a single component (see decode_mcus_single).  In contrast to the
+ * lookahead table of d_derived_tbl, the entries also cover the additional
+ * bits following the Huffman code, so that most sample differences are
+ * decoded with a single table lookup.
+ */
+
+#define LHUFF_LOOKAHEAD	12	/* # of bits of lookahead */
+
+typedef struct {
+  /* # bits of the Huffman code and the additional bits, or 0 if the
+   * Huffman code is longer than LHUFF_LOOKAHEAD bits */
+  UINT8 look_nbits[1<<LHUFF_LOOKAHEAD];
+  /* # bits of the Huffman code only */
+  UINT8 look_codebits[1<<LHUFF_LOOKAHEAD];
+  /* sample difference, valid only if look_nbits <= LHUFF_LOOKAHEAD */
+  JDIFF look_diff[1<<LHUFF_LOOKAHEAD];
+} lhd_fast_tbl;
+
 /*
  * Private entropy decoder object for lossless Huffman decoding.
  */
@@ -60,10 +80,56 @@ typedef struct {
   /* Index of the proper output pointer for each data unit within an MCU */
   int output_ptr_index[D_MAX_DATA_UNITS_IN_MCU];
 
+  /* Lookahead tables for the fast path (these workspaces have image lifespan) */
+  lhd_fast_tbl * fast_tbls[NUM_HUFF_TBLS];
+
+  /* TRUE until the first row of a scan or restart interval has been
+   * decoded (needed if the fast path also undifferences the samples) */
+  boolean first_row;
+
 } lhuff_entropy_decoder;
 
 typedef lhuff_entropy_decoder * lhuff_entropy_ptr;
 
+/* Forward declarations */
+METHODDEF(JDIMENSION) decode_mcus
+    JPP((j_decompress_ptr cinfo, JDIFFIMAGE diff_buf,
+         JDIMENSION MCU_row_num, JDIMENSION MCU_col_num, JDIMENSION nMCU));
+METHODDEF(JDIMENSION) decode_mcus_single
+    JPP((j_decompress_ptr cinfo, JDIFFIMAGE diff_buf,
+         JDIMENSION MCU_row_num, JDIMENSION MCU_col_num, JDIMENSION nMCU));
+LOCAL(void) make_fast_tbl
+    JPP((j_decompress_ptr cinfo, d_derived_tbl * dtbl, lhd_fast_tbl ** pftbl));
+
+
+/*
+ * DCMTK specific code: the fast path is enabled by default.  The flag may be
+ * changed by another thread, so it is accessed atomically (if supported by
+ * the compiler).
+ */
+
+static volatile int use_fast_path = TRUE;
+
+GLOBAL(void)
+jpeg_lossless_set_fast_path (boolean enable)
+{
+#ifdef __ATOMIC_RELAXED
+  __atomic_store_n(&use_fast_path, enable ? TRUE : FALSE, __ATOMIC_RELAXED);
+#else
+  use_fast_path = enable ? TRUE : FALSE;
+#endif
+}
+
+LOCAL(boolean)
+fast_path_enabled (void)
+{
+#ifdef __ATOMIC_RELAXED
+  return __atomic_load_n(&use_fast_path, __ATOMIC_RELAXED) ? TRUE : FALSE;
+#else
+  return use_fast_path ? TRUE : FALSE;
+#endif
+}
+
 
 /*
  * Initialize for a Huffman-compressed scan.
@@ -109,6 +175,26 @@ start_pass_lhuff_decoder (j_decompress_ptr cinfo)
   }
   entropy->num_output_ptrs = ptrn;
 
+  /* Use the fast path for scans with a single component (i.e. one sample
+   * per MCU).  With the first order predictor (selection value 1), which
+   * is used by most lossless JPEG images, the samples are also undifferenced
+   * by the fast path, provided that every row of the component is a separate
+   * MCU row.  The fast path can be disabled for testing purposes (see
+   * jpeg_lossless_set_fast_path).
+   */
+  compptr = cinfo->cur_comp_info[0];
+  if (cinfo->data_units_in_MCU == 1 && fast_path_enabled()) {
+    make_fast_tbl(cinfo, entropy->cur_tbls[0],
+		  & entropy->fast_tbls[compptr->dc_tbl_no]);
+    losslsd->entropy_decode_mcus = decode_mcus_single;
+    losslsd->entropy_undifference = (cinfo->Ss == 1 &&
+				     compptr->v_samp_factor == 1);
+  } else {
+    losslsd->entropy_decode_mcus = decode_mcus;
+    losslsd->entropy_undifference = FALSE;
+  }
+  entropy->first_row = TRUE;
+
   /* Initialize bitread state variables */
   entropy->bitstate.bits_left = 0;
   entropy->bitstate.get_buffer = 0; /* unnecessary, but keeps Purify quiet */
@@ -142,6 +228,61 @@ static const int extend_offset[16] = /* entry n is (-1 << n) + 1 */
 #endif /* AVOID_TABLES */
 
 
+/*
+ * Compute the lookahead table for the fast path from a derived table.
+ * The symbols have already been validated by jpeg_make_d_derived_tbl.
+ */
+
+LOCAL(void)
+make_fast_tbl (j_decompress_ptr cinfo, d_derived_tbl * dtbl,
+	       lhd_fast_tbl ** pftbl)
+{
+  JHUFF_TBL *htbl = dtbl->pub;
+  lhd_fast_tbl *ftbl;
+  int p, i, l, s, nbits, lookbits, ctr, r;
+  unsigned int code;
+
+  /* Allocate a workspace if we haven't already done so. */
+  if (*pftbl == NULL)
+    *pftbl = (lhd_fast_tbl *)
+      (*cinfo->mem->alloc_small) ((j_common_ptr) cinfo, JPOOL_IMAGE,
+				  SIZEOF(lhd_fast_tbl));
+  ftbl = *pftbl;
+
+  /* All entries are set to 0 first, indicating "too long" */
+  MEMZERO(ftbl->look_nbits, SIZEOF(ftbl->look_nbits));
+
+  /* Generate the codes as in Figure C.2 and fill in all the entries that
+   * correspond to bit sequences starting with a code that is short enough.
+   */
+  code = 0;
+  p = 0;
+  for (l = 1; l <= LHUFF_LOOKAHEAD; l++) {
+    for (i = 1; i <= (int) htbl->bits[l]; i++, p++, code++) {
+      s = htbl->huffval[p];
+      /* no additional bits follow for s = 16 (difference 32768) */
+      nbits = (s == 16) ? l : l + s;
+      lookbits = (int) code << (LHUFF_LOOKAHEAD-l);
+      for (ctr = 0; ctr < (1 << (LHUFF_LOOKAHEAD-l)); ctr++) {
+	ftbl->look_nbits[lookbits + ctr] = (UINT8) nbits;
+	ftbl->look_codebits[lookbits + ctr] = (UINT8) l;
+	if (nbits <= LHUFF_LOOKAHEAD) {
+	  if (s == 0)
+	    ftbl->look_diff[lookbits + ctr] = 0;
+	  else if (s == 16)
+	    ftbl->look_diff[lookbits + ctr] = 32768;
+	  else {
+	    r = (ctr >> (LHUFF_LOOKAHEAD - nbits)) & ((1 << s) - 1);
+	    ftbl->look_diff[lookbits + ctr] = (JDIFF) HUFF_EXTEND(r, s);
+	  }
+	}
+      }
+    }
+    code <<= 1;
+  }
+}
+
+
 /*
  * Check for a restart marker & resynchronize decoder.
  * Returns FALSE if must suspend.
@@ -171,6 +312,9 @@ process_restart (j_decompress_ptr cinfo)
   if (cinfo->unread_marker == 0)
     entropy->insufficient_data = FALSE;
 
+  /* The predictor is reset by the undifferencer (see jddiffct.c) */
+  entropy->first_row = TRUE;
+
   return TRUE;
 }
 
@@ -263,6 +407,143 @@ decode_mcus (j_decompress_ptr cinfo, JDIFFIMAGE diff_buf,
 }
 
 
+/*
+ * Fast path of decode_mcus for scans with a single component, i.e. the MCU
+ * consists of a single sample.  Most sample differences are decoded with the
+ * lookahead table of make_fast_tbl; the remaining ones (long Huffman codes
+ * or not enough bits in the buffer) are decoded as in decode_mcus.
+ *
+ * If losslsd->entropy_undifference is TRUE, the samples are also
+ * undifferenced with the first order predictor, and the reconstructed
+ * samples are stored in diff_buf instead of the differences (see jdpred.c
+ * for the predictors, the results are identical).  This avoids a separate
+ * pass over the samples in jddiffct.c.
+ *
+ * The bitread state is only saved before operations that might suspend,
+ * i.e. before calling jpeg_fill_bit_buffer, since it is not changed
+ * otherwise.  Note that the state must always correspond to the beginning
+ * of a sample.  Returns the number of MCUs decoded, see decode_mcus.
+ */
+
+METHODDEF(JDIMENSION)
+decode_mcus_single (j_decompress_ptr cinfo, JDIFFIMAGE diff_buf,
+		    JDIMENSION MCU_row_num, JDIMENSION MCU_col_num,
+		    JDIMENSION nMCU)
+{
+  j_lossless_d_ptr losslsd = (j_lossless_d_ptr) cinfo->codec;
+  lhuff_entropy_ptr entropy = (lhuff_entropy_ptr) losslsd->entropy_private;
+  d_derived_tbl * dctbl = entropy->cur_tbls[0];
+  lhd_fast_tbl * ftbl =
+    entropy->fast_tbls[cinfo->cur_comp_info[0]->dc_tbl_no];
+  boolean undifference = losslsd->entropy_undifference;
+  /* Predictor for the first column of the first row: 2^(P-Pt-1) */
+  int initial_predictor = 1 << (cinfo->data_precision - cinfo->Al - 1);
+  JDIFFROW output_ptr;
+  unsigned int mcu_num;
+  int Ra;
+  register int s, r, nb, look;
+  BITREAD_STATE_VARS;
+
+  output_ptr = diff_buf[entropy->output_ptr_info[0].ci][MCU_row_num] +
+    MCU_col_num;
+
+  /*
+   * If we've run out of data, zero out the differences and reset the
+   * undifferencer (see decode_mcus).  If the samples are undifferenced here,
+   * this results in all samples being equal to the initial predictor.
+   */
+  if (entropy->insufficient_data) {
+    if (undifference) {
+      for (mcu_num = 0; mcu_num < nMCU; mcu_num++)
+	output_ptr[mcu_num] = (JDIFF) (initial_predictor & 0xFFFF);
+      entropy->first_row = TRUE;
+    } else
+      jzero_far((void FAR *) output_ptr, nMCU * SIZEOF(JDIFF));
+
+    (*losslsd->predict_process_restart) (cinfo);
+    return nMCU;
+  }
+
+  /* Predictor for the first sample: Ra, or Rb in the first column (which
+   * still contains the first sample of the previous row, since the MCU row
+   * buffer is reused), or the initial predictor in the first row.
+   */
+  if (MCU_col_num > 0)
+    Ra = output_ptr[-1];
+  else if (entropy->first_row)
+    Ra = initial_predictor;
+  else
+    Ra = output_ptr[0];
+
+  /* Load up working state */
+  BITREAD_LOAD_STATE(cinfo,entropy->bitstate);
+
+  for (mcu_num = 0; mcu_num < nMCU; mcu_num++) {
+
+    /* Make sure that the lookahead bits are available */
+    if (bits_left < LHUFF_LOOKAHEAD) {
+      BITREAD_SAVE_STATE(cinfo,entropy->bitstate);
+      if (! jpeg_fill_bit_buffer(&br_state, get_buffer, bits_left, 0))
+	break;
+      get_buffer = br_state.get_buffer; bits_left = br_state.bits_left;
+    }
+
+    /* Section H.2.2: decode the sample difference */
+    nb = 0;
+    look = 0;
+    if (bits_left >= LHUFF_LOOKAHEAD) {
+      look = PEEK_BITS(LHUFF_LOOKAHEAD);
+      nb = ftbl->look_nbits[look];
+    }
+    if (nb != 0 && nb <= LHUFF_LOOKAHEAD) {
+      /* Huffman code and additional bits are contained in the lookahead */
+      DROP_BITS(nb);
+      s = ftbl->look_diff[look];
+    } else if (nb != 0 && nb <= bits_left) {
+      /* Huffman code is contained in the lookahead, fetch additional bits */
+      r = ftbl->look_codebits[look];
+      DROP_BITS(r);
+      s = nb - r;
+      r = GET_BITS(s);
+      s = HUFF_EXTEND(r, s);
+    } else {
+      /* Long Huffman code or end of data, do it the hard way */
+      BITREAD_SAVE_STATE(cinfo,entropy->bitstate);
+      HUFF_DECODE(s, br_state, dctbl, break, label1);
+      if (s) {
+	if (s == 16)	/* special case: always output 32768 */
+	  s = 32768;
+	else {		/* normal case: fetch subsequent bits */
+	  CHECK_BIT_BUFFER(br_state, s, break);
+	  r = GET_BITS(s);
+	  s = HUFF_EXTEND(r, s);
+	}
+      }
+    }
+
+    /* Output the sample difference or the reconstructed sample, which is
+     * calculated modulo 2^16 as in jdpred.c
+     */
+    if (undifference) {
+      Ra = (s + Ra) & 0xFFFF;
+      *output_ptr++ = (JDIFF) Ra;
+    } else
+      *output_ptr++ = (JDIFF) s;
+  }
+
+  if (mcu_num == nMCU) {
+    /* Completed all MCUs, so update state */
+    BITREAD_SAVE_STATE(cinfo,entropy->bitstate);
+  }
+  /* else: suspended, the state corresponds to the beginning of the sample */
+
+  if (mcu_num > 0 && MCU_col_num == 0)
+    entropy->first_row = FALSE;
+
+  return mcu_num;
+}
+
+
 /*
  * Module initialization routine for lossless Huffman entropy decoding.
  */
@@ -285,6 +566,7 @@ jinit_lhuff_decoder (j_decompress_ptr cinfo)
   /* Mark tables unallocated */
   for (i = 0; i < NUM_HUFF_TBLS; i++) {
     entropy->derived_tbls[i] = NULL;
+    entropy->fast_tbls[i] = NULL;
   }
 }
 
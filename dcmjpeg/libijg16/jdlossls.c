@@ -76,6 +76,7 @@ jinit_lossless_d_codec(j_decompress_ptr cinfo)
   } else {
     jinit_lhuff_decoder(cinfo);
   }
+  losslsd->entropy_undifference = FALSE;
 
   /* Undifferencer */
   jinit_undifferencer(cinfo);
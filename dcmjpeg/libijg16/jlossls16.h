@@ -118,6 +118,11 @@ typedef struct {
   /* Pointer to data which is private to entropy module */
   void *entropy_private;
 
+  /* DCMTK specific: TRUE if entropy_decode_mcus also undifferences the
+   * samples, i.e. diff_buf contains the reconstructed samples (see jdlhuff.c)
+   */
+  boolean entropy_undifference;
+
 
   /* Prediction, undifferencing */
   JMETHOD(void, predict_start_pass, (j_decompress_ptr cinfo));
@@ -950,6 +950,7 @@ typedef JMETHOD(boolean, jpeg_marker_parser_method, (j_decompress_ptr cinfo));
 #define jpeg_idct_ifast                jpeg16_idct_ifast
 #define jpeg_idct_islow                jpeg16_idct_islow
 #define jpeg_input_complete            jpeg16_input_complete
+#define jpeg_lossless_set_fast_path    jpeg16_lossless_set_fast_path
 #define jpeg_make_c_derived_tbl        jpeg16_make_c_derived_tbl
 #define jpeg_make_d_derived_tbl        jpeg16_make_d_derived_tbl
 #define jpeg_mem_available             jpeg16_mem_available
@@ -1149,6 +1150,12 @@ EXTERN(void) jpeg_destroy JPP((j_common_ptr cinfo));
 EXTERN(boolean) jpeg_resync_to_restart JPP((j_decompress_ptr cinfo,
 					    int desired));
 
+/* DCMTK specific: the fast path of the lossless Huffman decoder (see
+ * jdlhuff.c) can be disabled by the application, e.g. for testing purposes.
+ * The setting is evaluated at the start of each scan.
+ */
+EXTERN(void) jpeg_lossless_set_fast_path JPP((boolean enable));
+
 
 /* These marker codes are exported since applications and data source modules
  * are likely to want to use them.
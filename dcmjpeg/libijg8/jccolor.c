@@ -420,8 +420,12 @@ jinit_color_converter (j_compress_ptr cinfo)
     if (cinfo->num_components != 3)
       ERREXIT(cinfo, JERR_BAD_J_COLORSPACE);
     if (cinfo->in_color_space == JCS_RGB) {
-      cconvert->pub.start_pass = rgb_ycc_start;
-      cconvert->pub.color_convert = rgb_ycc_convert;
+      if (jpeg_simd_level() != JSIMD_NONE)
+	cconvert->pub.color_convert = jsimd_rgb_ycc_convert;
+      else {
+	cconvert->pub.start_pass = rgb_ycc_start;
+	cconvert->pub.color_convert = rgb_ycc_convert;
+      }
     } else if (cinfo->in_color_space == JCS_YCbCr)
       cconvert->pub.color_convert = null_convert;
     else
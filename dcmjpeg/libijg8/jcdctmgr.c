@@ -30,6 +30,9 @@ typedef struct {
    */
   DCTELEM * divisors[NUM_QUANT_TBLS];
 
+  /* TRUE if the vectorized quantization routine is used */
+  boolean simd_quantize;
+
 #ifdef DCT_FLOAT_SUPPORTED
   /* Same as above for the floating-point case. */
   float_DCT_method_ptr do_float_dct;
@@ -225,6 +228,9 @@ forward_DCT (j_compress_ptr cinfo, jpeg_component_info * compptr,
     (*do_dct) (workspace);
 
     /* Quantize/descale the coefficients, and store into coef_blocks[] */
+    if (fdct->simd_quantize)
+      jsimd_quantize(coef_blocks[bi], divisors, workspace);
+    else
     { register DCTELEM temp, qval;
       register int i;
       register JCOEFPTR output_ptr = coef_blocks[bi];
@@ -355,12 +361,16 @@ jinit_forward_dct (j_compress_ptr cinfo)
 				SIZEOF(fdct_controller));
   lossyc->fdct_private = (struct jpeg_forward_dct *) fdct;
   lossyc->fdct_start_pass = start_pass_fdctmgr;
+  fdct->simd_quantize = (jpeg_simd_level() != JSIMD_NONE);
 
   switch (cinfo->dct_method) {
 #ifdef DCT_ISLOW_SUPPORTED
   case JDCT_ISLOW:
     lossyc->fdct_forward_DCT = forward_DCT;
-    fdct->do_dct = jpeg_fdct_islow;
+    if (jpeg_simd_level() != JSIMD_NONE)
+      fdct->do_dct = jsimd_fdct_islow;
+    else
+      fdct->do_dct = jpeg_fdct_islow;
     break;
 #endif
 #ifdef DCT_IFAST_SUPPORTED
@@ -90,6 +90,9 @@ typedef FAST_FLOAT FLOAT_MULT_TYPE; /* preferred floating type */
 #define jpeg_idct_4x4		jpeg8_idct_4x4
 #define jpeg_idct_2x2		jpeg8_idct_2x2
 #define jpeg_idct_1x1		jpeg8_idct_1x1
+#define jsimd_fdct_islow		jsimd8_fdct_islow
+#define jsimd_idct_islow		jsimd8_idct_islow
+#define jsimd_quantize		jsimd8_quantize
 #endif /* NEED_SHORT_EXTERNAL_NAMES */
 
 /* Extern declarations for the forward and inverse DCT routines. */
@@ -117,6 +120,15 @@ EXTERN(void) jpeg_idct_1x1
     JPP((j_decompress_ptr cinfo, jpeg_component_info * compptr,
 	 JCOEFPTR coef_block, JSAMPARRAY output_buf, JDIMENSION output_col));
 
+/* Vectorized versions in jsimd.c (only if jpeg_simd_level() != JSIMD_NONE) */
+
+EXTERN(void) jsimd_fdct_islow JPP((DCTELEM * data));
+EXTERN(void) jsimd_quantize
+    JPP((JCOEFPTR coef_block, DCTELEM * divisors, DCTELEM * workspace));
+EXTERN(void) jsimd_idct_islow
+    JPP((j_decompress_ptr cinfo, jpeg_component_info * compptr,
+	 JCOEFPTR coef_block, JSAMPARRAY output_buf, JDIMENSION output_col));
+
 
 /*
  * Macros for handling fixed-point arithmetic; these are used by many
@@ -306,6 +306,10 @@ struct jpeg_color_quantizer {
 #define jzero_far		jzero8_far
 #define jpeg_zigzag_order		jpeg8_zigzag_order
 #define jpeg_natural_order		jpeg8_natural_order
+#define jsimd_rgb_ycc_convert		jsimd8_rgb_ycc_convert
+#define jsimd_ycc_rgb_convert		jsimd8_ycc_rgb_convert
+#define jsimd_h2v1_fancy_upsample		jsimd8_h2v1_fancy_upsample
+#define jsimd_h2v2_fancy_upsample		jsimd8_h2v2_fancy_upsample
 #endif /* NEED_SHORT_EXTERNAL_NAMES */
 
 
@@ -357,6 +361,21 @@ EXTERN(void) jcopy_sample_rows JPP((JSAMPARRAY input_array, int source_row,
 EXTERN(void) jcopy_block_row JPP((JBLOCKROW input_row, JBLOCKROW output_row,
 				  JDIMENSION num_blocks));
 EXTERN(void) jzero_far JPP((void FAR * target, size_t bytestozero));
+/* Vectorized color conversion and upsampling in jsimd.c */
+EXTERN(void) jsimd_rgb_ycc_convert JPP((j_compress_ptr cinfo,
+					JSAMPARRAY input_buf, JSAMPIMAGE output_buf,
+					JDIMENSION output_row, int num_rows));
+EXTERN(void) jsimd_ycc_rgb_convert JPP((j_decompress_ptr cinfo,
+					JSAMPIMAGE input_buf, JDIMENSION input_row,
+					JSAMPARRAY output_buf, int num_rows));
+EXTERN(void) jsimd_h2v1_fancy_upsample JPP((j_decompress_ptr cinfo,
+					    jpeg_component_info * compptr,
+					    JSAMPARRAY input_data,
+					    JSAMPARRAY * output_data_ptr));
+EXTERN(void) jsimd_h2v2_fancy_upsample JPP((j_decompress_ptr cinfo,
+					    jpeg_component_info * compptr,
+					    JSAMPARRAY input_data,
+					    JSAMPARRAY * output_data_ptr));
 /* Constant tables in jutils.c */
 #if 0				/* This table is not actually needed in v6a */
 extern const int jpeg_zigzag_order[]; /* natural coef order to zigzag order */
@@ -964,6 +964,8 @@ typedef JMETHOD(boolean, jpeg_marker_parser_method, (j_decompress_ptr cinfo));
 #define jpeg_set_linear_quality        jpeg8_set_linear_quality
 #define jpeg_set_marker_processor      jpeg8_set_marker_processor
 #define jpeg_set_quality               jpeg8_set_quality
+#define jpeg_simd_level                jpeg8_simd_level
+#define jpeg_simd_set_max_level        jpeg8_simd_set_max_level
 #define jpeg_simple_lossless           jpeg8_simple_lossless
 #define jpeg_simple_progression        jpeg8_simple_progression
 #define jpeg_start_compress            jpeg8_start_compress
@@ -981,6 +983,13 @@ typedef JMETHOD(boolean, jpeg_marker_parser_method, (j_decompress_ptr cinfo));
 #define jpeg_write_scanlines           jpeg8_write_scanlines
 #define jpeg_write_tables              jpeg8_write_tables
 #define jround_up                      jround8_up
+#define jsimd_fdct_islow               jsimd8_fdct_islow
+#define jsimd_h2v1_fancy_upsample      jsimd8_h2v1_fancy_upsample
+#define jsimd_h2v2_fancy_upsample      jsimd8_h2v2_fancy_upsample
+#define jsimd_idct_islow               jsimd8_idct_islow
+#define jsimd_quantize                 jsimd8_quantize
+#define jsimd_rgb_ycc_convert          jsimd8_rgb_ycc_convert
+#define jsimd_ycc_rgb_convert          jsimd8_ycc_rgb_convert
 #define jzero_far                      jzero8_far
 #endif /* NEED_SHORT_EXTERNAL_NAMES */
 
@@ -1144,6 +1153,17 @@ EXTERN(void) jpeg_destroy JPP((j_common_ptr cinfo));
 EXTERN(boolean) jpeg_resync_to_restart JPP((j_decompress_ptr cinfo,
 					    int desired));
 
+/* Vectorized versions of the DCT, color conversion and upsampling routines
+ * are used if supported by the processor (see jsimd.c).  The instruction set
+ * can be limited by the application, e.g. for testing purposes.
+ */
+#define JSIMD_NONE      0       /* portable C code only */
+#define JSIMD_SSE41     1       /* SSE4.1 instructions */
+#define JSIMD_AVX2      2       /* AVX2 instructions */
+
+EXTERN(int) jpeg_simd_level JPP((void));
+EXTERN(void) jpeg_simd_set_max_level JPP((int level));
+
 
 /* These marker codes are exported since applications and data source modules
  * are likely to want to use them.
@@ -23,6 +23,7 @@
 #include "dcmtk/config/osconfig.h"
 #include "dcmtk/dcmdata/dctypes.h"
 #include "dcmtk/dcmimgle/diimage.h"
+#include "dcmtk/dcmimgle/distrip.h"
 #include "dcmtk/dcmjpeg/dipijpeg.h"
 
 #define INCLUDE_CSETJMP
@@ -145,8 +146,11 @@ int DiJPEGPlugin::write(DiImage *image,
     int result = 0;
     if ((image != NULL) && (stream != NULL))
     {
-        /* create bitmap with 8 bits per sample */
-        const void *data = image->getOutputData(frame, 8 /*bits*/, 0 /*planar*/);
+        /* render bitmap with 8 bits per sample strip by strip, i.e. the complete frame is never stored in memory */
+        DiStripRenderer * volatile strips = new DiStripRenderer(image, frame, 8 /*bits*/, 0 /*rowsPerStrip*/, 0 /*planar*/);
+        unsigned long firstRow = 0;
+        unsigned long rowCount = 0;
+        const void *data = strips->getNextStrip(firstRow, rowCount);
         if (data != NULL)
         {
             const OFBool isMono = (image->getInternalColorModel() == EPI_Monochrome1) ||
@@ -177,6 +181,7 @@ int DiJPEGPlugin::write(DiImage *image,
                 (*cinfo.err->format_message)(OFreinterpret_cast(jpeg_common_struct*, &cinfo), buffer);
                 /* Release memory */
                 jpeg_destroy_compress(&cinfo);
+                delete strips;
                 image->deleteOutputData();
                 /* return error code */
                 return 0;
@@ -220,19 +225,33 @@ int DiJPEGPlugin::write(DiImage *image,
             jpeg_start_compress(&cinfo, TRUE);
             /* Process data */
             JSAMPROW row_pointer[1];
-            Uint8 *image_buffer = OFreinterpret_cast(Uint8*, OFconst_cast(void*, data));
             const size_t row_stride = cinfo.image_width * cinfo.input_components;
-            while (cinfo.next_scanline < cinfo.image_height)
+            while ((data != NULL) && (cinfo.next_scanline < cinfo.image_height))
             {
-                row_pointer[0] = &image_buffer[cinfo.next_scanline * row_stride];
-                (void)jpeg_write_scanlines(&cinfo, row_pointer, 1);
+                /* pass the rows of the current strip to the compressor */
+                Uint8 *image_buffer = OFreinterpret_cast(Uint8*, OFconst_cast(void*, data));
+                while (cinfo.next_scanline < firstRow + rowCount)
+                {
+                    row_pointer[0] = &image_buffer[(cinfo.next_scanline - firstRow) * row_stride];
+                    (void)jpeg_write_scanlines(&cinfo, row_pointer, 1);
+                }
+                if (cinfo.next_scanline < cinfo.image_height)
+                    data = strips->getNextStrip(firstRow, rowCount);
+            }
+            if (cinfo.next_scanline == cinfo.image_height)
+            {
+                /* Finish compression */
+                jpeg_finish_compress(&cinfo);
+                /* All done. */
+                result = 1;
+            } else {
+                /* rendering of a strip failed */
+                jpeg_abort_compress(&cinfo);
             }
-            /* Finish compression and release memory */
-            jpeg_finish_compress(&cinfo);
+            /* Release memory */
             jpeg_destroy_compress(&cinfo);
-            /* All done. */
-            result = 1;
         }
+        delete strips;
         /* delete pixel data */
         image->deleteOutputData();
     }
@@ -30,12 +30,150 @@
 #include "dcmtk/dcmdata/dcvrpobw.h"  /* for class DcmPolymorphOBOW */
 #include "dcmtk/dcmdata/dcswap.h"    /* for swapIfNecessary() */
 #include "dcmtk/dcmdata/dcuid.h"     /* for dcmGenerateUniqueIdentifer()*/
+#include "dcmtk/dcmdata/dcfrmpar.h"  /* for class DcmFrameProcessor */
 
 // dcmjpeg includes
 #include "dcmtk/dcmjpeg/djcparam.h"  /* for class DJCodecParameter */
 #include "dcmtk/dcmjpeg/djdecabs.h"  /* for class DJDecoder */
 
 
+/** helper class decompressing the frames of a multi-frame image in parallel.
+ *  Each frame is decompressed by its own instance of the compression library.
+ */
+class DJCodecDecoder::FrameDecoder: public DcmFrameProcessor
+{
+public:
+
+  /** constructor
+   *  @param codec the codec creating the decoder instances
+   *  @param fragments fragments of the compressed pixel sequence
+   *  @param fromRepParam current representation parameter of compressed data, may be NULL
+   *  @param djcp codec parameter
+   *  @param precision bits per sample of the JPEG data
+   *  @param isYBR flag indicating whether DICOM photometric interpretation is YCbCr
+   *  @param isSigned flag indicating whether uncompressed pixel data is signed
+   *  @param imageData buffer for all uncompressed frames
+   *  @param frameSize size of an uncompressed frame in bytes
+   *  @param columns number of columns
+   *  @param rows number of rows
+   *  @param createPlanarConfiguration convert frames to color-by-plane if true
+   */
+  FrameDecoder(
+    const DJCodecDecoder& codec,
+    const DcmFragmentTable& fragments,
+    const DcmRepresentationParameter *fromRepParam,
+    const DJCodecParameter *djcp,
+    Uint8 precision,
+    OFBool isYBR,
+    OFBool isSigned,
+    Uint8 *imageData,
+    size_t frameSize,
+    Uint16 columns,
+    Uint16 rows,
+    OFBool createPlanarConfiguration)
+  : DcmFrameProcessor()
+  , codec_(codec)
+  , fragments_(fragments)
+  , fromRepParam_(fromRepParam)
+  , djcp_(djcp)
+  , precision_(precision)
+  , isYBR_(isYBR)
+  , isSigned_(isSigned)
+  , imageData_(imageData)
+  , frameSize_(frameSize)
+  , columns_(columns)
+  , rows_(rows)
+  , createPlanarConfiguration_(createPlanarConfiguration)
+  {
+  }
+
+protected:
+
+  /** decompress the given frame into its place in the output buffer
+   *  @param frameNo number of the frame
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition processFrame(Uint32 frameNo)
+  {
+    DJDecoder *jpeg = codec_.createDecoderInstance(fromRepParam_, djcp_, precision_, isYBR_);
+    if (jpeg == NULL) return EC_MemoryExhausted;
+
+    Uint8 *imageData8 = imageData_ + frameNo * frameSize_;
+    Uint32 currentItem = fragments_.getStartFragment(frameNo);
+    const Uint32 endItem = fragments_.getEndFragment(frameNo);
+    OFCondition result = jpeg->init();
+    if (result.good())
+    {
+      result = EJ_Suspension;
+      while (EJ_Suspension == result)
+      {
+        if (currentItem >= endItem) result = EC_CorruptedData; // JPEG data stream is incomplete
+        else
+        {
+          result = jpeg->decode(fragments_.getData(currentItem), fragments_.getLength(currentItem),
+            imageData8, OFstatic_cast(Uint32, frameSize_), isSigned_);
+          ++currentItem;
+        }
+      }
+    }
+
+    // convert planar configuration if necessary
+    if (result.good() && createPlanarConfiguration_)
+    {
+      if (precision_ > 8)
+        result = createPlanarConfigurationWord(OFreinterpret_cast(Uint16*, imageData8), columns_, rows_);
+        else result = createPlanarConfigurationByte(imageData8, columns_, rows_);
+    }
+    delete jpeg;
+    return result;
+  }
+
+private:
+
+  /// private undefined copy constructor
+  FrameDecoder(const FrameDecoder&);
+
+  /// private undefined copy assignment operator
+  FrameDecoder& operator=(const FrameDecoder&);
+
+  /// the codec creating the decoder instances
+  const DJCodecDecoder& codec_;
+
+  /// fragments of the compressed pixel sequence
+  const DcmFragmentTable& fragments_;
+
+  /// current representation parameter of compressed data, may be NULL
+  const DcmRepresentationParameter *fromRepParam_;
+
+  /// codec parameter
+  const DJCodecParameter *djcp_;
+
+  /// bits per sample of the JPEG data
+  Uint8 precision_;
+
+  /// flag indicating whether DICOM photometric interpretation is YCbCr
+  OFBool isYBR_;
+
+  /// flag indicating whether uncompressed pixel data is signed
+  OFBool isSigned_;
+
+  /// buffer for all uncompressed frames
+  Uint8 *imageData_;
+
+  /// size of an uncompressed frame in bytes
+  size_t frameSize_;
+
+  /// number of columns
+  Uint16 columns_;
+
+  /// number of rows
+  Uint16 rows_;
+
+  /// convert frames to color-by-plane if true
+  OFBool createPlanarConfiguration_;
+};
+
+
 DJCodecDecoder::DJCodecDecoder()
 : DcmCodec()
 {
@@ -159,12 +297,25 @@ OFCondition DJCodecDecoder::decode(
                   }
                 }
 
-                result = uncompressedPixelData.createUint16Array(OFstatic_cast(Uint32, totalSize / sizeof(Uint16)), imageData16);
+                // frames are decompressed in parallel if requested and if the
+                // fragments of each frame can be determined in advance
+                DcmFragmentTable fragments;
+                Sint32 sequentialFrames = imageFrames;
+                if ((imageFrames > 1) && (dcmCodecMaxThreads.get() > 1))
+                {
+                  result = fragments.create(pixSeq, OFstatic_cast(Uint32, imageFrames));
+                  // the first frame is always decompressed here since the
+                  // decompressed color model is only known afterwards
+                  if (result.good() && fragments.hasFrameIndex()) sequentialFrames = 1;
+                }
+
+                if (result.good())
+                  result = uncompressedPixelData.createUint16Array(OFstatic_cast(Uint32, totalSize / sizeof(Uint16)), imageData16);
                 if (result.good())
                 {
                   Uint8 *imageData8 = OFreinterpret_cast(Uint8*, imageData16);
 
-                  while ((currentFrame < imageFrames)&&(result.good()))
+                  while ((currentFrame < sequentialFrames)&&(result.good()))
                   {
                     result = jpeg->init();
                     if (result.good())
@@ -226,6 +377,15 @@ OFCondition DJCodecDecoder::decode(
                     }
                   }
 
+                  if (result.good() && (currentFrame < imageFrames))
+                  {
+                    // decompress the remaining frames in parallel
+                    FrameDecoder frameDecoder(*this, fragments, fromRepParam, djcp, precision, isYBR, isSigned,
+                      OFreinterpret_cast(Uint8*, imageData16), frameSize, imageColumns, imageRows,
+                      (imageSamplesPerPixel == 3) && createPlanarConfiguration);
+                    result = frameDecoder.run(OFstatic_cast(Uint32, currentFrame), OFstatic_cast(Uint32, imageFrames - currentFrame));
+                  }
+
                   if (result.good())
                   {
                     // decompression is complete, finally adjust byte order if necessary
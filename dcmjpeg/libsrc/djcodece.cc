@@ -39,6 +39,7 @@
 #include "dcmtk/dcmdata/dcvrst.h"     /* for class DcmShortText */
 #include "dcmtk/dcmdata/dcvrus.h"     /* for class DcmUnsignedShort */
 #include "dcmtk/dcmdata/dcswap.h"     /* for swapIfNecessary */
+#include "dcmtk/dcmdata/dcfrmpar.h"   /* for class DcmFrameCompressor */
 
 // dcmjpeg includes
 #include "dcmtk/dcmjpeg/djcparam.h"   /* for class DJCodecParameter */
@@ -51,6 +52,186 @@
 #include "dcmtk/ofstd/ofstdinc.h"
 
 
+/** helper class compressing the frames of an image with the IJG library.
+ *  The frames are either taken from the uncompressed pixel data or rendered
+ *  by a DicomImage. Since rendering is not thread-safe, it is done for each
+ *  batch of frames in prepareFrames(). Each frame is compressed by its own
+ *  encoder instance because the IJG encoders are not reentrant.
+ */
+class DJCodecEncoder::FrameCompressor: public DcmFrameCompressor
+{
+public:
+
+  /** constructor
+   *  @param codec the codec compressing the frames
+   *  @param toRepParam representation parameter passed to encode()
+   *  @param cp codec parameter passed to encode()
+   *  @param compressedBits bits per sample passed to createEncoderInstance()
+   *  @param interpr color model of the frames
+   *  @param samplesPerPixel samples per pixel of the frames
+   *  @param columns frame width
+   *  @param rows frame height
+   *  @param bytesPerSample bytes per sample of the frames, 1 or 2
+   */
+  FrameCompressor(
+    const DJCodecEncoder& codec,
+    const DcmRepresentationParameter *toRepParam,
+    const DJCodecParameter *cp,
+    Uint8 compressedBits,
+    EP_Interpretation interpr,
+    Uint16 samplesPerPixel,
+    Uint16 columns,
+    Uint16 rows,
+    unsigned short bytesPerSample)
+  : DcmFrameCompressor()
+  , codec_(codec)
+  , toRepParam_(toRepParam)
+  , cp_(cp)
+  , compressedBits_(compressedBits)
+  , interpr_(interpr)
+  , samplesPerPixel_(samplesPerPixel)
+  , columns_(columns)
+  , rows_(rows)
+  , bytesPerSample_(bytesPerSample)
+  , pixelData_(NULL)
+  , dimage_(NULL)
+  , bitsPerSample_(0)
+  , frameSize_(OFstatic_cast(size_t, columns) * rows * samplesPerPixel * bytesPerSample)
+  , firstRendered_(0)
+  , rendered_()
+  {
+  }
+
+  /// destructor
+  virtual ~FrameCompressor()
+  {
+    for (OFVector<Uint8 *>::iterator it = rendered_.begin(); it != rendered_.end(); ++it)
+      delete[] *it;
+  }
+
+  /** compress the frames contained in the given uncompressed pixel data
+   *  @param pixelData pointer to the first frame, the frames must be stored
+   *    "color by pixel" in local byte order
+   */
+  void setPixelData(const Uint8 *pixelData)
+  {
+    pixelData_ = pixelData;
+  }
+
+  /** compress the frames rendered by the given DicomImage
+   *  @param dimage image to be rendered
+   *  @param bitsPerSample bits per sample of the rendered frames
+   */
+  void setImage(DicomImage *dimage, int bitsPerSample)
+  {
+    dimage_ = dimage;
+    bitsPerSample_ = bitsPerSample;
+    frameSize_ = dimage->getOutputDataSize(bitsPerSample);
+  }
+
+protected:
+
+  /** render the given frames if a DicomImage is used
+   *  @param firstFrame number of the first frame of the batch
+   *  @param numberOfFrames number of frames in the batch
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition prepareFrames(Uint32 firstFrame, Uint32 numberOfFrames)
+  {
+    if (dimage_ == NULL) return EC_Normal;
+    firstRendered_ = firstFrame;
+    // the frame buffers are reused for all batches
+    while (rendered_.size() < numberOfFrames)
+      rendered_.push_back(new Uint8[frameSize_]);
+    for (Uint32 i = 0; i < numberOfFrames; ++i)
+    {
+      if (!dimage_->getOutputData(rendered_[i], frameSize_, bitsPerSample_, firstFrame + i, 0))
+        return EC_MemoryExhausted;
+    }
+    return EC_Normal;
+  }
+
+  /** compress a single frame
+   *  @param frameNo number of the frame to be compressed
+   *  @param compressedData returns the compressed frame
+   *  @param compressedLength returns the length of the compressed frame
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition compressFrame(Uint32 frameNo, Uint8 *&compressedData, Uint32 &compressedLength)
+  {
+    const Uint8 *frame = dimage_ ? rendered_[frameNo - firstRendered_] : pixelData_ + frameNo * frameSize_;
+    DJEncoder *jpeg = codec_.createEncoderInstance(toRepParam_, cp_, compressedBits_);
+    if (jpeg == NULL) return EC_MemoryExhausted;
+    OFCondition result;
+    compressedData = NULL;
+    compressedLength = 0;
+    if (bytesPerSample_ == 1)
+    {
+      result = jpeg->encode(columns_, rows_, interpr_, samplesPerPixel_, OFconst_cast(Uint8*, frame), compressedData, compressedLength);
+    } else {
+      result = jpeg->encode(columns_, rows_, interpr_, samplesPerPixel_, OFreinterpret_cast(Uint16*, OFconst_cast(Uint8*, frame)), compressedData, compressedLength);
+    }
+    delete jpeg;
+    if (result.good() && (compressedLength == 0)) result = EC_CannotChangeRepresentation;
+    if (result.bad())
+    {
+      delete[] compressedData;
+      compressedData = NULL;
+    }
+    return result;
+  }
+
+private:
+
+  /// the codec compressing the frames
+  const DJCodecEncoder& codec_;
+
+  /// representation parameter passed to encode()
+  const DcmRepresentationParameter *toRepParam_;
+
+  /// codec parameter passed to encode()
+  const DJCodecParameter *cp_;
+
+  /// bits per sample passed to createEncoderInstance()
+  Uint8 compressedBits_;
+
+  /// color model of the frames
+  EP_Interpretation interpr_;
+
+  /// samples per pixel of the frames
+  Uint16 samplesPerPixel_;
+
+  /// frame width
+  Uint16 columns_;
+
+  /// frame height
+  Uint16 rows_;
+
+  /// bytes per sample of the frames
+  unsigned short bytesPerSample_;
+
+  /// pointer to the first uncompressed frame, NULL if a DicomImage is used
+  const Uint8 *pixelData_;
+
+  /// image rendering the frames, NULL if uncompressed pixel data is used
+  DicomImage *dimage_;
+
+  /// bits per sample of the rendered frames
+  int bitsPerSample_;
+
+  /// size of an uncompressed or rendered frame in bytes
+  size_t frameSize_;
+
+  /// number of the first frame of the current batch of rendered frames
+  Uint32 firstRendered_;
+
+  /// rendered frames of the current batch
+  OFVector<Uint8 *> rendered_;
+};
+
+// --------------------------------------------------------------------------
+
+
 DJCodecEncoder::DJCodecEncoder()
 : DcmCodec()
 {
@@ -340,39 +521,15 @@ OFCondition DJCodecEncoder::encodeColorImage(
       unsigned short bytesPerSample = jpeg->bytesPerSample();
       unsigned short columns = OFstatic_cast(unsigned short, dimage->getWidth());
       unsigned short rows = OFstatic_cast(unsigned short, dimage->getHeight());
-      Uint8 *jpegData = NULL;
-      Uint32 jpegLen  = 0;
-      const void *frame = NULL;
 
       // compute original image size in bytes, ignoring any padding bits.
       uncompressedSize = OFstatic_cast(double, columns * rows * dimage->getDepth() * frameCount * samplesPerPixel) / 8.0;
-      for (size_t i=0; (i<frameCount) && (result.good()); i++)
-      {
-        frame = dimage->getOutputData(bitsPerSample, i, 0);
-        if (frame == NULL) result = EC_MemoryExhausted;
-        else
-        {
-          // compress frame
-          jpegData = NULL;
-          if (bytesPerSample == 1)
-          {
-            result = jpeg->encode(columns, rows, interpr, samplesPerPixel, OFreinterpret_cast(Uint8*, OFconst_cast(void*, frame)), jpegData, jpegLen);
-          } else {
-            result = jpeg->encode(columns, rows, interpr, samplesPerPixel, OFreinterpret_cast(Uint16*, OFconst_cast(void*, frame)), jpegData, jpegLen);
-          }
-
-          // store frame
-          if (result.good())
-          {
-            result = pixelSequence->storeCompressedFrame(offsetList, jpegData, jpegLen, cp->getFragmentSize());
-          }
-
-          // delete block of JPEG data
-          delete[] jpegData;
-          compressedSize += jpegLen;
-        }
-      }
       delete jpeg;
+
+      // frames are rendered sequentially but compressed in parallel, if enabled
+      FrameCompressor compressor(*this, toRepParam, cp, OFstatic_cast(Uint8, compressedBits), interpr, samplesPerPixel, columns, rows, bytesPerSample);
+      compressor.setImage(dimage, bitsPerSample);
+      result = compressor.compress(pixelSequence, offsetList, OFstatic_cast(Uint32, frameCount), cp->getFragmentSize(), compressedSize);
     } else result = EC_MemoryExhausted;
   }
 
@@ -466,8 +623,6 @@ OFCondition DJCodecEncoder::encodeTrueLossless(
     Uint16 rows = 0;
     Sint32 numberOfFrames = 1;
     EP_Interpretation interpr = EPI_Unknown;
-    Uint8 *jpegData = NULL;
-    Uint32 jpegLen  = 0;
     OFBool byteSwapped = OFFalse;      // true if we have byte-swapped the original pixel data
     OFBool planConfSwitched = OFFalse; // true if planar configuration was toggled
     DcmOffsetList offsetList;
@@ -592,47 +747,21 @@ OFCondition DJCodecEncoder::encodeTrueLossless(
     }
 
     // prepare some variables for encoding
-    size_t frameCount = OFstatic_cast(size_t, numberOfFrames);
-    size_t frameSize = columns * rows * samplesPerPixel * bytesAllocated;
-    const Uint8 *framePointer = OFreinterpret_cast(const Uint8 *, pixelData);
     size_t compressedSize = 0;
 
-    // create encoder corresponding to bit depth (8 or 16 bit)
-    DJEncoder *jpeg = createEncoderInstance(toRepParam, djcp, OFstatic_cast(Uint8, bitsAllocated));
-    if (jpeg)
+    // compress each frame (in parallel, if enabled) with an encoder
+    // corresponding to the bit depth (8 or 16 bit)
+    if (result.good())
     {
-      // main loop for compression: compress each frame
-      for (unsigned int i=0; i<frameCount && result.good(); i++)
+      FrameCompressor compressor(*this, toRepParam, djcp, OFstatic_cast(Uint8, bitsAllocated), interpr, samplesPerPixel, columns, rows, bytesAllocated);
+      compressor.setPixelData(OFreinterpret_cast(const Uint8 *, pixelData));
+      result = compressor.compress(pixelSequence, offsetList, OFstatic_cast(Uint32, numberOfFrames), djcp->getFragmentSize(), compressedSize);
+      if (result.bad())
       {
-        if (bitsAllocated == 8)
-        {
-          jpeg->encode(columns, rows, interpr, samplesPerPixel, OFconst_cast(Uint8*, framePointer), jpegData, jpegLen);
-        }
-        else if (bitsAllocated == 16)
-        {
-          jpeg->encode(columns, rows, interpr, samplesPerPixel, OFreinterpret_cast(Uint16*, OFconst_cast(Uint8*, framePointer)), jpegData, jpegLen);
-        }
-        // update variables
-        compressedSize+=jpegLen;
-        framePointer+=frameSize;
-        if (jpegLen == 0)
-        {
-          DCMJPEG_ERROR("True lossless encoder: Error encoding frame");
-          result = EC_CannotChangeRepresentation;
-        }
-        else
-        {
-          result = pixelSequence->storeCompressedFrame(offsetList, jpegData, jpegLen, djcp->getFragmentSize());
-        }
-        // free memory
-        delete[] jpegData;
+        DCMJPEG_ERROR("True lossless encoder: Error encoding frame");
+        result = EC_CannotChangeRepresentation;
       }
     }
-    else
-    {
-      DCMJPEG_ERROR("True lossless encoder: Cannot allocate encoder instance");
-      result = EC_IllegalCall;
-    }
     if (result.good())
     {
       compressionRatio = OFstatic_cast(double, bytesAllocated * samplesPerPixel * columns * rows * numberOfFrames) / OFstatic_cast(double, compressedSize);
@@ -640,7 +769,6 @@ OFCondition DJCodecEncoder::encodeTrueLossless(
     }
     else
       delete pixelSequence;
-    delete jpeg; // encoder no longer in use
 
     if ((result.good()) && (djcp->getCreateOffsetTable()))
     {
@@ -1131,41 +1259,17 @@ OFCondition DJCodecEncoder::encodeMonochromeImage(
       unsigned short bytesPerSample = jpeg->bytesPerSample();
       unsigned short columns = OFstatic_cast(unsigned short, dimage.getWidth());
       unsigned short rows = OFstatic_cast(unsigned short, dimage.getHeight());
-      Uint8 *jpegData = NULL;
-      Uint32 jpegLen  = 0;
-      const void *frame = NULL;
 
       // compute original image size in bytes, ignoring any padding bits.
       Uint16 samplesPerPixel = 0;
       if ((dataset->findAndGetUint16(DCM_SamplesPerPixel, samplesPerPixel)).bad()) samplesPerPixel = 1;
       uncompressedSize = OFstatic_cast(double, columns * rows * pixelDepth * frameCount * samplesPerPixel) / 8.0;
-      for (size_t i=0; (i<frameCount) && (result.good()); i++)
-      {
-        frame = dimage.getOutputData(bitsPerSample, i, 0);
-        if (frame == NULL) result = EC_MemoryExhausted;
-        else
-        {
-          // compress frame
-          jpegData = NULL;
-          if (bytesPerSample == 1)
-          {
-            result = jpeg->encode(columns, rows, EPI_Monochrome2, 1, OFreinterpret_cast(Uint8*, OFconst_cast(void*, frame)), jpegData, jpegLen);
-          } else {
-            result = jpeg->encode(columns, rows, EPI_Monochrome2, 1, OFreinterpret_cast(Uint16*, OFconst_cast(void*, frame)), jpegData, jpegLen);
-          }
-
-          // store frame
-          if (result.good())
-          {
-            result = pixelSequence->storeCompressedFrame(offsetList, jpegData, jpegLen, cp->getFragmentSize());
-          }
-
-          // delete block of JPEG data
-          delete[] jpegData;
-          compressedSize += jpegLen;
-        }
-      }
       delete jpeg;
+
+      // frames are rendered sequentially but compressed in parallel, if enabled
+      FrameCompressor compressor(*this, toRepParam, cp, OFstatic_cast(Uint8, compressedBits), EPI_Monochrome2, 1, columns, rows, bytesPerSample);
+      compressor.setImage(&dimage, bitsPerSample);
+      result = compressor.compress(pixelSequence, offsetList, OFstatic_cast(Uint32, frameCount), cp->getFragmentSize(), compressedSize);
     } else result = EC_MemoryExhausted;
   }
 
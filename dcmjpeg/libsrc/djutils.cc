@@ -27,6 +27,14 @@
 #define INCLUDE_CCTYPE
 #include "dcmtk/ofstd/ofstdinc.h"
 
+BEGIN_EXTERN_C
+/* declared in jpeglib8.h and jpeglib12.h, which cannot be included in the same file */
+int jpeg8_simd_level(void);
+void jpeg8_simd_set_max_level(int level);
+int jpeg12_simd_level(void);
+void jpeg12_simd_set_max_level(int level);
+END_EXTERN_C
+
 OFLogger DCM_dcmjpegLogger = OFLog::getLogger("dcmtk.dcmjpeg");
 
 makeOFConditionConst(EJ_Suspension,                           OFM_dcmjpeg,  1, OF_error, "IJG codec suspension return"  );
@@ -68,3 +76,17 @@ EP_Interpretation DcmJpegHelper::getPhotometricInterpretation(DcmItem *item)
   }
   return EPI_Unknown;
 }
+
+
+int DcmJpegHelper::getSIMDLevel()
+{
+  /* both libraries are compiled from the same source, so the level is the same */
+  return jpeg8_simd_level();
+}
+
+
+void DcmJpegHelper::setMaxSIMDLevel(const int level)
+{
+  jpeg8_simd_set_max_level(level);
+  jpeg12_simd_set_max_level(level);
+}
@@ -0,0 +1,319 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmjpeg
+ *
+ *  Author:  agent
+ *
+ *  Purpose: Measure the throughput of the JPEG codecs
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/ofstream.h"
+#include "dcmtk/ofstd/oftimer.h"
+#include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dcpxitem.h"
+#include "dcmtk/dcmjpeg/djencode.h"
+#include "dcmtk/dcmjpeg/djdecode.h"
+#include "dcmtk/dcmjpeg/djrploss.h"
+#include "dcmtk/dcmjpeg/djrplol.h"
+#include "dcmtk/dcmjpeg/djutils.h"
+#include "dcmtk/dcmimage/diregist.h"  /* include to support color images */
+
+#define INCLUDE_CSTDLIB
+#define INCLUDE_CSTRING
+#define INCLUDE_CSTDIO
+#include "dcmtk/ofstd/ofstdinc.h"
+
+
+/* names of the instruction sets supported by the IJG libraries */
+static const char *LevelNames[] =
+{
+    "none", "SSE4.1", "AVX2"
+};
+
+
+/* number of pixels per second in millions */
+static double mpixels(const unsigned long count, const int iterations, const double seconds)
+{
+    return (seconds > 0) ? OFstatic_cast(double, count) * iterations / seconds / 1000000.0 : 0;
+}
+
+
+/* print one line of the result table */
+static void report(const char *operation, const char *image, const char *variant, const double throughput, const OFBool ok)
+{
+    char line[128];
+    sprintf(line, "%-10s %-24s %-8s %10.1f Mpixels/s  %s", operation, image, variant, throughput, ok ? "ok" : "MISMATCH");
+    COUT << line << OFendl;
+}
+
+
+/* concatenate all fragments of the compressed pixel data (except for the offset table) */
+static OFBool getCompressedData(DcmDataset &dset, const E_TransferSyntax xfer, const DcmRepresentationParameter *param,
+                                OFString &data)
+{
+    DcmElement *elem = NULL;
+    DcmPixelSequence *seq = NULL;
+    data.clear();
+    if (dset.findAndGetElement(DCM_PixelData, elem).bad() ||
+        OFstatic_cast(DcmPixelData *, elem)->getEncapsulatedRepresentation(xfer, param, seq).bad())
+        return OFFalse;
+    const unsigned long count = seq->card();
+    for (unsigned long i = 1; i < count; ++i)
+    {
+        DcmPixelItem *item = NULL;
+        Uint8 *bytes = NULL;
+        if (seq->getItem(item, i).good() && item->getUint8Array(bytes).good() && (bytes != NULL))
+            data.append(OFreinterpret_cast(const char *, bytes), item->getLength());
+    }
+    return OFTrue;
+}
+
+
+/* get the uncompressed pixel data */
+static OFBool getPixelData(DcmDataset &dset, OFString &data)
+{
+    DcmElement *elem = NULL;
+    Uint8 *bytes = NULL;
+    data.clear();
+    if (dset.findAndGetElement(DCM_PixelData, elem).bad() || elem->getUint8Array(bytes).bad() || (bytes == NULL))
+        return OFFalse;
+    data.assign(OFreinterpret_cast(const char *, bytes), elem->getLength());
+    return OFTrue;
+}
+
+
+/* compress and decompress the given dataset with all instruction sets supported by the processor,
+ * the results are compared with the portable code
+ */
+static OFBool benchmarkCodec(DcmDataset &dset, const char *name, const int iterations)
+{
+    Uint16 columns = 0;
+    Uint16 rows = 0;
+    Uint16 bitsStored = 0;
+    Sint32 frames = 1;
+    dset.findAndGetUint16(DCM_Columns, columns);
+    dset.findAndGetUint16(DCM_Rows, rows);
+    dset.findAndGetUint16(DCM_BitsStored, bitsStored);
+    dset.findAndGetSint32(DCM_NumberOfFrames, frames);
+    if (frames < 1)
+        frames = 1;
+    const unsigned long count = OFstatic_cast(unsigned long, columns) * rows * frames;
+    /* 12 bit images require the extended process */
+    const E_TransferSyntax xfer = (bitsStored > 8) ? EXS_JPEGProcess2_4 : EXS_JPEGProcess1;
+    const DJ_RPLossy param(90);
+    OFString expectedCompressed;
+    OFString expectedPixels;
+    OFBool result = OFTrue;
+    for (int level = 0; level <= 2; ++level)
+    {
+        DcmJpegHelper::setMaxSIMDLevel(level);
+        if (DcmJpegHelper::getSIMDLevel() != level)
+            continue;
+        /* compression */
+        OFString compressed;
+        OFBool ok = OFTrue;
+        OFTimer timer;
+        for (int i = 0; i < iterations; ++i)
+        {
+            DcmDataset copy(dset);
+            ok &= copy.chooseRepresentation(xfer, &param).good() && copy.canWriteXfer(xfer) &&
+                getCompressedData(copy, xfer, &param, compressed);
+        }
+        double seconds = timer.getDiff();
+        if (level == 0)
+            expectedCompressed = compressed;
+        ok &= (compressed == expectedCompressed);
+        report("compress", name, LevelNames[level], mpixels(count, iterations, seconds), ok);
+        result &= ok;
+        /* decompression (of the data compressed with the portable code) */
+        DcmDataset encoded(dset);
+        if (encoded.chooseRepresentation(xfer, &param).bad())
+            return OFFalse;
+        encoded.removeAllButCurrentRepresentations();
+        OFString pixels;
+        ok = OFTrue;
+        timer.reset();
+        for (int i = 0; i < iterations; ++i)
+        {
+            DcmDataset copy(encoded);
+            ok &= copy.chooseRepresentation(EXS_LittleEndianExplicit, NULL).good() && getPixelData(copy, pixels);
+        }
+        seconds = timer.getDiff();
+        if (level == 0)
+            expectedPixels = pixels;
+        ok &= (pixels == expectedPixels);
+        report("decompress", name, LevelNames[level], mpixels(count, iterations, seconds), ok);
+        result &= ok;
+    }
+    DcmJpegHelper::setMaxSIMDLevel(2);
+    return result;
+}
+
+
+/* compress the given dataset with lossless JPEG (selection value 1) and measure the decompression,
+ * the result is compared with the original pixel data
+ */
+static OFBool benchmarkLossless(DcmDataset &dset, const char *name, const int iterations)
+{
+    Uint16 columns = 0;
+    Uint16 rows = 0;
+    Sint32 frames = 1;
+    dset.findAndGetUint16(DCM_Columns, columns);
+    dset.findAndGetUint16(DCM_Rows, rows);
+    dset.findAndGetSint32(DCM_NumberOfFrames, frames);
+    if (frames < 1)
+        frames = 1;
+    const unsigned long count = OFstatic_cast(unsigned long, columns) * rows * frames;
+    const DJ_RPLossless param(1 /* predictor */, 0 /* point transform */);
+    OFString expectedPixels;
+    if (!getPixelData(dset, expectedPixels))
+        return OFFalse;
+    /* compression */
+    DcmDataset encoded(dset);
+    OFTimer timer;
+    OFBool ok = encoded.chooseRepresentation(EXS_JPEGProcess14SV1, &param).good() && encoded.canWriteXfer(EXS_JPEGProcess14SV1);
+    report("compress", name, "SV1", mpixels(count, 1, timer.getDiff()), ok);
+    if (!ok)
+        return OFFalse;
+    encoded.removeAllButCurrentRepresentations();
+    /* decompression */
+    OFString pixels;
+    timer.reset();
+    for (int i = 0; i < iterations; ++i)
+    {
+        DcmDataset copy(encoded);
+        ok &= copy.chooseRepresentation(EXS_LittleEndianExplicit, NULL).good() && getPixelData(copy, pixels);
+    }
+    const double seconds = timer.getDiff();
+    ok &= (pixels == expectedPixels);
+    report("decompress", name, "SV1", mpixels(count, iterations, seconds), ok);
+    return ok;
+}
+
+
+/* create an image with smooth gradients and some noise, so that the compression ratio is realistic */
+static void createImage(DcmDataset &dset,
+                        const Uint16 columns,
+                        const Uint16 rows,
+                        const Uint16 samplesPerPixel,
+                        const Uint16 bitsStored)
+{
+    const unsigned long count = OFstatic_cast(unsigned long, columns) * rows * samplesPerPixel;
+    const Uint32 maxValue = (1UL << bitsStored) - 1;
+    dset.putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage);
+    dset.putAndInsertString(DCM_SOPInstanceUID, "1.2.276.0.7230010.3.1.4.0.1");
+    dset.putAndInsertString(DCM_PhotometricInterpretation, (samplesPerPixel == 3) ? "RGB" : "MONOCHROME2");
+    dset.putAndInsertUint16(DCM_SamplesPerPixel, samplesPerPixel);
+    if (samplesPerPixel == 3)
+        dset.putAndInsertUint16(DCM_PlanarConfiguration, 0);
+    dset.putAndInsertUint16(DCM_Rows, rows);
+    dset.putAndInsertUint16(DCM_Columns, columns);
+    dset.putAndInsertUint16(DCM_BitsAllocated, (bitsStored > 8) ? 16 : 8);
+    dset.putAndInsertUint16(DCM_BitsStored, bitsStored);
+    dset.putAndInsertUint16(DCM_HighBit, bitsStored - 1);
+    dset.putAndInsertUint16(DCM_PixelRepresentation, 0);
+    /* simple pseudo random generator, so the results are reproducible */
+    Uint32 seed = 1;
+    Uint16 *values = new Uint16[count];
+    for (unsigned long i = 0; i < count; ++i)
+    {
+        const unsigned long x = (i / samplesPerPixel) % columns;
+        const unsigned long y = (i / samplesPerPixel) / columns;
+        const unsigned long s = i % samplesPerPixel;
+        seed = seed * 1103515245 + 12345;
+        values[i] = OFstatic_cast(Uint16, ((x * (s + 1) + y * (3 - s)) * maxValue / (4UL * (columns + rows)) +
+            ((seed >> 16) & 0x0f) * maxValue / 255) & maxValue);
+    }
+    if (bitsStored > 8)
+        dset.putAndInsertUint16Array(DCM_PixelData, values, count);
+    else {
+        Uint8 *bytes = new Uint8[count];
+        for (unsigned long i = 0; i < count; ++i)
+            bytes[i] = OFstatic_cast(Uint8, values[i]);
+        dset.putAndInsertUint8Array(DCM_PixelData, bytes, count);
+        delete[] bytes;
+    }
+    delete[] values;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int iterations = 5;
+    int first = 1;
+    if ((argc > 1) && (strcmp(argv[1], "-i") == 0))
+    {
+        if ((argc < 3) || (atoi(argv[2]) <= 0))
+            first = 0;
+        else {
+            iterations = atoi(argv[2]);
+            first = 3;
+        }
+    }
+    if (first == 0)
+    {
+        COUT << "jpegbench: Measure the throughput of the lossy JPEG codecs" << OFendl;
+        COUT << "usage: jpegbench [-i iterations] [dcmfile-in...]" << OFendl;
+        return 1;
+    }
+
+    /* make sure data dictionary is loaded */
+    if (!dcmDataDict.isDictionaryLoaded())
+    {
+        CERR << "Warning: no data dictionary loaded, "
+             << "check environment variable: "
+             << DCM_DICT_ENVIRONMENT_VARIABLE << OFendl;
+    }
+
+    /* YCbCr with 4:2:2 subsampling, i.e. the color conversion and upsampling routines are also measured */
+    DJEncoderRegistration::registerCodecs(ECC_lossyYCbCr, EUC_never, OFFalse, 0, 0, 0, OFTrue, ESS_422);
+    DJDecoderRegistration::registerCodecs(EDC_photometricInterpretation, EUC_never);
+
+    COUT << iterations << " iterations, best instruction set: " << LevelNames[DcmJpegHelper::getSIMDLevel()] << OFendl;
+    OFBool ok = OFTrue;
+    if (argc > first)
+    {
+        for (int i = first; i < argc; ++i)
+        {
+            DcmFileFormat fileformat;
+            DcmDataset *dset = fileformat.getDataset();
+            if (fileformat.loadFile(argv[i]).bad() || dset->chooseRepresentation(EXS_LittleEndianExplicit, NULL).bad())
+            {
+                CERR << "Error: cannot read uncompressed image from file: " << argv[i] << OFendl;
+                ok = OFFalse;
+                continue;
+            }
+            dset->removeAllButCurrentRepresentations();
+            OFString name;
+            OFStandard::getFilenameFromPath(name, argv[i]);
+            ok &= benchmarkCodec(*dset, name.c_str(), iterations);
+            ok &= benchmarkLossless(*dset, name.c_str(), iterations);
+        }
+    } else {
+        DcmDataset rgb8;
+        createImage(rgb8, 2048, 2048, 3, 8);
+        ok &= benchmarkCodec(rgb8, "2048x2048 RGB 8 bit", iterations);
+        DcmDataset mono8;
+        createImage(mono8, 2048, 2048, 1, 8);
+        ok &= benchmarkCodec(mono8, "2048x2048 MONO 8 bit", iterations);
+        DcmDataset mono12;
+        createImage(mono12, 2048, 2048, 1, 12);
+        ok &= benchmarkCodec(mono12, "2048x2048 MONO 12 bit", iterations);
+        ok &= benchmarkLossless(mono12, "2048x2048 MONO 12 bit", iterations);
+        DcmDataset mono16;
+        createImage(mono16, 2048, 2048, 1, 16);
+        ok &= benchmarkLossless(mono16, "2048x2048 MONO 16 bit", iterations);
+    }
+    DJEncoderRegistration::cleanup();
+    DJDecoderRegistration::cleanup();
+    return ok ? 0 : 2;
+}
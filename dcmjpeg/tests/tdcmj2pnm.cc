@@ -0,0 +1,227 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmjpeg
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the conversion of all frames of a large JPEG compressed image with dcmj2pnm
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTDLIB
+#define INCLUDE_CSTDIO
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/ofstd/oflist.h"
+#include "dcmtk/ofstd/ofstream.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dcpxitem.h"
+#include "dcmtk/dcmjpeg/djencode.h"
+#include "dcmtk/dcmjpeg/djrplol.h"
+
+#if defined(HAVE_SYS_RESOURCE_H) && defined(__linux__)
+/* the maximum resident set size of child processes is reported in kB */
+#define CHECK_MEMORY_USAGE
+BEGIN_EXTERN_C
+#include <sys/resource.h>
+END_EXTERN_C
+#endif
+
+/* path of the dcmj2pnm executable, defined by the build system */
+#ifndef DCMJ2PNM_PATH
+#define DCMJ2PNM_PATH "../apps/dcmj2pnm"
+#endif
+
+/* directory for the input and output files of the test */
+#define WORK_DIR "tdcmj2pnm.dir"
+/* file for the output of dcmj2pnm */
+#define LOG_FILE "tdcmj2pnm.log"
+
+/* size of the test image, the uncompressed pixel data has a size of 50 MB */
+#define IMAGE_COLUMNS 512
+#define IMAGE_ROWS 512
+#define IMAGE_FRAMES 200
+
+
+/* delete all files in the working directory (and create it if necessary) */
+static void cleanWorkDir()
+{
+    OFList<OFString> fileList;
+    OFStandard::searchDirectoryRecursively(WORK_DIR, fileList);
+    OFListIterator(OFString) iter = fileList.begin();
+    while (iter != fileList.end())
+        OFStandard::deleteFile(*iter++);
+    OFCHECK(OFStandard::createDirectory(WORK_DIR, "").good());
+}
+
+
+/* get the value of the given pixel, each frame uses the full range of pixel values */
+static Uint8 getPixel(const unsigned long frame,
+                      const unsigned long pos)
+{
+    if (pos < 2)
+        return (pos == 0) ? 0 : 255;
+    return OFstatic_cast(Uint8, (pos % IMAGE_COLUMNS) + (pos / IMAGE_COLUMNS) / 3 + frame * 7);
+}
+
+
+/* read the content of the given file */
+static OFString readFile(const OFString &filename)
+{
+    OFString content;
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (file != NULL)
+    {
+        char buf[4096];
+        size_t count;
+        while ((count = fread(buf, 1, sizeof(buf), file)) > 0)
+            content.append(buf, count);
+        fclose(file);
+    }
+    return content;
+}
+
+
+/* run dcmj2pnm with the given arguments, the output is written to a log file */
+static OFBool runDcmj2pnm(const OFString &arguments)
+{
+    OFString command = "\"" DCMJ2PNM_PATH "\" ";
+    command += arguments;
+    command += " > " LOG_FILE " 2>&1";
+    return system(command.c_str()) == 0;
+}
+
+
+/* set the attributes of an 8 bit monochrome image */
+static void setImageAttributes(DcmDataset &dset)
+{
+    dset.putAndInsertString(DCM_SOPClassUID, UID_MultiframeGrayscaleByteSecondaryCaptureImageStorage);
+    dset.putAndInsertString(DCM_SOPInstanceUID, "1.2.276.0.7230010.3.1.4.0.21");
+    dset.putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+    dset.putAndInsertUint16(DCM_SamplesPerPixel, 1);
+    dset.putAndInsertUint16(DCM_Rows, IMAGE_ROWS);
+    dset.putAndInsertUint16(DCM_Columns, IMAGE_COLUMNS);
+    dset.putAndInsertUint16(DCM_BitsAllocated, 8);
+    dset.putAndInsertUint16(DCM_BitsStored, 8);
+    dset.putAndInsertUint16(DCM_HighBit, 7);
+    dset.putAndInsertUint16(DCM_PixelRepresentation, 0);
+}
+
+
+/* create a large multi-frame image that is compressed lossless, the frames are compressed
+ * one after the other, so that the uncompressed pixel data is never in memory
+ */
+static void createImage(const char *filename)
+{
+    const unsigned long frameSize = IMAGE_COLUMNS * IMAGE_ROWS;
+    const DJ_RPLossless param;
+    DJEncoderRegistration::registerCodecs();
+    DcmPixelSequence *sequence = new DcmPixelSequence(DCM_PixelSequenceTag);
+    /* empty basic offset table */
+    sequence->insert(new DcmPixelItem(DCM_PixelItemTag));
+    Uint8 *pixels = new Uint8[frameSize];
+    for (unsigned long f = 0; f < IMAGE_FRAMES; ++f)
+    {
+        DcmDataset frame;
+        setImageAttributes(frame);
+        for (unsigned long i = 0; i < frameSize; ++i)
+            pixels[i] = getPixel(f, i);
+        frame.putAndInsertUint8Array(DCM_PixelData, pixels, frameSize);
+        OFCHECK(frame.chooseRepresentation(EXS_JPEGProcess14SV1, &param).good());
+        DcmElement *elem = NULL;
+        DcmPixelSequence *frameSequence = NULL;
+        OFCHECK(frame.findAndGetElement(DCM_PixelData, elem).good());
+        if ((elem == NULL) || OFstatic_cast(DcmPixelData *, elem)->getEncapsulatedRepresentation(EXS_JPEGProcess14SV1, &param, frameSequence).bad())
+        {
+            OFCHECK_FAIL("cannot compress frame " << (f + 1));
+            break;
+        }
+        /* copy the fragments (without the offset table) */
+        for (unsigned long i = 1; i < frameSequence->card(); ++i)
+        {
+            DcmPixelItem *item = NULL;
+            Uint8 *data = NULL;
+            OFCHECK(frameSequence->getItem(item, i).good());
+            OFCHECK(item->getUint8Array(data).good());
+            DcmPixelItem *newItem = new DcmPixelItem(DCM_PixelItemTag);
+            newItem->putUint8Array(data, item->getLength());
+            sequence->insert(newItem);
+        }
+    }
+    delete[] pixels;
+    DJEncoderRegistration::cleanup();
+    DcmFileFormat fileformat;
+    DcmDataset *dset = fileformat.getDataset();
+    setImageAttributes(*dset);
+    char buf[16];
+    sprintf(buf, "%u", OFstatic_cast(unsigned int, IMAGE_FRAMES));
+    dset->putAndInsertString(DCM_NumberOfFrames, buf);
+    DcmPixelData *pixelData = new DcmPixelData(DCM_PixelData);
+    pixelData->putOriginalRepresentation(EXS_JPEGProcess14SV1, &param, sequence);
+    dset->insert(pixelData);
+    OFCHECK(fileformat.saveFile(filename, EXS_JPEGProcess14SV1).good());
+}
+
+
+OFTEST(dcmjpeg_dcmj2pnmAllFrames)
+{
+    const unsigned long frameSize = IMAGE_COLUMNS * IMAGE_ROWS;
+    cleanWorkDir();
+
+    createImage(WORK_DIR "/multi.dcm");
+
+    /* convert all frames, as done for the large file that could not be converted before */
+    OFCHECK(runDcmj2pnm("--conv-guess-lossy --use-frame-number --all-frames " WORK_DIR "/multi.dcm " WORK_DIR "/frame"));
+#ifdef CHECK_MEMORY_USAGE
+    /* the frames are decompressed one after the other, so the uncompressed pixel data is never in memory
+     * (this is also true for the test program, whose memory usage is included)
+     */
+    struct rusage usage;
+    OFCHECK(getrusage(RUSAGE_CHILDREN, &usage) == 0);
+    OFCHECK(OFstatic_cast(unsigned long, usage.ru_maxrss) < frameSize * IMAGE_FRAMES / 1024);
+#endif
+    OFOStringStream header;
+    header << "P5\n" << IMAGE_COLUMNS << " " << IMAGE_ROWS << "\n255\n" << OFStringStream_ends;
+    OFSTRINGSTREAM_GETOFSTRING(header, expectedHeader)
+    for (unsigned long f = 0; f < IMAGE_FRAMES; ++f)
+    {
+        OFOStringStream stream;
+        stream << WORK_DIR "/frame.f" << (f + 1) << ".pgm" << OFStringStream_ends;
+        OFSTRINGSTREAM_GETOFSTRING(stream, filename)
+        const OFString content = readFile(filename);
+        if (content.size() != expectedHeader.size() + frameSize)
+            OFCHECK_FAIL("output file " << filename << " is missing or has a size of " << content.size() << " bytes");
+        else
+        {
+            /* the image has been compressed lossless */
+            OFCHECK(content.compare(0, expectedHeader.size(), expectedHeader) == 0);
+            unsigned long mismatches = 0;
+            for (unsigned long i = 0; i < frameSize; ++i)
+            {
+                if (OFstatic_cast(Uint8, content[expectedHeader.size() + i]) != getPixel(f, i))
+                    ++mismatches;
+            }
+            if (mismatches > 0)
+                OFCHECK_FAIL(mismatches << " pixel(s) of frame " << (f + 1) << " differ");
+        }
+    }
+    /* there are no further output files */
+    OFList<OFString> fileList;
+    OFCHECK_EQUAL(OFStandard::searchDirectoryRecursively(WORK_DIR, fileList), OFstatic_cast(size_t, IMAGE_FRAMES + 1));
+
+    /* a single frame can still be written as a JPEG file */
+    OFCHECK(runDcmj2pnm("+oj +F 2 " WORK_DIR "/multi.dcm " WORK_DIR "/frame.jpg"));
+    const OFString jpeg = readFile(WORK_DIR "/frame.jpg");
+    OFCHECK(jpeg.size() > 2);
+    OFCHECK(jpeg.compare(0, 2, "\xFF\xD8") == 0);
+    cleanWorkDir();
+}
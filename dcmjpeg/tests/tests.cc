@@ -11,7 +11,7 @@
  *    D-26121 Oldenburg, Germany
  *
  *
- *  Module:  ofstd
+ *  Module:  dcmjpeg
  *
  *  Author:  Uli Schlachter
  *
@@ -23,5 +23,8 @@
 
 #include "dcmtk/ofstd/oftest.h"
 
-OFTEST_REGISTER(dcmjpeg_test);
+OFTEST_REGISTER(dcmjpeg_dcmj2pnmAllFrames);
+OFTEST_REGISTER(dcmjpeg_losslessFastPath);
+OFTEST_REGISTER(dcmjpeg_simdBaseline);
+OFTEST_REGISTER(dcmjpeg_simdExtended);
 OFTEST_MAIN("dcmjpeg")
@@ -0,0 +1,425 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmjpeg
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the fast path of the lossless Huffman decoder (16 bit IJG library)
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/ofstd/ofstream.h"
+
+#define INCLUDE_CSETJMP
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+// These two macros are re-defined in the IJG header files.
+// We undefine them here and hope that IJG's configure has
+// come to the same conclusion that we have...
+#ifdef HAVE_STDLIB_H
+#undef HAVE_STDLIB_H
+#endif
+#ifdef HAVE_STDDEF_H
+#undef HAVE_STDDEF_H
+#endif
+
+BEGIN_EXTERN_C
+#define boolean ijg_boolean
+#include "jpeglib16.h"
+#include "jerror16.h"
+#undef boolean
+
+// disable any preprocessor magic the IJG library might be doing with the "const" keyword
+#ifdef const
+#undef const
+#endif
+
+#ifdef USE_STD_CXX_INCLUDES
+// Solaris defines longjmp() in namespace std, other compilers don't...
+namespace std { }
+using namespace std;
+#endif
+
+
+/* size of the test images, the height is not a multiple of the restart intervals */
+#define IMAGE_COLUMNS 97
+#define IMAGE_ROWS 23
+
+
+// error handler struct
+struct TestErrorStruct
+{
+  // the standard IJG error handler object
+  struct jpeg_error_mgr pub;
+
+  // our jump buffer
+  jmp_buf setjmp_buffer;
+
+  // number of warnings
+  int warnings;
+};
+
+// destination manager struct, writes to a buffer that is large enough
+struct TestDestinationStruct
+{
+  // the standard IJG destination manager object
+  struct jpeg_destination_mgr pub;
+
+  // output buffer
+  JOCTET *buffer;
+
+  // size of the output buffer
+  size_t size;
+};
+
+// source manager struct, supports suspension and truncated input data
+struct TestSourceStruct
+{
+  // the standard IJG source manager object
+  struct jpeg_source_mgr pub;
+
+  // compressed data
+  const JOCTET *data;
+
+  // number of bytes of the compressed data
+  size_t size;
+
+  // number of bytes made available to the decoder so far
+  size_t available;
+
+  // number of bytes to skip as soon as more data is available
+  long skip_bytes;
+
+  // suspend if the available data is exhausted (until all data is available)
+  OFBool suspend;
+};
+
+static void TestErrorExit(j_common_ptr cinfo)
+{
+  TestErrorStruct *err = OFreinterpret_cast(TestErrorStruct *, cinfo->err);
+  longjmp(err->setjmp_buffer, 1);
+}
+
+static void TestEmitMessage(j_common_ptr cinfo, int msg_level)
+{
+  /* count warnings, ignore trace messages */
+  if (msg_level < 0)
+    OFreinterpret_cast(TestErrorStruct *, cinfo->err)->warnings++;
+}
+
+static void TestInitDestination(j_compress_ptr cinfo)
+{
+  TestDestinationStruct *dest = OFreinterpret_cast(TestDestinationStruct *, cinfo->dest);
+  dest->pub.next_output_byte = dest->buffer;
+  dest->pub.free_in_buffer = dest->size;
+}
+
+static ijg_boolean TestEmptyOutputBuffer(j_compress_ptr cinfo)
+{
+  /* the buffer is large enough for the test images */
+  ERREXIT(cinfo, JERR_BUFFER_SIZE);
+  return TRUE;
+}
+
+static void TestTermDestination(j_compress_ptr /* cinfo */)
+{
+}
+
+static void TestInitSource(j_decompress_ptr /* cinfo */)
+{
+}
+
+static ijg_boolean TestFillInputBuffer(j_decompress_ptr cinfo)
+{
+  static const JOCTET eoi[2] = { 0xFF, JPEG_EOI };
+  TestSourceStruct *src = OFreinterpret_cast(TestSourceStruct *, cinfo->src);
+  if (src->suspend && (src->available < src->size))
+    return FALSE;
+  /* insert a fake EOI marker at the end of the (truncated) data, see jdatasrc.c */
+  WARNMS(cinfo, JWRN_JPEG_EOF);
+  src->pub.next_input_byte = eoi;
+  src->pub.bytes_in_buffer = 2;
+  return TRUE;
+}
+
+static void TestSkipInputData(j_decompress_ptr cinfo, long num_bytes)
+{
+  TestSourceStruct *src = OFreinterpret_cast(TestSourceStruct *, cinfo->src);
+  if (num_bytes > OFstatic_cast(long, src->pub.bytes_in_buffer))
+  {
+    src->skip_bytes = num_bytes - OFstatic_cast(long, src->pub.bytes_in_buffer);
+    num_bytes = OFstatic_cast(long, src->pub.bytes_in_buffer);
+  }
+  if (num_bytes > 0)
+  {
+    src->pub.next_input_byte += num_bytes;
+    src->pub.bytes_in_buffer -= num_bytes;
+  }
+}
+
+static void TestTermSource(j_decompress_ptr /* cinfo */)
+{
+}
+
+// helper methods to fix old-style casts warnings
+static void OFjpeg_create_compress(j_compress_ptr cinfo)
+{
+  jpeg_create_compress(cinfo);
+}
+
+static void OFjpeg_create_decompress(j_decompress_ptr cinfo)
+{
+  jpeg_create_decompress(cinfo);
+}
+
+END_EXTERN_C
+
+
+/* create an image with a gradient and noise in the lower bits (i.e. short Huffman codes),
+ * some lines of noise covering all 16 bits (long Huffman codes) and some differences of 32768
+ */
+static Uint16 *createImage()
+{
+    Uint16 *image = new Uint16[IMAGE_COLUMNS * IMAGE_ROWS];
+    Uint32 seed = 4711;
+    for (unsigned long y = 0; y < IMAGE_ROWS; ++y)
+    {
+        for (unsigned long x = 0; x < IMAGE_COLUMNS; ++x)
+        {
+            seed = seed * 1103515245 + 12345;
+            Uint16 &value = image[y * IMAGE_COLUMNS + x];
+            if (y % 8 == 5)
+                value = OFstatic_cast(Uint16, seed >> 16);
+            else if ((y % 8 == 6) && (x % 11 < 2))
+                value = OFstatic_cast(Uint16, (x % 11) * 32768);
+            else
+                value = OFstatic_cast(Uint16, 1000 + x * 23 + y * 7 + ((seed >> 16) & 0x3f));
+        }
+    }
+    return image;
+}
+
+
+/* compress the given image with lossless JPEG */
+static OFBool compressImage(const Uint16 *image,
+                            const int psv,
+                            const int pt,
+                            const unsigned int restartInterval,
+                            const int restartInRows,
+                            OFString &data)
+{
+    const size_t size = IMAGE_COLUMNS * IMAGE_ROWS * 3 + 1024;
+    JOCTET *buffer = new JOCTET[size];
+    struct jpeg_compress_struct cinfo;
+    TestErrorStruct jerr;
+    TestDestinationStruct dest;
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = TestErrorExit;
+    jerr.pub.emit_message = TestEmitMessage;
+    jerr.warnings = 0;
+    if (setjmp(jerr.setjmp_buffer))
+    {
+        jpeg_destroy_compress(&cinfo);
+        delete[] buffer;
+        return OFFalse;
+    }
+    OFjpeg_create_compress(&cinfo);
+    dest.pub.init_destination = TestInitDestination;
+    dest.pub.empty_output_buffer = TestEmptyOutputBuffer;
+    dest.pub.term_destination = TestTermDestination;
+    dest.buffer = buffer;
+    dest.size = size;
+    cinfo.dest = &dest.pub;
+    cinfo.image_width = IMAGE_COLUMNS;
+    cinfo.image_height = IMAGE_ROWS;
+    cinfo.input_components = 1;
+    cinfo.in_color_space = JCS_GRAYSCALE;
+    jpeg_set_defaults(&cinfo);
+    cinfo.optimize_coding = TRUE; // must always be true for 16 bit compression
+    jpeg_simple_lossless(&cinfo, psv, pt);
+    cinfo.restart_interval = restartInterval;
+    cinfo.restart_in_rows = restartInRows;
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height)
+    {
+        JSAMPROW row = OFconst_cast(JSAMPROW, OFreinterpret_cast(const JSAMPLE *, image + cinfo.next_scanline * IMAGE_COLUMNS));
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    data.assign(OFreinterpret_cast(const char *, buffer), size - dest.pub.free_in_buffer);
+    jpeg_destroy_compress(&cinfo);
+    delete[] buffer;
+    return OFTrue;
+}
+
+
+/* make more data available to a suspending source (after a suspension) */
+static void addData(TestSourceStruct &src,
+                    const size_t chunkSize)
+{
+    const size_t consumed = src.pub.next_input_byte - src.data;
+    src.available = (src.available + chunkSize < src.size) ? src.available + chunkSize : src.size;
+    src.pub.next_input_byte = src.data + consumed;
+    src.pub.bytes_in_buffer = src.available - consumed;
+    if (src.skip_bytes > 0)
+    {
+        const long skip = src.skip_bytes;
+        src.skip_bytes = 0;
+        if (skip > OFstatic_cast(long, src.pub.bytes_in_buffer))
+        {
+            src.skip_bytes = skip - OFstatic_cast(long, src.pub.bytes_in_buffer);
+            src.pub.next_input_byte += src.pub.bytes_in_buffer;
+            src.pub.bytes_in_buffer = 0;
+        } else {
+            src.pub.next_input_byte += skip;
+            src.pub.bytes_in_buffer -= skip;
+        }
+    }
+}
+
+
+/* decompress the given (possibly truncated) data.  If chunkSize is not 0, the data is passed to
+ * the decoder in chunks of the given size, i.e. the decoder has to suspend.
+ */
+static OFBool decompressImage(const OFString &data,
+                              const size_t length,
+                              const size_t chunkSize,
+                              const OFBool fastPath,
+                              Uint16 *image,
+                              int &warnings)
+{
+    struct jpeg_decompress_struct cinfo;
+    TestErrorStruct jerr;
+    TestSourceStruct src;
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = TestErrorExit;
+    jerr.pub.emit_message = TestEmitMessage;
+    jerr.warnings = 0;
+    memset(image, 0, IMAGE_COLUMNS * IMAGE_ROWS * sizeof(Uint16));
+    if (setjmp(jerr.setjmp_buffer))
+    {
+        jpeg_destroy_decompress(&cinfo);
+        jpeg_lossless_set_fast_path(TRUE);
+        return OFFalse;
+    }
+    OFjpeg_create_decompress(&cinfo);
+    src.pub.init_source = TestInitSource;
+    src.pub.fill_input_buffer = TestFillInputBuffer;
+    src.pub.skip_input_data = TestSkipInputData;
+    src.pub.resync_to_restart = jpeg_resync_to_restart;
+    src.pub.term_source = TestTermSource;
+    src.data = OFreinterpret_cast(const JOCTET *, data.data());
+    src.size = length;
+    src.available = (chunkSize > 0) ? 0 : length;
+    src.skip_bytes = 0;
+    src.suspend = (chunkSize > 0);
+    src.pub.next_input_byte = src.data;
+    src.pub.bytes_in_buffer = src.available;
+    cinfo.src = &src.pub;
+    jpeg_lossless_set_fast_path(fastPath);
+    while (jpeg_read_header(&cinfo, TRUE) == JPEG_SUSPENDED)
+        addData(src, chunkSize);
+    while (!jpeg_start_decompress(&cinfo))
+        addData(src, chunkSize);
+    while (cinfo.output_scanline < cinfo.output_height)
+    {
+        JSAMPROW row = OFreinterpret_cast(JSAMPROW, image + cinfo.output_scanline * IMAGE_COLUMNS);
+        if (jpeg_read_scanlines(&cinfo, &row, 1) == 0)
+            addData(src, chunkSize);
+    }
+    while (!jpeg_finish_decompress(&cinfo))
+        addData(src, chunkSize);
+    jpeg_destroy_decompress(&cinfo);
+    jpeg_lossless_set_fast_path(TRUE);
+    warnings = jerr.warnings;
+    return OFTrue;
+}
+
+
+/* decompress the given data with the fast path and with the generic code, the results have to be identical */
+static void checkDecoder(const OFString &data,
+                         const size_t length,
+                         const size_t chunkSize,
+                         const Uint16 *expected,
+                         const char *description)
+{
+    const unsigned long count = IMAGE_COLUMNS * IMAGE_ROWS;
+    Uint16 *generic = new Uint16[count];
+    Uint16 *fast = new Uint16[count];
+    int genericWarnings = 0;
+    int fastWarnings = 0;
+    OFCHECK(decompressImage(data, length, chunkSize, OFFalse, generic, genericWarnings));
+    OFCHECK(decompressImage(data, length, chunkSize, OFTrue, fast, fastWarnings));
+    if (memcmp(generic, fast, count * sizeof(Uint16)) != 0)
+        OFCHECK_FAIL("fast path differs from generic code for " << description << ", length " << length << " of " << data.length()
+            << ", chunk size " << chunkSize);
+    OFCHECK_EQUAL(fastWarnings, genericWarnings);
+    if ((expected != NULL) && (memcmp(expected, fast, count * sizeof(Uint16)) != 0))
+        OFCHECK_FAIL("decompressed image differs from original for " << description << ", chunk size " << chunkSize);
+    delete[] generic;
+    delete[] fast;
+}
+
+
+OFTEST(dcmjpeg_losslessFastPath)
+{
+    const unsigned long count = IMAGE_COLUMNS * IMAGE_ROWS;
+    Uint16 *image = createImage();
+    Uint16 *expected = new Uint16[count];
+    /* restart interval in MCUs (i.e. samples) or in rows, for lossless JPEG the restart interval
+     * has to be a multiple of the number of MCUs per row
+     */
+    static const unsigned int restartIntervals[] = { 0, IMAGE_COLUMNS, 2 * IMAGE_COLUMNS, 0 };
+    static const int restartRows[] = { 0, 0, 0, 5 };
+    static const int predictors[] = { 1, 6 };
+    static const int pointTransforms[] = { 0, 3 };
+    for (size_t p = 0; p < 2; ++p)
+    {
+        for (size_t t = 0; t < 2; ++t)
+        {
+            const int pt = pointTransforms[t];
+            for (unsigned long i = 0; i < count; ++i)
+                expected[i] = OFstatic_cast(Uint16, (image[i] >> pt) << pt);
+            for (size_t r = 0; r < 4; ++r)
+            {
+                OFOStringStream stream;
+                stream << "SV" << predictors[p] << ", Pt " << pt << ", restart interval " << restartIntervals[r]
+                       << " MCUs / " << restartRows[r] << " rows" << OFStringStream_ends;
+                OFSTRINGSTREAM_GETSTR(stream, description)
+                OFString data;
+                OFCHECK(compressImage(image, predictors[p], pt, restartIntervals[r], restartRows[r], data));
+                /* complete data, without and with suspension */
+                checkDecoder(data, data.length(), 0, expected, description);
+                checkDecoder(data, data.length(), 7, expected, description);
+                checkDecoder(data, data.length(), 256, expected, description);
+                /* truncated data, also in the middle of a restart marker */
+                for (size_t k = 1; k < 8; ++k)
+                {
+                    checkDecoder(data, data.length() * k / 8, 0, NULL, description);
+                    checkDecoder(data, data.length() * k / 8, 5, NULL, description);
+                }
+                checkDecoder(data, data.length() - 2, 0, NULL, description);
+                for (size_t pos = data.length() / 2; pos + 1 < data.length(); ++pos)
+                {
+                    if ((OFstatic_cast(unsigned char, data[pos]) == 0xff) && ((data[pos + 1] & 0xf8) == 0xd0))
+                    {
+                        checkDecoder(data, pos + 1, 0, NULL, description);
+                        break;
+                    }
+                }
+                OFSTRINGSTREAM_FREESTR(description)
+            }
+        }
+    }
+    delete[] expected;
+    delete[] image;
+}
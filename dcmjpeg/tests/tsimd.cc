@@ -0,0 +1,202 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmjpeg
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the vectorized routines of the 8 bit and 12 bit IJG libraries
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dcpxitem.h"
+#include "dcmtk/dcmjpeg/djencode.h"
+#include "dcmtk/dcmjpeg/djdecode.h"
+#include "dcmtk/dcmjpeg/djrploss.h"
+#include "dcmtk/dcmjpeg/djutils.h"
+#include "dcmtk/dcmimage/diregist.h"  /* include to support color images */
+
+
+/* size of the test images, not a multiple of the MCU size or the vector width */
+#define IMAGE_COLUMNS 259
+#define IMAGE_ROWS 131
+
+
+/* create an image with gradients and noise covering the given number of bits.
+ * The leftmost 48 columns are flat, so that there are also blocks without AC coefficients.
+ */
+static void createImage(DcmDataset &dset,
+                        const Uint16 samplesPerPixel,
+                        const Uint16 bitsStored)
+{
+    const unsigned long count = OFstatic_cast(unsigned long, IMAGE_COLUMNS) * IMAGE_ROWS * samplesPerPixel;
+    const Uint32 maxValue = (1UL << bitsStored) - 1;
+    dset.putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage);
+    dset.putAndInsertString(DCM_SOPInstanceUID, "1.2.276.0.7230010.3.1.4.0.2");
+    dset.putAndInsertString(DCM_PhotometricInterpretation, (samplesPerPixel == 3) ? "RGB" : "MONOCHROME2");
+    dset.putAndInsertUint16(DCM_SamplesPerPixel, samplesPerPixel);
+    if (samplesPerPixel == 3)
+        dset.putAndInsertUint16(DCM_PlanarConfiguration, 0);
+    dset.putAndInsertUint16(DCM_Rows, IMAGE_ROWS);
+    dset.putAndInsertUint16(DCM_Columns, IMAGE_COLUMNS);
+    dset.putAndInsertUint16(DCM_BitsAllocated, (bitsStored > 8) ? 16 : 8);
+    dset.putAndInsertUint16(DCM_BitsStored, bitsStored);
+    dset.putAndInsertUint16(DCM_HighBit, bitsStored - 1);
+    dset.putAndInsertUint16(DCM_PixelRepresentation, 0);
+    Uint32 seed = 4711;
+    Uint16 *values = new Uint16[count];
+    for (unsigned long i = 0; i < count; ++i)
+    {
+        const unsigned long x = (i / samplesPerPixel) % IMAGE_COLUMNS;
+        const unsigned long y = (i / samplesPerPixel) / IMAGE_COLUMNS;
+        const unsigned long s = i % samplesPerPixel;
+        seed = seed * 1103515245 + 12345;
+        if (x < 48)
+            values[i] = OFstatic_cast(Uint16, maxValue * (s + 1) / 4);
+        else {
+            /* three quarters gradient, one quarter noise (including the extreme values) */
+            values[i] = OFstatic_cast(Uint16, (x * (s + 1) + y * (3 - s)) * maxValue * 3 / (16UL * (IMAGE_COLUMNS + IMAGE_ROWS)) +
+                ((seed >> 16) & 0xff) * maxValue / 1020);
+            if ((seed >> 28) == 0)
+                values[i] = OFstatic_cast(Uint16, (seed & 0x100) ? maxValue : 0);
+        }
+    }
+    if (bitsStored > 8)
+        dset.putAndInsertUint16Array(DCM_PixelData, values, count);
+    else {
+        Uint8 *bytes = new Uint8[count];
+        for (unsigned long i = 0; i < count; ++i)
+            bytes[i] = OFstatic_cast(Uint8, values[i]);
+        dset.putAndInsertUint8Array(DCM_PixelData, bytes, count);
+        delete[] bytes;
+    }
+    delete[] values;
+}
+
+
+/* concatenate all fragments of the compressed pixel data (except for the offset table) */
+static OFBool getCompressedData(DcmDataset &dset,
+                                const E_TransferSyntax xfer,
+                                const DcmRepresentationParameter *param,
+                                OFString &data)
+{
+    DcmElement *elem = NULL;
+    DcmPixelSequence *seq = NULL;
+    data.clear();
+    if (dset.findAndGetElement(DCM_PixelData, elem).bad() ||
+        OFstatic_cast(DcmPixelData *, elem)->getEncapsulatedRepresentation(xfer, param, seq).bad())
+        return OFFalse;
+    const unsigned long count = seq->card();
+    for (unsigned long i = 1; i < count; ++i)
+    {
+        DcmPixelItem *item = NULL;
+        Uint8 *bytes = NULL;
+        if (seq->getItem(item, i).good() && item->getUint8Array(bytes).good() && (bytes != NULL))
+            data.append(OFreinterpret_cast(const char *, bytes), item->getLength());
+    }
+    return !data.empty();
+}
+
+
+/* get the uncompressed pixel data */
+static OFBool getPixelData(DcmDataset &dset,
+                           OFString &data)
+{
+    DcmElement *elem = NULL;
+    Uint8 *bytes = NULL;
+    data.clear();
+    if (dset.findAndGetElement(DCM_PixelData, elem).bad() || elem->getUint8Array(bytes).bad() || (bytes == NULL))
+        return OFFalse;
+    data.assign(OFreinterpret_cast(const char *, bytes), elem->getLength());
+    return OFTrue;
+}
+
+
+/* compress and decompress the given image with the portable code and with all instruction sets
+ * supported by the processor, the results have to be identical
+ */
+static void checkCodec(const Uint16 samplesPerPixel,
+                       const Uint16 bitsStored,
+                       const E_SubSampling subSampling)
+{
+    /* the subsampling is a parameter of the encoder registration */
+    DJEncoderRegistration::cleanup();
+    DJEncoderRegistration::registerCodecs(ECC_lossyYCbCr, EUC_never, OFFalse, 0, 0, 0, OFTrue, subSampling);
+    DcmDataset dset;
+    createImage(dset, samplesPerPixel, bitsStored);
+    const E_TransferSyntax xfer = (bitsStored > 8) ? EXS_JPEGProcess2_4 : EXS_JPEGProcess1;
+    const DJ_RPLossy param(90);
+    /* output of the portable code */
+    DcmJpegHelper::setMaxSIMDLevel(0);
+    OFCHECK_EQUAL(DcmJpegHelper::getSIMDLevel(), 0);
+    OFString expectedCompressed;
+    OFString expectedPixels;
+    DcmDataset encoded(dset);
+    OFCHECK(encoded.chooseRepresentation(xfer, &param).good());
+    OFCHECK(getCompressedData(encoded, xfer, &param, expectedCompressed));
+    encoded.removeAllButCurrentRepresentations();
+    DcmDataset decoded(encoded);
+    OFCHECK(decoded.chooseRepresentation(EXS_LittleEndianExplicit, NULL).good());
+    OFCHECK(getPixelData(decoded, expectedPixels));
+    /* make sure that the image is really lossy compressed and that the colors are converted back */
+    OFString originalPixels;
+    OFCHECK(getPixelData(dset, originalPixels));
+    OFCHECK_EQUAL(expectedPixels.length(), originalPixels.length());
+    OFCHECK(expectedPixels != originalPixels);
+    OFCHECK(expectedCompressed.length() < originalPixels.length());
+    /* compare with the vectorized code */
+    for (int level = 1; level <= 2; ++level)
+    {
+        DcmJpegHelper::setMaxSIMDLevel(level);
+        if (DcmJpegHelper::getSIMDLevel() != level)
+            continue;
+        OFString compressed;
+        DcmDataset copy(dset);
+        OFCHECK(copy.chooseRepresentation(xfer, &param).good());
+        OFCHECK(getCompressedData(copy, xfer, &param, compressed));
+        if (compressed != expectedCompressed)
+            OFCHECK_FAIL("compressed data differs for " << bitsStored << " bit image with " << samplesPerPixel
+                << " sample(s) per pixel, instruction set level " << level);
+        OFString pixels;
+        DcmDataset decodedCopy(encoded);
+        OFCHECK(decodedCopy.chooseRepresentation(EXS_LittleEndianExplicit, NULL).good());
+        OFCHECK(getPixelData(decodedCopy, pixels));
+        if (pixels != expectedPixels)
+            OFCHECK_FAIL("decompressed data differs for " << bitsStored << " bit image with " << samplesPerPixel
+                << " sample(s) per pixel, instruction set level " << level);
+    }
+    DcmJpegHelper::setMaxSIMDLevel(2);
+}
+
+
+OFTEST(dcmjpeg_simdBaseline)
+{
+    DJDecoderRegistration::registerCodecs(EDC_photometricInterpretation, EUC_never);
+    checkCodec(1, 8, ESS_444);
+    /* color conversion without subsampling, with h2v1 and with h2v2 upsampling */
+    checkCodec(3, 8, ESS_444);
+    checkCodec(3, 8, ESS_422);
+    checkCodec(3, 8, ESS_411);
+    DJEncoderRegistration::cleanup();
+    DJDecoderRegistration::cleanup();
+}
+
+
+OFTEST(dcmjpeg_simdExtended)
+{
+    DJDecoderRegistration::registerCodecs(EDC_photometricInterpretation, EUC_never);
+    checkCodec(1, 12, ESS_444);
+    checkCodec(3, 12, ESS_444);
+    checkCodec(3, 12, ESS_422);
+    checkCodec(3, 12, ESS_411);
+    DJEncoderRegistration::cleanup();
+    DJDecoderRegistration::cleanup();
+}
@@ -34,6 +34,7 @@
 #include "dcmtk/dcmdata/cmdlnarg.h"
 #include "dcmtk/ofstd/ofconapp.h"
 #include "dcmtk/dcmdata/dcuid.h"      /* for dcmtk version name */
+#include "dcmtk/dcmdata/dcfrmpar.h"   /* for dcmCodecMaxThreads */
 #include "dcmtk/dcmimage/diregist.h"  /* include to support color images */
 #include "dcmtk/dcmjpls/djlsutil.h"   /* for dcmjpls typedefs */
 #include "dcmtk/dcmjpls/djencode.h"   /* for class DJLSEncoderRegistration */
@@ -97,6 +98,7 @@ int main(int argc, char *argv[])
 
   // encapsulated pixel data encoding options
   OFCmdUnsignedInt opt_fragmentSize = 0; // 0=unlimited
+  OFCmdUnsignedInt opt_threads = 1;
   OFBool           opt_createOffsetTable = OFTrue;
   JLS_UIDCreation  opt_uidcreation = EJLSUC_default;
   OFBool           opt_secondarycapture = OFFalse;
@@ -177,6 +179,9 @@ LICENSE_FILE_DECLARE_COMMAND_LINE_OPTIONS
     cmd.addSubGroup("basic offset table encoding:");
       cmd.addOption("--offset-table-create",    "+ot",    "create offset table (default)");
       cmd.addOption("--offset-table-empty",     "-ot",    "leave offset table empty");
+    cmd.addSubGroup("multi-frame images:");
+      cmd.addOption("--threads",                "+mt", 1, "[n]umber: integer (default: 1)",
+                                                          "compress up to n frames in parallel");
     cmd.addSubGroup("SOP Class UID:");
       cmd.addOption("--class-default",          "+cd",    "keep SOP Class UID (default)");
       cmd.addOption("--class-sc",               "+cs",    "convert to Secondary Capture Image\n(implies --uid-always)");
@@ -363,6 +368,12 @@ LICENSE_FILE_EVALUATE_COMMAND_LINE_OPTIONS
       if (cmd.findOption("--offset-table-empty")) opt_createOffsetTable = OFFalse;
       cmd.endOptionBlock();
 
+      if (cmd.findOption("--threads"))
+      {
+        app.checkValue(cmd.getValueAndCheckMin(opt_threads, 1));
+        dcmCodecMaxThreads.set(OFstatic_cast(Uint32, opt_threads));
+      }
+
       // SOP Class UID options
       cmd.beginOptionBlock();
       if (cmd.findOption("--class-default")) opt_secondarycapture = OFFalse;
@@ -448,12 +459,9 @@ LICENSE_FILE_EVALUATE_COMMAND_LINE_OPTIONS
     DcmXfer original_xfer(dataset->getOriginalXfer());
     if (original_xfer.isEncapsulated())
     {
-      OFLOG_INFO(dcmcjplsLogger, "DICOM file is already compressed, converting to uncompressed transfer syntax first");
-      if (EC_Normal != dataset->chooseRepresentation(EXS_LittleEndianExplicit, NULL))
-      {
-        OFLOG_FATAL(dcmcjplsLogger, "No conversion from compressed original to uncompressed transfer syntax possible!");
-        return 1;
-      }
+      // no explicit conversion to an uncompressed transfer syntax here, chooseRepresentation()
+      // decodes the original pixel data as needed (frame by frame, if the codecs support it)
+      OFLOG_INFO(dcmcjplsLogger, "DICOM file is already compressed, transcoding to the new transfer syntax");
     }
 
     OFString sopClass;
@@ -490,6 +498,8 @@ LICENSE_FILE_EVALUATE_COMMAND_LINE_OPTIONS
 
     OFLOG_INFO(dcmcjplsLogger, "creating output file " << opt_ofname);
 
+    // drop the original (compressed) pixel data, it is not needed for writing
+    dataset->removeAllButCurrentRepresentations();
     fileformat.loadAllDataIntoMemory();
     error = fileformat.saveFile(opt_ofname, opt_oxfer, opt_oenctype, opt_oglenc, opt_opadenc,
       OFstatic_cast(Uint32, opt_filepad), OFstatic_cast(Uint32, opt_itempad), EWM_updateMeta);
@@ -34,6 +34,7 @@
 #include "dcmtk/dcmdata/cmdlnarg.h"
 #include "dcmtk/ofstd/ofconapp.h"
 #include "dcmtk/dcmdata/dcuid.h"      /* for dcmtk version name */
+#include "dcmtk/dcmdata/dcfrmpar.h"   /* for dcmCodecMaxThreads */
 #include "dcmtk/dcmimage/diregist.h"  /* include to support color images */
 #include "dcmtk/dcmjpls/djlsutil.h"   /* for dcmjpgls typedefs */
 #include "dcmtk/dcmjpls/djdecode.h"   /* for JPEG-LS decoder */
@@ -86,6 +87,7 @@ int main(int argc, char *argv[])
   JLS_UIDCreation opt_uidcreation = EJLSUC_default;
   JLS_PlanarConfiguration opt_planarconfig = EJLSPC_restore;
   OFBool opt_ignoreOffsetTable = OFFalse;
+  OFCmdUnsignedInt opt_threads = 1;
 
 #ifdef USE_LICENSE_FILE
 LICENSE_FILE_DECLARATIONS
@@ -125,6 +127,8 @@ LICENSE_FILE_DECLARE_COMMAND_LINE_OPTIONS
       cmd.addOption("--uid-always",             "+ua",    "always assign new UID");
     cmd.addSubGroup("other processing options:");
       cmd.addOption("--ignore-offsettable",     "+io",    "ignore offset table when decompressing");
+      cmd.addOption("--threads",                "+mt", 1, "[n]umber: integer (default: 1)",
+                                                          "decompress up to n frames in parallel");
 
   cmd.addGroup("output options:");
     cmd.addSubGroup("output file format:");
@@ -196,6 +200,12 @@ LICENSE_FILE_EVALUATE_COMMAND_LINE_OPTIONS
 
       if (cmd.findOption("--ignore-offsettable")) opt_ignoreOffsetTable = OFTrue;
 
+      if (cmd.findOption("--threads"))
+      {
+        app.checkValue(cmd.getValueAndCheckMin(opt_threads, 1));
+        dcmCodecMaxThreads.set(OFstatic_cast(Uint32, opt_threads));
+      }
+
       cmd.beginOptionBlock();
       if (cmd.findOption("--read-file"))
       {
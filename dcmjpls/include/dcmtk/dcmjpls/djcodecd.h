@@ -177,6 +177,12 @@ public:
 
 private:
 
+  /// helper class decompressing the frames of a multi-frame image in parallel
+  class FrameDecoder;
+
+  // Needed to keep MS VC6 happy
+  friend class FrameDecoder;
+
   // static private helper methods
 
   /** decompresses a single frame from the given pixel sequence and
@@ -218,6 +224,43 @@ private:
     Uint16 imageSamplesPerPixel,
     Uint16 bytesPerSample);
 
+  /** decompresses a single frame from the given JPEG-LS bitstream and
+   *  stores the result in the given buffer. Does not access the dataset
+   *  or pixel sequence and may thus be called by multiple threads at once.
+   *  @param jlsData compressed JPEG-LS bitstream of the frame
+   *  @param compressedSize size of the compressed bitstream in bytes
+   *  @param buffer pointer to buffer where frame is to be stored
+   *  @param bufSize size of buffer in bytes
+   *  @param imageColumns number of columns for each frame
+   *  @param imageRows number of rows for each frame
+   *  @param imageSamplesPerPixel number of samples per pixel
+   *  @param bytesPerSample number of bytes per sample
+   *  @param imagePlanarConfiguration planar configuration of the uncompressed frame
+   *  @return EC_Normal if successful, an error code otherwise.
+   */
+  static OFCondition decompressFrame(
+    const Uint8 *jlsData,
+    size_t compressedSize,
+    void *buffer,
+    Uint32 bufSize,
+    Uint16 imageColumns,
+    Uint16 imageRows,
+    Uint16 imageSamplesPerPixel,
+    Uint16 bytesPerSample,
+    Uint16 imagePlanarConfiguration);
+
+  /** determines the planar configuration of the uncompressed image
+   *  depending on the codec parameters and the given dataset.
+   *  @param cp codec parameters for this codec
+   *  @param dataset pointer to dataset in which pixel data element is contained
+   *  @param imageSamplesPerPixel number of samples per pixel
+   *  @return planar configuration, 0 is color-by-pixel, 1 is color-by-plane
+   */
+  static Uint16 determineDecompressedPlanarConfiguration(
+    const DJLSCodecParameter *cp,
+    DcmItem *dataset,
+    Uint16 imageSamplesPerPixel);
+
   /** determines if a given image requires color-by-plane planar configuration
    *  depending on SOP Class UID (DICOM IOD) and photometric interpretation.
    *  All SOP classes defined in the 2003 edition of the DICOM standard or earlier
@@ -31,12 +31,14 @@
 class DJLSRepresentationParameter;
 class DJLSCodecParameter;
 class DicomImage;
+class DcmFrameSource;
 
 /** abstract codec class for JPEG-LS encoders.
  *  This abstract class contains most of the application logic
  *  needed for a dcmdata codec object that implements a JPEG-LS encoder
- *  This class only supports compression, it neither implements
- *  decoding nor transcoding.
+ *  This class only supports compression, it does not implement decoding.
+ *  Compressed images can be transcoded frame by frame with the lossless
+ *  raw encoder, see encodeFrames().
  */
 class DCMTK_DCMJPLS_EXPORT DJLSEncoderBase : public DcmCodec
 {
@@ -146,6 +148,27 @@ public:
     const DcmCodecParameter * cp,
     DcmStack & objStack) const;
 
+  /** compresses the frames of a compressed DICOM image, which are decompressed
+   *  batch by batch by the given frame source, and stores the result in the
+   *  given pixSeq element. Only supported by the lossless raw encoder, i.e.
+   *  EC_IllegalCall is returned if the cooked encoder would be used.
+   *  @param frames source of the uncompressed frames
+   *  @param toRepParam representation parameter describing the desired
+   *    compressed representation
+   *  @param pixSeq compressed pixel sequence (pointer to new DcmPixelSequence object
+   *    allocated on heap) returned in this parameter upon success.
+   *  @param cp codec parameters for this codec
+   *  @param objStack stack pointing to the location of the pixel data
+   *    element in the current dataset.
+   *  @return EC_Normal if successful, an error code otherwise.
+   */
+  virtual OFCondition encodeFrames(
+    DcmFrameSource& frames,
+    const DcmRepresentationParameter * toRepParam,
+    DcmPixelSequence * & pixSeq,
+    const DcmCodecParameter * cp,
+    DcmStack & objStack) const;
+
   /** checks if this codec is able to convert from the
    *  given current transfer syntax to the given new
    *  transfer syntax
@@ -179,17 +202,47 @@ public:
 
 private:
 
+  /// helper class compressing the frames of an image, possibly in parallel
+  class FrameCompressor;
+
+  // Needed to keep MS VC6 happy
+  friend class FrameCompressor;
+
   /** returns the transfer syntax that this particular codec
    *  is able to encode
    *  @return supported transfer syntax
    */
   virtual E_TransferSyntax supportedTransferSyntax() const = 0;
 
+  /** compresses the given uncompressed DICOM image, or the frames provided
+   *  by the given frame source, and stores the result in the given pixSeq element.
+   *  @param pixelData pointer to the uncompressed image data in OW format
+   *    and local byte order, NULL if frames is used
+   *  @param length of the pixel data field in bytes
+   *  @param frames source of the uncompressed frames, NULL if pixelData is used
+   *  @param toRepParam representation parameter describing the desired
+   *    compressed representation
+   *  @param pixSeq compressed pixel sequence returned in this parameter upon success.
+   *  @param cp codec parameters for this codec
+   *  @param objStack stack pointing to the location of the pixel data
+   *    element in the current dataset.
+   *  @return EC_Normal if successful, an error code otherwise.
+   */
+  OFCondition encodeImage(
+    const Uint16 * pixelData,
+    const Uint32 length,
+    DcmFrameSource * frames,
+    const DcmRepresentationParameter * toRepParam,
+    DcmPixelSequence * & pixSeq,
+    const DcmCodecParameter *cp,
+    DcmStack & objStack) const;
+
   /** lossless encoder that compresses the complete pixel cell
    *  (very much like the RLE encoder in module dcmdata).
    *  @param pixelData pointer to the uncompressed image data in OW format
-   *    and local byte order
+   *    and local byte order, NULL if frames is used
    *  @param length of the pixel data field in bytes
+   *  @param frames source of the uncompressed frames, NULL if pixelData is used
    *  @param dataset pointer to dataset containing image pixel module
    *  @param djrp representation parameter
    *  @param pixSeq pixel sequence to write to
@@ -200,6 +253,7 @@ private:
   OFCondition losslessRawEncode(
     const Uint16 *pixelData,
     const Uint32 length,
+    DcmFrameSource *frames,
     DcmItem *dataset,
     const DJLSRepresentationParameter *djrp,
     DcmPixelSequence * & pixSeq,
@@ -270,8 +324,8 @@ private:
    *  @param samplesPerPixel image samples per pixel
    *  @param planarConfiguration image planar configuration
    *  @param photometricInterpretation photometric interpretation of the DICOM dataset
-   *  @param pixelSequence object in which the compressed frame is stored
-   *  @param offsetList list of frame offsets updated in this parameter
+   *  @param compressedFrame compressed frame returned in this parameter,
+   *    allocated with new[]
    *  @param compressedSize size of compressed frame returned in this parameter
    *  @param djcp parameters for the codec
    *  @return EC_Normal if successful, an error code otherwise
@@ -284,16 +338,17 @@ private:
     Uint16 samplesPerPixel,
     Uint16 planarConfiguration,
     const OFString& photometricInterpretation,
-    DcmPixelSequence *pixelSequence,
-    DcmOffsetList &offsetList,
-    unsigned long &compressedSize,
+    Uint8 *&compressedFrame,
+    Uint32 &compressedSize,
     const DJLSCodecParameter *djcp) const;
 
-  /** perform the lossless cooked compression of a single frame
-   *  @param pixelSequence object in which the compressed frame is stored
+  /** perform the lossless cooked compression of a single frame.
+   *  Only reads the intermediate representation of the given DicomImage,
+   *  so multiple frames of the same image can be compressed at the same time.
    *  @param dimage DicomImage instance used to process frame
    *  @param photometricInterpretation photometric interpretation of the DICOM dataset
-   *  @param offsetList list of frame offsets updated in this parameter
+   *  @param compressedFrame compressed frame returned in this parameter,
+   *    allocated with new[]
    *  @param compressedSize size of compressed frame returned in this parameter
    *  @param djcp parameters for the codec
    *  @param frame frame index
@@ -301,11 +356,10 @@ private:
    *  @return EC_Normal if successful, an error code otherwise
    */
   OFCondition compressCookedFrame(
-    DcmPixelSequence *pixelSequence,
     DicomImage *dimage,
     const OFString& photometricInterpretation,
-    DcmOffsetList &offsetList,
-    unsigned long &compressedSize,
+    Uint8 *&compressedFrame,
+    Uint32 &compressedSize,
     const DJLSCodecParameter *djcp,
     Uint32 frame,
     Uint16 nearLosslessDeviation) const;
@@ -228,15 +228,12 @@ public:
 		  {
 			  MakeValid();
 		  }
-		  bufType valTest = _readCache;
-
-		  for (LONG count = 0; count < 16; count++)
-		  {
-			  if ((valTest & (bufType(1) << (bufferbits - 1))) != 0)
-				  return count;
-
-			  valTest <<= 1;
-		  }
+		  // look up the number of leading zero bits in the next 16 bits
+		  LONG valTest = LONG(_readCache >> (bufferbits - 16));
+		  if (valTest >= 0x100)
+			  return _leadingZeros[valTest >> 8];
+		  if (valTest != 0)
+			  return 8 + _leadingZeros[valTest];
 		  return -1;
 	  }
 
@@ -273,6 +270,9 @@ protected:
 	OFauto_ptr<ProcessLine> _processLine;
 
 private:
+	// number of leading zero bits of a byte (8 for 0)
+	static const BYTE _leadingZeros[256];
+
 	// decoding
 	bufType _readCache;
 	LONG _validBits;
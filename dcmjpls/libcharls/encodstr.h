@@ -105,6 +105,10 @@ protected:
 			if (bitpos >= 32)
 				break;
 
+			// make sure that the byte fits into the buffer
+			if (_compressedLength == 0)
+				throw JlsException(CompressedBufferTooSmall);
+
 			if (_isFFWritten)
 			{
 				// insert highmost bit
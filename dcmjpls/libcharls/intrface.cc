@@ -87,7 +87,14 @@ CHARLS_IMEXPORT(JLS_ERROR) JpegLsEncode(void* compressedData, size_t compressedL
 	}
 
 	
-	stream.Write((BYTE*)compressedData, compressedLength);
+	try
+	{
+		stream.Write((BYTE*)compressedData, compressedLength);
+	}
+	catch (JlsException& e)
+	{
+		return e._error;
+	}
 	
 	*pcbyteWritten = stream.GetBytesWritten();	
 	return OK;
@@ -175,7 +182,14 @@ CHARLS_IMEXPORT(JLS_ERROR) JpegLsVerifyEncode(const void* uncompressedData, size
 	memcpy(&rgbyteCompressed[0], compressedData, compressedLength);
 	
 	stream.EnableCompare(true);
-	stream.Write(&rgbyteCompressed[0], compressedLength);
+	try
+	{
+		stream.Write(&rgbyteCompressed[0], compressedLength);
+	}
+	catch (JlsException& e)
+	{
+		return e._error;
+	}
 	
 	return OK;
 }
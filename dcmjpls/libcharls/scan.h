@@ -61,21 +61,15 @@ inlinehint LONG GetPredictedValue(LONG Ra, LONG Rb, LONG Rc)
 
 inlinehint LONG GetPredictedValue(LONG Ra, LONG Rb, LONG Rc)
 {
-	// sign trick reduces the number of if statements (branches) 
-	LONG sgn = BitWiseSign(Rb - Ra);
-
-	// is Ra between Rc and Rb? 
-	if ((sgn ^ (Rc - Ra)) < 0)
-	{
-		return Rb;
-	} 
-	else if ((sgn ^ (Rb - Rc)) < 0)
-	{
-		return Ra;
-	}
-
-	// default case, valid if Rc element of [Ra,Rb] 
-	return Ra + Rb - Rc;
+	// median edge detector: written with conditional assignments only, so
+	// that the compiler can avoid (badly predictable) branches
+	LONG minab = MIN(Ra, Rb);
+	LONG maxab = MAX(Ra, Rb);
+	LONG Px = Ra + Rb - Rc;
+
+	Px = (Rc >= maxab) ? minab : Px;
+	Px = (Rc <= minab) ? maxab : Px;
+	return Px;
 }
 
 #endif
@@ -64,7 +64,10 @@ private:
 	void WriteByte(BYTE val)
 	{ 
 		ASSERT(!_bCompare || _pdata[_cbyteOffset] == val);
-		
+
+		if (_cbyteOffset >= _cbyteLength)
+			throw JlsException(CompressedBufferTooSmall);
+
 		_pdata[_cbyteOffset++] = val; 
 	}
 
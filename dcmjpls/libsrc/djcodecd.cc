@@ -33,6 +33,7 @@
 #include "dcmtk/dcmdata/dcvrpobw.h"  /* for class DcmPolymorphOBOW */
 #include "dcmtk/dcmdata/dcswap.h"    /* for swapIfNecessary() */
 #include "dcmtk/dcmdata/dcuid.h"     /* for dcmGenerateUniqueIdentifer()*/
+#include "dcmtk/dcmdata/dcfrmpar.h"  /* for class DcmFrameProcessor */
 #include "dcmtk/dcmjpls/djcparam.h"  /* for class DJLSCodecParameter */
 #include "djerror.h"                 /* for private class DJLSError */
 
@@ -51,6 +52,118 @@ E_TransferSyntax DJLSNearLosslessDecoder::supportedTransferSyntax() const
 
 // --------------------------------------------------------------------------
 
+/** helper class decompressing the frames of a multi-frame image in parallel.
+ *  The frames are decompressed from the fragment table only, without access
+ *  to the dataset or the pixel sequence.
+ */
+class DJLSDecoderBase::FrameDecoder: public DcmFrameProcessor
+{
+public:
+
+  /** constructor
+   *  @param fragments fragments of the compressed pixel sequence
+   *  @param imageData buffer for all uncompressed frames
+   *  @param frameSize size of an uncompressed frame in bytes
+   *  @param columns number of columns
+   *  @param rows number of rows
+   *  @param samplesPerPixel number of samples per pixel
+   *  @param bytesPerSample number of bytes per sample
+   *  @param planarConfiguration planar configuration of the uncompressed image
+   */
+  FrameDecoder(
+    const DcmFragmentTable& fragments,
+    Uint8 *imageData,
+    Uint32 frameSize,
+    Uint16 columns,
+    Uint16 rows,
+    Uint16 samplesPerPixel,
+    Uint16 bytesPerSample,
+    Uint16 planarConfiguration)
+  : DcmFrameProcessor()
+  , fragments_(fragments)
+  , imageData_(imageData)
+  , frameSize_(frameSize)
+  , columns_(columns)
+  , rows_(rows)
+  , samplesPerPixel_(samplesPerPixel)
+  , bytesPerSample_(bytesPerSample)
+  , planarConfiguration_(planarConfiguration)
+  {
+  }
+
+protected:
+
+  /** decompress the given frame into its place in the output buffer
+   *  @param frameNo number of the frame
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition processFrame(Uint32 frameNo)
+  {
+    const Uint32 startItem = fragments_.getStartFragment(frameNo);
+    const Uint32 endItem = fragments_.getEndFragment(frameNo);
+    Uint8 *buffer = imageData_ + frameNo * frameSize_;
+    DCMJPLS_DEBUG("JPEG-LS decoder processes frame " << (frameNo+1) << " with fragment " << startItem);
+
+    // a frame stored in a single fragment is decompressed in place
+    if (endItem == startItem + 1)
+    {
+      if (fragments_.getData(startItem) == NULL) return EC_JLSCannotComputeNumberOfFragments;
+      return decompressFrame(fragments_.getData(startItem), fragments_.getLength(startItem), buffer, frameSize_,
+        columns_, rows_, samplesPerPixel_, bytesPerSample_, planarConfiguration_);
+    }
+
+    // otherwise concatenate the fragments of the frame
+    size_t compressedSize = 0;
+    Uint32 i;
+    for (i = startItem; i < endItem; ++i) compressedSize += fragments_.getLength(i);
+    Uint8 *jlsData = new Uint8[compressedSize];
+    size_t offset = 0;
+    for (i = startItem; i < endItem; ++i)
+    {
+      if (fragments_.getData(i)) memcpy(jlsData + offset, fragments_.getData(i), fragments_.getLength(i));
+      offset += fragments_.getLength(i);
+    }
+    OFCondition result = decompressFrame(jlsData, compressedSize, buffer, frameSize_,
+      columns_, rows_, samplesPerPixel_, bytesPerSample_, planarConfiguration_);
+    delete[] jlsData;
+    return result;
+  }
+
+private:
+
+  /// private undefined copy constructor
+  FrameDecoder(const FrameDecoder&);
+
+  /// private undefined copy assignment operator
+  FrameDecoder& operator=(const FrameDecoder&);
+
+  /// fragments of the compressed pixel sequence
+  const DcmFragmentTable& fragments_;
+
+  /// buffer for all uncompressed frames
+  Uint8 *imageData_;
+
+  /// size of an uncompressed frame in bytes
+  Uint32 frameSize_;
+
+  /// number of columns
+  Uint16 columns_;
+
+  /// number of rows
+  Uint16 rows_;
+
+  /// number of samples per pixel
+  Uint16 samplesPerPixel_;
+
+  /// number of bytes per sample
+  Uint16 bytesPerSample_;
+
+  /// planar configuration of the uncompressed image
+  Uint16 planarConfiguration_;
+};
+
+// --------------------------------------------------------------------------
+
 DJLSDecoderBase::DJLSDecoderBase()
 : DcmCodec()
 {
@@ -158,6 +271,21 @@ OFCondition DJLSDecoderBase::decode(
   Uint32 currentItem = 1; // item 0 contains the offset table
   OFBool done = OFFalse;
 
+  if ((imageFrames > 1) && (dcmCodecMaxThreads.get() > 1))
+  {
+    // decompress the frames in parallel if the fragments of each frame are known
+    DcmFragmentTable fragments;
+    result = fragments.create(pixSeq, OFstatic_cast(Uint32, imageFrames));
+    if (result.good() && fragments.hasFrameIndex() &&
+        (!djcp->ignoreOffsetTable() || (fragments.numberOfFragments() == OFstatic_cast(Uint32, imageFrames) + 1)))
+    {
+      FrameDecoder frameDecoder(fragments, pixeldata8, frameSize, imageColumns, imageRows, imageSamplesPerPixel,
+        bytesPerSample, determineDecompressedPlanarConfiguration(djcp, dataset, imageSamplesPerPixel));
+      result = frameDecoder.run(0, OFstatic_cast(Uint32, imageFrames));
+      done = OFTrue;
+    }
+  }
+
   while (result.good() && !done)
   {
       DCMJPLS_DEBUG("JPEG-LS decoder processes frame " << (currentFrame+1));
@@ -303,35 +431,7 @@ OFCondition DJLSDecoderBase::decodeFrame(
   if (fragmentsForThisFrame == 0) result = EC_JLSCannotComputeNumberOfFragments;
 
   // determine planar configuration for uncompressed data
-  OFString imageSopClass;
-  OFString imagePhotometricInterpretation;
-  dataset->findAndGetOFString(DCM_SOPClassUID, imageSopClass);
-  dataset->findAndGetOFString(DCM_PhotometricInterpretation, imagePhotometricInterpretation);
-  Uint16 imagePlanarConfiguration = 0; // 0 is color-by-pixel, 1 is color-by-plane
-
-  if (imageSamplesPerPixel > 1)
-  {
-    switch (cp->getPlanarConfiguration())
-    {
-      case EJLSPC_restore:
-        // get planar configuration from dataset
-        imagePlanarConfiguration = 2; // invalid value
-        dataset->findAndGetUint16(DCM_PlanarConfiguration, imagePlanarConfiguration);
-        // determine auto default if not found or invalid
-        if (imagePlanarConfiguration > 1)
-          imagePlanarConfiguration = determinePlanarConfiguration(imageSopClass, imagePhotometricInterpretation);
-        break;
-      case EJLSPC_auto:
-        imagePlanarConfiguration = determinePlanarConfiguration(imageSopClass, imagePhotometricInterpretation);
-        break;
-      case EJLSPC_colorByPixel:
-        imagePlanarConfiguration = 0;
-        break;
-      case EJLSPC_colorByPlane:
-        imagePlanarConfiguration = 1;
-        break;
-    }
-  }
+  Uint16 imagePlanarConfiguration = determineDecompressedPlanarConfiguration(cp, dataset, imageSamplesPerPixel);
 
   // get the size of all the fragments
   if (result.good())
@@ -352,7 +452,24 @@ OFCondition DJLSDecoderBase::decodeFrame(
     } /* while */
   }
 
-  // get the compressed data
+  // a frame stored in a single fragment is decompressed in place
+  if (result.good() && (fragmentsForThisFrame == 1))
+  {
+    result = fromPixSeq->getItem(pixItem, currentItem++);
+    if (result.good() && pixItem)
+    {
+      result = pixItem->getUint8Array(jlsFragmentData);
+      if (result.good() && (jlsFragmentData == NULL)) result = EC_JLSCannotComputeNumberOfFragments;
+      if (result.good())
+      {
+        result = decompressFrame(jlsFragmentData, compressedSize, buffer, bufSize, imageColumns, imageRows,
+          imageSamplesPerPixel, bytesPerSample, imagePlanarConfiguration);
+      }
+    }
+    return result;
+  }
+
+  // otherwise get the compressed data of all fragments
   if (result.good())
   {
     Uint32 offset = 0;
@@ -376,64 +493,78 @@ OFCondition DJLSDecoderBase::decodeFrame(
 
   if (result.good())
   {
-    JlsParameters params;
-    JLS_ERROR err;
+    result = decompressFrame(jlsData, compressedSize, buffer, bufSize, imageColumns, imageRows,
+      imageSamplesPerPixel, bytesPerSample, imagePlanarConfiguration);
+  }
+  delete[] jlsData;
+
+  return result;
+}
+
+
+OFCondition DJLSDecoderBase::decompressFrame(
+    const Uint8 *jlsData,
+    size_t compressedSize,
+    void *buffer,
+    Uint32 bufSize,
+    Uint16 imageColumns,
+    Uint16 imageRows,
+    Uint16 imageSamplesPerPixel,
+    Uint16 bytesPerSample,
+    Uint16 imagePlanarConfiguration)
+{
+  JlsParameters params;
+  JLS_ERROR err;
+
+  err = JpegLsReadHeader(jlsData, compressedSize, &params);
+  OFCondition result = DJLSError::convert(err);
 
-    err = JpegLsReadHeader(jlsData, compressedSize, &params);
+  if (result.good())
+  {
+    if (params.width != imageColumns) result = EC_JLSImageDataMismatch;
+    else if (params.height != imageRows) result = EC_JLSImageDataMismatch;
+    else if (params.components != imageSamplesPerPixel) result = EC_JLSImageDataMismatch;
+    else if ((bytesPerSample == 1) && (params.bitspersample > 8)) result = EC_JLSImageDataMismatch;
+    else if ((bytesPerSample == 2) && (params.bitspersample <= 8)) result = EC_JLSImageDataMismatch;
+  }
+
+  if (result.good())
+  {
+    err = JpegLsDecode(buffer, bufSize, jlsData, compressedSize, &params);
     result = DJLSError::convert(err);
 
-    if (result.good())
+    if (result.good() && imageSamplesPerPixel == 3)
     {
-      if (params.width != imageColumns) result = EC_JLSImageDataMismatch;
-      else if (params.height != imageRows) result = EC_JLSImageDataMismatch;
-      else if (params.components != imageSamplesPerPixel) result = EC_JLSImageDataMismatch;
-      else if ((bytesPerSample == 1) && (params.bitspersample > 8)) result = EC_JLSImageDataMismatch;
-      else if ((bytesPerSample == 2) && (params.bitspersample <= 8)) result = EC_JLSImageDataMismatch;
+      if (imagePlanarConfiguration == 1 && params.ilv != ILV_NONE)
+      {
+        // The dataset says this should be planarConfiguration == 1, but
+        // it isn't -> convert it.
+        DCMJPLS_WARN("different planar configuration in JPEG stream, converting to \"1\"");
+        if (bytesPerSample == 1)
+          result = createPlanarConfiguration1Byte(OFreinterpret_cast(Uint8*, buffer), imageColumns, imageRows);
+        else
+          result = createPlanarConfiguration1Word(OFreinterpret_cast(Uint16*, buffer), imageColumns, imageRows);
+      }
+      else if (imagePlanarConfiguration == 0 && params.ilv != ILV_SAMPLE && params.ilv != ILV_LINE)
+      {
+        // The dataset says this should be planarConfiguration == 0, but
+        // it isn't -> convert it.
+        DCMJPLS_WARN("different planar configuration in JPEG stream, converting to \"0\"");
+        if (bytesPerSample == 1)
+          result = createPlanarConfiguration0Byte(OFreinterpret_cast(Uint8*, buffer), imageColumns, imageRows);
+        else
+          result = createPlanarConfiguration0Word(OFreinterpret_cast(Uint16*, buffer), imageColumns, imageRows);
+      }
     }
 
-    if (!result.good())
-    {
-      delete[] jlsData;
-    }
-    else
+    if (result.good())
     {
-      err = JpegLsDecode(buffer, bufSize, jlsData, compressedSize, &params);
-      result = DJLSError::convert(err);
-      delete[] jlsData;
-
-      if (result.good() && imageSamplesPerPixel == 3)
-      {
-        if (imagePlanarConfiguration == 1 && params.ilv != ILV_NONE)
-        {
-          // The dataset says this should be planarConfiguration == 1, but
-          // it isn't -> convert it.
-          DCMJPLS_WARN("different planar configuration in JPEG stream, converting to \"1\"");
-          if (bytesPerSample == 1)
-            result = createPlanarConfiguration1Byte(OFreinterpret_cast(Uint8*, buffer), imageColumns, imageRows);
-          else
-            result = createPlanarConfiguration1Word(OFreinterpret_cast(Uint16*, buffer), imageColumns, imageRows);
-        }
-        else if (imagePlanarConfiguration == 0 && params.ilv != ILV_SAMPLE && params.ilv != ILV_LINE)
+        // decompression is complete, finally adjust byte order if necessary
+        if (bytesPerSample == 1) // we're writing bytes into words
         {
-          // The dataset says this should be planarConfiguration == 0, but
-          // it isn't -> convert it.
-          DCMJPLS_WARN("different planar configuration in JPEG stream, converting to \"0\"");
-          if (bytesPerSample == 1)
-            result = createPlanarConfiguration0Byte(OFreinterpret_cast(Uint8*, buffer), imageColumns, imageRows);
-          else
-            result = createPlanarConfiguration0Word(OFreinterpret_cast(Uint16*, buffer), imageColumns, imageRows);
+            result = swapIfNecessary(gLocalByteOrder, EBO_LittleEndian, buffer,
+                    bufSize, sizeof(Uint16));
         }
-      }
-
-      if (result.good())
-      {
-          // decompression is complete, finally adjust byte order if necessary
-          if (bytesPerSample == 1) // we're writing bytes into words
-          {
-              result = swapIfNecessary(gLocalByteOrder, EBO_LittleEndian, buffer,
-                      bufSize, sizeof(Uint16));
-          }
-      }
     }
   }
 
@@ -485,6 +616,44 @@ OFCondition DJLSDecoderBase::determineDecompressedColorModel(
 }
 
 
+Uint16 DJLSDecoderBase::determineDecompressedPlanarConfiguration(
+  const DJLSCodecParameter *cp,
+  DcmItem *dataset,
+  Uint16 imageSamplesPerPixel)
+{
+  OFString imageSopClass;
+  OFString imagePhotometricInterpretation;
+  dataset->findAndGetOFString(DCM_SOPClassUID, imageSopClass);
+  dataset->findAndGetOFString(DCM_PhotometricInterpretation, imagePhotometricInterpretation);
+  Uint16 imagePlanarConfiguration = 0; // 0 is color-by-pixel, 1 is color-by-plane
+
+  if (imageSamplesPerPixel > 1)
+  {
+    switch (cp->getPlanarConfiguration())
+    {
+      case EJLSPC_restore:
+        // get planar configuration from dataset
+        imagePlanarConfiguration = 2; // invalid value
+        dataset->findAndGetUint16(DCM_PlanarConfiguration, imagePlanarConfiguration);
+        // determine auto default if not found or invalid
+        if (imagePlanarConfiguration > 1)
+          imagePlanarConfiguration = determinePlanarConfiguration(imageSopClass, imagePhotometricInterpretation);
+        break;
+      case EJLSPC_auto:
+        imagePlanarConfiguration = determinePlanarConfiguration(imageSopClass, imagePhotometricInterpretation);
+        break;
+      case EJLSPC_colorByPixel:
+        imagePlanarConfiguration = 0;
+        break;
+      case EJLSPC_colorByPlane:
+        imagePlanarConfiguration = 1;
+        break;
+    }
+  }
+  return imagePlanarConfiguration;
+}
+
+
 Uint16 DJLSDecoderBase::determinePlanarConfiguration(
   const OFString& sopClassUID,
   const OFString& photometricInterpretation)
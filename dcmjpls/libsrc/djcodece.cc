@@ -45,6 +45,7 @@
 #include "dcmtk/dcmdata/dcvrst.h"    /* for class DcmShortText */
 #include "dcmtk/dcmdata/dcvrus.h"    /* for class DcmUnsignedShort */
 #include "dcmtk/dcmdata/dcswap.h"    /* for swapIfNecessary */
+#include "dcmtk/dcmdata/dcfrmpar.h"  /* for classes DcmFrameCompressor and DcmFrameSource */
 
 // dcmjpls includes
 #include "dcmtk/dcmjpls/djcparam.h"  /* for class DJLSCodecParameter */
@@ -82,6 +83,174 @@ E_TransferSyntax DJLSNearLosslessEncoder::supportedTransferSyntax() const
 
 // --------------------------------------------------------------------------
 
+/** helper class compressing the frames of an image, possibly in parallel.
+ *  Frames are either compressed from the raw pixel data, from frames that
+ *  are decompressed batch by batch by a frame source, or from the
+ *  intermediate representation of a DicomImage.
+ */
+class DJLSEncoderBase::FrameCompressor: public DcmFrameCompressor
+{
+public:
+
+  /** constructor for the raw encoder
+   *  @param codec the codec compressing the frames
+   *  @param pixelData pointer to the first frame, NULL if the frames are
+   *    provided by the frame source
+   *  @param frames source of the uncompressed frames, NULL if pixelData is used
+   *  @param frameSize size of an uncompressed frame in bytes
+   *  @param bitsAllocated number of bits allocated per pixel
+   *  @param columns frame width
+   *  @param rows frame height
+   *  @param samplesPerPixel image samples per pixel
+   *  @param planarConfiguration image planar configuration
+   *  @param photometricInterpretation photometric interpretation of the DICOM dataset
+   *  @param djcp parameters for the codec
+   */
+  FrameCompressor(
+    const DJLSEncoderBase& codec,
+    const Uint8 *pixelData,
+    DcmFrameSource *frames,
+    unsigned long frameSize,
+    Uint16 bitsAllocated,
+    Uint16 columns,
+    Uint16 rows,
+    Uint16 samplesPerPixel,
+    Uint16 planarConfiguration,
+    const OFString& photometricInterpretation,
+    const DJLSCodecParameter *djcp)
+  : DcmFrameCompressor()
+  , codec_(codec)
+  , pixelData_(pixelData)
+  , frames_(frames)
+  , frameSize_(frameSize)
+  , bitsAllocated_(bitsAllocated)
+  , columns_(columns)
+  , rows_(rows)
+  , samplesPerPixel_(samplesPerPixel)
+  , planarConfiguration_(planarConfiguration)
+  , dimage_(NULL)
+  , nearLosslessDeviation_(0)
+  , photometricInterpretation_(photometricInterpretation)
+  , djcp_(djcp)
+  {
+  }
+
+  /** constructor for the cooked encoder
+   *  @param codec the codec compressing the frames
+   *  @param dimage DicomImage instance used to process frames
+   *  @param photometricInterpretation photometric interpretation of the DICOM dataset
+   *  @param djcp parameters for the codec
+   *  @param nearLosslessDeviation maximum deviation for near-lossless encoding
+   */
+  FrameCompressor(
+    const DJLSEncoderBase& codec,
+    DicomImage *dimage,
+    const OFString& photometricInterpretation,
+    const DJLSCodecParameter *djcp,
+    Uint16 nearLosslessDeviation)
+  : DcmFrameCompressor()
+  , codec_(codec)
+  , pixelData_(NULL)
+  , frames_(NULL)
+  , frameSize_(0)
+  , bitsAllocated_(0)
+  , columns_(0)
+  , rows_(0)
+  , samplesPerPixel_(0)
+  , planarConfiguration_(0)
+  , dimage_(dimage)
+  , nearLosslessDeviation_(nearLosslessDeviation)
+  , photometricInterpretation_(photometricInterpretation)
+  , djcp_(djcp)
+  {
+  }
+
+protected:
+
+  /** decompress a batch of frames if a frame source is used
+   *  @param firstFrame number of the first frame of the batch
+   *  @param numberOfFrames number of frames in the batch
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition prepareFrames(Uint32 firstFrame, Uint32 numberOfFrames)
+  {
+    if (frames_ == NULL) return EC_Normal;
+    OFCondition result = frames_->decompressFrames(firstFrame, numberOfFrames);
+
+    // byte swap the frames to little endian if bits allocated is 8
+    if (result.good() && (gLocalByteOrder == EBO_BigEndian) && (bitsAllocated_ == 8))
+    {
+      for (Uint32 i = 0; (i < numberOfFrames) && result.good(); ++i)
+        result = swapIfNecessary(EBO_LittleEndian, gLocalByteOrder, frames_->getFrame(firstFrame + i),
+          OFstatic_cast(Uint32, frameSize_ + (frameSize_ & 1)), sizeof(Uint16));
+    }
+    return result;
+  }
+
+  /** compress a single frame
+   *  @param frameNo number of the frame to be compressed
+   *  @param compressedData returns the compressed frame
+   *  @param compressedLength returns the length of the compressed frame
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  virtual OFCondition compressFrame(Uint32 frameNo, Uint8 *&compressedData, Uint32 &compressedLength)
+  {
+    DCMJPLS_DEBUG("JPEG-LS encoder processes frame " << (frameNo+1));
+    if (dimage_)
+    {
+      return codec_.compressCookedFrame(dimage_, photometricInterpretation_,
+        compressedData, compressedLength, djcp_, frameNo, nearLosslessDeviation_);
+    }
+    const Uint8 *framePointer = frames_ ? frames_->getFrame(frameNo) : pixelData_ + frameNo * frameSize_;
+    if (framePointer == NULL) return EC_IllegalCall;
+    return codec_.compressRawFrame(framePointer, bitsAllocated_, columns_, rows_,
+      samplesPerPixel_, planarConfiguration_, photometricInterpretation_, compressedData, compressedLength, djcp_);
+  }
+
+private:
+
+  /// the codec compressing the frames
+  const DJLSEncoderBase& codec_;
+
+  /// pointer to the first frame for the raw encoder
+  const Uint8 *pixelData_;
+
+  /// source of the uncompressed frames for the raw encoder, NULL if pixelData_ is used
+  DcmFrameSource *frames_;
+
+  /// size of an uncompressed frame in bytes for the raw encoder
+  unsigned long frameSize_;
+
+  /// number of bits allocated per pixel for the raw encoder
+  Uint16 bitsAllocated_;
+
+  /// frame width for the raw encoder
+  Uint16 columns_;
+
+  /// frame height for the raw encoder
+  Uint16 rows_;
+
+  /// image samples per pixel for the raw encoder
+  Uint16 samplesPerPixel_;
+
+  /// image planar configuration for the raw encoder
+  Uint16 planarConfiguration_;
+
+  /// DicomImage instance for the cooked encoder, NULL for the raw encoder
+  DicomImage *dimage_;
+
+  /// maximum deviation for near-lossless encoding
+  Uint16 nearLosslessDeviation_;
+
+  /// photometric interpretation of the DICOM dataset
+  OFString photometricInterpretation_;
+
+  /// parameters for the codec
+  const DJLSCodecParameter *djcp_;
+};
+
+// --------------------------------------------------------------------------
+
 DJLSEncoderBase::DJLSEncoderBase()
 : DcmCodec()
 {
@@ -140,7 +309,8 @@ OFCondition DJLSEncoderBase::encode(
     const DcmCodecParameter * /* cp */,
     DcmStack & /* objStack */) const
 {
-  // we don't support re-coding for now.
+  // we don't support direct re-coding, compressed images are
+  // transcoded frame by frame with encodeFrames()
   return EC_IllegalCall;
 }
 
@@ -151,6 +321,28 @@ OFCondition DJLSEncoderBase::encode(
     DcmPixelSequence * & pixSeq,
     const DcmCodecParameter *cp,
     DcmStack & objStack) const
+{
+  return encodeImage(pixelData, length, NULL, toRepParam, pixSeq, cp, objStack);
+}
+
+OFCondition DJLSEncoderBase::encodeFrames(
+    DcmFrameSource& frames,
+    const DcmRepresentationParameter * toRepParam,
+    DcmPixelSequence * & pixSeq,
+    const DcmCodecParameter *cp,
+    DcmStack & objStack) const
+{
+  return encodeImage(NULL, 0, &frames, toRepParam, pixSeq, cp, objStack);
+}
+
+OFCondition DJLSEncoderBase::encodeImage(
+    const Uint16 * pixelData,
+    const Uint32 length,
+    DcmFrameSource * frames,
+    const DcmRepresentationParameter * toRepParam,
+    DcmPixelSequence * & pixSeq,
+    const DcmCodecParameter *cp,
+    DcmStack & objStack) const
 {
   OFCondition result = EC_Normal;
   DJLSRepresentationParameter defRep;
@@ -170,11 +362,17 @@ OFCondition DJLSEncoderBase::encode(
   if (!djrp)
     djrp = &defRep;
 
+  // the cooked encoder needs the complete uncompressed pixel data, so frame
+  // by frame transcoding is only possible with the raw encoder
+  if (frames && (djcp->cookedEncodingPreferred() ||
+      ((supportedTransferSyntax() != EXS_JPEGLSLossless) && !djrp->useLosslessProcess())))
+    return EC_IllegalCall;
+
   if (supportedTransferSyntax() == EXS_JPEGLSLossless || djrp->useLosslessProcess())
   {
     if (djcp->cookedEncodingPreferred())
       result = losslessCookedEncode(pixelData, length, dataset, djrp, pixSeq, djcp, compressionRatio, 0);
-      else result = losslessRawEncode(pixelData, length, dataset, djrp, pixSeq, djcp, compressionRatio);
+      else result = losslessRawEncode(pixelData, length, frames, dataset, djrp, pixSeq, djcp, compressionRatio);
   }
   else
   {
@@ -394,6 +592,7 @@ OFCondition DJLSEncoderBase::updateDerivationDescription(
 OFCondition DJLSEncoderBase::losslessRawEncode(
     const Uint16 *pixelData,
     const Uint32 length,
+    DcmFrameSource *frames,
     DcmItem *dataset,
     const DJLSRepresentationParameter *djrp,
     DcmPixelSequence * & pixSeq,
@@ -450,7 +649,9 @@ OFCondition DJLSEncoderBase::losslessRawEncode(
           photometricInterpretation == "YBR_FULL")
       {
         // A bitsAllocated value that we don't handle, but a color model that indicates
-        // that the cooked encoder could handle this case. Fall back to cooked encoder.
+        // that the cooked encoder could handle this case. Fall back to cooked encoder,
+        // which needs the complete uncompressed pixel data.
+        if (frames) return EC_IllegalCall;
         return losslessCookedEncode(pixelData, length, dataset, djrp, pixSeq, djcp, compressionRatio, 0);
       }
 
@@ -462,7 +663,12 @@ OFCondition DJLSEncoderBase::losslessRawEncode(
     if ((columns < 1)||(rows < 1)||(samplesPerPixel < 1)) result = EC_JLSUnsupportedImageType;
 
     // make sure that we have at least as many bytes of pixel data as we expect
-    if (bytesAllocated * samplesPerPixel * columns * rows *
+    if (frames)
+    {
+      if (bytesAllocated * samplesPerPixel * columns * rows > frames->getFrameSize())
+        result = EC_JLSUncompressedBufferTooSmall;
+    }
+    else if (bytesAllocated * samplesPerPixel * columns * rows *
       OFstatic_cast(unsigned long,numberOfFrames) > length)
       result = EC_JLSUncompressedBufferTooSmall;
   }
@@ -485,16 +691,16 @@ OFCondition DJLSEncoderBase::losslessRawEncode(
   }
 
   DcmOffsetList offsetList;
-  unsigned long compressedSize = 0;
-  unsigned long compressedFrameSize = 0;
+  size_t compressedSize = 0;
   double uncompressedSize = 0.0;
 
   // render and compress each frame
   if (result.good())
   {
 
-    // byte swap pixel data to little endian if bits allocate is 8
-    if ((gLocalByteOrder == EBO_BigEndian) && (bitsAllocated == 8))
+    // byte swap pixel data to little endian if bits allocate is 8. Frames
+    // provided by a frame source are swapped after decompression.
+    if (pixelData && (gLocalByteOrder == EBO_BigEndian) && (bitsAllocated == 8))
     {
        swapIfNecessary(EBO_LittleEndian, gLocalByteOrder, OFstatic_cast(void *, OFconst_cast(Uint16 *, pixelData)), length, sizeof(Uint16));
        byteSwapped = OFTrue;
@@ -507,17 +713,10 @@ OFCondition DJLSEncoderBase::losslessRawEncode(
     // compute original image size in bytes, ignoring any padding bits.
     uncompressedSize = columns * rows * samplesPerPixel * bitsStored * frameCount / 8.0;
 
-    for (unsigned long i=0; (i<frameCount) && (result.good()); ++i)
-    {
-      // compress frame
-      DCMJPLS_DEBUG("JPEG-LS encoder processes frame " << (i+1) << " of " << frameCount);
-      result = compressRawFrame(framePointer, bitsAllocated, columns, rows,
-          samplesPerPixel, planarConfiguration, photometricInterpretation,
-          pixelSequence, offsetList, compressedFrameSize, djcp);
-
-      compressedSize += compressedFrameSize;
-      framePointer += frameSize;
-    }
+    // compress all frames, possibly in parallel
+    FrameCompressor compressor(*this, framePointer, frames, frameSize, bitsAllocated, columns, rows,
+      samplesPerPixel, planarConfiguration, photometricInterpretation, djcp);
+    result = compressor.compress(pixelSequence, offsetList, OFstatic_cast(Uint32, frameCount), djcp->getFragmentSize(), compressedSize);
   }
 
   // store pixel sequence if everything went well.
@@ -553,15 +752,13 @@ OFCondition DJLSEncoderBase::compressRawFrame(
   Uint16 samplesPerPixel,
   Uint16 planarConfiguration,
   const OFString& /* photometricInterpretation */,
-  DcmPixelSequence *pixelSequence,
-  DcmOffsetList &offsetList,
-  unsigned long &compressedSize,
+  Uint8 *&compressedFrame,
+  Uint32 &compressedSize,
   const DJLSCodecParameter *djcp) const
 {
   OFCondition result = EC_Normal;
   Uint16 bytesAllocated = bitsAllocated / 8;
   Uint32 frameSize = width*height*bytesAllocated*samplesPerPixel;
-  Uint32 fragmentSize = djcp->getFragmentSize();
   OFBool opt_use_custom_options = djcp->getUseCustomOptions();
   JlsParameters jls_params;
   Uint8 *frameBuffer = NULL;
@@ -661,23 +858,29 @@ OFCondition DJLSEncoderBase::compressRawFrame(
     // way to find out, so we just allocate a buffer large enough for the raw data
     // plus a little more for JPEG metadata.
     // Yes, this is way too much for just a little JPEG metadata, but some
-    // test-images showed that the buffer previously was too small. Plus, at some
-    // places charls fails to do proper bounds checking and writes behind the end
-    // of the buffer (sometimes way behind its end...).
-    size_t size = frameSize + 1024;
-    Uint8 *buffer = new Uint8[size];
-
-    JLS_ERROR err = JpegLsEncode(buffer, size, &size, framePointer, frameSize, &jls_params);
+    // test-images showed that the buffer previously was too small. Images that
+    // hardly compress (e.g. noise) may even need more, so the buffer is enlarged
+    // as long as CharLS reports that it is too small.
+    size_t bufferSize = frameSize + 1024;
+    size_t size = 0;
+    Uint8 *buffer = NULL;
+    JLS_ERROR err;
+    do
+    {
+      delete[] buffer;
+      buffer = new Uint8[bufferSize];
+      err = JpegLsEncode(buffer, bufferSize, &size, framePointer, frameSize, &jls_params);
+      bufferSize *= 2;
+    } while ((err == CompressedBufferTooSmall) && (bufferSize <= 8 * OFstatic_cast(size_t, frameSize) + 2048));
     result = DJLSError::convert(err);
 
     if (result.good())
     {
       // 'size' now contains the size of the compressed data in buffer
-      compressedSize = size;
-      result = pixelSequence->storeCompressedFrame(offsetList, buffer, size, fragmentSize);
+      compressedFrame = buffer;
+      compressedSize = OFstatic_cast(Uint32, size);
     }
-
-    delete[] buffer;
+    else delete[] buffer;
   }
 
   if (frameBuffer)
@@ -714,7 +917,7 @@ OFCondition DJLSEncoderBase::losslessCookedEncode(
   {
     // a photometric interpretation that we don't handle. Fall back to raw encoder (unless in near-lossless mode)
      if (nearLosslessDeviation > 0) return EC_JLSUnsupportedPhotometricInterpretation;
-     else return losslessRawEncode(pixelData, length, dataset, djrp, pixSeq, djcp, compressionRatio);
+     else return losslessRawEncode(pixelData, length, NULL, dataset, djrp, pixSeq, djcp, compressionRatio);
   }
 
   Uint16 pixelRepresentation = 0;
@@ -731,7 +934,7 @@ OFCondition DJLSEncoderBase::losslessCookedEncode(
     {
         // prevent a loop - only call lossless raw encoder if bitsAllocated is OK for the raw encoder
         if ((bitsAllocated == 8) || (bitsAllocated == 16))
-          return losslessRawEncode(pixelData, length, dataset, djrp, pixSeq, djcp, compressionRatio);
+          return losslessRawEncode(pixelData, length, NULL, dataset, djrp, pixSeq, djcp, compressionRatio);
         else return EC_JLSUnsupportedPixelRepresentation;
     }
   }
@@ -778,8 +981,7 @@ OFCondition DJLSEncoderBase::losslessCookedEncode(
   }
 
   DcmOffsetList offsetList;
-  unsigned long compressedSize = 0;
-  unsigned long compressedFrameSize = 0;
+  size_t compressedSize = 0;
   double uncompressedSize = 0.0;
 
   // render and compress each frame
@@ -793,15 +995,10 @@ OFCondition DJLSEncoderBase::losslessCookedEncode(
     uncompressedSize = dimage->getWidth() * dimage->getHeight() *
       bitsPerSample * frameCount * samplesPerPixel / 8.0;
 
-    for (unsigned long i=0; (i<frameCount) && (result.good()); ++i)
-    {
-      // compress frame
-      DCMJPLS_DEBUG("JPEG-LS encoder processes frame " << (i+1) << " of " << frameCount);
-      result = compressCookedFrame(pixelSequence, dimage,
-          photometricInterpretation, offsetList, compressedFrameSize, djcp, i, nearLosslessDeviation);
-
-      compressedSize += compressedFrameSize;
-    }
+    // compress all frames, possibly in parallel. The intermediate
+    // representation of all frames has already been created by DicomImage.
+    FrameCompressor compressor(*this, dimage, photometricInterpretation, djcp, nearLosslessDeviation);
+    result = compressor.compress(pixelSequence, offsetList, OFstatic_cast(Uint32, frameCount), djcp->getFragmentSize(), compressedSize);
   }
 
   // store pixel sequence if everything went well.
@@ -837,11 +1034,10 @@ OFCondition DJLSEncoderBase::losslessCookedEncode(
 
 
 OFCondition DJLSEncoderBase::compressCookedFrame(
-  DcmPixelSequence *pixelSequence,
   DicomImage *dimage,
   const OFString& /* photometricInterpretation */,
-  DcmOffsetList &offsetList,
-  unsigned long &compressedSize,
+  Uint8 *&compressedFrame,
+  Uint32 &compressedSize,
   const DJLSCodecParameter *djcp,
   Uint32 frame,
   Uint16 nearLosslessDeviation) const
@@ -854,7 +1050,6 @@ OFCondition DJLSEncoderBase::compressCookedFrame(
   int depth = dimage->getDepth();
   if ((depth < 1) || (depth > 16)) return EC_JLSUnsupportedBitDepth;
 
-  Uint32 fragmentSize = djcp->getFragmentSize();
   OFBool opt_use_custom_options = djcp->getUseCustomOptions();
 
   const DiPixel *dinter = dimage->getInterData();
@@ -1057,25 +1252,32 @@ OFCondition DJLSEncoderBase::compressCookedFrame(
   // way to find out, so we just allocate a buffer large enough for the raw data
   // plus a little more for JPEG metadata.
   // Yes, this is way too much for just a little JPEG metadata, but some
-  // test-images showed that the buffer previously was too small. Plus, at some
-  // places charls fails to do proper bounds checking and writes behind the end
-  // of the buffer (sometimes way behind its end...).
-  size_t compressed_buffer_size = buffer_size + 1024;
-  Uint8 *compressed_buffer = new Uint8[compressed_buffer_size];
-
-  JLS_ERROR err = JpegLsEncode(compressed_buffer, compressed_buffer_size,
-      &compressed_buffer_size, framePointer, buffer_size, &jls_params);
+  // test-images showed that the buffer previously was too small. Images that
+  // hardly compress (e.g. noise) may even need more, so the buffer is enlarged
+  // as long as CharLS reports that it is too small.
+  size_t allocated_size = buffer_size + 1024;
+  size_t compressed_buffer_size = 0;
+  Uint8 *compressed_buffer = NULL;
+  JLS_ERROR err;
+  do
+  {
+    delete[] compressed_buffer;
+    compressed_buffer = new Uint8[allocated_size];
+    err = JpegLsEncode(compressed_buffer, allocated_size,
+        &compressed_buffer_size, framePointer, buffer_size, &jls_params);
+    allocated_size *= 2;
+  } while ((err == CompressedBufferTooSmall) && (allocated_size <= 8 * OFstatic_cast(size_t, buffer_size) + 2048));
   result = DJLSError::convert(err);
 
   if (result.good())
   {
     // 'compressed_buffer_size' now contains the size of the compressed data in buffer
-    compressedSize = compressed_buffer_size;
-    result = pixelSequence->storeCompressedFrame(offsetList, compressed_buffer, compressed_buffer_size, fragmentSize);
+    compressedFrame = compressed_buffer;
+    compressedSize = OFstatic_cast(Uint32, compressed_buffer_size);
   }
+  else delete[] compressed_buffer;
 
   delete[] buffer;
-  delete[] compressed_buffer;
   if (frameBuffer)
     delete[] frameBuffer;
 
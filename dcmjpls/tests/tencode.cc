@@ -0,0 +1,189 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmjpls
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test the JPEG-LS encoder with images that hardly compress
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmjpls/djencode.h"
+#include "dcmtk/dcmjpls/djdecode.h"
+#include "dcmtk/dcmjpls/djrparam.h"
+#include "dcmtk/dcmimage/diregist.h"  /* include to support color images */
+
+// charls includes
+#include "intrface.h"
+
+
+/* size of the test images */
+#define IMAGE_COLUMNS 211
+#define IMAGE_ROWS 157
+
+
+/* create an image with random noise, which is slightly larger after JPEG-LS compression */
+static void createNoiseImage(DcmDataset &dset,
+                             const Uint16 samplesPerPixel,
+                             const Uint16 bitsStored)
+{
+    const unsigned long count = OFstatic_cast(unsigned long, IMAGE_COLUMNS) * IMAGE_ROWS * samplesPerPixel;
+    dset.putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage);
+    dset.putAndInsertString(DCM_SOPInstanceUID, "1.2.276.0.7230010.3.1.4.0.3");
+    dset.putAndInsertString(DCM_PhotometricInterpretation, (samplesPerPixel == 3) ? "RGB" : "MONOCHROME2");
+    dset.putAndInsertUint16(DCM_SamplesPerPixel, samplesPerPixel);
+    if (samplesPerPixel == 3)
+        dset.putAndInsertUint16(DCM_PlanarConfiguration, 0);
+    dset.putAndInsertUint16(DCM_Rows, IMAGE_ROWS);
+    dset.putAndInsertUint16(DCM_Columns, IMAGE_COLUMNS);
+    dset.putAndInsertUint16(DCM_BitsAllocated, (bitsStored > 8) ? 16 : 8);
+    dset.putAndInsertUint16(DCM_BitsStored, bitsStored);
+    dset.putAndInsertUint16(DCM_HighBit, bitsStored - 1);
+    dset.putAndInsertUint16(DCM_PixelRepresentation, 0);
+    Uint32 seed = 4711;
+    Uint16 *values = new Uint16[count];
+    for (unsigned long i = 0; i < count; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        values[i] = OFstatic_cast(Uint16, (seed >> 8) & ((1UL << bitsStored) - 1));
+    }
+    if (bitsStored > 8)
+        dset.putAndInsertUint16Array(DCM_PixelData, values, count);
+    else {
+        Uint8 *bytes = new Uint8[count];
+        for (unsigned long i = 0; i < count; ++i)
+            bytes[i] = OFstatic_cast(Uint8, values[i]);
+        dset.putAndInsertUint8Array(DCM_PixelData, bytes, count);
+        delete[] bytes;
+    }
+    delete[] values;
+}
+
+
+/* get the uncompressed pixel data */
+static OFBool getPixelData(DcmDataset &dset,
+                           OFString &data)
+{
+    DcmElement *elem = NULL;
+    Uint8 *bytes = NULL;
+    data.clear();
+    if (dset.findAndGetElement(DCM_PixelData, elem).bad() || elem->getUint8Array(bytes).bad() || (bytes == NULL))
+        return OFFalse;
+    data.assign(OFreinterpret_cast(const char *, bytes), elem->getLength());
+    return OFTrue;
+}
+
+
+/* compress a noise image lossless and check that the decompressed image is identical */
+static void checkNoiseImage(const Uint16 samplesPerPixel,
+                            const Uint16 bitsStored,
+                            const OFBool preferCookedEncoding)
+{
+    DJLSEncoderRegistration::cleanup();
+    DJLSEncoderRegistration::registerCodecs(OFFalse, 3, 7, 21, 64, 0, preferCookedEncoding, 0, OFTrue, EJLSUC_never);
+    DcmDataset dset;
+    createNoiseImage(dset, samplesPerPixel, bitsStored);
+    OFString original;
+    OFCHECK(getPixelData(dset, original));
+    const DJLSRepresentationParameter param(0, OFTrue);
+    DcmDataset encoded(dset);
+    OFCondition status = encoded.chooseRepresentation(EXS_JPEGLSLossless, &param);
+    if (status.bad())
+    {
+        OFCHECK_FAIL("cannot compress " << bitsStored << " bit noise image with " << samplesPerPixel
+            << " sample(s) per pixel: " << status.text());
+        return;
+    }
+    OFCHECK(encoded.canWriteXfer(EXS_JPEGLSLossless));
+    encoded.removeAllButCurrentRepresentations();
+    OFString decoded;
+    OFCHECK(encoded.chooseRepresentation(EXS_LittleEndianExplicit, NULL).good());
+    OFCHECK(getPixelData(encoded, decoded));
+    OFCHECK(decoded == original);
+}
+
+
+/* create the parameters for compressing a noise image directly with CharLS */
+static void initParameters(JlsParameters &params,
+                           const int components,
+                           const int bitsPerSample)
+{
+    memset(&params, 0, sizeof(params));
+    params.width = IMAGE_COLUMNS;
+    params.height = IMAGE_ROWS;
+    params.bitspersample = bitsPerSample;
+    params.components = components;
+    params.ilv = (components > 1) ? ILV_SAMPLE : ILV_NONE;
+}
+
+
+OFTEST(dcmjpls_encodeNoise)
+{
+    DJLSDecoderRegistration::registerCodecs(EJLSUC_never);
+    /* the compressed data used to be larger than the buffer allocated by the encoder */
+    for (int cooked = 0; cooked < 2; ++cooked)
+    {
+        checkNoiseImage(1, 8, cooked != 0);
+        checkNoiseImage(1, 12, cooked != 0);
+        checkNoiseImage(1, 16, cooked != 0);
+        checkNoiseImage(3, 8, cooked != 0);
+    }
+    DJLSEncoderRegistration::cleanup();
+    DJLSDecoderRegistration::cleanup();
+}
+
+
+OFTEST(dcmjpls_compressedBufferTooSmall)
+{
+    const size_t count = IMAGE_COLUMNS * IMAGE_ROWS * 3;
+    Uint8 *image = new Uint8[count];
+    Uint32 seed = 4711;
+    for (size_t i = 0; i < count; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        image[i] = OFstatic_cast(Uint8, seed >> 16);
+    }
+    for (int components = 1; components <= 3; components += 2)
+    {
+        const size_t imageSize = IMAGE_COLUMNS * IMAGE_ROWS * components;
+        /* the compressed data of noise is larger than the image */
+        const size_t bufferSize = 2 * imageSize + 1024;
+        Uint8 *expected = new Uint8[bufferSize];
+        Uint8 *buffer = new Uint8[bufferSize];
+        JlsParameters params;
+        size_t expectedSize = 0;
+        initParameters(params, components, 8);
+        OFCHECK_EQUAL(JpegLsEncode(expected, bufferSize, &expectedSize, image, imageSize, &params), OK);
+        OFCHECK(expectedSize > imageSize);
+        /* a buffer of exactly the required size is sufficient */
+        size_t size = 0;
+        initParameters(params, components, 8);
+        OFCHECK_EQUAL(JpegLsEncode(buffer, expectedSize, &size, image, imageSize, &params), OK);
+        OFCHECK_EQUAL(size, expectedSize);
+        OFCHECK(memcmp(buffer, expected, expectedSize) == 0);
+        /* smaller buffers are reported (also if only the last bytes of the scan or the header do not fit) */
+        static const size_t missing[] = { 1, 2, 3, 4, 5, 8, 100 };
+        for (size_t i = 0; i < sizeof(missing) / sizeof(missing[0]); ++i)
+        {
+            initParameters(params, components, 8);
+            OFCHECK_EQUAL(JpegLsEncode(buffer, expectedSize - missing[i], &size, image, imageSize, &params), CompressedBufferTooSmall);
+        }
+        initParameters(params, components, 8);
+        OFCHECK_EQUAL(JpegLsEncode(buffer, 10, &size, image, imageSize, &params), CompressedBufferTooSmall);
+        delete[] buffer;
+        delete[] expected;
+    }
+    delete[] image;
+}
@@ -0,0 +1,21 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmjpls
+ *
+ *  Author:  agent
+ *
+ *  Purpose: main test program
+ *
+ */
+
+#include "dcmtk/config/osconfig.h"
+
+#include "dcmtk/ofstd/oftest.h"
+
+OFTEST_REGISTER(dcmjpls_compressedBufferTooSmall);
+OFTEST_REGISTER(dcmjpls_encodeNoise);
+OFTEST_MAIN("dcmjpls")
@@ -219,8 +219,9 @@ int main(int argc, char *argv[])
         CONVERT_TO_STRING("set max receive pdu to n bytes (default: " << opt_maxReceivePDULength << ")", optString3);
         cmd.addOption("--max-pdu",             "-pdu", 1, optString2.c_str(),
                                                           optString3.c_str());
+        CONVERT_TO_STRING("restrict max send pdu to n bytes\n(default: " << ASC_DEFAULTMAXSENDPDU << ", larger values permit\nlarger pdus if accepted by the peer)", optString4);
         cmd.addOption("--max-send-pdu",                1, optString2.c_str(),
-                                                          "restrict max send pdu to n bytes");
+                                                          optString4.c_str());
     cmd.addGroup("output options:");
       cmd.addSubGroup("general:");
         cmd.addOption("--create-report-file",  "+crf", 1, "[f]ilename: string",
@@ -65,6 +65,7 @@ END_EXTERN_C
 #include "dcmtk/dcmdata/dcuid.h"        /* for dcmtk version name */
 #include "dcmtk/dcmdata/dcdeftag.h"
 #include "dcmtk/dcmdata/dcostrmz.h"     /* for dcmZlibCompressionLevel */
+#include "dcmtk/dcmdata/dcelscan.h"     /* for class DcmElementScanner */
 
 #ifdef WITH_OPENSSL
 #include "dcmtk/dcmtls/tlstrans.h"
@@ -408,7 +409,7 @@ int main(int argc, char *argv[])
       cmd.addOption("--compression-level",      "+cl",  1, "[l]evel: integer (default: 6)",
                                                            "0=uncompressed, 1=fastest, 9=best compression");
 #endif
-    cmd.addSubGroup("sorting into subdirectories (not with --bit-preserving):");
+    cmd.addSubGroup("sorting into subdirectories:");
       cmd.addOption("--sort-conc-studies",      "-ss",  1, "[p]refix: string",
                                                            "sort studies using prefix p and a timestamp");
       cmd.addOption("--sort-on-study-uid",      "-su",  1, "[p]refix: string",
@@ -820,19 +821,16 @@ int main(int argc, char *argv[])
     cmd.beginOptionBlock();
     if (cmd.findOption("--sort-conc-studies"))
     {
-      app.checkConflict("--sort-conc-studies", "--bit-preserving", opt_bitPreserving);
       app.checkValue(cmd.getValue(opt_sortStudyDirPrefix));
       opt_sortStudyMode = ESM_Timestamp;
     }
     if (cmd.findOption("--sort-on-study-uid"))
     {
-      app.checkConflict("--sort-on-study-uid", "--bit-preserving", opt_bitPreserving);
       app.checkValue(cmd.getValue(opt_sortStudyDirPrefix));
       opt_sortStudyMode = ESM_StudyInstanceUID;
     }
     if (cmd.findOption("--sort-on-patientname"))
     {
-      app.checkConflict("--sort-on-patientname", "--bit-preserving", opt_bitPreserving);
       opt_sortStudyDirPrefix = NULL;
       opt_sortStudyMode = ESM_PatientName;
     }
@@ -1838,9 +1836,142 @@ struct StoreCallbackData
   char* imageFileName;
   DcmFileFormat* dcmff;
   T_ASC_Association* assoc;
+  DcmElementScanner* scanner;
 };
 
 
+static OFBool
+sortIntoStudySubdirectory(
+    const OFString& currentStudyInstanceUID,
+    const OFString& tmpPatientName,
+    const char *imageFileName,
+    OFString& fileName)
+    /*
+     * This function determines the subdirectory for the study of a DICOM object that has just been
+     * received, according to the --sort-xxx option, and creates it if necessary.
+     *
+     * Parameters:
+     *   currentStudyInstanceUID - [in] The Study Instance UID of the object, must not be empty.
+     *   tmpPatientName          - [in] The Patient's Name of the object, only used with --sort-on-patientname.
+     *   imageFileName           - [in] The path to and name of the file in the output directory.
+     *   fileName                - [out] The path to and name of the file in the subdirectory.
+     */
+{
+  OFString tmpStr;
+
+  // if --sort-on-patientname is active, we need to extract the
+  // patient's name (format: last_name^first_name)
+  OFString currentPatientName;
+  if (opt_sortStudyMode == ESM_PatientName)
+  {
+    OFString tmpName = tmpPatientName;
+    if (tmpName.empty())
+    {
+      // default if patient name is missing or empty
+      tmpName = "ANONYMOUS";
+      OFLOG_WARN(storescpLogger, "element PatientName " << DCM_PatientName << " absent or empty in data set, using '"
+           << tmpName << "' instead");
+    }
+
+    /* substitute non-ASCII characters in patient name to ASCII "equivalent" */
+    const size_t length = tmpName.length();
+    for (size_t i = 0; i < length; i++)
+      mapCharacterAndAppendToString(tmpName[i], currentPatientName);
+  }
+
+  // if this is the first DICOM object that was received or if the study instance UID in the
+  // current DICOM object does not equal the last object's study instance UID we need to create
+  // a new subdirectory in which the current DICOM object will be stored
+  if (lastStudyInstanceUID.empty() || (lastStudyInstanceUID != currentStudyInstanceUID))
+  {
+    // if lastStudyInstanceUID is non-empty, we have just completed receiving all objects for one
+    // study. In such a case, we need to set a certain indicator variable (lastStudySubdirectoryPathAndName),
+    // so that we know that executeOnEndOfStudy() might have to be executed later. In detail, this indicator
+    // variable will contain the path and name of the last study's subdirectory, so that we can still remember
+    // this directory, when we execute executeOnEndOfStudy(). The memory that is allocated for this variable
+    // here will be freed after the execution of executeOnEndOfStudy().
+    if (!lastStudyInstanceUID.empty())
+      lastStudySubdirectoryPathAndName = subdirectoryPathAndName;
+
+    // create the new lastStudyInstanceUID value according to the value in the current DICOM object
+    lastStudyInstanceUID = currentStudyInstanceUID;
+
+    // get the current time (needed for subdirectory name)
+    OFDateTime dateTime;
+    dateTime.setCurrentDateTime();
+
+    // create a name for the new subdirectory.
+    char timestamp[32];
+    sprintf(timestamp, "%04u%02u%02u_%02u%02u%02u%03u",
+      dateTime.getDate().getYear(), dateTime.getDate().getMonth(), dateTime.getDate().getDay(),
+      dateTime.getTime().getHour(), dateTime.getTime().getMinute(), dateTime.getTime().getIntSecond(), dateTime.getTime().getMilliSecond());
+
+    OFString subdirectoryName;
+    switch (opt_sortStudyMode)
+    {
+      case ESM_Timestamp:
+        // pattern: "[prefix]_[YYYYMMDD]_[HHMMSSMMM]"
+        subdirectoryName = opt_sortStudyDirPrefix;
+        if (!subdirectoryName.empty())
+          subdirectoryName += '_';
+        subdirectoryName += timestamp;
+        break;
+      case ESM_StudyInstanceUID:
+        // pattern: "[prefix]_[Study Instance UID]"
+        subdirectoryName = opt_sortStudyDirPrefix;
+        if (!subdirectoryName.empty())
+          subdirectoryName += '_';
+        subdirectoryName += currentStudyInstanceUID;
+        break;
+      case ESM_PatientName:
+        // pattern: "[Patient's Name]_[YYYYMMDD]_[HHMMSSMMM]"
+        subdirectoryName = currentPatientName;
+        subdirectoryName += '_';
+        subdirectoryName += timestamp;
+        break;
+      case ESM_None:
+        break;
+    }
+
+    // create subdirectoryPathAndName (string with full path to new subdirectory)
+    OFStandard::combineDirAndFilename(subdirectoryPathAndName, OFStandard::getDirNameFromPath(tmpStr, imageFileName), subdirectoryName);
+
+    // check if the subdirectory already exists
+    // if it already exists dump a warning
+    if( OFStandard::dirExists(subdirectoryPathAndName) )
+      OFLOG_WARN(storescpLogger, "subdirectory for study already exists: " << subdirectoryPathAndName);
+    else
+    {
+      // if it does not exist create it
+      OFLOG_INFO(storescpLogger, "creating new subdirectory for study: " << subdirectoryPathAndName);
+#ifdef HAVE_WINDOWS_H
+      if( _mkdir( subdirectoryPathAndName.c_str() ) == -1 )
+#else
+      if( mkdir( subdirectoryPathAndName.c_str(), S_IRWXU | S_IRWXG | S_IRWXO ) == -1 )
+#endif
+      {
+        OFLOG_ERROR(storescpLogger, "could not create subdirectory for study: " << subdirectoryPathAndName);
+        return OFFalse;
+      }
+      // all objects of a study have been received, so a new subdirectory is started.
+      // ->timename counter can be reset, because the next filename can't cause a duplicate.
+      // if no reset would be done, files of a new study (->new directory) would start with a counter in filename
+      if (opt_timeNames)
+        timeNameCounter = -1;
+    }
+  }
+
+  // integrate subdirectory name into file name (note that imageFileName currently contains both
+  // path and file name; however, the path refers to the output directory captured in opt_outputDirectory)
+  OFStandard::combineDirAndFilename(fileName, subdirectoryPathAndName, OFStandard::getFilenameFromPath(tmpStr, imageFileName));
+
+  // update global variable outputFileNameArray
+  // (might be used in executeOnReception() and renameOnEndOfStudy)
+  outputFileNameArray.push_back(tmpStr);
+  return OFTrue;
+}
+
+
 static void
 storeSCPCallback(
     void *callbackData,
@@ -1947,116 +2078,17 @@ storeSCPCallback(
           return;
         }
 
-        // if --sort-on-patientname is active, we need to extract the
-        // patient's name (format: last_name^first_name)
-        OFString currentPatientName;
+        // if --sort-on-patientname is active, we also need the patient's name
+        OFString tmpName;
         if (opt_sortStudyMode == ESM_PatientName)
-        {
-          OFString tmpName;
-          if ((*imageDataSet)->findAndGetOFString(DCM_PatientName, tmpName).bad() || tmpName.empty())
-          {
-            // default if patient name is missing or empty
-            tmpName = "ANONYMOUS";
-            OFLOG_WARN(storescpLogger, "element PatientName " << DCM_PatientName << " absent or empty in data set, using '"
-                 << tmpName << "' instead");
-          }
-
-          /* substitute non-ASCII characters in patient name to ASCII "equivalent" */
-          const size_t length = tmpName.length();
-          for (size_t i = 0; i < length; i++)
-            mapCharacterAndAppendToString(tmpName[i], currentPatientName);
-        }
+          (*imageDataSet)->findAndGetOFString(DCM_PatientName, tmpName);
 
-        // if this is the first DICOM object that was received or if the study instance UID in the
-        // current DICOM object does not equal the last object's study instance UID we need to create
-        // a new subdirectory in which the current DICOM object will be stored
-        if (lastStudyInstanceUID.empty() || (lastStudyInstanceUID != currentStudyInstanceUID))
+        // determine the subdirectory and the file name within
+        if (!sortIntoStudySubdirectory(currentStudyInstanceUID, tmpName, cbdata->imageFileName, fileName))
         {
-          // if lastStudyInstanceUID is non-empty, we have just completed receiving all objects for one
-          // study. In such a case, we need to set a certain indicator variable (lastStudySubdirectoryPathAndName),
-          // so that we know that executeOnEndOfStudy() might have to be executed later. In detail, this indicator
-          // variable will contain the path and name of the last study's subdirectory, so that we can still remember
-          // this directory, when we execute executeOnEndOfStudy(). The memory that is allocated for this variable
-          // here will be freed after the execution of executeOnEndOfStudy().
-          if (!lastStudyInstanceUID.empty())
-            lastStudySubdirectoryPathAndName = subdirectoryPathAndName;
-
-          // create the new lastStudyInstanceUID value according to the value in the current DICOM object
-          lastStudyInstanceUID = currentStudyInstanceUID;
-
-          // get the current time (needed for subdirectory name)
-          OFDateTime dateTime;
-          dateTime.setCurrentDateTime();
-
-          // create a name for the new subdirectory.
-          char timestamp[32];
-          sprintf(timestamp, "%04u%02u%02u_%02u%02u%02u%03u",
-            dateTime.getDate().getYear(), dateTime.getDate().getMonth(), dateTime.getDate().getDay(),
-            dateTime.getTime().getHour(), dateTime.getTime().getMinute(), dateTime.getTime().getIntSecond(), dateTime.getTime().getMilliSecond());
-
-          OFString subdirectoryName;
-          switch (opt_sortStudyMode)
-          {
-            case ESM_Timestamp:
-              // pattern: "[prefix]_[YYYYMMDD]_[HHMMSSMMM]"
-              subdirectoryName = opt_sortStudyDirPrefix;
-              if (!subdirectoryName.empty())
-                subdirectoryName += '_';
-              subdirectoryName += timestamp;
-              break;
-            case ESM_StudyInstanceUID:
-              // pattern: "[prefix]_[Study Instance UID]"
-              subdirectoryName = opt_sortStudyDirPrefix;
-              if (!subdirectoryName.empty())
-                subdirectoryName += '_';
-              subdirectoryName += currentStudyInstanceUID;
-              break;
-            case ESM_PatientName:
-              // pattern: "[Patient's Name]_[YYYYMMDD]_[HHMMSSMMM]"
-              subdirectoryName = currentPatientName;
-              subdirectoryName += '_';
-              subdirectoryName += timestamp;
-              break;
-            case ESM_None:
-              break;
-          }
-
-          // create subdirectoryPathAndName (string with full path to new subdirectory)
-          OFStandard::combineDirAndFilename(subdirectoryPathAndName, OFStandard::getDirNameFromPath(tmpStr, cbdata->imageFileName), subdirectoryName);
-
-          // check if the subdirectory already exists
-          // if it already exists dump a warning
-          if( OFStandard::dirExists(subdirectoryPathAndName) )
-            OFLOG_WARN(storescpLogger, "subdirectory for study already exists: " << subdirectoryPathAndName);
-          else
-          {
-            // if it does not exist create it
-            OFLOG_INFO(storescpLogger, "creating new subdirectory for study: " << subdirectoryPathAndName);
-#ifdef HAVE_WINDOWS_H
-            if( _mkdir( subdirectoryPathAndName.c_str() ) == -1 )
-#else
-            if( mkdir( subdirectoryPathAndName.c_str(), S_IRWXU | S_IRWXG | S_IRWXO ) == -1 )
-#endif
-            {
-              OFLOG_ERROR(storescpLogger, "could not create subdirectory for study: " << subdirectoryPathAndName);
-              rsp->DimseStatus = STATUS_STORE_Error_CannotUnderstand;
-              return;
-            }
-            // all objects of a study have been received, so a new subdirectory is started.
-            // ->timename counter can be reset, because the next filename can't cause a duplicate.
-            // if no reset would be done, files of a new study (->new directory) would start with a counter in filename
-            if (opt_timeNames)
-              timeNameCounter = -1;
-          }
+          rsp->DimseStatus = STATUS_STORE_Error_CannotUnderstand;
+          return;
         }
-
-        // integrate subdirectory name into file name (note that cbdata->imageFileName currently contains both
-        // path and file name; however, the path refers to the output directory captured in opt_outputDirectory)
-        OFStandard::combineDirAndFilename(fileName, subdirectoryPathAndName, OFStandard::getFilenameFromPath(tmpStr, cbdata->imageFileName));
-
-        // update global variable outputFileNameArray
-        // (might be used in executeOnReception() and renameOnEndOfStudy)
-        outputFileNameArray.push_back(tmpStr);
       }
       // if no --sort-xxx option is set, the determination of the output file name is simple
       else
@@ -2109,7 +2141,72 @@ storeSCPCallback(
     }
 
     // in case opt_bitPreserving is set, do some other things
-    if( opt_bitPreserving )
+    if( opt_bitPreserving && !opt_ignore && (rsp->DimseStatus == STATUS_Success) && cbdata->scanner )
+    {
+      // the data set has been written to the file without being parsed. The values needed
+      // for checking and sorting have been extracted by the scanner while receiving.
+      DcmElementScanner *scanner = cbdata->scanner;
+      OFString sopClassUID;
+      OFString sopInstanceUID;
+      if (scanner->status().bad())
+      {
+        OFLOG_WARN(storescpLogger, "cannot scan received data set: " << scanner->status().text());
+      }
+      else if (scanner->getValue(DCM_SOPClassUID, sopClassUID).bad() || scanner->getValue(DCM_SOPInstanceUID, sopInstanceUID).bad())
+      {
+        OFLOG_ERROR(storescpLogger, "bad DICOM file: " << cbdata->imageFileName);
+        rsp->DimseStatus = STATUS_STORE_Error_CannotUnderstand;
+      }
+      else if ((sopClassUID != req->AffectedSOPClassUID) || (sopInstanceUID != req->AffectedSOPInstanceUID))
+      {
+        rsp->DimseStatus = STATUS_STORE_Error_DataSetDoesNotMatchSOPClass;
+      }
+
+      // in case one of the --sort-xxx options is set, move the file into the subdirectory of the study
+      if (opt_sortStudyMode != ESM_None)
+      {
+        OFString currentStudyInstanceUID;
+        OFString tmpName;
+        OFString fileName;
+        scanner->getValue(DCM_StudyInstanceUID, currentStudyInstanceUID);
+        if (currentStudyInstanceUID.empty())
+        {
+          OFLOG_ERROR(storescpLogger, "element StudyInstanceUID " << DCM_StudyInstanceUID << " absent or empty in data set");
+          rsp->DimseStatus = STATUS_STORE_Error_CannotUnderstand;
+          return;
+        }
+        if (opt_sortStudyMode == ESM_PatientName)
+          scanner->getValue(DCM_PatientName, tmpName);
+        if (!sortIntoStudySubdirectory(currentStudyInstanceUID, tmpName, cbdata->imageFileName, fileName))
+        {
+          rsp->DimseStatus = STATUS_STORE_Error_CannotUnderstand;
+          return;
+        }
+        OFLOG_INFO(storescpLogger, "storing DICOM file: " << fileName);
+        if (OFStandard::fileExists(fileName))
+        {
+          OFLOG_WARN(storescpLogger, "DICOM file already exists, overwriting: " << fileName);
+          OFStandard::deleteFile(fileName);
+        }
+        if (!OFStandard::renameFile(cbdata->imageFileName, fileName))
+        {
+          OFLOG_ERROR(storescpLogger, "cannot write DICOM file: " << fileName);
+          rsp->DimseStatus = STATUS_STORE_Refused_OutOfResources;
+        }
+        else
+        {
+          // the file name is also used for deleting the file in case of an error
+          OFStandard::strlcpy(cbdata->imageFileName, fileName.c_str(), 2048);
+        }
+      }
+      else
+      {
+        // we need to set outputFileNameArray and outputFileNameArrayCnt to be
+        // able to perform the placeholder substitution in executeOnReception()
+        outputFileNameArray.push_back(OFStandard::getFilenameFromPath(tmpStr, cbdata->imageFileName));
+      }
+    }
+    else if( opt_bitPreserving )
     {
       // we need to set outputFileNameArray and outputFileNameArrayCnt to be
       // able to perform the placeholder substitution in executeOnReception()
@@ -2236,6 +2333,15 @@ static OFCondition storeSCP(
   DcmFileFormat dcmff;
   callbackData.dcmff = &dcmff;
 
+  // in bit preserving mode, the few values needed for checking and sorting
+  // are extracted while the data set is written to the file
+  DcmElementScanner scanner;
+  scanner.addTag(DCM_SOPClassUID);
+  scanner.addTag(DCM_SOPInstanceUID);
+  scanner.addTag(DCM_StudyInstanceUID);
+  if (opt_sortStudyMode == ESM_PatientName) scanner.addTag(DCM_PatientName);
+  callbackData.scanner = &scanner;
+
   // store SourceApplicationEntityTitle in metaheader
   if (assoc && assoc->params)
   {
@@ -2252,7 +2358,7 @@ static OFCondition storeSCP(
   if (opt_bitPreserving)
   {
     cond = DIMSE_storeProvider(assoc, presID, req, imageFileName, opt_useMetaheader, NULL,
-      storeSCPCallback, &callbackData, opt_blockMode, opt_dimse_timeout);
+      storeSCPCallback, &callbackData, opt_blockMode, opt_dimse_timeout, &scanner);
   }
   else
   {
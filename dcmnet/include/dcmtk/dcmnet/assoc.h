@@ -104,12 +104,17 @@
 
 /*
  * There have been reports that smaller PDUs work better in some environments.
- * Allow a 4K minimum and a 128K maximum. Any further extension requires
- * modifications in the DUL code.
+ * Allow a 4K minimum and a 4M maximum (see also MAX_PDU_LENGTH in the DUL
+ * code). Large PDUs reduce the per-PDU overhead on fast networks, but note
+ * that the receive buffer of an association and the send buffer are allocated
+ * with the full size. Therefore, PDUs larger than 128K are only sent if
+ * enabled explicitly through dcmMaxOutgoingPDUSize (see dimse.h), even if
+ * the peer accepts them.
  */
 #define ASC_DEFAULTMAXPDU       16384 /* 16K is default if nothing else specified */
 #define ASC_MINIMUMPDUSIZE       4096
-#define ASC_MAXIMUMPDUSIZE     131072 /* 128K - we only handle this big */
+#define ASC_MAXIMUMPDUSIZE    4194304 /* 4M - we only handle this big */
+#define ASC_DEFAULTMAXSENDPDU  131072 /* 128K - sent unless enabled otherwise */
 
 /*
 ** Type Definitions
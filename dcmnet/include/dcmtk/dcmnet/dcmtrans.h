@@ -88,6 +88,19 @@ public:
    */
   virtual ssize_t write(void *buf, size_t nbyte) = 0;
 
+  /** attempts to write two buffers, e.g. the header and the value of a PDU,
+   *  to the transport connection as if write() was called for each of them.
+   *  Unlike write(), this method only returns after all data has been written
+   *  or an error has occurred. The default implementation calls write()
+   *  until done, derived classes may use a single gathering write instead.
+   *  @param buf1 first buffer
+   *  @param nbyte1 number of bytes to write from the first buffer
+   *  @param buf2 second buffer
+   *  @param nbyte2 number of bytes to write from the second buffer
+   *  @return number of bytes written, negative number if unsuccessful.
+   */
+  virtual ssize_t writeBuffers(void *buf1, size_t nbyte1, void *buf2, size_t nbyte2);
+
   /** Closes the transport connection. If a secure connection
    *  is used, a closure alert is sent before the connection
    *  is closed. Abstract method.
@@ -157,13 +170,14 @@ public:
    */
   static OFBool selectReadableAssociation(DcmTransportConnection *connections[], int connCount, int timeout);
 
-protected:
-
-  /** returns the socket file descriptor managed by this object.
+  /** returns the socket file descriptor managed by this object, e.g.\ for
+   *  registering the connection with an event notification mechanism.
    *  @return socket file descriptor
    */
   int getSocket() { return theSocket; }
 
+protected:
+
   /** set the socket file descriptor managed by this object.
    *  @param socket file descriptor
    */
@@ -273,6 +287,18 @@ public:
    */
   virtual ssize_t write(void *buf, size_t nbyte);
 
+  /** attempts to write two buffers, e.g. the header and the value of a PDU,
+   *  to the transport connection with a single gathering write where
+   *  available. Only returns after all data has been written or an error
+   *  has occurred.
+   *  @param buf1 first buffer
+   *  @param nbyte1 number of bytes to write from the first buffer
+   *  @param buf2 second buffer
+   *  @param nbyte2 number of bytes to write from the second buffer
+   *  @return number of bytes written, negative number if unsuccessful.
+   */
+  virtual ssize_t writeBuffers(void *buf1, size_t nbyte1, void *buf2, size_t nbyte2);
+
   /** Closes the transport connection. If a secure connection
    *  is used, a closure alert is sent before the connection
    *  is closed.
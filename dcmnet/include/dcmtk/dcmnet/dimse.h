@@ -94,6 +94,7 @@
 #include "dcmtk/ofstd/ofglobal.h"
 
 class DcmOutputFileStream;
+class DcmElementScanner;
 
 /** Global flag to enable/disable workaround code for some buggy Store SCUs
  * in DIMSE_storeProvider().  If enabled, an illegal space-padding in the
@@ -109,10 +110,22 @@ extern DCMTK_DCMNET_EXPORT OFGlobal<OFBool> dcmPeerRequiresExactUIDCopy; /* defa
  *  P-DATA PDUs to a value less than the maximum supported by the
  *  remote application entity or this library.  May be useful
  *  if there is an interaction between PDU size and other network
- *  layers, e. g. TLS, IP or below.
+ *  layers, e. g. TLS, IP or below.  Unless this flag is set to a
+ *  value larger than ASC_DEFAULTMAXSENDPDU (128K), outgoing PDUs are
+ *  also limited to ASC_DEFAULTMAXSENDPDU, i.e. larger PDUs (up to
+ *  ASC_MAXIMUMPDUSIZE) are only sent if enabled explicitly.  Must be
+ *  set before the association is negotiated.
  */
 extern DCMTK_DCMNET_EXPORT OFGlobal<Uint32> dcmMaxOutgoingPDUSize; /* default 2^32-1 */
 
+/** global flag defining the size of the buffer (in bytes) in which
+ *  DIMSE_receiveDataSetInFile() collects the received PDVs before writing
+ *  them to the file. A larger buffer results in fewer but larger write
+ *  operations. A value of 0 disables buffering, i.e. each PDV is written
+ *  separately.
+ */
+extern DCMTK_DCMNET_EXPORT OFGlobal<Uint32> dcmReceiveFileBufferSize; /* default 256 kB */
+
 
 /*
  * General Status Codes
@@ -738,7 +751,9 @@ DIMSE_storeProvider(/* in */
     DcmDataset **imageDataSet,
         DIMSE_StoreProviderCallback callback, void *callbackData,
         /* blocking info for data set */
-        T_DIMSE_BlockingMode blockMode, int timeout);
+        T_DIMSE_BlockingMode blockMode, int timeout,
+        /* scanner for the data set, only used if written to imageFileName */
+        DcmElementScanner *scanner = NULL);
 
 DCMTK_DCMNET_EXPORT OFCondition
 DIMSE_sendStoreResponse(T_ASC_Association * assoc,
@@ -988,12 +1003,17 @@ DIMSE_createFilestream(
                      /* out */
                      DcmOutputFileStream **filestream);
 
+/* If a scanner is given, it is started with the transfer syntax of the
+ * presentation context and is passed all received data, e.g. in order to
+ * extract a few UIDs without parsing the dataset.
+ */
 DCMTK_DCMNET_EXPORT OFCondition
 DIMSE_receiveDataSetInFile(T_ASC_Association *assoc,
                      T_DIMSE_BlockingMode blocking, int timeout,
                      T_ASC_PresentationContextID *presID,
                      DcmOutputStream *filestream,
-                     DIMSE_ProgressCallback callback, void *callbackData);
+                     DIMSE_ProgressCallback callback, void *callbackData,
+                     DcmElementScanner *scanner = NULL);
 
 DCMTK_DCMNET_EXPORT OFCondition
 DIMSE_ignoreDataSet( T_ASC_Association * assoc,
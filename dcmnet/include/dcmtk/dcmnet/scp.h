@@ -884,6 +884,22 @@ protected:
    */
   virtual void handleAssociation();
 
+  /** Receive the next DIMSE command on the current association and handle it by calling
+   *  handleIncomingCommand(). This is a single iteration of the loop in handleAssociation().
+   *  @return EC_Normal if a command was received and handled, an error code otherwise.
+   *          In particular, DUL_PEERREQUESTEDRELEASE and DUL_PEERABORTEDASSOCIATION are
+   *          returned if the peer requested to release or aborted the association.
+   */
+  virtual OFCondition receiveAndHandleCommand();
+
+  /** Clean up after the current association has ended, i.e. acknowledge a release
+   *  request or abort the association as appropriate, then drop and destroy the
+   *  association.
+   *  @param cond [in] The condition that ended the association, as returned by
+   *                   receiveAndHandleCommand()
+   */
+  virtual void endAssociation(const OFCondition &cond);
+
   /** Send a DIMSE command and possibly also a dataset from a data object via network to
    *  another DICOM application
    *  @param presID          [in]  Presentation context ID to be used for message
@@ -77,6 +77,34 @@ public:
        */
       virtual OFBool busy() = 0;
 
+      /** Negotiate the given association without handling any DIMSE messages,
+       *  i.e.\ return as soon as the association has been acknowledged or
+       *  refused. Used by the pool instead of start() if multiplexing is
+       *  enabled (see DcmBaseSCPPool::setMaxAssociations()). Afterwards,
+       *  incoming DIMSE commands are handled by workerHandleNextCommand().
+       *  The default implementation does not support multiplexing and
+       *  returns EC_IllegalCall.
+       *  @param assoc The association to be negotiated. Must not be NULL.
+       *  @return EC_Normal if association was negotiated or refused properly,
+       *          an error code otherwise.
+       */
+      virtual OFCondition workerNegotiate(T_ASC_Association* const assoc);
+
+      /** Receive and handle the next DIMSE command on an association that
+       *  has been negotiated by workerNegotiate(). If the association ends,
+       *  it is cleaned up and busy() returns OFFalse afterwards.
+       *  The default implementation returns EC_IllegalCall.
+       *  @return EC_Normal if a command has been handled, the condition
+       *          that ended the association otherwise.
+       */
+      virtual OFCondition workerHandleNextCommand();
+
+      /** Abort the association that has been negotiated by workerNegotiate()
+       *  since no DIMSE command has been received within the DIMSE timeout.
+       *  The default implementation does nothing.
+       */
+      virtual void workerAbortIdleAssociation();
+
       /** Ends and exits worker thread. Call will not return.
        */
       virtual void exit();
@@ -139,7 +167,31 @@ public:
    */
   virtual Uint16 getMaxThreads();
 
+  /** Set the number of maximum permitted associations in multiplexed mode.
+   *  If this number is larger than 0, the pool does not dedicate a thread
+   *  to each association. Instead, up to getMaxThreads() threads wait for
+   *  incoming data on all associations at once and handle one DIMSE message
+   *  at a time on the association that became readable. This permits serving
+   *  a large number of mostly idle associations with a small number of
+   *  threads. Multiplexing requires epoll() and is silently disabled on
+   *  platforms not providing it. In multiplexed mode, associations idle
+   *  for longer than the DIMSE timeout are aborted if DIMSE non-blocking
+   *  mode is configured. Messages are always received in non-blocking mode,
+   *  i.e.\ if DIMSE blocking mode or a DIMSE timeout of 0 is configured,
+   *  the ACSE timeout (or 30 seconds if it is 0) is used for receiving them.
+   *  @param maxAssociations Number of associations permitted to exist within
+   *         the pool in multiplexed mode, 0 to disable multiplexing (default).
+   */
+  virtual void setMaxAssociations(const size_t maxAssociations);
+
+  /** Get number of maximum permitted associations in multiplexed mode.
+   *  @return Number of associations permitted to exist within pool, 0 if
+   *          multiplexing is disabled.
+   */
+  virtual size_t getMaxAssociations();
+
   /** Get number of currently active connections.
+   *  In multiplexed mode, this is the number of associations currently served.
    *  @param onlyBusy Return only number of those workers that are busy with a
    *         connection and not idle, if OFTrue.
    *  @return Number of connections currently handled within pool
@@ -249,6 +301,19 @@ private:
 
   /// Current run mode of pool
   runmode m_runMode;
+
+  /// Maximum number of associations in multiplexed mode, 0 if disabled
+  size_t m_maxAssociations;
+
+  /// Helper class that serves all associations in multiplexed mode
+  class Multiplexer;
+
+  // Needed to keep MS VC6 happy
+  friend class Multiplexer;
+
+  /// Multiplexer serving the associations while listening in multiplexed
+  /// mode, NULL otherwise
+  Multiplexer* m_multiplexer;
 };
 
 /** Implementation of DICOM SCP server pool. The pool waits for incoming
@@ -257,7 +322,8 @@ private:
  *  simultaneous connections, is configurable. The default is 5. At the moment,
  *  if no free worker slots are available, an incoming request is rejected with
  *  the error "local limit exceeded", i.e. those requests are not queued. This
- *  behaviour might change in the future.
+ *  behaviour might change in the future. Alternatively, the pool can multiplex
+ *  a larger number of associations onto its threads, see setMaxAssociations().
  *  @tparam SCP the service class provider to be instantiated for each request,
  *    should follow the @ref SCPThread_Concept.
  *  @tparam SCPPool the base SCP pool class to use. Use this parameter if you
@@ -324,6 +390,35 @@ private:
         {
             return SCP::run(assoc);
         }
+
+        /** Negotiate an already accepted (TCP/IP) connection in multiplexed
+         *  mode, i.e.\ without handling any DIMSE messages.
+         *  @param assoc The association to be negotiated
+         *  @return the result of the underlying SCP implementation.
+         */
+        virtual OFCondition workerNegotiate(T_ASC_Association* const assoc)
+        {
+            OFCondition result = SCP::setMultiplexedMode(OFTrue);
+            if (result.good())
+                result = SCP::run(assoc);
+            return result;
+        }
+
+        /** Handle the next DIMSE command on the negotiated association.
+         *  @return the result of the underlying SCP implementation.
+         */
+        virtual OFCondition workerHandleNextCommand()
+        {
+            return SCP::handleNextCommand();
+        }
+
+        /** Abort the negotiated association since it has been idle for
+         *  too long.
+         */
+        virtual void workerAbortIdleAssociation()
+        {
+            SCP::abortIdleAssociation();
+        }
     };
 
     /** Create a worker to be used for handling a request.
@@ -70,8 +70,45 @@ public:
    */
   virtual OFCondition setSharedConfig(const DcmSharedSCPConfig& config);
 
+  /** Enable or disable multiplexed mode. In multiplexed mode, run() returns as soon
+   *  as the association has been negotiated instead of handling it until it ends.
+   *  The caller is then responsible for calling handleNextCommand() whenever data
+   *  is available on the association. This allows for serving many (mostly idle)
+   *  associations with a small number of threads, see DcmBaseSCPPool.
+   *  @param enabled OFTrue to enable multiplexed mode, OFFalse to disable it
+   *  @return EC_Normal if mode could be set, an error code if an association is
+   *          currently running.
+   */
+  virtual OFCondition setMultiplexedMode(const OFBool enabled);
+
+  /** Receive and handle the next DIMSE command on an association negotiated in
+   *  multiplexed mode. If the association ends, i.e.\ the peer released or aborted
+   *  it or an error occurred, the association is cleaned up and isConnected()
+   *  returns OFFalse afterwards.
+   *  @return EC_Normal if a command has been handled, the condition that ended the
+   *          association otherwise.
+   */
+  virtual OFCondition handleNextCommand();
+
+  /** Abort an association negotiated in multiplexed mode since no DIMSE command
+   *  has been received within the DIMSE timeout. Afterwards, isConnected() returns
+   *  OFFalse.
+   */
+  virtual void abortIdleAssociation();
+
+protected:
+
+  /** Overwrites DcmSCP::handleAssociation(). In multiplexed mode, returns
+   *  immediately so that run() returns after the association has been
+   *  negotiated. Otherwise, the base class implementation is called.
+   */
+  virtual void handleAssociation();
+
 private:
 
+  /// If OFTrue, run() returns after association negotiation (see setMultiplexedMode())
+  OFBool m_multiplexed;
+
   /** Private undefined copy constructor. Shall never be called.
    *  @param src Source object
    */
@@ -116,6 +116,7 @@
 #include "dcmtk/ofstd/ofconsol.h"
 #include "dcmtk/ofstd/ofstd.h"
 #include "dcmtk/dcmnet/dcmtrans.h"
+#include "dcmtk/dcmnet/dimse.h"     /* for dcmMaxOutgoingPDUSize */
 
 /*
 ** Constant Definitions
@@ -1867,6 +1868,25 @@ updateRequestedPCListFromAcceptedPCList(
     return cond;
 }
 
+/* determine the size of the send buffer for a peer accepting PDUs of the
+ * given size (0 if unlimited). PDUs larger than ASC_DEFAULTMAXSENDPDU are
+ * only sent if enabled explicitly through dcmMaxOutgoingPDUSize.
+ */
+static long
+ASC_getSendPDULength(long theirMaxPDUReceiveSize)
+{
+    long limit = ASC_DEFAULTMAXSENDPDU;
+    const Uint32 maxOutgoing = dcmMaxOutgoingPDUSize.get();
+    if ((maxOutgoing != OFstatic_cast(Uint32, -1)) && (maxOutgoing > OFstatic_cast(Uint32, limit)))
+        limit = (maxOutgoing < ASC_MAXIMUMPDUSIZE) ? OFstatic_cast(long, maxOutgoing) : ASC_MAXIMUMPDUSIZE;
+
+    if ((theirMaxPDUReceiveSize < 1) || (theirMaxPDUReceiveSize > limit)) {
+        /* the length is unlimited or too large, choose a suitable buffer len */
+        return limit;
+    }
+    return theirMaxPDUReceiveSize;
+}
+
 OFCondition
 ASC_requestAssociation(T_ASC_Network * network,
                        T_ASC_Parameters * params,
@@ -1932,13 +1952,7 @@ ASC_requestAssociation(T_ASC_Network * network,
         }
 
         /* create a sendPDVBuffer */
-        sendLen = params->theirMaxPDUReceiveSize;
-        if (sendLen < 1) {
-            /* the length is unlimited, choose a suitable buffer len */
-            sendLen = ASC_MAXIMUMPDUSIZE;
-        } else if (sendLen > ASC_MAXIMUMPDUSIZE) {
-            sendLen = ASC_MAXIMUMPDUSIZE;
-        }
+        sendLen = ASC_getSendPDULength(params->theirMaxPDUReceiveSize);
         /* make sure max pdv length is even */
         if ((sendLen % 2) != 0)
         {
@@ -2014,13 +2028,7 @@ ASC_acknowledgeAssociation(
     if (cond.good())
     {
         /* create a sendPDVBuffer */
-        sendLen = assoc->params->theirMaxPDUReceiveSize;
-        if (sendLen < 1) {
-            /* the length is unlimited, choose a suitable buffer len */
-            sendLen = ASC_MAXIMUMPDUSIZE;
-        } else if (sendLen > ASC_MAXIMUMPDUSIZE) {
-            sendLen = ASC_MAXIMUMPDUSIZE;
-        }
+        sendLen = ASC_getSendPDULength(assoc->params->theirMaxPDUReceiveSize);
         /* make sure max pdv length is even */
         if ((sendLen % 2) != 0)
         {
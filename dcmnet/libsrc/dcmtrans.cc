@@ -43,6 +43,12 @@ BEGIN_EXTERN_C
 #ifdef HAVE_SYS_SELECT_H
 #include <sys/select.h>
 #endif
+#ifdef HAVE_POLL_H
+#include <poll.h>
+#endif
+#ifdef HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif
 END_EXTERN_C
 
 #ifdef HAVE_WINDOWS_H
@@ -115,6 +121,28 @@ DcmTransportConnection::~DcmTransportConnection()
 {
 }
 
+ssize_t DcmTransportConnection::writeBuffers(void *buf1, size_t nbyte1, void *buf2, size_t nbyte2)
+{
+  void *buf[2] = { buf1, buf2 };
+  size_t nbyte[2] = { nbyte1, nbyte2 };
+  ssize_t total = 0;
+  for (int i = 0; i < 2; ++i)
+  {
+    char *p = OFstatic_cast(char *, buf[i]);
+    size_t remaining = nbyte[i];
+    while (remaining > 0)
+    {
+      ssize_t nbytes = write(p, remaining);
+      if (nbytes == -1 && errno == EINTR) continue;
+      if (nbytes <= 0) return -1;
+      p += nbytes;
+      remaining -= nbytes;
+      total += nbytes;
+    }
+  }
+  return total;
+}
+
 OFBool DcmTransportConnection::safeSelectReadableAssociation(DcmTransportConnection *connections[], int connCount, int timeout)
 {
   int numberOfRounds = timeout+1;
@@ -269,6 +297,43 @@ ssize_t DcmTCPConnection::write(void *buf, size_t nbyte)
 #endif
 }
 
+ssize_t DcmTCPConnection::writeBuffers(void *buf1, size_t nbyte1, void *buf2, size_t nbyte2)
+{
+#if defined(HAVE_SYS_UIO_H) && !defined(HAVE_WINSOCK_H)
+  struct iovec iov[2];
+  iov[0].iov_base = buf1;
+  iov[0].iov_len = nbyte1;
+  iov[1].iov_base = buf2;
+  iov[1].iov_len = nbyte2;
+  struct iovec *vec = iov;
+  int count = 2;
+  ssize_t total = 0;
+  while (count > 0)
+  {
+    ssize_t nbytes = ::writev(getSocket(), vec, count);
+    if (nbytes == -1 && errno == EINTR) continue;
+    if (nbytes <= 0) return -1;
+    total += nbytes;
+    /* skip the data that has been written, in case of a partial write */
+    size_t written = OFstatic_cast(size_t, nbytes);
+    while ((count > 0) && (written >= vec->iov_len))
+    {
+      written -= vec->iov_len;
+      ++vec;
+      --count;
+    }
+    if (count > 0)
+    {
+      vec->iov_base = OFstatic_cast(char *, vec->iov_base) + written;
+      vec->iov_len -= written;
+    }
+  }
+  return total;
+#else
+  return DcmTransportConnection::writeBuffers(buf1, nbyte1, buf2, nbyte2);
+#endif
+}
+
 void DcmTCPConnection::close()
 {
   if (getSocket() != -1)
@@ -296,6 +361,26 @@ unsigned long DcmTCPConnection::getPeerCertificate(void * /* buf */ , unsigned l
 
 OFBool DcmTCPConnection::networkDataAvailable(int timeout)
 {
+#ifdef HAVE_POLL_H
+  /* prefer poll() since select() cannot handle sockets
+   * with a descriptor number beyond FD_SETSIZE
+   */
+  struct pollfd pfd;
+  int nfound;
+
+  pfd.fd = getSocket();
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+
+  nfound = poll(&pfd, 1, timeout * 1000);
+  if (nfound <= 0) return OFFalse;
+  else
+  {
+    /* also report hangups and errors, the next read will fail accordingly */
+    if (pfd.revents & (POLLIN | POLLHUP | POLLERR)) return OFTrue;
+    else return OFFalse;  /* This should not really happen */
+  }
+#else
   struct timeval t;
   fd_set fdset;
   int nfound;
@@ -323,6 +408,7 @@ OFBool DcmTCPConnection::networkDataAvailable(int timeout)
     if (FD_ISSET(getSocket(), &fdset)) return OFTrue;
     else return OFFalse;  /* This should not really happen */
   }
+#endif
 }
 
 OFBool DcmTCPConnection::isTransparentConnection()
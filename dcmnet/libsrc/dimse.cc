@@ -118,6 +118,7 @@
 #include "dcmtk/dcmdata/dcdicent.h"    /* for DcmDictEntry, needed for MSVC5 */
 #include "dcmtk/dcmdata/dcwcache.h"    /* for class DcmWriteCache */
 #include "dcmtk/dcmdata/dcvrui.h"      /* for class DcmUniqueIdentifier */
+#include "dcmtk/dcmdata/dcelscan.h"    /* for class DcmElementScanner */
 
 
 /*
@@ -132,6 +133,12 @@
  */
 OFGlobal<Uint32> dcmMaxOutgoingPDUSize((Uint32) -1);
 
+/*  global flag defining the size of the buffer in which
+ *  DIMSE_receiveDataSetInFile() collects the received PDVs
+ *  before writing them to the file.
+ */
+OFGlobal<Uint32> dcmReceiveFileBufferSize(262144);
+
 /*
  * Other global variables (should be used very, very rarely).
  * Modification of this variables is THREAD UNSAFE.
@@ -689,7 +696,6 @@ sendDcmDataset(
     DUL_PDV pdv;
     /* the following variable is currently unused, leave it for future use */
     unsigned long pdvCount = 0;
-    DcmWriteCache wcache;
 
     /* initialize some local variables (we want to use the association's send buffer */
     /* to store data) this buffer can only take a certain number of elements */
@@ -705,6 +711,10 @@ sendDcmDataset(
       bufLen = maxpdulen - 12;
     }
 
+    /* large elements that still reside in file (e.g. pixel data) are read in chunks */
+    /* of the PDV size, so that each PDV of a large PDU can be filled with one read */
+    DcmWriteCache wcache(OFstatic_cast(Uint32, (bufLen > DcmWriteCacheBufsize) ? bufLen : DcmWriteCacheBufsize));
+
     /* on the basis of the association's buffer, create a buffer variable that we can write to */
     DcmOutputBufferStream outBuf(buf, bufLen);
 
@@ -1459,7 +1469,8 @@ DIMSE_receiveDataSetInFile(
         T_ASC_PresentationContextID *presID,
         DcmOutputStream *filestream,
         DIMSE_ProgressCallback callback,
-        void *callbackData)
+        void *callbackData,
+        DcmElementScanner *scanner)
 {
     OFCondition cond = EC_Normal;
     DUL_PDV pdv;
@@ -1473,6 +1484,11 @@ DIMSE_receiveDataSetInFile(
 
     *presID = 0;        /* invalid value */
     offile_off_t written = 0;
+
+    /* collect the PDVs in a buffer in order to write larger blocks to the file */
+    const Uint32 bufferSize = dcmReceiveFileBufferSize.get();
+    Uint8 *buffer = (bufferSize > 0) ? new Uint8[bufferSize] : NULL;
+    Uint32 bufferLength = 0;
     while (!last)
     {
         cond = DIMSE_readNextPDV(assoc, blocking, timeout, &pdv);
@@ -1495,6 +1511,7 @@ DIMSE_receiveDataSetInFile(
             /* is this a valid presentation context ? */
             cond = getTransferSyntax(assoc, pid, &xferSyntax);
             if (cond.bad()) last = OFTrue; // terminate loop
+            else if (scanner) scanner->start(xferSyntax);
           }
           else if (pdv.presentationContextID != pid)
           {
@@ -1520,8 +1537,32 @@ DIMSE_receiveDataSetInFile(
 
         if (!last)
         {
-          written = filestream->write((void *)(pdv.data), (Uint32)(pdv.fragmentLength));
-          if ((! filestream->good()) || (written != (Uint32)(pdv.fragmentLength)))
+          if (scanner && !scanner->finished()) scanner->scan(pdv.data, pdv.fragmentLength);
+
+          /* write the buffer if the PDV does not fit in anymore, and the PDV
+           * itself if it is not smaller than the buffer or if it is the last one
+           */
+          OFBool ok = OFTrue;
+          if ((bufferLength > 0) && (pdv.lastPDV || (bufferLength + pdv.fragmentLength > bufferSize)))
+          {
+            written = filestream->write(buffer, bufferLength);
+            ok = filestream->good() && (written == (offile_off_t)bufferLength);
+            bufferLength = 0;
+          }
+          if (ok)
+          {
+            if (pdv.lastPDV || (pdv.fragmentLength >= bufferSize))
+            {
+              written = filestream->write((void *)(pdv.data), (Uint32)(pdv.fragmentLength));
+              ok = filestream->good() && (written == (Uint32)(pdv.fragmentLength));
+            }
+            else
+            {
+              memcpy(buffer + bufferLength, pdv.data, pdv.fragmentLength);
+              bufferLength += pdv.fragmentLength;
+            }
+          }
+          if (!ok)
           {
               cond = DIMSE_ignoreDataSet(assoc, blocking, timeout, &bytesRead, &pdvCount);
               if (cond == EC_Normal)
@@ -1548,6 +1589,8 @@ DIMSE_receiveDataSetInFile(
         }
     }
 
+    delete[] buffer;
+
     /* set the Presentation Context ID we received */
     *presID = pid;
     return cond;
@@ -372,7 +372,8 @@ DIMSE_storeProvider( T_ASC_Association *assoc,
 	const char* imageFileName, int writeMetaheader,
 	DcmDataset **imageDataSet,
 	DIMSE_StoreProviderCallback callback, void *callbackData,
-	T_DIMSE_BlockingMode blockMode, int timeout)
+	T_DIMSE_BlockingMode blockMode, int timeout,
+	DcmElementScanner *scanner)
     /*
      * This function receives a data set over the network and either stores this data in a file (exactly as it was
      * received) or it stores this data in memory. Before, during and after the process of receiving data, the callback
@@ -396,6 +397,8 @@ DIMSE_storeProvider( T_ASC_Association *assoc,
      *   callbackData    - [in] Pointer to data which shall be passed to the progress indicating function
      *   blockMode       - [in] The blocking mode for receiving data (either DIMSE_BLOCKING or DIMSE_NONBLOCKING)
      *   timeout         - [in] Timeout interval for receiving data (if the blocking mode is DIMSE_NONBLOCKING).
+     *   scanner         - [in] If this variable does not equal NULL and imageFileName does not equal NULL, the
+     *                          received data is passed to this scanner while it is written to the file.
      */
 {
     OFCondition cond = EC_Normal;
@@ -467,7 +470,7 @@ DIMSE_storeProvider( T_ASC_Association *assoc,
           }
         } else {
           /* if no error occured, receive data and write it to the file */
-          cond = DIMSE_receiveDataSetInFile(assoc, blockMode, timeout, &presIdData, filestream, privCallback, &callbackCtx);
+          cond = DIMSE_receiveDataSetInFile(assoc, blockMode, timeout, &presIdData, filestream, privCallback, &callbackCtx, scanner);
           delete filestream;
           if (cond != EC_Normal)
           {
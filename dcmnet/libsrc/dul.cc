@@ -195,7 +195,7 @@ static void clearRequestorsParams(DUL_ASSOCIATESERVICEPARAMETERS * params);
 static void clearPresentationContext(LST_HEAD ** l);
 
 #define MIN_PDU_LENGTH  4*1024
-#define MAX_PDU_LENGTH  128*1024
+#define MAX_PDU_LENGTH  4*1024*1024
 
 static OFBool processIsForkedChild = OFFalse;
 static OFBool shouldFork = OFFalse;
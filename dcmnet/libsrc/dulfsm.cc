@@ -3018,7 +3018,7 @@ writeDataPDU(PRIVATE_ASSOCIATIONKEY ** association,
         head[24];
     unsigned long
         length;
-    int
+    ssize_t
         nbytes;
 
     /* construct a stream variable that will contain PDU head information */
@@ -3028,31 +3028,16 @@ writeDataPDU(PRIVATE_ASSOCIATIONKEY ** association,
     OFCondition cond = streamDataPDUHead(pdu, head, sizeof(head), &length);
     if (cond.bad()) return cond;
 
-    /* send the PDU head information (see above) */
-    do
-    {
-      nbytes = (*association)->connection ? (*association)->connection->write((char*)head, size_t(length)) : 0;
-    } while (nbytes == -1 && errno == EINTR);
-
-    /* if not all head information was sent, return an error */
-    if ((unsigned long) nbytes != length)
-    {
-        char buf[256];
-        OFString msg = "TCP I/O Error (";
-        msg += OFStandard::strerror(errno, buf, sizeof(buf));
-        msg += ") occurred in routine: writeDataPDU";
-        return makeDcmnetCondition(DULC_TCPIOERROR, OF_error, msg.c_str());
-    }
-
-    /* send the PDU's PDV data (note that our representation of a PDU can only contain one PDV.) */
-    do
-    {
-      nbytes = (*association)->connection ? (*association)->connection->write((char*)pdu->presentationDataValue.data,
-        size_t(pdu->presentationDataValue.length - 2)) : 0;
-    } while (nbytes == -1 && errno == EINTR);
+    /* send the PDU head information (see above) and the PDU's PDV data (note that our */
+    /* representation of a PDU can only contain one PDV) with a single gathering write, */
+    /* so that large PDUs are sent without copying the data and without an additional */
+    /* system call for the head */
+    const size_t dataLength = size_t(pdu->presentationDataValue.length - 2);
+    nbytes = (*association)->connection ? (*association)->connection->writeBuffers((char*)head, size_t(length),
+      (char*)pdu->presentationDataValue.data, dataLength) : 0;
 
-        /* if not all head information was sent, return an error */
-    if ((unsigned long) nbytes != pdu->presentationDataValue.length - 2)
+    /* if not all information was sent, return an error */
+    if (nbytes < 0 || (unsigned long) nbytes != length + dataLength)
     {
         char buf[256];
         OFString msg = "TCP I/O Error (";
@@ -501,24 +501,46 @@ void DcmSCP::handleAssociation()
   // or that the peer requested the release of the association (DUL_PEERREQUESTEDRELEASE).) (Also note
   // that ReceiveAndHandleCommands() will never return EC_Normal.)
   OFCondition cond = EC_Normal;
-  T_DIMSE_Message message;
-  T_ASC_PresentationContextID presID;
 
   // start a loop to be able to receive more than one DIMSE command
   while( cond.good() )
   {
-    // receive a DIMSE command over the network
-    cond = DIMSE_receiveCommand( m_assoc, m_cfg->getDIMSEBlockingMode(), m_cfg->getDIMSETimeout(),
-                                 &presID, &message, NULL );
+    cond = receiveAndHandleCommand();
+  }
+  endAssociation(cond);
+}
 
-    // check if peer did release or abort, or if we have a valid message
-    if( cond.good() )
-    {
-      DcmPresentationContextInfo presInfo;
-      getPresentationContextInfo(m_assoc, presID, presInfo);
-      cond = handleIncomingCommand(&message, presInfo);
-    }
+// ----------------------------------------------------------------------------
+
+OFCondition DcmSCP::receiveAndHandleCommand()
+{
+  if (m_assoc == NULL)
+    return DIMSE_ILLEGALASSOCIATION;
+
+  T_DIMSE_Message message;
+  T_ASC_PresentationContextID presID;
+
+  // receive a DIMSE command over the network
+  OFCondition cond = DIMSE_receiveCommand( m_assoc, m_cfg->getDIMSEBlockingMode(), m_cfg->getDIMSETimeout(),
+                                           &presID, &message, NULL );
+
+  // check if peer did release or abort, or if we have a valid message
+  if( cond.good() )
+  {
+    DcmPresentationContextInfo presInfo;
+    getPresentationContextInfo(m_assoc, presID, presInfo);
+    cond = handleIncomingCommand(&message, presInfo);
   }
+  return cond;
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmSCP::endAssociation(const OFCondition &cond)
+{
+  if (m_assoc == NULL)
+    return;
+
   // Clean up on association termination.
   if( cond == DUL_PEERREQUESTEDRELEASE )
   {
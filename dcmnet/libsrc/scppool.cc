@@ -29,6 +29,540 @@
 #include "dcmtk/dcmnet/scppool.h"
 #include "dcmtk/dcmnet/diutil.h"
 
+#ifdef HAVE_SYS_EPOLL_H
+#define INCLUDE_CERRNO
+#define INCLUDE_CTIME
+#include "dcmtk/ofstd/ofstdinc.h"
+
+BEGIN_EXTERN_C
+#include <sys/epoll.h>   /* for epoll_create(), epoll_ctl(), epoll_wait() */
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>      /* for close(), pipe(), write() */
+#endif
+END_EXTERN_C
+
+#include "dcmtk/ofstd/ofvector.h"
+#include "dcmtk/dcmnet/dul.h"
+#include "dcmtk/dcmnet/dcmtrans.h"
+
+/// epoll key of the wake-up pipe, never used for an association
+static const Uint64 WAKEUP_KEY = ~OFstatic_cast(Uint64, 0);
+
+
+/* *********************************************************************** */
+/*                        DcmBaseSCPPool::Multiplexer class                */
+/* *********************************************************************** */
+
+/** Serves all associations of the pool in multiplexed mode. A fixed number of
+ *  threads wait on a shared epoll instance for any association to become
+ *  readable and then handle the next DIMSE message on that association. Each
+ *  association is registered "one-shot", i.e. it is served by at most one
+ *  thread at a time and has to be re-armed after its message has been handled.
+ *  The threads are woken up for stopping through a pipe that is registered
+ *  with the same epoll instance.
+ */
+class DcmBaseSCPPool::Multiplexer
+{
+public:
+
+  /** Constructor.
+   *  @param pool The pool that creates the workers handling the associations
+   *  @param config The configuration to be used by all workers
+   *  @param idleTimeout Number of seconds after which an idle association is
+   *         aborted, 0 for no timeout
+   */
+  Multiplexer(DcmBaseSCPPool& pool,
+              const DcmSharedSCPConfig& config,
+              const Uint32 idleTimeout);
+
+  /** Destructor. Stops all threads, see shutdown().
+   */
+  ~Multiplexer();
+
+  /** Start the threads serving the associations.
+   *  @param numThreads Number of threads to start
+   *  @param maxAssociations Maximum number of associations served at a time
+   *  @return EC_Normal if all threads could be started, an error code otherwise.
+   */
+  OFCondition start(const Uint16 numThreads,
+                    const size_t maxAssociations);
+
+  /** Hand over an association whose TCP/IP connection has been accepted.
+   *  The association is negotiated by one of the threads.
+   *  @param assoc The association to be served. Must not be NULL.
+   *  @return EC_Normal if the association is served, NET_EC_SCPBusy if the
+   *          maximum number of associations is reached, another error code
+   *          otherwise. Unless EC_Normal is returned, the caller keeps
+   *          responsibility for the association.
+   */
+  OFCondition addAssociation(T_ASC_Association* assoc);
+
+  /** Get number of associations currently served.
+   *  @return Number of associations
+   */
+  size_t numAssociations();
+
+  /** Wait until all associations have ended, then stop and join all threads.
+   *  The threads serve the remaining associations meanwhile.
+   */
+  void shutdown();
+
+private:
+
+  /// State of a single association
+  struct Session
+  {
+    /// Constructor, creates an unused session
+    Session() : worker(NULL), assoc(NULL), socket(-1), generation(0),
+                negotiated(OFFalse), parked(OFFalse), idleSince(0) {}
+    /// Worker handling the association, NULL if the session slot is unused
+    DcmBaseSCPWorker* worker;
+    /// The association
+    T_ASC_Association* assoc;
+    /// Socket of the association as registered with epoll
+    int socket;
+    /// Incremented each time the slot is released, for detecting stale events
+    Uint32 generation;
+    /// OFTrue if association negotiation has been performed
+    OFBool negotiated;
+    /// OFTrue if the session is waiting for data, i.e. not served by a thread
+    OFBool parked;
+    /// Time since when the session is waiting for data
+    time_t idleSince;
+  };
+
+  /// Thread serving associations, see serve()
+  class Thread : public OFThread
+  {
+  public:
+    /// Constructor
+    Thread(Multiplexer& mux) : OFThread(), m_mux(mux) {}
+  protected:
+    /// Serve associations until the multiplexer is stopped
+    virtual void run() { m_mux.serve(); }
+  private:
+    /// The multiplexer this thread belongs to
+    Multiplexer& m_mux;
+  };
+
+  /// Main loop of the threads
+  void serve();
+
+  /** Handle the event of an association becoming readable
+   *  @param key The key of the session registered with epoll
+   */
+  void serveSession(const Uint64 key);
+
+  /** Re-arm the session in order to wait for the next DIMSE message
+   *  @param slot The slot of the session
+   */
+  void park(const size_t slot);
+
+  /** Free the slot of a session whose association has ended
+   *  @param slot The slot of the session
+   */
+  void release(const size_t slot);
+
+  /// Abort all associations that have been idle longer than the idle timeout
+  void abortIdleSessions();
+
+  /** Check whether the threads have to stop, i.e. stopping has been requested
+   *  and no association is left. Must be called while holding the mutex.
+   *  @return OFTrue if the threads have to stop
+   */
+  OFBool stopping() const
+  {
+    return m_stop && (m_freeSlots.size() == m_sessions.size());
+  }
+
+  /** Wake up all threads waiting for incoming data. The pipe is never read,
+   *  i.e. all threads calling epoll_wait() afterwards return immediately.
+   *  Must be called while holding the mutex.
+   */
+  void wakeUp();
+
+  /** Stop and join all threads.
+   */
+  void joinThreads();
+
+  /** Combine slot and generation to the key registered with epoll
+   *  @param slot The slot of the session
+   *  @return The key of the session
+   */
+  Uint64 makeKey(const size_t slot) const
+  {
+    return (OFstatic_cast(Uint64, m_sessions[slot].generation) << 32) | OFstatic_cast(Uint64, slot);
+  }
+
+  /// Private undefined copy constructor
+  Multiplexer(const Multiplexer&);
+
+  /// Private undefined assignment operator
+  Multiplexer& operator=(const Multiplexer&);
+
+  /// The pool that creates the workers
+  DcmBaseSCPPool& m_pool;
+  /// The configuration used by all workers
+  DcmSharedSCPConfig m_config;
+  /// Number of seconds after which an idle association is aborted, 0 if none
+  Uint32 m_idleTimeout;
+  /// Mutex that guards the sessions
+  OFMutex m_mutex;
+  /// All session slots, never resized after start()
+  OFVector<Session> m_sessions;
+  /// Indices of the unused session slots
+  OFVector<size_t> m_freeSlots;
+  /// The threads serving associations
+  OFList<Thread*> m_threads;
+  /// The epoll instance all associations are registered with
+  int m_epoll;
+  /// Pipe for waking up the threads, read end and write end
+  int m_wakeUp[2];
+  /// OFTrue if the threads have been woken up for stopping
+  OFBool m_wokenUp;
+  /// Set to OFTrue in order to stop the threads once all associations have ended
+  OFBool m_stop;
+  /// Time of the last check for idle associations
+  time_t m_lastIdleCheck;
+};
+
+// ----------------------------------------------------------------------------
+
+DcmBaseSCPPool::Multiplexer::Multiplexer(DcmBaseSCPPool& pool,
+                                         const DcmSharedSCPConfig& config,
+                                         const Uint32 idleTimeout)
+  : m_pool(pool),
+    m_config(config),
+    m_idleTimeout(idleTimeout),
+    m_mutex(),
+    m_sessions(),
+    m_freeSlots(),
+    m_threads(),
+    m_epoll(-1),
+    m_wokenUp(OFFalse),
+    m_stop(OFFalse),
+    m_lastIdleCheck(0)
+{
+  m_wakeUp[0] = m_wakeUp[1] = -1;
+}
+
+// ----------------------------------------------------------------------------
+
+DcmBaseSCPPool::Multiplexer::~Multiplexer()
+{
+  joinThreads();
+  if (m_epoll >= 0)
+    close(m_epoll);
+  if (m_wakeUp[0] >= 0)
+    close(m_wakeUp[0]);
+  if (m_wakeUp[1] >= 0)
+    close(m_wakeUp[1]);
+}
+
+// ----------------------------------------------------------------------------
+
+OFCondition DcmBaseSCPPool::Multiplexer::start(const Uint16 numThreads,
+                                               const size_t maxAssociations)
+{
+  // the size parameter is only a hint that is ignored by current kernels
+  m_epoll = epoll_create(OFstatic_cast(int, maxAssociations < 1024 ? maxAssociations : 1024));
+  if (m_epoll < 0)
+  {
+    char buf[256];
+    DCMNET_ERROR("DcmBaseSCPPool: Cannot create epoll instance: " << OFStandard::strerror(errno, buf, sizeof(buf)));
+    return NET_EC_CannotStartSCPThread;
+  }
+
+  // the read end of the pipe becomes readable when the threads have to stop
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.u64 = WAKEUP_KEY;
+  if ((pipe(m_wakeUp) != 0) || (epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeUp[0], &event) != 0))
+  {
+    char buf[256];
+    DCMNET_ERROR("DcmBaseSCPPool: Cannot create wake-up pipe: " << OFStandard::strerror(errno, buf, sizeof(buf)));
+    return NET_EC_CannotStartSCPThread;
+  }
+
+  m_sessions.resize(maxAssociations);
+  // use the slots in ascending order
+  for (size_t slot = maxAssociations; slot > 0; --slot)
+    m_freeSlots.push_back(slot - 1);
+
+  // at least one thread is needed in order to serve any association
+  for (Uint16 i = 0; i < numThreads || i == 0; ++i)
+  {
+    Thread* thread = new Thread(*this);
+    if (thread->start() != 0)
+    {
+      delete thread;
+      return NET_EC_CannotStartSCPThread;
+    }
+    m_threads.push_back(thread);
+  }
+  DCMNET_DEBUG("DcmBaseSCPPool: Serving up to " << maxAssociations << " associations with "
+    << m_threads.size() << " multiplexing threads");
+  return EC_Normal;
+}
+
+// ----------------------------------------------------------------------------
+
+OFCondition DcmBaseSCPPool::Multiplexer::addAssociation(T_ASC_Association* assoc)
+{
+  DcmTransportConnection* connection = DUL_getTransportConnection(assoc->DULassociation);
+  if (connection == NULL)
+    return DIMSE_ILLEGALASSOCIATION;
+
+  m_mutex.lock();
+  if (m_freeSlots.empty())
+  {
+    m_mutex.unlock();
+    return NET_EC_SCPBusy;
+  }
+  DcmBaseSCPWorker* const worker = m_pool.createSCPWorker();
+  if (!worker)
+  {
+    m_mutex.unlock();
+    return EC_MemoryExhausted;
+  }
+  worker->setSharedConfig(m_config);
+
+  const size_t slot = m_freeSlots.back();
+  m_freeSlots.pop_back();
+  Session& session = m_sessions[slot];
+  session.worker = worker;
+  session.assoc = assoc;
+  session.socket = connection->getSocket();
+  session.negotiated = OFFalse;
+  session.parked = OFTrue;
+  session.idleSince = time(NULL);
+
+  // A newly accepted socket is writable, i.e. the event fires immediately and
+  // the association is negotiated by the next available thread
+  struct epoll_event event;
+  event.events = EPOLLOUT | EPOLLONESHOT;
+  event.data.u64 = makeKey(slot);
+  if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, session.socket, &event) != 0)
+  {
+    char buf[256];
+    DCMNET_ERROR("DcmBaseSCPPool: Cannot register association: " << OFStandard::strerror(errno, buf, sizeof(buf)));
+    session.worker = NULL;
+    session.assoc = NULL;
+    session.parked = OFFalse;
+    ++session.generation;
+    m_freeSlots.push_back(slot);
+    m_mutex.unlock();
+    delete worker;
+    return NET_EC_CannotStartSCPThread;
+  }
+  m_mutex.unlock();
+  return EC_Normal;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t DcmBaseSCPPool::Multiplexer::numAssociations()
+{
+  m_mutex.lock();
+  const size_t result = m_sessions.size() - m_freeSlots.size();
+  m_mutex.unlock();
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmBaseSCPPool::Multiplexer::shutdown()
+{
+  // the last association to end wakes up the threads, see release()
+  joinThreads();
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmBaseSCPPool::Multiplexer::wakeUp()
+{
+  if (!m_wokenUp && (m_wakeUp[1] >= 0))
+  {
+    const char c = 0;
+    if (write(m_wakeUp[1], &c, 1) == 1)
+      m_wokenUp = OFTrue;
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmBaseSCPPool::Multiplexer::joinThreads()
+{
+  m_mutex.lock();
+  m_stop = OFTrue;
+  if (stopping())
+    wakeUp();
+  m_mutex.unlock();
+  while (!m_threads.empty())
+  {
+    m_threads.front()->join();
+    delete m_threads.front();
+    m_threads.pop_front();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmBaseSCPPool::Multiplexer::serve()
+{
+  struct epoll_event event;
+  // without idle timeout, the threads only wake up for incoming data or for stopping
+  const int timeout = (m_idleTimeout > 0) ? 1000 : -1;
+  while (1)
+  {
+    m_mutex.lock();
+    const OFBool stop = stopping();
+    m_mutex.unlock();
+    if (stop)
+      break;
+    const int count = epoll_wait(m_epoll, &event, 1, timeout);
+    if ((count > 0) && (event.data.u64 != WAKEUP_KEY))
+    {
+      serveSession(event.data.u64);
+    }
+    else if ((count < 0) && (errno != EINTR))
+    {
+      char buf[256];
+      DCMNET_ERROR("DcmBaseSCPPool: Waiting for incoming data failed: " << OFStandard::strerror(errno, buf, sizeof(buf)));
+      break;
+    }
+    if (m_idleTimeout > 0)
+      abortIdleSessions();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmBaseSCPPool::Multiplexer::serveSession(const Uint64 key)
+{
+  const size_t slot = OFstatic_cast(size_t, key & 0xffffffff);
+  const Uint32 generation = OFstatic_cast(Uint32, key >> 32);
+
+  m_mutex.lock();
+  // ignore stale events of associations that have ended or have been aborted meanwhile
+  if ((slot >= m_sessions.size()) || (m_sessions[slot].worker == NULL) ||
+      (m_sessions[slot].generation != generation) || !m_sessions[slot].parked)
+  {
+    m_mutex.unlock();
+    return;
+  }
+  Session& session = m_sessions[slot];
+  DcmBaseSCPWorker* const worker = session.worker;
+  T_ASC_Association* const assoc = session.assoc;
+  const OFBool negotiated = session.negotiated;
+  session.parked = OFFalse;
+  session.negotiated = OFTrue;
+  m_mutex.unlock();
+
+  OFCondition cond;
+  if (!negotiated)
+  {
+    cond = worker->workerNegotiate(assoc);
+    if (cond.bad())
+    {
+      // the worker did not take over the association
+      DCMNET_ERROR("DcmBaseSCPPool: Cannot negotiate association: " << cond.text());
+      m_pool.rejectAssociation(assoc, ASC_REASON_SP_PRES_TEMPORARYCONGESTION);
+      m_pool.dropAndDestroyAssociation(assoc);
+    }
+  }
+  else
+    cond = worker->workerHandleNextCommand();
+
+  // handle further messages already received (e.g. buffered by TLS) without waiting
+  while (cond.good() && worker->busy() && ASC_dataWaiting(assoc, 0))
+    cond = worker->workerHandleNextCommand();
+
+  if (cond.good() && worker->busy())
+    park(slot);
+  else
+    release(slot);
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmBaseSCPPool::Multiplexer::park(const size_t slot)
+{
+  m_mutex.lock();
+  Session& session = m_sessions[slot];
+  session.parked = OFTrue;
+  session.idleSince = time(NULL);
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLONESHOT;
+  event.data.u64 = makeKey(slot);
+  if (epoll_ctl(m_epoll, EPOLL_CTL_MOD, session.socket, &event) != 0)
+  {
+    char buf[256];
+    DCMNET_ERROR("DcmBaseSCPPool: Cannot wait for incoming data: " << OFStandard::strerror(errno, buf, sizeof(buf)));
+    session.parked = OFFalse;
+    m_mutex.unlock();
+    session.worker->workerAbortIdleAssociation();
+    release(slot);
+    return;
+  }
+  m_mutex.unlock();
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmBaseSCPPool::Multiplexer::release(const size_t slot)
+{
+  // The socket has been closed together with the association, which also
+  // removes it from the epoll instance
+  m_mutex.lock();
+  Session& session = m_sessions[slot];
+  DcmBaseSCPWorker* const worker = session.worker;
+  session.worker = NULL;
+  session.assoc = NULL;
+  session.socket = -1;
+  session.parked = OFFalse;
+  ++session.generation;
+  m_freeSlots.push_back(slot);
+  if (stopping())
+    wakeUp();
+  m_mutex.unlock();
+  delete worker;
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmBaseSCPPool::Multiplexer::abortIdleSessions()
+{
+  const time_t now = time(NULL);
+  OFVector<size_t> idle;
+  m_mutex.lock();
+  // check at most once per second, no matter how many threads are running
+  if (now != m_lastIdleCheck)
+  {
+    m_lastIdleCheck = now;
+    for (size_t slot = 0; slot < m_sessions.size(); ++slot)
+    {
+      Session& session = m_sessions[slot];
+      if (session.worker && session.negotiated && session.parked &&
+          (now - session.idleSince >= OFstatic_cast(time_t, m_idleTimeout)))
+      {
+        // take the session over so that no other thread serves it meanwhile
+        session.parked = OFFalse;
+        idle.push_back(slot);
+      }
+    }
+  }
+  m_mutex.unlock();
+
+  for (OFVector<size_t>::iterator it = idle.begin(); it != idle.end(); ++it)
+  {
+    m_sessions[*it].worker->workerAbortIdleAssociation();
+    release(*it);
+  }
+}
+
+#endif // HAVE_SYS_EPOLL_H
+
 // ----------------------------------------------------------------------------
 
 DcmBaseSCPPool::DcmBaseSCPPool()
@@ -37,7 +571,9 @@ DcmBaseSCPPool::DcmBaseSCPPool()
     m_workersIdle(),
     m_cfg(),
     m_maxWorkers(5),
-    m_runMode( LISTEN )
+    m_runMode( LISTEN ),
+    m_maxAssociations(0),
+    m_multiplexer(NULL)
     // not implemented yet: m_workersBusyTimeout(60),
     // not implemented yet: m_waiting(),
 {
@@ -64,6 +600,38 @@ OFCondition DcmBaseSCPPool::listen()
   if( cond.bad() )
     return cond;
 
+#ifdef HAVE_SYS_EPOLL_H
+  /* In multiplexed mode, all associations are served by a fixed number of threads */
+  if (m_maxAssociations > 0)
+  {
+    const Uint32 idleTimeout = (m_cfg.getDIMSEBlockingMode() == DIMSE_NONBLOCKING) ? m_cfg.getDIMSETimeout() : 0;
+    /* A thread must never wait for the rest of a message without a timeout, since
+     * a peer stalling in the middle of a message would block it for good. The
+     * idle timeout between messages is still taken from the configuration.
+     */
+    DcmSharedSCPConfig multiplexedConfig(m_cfg);
+    if (idleTimeout == 0)
+    {
+      const Uint32 readTimeout = (m_cfg.getACSETimeout() > 0) ? m_cfg.getACSETimeout() : 30;
+      DCMNET_WARN("DcmBaseSCPPool: Multiplexed mode requires DIMSE non-blocking mode with a timeout, "
+        << "using a timeout of " << readTimeout << " seconds for receiving messages");
+      multiplexedConfig->setDIMSEBlockingMode(DIMSE_NONBLOCKING);
+      multiplexedConfig->setDIMSETimeout(readTimeout);
+    }
+    Multiplexer* multiplexer = new Multiplexer(*this, multiplexedConfig, idleTimeout);
+    cond = multiplexer->start(m_maxWorkers, m_maxAssociations);
+    if (cond.bad())
+    {
+      delete multiplexer;
+      ASC_dropNetwork(&network);
+      return cond;
+    }
+    m_criticalSection.lock();
+    m_multiplexer = multiplexer;
+    m_criticalSection.unlock();
+  }
+#endif
+
   /* As long as all is fine (or we have been to busy handling last connection request) keep listening */
   while ( m_runMode == LISTEN && ( cond.good() || (cond == NET_EC_SCPBusy) ) )
   {
@@ -113,6 +681,18 @@ OFCondition DcmBaseSCPPool::listen()
     }
   }
 
+#ifdef HAVE_SYS_EPOLL_H
+  /* Wait for all multiplexed associations to end */
+  if (m_multiplexer)
+  {
+    m_multiplexer->shutdown();
+    m_criticalSection.lock();
+    delete m_multiplexer;
+    m_multiplexer = NULL;
+    m_criticalSection.unlock();
+  }
+#endif
+
   m_criticalSection.lock();
   m_runMode = SHUTDOWN;
 
@@ -156,10 +736,29 @@ Uint16 DcmBaseSCPPool::getMaxThreads()
 
 // ----------------------------------------------------------------------------
 
+void DcmBaseSCPPool::setMaxAssociations(const size_t maxAssociations)
+{
+  m_maxAssociations = maxAssociations;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t DcmBaseSCPPool::getMaxAssociations()
+{
+  return m_maxAssociations;
+}
+
+// ----------------------------------------------------------------------------
+
 size_t DcmBaseSCPPool::numThreads(const OFBool onlyBusy)
 {
   size_t result = 0;
   m_criticalSection.lock();
+#ifdef HAVE_SYS_EPOLL_H
+  if (m_multiplexer)
+    result = m_multiplexer->numAssociations();
+  else
+#endif
   if (!onlyBusy)
   {
     result = m_workersBusy.size() + m_workersIdle.size();
@@ -182,6 +781,12 @@ void DcmBaseSCPPool::setMaxThreads(const Uint16 maxWorkers)
 OFCondition DcmBaseSCPPool::runAssociation(T_ASC_Association *assoc,
                                            const DcmSharedSCPConfig& sharedConfig)
 {
+#ifdef HAVE_SYS_EPOLL_H
+  /* In multiplexed mode, the association is not handed to a dedicated thread */
+  if (m_multiplexer)
+    return m_multiplexer->addAssociation(assoc);
+#endif
+
   /* Try to find idle worker thread */
   OFCondition result = EC_Normal;
   DcmBaseSCPWorker *chosen = NULL;
@@ -319,6 +924,27 @@ OFCondition DcmBaseSCPPool::DcmBaseSCPWorker::setAssociation(T_ASC_Association*
 
 // ----------------------------------------------------------------------------
 
+OFCondition DcmBaseSCPPool::DcmBaseSCPWorker::workerNegotiate(T_ASC_Association* const /* assoc */)
+{
+  return EC_IllegalCall;
+}
+
+// ----------------------------------------------------------------------------
+
+OFCondition DcmBaseSCPPool::DcmBaseSCPWorker::workerHandleNextCommand()
+{
+  return EC_IllegalCall;
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmBaseSCPPool::DcmBaseSCPWorker::workerAbortIdleAssociation()
+{
+  // multiplexing is not supported by default
+}
+
+// ----------------------------------------------------------------------------
+
 void DcmBaseSCPPool::DcmBaseSCPWorker::run()
 {
   OFCondition result;
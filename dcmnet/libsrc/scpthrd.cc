@@ -27,7 +27,8 @@
 // ----------------------------------------------------------------------------
 
 DcmThreadSCP::DcmThreadSCP()
- : DcmSCP()
+ : DcmSCP(),
+   m_multiplexed(OFFalse)
 {
 }
 
@@ -73,3 +74,47 @@ OFCondition DcmThreadSCP::run(T_ASC_Association* incomingAssoc)
 
   return processAssociationRQ();
 }
+
+// ----------------------------------------------------------------------------
+
+OFCondition DcmThreadSCP::setMultiplexedMode(const OFBool enabled)
+{
+  if (isConnected())
+    return NET_EC_AlreadyConnected;
+
+  m_multiplexed = enabled;
+  return EC_Normal;
+}
+
+// ----------------------------------------------------------------------------
+
+OFCondition DcmThreadSCP::handleNextCommand()
+{
+  if (!isConnected())
+    return DIMSE_ILLEGALASSOCIATION;
+
+  OFCondition cond = receiveAndHandleCommand();
+  if (cond.bad())
+    endAssociation(cond);
+  return cond;
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmThreadSCP::abortIdleAssociation()
+{
+  if (isConnected())
+  {
+    DCMNET_INFO("No DIMSE command received within " << getDIMSETimeout() << " seconds, aborting association");
+    endAssociation(DIMSE_NODATAAVAILABLE);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmThreadSCP::handleAssociation()
+{
+  // in multiplexed mode, incoming commands are handled by handleNextCommand()
+  if (!m_multiplexed)
+    DcmSCP::handleAssociation();
+}
@@ -24,9 +24,18 @@
 #include "dcmtk/ofstd/oftest.h"
 
 OFTEST_REGISTER(dcmnet_dimseDump_nullByte);
+OFTEST_REGISTER(dcmnet_transportConnection_writeBuffers);
 
 #ifdef WITH_THREADS
 OFTEST_REGISTER(dcmnet_scp_pool);
+OFTEST_REGISTER(dcmnet_scp_pool_multiplexed);
+#ifdef HAVE_SYS_EPOLL_H
+OFTEST_REGISTER(dcmnet_scp_pool_multiplexed_stalled);
+#endif // HAVE_SYS_EPOLL_H
 #endif // WITH_THREADS
 
+#if defined(WITH_THREADS) && defined(HAVE_SYS_UIO_H) && !defined(HAVE_WINSOCK_H)
+OFTEST_REGISTER(dcmnet_tcpConnection_writeBuffers);
+#endif
+
 OFTEST_MAIN("dcmnet")
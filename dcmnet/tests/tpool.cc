@@ -27,15 +27,20 @@
 #include "dcmtk/ofstd/oftest.h"
 #include "dcmtk/dcmnet/scppool.h"
 #include "dcmtk/dcmnet/scu.h"
+#include "dcmtk/dcmnet/dcmtrans.h"
 
 struct TestSCU : DcmSCU, OFThread
 {
     OFCondition result;
+    size_t numEchos;
+    TestSCU() : numEchos(1) {}
 protected:
     void run()
     {
         negotiateAssociation();
-        result = sendECHORequest(0);
+        result = EC_Normal;
+        for (size_t i = 0; i < numEchos && result.good(); ++i)
+            result = sendECHORequest(0);
         releaseAssociation();
     }
 };
@@ -51,25 +56,23 @@ protected:
 };
 
 
-/* Test starts pool with a maximum of 20 SCP workers. All workers are
- * configured to respond to C-ECHO (Verification SOP Class). 20 SCU
- * threads are created and connect simultaneously to the pool, send
- * C-ECHO messages and release the association.
+/* Starts the given pool, configured to respond to C-ECHO (Verification
+ * SOP Class). 20 SCU threads are created and connect simultaneously to
+ * the pool, send the given number of C-ECHO messages and release the
+ * association.
  */
-OFTEST_FLAGS(dcmnet_scp_pool, EF_Slow)
+static void runPoolTest(TestPool& pool, const Uint16 port, const size_t numEchos)
 {
-    TestPool pool;
     DcmSCPConfig& config = pool.getConfig();
 
     config.setAETitle("PoolTestSCP");
-    config.setPort(11112);
+    config.setPort(port);
     config.setConnectionBlockingMode(DUL_NOBLOCK);
 
     // Dead time during which the pool is unable to respond to
     // stopAfterCurrentAssociations().
     config.setConnectionTimeout(1);
 
-    pool.setMaxThreads(20);
     OFList<OFString> xfers;
     xfers.push_back(UID_LittleEndianExplicitTransferSyntax);
     xfers.push_back(UID_LittleEndianImplicitTransferSyntax);
@@ -81,10 +84,11 @@ OFTEST_FLAGS(dcmnet_scp_pool, EF_Slow)
     for (OFVector<TestSCU*>::iterator it1 = scus.begin(); it1 != scus.end(); ++it1)
     {
         *it1 = new TestSCU;
+        (*it1)->numEchos = numEchos;
         (*it1)->setAETitle("PoolTestSCU");
         (*it1)->setPeerAETitle("PoolTestSCP");
         (*it1)->setPeerHostName("localhost");
-        (*it1)->setPeerPort(11112);
+        (*it1)->setPeerPort(port);
         (*it1)->addPresentationContext(UID_VerificationSOPClass, xfers);
         (*it1)->initNetwork();
     }
@@ -110,4 +114,116 @@ OFTEST_FLAGS(dcmnet_scp_pool, EF_Slow)
     OFCHECK(pool.result.good());
 }
 
+
+/* Test starts pool with a maximum of 20 SCP workers, i.e. one thread
+ * for each of the 20 SCUs.
+ */
+OFTEST_FLAGS(dcmnet_scp_pool, EF_Slow)
+{
+    TestPool pool;
+    pool.setMaxThreads(20);
+    runPoolTest(pool, 11112, 1);
+}
+
+/* Test starts pool in multiplexed mode, serving up to 20 associations
+ * with only 2 threads. Each SCU sends several C-ECHO messages so that
+ * the associations are interleaved. On platforms not supporting
+ * multiplexing, the pool falls back to one thread per association.
+ */
+OFTEST_FLAGS(dcmnet_scp_pool_multiplexed, EF_Slow)
+{
+    TestPool pool;
+#ifdef HAVE_SYS_EPOLL_H
+    pool.setMaxThreads(2);
+#else
+    pool.setMaxThreads(20);
+#endif
+    pool.setMaxAssociations(20);
+    runPoolTest(pool, 11113, 5);
+}
+
+#ifdef HAVE_SYS_EPOLL_H
+
+/* Test starts pool in multiplexed mode with a single thread and DIMSE
+ * blocking mode. A peer stalls in the middle of a PDU, which must not
+ * block the thread for good, i.e. another SCU is still served once the
+ * stalled association has been aborted after the ACSE timeout.
+ */
+OFTEST(dcmnet_scp_pool_multiplexed_stalled)
+{
+    const Uint16 port = 11114;
+    TestPool pool;
+    pool.setMaxThreads(1);
+    pool.setMaxAssociations(4);
+    DcmSCPConfig& config = pool.getConfig();
+    config.setAETitle("PoolTestSCP");
+    config.setPort(port);
+    config.setConnectionBlockingMode(DUL_NOBLOCK);
+    config.setConnectionTimeout(1);
+    config.setACSETimeout(2);
+    OFList<OFString> xfers;
+    xfers.push_back(UID_LittleEndianImplicitTransferSyntax);
+    config.addPresentationContext(UID_VerificationSOPClass, xfers);
+    pool.start();
+
+    /* negotiate an association and send only the first bytes of a P-DATA-TF PDU */
+    T_ASC_Network *net = NULL;
+    T_ASC_Parameters *params = NULL;
+    T_ASC_Association *assoc = NULL;
+    const char *ts[] = { UID_LittleEndianImplicitTransferSyntax };
+    char peer[32];
+    sprintf(peer, "localhost:%u", port);
+    OFCHECK(ASC_initializeNetwork(NET_REQUESTOR, 0, 10, &net).good());
+    OFCondition cond;
+    for (int retry = 0; retry < 50; ++retry)
+    {
+        OFCHECK(ASC_createAssociationParameters(&params, ASC_DEFAULTMAXPDU).good());
+        ASC_setAPTitles(params, "StalledSCU", "PoolTestSCP", NULL);
+        ASC_setPresentationAddresses(params, "localhost", peer);
+        ASC_addPresentationContext(params, 1, UID_VerificationSOPClass, ts, 1);
+        cond = ASC_requestAssociation(net, params, &assoc);
+        if (cond.good())
+            break;
+        ASC_destroyAssociation(&assoc);
+        OFStandard::milliSleep(100);
+    }
+    OFCHECK(cond.good());
+    if (cond.good())
+    {
+        unsigned char pdu[3] = { 0x04, 0x00, 0x00 };
+        OFCHECK_EQUAL(DUL_getTransportConnection(assoc->DULassociation)->write(pdu, sizeof(pdu)), 3);
+    }
+
+    /* the stalled association is aborted, the other one is served */
+    TestSCU scu;
+    scu.setAETitle("PoolTestSCU");
+    scu.setPeerAETitle("PoolTestSCP");
+    scu.setPeerHostName("localhost");
+    scu.setPeerPort(port);
+    scu.setACSETimeout(10);
+    scu.setDIMSEBlockingMode(DIMSE_NONBLOCKING);
+    scu.setDIMSETimeout(10);
+    scu.addPresentationContext(UID_VerificationSOPClass, xfers);
+    scu.initNetwork();
+    scu.start();
+    scu.join();
+    OFCHECK(scu.result.good());
+    for (int retry = 0; (retry < 50) && (pool.numThreads(OFFalse) > 0); ++retry)
+        OFStandard::milliSleep(100);
+    OFCHECK_EQUAL(pool.numThreads(OFFalse), 0);
+
+    /* without the timeout, only closing the connection would release the thread */
+    if (assoc)
+    {
+        ASC_abortAssociation(assoc);
+        ASC_destroyAssociation(&assoc);
+    }
+    ASC_dropNetwork(&net);
+    pool.stopAfterCurrentAssociations();
+    pool.join();
+    OFCHECK(pool.result.good());
+}
+
+#endif // HAVE_SYS_EPOLL_H
+
 #endif // WITH_THREADS
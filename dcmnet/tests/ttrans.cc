@@ -0,0 +1,234 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test writing two buffers at once to a transport connection
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CERRNO
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmnet/dcmtrans.h"
+
+#if defined(WITH_THREADS) && defined(HAVE_SYS_UIO_H) && !defined(HAVE_WINSOCK_H)
+#define TEST_TCP_CONNECTION
+#include "dcmtk/ofstd/ofthread.h"
+BEGIN_EXTERN_C
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+END_EXTERN_C
+#endif
+
+
+/* fill a buffer with a pattern that differs for both buffers and all positions */
+static void fillBuffer(unsigned char *buf, const size_t size, const unsigned char seed)
+{
+    for (size_t i = 0; i < size; ++i)
+        buf[i] = OFstatic_cast(unsigned char, seed + i * 7 + (i >> 8));
+}
+
+
+/* transport connection that only writes a few bytes at a time and is
+ * interrupted by a signal before every other write
+ */
+class PartialWriteConnection : public DcmTransportConnection
+{
+public:
+    PartialWriteConnection(const size_t chunkSize)
+      : DcmTransportConnection(-1)
+      , data()
+      , chunk(chunkSize)
+      , calls(0)
+      , failAfter(0)
+    {
+    }
+
+    virtual DcmTransportLayerStatus serverSideHandshake() { return TCS_ok; }
+    virtual DcmTransportLayerStatus clientSideHandshake() { return TCS_ok; }
+    virtual DcmTransportLayerStatus renegotiate(const char *) { return TCS_ok; }
+    virtual ssize_t read(void *, size_t) { return -1; }
+
+    virtual ssize_t write(void *buf, size_t nbyte)
+    {
+        if ((++calls % 2) == 1)
+        {
+            errno = EINTR;
+            return -1;
+        }
+        if ((failAfter > 0) && (data.size() >= failAfter))
+            return 0;
+        const size_t count = (nbyte < chunk) ? nbyte : chunk;
+        data.append(OFstatic_cast(const char *, buf), count);
+        return OFstatic_cast(ssize_t, count);
+    }
+
+    virtual void close() {}
+    virtual unsigned long getPeerCertificateLength() { return 0; }
+    virtual unsigned long getPeerCertificate(void *, unsigned long) { return 0; }
+    virtual OFBool networkDataAvailable(int) { return OFFalse; }
+    virtual OFBool isTransparentConnection() { return OFTrue; }
+    virtual OFString& dumpConnectionParameters(OFString& str) { return str; }
+    virtual const char *errorString(DcmTransportLayerStatus) { return ""; }
+
+    /// data written so far
+    OFString data;
+    /// maximum number of bytes written by each call of write()
+    size_t chunk;
+    /// number of calls of write()
+    unsigned long calls;
+    /// if not 0, write() fails once this number of bytes has been written
+    size_t failAfter;
+};
+
+
+OFTEST(dcmnet_transportConnection_writeBuffers)
+{
+    unsigned char header[12];
+    unsigned char value[1000];
+    fillBuffer(header, sizeof(header), 1);
+    fillBuffer(value, sizeof(value), 100);
+    OFString expected(OFreinterpret_cast(const char *, header), sizeof(header));
+    expected.append(OFreinterpret_cast(const char *, value), sizeof(value));
+
+    /* partial writes that end within and exactly at the end of a buffer */
+    const size_t chunks[] = { 1, 5, 6, 12, 13, 999, 2000 };
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i)
+    {
+        PartialWriteConnection conn(chunks[i]);
+        OFCHECK_EQUAL(conn.writeBuffers(header, sizeof(header), value, sizeof(value)), OFstatic_cast(ssize_t, expected.size()));
+        OFCHECK(conn.data == expected);
+    }
+
+    /* empty buffers */
+    PartialWriteConnection empty(5);
+    OFCHECK_EQUAL(empty.writeBuffers(header, sizeof(header), value, 0), OFstatic_cast(ssize_t, sizeof(header)));
+    OFCHECK_EQUAL(empty.writeBuffers(header, 0, value, 0), 0);
+    OFCHECK(empty.data == expected.substr(0, sizeof(header)));
+
+    /* an error is reported even if some data has been written */
+    PartialWriteConnection failing(100);
+    failing.failAfter = 500;
+    OFCHECK(failing.writeBuffers(header, sizeof(header), value, sizeof(value)) < 0);
+}
+
+
+#ifdef TEST_TCP_CONNECTION
+
+/* the signal handler does nothing, it only interrupts system calls */
+static void interruptHandler(int)
+{
+}
+
+/* thread reading all data from a socket in small pieces and slowly, while
+ * interrupting the writing thread with signals before each read
+ */
+class SlowReader : public OFThread
+{
+public:
+    SlowReader(const int socket, const pthread_t writer, const size_t expectedSize)
+      : OFThread()
+      , data()
+      , signals(0)
+      , m_socket(socket)
+      , m_writer(writer)
+      , m_expectedSize(expectedSize)
+    {
+    }
+
+    /// data read so far
+    OFString data;
+    /// number of signals sent to the writing thread
+    unsigned long signals;
+
+protected:
+    virtual void run()
+    {
+        char buf[4096];
+        while (data.size() < m_expectedSize)
+        {
+            /* the first signal usually interrupts a write after some data has been sent,
+             * the second one while the writing thread waits for the socket again
+             */
+            for (int i = 0; i < 2; ++i)
+            {
+                pthread_kill(m_writer, SIGUSR1);
+                ++signals;
+                OFStandard::milliSleep(1);
+            }
+            const ssize_t count = ::read(m_socket, buf, sizeof(buf));
+            if (count <= 0)
+                break;
+            data.append(buf, OFstatic_cast(size_t, count));
+        }
+    }
+
+private:
+    int m_socket;
+    pthread_t m_writer;
+    size_t m_expectedSize;
+};
+
+OFTEST(dcmnet_tcpConnection_writeBuffers)
+{
+    int sockets[2];
+    OFCHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+
+    /* a small send buffer causes many partial writes */
+    int size = 4096;
+    setsockopt(sockets[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+
+    /* system calls interrupted by the signal are not restarted automatically */
+    struct sigaction action;
+    struct sigaction oldAction;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = interruptHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;
+    OFCHECK(sigaction(SIGUSR1, &action, &oldAction) == 0);
+
+    /* a PDU header and a large PDV as sent by writeDataPDU() */
+    const size_t valueSize = 1024 * 1024 + 3;
+    unsigned char header[12];
+    unsigned char *value = new unsigned char[valueSize];
+    fillBuffer(header, sizeof(header), 1);
+    fillBuffer(value, valueSize, 100);
+    OFString expected(OFreinterpret_cast(const char *, header), sizeof(header));
+    expected.append(OFreinterpret_cast(const char *, value), valueSize);
+
+    DcmTCPConnection conn(sockets[0]);
+    SlowReader reader(sockets[1], pthread_self(), expected.size());
+    OFCHECK(reader.start() == 0);
+    const ssize_t result = conn.writeBuffers(header, sizeof(header), value, valueSize);
+    OFCHECK_EQUAL(result, OFstatic_cast(ssize_t, expected.size()));
+    /* make sure that the reading thread terminates if some data is missing */
+    shutdown(sockets[0], SHUT_WR);
+    reader.join();
+    OFCHECK(reader.signals > 1);
+    OFCHECK_EQUAL(reader.data.size(), expected.size());
+    OFCHECK(reader.data == expected);
+
+    /* writing to a closed connection fails */
+    ::close(sockets[1]);
+    signal(SIGPIPE, SIG_IGN);
+    OFCHECK(conn.writeBuffers(header, sizeof(header), value, valueSize) < 0);
+
+    sigaction(SIGUSR1, &oldAction, NULL);
+    conn.close();
+    delete[] value;
+}
+
+#endif // TEST_TCP_CONNECTION
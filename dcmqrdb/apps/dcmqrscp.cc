@@ -94,6 +94,7 @@ static char rcsid[] = "$dcmtk: " OFFIS_CONSOLE_APPLICATION " v"
 const char *opt_configFileName = DEFAULT_CONFIGURATION_DIR "dcmqrscp.cfg";
 OFBool      opt_checkFindIdentifier = OFFalse;
 OFBool      opt_checkMoveIdentifier = OFFalse;
+OFBool      opt_useKeyIndex = OFFalse;
 OFCmdUnsignedInt opt_port = 0;
 
 #define SHORTCOL 4
@@ -168,6 +169,8 @@ main(int argc, char *argv[])
       cmd.addOption("--no-check-find",                       "do not check C-FIND identifier validity (def.)");
       cmd.addOption("--check-move",             "-XM",       "check C-MOVE identifier validity");
       cmd.addOption("--no-check-move",                       "do not check C-MOVE identifier validity (def.)");
+    cmd.addSubGroup("index file lookup:");
+      cmd.addOption("--key-index",              "+ki",       "create and use key index file (index.key)\nfor the lookup of UIDs, patient ID,\naccession number and study date");
     cmd.addSubGroup("restriction of move targets:");
       cmd.addOption("--move-unrestricted",                   "do not restrict move destination (default)");
       cmd.addOption("--move-aetitle",           "-ZA",       "restrict move dest. to requesting AE title");
@@ -342,6 +345,7 @@ main(int argc, char *argv[])
       if (cmd.findOption("--check-move")) opt_checkMoveIdentifier = OFTrue;
       if (cmd.findOption("--no-check-move")) opt_checkMoveIdentifier = OFFalse;
       cmd.endOptionBlock();
+      if (cmd.findOption("--key-index")) opt_useKeyIndex = OFTrue;
       cmd.beginOptionBlock();
       if (cmd.findOption("--move-unrestricted"))
       {
@@ -713,7 +717,7 @@ main(int argc, char *argv[])
     DcmQueryRetrieveSQLDatabaseHandleFactory factory;
 #else
     // use linear index database (index.dat)
-    DcmQueryRetrieveIndexDatabaseHandleFactory factory(&config);
+    DcmQueryRetrieveIndexDatabaseHandleFactory factory(&config, opt_useKeyIndex);
 #endif
 
     DcmQueryRetrieveSCP scp(config, options, factory);
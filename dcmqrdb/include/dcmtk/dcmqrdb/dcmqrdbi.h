@@ -37,6 +37,7 @@ struct DB_ElementList;
 class DcmQueryRetrieveConfig;
 
 #define DBINDEXFILE "index.dat"
+#define DBKEYINDEXFILE "index.key"
 
 #ifndef _WIN32
 /* we lock image files on all platforms except Win32 where it does not work
@@ -263,6 +264,19 @@ public:
    */
   void enableQuotaSystem(OFBool enable);
 
+  /** enable/disable the key index (default: disabled). The key index file
+   *  (index.key) maps Patient ID, Accession Number, Study Date and Study,
+   *  Series and SOP Instance UID to the records of the index file, so that
+   *  queries and retrievals with a single value for one of these keys (or a
+   *  closed range of study dates) only read the matching records instead of
+   *  scanning the complete index file. Enabling creates the key index file
+   *  if necessary, disabling deletes it. Once created, the key index file
+   *  is used and maintained by all handles for the same storage area.
+   *  @param enable OFTrue to create the key index, OFFalse to delete it
+   *  @return EC_Normal upon normal completion, or some other OFCondition code upon failure.
+   */
+  OFCondition enableKeyIndex(OFBool enable);
+
   /** dump database index file to stdout.
    *  @param storeArea name of storage area, must not be NULL
    */
@@ -414,8 +428,11 @@ public:
 
   /** constructor
    *  @param config system configuration object, must not be NULL.
+   *  @param useKeyIndex if true, create handles using the key index file
+   *    (index.key) for the lookup of unique keys, see
+   *    DcmQueryRetrieveIndexDatabaseHandle::enableKeyIndex()
    */
-  DcmQueryRetrieveIndexDatabaseHandleFactory(const DcmQueryRetrieveConfig *config);
+  DcmQueryRetrieveIndexDatabaseHandleFactory(const DcmQueryRetrieveConfig *config, OFBool useKeyIndex = OFFalse);
 
   /// destructor
   virtual ~DcmQueryRetrieveIndexDatabaseHandleFactory();
@@ -437,6 +454,9 @@ private:
 
   /// pointer to system configuration
   const DcmQueryRetrieveConfig *config_;
+
+  /// flag indicating whether created handles use the key index
+  OFBool useKeyIndex_;
 };
 
 #endif
@@ -176,6 +176,90 @@ struct DCMTK_DCMQRDB_EXPORT DB_UidList
     char *serie ;
     char *image ;
     struct DB_UidList *next ;
+    /// pointer to next entry in the same bucket of the UID hash table
+    struct DB_UidList *hashNext ;
+};
+
+/** this struct describes a single-valued key of the current request that
+ *  can only match index records with an identical value. Such keys allow
+ *  for ruling out index records by a simple string comparison, without
+ *  copying the record and applying the full matching rules.
+ */
+struct DCMTK_DCMQRDB_EXPORT DB_KeyFilter
+{
+    /// byte offset of the value field within an IdxRecord
+    size_t offset ;
+    /// size of the value field within an IdxRecord in bytes
+    size_t fieldSize ;
+    /// value to be compared, without leading and trailing spaces
+    char *value ;
+    /// pointer to next in list
+    struct DB_KeyFilter *next ;
+};
+
+/// number of buckets of the hash table used for the UID found list
+#define DB_UIDHASHSIZE 4096
+
+/* the following constants identify the keys that are maintained
+ * in the key index file. Higher numbers denote more selective keys.
+ * The value 0 marks an unused entry of the key index hash table,
+ * the value -1 marks an entry that has been deleted.
+ */
+
+#define DB_KEYIDX_StudyDate         1
+#define DB_KEYIDX_PatientID         2
+#define DB_KEYIDX_AccessionNumber   3
+#define DB_KEYIDX_StudyInstanceUID  4
+#define DB_KEYIDX_SeriesInstanceUID 5
+#define DB_KEYIDX_SOPInstanceUID    6
+
+#define DB_KEYIDX_NBKEYS            6
+
+/** this struct defines the header of the key index file ("index.key").
+ *  The key index file maps the values of the keys listed above to the
+ *  Index records of the index.dat file containing them. It consists of
+ *  this header, followed by an open addressing hash table of
+ *  DB_KeyIndexEntry structs and an array of DB_KeyIndexLink structs, one
+ *  per Index record and key. A key index file is only valid if the
+ *  size and modification time stored in the header match the index.dat file.
+ *  Study dates are stored per day (YYYYMMDD), dates in any other format share
+ *  a single list, so that date ranges can be looked up day by day.
+ */
+struct DCMTK_DCMQRDB_EXPORT DB_KeyIndexHeader
+{
+    /// magic word identifying the key index file
+    char magic [8] ;
+    /// size of the index.dat file described by this key index, -1 while being modified
+    long indexSize ;
+    /// modification time of the index.dat file described by this key index
+    long indexTime ;
+    /// number of entries of the hash table, always a power of two
+    int bucketCount ;
+    /// number of hash table entries in use or deleted
+    int usedCount ;
+};
+
+/** this struct defines an entry of the hash table of the key index file.
+ *  Each entry refers to the list of Index records sharing a key value.
+ */
+struct DCMTK_DCMQRDB_EXPORT DB_KeyIndexEntry
+{
+    /// hash value of key and key value
+    Uint32 hash ;
+    /// key (DB_KEYIDX_...), 0 if unused, -1 if deleted
+    int key ;
+    /// index of the first Index record of the list plus one
+    int head ;
+};
+
+/** this struct links the Index records sharing a key value in the key index file
+ */
+struct DCMTK_DCMQRDB_EXPORT DB_KeyIndexLink
+{
+    /// index of the previous Index record plus one, 0 if none
+    int prev ;
+    /// index of the next Index record plus one, 0 if none
+    int next ;
 };
 
 struct DCMTK_DCMQRDB_EXPORT DB_CounterList
@@ -211,6 +295,18 @@ struct DCMTK_DCMQRDB_EXPORT DB_Private_Handle
     int NumberRemainOperations ;
     DB_QUERY_CLASS rootLevel ;
     DB_UidList *uidList ;
+    DB_UidList **uidHash ;
+    DB_KeyFilter *keyFilter ;
+    char *idxMap ;
+    size_t idxMapSize ;
+    char keyIndexFilename[DBC_MAXSTRING+1] ;
+    int kidx ;
+    OFBool useKeyIndex ;
+    OFBool keyIndexModified ;
+    DB_KeyIndexHeader keyIndexHeader ;
+    int *candidates ;
+    int candidateCount ;
+    int candidatePos ;
 
     DB_Private_Handle()
     : pidx(0)
@@ -226,6 +322,18 @@ struct DCMTK_DCMQRDB_EXPORT DB_Private_Handle
     , NumberRemainOperations(0)
     , rootLevel(STUDY_ROOT)
     , uidList(NULL)
+    , uidHash(NULL)
+    , keyFilter(NULL)
+    , idxMap(NULL)
+    , idxMapSize(0)
+//  , keyIndexFilename()
+    , kidx(-1)
+    , useKeyIndex(OFFalse)
+    , keyIndexModified(OFFalse)
+    , keyIndexHeader()
+    , candidates(NULL)
+    , candidateCount(-1)
+    , candidatePos(0)
     {
     }
 };
@@ -32,6 +32,9 @@ BEGIN_EXTERN_C
 #ifdef HAVE_SYS_PARAM_H
 #include <sys/param.h>
 #endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 END_EXTERN_C
 
 #define INCLUDE_CCTYPE
@@ -119,6 +122,35 @@ static char *DB_strdup(const char* str)
     return s;
 }
 
+/************
+**      Compute the hash table bucket of an Index Record
+**      from the UID of the query level
+ */
+
+static unsigned long DB_UIDHash (
+                DB_Private_Handle       *phandle,
+                const char              *patient,
+                const char              *study,
+                const char              *serie,
+                const char              *image
+                )
+{
+    const char *uid = patient ;
+    unsigned long hash = 5381 ;
+
+    switch (phandle->queryLevel) {
+    case STUDY_LEVEL : uid = study ; break ;
+    case SERIE_LEVEL : uid = serie ; break ;
+    case IMAGE_LEVEL : uid = image ; break ;
+    default : break ;
+    }
+    if (uid) {
+        for ( ; *uid ; uid++)
+            hash = hash * 33 + (unsigned char) *uid ;
+    }
+    return hash % DB_UIDHASHSIZE ;
+}
+
 /************
 **      Add UID in Index Record to the UID found list
  */
@@ -129,6 +161,15 @@ static void DB_UIDAddFound (
                 )
 {
     DB_UidList *plist ;
+    unsigned long bucket ;
+
+    if (phandle->uidHash == NULL) {
+        phandle->uidHash = (DB_UidList **) calloc (DB_UIDHASHSIZE, sizeof (DB_UidList *)) ;
+        if (phandle->uidHash == NULL) {
+            DCMQRDB_ERROR("DB_UIDAddFound: out of memory");
+            return;
+        }
+    }
 
     plist = (DB_UidList *) malloc (sizeof (DB_UidList)) ;
     if (plist == NULL) {
@@ -151,6 +192,13 @@ static void DB_UIDAddFound (
         plist->image = DB_strdup ((char *) idxRec->SOPInstanceUID) ;
 
     phandle->uidList = plist ;
+
+    /*** Also enter the UIDs into the hash table
+    **/
+
+    bucket = DB_UIDHash (phandle, plist->patient, plist->study, plist->serie, plist->image) ;
+    plist->hashNext = phandle->uidHash [bucket] ;
+    phandle->uidHash [bucket] = plist ;
 }
 
 
@@ -165,7 +213,15 @@ static int DB_UIDAlreadyFound (
 {
     DB_UidList *plist ;
 
-    for (plist = phandle->uidList ; plist ; plist = plist->next) {
+    if (phandle->uidHash == NULL)
+        return (OFFalse) ;
+
+    /*** Only the UIDs in the same bucket of the hash table need to be compared
+    **/
+
+    plist = phandle->uidHash [DB_UIDHash (phandle, idxRec->PatientID, idxRec->StudyInstanceUID,
+                                          idxRec->SeriesInstanceUID, idxRec->SOPInstanceUID)] ;
+    for ( ; plist ; plist = plist->hashNext) {
         if (  ((int)phandle->queryLevel >= PATIENT_LEVEL)
               && (strcmp (plist->patient, (char *) idxRec->PatientID) != 0)
             )
@@ -434,25 +490,87 @@ static long DB_lseek(int fildes, long offset, int whence)
     return pos;
 }
 
+/******************************
+ *      Release the memory mapping of the index file
+ */
+
+static void DB_IdxUnmap (DB_Private_Handle *phandle)
+{
+#ifdef HAVE_SYS_MMAN_H
+    if (phandle -> idxMap)
+        munmap (phandle -> idxMap, phandle -> idxMapSize) ;
+#endif
+    phandle -> idxMap = NULL ;
+    phandle -> idxMapSize = 0 ;
+}
+
+/******************************
+ *      Map the index file into memory (read-only).
+ *      The mapping is established while the database is locked, i.e. it
+ *      always reflects a consistent state of the index file. Records appended
+ *      by this handle while holding the lock are read through read() instead.
+ *      If the index file cannot be mapped, all records are read through read().
+ */
+
+static void DB_IdxMap (DB_Private_Handle *phandle)
+{
+    DB_IdxUnmap (phandle) ;
+#ifdef HAVE_SYS_MMAN_H
+    struct stat st ;
+    if ((fstat (phandle -> pidx, &st) == 0) && (st.st_size > (off_t) SIZEOF_STUDYDESC)) {
+        void *data = mmap (NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, phandle -> pidx, 0) ;
+        if (data != MAP_FAILED) {
+            phandle -> idxMap = (char *) data ;
+            phandle -> idxMapSize = (size_t) st.st_size ;
+        }
+    }
+#endif
+}
+
+/******************************
+ *      Get a pointer to an Index record in the memory mapped index file.
+ *      Returns NULL if the record is not mapped.
+ */
+
+static const IdxRecord *DB_IdxMapped (DB_Private_Handle *phandle, int idx)
+{
+    if (phandle -> idxMap && (idx >= 0)) {
+        size_t offset = SIZEOF_STUDYDESC + (size_t) idx * SIZEOF_IDXRECORD ;
+        if (offset + SIZEOF_IDXRECORD <= phandle -> idxMapSize)
+            return (const IdxRecord *) (phandle -> idxMap + offset) ;
+    }
+    return NULL ;
+}
+
 /******************************
  *      Read an Index record
  */
 
-OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxRead (int idx, IdxRecord *idxRec)
+static OFCondition DB_IdxReadRecord (DB_Private_Handle *phandle, int idx, IdxRecord *idxRec)
 {
 
+    /*** Use the memory mapped index file if possible
+    **/
+
+    const IdxRecord *mapped = DB_IdxMapped (phandle, idx) ;
+    if (mapped) {
+        memcpy ((char *) idxRec, (const char *) mapped, SIZEOF_IDXRECORD) ;
+        DB_IdxInitRecord (idxRec, 1) ;
+        return EC_Normal ;
+    }
+
     /*** Goto the right index in file
     **/
 
-    DB_lseek (handle_ -> pidx, (long) (SIZEOF_STUDYDESC + idx * SIZEOF_IDXRECORD), SEEK_SET) ;
+    DB_lseek (phandle -> pidx, (long) (SIZEOF_STUDYDESC + idx * SIZEOF_IDXRECORD), SEEK_SET) ;
 
     /*** Read the record
     **/
 
-    if (read (handle_ -> pidx, (char *) idxRec, SIZEOF_IDXRECORD) != SIZEOF_IDXRECORD)
+    if (read (phandle -> pidx, (char *) idxRec, SIZEOF_IDXRECORD) != SIZEOF_IDXRECORD)
         return (QR_EC_IndexDatabaseError) ;
 
-    DB_lseek (handle_ -> pidx, 0L, SEEK_SET) ;
+    DB_lseek (phandle -> pidx, 0L, SEEK_SET) ;
 
     /*** Initialize record links
     **/
@@ -461,6 +579,595 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxRead (int idx, IdxRecord
     return EC_Normal ;
 }
 
+OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxRead (int idx, IdxRecord *idxRec)
+{
+    return DB_IdxReadRecord (handle_, idx, idxRec) ;
+}
+
+/******************************
+ *      Determine the value of a field of an Index record, i.e. the
+ *      characters up to the first null byte, without leading and
+ *      trailing spaces unless STRICT_COMPARE is defined.
+ */
+
+static void DB_TrimField (const char *field, size_t fieldSize, size_t *start, size_t *end)
+{
+    for (*end = 0 ; (*end < fieldSize) && (field [*end] != '\0') ; (*end)++)  /* loop with empty body */;
+#ifdef STRICT_COMPARE
+    *start = 0 ;
+#else
+    for (*start = 0 ; (*start < *end) && (field [*start] == ' ') ; (*start)++)  /* loop with empty body */;
+    while ((*end > *start) && (field [*end - 1] == ' '))
+        (*end)-- ;
+#endif
+}
+
+/******************************
+ *      Key index file
+ *
+ *      The key index file maps the values of the keys DB_KEYIDX_... to the
+ *      Index records containing them. Each distinct value of a key owns an
+ *      entry of an open addressing hash table, which refers to a doubly
+ *      linked list of the Index records with this value. Looking up, adding
+ *      and removing a record thus only accesses a few entries of the key
+ *      index file, independent of the number of records in the database.
+ *      Records found through the key index are always checked against the
+ *      key filter, i.e. hash collisions only cost time.
+ *
+ *      Study dates are maintained per day, i.e. for dates in the format
+ *      YYYYMMDD. Dates in any other format share a single entry. A date
+ *      range is looked up day by day, plus the dates in other formats.
+ *
+ *      The key index file is only accessed while the database is locked.
+ *      An exclusive lock marks it as being modified, the following unlock
+ *      stores size and modification time of the index file in its header.
+ *      A key index not matching the index file is ignored while the
+ *      database is locked for reading and rebuilt by the next exclusive lock.
+ */
+
+static const char DB_KeyIdxMagic [8] = { 'D', 'C', 'M', 'Q', 'R', 'K', 'I', '2' } ;
+
+/* number of hash table entries read at once */
+#define DB_KEYIDX_BLOCKSIZE 64
+
+/* maximum number of years of a date range looked up day by day */
+#define DB_KEYIDX_MAXDATEYEARS 10
+
+static void DB_RemoveSpaces (char *string) ;
+
+/* get the value field of a key within an Index record */
+static const char *DB_KeyIdxField (const IdxRecord *idxRec, int key, size_t *fieldSize)
+{
+    switch (key) {
+        case DB_KEYIDX_StudyDate:
+            *fieldSize = sizeof (idxRec -> StudyDate) ;
+            return idxRec -> StudyDate ;
+        case DB_KEYIDX_PatientID:
+            *fieldSize = sizeof (idxRec -> PatientID) ;
+            return idxRec -> PatientID ;
+        case DB_KEYIDX_AccessionNumber:
+            *fieldSize = sizeof (idxRec -> AccessionNumber) ;
+            return idxRec -> AccessionNumber ;
+        case DB_KEYIDX_StudyInstanceUID:
+            *fieldSize = sizeof (idxRec -> StudyInstanceUID) ;
+            return idxRec -> StudyInstanceUID ;
+        case DB_KEYIDX_SeriesInstanceUID:
+            *fieldSize = sizeof (idxRec -> SeriesInstanceUID) ;
+            return idxRec -> SeriesInstanceUID ;
+        case DB_KEYIDX_SOPInstanceUID:
+            *fieldSize = sizeof (idxRec -> SOPInstanceUID) ;
+            return idxRec -> SOPInstanceUID ;
+    }
+    *fieldSize = 0 ;
+    return NULL ;
+}
+
+/* compute the hash value of a key value (32-bit FNV-1a) */
+static Uint32 DB_KeyIdxHash (int key, const char *value, size_t length)
+{
+    Uint32 hash = 2166136261UL ;
+    hash = (hash ^ (Uint32) key) * 16777619UL ;
+    for (size_t i = 0 ; i < length ; i++)
+        hash = (hash ^ (Uint32) (unsigned char) value [i]) * 16777619UL ;
+    return hash ;
+}
+
+/* get the day of a date without spaces as a number YYYYMMDD.
+ * Returns 0 if the date has another format.
+ */
+static long DB_KeyIdxDateDay (const char *date)
+{
+    long day = 0 ;
+
+    for (int i = 0 ; i < 8 ; i++) {
+        if ((date [i] < '0') || (date [i] > '9'))
+            return 0 ;
+        day = day * 10 + (date [i] - '0') ;
+    }
+    if ((date [8] != '\0') || (day % 100 < 1) || (day % 100 > 31) || (day / 100 % 100 < 1) || (day / 100 % 100 > 12))
+        return 0 ;
+    return day ;
+}
+
+/* compute the hash value of a date without spaces.
+ * All dates not in the format YYYYMMDD have the same hash value.
+ */
+static Uint32 DB_KeyIdxDateHash (const char *date)
+{
+    return DB_KeyIdxHash (DB_KEYIDX_StudyDate, date, (DB_KeyIdxDateDay (date) > 0) ? 8 : 0) ;
+}
+
+/* compute the hash value of a key within an Index record.
+ * Returns OFFalse if the record has an empty value for this key.
+ */
+static OFBool DB_KeyIdxRecordHash (const IdxRecord *idxRec, int key, Uint32 *hash)
+{
+    size_t fieldSize ;
+    size_t start ;
+    size_t end ;
+    const char *field = DB_KeyIdxField (idxRec, key, &fieldSize) ;
+
+    /*** Dates are compared without any spaces, see matchDate()
+    **/
+
+    if (key == DB_KEYIDX_StudyDate) {
+        char date [DA_MAX_LENGTH+1] ;
+        strncpy (date, field, sizeof (date) - 1) ;
+        date [sizeof (date) - 1] = '\0' ;
+        DB_RemoveSpaces (date) ;
+        if (date [0] == '\0')
+            return OFFalse ;
+        *hash = DB_KeyIdxDateHash (date) ;
+        return OFTrue ;
+    }
+
+    DB_TrimField (field, fieldSize, &start, &end) ;
+    if (start == end)
+        return OFFalse ;
+    *hash = DB_KeyIdxHash (key, field + start, end - start) ;
+    return OFTrue ;
+}
+
+/* read or write a part of the key index file */
+static OFBool DB_KeyIdxIO (DB_Private_Handle *phandle, long offset, void *buffer, size_t length, OFBool doWrite)
+{
+    if (lseek (phandle -> kidx, offset, SEEK_SET) != offset)
+        return OFFalse ;
+    if (doWrite)
+        return (size_t) write (phandle -> kidx, (char *) buffer, length) == length ;
+    return (size_t) read (phandle -> kidx, (char *) buffer, length) == length ;
+}
+
+/* get the position of a hash table entry in the key index file */
+static long DB_KeyIdxEntryOffset (int slot)
+{
+    return (long) sizeof (DB_KeyIndexHeader) + (long) slot * (long) sizeof (DB_KeyIndexEntry) ;
+}
+
+/* get the position of the link of an Index record for a key in the key index file */
+static long DB_KeyIdxLinkOffset (DB_Private_Handle *phandle, int idx, int key)
+{
+    return DB_KeyIdxEntryOffset (phandle -> keyIndexHeader. bucketCount)
+        + ((long) idx * DB_KEYIDX_NBKEYS + key - 1) * (long) sizeof (DB_KeyIndexLink) ;
+}
+
+/* search the hash table entry of a key value.
+ * Returns 1 and the entry and its slot if found. Otherwise, returns 0 and the
+ * first unused slot in freeSlot (-1 if the table is full), or -1 on read errors.
+ */
+static int DB_KeyIdxFind (DB_Private_Handle *phandle, int key, Uint32 hash, int *slot, DB_KeyIndexEntry *entry, int *freeSlot)
+{
+    DB_KeyIndexEntry block [DB_KEYIDX_BLOCKSIZE] ;
+    const int bucketCount = phandle -> keyIndexHeader. bucketCount ;
+    int pos = (int) (hash & (Uint32) (bucketCount - 1)) ;
+    int count = 0 ;
+    int i = 0 ;
+
+    *freeSlot = -1 ;
+    for (int probe = 0 ; probe < bucketCount ; probe++) {
+
+        /*** Read the entries in blocks, up to the end of the table
+        **/
+
+        if (i == count) {
+            count = bucketCount - pos ;
+            if (count > DB_KEYIDX_BLOCKSIZE)
+                count = DB_KEYIDX_BLOCKSIZE ;
+            if (!DB_KeyIdxIO (phandle, DB_KeyIdxEntryOffset (pos), block, count * sizeof (DB_KeyIndexEntry), OFFalse))
+                return -1 ;
+            i = 0 ;
+        }
+        if (block [i]. key == 0) {
+            *freeSlot = pos ;
+            return 0 ;
+        }
+        if ((block [i]. key == key) && (block [i]. hash == hash)) {
+            *slot = pos ;
+            *entry = block [i] ;
+            return 1 ;
+        }
+        i++ ;
+        pos = (pos + 1) & (bucketCount - 1) ;
+        if (pos == 0)
+            count = i ;     /* continue at the start of the table */
+    }
+    return 0 ;
+}
+
+/* add the keys of an Index record to the key index.
+ * Returns OFFalse if the key index could not be updated, e.g. because
+ * its hash table is full. In this case, the key index must be rebuilt.
+ */
+static OFBool DB_KeyIdxInsert (DB_Private_Handle *phandle, int idx, const IdxRecord *idxRec)
+{
+    DB_KeyIndexHeader *header = &(phandle -> keyIndexHeader) ;
+    DB_KeyIndexEntry entry ;
+    DB_KeyIndexLink link ;
+    DB_KeyIndexLink head ;
+    Uint32      hash ;
+    int         slot ;
+    int         freeSlot ;
+    long        offset ;
+
+    for (int key = 1 ; key <= DB_KEYIDX_NBKEYS ; key++) {
+        if (!DB_KeyIdxRecordHash (idxRec, key, &hash))
+            continue ;
+        int found = DB_KeyIdxFind (phandle, key, hash, &slot, &entry, &freeSlot) ;
+        if (found < 0)
+            return OFFalse ;
+        link. prev = 0 ;
+        if (found) {
+
+            /*** Prepend the record to the list of records with this value
+            **/
+
+            offset = DB_KeyIdxLinkOffset (phandle, entry. head - 1, key) ;
+            if (!DB_KeyIdxIO (phandle, offset, &head, sizeof (head), OFFalse))
+                return OFFalse ;
+            head. prev = idx + 1 ;
+            if (!DB_KeyIdxIO (phandle, offset, &head, sizeof (head), OFTrue))
+                return OFFalse ;
+            link. next = entry. head ;
+        } else {
+
+            /*** Use a new entry, keeping at least a quarter of the table unused
+            **/
+
+            if ((freeSlot < 0) || (4 * (header -> usedCount + 1) > 3 * header -> bucketCount))
+                return OFFalse ;
+            slot = freeSlot ;
+            entry. hash = hash ;
+            entry. key = key ;
+            header -> usedCount++ ;
+            link. next = 0 ;
+        }
+        entry. head = idx + 1 ;
+        if (!DB_KeyIdxIO (phandle, DB_KeyIdxLinkOffset (phandle, idx, key), &link, sizeof (link), OFTrue) ||
+            !DB_KeyIdxIO (phandle, DB_KeyIdxEntryOffset (slot), &entry, sizeof (entry), OFTrue))
+            return OFFalse ;
+    }
+    return OFTrue ;
+}
+
+/* remove the keys of an Index record from the key index.
+ * Returns OFFalse if the key index could not be updated.
+ */
+static OFBool DB_KeyIdxRemove (DB_Private_Handle *phandle, int idx, const IdxRecord *idxRec)
+{
+    DB_KeyIndexEntry entry ;
+    DB_KeyIndexLink link ;
+    DB_KeyIndexLink other ;
+    Uint32      hash ;
+    int         slot ;
+    int         freeSlot ;
+    long        offset ;
+
+    for (int key = 1 ; key <= DB_KEYIDX_NBKEYS ; key++) {
+        if (!DB_KeyIdxRecordHash (idxRec, key, &hash))
+            continue ;
+        if (!DB_KeyIdxIO (phandle, DB_KeyIdxLinkOffset (phandle, idx, key), &link, sizeof (link), OFFalse))
+            return OFFalse ;
+        if (link. prev > 0) {
+            offset = DB_KeyIdxLinkOffset (phandle, link. prev - 1, key) ;
+            if (!DB_KeyIdxIO (phandle, offset, &other, sizeof (other), OFFalse))
+                return OFFalse ;
+            other. next = link. next ;
+            if (!DB_KeyIdxIO (phandle, offset, &other, sizeof (other), OFTrue))
+                return OFFalse ;
+        } else {
+
+            /*** The record is the first one of the list, update the hash table entry.
+            *** Entries of values without records are marked as deleted.
+            **/
+
+            if ((DB_KeyIdxFind (phandle, key, hash, &slot, &entry, &freeSlot) <= 0) || (entry. head != idx + 1))
+                return OFFalse ;
+            entry. head = link. next ;
+            if (entry. head == 0)
+                entry. key = -1 ;
+            if (!DB_KeyIdxIO (phandle, DB_KeyIdxEntryOffset (slot), &entry, sizeof (entry), OFTrue))
+                return OFFalse ;
+        }
+        if (link. next > 0) {
+            offset = DB_KeyIdxLinkOffset (phandle, link. next - 1, key) ;
+            if (!DB_KeyIdxIO (phandle, offset, &other, sizeof (other), OFFalse))
+                return OFFalse ;
+            other. prev = link. prev ;
+            if (!DB_KeyIdxIO (phandle, offset, &other, sizeof (other), OFTrue))
+                return OFFalse ;
+        }
+    }
+    return OFTrue ;
+}
+
+static int DB_KeyIdxCompare (const void *a, const void *b)
+{
+    return *(const int *) a - *(const int *) b ;
+}
+
+/* get the maximum number of Index records, i.e. the maximum length of the
+ * lists of the key index. Returns -1 if the index file cannot be accessed.
+ */
+static long DB_KeyIdxMaxRecords (DB_Private_Handle *phandle)
+{
+    struct stat st ;
+
+    if (fstat (phandle -> pidx, &st) != 0)
+        return -1 ;
+    return ((long) st. st_size - (long) SIZEOF_STUDYDESC) / (long) SIZEOF_IDXRECORD ;
+}
+
+/* append the numbers of the Index records having the given hash value for
+ * a key to an array of records allocated with malloc(). Returns OFFalse if
+ * the key index could not be read.
+ */
+static OFBool DB_KeyIdxAppend (DB_Private_Handle *phandle, int key, Uint32 hash, long maxCount, int **records, int *count, int *capacity)
+{
+    DB_KeyIndexEntry entry ;
+    DB_KeyIndexLink link ;
+    int         slot ;
+    int         freeSlot ;
+    int         next ;
+    int         found ;
+
+    found = DB_KeyIdxFind (phandle, key, hash, &slot, &entry, &freeSlot) ;
+    if (found < 0)
+        return OFFalse ;
+
+    /*** A list longer than the index file can only result from a damaged key index
+    **/
+
+    for (next = (found > 0) ? entry. head : 0 ; next > 0 ; next = link. next) {
+        if (*count == *capacity) {
+            int *enlarged = NULL ;
+            if (*capacity < maxCount) {
+                *capacity = (*capacity == 0) ? 16 : 2 * (*capacity) ;
+                enlarged = (int *) realloc (*records, (*capacity) * sizeof (int)) ;
+            }
+            if (enlarged == NULL)
+                return OFFalse ;
+            *records = enlarged ;
+        }
+        (*records) [(*count)++] = next - 1 ;
+        if (!DB_KeyIdxIO (phandle, DB_KeyIdxLinkOffset (phandle, next - 1, key), &link, sizeof (link), OFFalse))
+            return OFFalse ;
+    }
+    return OFTrue ;
+}
+
+/* finish a look up in the key index. Sorts the records found or frees them
+ * if the look up failed.
+ */
+static OFBool DB_KeyIdxFinishLookup (OFBool result, int **records, int *count)
+{
+    if (result)
+        qsort (*records, *count, sizeof (int), DB_KeyIdxCompare) ;
+    else {
+        free (*records) ;
+        *records = NULL ;
+        *count = 0 ;
+    }
+    return result ;
+}
+
+/* look up the Index records having the given value for a key.
+ * On success, returns OFTrue and the numbers of the records in ascending
+ * order in a newly allocated array. Returns OFFalse if the key index
+ * could not be read.
+ */
+static OFBool DB_KeyIdxLookup (DB_Private_Handle *phandle, int key, const char *value, size_t length, int **records, int *count)
+{
+    int         capacity = 0 ;
+    long        maxCount = DB_KeyIdxMaxRecords (phandle) ;
+
+    *records = NULL ;
+    *count = 0 ;
+    return DB_KeyIdxFinishLookup ((maxCount >= 0) &&
+        DB_KeyIdxAppend (phandle, key, DB_KeyIdxHash (key, value, length), maxCount, records, count, &capacity),
+        records, count) ;
+}
+
+/* look up the Index records which may match a study date or date range
+ * (see matchDate()). A single date is looked up like any other key. For a
+ * date range, each day of the range is looked up, and all dates not in the
+ * format YYYYMMDD. Returns OFFalse if the key index cannot be used for
+ * this value, i.e. for open ranges and ranges of more than
+ * DB_KEYIDX_MAXDATEYEARS years, or if the key index could not be read.
+ */
+static OFBool DB_KeyIdxLookupDate (DB_Private_Handle *phandle, const char *value, size_t length, int **records, int *count)
+{
+    char        date [DBC_MAXSTRING+1] ;
+    char        buf [16] ;
+    char        *separator ;
+    int         capacity = 0 ;
+    long        maxCount = DB_KeyIdxMaxRecords (phandle) ;
+    long        first ;
+    long        last ;
+    OFBool      result ;
+
+    *records = NULL ;
+    *count = 0 ;
+    if ((length >= sizeof (date)) || (maxCount < 0))
+        return OFFalse ;
+    memcpy (date, value, length) ;
+    date [length] = '\0' ;
+    DB_RemoveSpaces (date) ;
+    if ((date [0] == '\0') || (strchr (date, '\\') != NULL))
+        return OFFalse ;
+
+    separator = strchr (date, '-') ;
+    if (separator == NULL)
+        return DB_KeyIdxFinishLookup (DB_KeyIdxAppend (phandle, DB_KEYIDX_StudyDate, DB_KeyIdxDateHash (date),
+            maxCount, records, count, &capacity), records, count) ;
+
+    *separator = '\0' ;
+    first = DB_KeyIdxDateDay (date) ;
+    last = DB_KeyIdxDateDay (separator + 1) ;
+    if ((first == 0) || (last == 0) || (last / 10000 - first / 10000 >= DB_KEYIDX_MAXDATEYEARS))
+        return OFFalse ;
+    result = DB_KeyIdxAppend (phandle, DB_KEYIDX_StudyDate, DB_KeyIdxDateHash (""), maxCount, records, count, &capacity) ;
+    for (long year = first / 10000 ; result && (year <= last / 10000) ; year++) {
+        for (long month = 1 ; result && (month <= 12) ; month++) {
+            for (long day = year * 10000 + month * 100 + 1 ; result && (day <= year * 10000 + month * 100 + 31) ; day++) {
+                if ((day < first) || (day > last))
+                    continue ;
+                sprintf (buf, "%08ld", day) ;
+                result = DB_KeyIdxAppend (phandle, DB_KEYIDX_StudyDate, DB_KeyIdxDateHash (buf), maxCount, records, count, &capacity) ;
+            }
+        }
+    }
+    return DB_KeyIdxFinishLookup (result, records, count) ;
+}
+
+/* close the key index file. If it has been modified, store size and
+ * modification time of the index file in its header, which makes it valid.
+ */
+static void DB_KeyIdxClose (DB_Private_Handle *phandle)
+{
+    struct stat st ;
+
+    if (phandle -> kidx < 0)
+        return ;
+    if (phandle -> keyIndexModified && (fstat (phandle -> pidx, &st) == 0)) {
+        phandle -> keyIndexHeader. indexSize = (long) st. st_size ;
+        phandle -> keyIndexHeader. indexTime = (long) st. st_mtime ;
+        DB_KeyIdxIO (phandle, 0L, &(phandle -> keyIndexHeader), sizeof (DB_KeyIndexHeader), OFTrue) ;
+    }
+    close (phandle -> kidx) ;
+    phandle -> kidx = -1 ;
+    phandle -> keyIndexModified = OFFalse ;
+}
+
+/* stop using the key index, e.g. after a failed update.
+ * A key index being modified remains invalid.
+ */
+static void DB_KeyIdxDiscard (DB_Private_Handle *phandle)
+{
+    phandle -> keyIndexModified = OFFalse ;
+    DB_KeyIdxClose (phandle) ;
+}
+
+/* create the key index file from the records of the index file */
+static OFBool DB_KeyIdxRebuild (DB_Private_Handle *phandle)
+{
+    DB_KeyIndexEntry block [DB_KEYIDX_BLOCKSIZE] ;
+    DB_KeyIndexHeader *header = &(phandle -> keyIndexHeader) ;
+    IdxRecord   idxRec ;
+    struct stat st ;
+    OFBool      result = OFTrue ;
+    long        records = 0 ;
+    int         slot ;
+    int         idx ;
+
+    DCMQRDB_DEBUG("creating key index file " << phandle -> keyIndexFilename) ;
+    DB_KeyIdxDiscard (phandle) ;
+#ifdef O_BINARY
+    phandle -> kidx = open (phandle -> keyIndexFilename, O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0666) ;
+#else
+    phandle -> kidx = open (phandle -> keyIndexFilename, O_RDWR | O_CREAT | O_TRUNC, 0666) ;
+#endif
+    if (phandle -> kidx < 0) {
+        char buf[256];
+        DCMQRDB_WARN(phandle -> keyIndexFilename << ": " << OFStandard::strerror(errno, buf, sizeof(buf)));
+        return OFFalse ;
+    }
+
+    /*** Size the hash table for at least twice the number of keys
+    *** which can be stored in the index file
+    **/
+
+    if ((fstat (phandle -> pidx, &st) == 0) && ((long) st. st_size > (long) SIZEOF_STUDYDESC))
+        records = ((long) st. st_size - (long) SIZEOF_STUDYDESC) / (long) SIZEOF_IDXRECORD ;
+    memcpy (header -> magic, DB_KeyIdxMagic, sizeof (header -> magic)) ;
+    header -> indexSize = -1 ;
+    header -> indexTime = 0 ;
+    header -> bucketCount = 1024 ;
+    while ((header -> bucketCount < 2 * DB_KEYIDX_NBKEYS * records) && (header -> bucketCount < 0x10000000))
+        header -> bucketCount *= 2 ;
+    header -> usedCount = 0 ;
+    result = DB_KeyIdxIO (phandle, 0L, header, sizeof (DB_KeyIndexHeader), OFTrue) ;
+    memset (block, 0, sizeof (block)) ;
+    for (slot = 0 ; result && (slot < header -> bucketCount) ; slot += DB_KEYIDX_BLOCKSIZE)
+        result = ((size_t) write (phandle -> kidx, (char *) block, sizeof (block)) == sizeof (block)) ;
+
+    /*** Add the keys of all records in use
+    **/
+
+    for (idx = 0 ; result && (idx < records) ; idx++) {
+        if ((DB_IdxReadRecord (phandle, idx, &idxRec) == EC_Normal) && (idxRec. filename [0] != '\0'))
+            result = DB_KeyIdxInsert (phandle, idx, &idxRec) ;
+    }
+    if (!result) {
+        DCMQRDB_WARN("cannot create key index file " << phandle -> keyIndexFilename) ;
+        DB_KeyIdxDiscard (phandle) ;
+        return OFFalse ;
+    }
+    phandle -> keyIndexModified = OFTrue ;
+    return OFTrue ;
+}
+
+/* open the key index file after locking the database.
+ * With an exclusive lock, an invalid key index is rebuilt (or created if
+ * the key index is enabled) and marked as being modified. With a shared
+ * lock, an invalid key index is not used.
+ */
+static void DB_KeyIdxOpen (DB_Private_Handle *phandle, OFBool exclusive)
+{
+    DB_KeyIndexHeader *header = &(phandle -> keyIndexHeader) ;
+    struct stat st ;
+    OFBool      valid = OFFalse ;
+
+    DB_KeyIdxDiscard (phandle) ;
+#ifdef O_BINARY
+    phandle -> kidx = open (phandle -> keyIndexFilename, O_RDWR | O_BINARY) ;
+#else
+    phandle -> kidx = open (phandle -> keyIndexFilename, O_RDWR) ;
+#endif
+    if (phandle -> kidx >= 0) {
+        valid = DB_KeyIdxIO (phandle, 0L, header, sizeof (DB_KeyIndexHeader), OFFalse)
+            && (memcmp (header -> magic, DB_KeyIdxMagic, sizeof (header -> magic)) == 0)
+            && (header -> bucketCount > 0) && ((header -> bucketCount & (header -> bucketCount - 1)) == 0)
+            && (fstat (phandle -> pidx, &st) == 0)
+            && (header -> indexSize == (long) st. st_size) && (header -> indexTime == (long) st. st_mtime) ;
+        if (!valid)
+            DCMQRDB_DEBUG("key index file " << phandle -> keyIndexFilename << " is out of date") ;
+    } else if (!phandle -> useKeyIndex)
+        return ;
+
+    if (exclusive) {
+        if (valid) {
+            DB_KeyIndexHeader modified = *header ;
+            modified. indexSize = -1 ;
+            valid = DB_KeyIdxIO (phandle, 0L, &modified, sizeof (modified), OFTrue) ;
+            phandle -> keyIndexModified = valid ;
+        }
+        if (!valid)
+            valid = DB_KeyIdxRebuild (phandle) ;
+    }
+    if (!valid)
+        DB_KeyIdxDiscard (phandle) ;
+}
+
 
 /******************************
  *      Add an Index record
@@ -478,7 +1185,14 @@ static OFCondition DB_IdxAdd (DB_Private_Handle *phandle, int *idx, IdxRecord *i
 
     *idx = 0 ;
 
-    DB_lseek (phandle -> pidx, (long) SIZEOF_STUDYDESC, SEEK_SET) ;
+    /*** Skip the records in use in the memory mapped part of the index file
+    **/
+
+    const IdxRecord *mapped ;
+    while (((mapped = DB_IdxMapped (phandle, *idx)) != NULL) && (mapped -> filename [0] != '\0'))
+        (*idx)++ ;
+
+    DB_lseek (phandle -> pidx, (long) (SIZEOF_STUDYDESC + (*idx) * SIZEOF_IDXRECORD), SEEK_SET) ;
     while (read (phandle -> pidx, (char *) &rec, SIZEOF_IDXRECORD) == SIZEOF_IDXRECORD) {
         if (rec. filename [0] == '\0')
             break ;
@@ -497,6 +1211,13 @@ static OFCondition DB_IdxAdd (DB_Private_Handle *phandle, int *idx, IdxRecord *i
 
     DB_lseek (phandle -> pidx, 0L, SEEK_SET) ;
 
+    /*** Update the key index, rebuild it if the hash table is full
+    **/
+
+    if ((cond == EC_Normal) && (phandle -> kidx >= 0) && (idxRec -> filename [0] != '\0') &&
+        !DB_KeyIdxInsert (phandle, *idx, idxRec) && !DB_KeyIdxRebuild (phandle))
+        DB_KeyIdxDiscard (phandle) ;
+
     return cond ;
 }
 
@@ -528,16 +1249,50 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxInitLoop(int *idx)
 
 /******************************
  *      Get next Index record
- *      On return, idx is initialized with the index of the record read
+ *      On return, idx is initialized with the index of the record read.
+ *      If useKeyFilter is true, records ruled out by the key filter of
+ *      the current request are skipped. If the key index provided the
+ *      candidate records for the key filter, only these are read.
  */
 
-OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxGetNext(int *idx, IdxRecord *idxRec)
+static OFBool DB_KeyFilterMatch (DB_Private_Handle *phandle, const IdxRecord *idxRec) ;
+
+static OFCondition DB_IdxGetNextRecord (DB_Private_Handle *phandle, int *idx, IdxRecord *idxRec, OFBool useKeyFilter)
 {
+    const IdxRecord *mapped ;
 
     (*idx)++ ;
-    DB_lseek (handle_ -> pidx, SIZEOF_STUDYDESC + (long)(*idx) * SIZEOF_IDXRECORD, SEEK_SET) ;
-    while (read (handle_ -> pidx, (char *) idxRec, SIZEOF_IDXRECORD) == SIZEOF_IDXRECORD) {
-        if (idxRec -> filename [0] != '\0') {
+
+    if (useKeyFilter && (phandle -> candidateCount >= 0)) {
+        while (phandle -> candidatePos < phandle -> candidateCount) {
+            int candidate = phandle -> candidates [phandle -> candidatePos++] ;
+            if (candidate < *idx)
+                continue ;
+            *idx = candidate ;
+            if ((DB_IdxReadRecord (phandle, *idx, idxRec) == EC_Normal) &&
+                (idxRec -> filename [0] != '\0') && DB_KeyFilterMatch (phandle, idxRec))
+                return EC_Normal ;
+        }
+        DB_lseek (phandle -> pidx, 0L, SEEK_SET) ;
+        return QR_EC_IndexDatabaseError ;
+    }
+
+    /*** Records in the memory mapped index file are only copied
+    *** if they are in use and not ruled out by the key filter
+    **/
+
+    while ((mapped = DB_IdxMapped (phandle, *idx)) != NULL) {
+        if ((mapped -> filename [0] != '\0') && (!useKeyFilter || DB_KeyFilterMatch (phandle, mapped))) {
+            memcpy ((char *) idxRec, (const char *) mapped, SIZEOF_IDXRECORD) ;
+            DB_IdxInitRecord (idxRec, 1) ;
+            return EC_Normal ;
+        }
+        (*idx)++ ;
+    }
+
+    DB_lseek (phandle -> pidx, SIZEOF_STUDYDESC + (long)(*idx) * SIZEOF_IDXRECORD, SEEK_SET) ;
+    while (read (phandle -> pidx, (char *) idxRec, SIZEOF_IDXRECORD) == SIZEOF_IDXRECORD) {
+        if ((idxRec -> filename [0] != '\0') && (!useKeyFilter || DB_KeyFilterMatch (phandle, idxRec))) {
             DB_IdxInitRecord (idxRec, 1) ;
 
             return EC_Normal ;
@@ -545,11 +1300,16 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxGetNext(int *idx, IdxReco
         (*idx)++ ;
     }
 
-    DB_lseek (handle_ -> pidx, 0L, SEEK_SET) ;
+    DB_lseek (phandle -> pidx, 0L, SEEK_SET) ;
 
     return QR_EC_IndexDatabaseError ;
 }
 
+OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxGetNext(int *idx, IdxRecord *idxRec)
+{
+    return DB_IdxGetNextRecord (handle_, idx, idxRec, OFFalse) ;
+}
+
 
 /******************************
  *      Get next Index record
@@ -577,7 +1337,13 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_GetStudyDesc (StudyDescRecor
 OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxRemove(int idx)
 {
     IdxRecord   rec ;
+    IdxRecord   old ;
     OFCondition cond = EC_Normal;
+    OFBool      indexed = OFFalse;
+
+    /* the keys of the record are needed for removing it from the key index */
+    if (handle_ -> kidx >= 0)
+        indexed = (DB_IdxReadRecord (handle_, idx, &old) == EC_Normal) && (old. filename [0] != '\0') ;
 
     DB_lseek (handle_ -> pidx, SIZEOF_STUDYDESC + (long)idx * SIZEOF_IDXRECORD, SEEK_SET) ;
     DB_IdxInitRecord (&rec, 0) ;
@@ -590,6 +1356,9 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxRemove(int idx)
 
     DB_lseek (handle_ -> pidx, 0L, SEEK_SET) ;
 
+    if (indexed && !DB_KeyIdxRemove (handle_, idx, &old) && !DB_KeyIdxRebuild (handle_))
+        DB_KeyIdxDiscard (handle_) ;
+
     return cond ;
 }
 
@@ -606,11 +1375,15 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_lock(OFBool exclusive)
         dcmtk_plockerr("DB_lock");
         return QR_EC_IndexDatabaseError;
     }
+    DB_IdxMap(handle_);
+    DB_KeyIdxOpen(handle_, exclusive);
     return EC_Normal;
 }
 
 OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_unlock()
 {
+    DB_KeyIdxClose(handle_);
+    DB_IdxUnmap(handle_);
     if (dcmtk_flock(handle_->pidx, LOCK_UN) < 0) {
         dcmtk_plockerr("DB_unlock");
         return QR_EC_IndexDatabaseError;
@@ -622,21 +1395,29 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_unlock()
  *    Free an element List
  */
 
-static OFCondition DB_FreeUidList (DB_UidList *lst)
+static OFCondition DB_FreeUidList (DB_Private_Handle *phandle)
 {
-    if (lst == NULL) return EC_Normal;
-
-    OFCondition cond = DB_FreeUidList (lst -> next);
-    if (lst -> patient)
-        free (lst -> patient);
-    if (lst -> study)
-        free (lst -> study);
-    if (lst -> serie)
-        free (lst -> serie);
-    if (lst -> image)
-        free (lst -> image);
-    free (lst);
-    return (cond);
+    DB_UidList *lst = phandle -> uidList;
+
+    /* iterate rather than recurse since the list may become very long */
+    while (lst != NULL) {
+        DB_UidList *next = lst -> next;
+        if (lst -> patient)
+            free (lst -> patient);
+        if (lst -> study)
+            free (lst -> study);
+        if (lst -> serie)
+            free (lst -> serie);
+        if (lst -> image)
+            free (lst -> image);
+        free (lst);
+        lst = next;
+    }
+    phandle -> uidList = NULL;
+    if (phandle -> uidHash)
+        free (phandle -> uidHash);
+    phandle -> uidHash = NULL;
+    return EC_Normal;
 }
 
 
@@ -839,6 +1620,195 @@ static void DB_RemoveEnclosingSpaces (char *string)
 }
 
 
+/*******************
+ *      Free the key filter of the current request
+ */
+
+static void DB_FreeKeyFilter (DB_Private_Handle *phandle)
+{
+    DB_KeyFilter *filter ;
+
+    while (phandle -> keyFilter) {
+        filter = phandle -> keyFilter ;
+        phandle -> keyFilter = filter -> next ;
+        free (filter -> value) ;
+        free (filter) ;
+    }
+    free (phandle -> candidates) ;
+    phandle -> candidates = NULL ;
+    phandle -> candidateCount = -1 ;
+    phandle -> candidatePos = 0 ;
+}
+
+/*******************
+ *      Add a request key to the key filter if it can only match
+ *      index records with an identical value, i.e. if the key has a
+ *      single value without wildcards and is subject to UID or string
+ *      matching (see matchUID() and matchStrings()).
+ */
+
+static void DB_AddKeyFilter (DB_Private_Handle *phandle, DB_SmallDcmElmt *elem, DB_KEY_CLASS keyClass)
+{
+    IdxRecord   tmpl ;
+    DB_KeyFilter *filter ;
+    char        *value ;
+    int         i ;
+
+    if ((elem -> ValueLength == 0) || (elem -> PValueField == NULL))
+        return ;
+    if ((keyClass != UID_CLASS) && (keyClass != STRING_CLASS))
+        return ;
+
+    /*** Find the value field of the key in the index record
+    **/
+
+    DB_IdxInitRecord (&tmpl, 0) ;
+    for (i = 0 ; i < NBPARAMETERS ; i++)
+        if (tmpl. param [i]. XTag == elem -> XTag)
+            break ;
+    if (i == NBPARAMETERS)
+        return ;
+
+    value = (char *) malloc ((size_t)(elem -> ValueLength + 1)) ;
+    if (value == NULL)
+        return ;
+    memcpy (value, elem -> PValueField, (size_t)(elem -> ValueLength)) ;
+    value [elem -> ValueLength] = '\0' ;
+#ifndef STRICT_COMPARE
+    DB_RemoveEnclosingSpaces (value) ;
+#endif
+
+    /*** Multiple values and wildcards require the full matching rules
+    **/
+
+    if ((value [0] == '\0') || (strchr (value, '\\') != NULL) ||
+        ((keyClass == STRING_CLASS) && ((strchr (value, '*') != NULL) || (strchr (value, '?') != NULL)))) {
+        free (value) ;
+        return ;
+    }
+
+    filter = (DB_KeyFilter *) malloc (sizeof (DB_KeyFilter)) ;
+    if (filter == NULL) {
+        free (value) ;
+        return ;
+    }
+    filter -> offset = (size_t) (tmpl. param [i]. PValueField - (char *) &tmpl) ;
+    filter -> fieldSize = (size_t) tmpl. param [i]. ValueLength ;
+    filter -> value = value ;
+    filter -> next = phandle -> keyFilter ;
+    phandle -> keyFilter = filter ;
+}
+
+/*******************
+ *      Create the key filter for the current request, containing all keys
+ *      of the request list which are compared by hierarchicalCompare()
+ *      when starting at level qLevel. If the key index is available, the
+ *      records matching the most selective key maintained by the key index
+ *      are looked up as candidates, or the records matching the study date
+ *      if no other key of the key index is compared.
+ */
+
+static void DB_MakeKeyFilter (DB_Private_Handle *phandle, DB_LEVEL qLevel)
+{
+    DB_ElementList *plist ;
+    DB_LEVEL    XTagLevel ;
+    DB_KEY_TYPE keyAttr ;
+    DB_KEY_CLASS keyClass ;
+    DB_SmallDcmElmt *dateKey = NULL ;
+
+    DB_FreeKeyFilter (phandle) ;
+
+    /*** Without a filter, requests lacking a unique key above the query level
+    *** are reported as an error by hierarchicalCompare()
+    **/
+
+    for (int level = qLevel ; level < phandle -> queryLevel ; level++) {
+        DcmTagKey XTag ;
+        DB_GetUIDTag ((DB_LEVEL) level, &XTag) ;
+        for (plist = phandle -> findRequestList ; plist ; plist = plist -> next)
+            if (plist -> elem. XTag == XTag)
+                break ;
+        if (plist == NULL)
+            return ;
+    }
+
+    for (plist = phandle -> findRequestList ; plist ; plist = plist -> next) {
+        if ((DB_GetTagLevel (plist -> elem. XTag, &XTagLevel) != EC_Normal) ||
+            (DB_GetTagKeyAttr (plist -> elem. XTag, &keyAttr) != EC_Normal) ||
+            (DB_GetTagKeyClass (plist -> elem. XTag, &keyClass) != EC_Normal))
+            continue ;
+
+        /** Above the query level, only the unique keys are compared.
+        ** At the query level, all keys of this level are compared, and
+        ** patient keys in case of the Study Root Information Model exception.
+        */
+
+        if (  ((XTagLevel >= qLevel) && (XTagLevel < phandle -> queryLevel) && (keyAttr == UNIQUE_KEY))
+              || (XTagLevel == phandle -> queryLevel)
+              || ((XTagLevel == PATIENT_LEVEL) && (phandle -> queryLevel == STUDY_LEVEL) && (qLevel == STUDY_LEVEL))
+            ) {
+            DB_AddKeyFilter (phandle, &(plist -> elem), keyClass) ;
+            if (plist -> elem. XTag == DCM_StudyDate)
+                dateKey = &(plist -> elem) ;
+        }
+    }
+
+    /*** The study date is only used if no other key of the key index is compared
+    **/
+
+    if (phandle -> kidx >= 0) {
+        IdxRecord   tmpl ;
+        DB_KeyFilter *filter ;
+        DB_KeyFilter *best = NULL ;
+        int         bestKey = 0 ;
+        size_t      fieldSize ;
+        OFBool      found = OFFalse ;
+
+        for (filter = phandle -> keyFilter ; filter ; filter = filter -> next) {
+            for (int key = bestKey + 1 ; key <= DB_KEYIDX_NBKEYS ; key++) {
+                if ((size_t) (DB_KeyIdxField (&tmpl, key, &fieldSize) - (char *) &tmpl) == filter -> offset) {
+                    best = filter ;
+                    bestKey = key ;
+                }
+            }
+        }
+        if (best)
+            found = DB_KeyIdxLookup (phandle, bestKey, best -> value, strlen (best -> value),
+                                     &(phandle -> candidates), &(phandle -> candidateCount)) ;
+        else if (dateKey && (dateKey -> ValueLength > 0) && dateKey -> PValueField)
+            found = DB_KeyIdxLookupDate (phandle, dateKey -> PValueField, (size_t) dateKey -> ValueLength,
+                                         &(phandle -> candidates), &(phandle -> candidateCount)) ;
+        if (found)
+            DCMQRDB_DEBUG("using key index, " << phandle -> candidateCount << " candidate records") ;
+        else
+            phandle -> candidateCount = -1 ;
+    }
+}
+
+/*******************
+ *      Check whether an Index record may match the current request.
+ *      Returns OFFalse if the record is ruled out by the key filter.
+ *      Only the value fields of the record are accessed, i.e. the record
+ *      may be located in the memory mapped index file.
+ */
+
+static OFBool DB_KeyFilterMatch (DB_Private_Handle *phandle, const IdxRecord *idxRec)
+{
+    DB_KeyFilter *filter ;
+    const char  *field ;
+    size_t      start ;
+    size_t      end ;
+
+    for (filter = phandle -> keyFilter ; filter ; filter = filter -> next) {
+        field = (const char *) idxRec + filter -> offset ;
+        DB_TrimField (field, filter -> fieldSize, &start, &end) ;
+        if ((strlen (filter -> value) != end - start) ||
+            (strncmp (filter -> value, field + start, end - start) != 0))
+            return OFFalse ;
+    }
+    return OFTrue ;
+}
+
 /*******************
  *    Convert a date YYYYMMDD in a long
  */
@@ -1782,6 +2752,7 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::startFindRequest(
 
     DB_lock(OFFalse);
 
+    DB_MakeKeyFilter (handle_, qLevel) ;
     DB_IdxInitLoop (&(handle_->idxCounter)) ;
     MatchFound = OFFalse ;
     cond = EC_Normal ;
@@ -1791,7 +2762,7 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::startFindRequest(
         /*** Exit loop if read error (or end of file)
         **/
 
-        if (DB_IdxGetNext (&(handle_->idxCounter), &idxRec) != EC_Normal)
+        if (DB_IdxGetNextRecord (handle_, &(handle_->idxCounter), &idxRec, OFTrue) != EC_Normal)
             break ;
 
         /*** Exit loop if error or matching OK
@@ -1976,7 +2947,7 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::nextFindResponse (
         /*** Exit loop if read error (or end of file)
         **/
 
-        if (DB_IdxGetNext (&(handle_->idxCounter), &idxRec) != EC_Normal)
+        if (DB_IdxGetNextRecord (handle_, &(handle_->idxCounter), &idxRec, OFTrue) != EC_Normal)
             break ;
 
         /*** If Response already found
@@ -2038,8 +3009,7 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::nextFindResponse (
         handle_->idxCounter = -1 ;
         DB_FreeElementList (handle_->findRequestList) ;
         handle_->findRequestList = NULL ;
-        DB_FreeUidList (handle_->uidList) ;
-        handle_->uidList = NULL ;
+        DB_FreeUidList (handle_) ;
     }
 
 #ifdef DEBUG
@@ -2061,8 +3031,7 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::cancelFindRequest (DcmQueryRetr
     handle_->findRequestList = NULL ;
     DB_FreeElementList (handle_->findResponseList) ;
     handle_->findResponseList = NULL ;
-    DB_FreeUidList (handle_->uidList) ;
-    handle_->uidList = NULL ;
+    DB_FreeUidList (handle_) ;
 
     status->setStatus(STATUS_FIND_Cancel_MatchingTerminatedDueToCancelRequest);
 
@@ -2385,13 +3354,14 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::startMoveRequest(
 
     DB_lock(OFFalse);
 
+    DB_MakeKeyFilter (handle_, qLevel) ;
     DB_IdxInitLoop (&(handle_->idxCounter)) ;
     while (1) {
 
         /*** Exit loop if read error (or end of file)
         **/
 
-        if (DB_IdxGetNext (&(handle_->idxCounter), &idxRec) != EC_Normal)
+        if (DB_IdxGetNextRecord (handle_, &(handle_->idxCounter), &idxRec, OFTrue) != EC_Normal)
             break ;
 
         /*** If matching found
@@ -2419,6 +3389,7 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::startMoveRequest(
 
     DB_FreeElementList (handle_->findRequestList) ;
     handle_->findRequestList = NULL ;
+    DB_FreeKeyFilter (handle_) ;
 
     /**** If a matching image has been found,
     ****    status is pending
@@ -2822,6 +3793,9 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::removeDuplicateImage(
     int idx = 0;
     IdxRecord idxRec ;
     int studyIdx = 0;
+    int *candidates = NULL;
+    int candidateCount = -1;
+    size_t start, end;
 
     studyIdx = matchStudyUIDInStudyDesc (pStudyDesc, (char*)StudyInstanceUID,
                         (int)(handle_ -> maxStudiesAllowed)) ;
@@ -2831,7 +3805,19 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::removeDuplicateImage(
     return EC_Normal;
     }
 
-    while (DB_IdxRead(idx, &idxRec) == EC_Normal) {
+    /* with the key index, only the records with this SOP Instance UID are checked */
+    DB_TrimField(SOPInstanceUID, strlen(SOPInstanceUID), &start, &end);
+    if ((handle_ -> kidx < 0) || (start == end) ||
+        !DB_KeyIdxLookup(handle_, DB_KEYIDX_SOPInstanceUID, SOPInstanceUID + start, end - start, &candidates, &candidateCount))
+        candidateCount = -1;
+
+    for (int i = 0; ; i++) {
+
+    if (candidateCount >= 0) {
+        if (i == candidateCount) break;
+        idx = candidates[i];
+    } else idx = i;
+    if (DB_IdxRead(idx, &idxRec) != EC_Normal) break;
 
     if (strcmp(idxRec.SOPInstanceUID, SOPInstanceUID) == 0) {
 
@@ -2850,8 +3836,8 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::removeDuplicateImage(
         pStudyDesc[studyIdx].NumberofRegistratedImages--;
         pStudyDesc[studyIdx].StudySize -= idxRec.ImageSize;
     }
-    idx++;
     }
+    free(candidates);
     /* the study record should be written to file later */
     return EC_Normal;
 }
@@ -3261,6 +4247,38 @@ void DcmQueryRetrieveIndexDatabaseHandle::setIdentifierChecking(OFBool checkFind
 }
 
 
+OFCondition DcmQueryRetrieveIndexDatabaseHandle::enableKeyIndex(OFBool enable)
+{
+    handle_ -> useKeyIndex = enable;
+
+    // nothing to be done if there is a valid key index already
+    OFCondition result = DB_lock(OFFalse);
+    if (result.bad()) return result;
+    OFBool valid = (handle_ -> kidx >= 0);
+    DB_unlock();
+    if (enable && valid) return EC_Normal;
+
+    // an exclusive lock creates the key index if enabled
+    result = DB_lock(OFTrue);
+    if (result.bad()) return result;
+    if (enable)
+    {
+      if (handle_ -> kidx < 0) result = QR_EC_IndexDatabaseError;
+    }
+    else
+    {
+      DB_KeyIdxDiscard(handle_);
+      if ((unlink(handle_ -> keyIndexFilename) != 0) && (errno != ENOENT))
+      {
+        char buf[256];
+        DCMQRDB_ERROR(handle_ -> keyIndexFilename << ": " << OFStandard::strerror(errno, buf, sizeof(buf)));
+        result = QR_EC_IndexDatabaseError;
+      }
+    }
+    DB_unlock();
+    return result;
+}
+
 /***********************
  *      Creates a handle
  */
@@ -3307,6 +4325,7 @@ DcmQueryRetrieveIndexDatabaseHandle::DcmQueryRetrieveIndexDatabaseHandle(
     if (handle_) {
         sprintf (handle_ -> storageArea,"%s", storageArea);
         sprintf (handle_ -> indexFilename,"%s%c%s", storageArea, PATH_SEPARATOR, DBINDEXFILE);
+        sprintf (handle_ -> keyIndexFilename,"%s%c%s", storageArea, PATH_SEPARATOR, DBKEYINDEXFILE);
 
         /* create index file if it does not already exist */
         FILE* f = fopen(handle_->indexFilename, "ab");
@@ -3363,12 +4382,15 @@ DcmQueryRetrieveIndexDatabaseHandle::~DcmQueryRetrieveIndexDatabaseHandle()
        */
       DB_unlock();
 #endif
+      DB_KeyIdxDiscard (handle_);
       close( handle_ -> pidx);
 
       /* Free lists */
       DB_FreeElementList (handle_ -> findRequestList);
       DB_FreeElementList (handle_ -> findResponseList);
-      DB_FreeUidList (handle_ -> uidList);
+      DB_FreeUidList (handle_);
+      DB_FreeKeyFilter (handle_);
+      DB_IdxUnmap (handle_);
 
       delete handle_;
     }
@@ -3446,9 +4468,10 @@ DB_SmallDcmElmt::DB_SmallDcmElmt()
 }
 
 
-DcmQueryRetrieveIndexDatabaseHandleFactory::DcmQueryRetrieveIndexDatabaseHandleFactory(const DcmQueryRetrieveConfig *config)
+DcmQueryRetrieveIndexDatabaseHandleFactory::DcmQueryRetrieveIndexDatabaseHandleFactory(const DcmQueryRetrieveConfig *config, OFBool useKeyIndex)
 : DcmQueryRetrieveDatabaseHandleFactory()
 , config_(config)
+, useKeyIndex_(useKeyIndex)
 {
 }
 
@@ -3461,8 +4484,14 @@ DcmQueryRetrieveDatabaseHandle *DcmQueryRetrieveIndexDatabaseHandleFactory::crea
     const char *calledAETitle,
     OFCondition& result) const
 {
-  return new DcmQueryRetrieveIndexDatabaseHandle(
+  DcmQueryRetrieveIndexDatabaseHandle *handle = new DcmQueryRetrieveIndexDatabaseHandle(
     config_->getStorageArea(calledAETitle),
     config_->getMaxStudies(calledAETitle),
     config_->getMaxBytesPerStudy(calledAETitle), result);
+  if (useKeyIndex_ && result.good() && handle->enableKeyIndex(OFTrue).bad())
+  {
+    // the database remains usable without the key index
+    DCMQRDB_WARN("cannot use key index for storage area " << config_->getStorageArea(calledAETitle));
+  }
+  return handle;
 }
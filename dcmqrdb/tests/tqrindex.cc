@@ -0,0 +1,370 @@
+/*
+ *
+ *  Copyright (C) 2026, agent
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *
+ *  Module:  dcmqrdb
+ *
+ *  Author:  agent
+ *
+ *  Purpose: test queries and retrievals against the index database
+ *           with and without key index
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTDIO
+#include "dcmtk/ofstd/ofstdinc.h"
+
+BEGIN_EXTERN_C
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>    /* for rmdir() */
+#endif
+END_EXTERN_C
+
+#ifdef _WIN32
+#include <direct.h>    /* for rmdir() */
+#endif
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmqrdb/dcmqrdbi.h"
+#include "dcmtk/dcmqrdb/dcmqrdbs.h"
+#include "dcmtk/dcmqrdb/dcmqridx.h"
+
+
+#define STORAGE_AREA "tqrindex.db"
+
+/* number of patients, studies per patient, series per study and images per series */
+#define NUM_PATIENTS 6
+#define NUM_STUDIES 2
+#define NUM_SERIES 2
+#define NUM_IMAGES 4
+
+static OFString makeUID(unsigned int patient, unsigned int study = 0, unsigned int series = 0, unsigned int image = 0)
+{
+    char buf[65];
+    sprintf(buf, "1.2.276.0.7230010.3.9.%u.%u.%u.%u", patient, study, series, image);
+    return buf;
+}
+
+static OFString makePatientID(unsigned int patient)
+{
+    char buf[16];
+    sprintf(buf, "PAT%u", patient);
+    return buf;
+}
+
+/* the study dates are one day apart and cross the end of a year, the last study has an old-style date */
+static const char *studyDates[NUM_PATIENTS * NUM_STUDIES] =
+{
+    "20151225", "20151226", "20151227", "20151228", "20151229", "20151230",
+    "20151231", "20160101", "20160102", "20160103", "20160104", "2016.01.05"
+};
+
+static OFString makeAccessionNumber(unsigned int patient, unsigned int study)
+{
+    char buf[16];
+    sprintf(buf, "ACC%u.%u", patient, study);
+    return buf;
+}
+
+static OFString makeFilename(const OFString& name)
+{
+    OFString result;
+    return OFStandard::combineDirAndFilename(result, STORAGE_AREA, name);
+}
+
+/* write an image and register it in the database */
+static void storeImage(DcmQueryRetrieveIndexDatabaseHandle& handle, unsigned int patient,
+    unsigned int study, unsigned int series, unsigned int image, const char *suffix = "")
+{
+    DcmFileFormat fileformat;
+    DcmDataset *dset = fileformat.getDataset();
+    const OFString sopInstanceUID = makeUID(patient, study, series, image);
+    char buf[32];
+
+    dset->putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage);
+    dset->putAndInsertString(DCM_SOPInstanceUID, sopInstanceUID.c_str());
+    dset->putAndInsertString(DCM_PatientName, ("Test^" + makePatientID(patient)).c_str());
+    dset->putAndInsertString(DCM_PatientID, makePatientID(patient).c_str());
+    dset->putAndInsertString(DCM_StudyInstanceUID, makeUID(patient, study).c_str());
+    dset->putAndInsertString(DCM_StudyDate, studyDates[patient * NUM_STUDIES + study]);
+    dset->putAndInsertString(DCM_AccessionNumber, makeAccessionNumber(patient, study).c_str());
+    dset->putAndInsertString(DCM_StudyID, "1");
+    dset->putAndInsertString(DCM_SeriesInstanceUID, makeUID(patient, study, series).c_str());
+    dset->putAndInsertString(DCM_Modality, "OT");
+    sprintf(buf, "%u", series);
+    dset->putAndInsertString(DCM_SeriesNumber, buf);
+    sprintf(buf, "%u", image);
+    dset->putAndInsertString(DCM_InstanceNumber, buf);
+
+    sprintf(buf, "img_%u_%u_%u_%u%s.dcm", patient, study, series, image, suffix);
+    const OFString filename = makeFilename(buf);
+    OFCHECK(fileformat.saveFile(filename.c_str(), EXS_LittleEndianExplicit).good());
+
+    DcmQueryRetrieveDatabaseStatus status;
+    OFCHECK(handle.storeRequest(UID_SecondaryCaptureImageStorage, sopInstanceUID.c_str(), filename.c_str(), &status).good());
+    OFCHECK_EQUAL(status.status(), STATUS_Success);
+}
+
+/* run a C-FIND and return the unique keys of all responses */
+static OFList<OFString> findRequest(DcmQueryRetrieveIndexDatabaseHandle& handle, const char *model, DcmDataset& query)
+{
+    OFList<OFString> result;
+    DcmQueryRetrieveDatabaseStatus status;
+    OFCHECK(handle.startFindRequest(model, &query, &status).good());
+    while (DICOM_PENDING_STATUS(status.status()))
+    {
+        DcmDataset *response = NULL;
+        OFCHECK(handle.nextFindResponse(&response, &status).good());
+        if (response)
+        {
+            OFString value;
+            OFString keys;
+            const DcmTagKey tags[] = { DCM_PatientID, DCM_StudyInstanceUID, DCM_SeriesInstanceUID, DCM_SOPInstanceUID };
+            for (size_t i = 0; i < sizeof(tags) / sizeof(tags[0]); ++i)
+            {
+                value.clear();
+                response->findAndGetOFString(tags[i], value);
+                keys += value;
+                keys += '|';
+            }
+            result.push_back(keys);
+            delete response;
+        }
+    }
+    OFCHECK_EQUAL(status.status(), STATUS_Success);
+    return result;
+}
+
+static OFList<OFString> findRequest(DcmQueryRetrieveIndexDatabaseHandle& handle, const char *model, const char *level,
+    const char *patientID, const char *studyUID = NULL, const char *seriesUID = NULL, const char *sopUID = NULL)
+{
+    DcmDataset query;
+    query.putAndInsertString(DCM_QueryRetrieveLevel, level);
+    if (patientID) query.putAndInsertString(DCM_PatientID, patientID);
+    if (studyUID) query.putAndInsertString(DCM_StudyInstanceUID, studyUID);
+    if (seriesUID) query.putAndInsertString(DCM_SeriesInstanceUID, seriesUID);
+    if (sopUID) query.putAndInsertString(DCM_SOPInstanceUID, sopUID);
+    return findRequest(handle, model, query);
+}
+
+/* run a C-FIND for the studies with the given value of a study key */
+static OFList<OFString> findStudies(DcmQueryRetrieveIndexDatabaseHandle& handle, const DcmTagKey& key, const char *value)
+{
+    DcmDataset query;
+    query.putAndInsertString(DCM_QueryRetrieveLevel, "STUDY");
+    query.putAndInsertString(DCM_StudyInstanceUID, "");
+    query.putAndInsertString(key, value);
+    return findRequest(handle, UID_FINDStudyRootQueryRetrieveInformationModel, query);
+}
+
+/* run a C-MOVE and return the files of all sub-operations */
+static OFList<OFString> moveRequest(DcmQueryRetrieveIndexDatabaseHandle& handle, const char *level,
+    const char *patientID, const char *studyUID = NULL, const char *seriesUID = NULL)
+{
+    OFList<OFString> result;
+    DcmDataset query;
+    DcmQueryRetrieveDatabaseStatus status;
+    query.putAndInsertString(DCM_QueryRetrieveLevel, level);
+    query.putAndInsertString(DCM_PatientID, patientID);
+    if (studyUID) query.putAndInsertString(DCM_StudyInstanceUID, studyUID);
+    if (seriesUID) query.putAndInsertString(DCM_SeriesInstanceUID, seriesUID);
+
+    OFCHECK(handle.startMoveRequest(UID_MOVEPatientRootQueryRetrieveInformationModel, &query, &status).good());
+    while (DICOM_PENDING_STATUS(status.status()))
+    {
+        char sopClassUID[UI_MAX_LENGTH + 1];
+        char sopInstanceUID[UI_MAX_LENGTH + 1];
+        char filename[DBC_MAXSTRING + 1];
+        unsigned short remaining = 0;
+        sopClassUID[0] = sopInstanceUID[0] = filename[0] = '\0';
+        OFCHECK(handle.nextMoveResponse(sopClassUID, sopInstanceUID, filename, &remaining, &status).good());
+        if (DICOM_PENDING_STATUS(status.status()))
+            result.push_back(filename);
+    }
+    OFCHECK_EQUAL(status.status(), STATUS_Success);
+    return result;
+}
+
+static OFBool equal(const OFList<OFString>& a, const OFList<OFString>& b)
+{
+    if (a.size() != b.size())
+        return OFFalse;
+    OFListConstIterator(OFString) i = a.begin();
+    OFListConstIterator(OFString) j = b.begin();
+    while ((i != a.end()) && (*i == *j))
+    {
+        ++i;
+        ++j;
+    }
+    return i == a.end();
+}
+
+/* the requests compared with and without key index */
+struct QueryResults
+{
+    OFList<OFString> patients, studies, studiesByUID, series, images, image, duplicate, wildcard, unknown;
+    OFList<OFString> accession, date, oldStyleDate, dateRange, yearRange, openRange, longRange, moveStudy, moveSeries;
+
+    explicit QueryResults(DcmQueryRetrieveIndexDatabaseHandle& handle)
+    : patients(findRequest(handle, UID_FINDPatientRootQueryRetrieveInformationModel, "PATIENT", makePatientID(2).c_str()))
+    , studies(findRequest(handle, UID_FINDStudyRootQueryRetrieveInformationModel, "STUDY", makePatientID(3).c_str(), ""))
+    , studiesByUID(findRequest(handle, UID_FINDStudyRootQueryRetrieveInformationModel, "STUDY", NULL, makeUID(4, 1).c_str()))
+    , series(findRequest(handle, UID_FINDStudyRootQueryRetrieveInformationModel, "SERIES", NULL, makeUID(1, 0).c_str(), ""))
+    , images(findRequest(handle, UID_FINDStudyRootQueryRetrieveInformationModel, "IMAGE", NULL, makeUID(5, 1).c_str(), makeUID(5, 1, 1).c_str(), ""))
+    , image(findRequest(handle, UID_FINDStudyRootQueryRetrieveInformationModel, "IMAGE", NULL, makeUID(0, 1).c_str(), makeUID(0, 1, 0).c_str(), makeUID(0, 1, 0, 3).c_str()))
+    , duplicate(findRequest(handle, UID_FINDStudyRootQueryRetrieveInformationModel, "IMAGE", NULL, makeUID(2, 0).c_str(), makeUID(2, 0, 1).c_str(), makeUID(2, 0, 1, 2).c_str()))
+    , wildcard(findRequest(handle, UID_FINDPatientRootQueryRetrieveInformationModel, "PATIENT", "PAT*"))
+    , unknown(findRequest(handle, UID_FINDPatientRootQueryRetrieveInformationModel, "PATIENT", "PAT99"))
+    , accession(findStudies(handle, DCM_AccessionNumber, makeAccessionNumber(4, 1).c_str()))
+    , date(findStudies(handle, DCM_StudyDate, "20151229"))
+    , oldStyleDate(findStudies(handle, DCM_StudyDate, "2016.01.05"))
+    , dateRange(findStudies(handle, DCM_StudyDate, "20151227-20151230"))
+    , yearRange(findStudies(handle, DCM_StudyDate, "20151231-20160106"))
+    , openRange(findStudies(handle, DCM_StudyDate, "20160102-"))
+    , longRange(findStudies(handle, DCM_StudyDate, "19000101-20161231"))
+    , moveStudy(moveRequest(handle, "STUDY", makePatientID(3).c_str(), makeUID(3, 1).c_str()))
+    , moveSeries(moveRequest(handle, "SERIES", makePatientID(0).c_str(), makeUID(0, 0).c_str(), makeUID(0, 0, 1).c_str()))
+    {
+    }
+
+    void check(unsigned int extraImages) const
+    {
+        OFCHECK_EQUAL(patients.size(), 1);
+        OFCHECK_EQUAL(studies.size(), NUM_STUDIES);
+        OFCHECK_EQUAL(studiesByUID.size(), 1);
+        OFCHECK_EQUAL(series.size(), NUM_SERIES);
+        OFCHECK_EQUAL(images.size(), NUM_IMAGES + extraImages);
+        OFCHECK_EQUAL(image.size(), 1);
+        OFCHECK_EQUAL(duplicate.size(), 1);
+        OFCHECK_EQUAL(wildcard.size(), NUM_PATIENTS);
+        OFCHECK_EQUAL(unknown.size(), 0);
+        OFCHECK(accession.size() == 1 && accession.front() == "|" + makeUID(4, 1) + "|||");
+        OFCHECK(date.size() == 1 && date.front() == "|" + makeUID(2, 0) + "|||");
+        OFCHECK(oldStyleDate.size() == 1 && oldStyleDate.front() == "|" + makeUID(5, 1) + "|||");
+        OFCHECK_EQUAL(dateRange.size(), 4);
+        /* the old-style date is within the range, see matchDate() */
+        OFCHECK_EQUAL(yearRange.size(), 6);
+        OFCHECK_EQUAL(openRange.size(), 3);
+        OFCHECK_EQUAL(longRange.size(), NUM_PATIENTS * NUM_STUDIES);
+        OFCHECK_EQUAL(moveStudy.size(), NUM_SERIES * NUM_IMAGES);
+        OFCHECK_EQUAL(moveSeries.size(), NUM_IMAGES);
+    }
+
+    void compare(const QueryResults& other) const
+    {
+        OFCHECK(equal(patients, other.patients));
+        OFCHECK(equal(studies, other.studies));
+        OFCHECK(equal(studiesByUID, other.studiesByUID));
+        OFCHECK(equal(series, other.series));
+        OFCHECK(equal(images, other.images));
+        OFCHECK(equal(image, other.image));
+        OFCHECK(equal(duplicate, other.duplicate));
+        OFCHECK(equal(wildcard, other.wildcard));
+        OFCHECK(equal(unknown, other.unknown));
+        OFCHECK(equal(accession, other.accession));
+        OFCHECK(equal(date, other.date));
+        OFCHECK(equal(oldStyleDate, other.oldStyleDate));
+        OFCHECK(equal(dateRange, other.dateRange));
+        OFCHECK(equal(yearRange, other.yearRange));
+        OFCHECK(equal(openRange, other.openRange));
+        OFCHECK(equal(longRange, other.longRange));
+        OFCHECK(equal(moveStudy, other.moveStudy));
+        OFCHECK(equal(moveSeries, other.moveSeries));
+    }
+};
+
+/* check whether the key index file is up to date */
+static OFBool keyIndexValid()
+{
+    OFBool result = OFFalse;
+    DB_KeyIndexHeader header;
+    FILE *f = fopen(makeFilename(DBKEYINDEXFILE).c_str(), "rb");
+    if (f)
+    {
+        if (fread(&header, sizeof(header), 1, f) == 1)
+            result = (header.indexSize == OFstatic_cast(long, OFStandard::getFileSize(makeFilename(DBINDEXFILE))));
+        fclose(f);
+    }
+    return result;
+}
+
+static void removeStorageArea()
+{
+    OFList<OFString> files;
+    OFStandard::searchDirectoryRecursively(STORAGE_AREA, files);
+    for (OFListIterator(OFString) it = files.begin(); it != files.end(); ++it)
+        OFStandard::deleteFile(*it);
+    rmdir(STORAGE_AREA);
+}
+
+OFTEST(dcmqrdb_keyIndex)
+{
+    removeStorageArea();
+    OFCHECK(OFStandard::createDirectory(STORAGE_AREA, "").good());
+
+    OFCondition result;
+    DcmQueryRetrieveIndexDatabaseHandle handle(STORAGE_AREA, DB_UpperMaxStudies, DB_UpperMaxBytesPerStudy, result);
+    OFCHECK(result.good());
+    OFCHECK(handle.enableKeyIndex(OFTrue).good());
+    OFCHECK(OFStandard::fileExists(makeFilename(DBKEYINDEXFILE)));
+
+    /* populate the database, the images of a study are not stored one after the other */
+    for (unsigned int image = 0; image < NUM_IMAGES; ++image)
+        for (unsigned int patient = 0; patient < NUM_PATIENTS; ++patient)
+            for (unsigned int study = 0; study < NUM_STUDIES; ++study)
+                for (unsigned int series = 0; series < NUM_SERIES; ++series)
+                    storeImage(handle, patient, study, series, image);
+
+    /* store an image again, the first record is reused by the following image */
+    storeImage(handle, 2, 0, 1, 2, "_dup");
+    storeImage(handle, 5, 1, 1, NUM_IMAGES);
+    OFCHECK(keyIndexValid());
+
+    /* queries using the key index */
+    QueryResults indexed(handle);
+    indexed.check(1);
+    OFCHECK(indexed.duplicate.size() == 1 && indexed.duplicate.front() ==
+        "|" + makeUID(2, 0) + "|" + makeUID(2, 0, 1) + "|" + makeUID(2, 0, 1, 2) + "|");
+
+    /* the same queries scanning the index file */
+    OFCHECK(handle.enableKeyIndex(OFFalse).good());
+    OFCHECK(!OFStandard::fileExists(makeFilename(DBKEYINDEXFILE)));
+    QueryResults scanned(handle);
+    indexed.compare(scanned);
+
+    /* a key index not matching the index file is not used by queries
+     * and rebuilt when the database is updated
+     */
+    OFCHECK(handle.enableKeyIndex(OFTrue).good());
+    OFCHECK(OFStandard::renameFile(makeFilename(DBKEYINDEXFILE), makeFilename("index.old")));
+    {
+        DcmQueryRetrieveIndexDatabaseHandle other(STORAGE_AREA, DB_UpperMaxStudies, DB_UpperMaxBytesPerStudy, result);
+        OFCHECK(result.good());
+        storeImage(other, 5, 1, 1, NUM_IMAGES + 1);
+    }
+    OFCHECK(OFStandard::renameFile(makeFilename("index.old"), makeFilename(DBKEYINDEXFILE)));
+    OFCHECK(!keyIndexValid());
+    QueryResults outdated(handle);
+    outdated.check(2);
+
+    storeImage(handle, 5, 1, 1, NUM_IMAGES + 2);
+    OFCHECK(keyIndexValid());
+    QueryResults rebuilt(handle);
+    rebuilt.check(3);
+    OFCHECK(handle.enableKeyIndex(OFFalse).good());
+    QueryResults rescanned(handle);
+    rebuilt.compare(rescanned);
+
+    /* enabling the key index again creates it from the index file */
+    OFCHECK(handle.enableKeyIndex(OFTrue).good());
+    OFCHECK(keyIndexValid());
+
+    removeStorageArea();
+}
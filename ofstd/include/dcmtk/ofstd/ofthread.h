@@ -203,6 +203,13 @@ public:
   /** default constructor */
   OFThreadSpecificData();
 
+  /** constructor.
+   *  @param destructor function that is called with the value of a thread
+   *    when the thread terminates, if the value is not NULL.  Only supported
+   *    for POSIX and Solaris threads, the function is never called on Windows.
+   */
+  OFThreadSpecificData(void (*destructor)(void *));
+
   /** destructor. Deletes all thread specific key values (pointers), but
    *  not the objects pointed to.
    */
@@ -244,6 +251,11 @@ private:
 #endif
   void *theKey;
 
+  /** creates the thread specific data key
+   *  @param destructor function called for the value of a terminating thread, may be NULL
+   */
+  void createKey(void (*destructor)(void *));
+
   /** unimplemented private copy constructor */
   OFThreadSpecificData(const OFThreadSpecificData& arg);
 
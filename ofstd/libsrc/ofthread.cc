@@ -271,6 +271,21 @@ void OFThread::errorstr(OFString& description, int /* code */ )
 
 OFThreadSpecificData::OFThreadSpecificData()
 : theKey(NULL)
+{
+  createKey(NULL);
+}
+
+OFThreadSpecificData::OFThreadSpecificData(void (*destructor)(void *))
+: theKey(NULL)
+{
+  createKey(destructor);
+}
+
+#if defined(POSIX_INTERFACE) || defined(SOLARIS_INTERFACE)
+void OFThreadSpecificData::createKey(void (*destructor)(void *))
+#else
+void OFThreadSpecificData::createKey(void (* /* destructor */)(void *))
+#endif
 {
 #ifdef WINDOWS_INTERFACE
   DWORD *key = new DWORD;
@@ -284,14 +299,14 @@ OFThreadSpecificData::OFThreadSpecificData()
   pthread_key_t *key = new pthread_key_t;
   if (key)
   {
-    if (pthread_key_create(key, NULL)) delete key;
+    if (pthread_key_create(key, destructor)) delete key;
     else theKey=key;
   }
 #elif defined(SOLARIS_INTERFACE)
   thread_key_t *key = new thread_key_t;
   if (key)
   {
-    if (thr_keycreate(key, NULL)) delete key;
+    if (thr_keycreate(key, destructor)) delete key;
     else theKey=key;
   }
 #else
@@ -572,6 +572,45 @@ static void tsdata_test()
 }
 
 
+#ifndef HAVE_WINDOWS_H
+
+static OFThreadSpecificData *tsdata_dtor=NULL;
+static int tsd_destroyed=0;
+
+static void tsdata_destructor(void *value)
+{
+  // called on termination of the thread with the value set by the thread
+  if (value == OFreinterpret_cast(void *, &tsd_destroyed)) tsd_destroyed = 1;
+}
+
+class TSDataT3: public OFThread
+{
+public:
+  TSDataT3(): OFThread() {}
+  ~TSDataT3() {}
+
+  virtual void run()
+  {
+    tsdata_dtor->set(&tsd_destroyed);
+  }
+};
+
+static void tsdata_destructor_test()
+{
+  tsdata_dtor = new OFThreadSpecificData(tsdata_destructor);
+  if ((!tsdata_dtor)||(! tsdata_dtor->initialized())) BAILOUT("creation of thread specific data failed");
+
+  TSDataT3 t3;
+  if (0 != t3.start()) BAILOUT("unable to create thread, thread specific data destructor test failed");
+  if (0 != t3.join()) BAILOUT("unable to join thread, thread specific data destructor test failed");
+  if (!tsd_destroyed) BAILOUT("thread specific data destructor test failed");
+
+  delete tsdata_dtor;
+}
+
+#endif
+
+
 OFTEST(ofstd_thread)
 {
   // This makes sure tests are executed in the expected order
@@ -582,4 +621,7 @@ OFTEST(ofstd_thread)
   rwlock_test();    // may assume that mutexes and semaphores work correctly
   rwlocker_test();  // may assume that mutexes, semaphores and read/write locks work correctly
   tsdata_test();
+#ifndef HAVE_WINDOWS_H
+  tsdata_destructor_test();
+#endif
 }